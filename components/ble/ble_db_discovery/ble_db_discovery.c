@@ -15,6 +15,10 @@
 #include "nrf_log.h"
 
 #include "sdk_common.h"
+#include "app_timer.h"
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+#include "peer_manager.h"
+#endif
 
 #define SRV_DISC_START_HANDLE  0x0001                    /**< The start handle value used during service discovery. */
 #define DB_DISCOVERY_MAX_USERS BLE_DB_DISCOVERY_MAX_SRV  /**< The maximum number of users/registrations allowed by this module. */
@@ -25,22 +29,15 @@
 static ble_uuid_t m_registered_handlers[DB_DISCOVERY_MAX_USERS];
 
 
-/**@brief   Array of structures containing pending events to be sent to the application modules.
- *
- * @details Whenever a discovery related event is to be raised to a user module, it will be stored
- *          in this array first. When all services needed to be discovered have been
- *          discovered, all pending events will be sent to the corresponding user modules.
- **/
-static struct
-{
-    ble_db_discovery_evt_t         evt;          /**< The pending event. */
-    ble_db_discovery_evt_handler_t evt_handler;  /**< The event handler which should be called to raise this event. */
-} m_pending_user_evts[DB_DISCOVERY_MAX_USERS];
-
 static ble_db_discovery_evt_handler_t m_evt_handler;
-static uint32_t m_pending_usr_evt_index;    /**< The index to the pending user event array, pointing to the last added pending user event. */
 static uint32_t m_num_of_handlers_reg;      /**< The number of handlers registered with the DB Discovery module. */
 static bool     m_initialized = false;      /**< This variable Indicates if the module is initialized or not. */
+static ble_db_discovery_cache_stats_t m_cache_stats;    /**< Statistics on the use of stored databases. */
+
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+static pm_peer_id_t m_cache_stale_peer_id = PM_PEER_ID_INVALID; /**< Peer whose stored database is out of date but could not be deleted yet. */
+static uint32_t     m_cache_buf[BYTES_TO_WORDS(sizeof(ble_gatt_db_srv_t) * BLE_DB_DISCOVERY_MAX_SRV)]; /**< Database being written by the Peer Manager. */
+#endif
 
 #define MODULE_INITIALIZED (m_initialized == true)
 #include "sdk_macros.h"
@@ -98,18 +95,52 @@ static uint32_t registered_handler_set(const ble_uuid_t * const       p_srv_uuid
 }
 
 
-/**@brief Function for sending all pending discovery events to the corresponding user modules.
+/**@brief     Function for counting a discovery request sent to the peer.
+ *
+ * @param[in] p_db_discovery Pointer to the DB discovery structure.
  */
-static void pending_user_evts_send(void)
+static void round_trip_count(ble_db_discovery_t * const p_db_discovery)
 {
-    uint32_t i = 0;
+    p_db_discovery->round_trips++;
+    m_cache_stats.round_trips++;
+}
 
-    for (i = 0; i < m_num_of_handlers_reg; i++)
+
+/**@brief     Function for sending all pending discovery events of a connection to the
+ *            corresponding user modules.
+ *
+ * @details   The events are built from the discovered services when they are sent, so that only
+ *            the outcome of each service needs to be kept per connection until then.
+ *
+ * @param[in] p_db_discovery Pointer to the DB discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void pending_user_evts_send(ble_db_discovery_t * const p_db_discovery,
+                                   uint16_t const             conn_handle)
+{
+    uint32_t               i;
+    uint32_t               now_ticks = 0;
+    ble_db_discovery_evt_t evt;
+
+    // The duration is available to the user modules while the events are handled.
+    if (app_timer_cnt_get(&now_ticks) == NRF_SUCCESS)
+    {
+        (void)app_timer_cnt_diff_compute(now_ticks,
+                                         p_db_discovery->start_ticks,
+                                         &p_db_discovery->duration_ticks);
+    }
+
+    for (i = 0; i < p_db_discovery->pending_evt_count; i++)
     {
+        evt.conn_handle          = conn_handle;
+        evt.params.discovered_db = p_db_discovery->services[i];
+        evt.evt_type             = p_db_discovery->srv_found[i] ? BLE_DB_DISCOVERY_COMPLETE
+                                                                : BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+
         // Pass the event to the corresponding event handler.
-        m_pending_user_evts[i].evt_handler(&(m_pending_user_evts[i].evt));
+        m_evt_handler(&evt);
     }
-    m_pending_usr_evt_index = 0;
+    p_db_discovery->pending_evt_count = 0;
 }
 
 
@@ -174,32 +205,19 @@ static void discovery_complete_evt_trigger(ble_db_discovery_t * const p_db_disco
 
     if (p_evt_handler != NULL)
     {
-        if (m_pending_usr_evt_index < DB_DISCOVERY_MAX_USERS)
+        if (p_db_discovery->pending_evt_count < DB_DISCOVERY_MAX_USERS)
         {
-            // Insert an event into the pending event list.
-            m_pending_user_evts[m_pending_usr_evt_index].evt.conn_handle = conn_handle;
+            // Insert an event into the pending event list of this connection. Services are
+            // discovered in order, so the event of service i is pending event i.
+            p_db_discovery->srv_found[p_db_discovery->pending_evt_count] = is_srv_found;
 
-            m_pending_user_evts[m_pending_usr_evt_index].evt.params.discovered_db =
-                *p_srv_being_discovered;
-            if (is_srv_found)
-            {
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_COMPLETE;
-            }
-            else
-            {
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_SRV_NOT_FOUND;
-            }
-            m_pending_user_evts[m_pending_usr_evt_index].evt_handler = p_evt_handler;
-
-            m_pending_usr_evt_index++;
+            p_db_discovery->pending_evt_count++;
 
-            if (m_pending_usr_evt_index == m_num_of_handlers_reg)
+            if (p_db_discovery->pending_evt_count == m_num_of_handlers_reg)
             {
                 // All registered modules have pending events. Send all pending events to the user
                 // modules.
-                pending_user_evts_send();
+                pending_user_evts_send(p_db_discovery, conn_handle);
             }
             else
             {
@@ -210,6 +228,89 @@ static void discovery_complete_evt_trigger(ble_db_discovery_t * const p_db_disco
 }
 
 
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+/**@brief     Function for finding the peer ID of the bonded peer on a connection.
+ *
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @return    The peer ID, or PM_PEER_ID_INVALID if the peer is not bonded.
+ */
+static pm_peer_id_t cache_peer_id_get(uint16_t conn_handle)
+{
+    pm_peer_id_t peer_id;
+
+    if (pm_peer_id_get(conn_handle, &peer_id) != NRF_SUCCESS)
+    {
+        return PM_PEER_ID_INVALID;
+    }
+    return peer_id;
+}
+
+
+/**@brief     Function for deleting the stored database of a peer.
+ *
+ * @details   If the database can not be deleted now, it is not used, and the deletion is retried
+ *            the next time the database would be used.
+ *
+ * @param[in] peer_id        The peer.
+ */
+static void cache_delete(pm_peer_id_t peer_id)
+{
+    uint32_t err_code = pm_peer_data_delete(peer_id, PM_PEER_DATA_ID_GATT_REMOTE);
+
+    if ((err_code == NRF_SUCCESS) || (err_code == NRF_ERROR_NOT_FOUND))
+    {
+        if (m_cache_stale_peer_id == peer_id)
+        {
+            m_cache_stale_peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+    else
+    {
+        m_cache_stale_peer_id = peer_id;
+    }
+}
+
+
+/**@brief     Function for storing a completed discovery for the peer on a connection.
+ *
+ * @details   The Peer Manager writes the database asynchronously, from the buffer it is given. The
+ *            services are therefore copied to a buffer owned by this module, so that the DB
+ *            Discovery structure can be reused as soon as the discovery is complete. The buffer is
+ *            shared by all connections: a discovery of a bonded peer which completes while the
+ *            database of the previous one is still being written replaces the data being written.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery Structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void cache_store(ble_db_discovery_t * p_db_discovery, uint16_t const conn_handle)
+{
+    pm_peer_id_t peer_id = cache_peer_id_get(conn_handle);
+    uint32_t     err_code;
+
+    if (peer_id == PM_PEER_ID_INVALID)
+    {
+        return;
+    }
+
+    memcpy(m_cache_buf, p_db_discovery->services, m_num_of_handlers_reg * sizeof(ble_gatt_db_srv_t));
+
+    // The length is rounded up to whole words.
+    err_code = pm_peer_data_remote_db_store(peer_id,
+                                            (ble_gatt_db_srv_t *)m_cache_buf,
+                                            ALIGN_NUM(4, m_num_of_handlers_reg *
+                                                         sizeof(ble_gatt_db_srv_t)),
+                                            NULL);
+    if ((err_code == NRF_SUCCESS) && (m_cache_stale_peer_id == peer_id))
+    {
+        m_cache_stale_peer_id = PM_PEER_ID_INVALID;
+    }
+
+    DB_LOG("[DB]: Storing database of peer %d, result %d\r\n", peer_id, err_code);
+}
+#endif // BLE_DB_DISCOVERY_CACHE_ENABLED
+
+
 /**@brief     Function for handling service discovery completion.
  *
  * @details   This function will be used to determine if there are more services to be discovered,
@@ -253,7 +354,11 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
                    SRV_DISC_START_HANDLE,
                    &(p_srv_being_discovered->srv_uuid)
                    );
-        if (err_code != NRF_SUCCESS)
+        if (err_code == NRF_SUCCESS)
+        {
+            round_trip_count(p_db_discovery);
+        }
+        else
         {
             p_db_discovery->discovery_in_progress = false;
 
@@ -261,10 +366,6 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
             // Indicate the error to the registered user application.
             discovery_error_evt_trigger(p_db_discovery, err_code, conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = conn_handle;
-//            m_evt_handler(&m_pending_user_evts[0].evt);
-
             return;
         }
     }
@@ -272,9 +373,9 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
     {
         // No more service discovery is needed.
         p_db_discovery->discovery_in_progress  = false;
-        m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-        m_pending_user_evts[0].evt.conn_handle = conn_handle;
-        //m_evt_handler(&m_pending_user_evts[0].evt);
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+        cache_store(p_db_discovery, conn_handle);
+#endif
     }
 }
 
@@ -414,7 +515,12 @@ static uint32_t characteristics_discover(ble_db_discovery_t * const p_db_discove
 
     handle_range.end_handle = p_srv_being_discovered->handle_range.end_handle;
 
-    return sd_ble_gattc_characteristics_discover(conn_handle, &handle_range);
+    uint32_t err_code = sd_ble_gattc_characteristics_discover(conn_handle, &handle_range);
+    if (err_code == NRF_SUCCESS)
+    {
+        round_trip_count(p_db_discovery);
+    }
+    return err_code;
 }
 
 
@@ -507,7 +613,12 @@ static uint32_t descriptors_discover(ble_db_discovery_t * const p_db_discovery,
 
     *p_raise_discov_complete = false;
 
-    return sd_ble_gattc_descriptors_discover(conn_handle, &handle_range);
+    uint32_t err_code = sd_ble_gattc_descriptors_discover(conn_handle, &handle_range);
+    if (err_code == NRF_SUCCESS)
+    {
+        round_trip_count(p_db_discovery);
+    }
+    return err_code;
 }
 
 
@@ -553,15 +664,17 @@ static void on_primary_srv_discovery_rsp(ble_db_discovery_t * const    p_db_disc
             discovery_error_evt_trigger(p_db_discovery,
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
-
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-            //m_evt_handler(&m_pending_user_evts[0].evt);
         }
     }
     else
     {
         DB_LOG("Service UUID 0x%x Not found\r\n", p_srv_being_discovered->srv_uuid.uuid);
+
+        // An empty handle range marks the service as not found in a stored database.
+        p_srv_being_discovered->handle_range.start_handle = BLE_GATT_HANDLE_INVALID;
+        p_srv_being_discovered->handle_range.end_handle   = BLE_GATT_HANDLE_INVALID;
+        p_srv_being_discovered->char_count                = 0;
+
         // Trigger Service Not Found event to the application.
         discovery_complete_evt_trigger(p_db_discovery,
                                        false,
@@ -659,10 +772,6 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                                             err_code,
                                             p_ble_gattc_evt->conn_handle);
 
-                m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-                m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-                //m_evt_handler(&m_pending_user_evts[0].evt);
-
                 return;
             }
         }
@@ -692,10 +801,6 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-            //m_evt_handler(&m_pending_user_evts[0].evt);
-
             return;
         }
         if (raise_discov_complete)
@@ -792,9 +897,6 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-
             return;
         }
     }
@@ -815,6 +917,183 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
 }
 
 
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+/**@brief     Function for counting the requests that a discovery of a stored service would send.
+ *
+ * @details   The count is a lower bound, because the number of characteristics in each response
+ *            depends on the MTU and on the UUID types.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery Structure, with curr_srv_ind set to the
+ *                           service.
+ */
+static uint32_t cache_round_trips_count(ble_db_discovery_t * const p_db_discovery)
+{
+    ble_gatt_db_srv_t      * p_srv = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+    ble_gattc_handle_range_t handle_range;
+    uint32_t                 count = 1;  // Primary service discovery.
+
+    if (p_srv->handle_range.start_handle == BLE_GATT_HANDLE_INVALID)
+    {
+        return count;
+    }
+
+    count++; // Characteristic discovery.
+
+    if (p_srv->char_count == 0)
+    {
+        return count;
+    }
+
+    if (   is_char_discovery_reqd(p_db_discovery,
+                                  &(p_srv->charateristics[p_srv->char_count - 1].characteristic))
+        && (p_srv->char_count < BLE_GATT_DB_MAX_CHARS))
+    {
+        count++; // Characteristic discovery finding no more characteristics.
+    }
+
+    for (uint32_t i = 0; i < p_srv->char_count; i++)
+    {
+        ble_gatt_db_char_t * p_next_char = ((i + 1) < p_srv->char_count)
+                                           ? &(p_srv->charateristics[i + 1])
+                                           : NULL;
+
+        if (is_desc_discovery_reqd(p_db_discovery,
+                                   &(p_srv->charateristics[i]),
+                                   p_next_char,
+                                   &handle_range))
+        {
+            count++; // Descriptor discovery.
+        }
+    }
+
+    return count;
+}
+
+
+/**@brief     Function for completing a discovery from the stored database of the peer.
+ *
+ * @details   The database is loaded into the services of the DB Discovery structure. If it can not
+ *            be used, they are overwritten by the discovery which follows. The events of all
+ *            services are sent to the application before this function returns.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery Structure.
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @retval    True if the discovery was completed from a stored database.
+ * @retval    False if there was no usable stored database, and the discovery must be performed.
+ */
+static bool cache_discovery(ble_db_discovery_t * const p_db_discovery, uint16_t const conn_handle)
+{
+    ble_gatt_db_srv_t * p_cached_srvs = p_db_discovery->services;
+    pm_peer_id_t        peer_id       = cache_peer_id_get(conn_handle);
+    uint16_t            len           = (sizeof(p_db_discovery->services) / BYTES_PER_WORD) *
+                                        BYTES_PER_WORD;
+    uint32_t            err_code;
+    uint32_t            i;
+
+    if (peer_id == PM_PEER_ID_INVALID)
+    {
+        return false;
+    }
+
+    if (m_cache_stale_peer_id == peer_id)
+    {
+        cache_delete(peer_id);
+        m_cache_stats.cache_misses++;
+        return false;
+    }
+
+    err_code = pm_peer_data_remote_db_load(peer_id, p_cached_srvs, &len);
+    if (   (err_code != NRF_SUCCESS)
+        || ((len / sizeof(ble_gatt_db_srv_t)) != m_num_of_handlers_reg))
+    {
+        m_cache_stats.cache_misses++;
+        return false;
+    }
+
+    for (i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        if (!BLE_UUID_EQ(&(p_cached_srvs[i].srv_uuid), &(m_registered_handlers[i])))
+        {
+            // The set of registered services has changed since the database was stored.
+            m_cache_stats.cache_misses++;
+            return false;
+        }
+    }
+
+    DB_LOG("[DB]: Using stored database of peer %d for Connection handle %d\r\n",
+           peer_id, conn_handle);
+
+    p_db_discovery->srv_count = m_num_of_handlers_reg;
+
+    for (i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        p_db_discovery->curr_srv_ind = i;
+        m_cache_stats.round_trips_avoided += cache_round_trips_count(p_db_discovery);
+
+        discovery_complete_evt_trigger(p_db_discovery,
+                                       p_cached_srvs[i].handle_range.start_handle
+                                       != BLE_GATT_HANDLE_INVALID,
+                                       conn_handle);
+    }
+
+    p_db_discovery->discoveries_count = m_num_of_handlers_reg;
+    m_cache_stats.cache_hits++;
+
+    return true;
+}
+
+
+/**@brief     Function for handling a Handle Value Indication.
+ *
+ * @details   The stored database of the peer is deleted if the indication is of the Service
+ *            Changed characteristic.
+ *
+ * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in] p_ble_gattc_evt   Pointer to the GATT Client event.
+ */
+static void on_hvx(ble_db_discovery_t * const    p_db_discovery,
+                   const ble_gattc_evt_t * const p_ble_gattc_evt)
+{
+    if (   (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
+        || (p_ble_gattc_evt->params.hvx.type != BLE_GATT_HVX_INDICATION))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        ble_gatt_db_srv_t * p_srv = &(p_db_discovery->services[i]);
+
+        if (p_srv->srv_uuid.uuid != BLE_UUID_GATT)
+        {
+            continue;
+        }
+
+        for (uint32_t j = 0; j < p_srv->char_count; j++)
+        {
+            ble_gattc_char_t * p_char = &(p_srv->charateristics[j].characteristic);
+
+            if (   (p_char->uuid.uuid == BLE_UUID_GATT_CHARACTERISTIC_SERVICE_CHANGED)
+                && (p_char->handle_value == p_ble_gattc_evt->params.hvx.handle))
+            {
+                pm_peer_id_t peer_id = cache_peer_id_get(p_ble_gattc_evt->conn_handle);
+
+                if (peer_id != PM_PEER_ID_INVALID)
+                {
+                    DB_LOG("[DB]: Service Changed, deleting stored database of peer %d\r\n",
+                           peer_id);
+                    cache_delete(peer_id);
+                    m_cache_stats.cache_invalidations++;
+                }
+                return;
+            }
+        }
+    }
+}
+#endif // BLE_DB_DISCOVERY_CACHE_ENABLED
+
+
 uint32_t ble_db_discovery_init(const ble_db_discovery_evt_handler_t evt_handler)
 {
     uint32_t err_code = NRF_SUCCESS;
@@ -822,7 +1101,6 @@ uint32_t ble_db_discovery_init(const ble_db_discovery_evt_handler_t evt_handler)
 
     m_num_of_handlers_reg      = 0;
     m_initialized              = true;
-    m_pending_usr_evt_index    = 0;
     m_evt_handler              = evt_handler;
 
     return err_code;
@@ -834,7 +1112,6 @@ uint32_t ble_db_discovery_close()
 {
     m_num_of_handlers_reg      = 0;
     m_initialized              = false;
-    m_pending_usr_evt_index    = 0;
 
     return NRF_SUCCESS;
 }
@@ -869,11 +1146,21 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
     p_db_discovery->conn_handle = conn_handle;
     ble_gatt_db_srv_t * p_srv_being_discovered;
 
-    m_pending_usr_evt_index   = 0;
+    p_db_discovery->pending_evt_count = 0;
+    p_db_discovery->round_trips       = 0;
+    p_db_discovery->duration_ticks    = 0;
+    (void)app_timer_cnt_get(&p_db_discovery->start_ticks);
 
     p_db_discovery->discoveries_count = 0;
     p_db_discovery->curr_srv_ind = 0;
 
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+    if (cache_discovery(p_db_discovery, conn_handle))
+    {
+        return NRF_SUCCESS;
+    }
+#endif
+
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
     p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind];
@@ -887,6 +1174,7 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
                                                       SRV_DISC_START_HANDLE,
                                                       &(p_srv_being_discovered->srv_uuid));
     VERIFY_SUCCESS(err_code);
+    round_trip_count(p_db_discovery);
     p_db_discovery->discovery_in_progress = true;
 
     return NRF_SUCCESS;
@@ -933,7 +1221,23 @@ void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
             on_disconnected(p_db_discovery, &(p_ble_evt->evt.gap_evt));
             break;
 
+#if BLE_DB_DISCOVERY_CACHE_ENABLED
+        case BLE_GATTC_EVT_HVX:
+            on_hvx(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+            break;
+#endif
+
         default:
             break;
     }
 }
+
+
+uint32_t ble_db_discovery_cache_stats_get(ble_db_discovery_cache_stats_t * p_stats)
+{
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    *p_stats = m_cache_stats;
+
+    return NRF_SUCCESS;
+}
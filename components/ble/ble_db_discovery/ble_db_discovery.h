@@ -36,6 +36,21 @@
  * @note     The application must propagate BLE stack events to this module by calling
  *           ble_db_discovery_on_ble_evt().
  *
+ * @note     Discoveries on different connections, each using its own @ref ble_db_discovery_t
+ *           instance, run concurrently and independently. The SoftDevice allows one GATT client
+ *           procedure at a time per connection, so on each connection the requests are sent one
+ *           after another. The events of a connection are sent when all of its services have
+ *           been discovered. The @ref app_timer module must be initialized, it is used to measure
+ *           the duration of each discovery.
+ *
+ * @note     If @ref BLE_DB_DISCOVERY_CACHE_ENABLED is set, the discovered database of a bonded
+ *           peer is stored by the Peer Manager, and later discoveries on connections to the same
+ *           peer are completed from the stored database without any requests to the peer. The
+ *           stored database is deleted when the peer indicates Service Changed. For this, the
+ *           Generic Attribute service (@ref BLE_UUID_GATT) must be registered with
+ *           @ref ble_db_discovery_evt_register, so that the Service Changed characteristic is
+ *           discovered. The Peer Manager must be initialized before discovery is started.
+ *
  */
 
 #ifndef BLE_DB_DISCOVERY_H__
@@ -51,6 +66,10 @@
 
 #define BLE_DB_DISCOVERY_MAX_SRV          6  /**< Maximum number of services supported by this module. This also indicates the maximum number of users allowed to be registered to this module. (one user per service). */
 
+#ifndef BLE_DB_DISCOVERY_CACHE_ENABLED
+#define BLE_DB_DISCOVERY_CACHE_ENABLED    0  /**< Enable storing the discovered databases of bonded peers in the Peer Manager, and completing discoveries from them. */
+#endif
+
 
 /**@brief   Type of the DB Discovery event.
  */
@@ -80,6 +99,11 @@ typedef struct
     bool                discovery_in_progress;               /**< Variable to indicate if there is a service discovery in progress. */
     uint8_t             discoveries_count;                   /**< Number of service discoveries made, both successful and unsuccessful. */
     uint16_t            conn_handle;                         /**< Connection handle on which the discovery is started*/
+    bool                srv_found[BLE_DB_DISCOVERY_MAX_SRV]; /**< Whether each service was found at the peer. This is intended for internal use during service discovery. */
+    uint8_t             pending_evt_count;                   /**< Number of services whose events are waiting to be sent to the application. This is intended for internal use during service discovery. */
+    uint16_t            round_trips;                         /**< Number of discovery requests sent to the peer during the current or last discovery. */
+    uint32_t            start_ticks;                         /**< Value of the RTC counter of @ref app_timer when the discovery was started. */
+    uint32_t            duration_ticks;                      /**< Duration of the last discovery in @ref app_timer ticks, from its start until its events were sent. Valid while the events are handled, and afterwards. */
 } ble_db_discovery_t;
 
 
@@ -97,6 +121,18 @@ typedef struct
 } ble_db_discovery_evt_t;
 
 
+/**@brief   Statistics on the use of stored databases. See @ref BLE_DB_DISCOVERY_CACHE_ENABLED.
+ */
+typedef struct
+{
+    uint32_t cache_hits;            /**< Number of discoveries completed from a stored database. */
+    uint32_t cache_misses;          /**< Number of discoveries of bonded peers for which no usable database was stored. */
+    uint32_t cache_invalidations;   /**< Number of stored databases deleted because of a Service Changed indication. */
+    uint32_t round_trips;           /**< Number of discovery requests sent to peers. */
+    uint32_t round_trips_avoided;   /**< Lower bound on the number of discovery requests that discoveries from stored databases would otherwise have sent. */
+} ble_db_discovery_cache_stats_t;
+
+
 /**@brief   DB Discovery event handler type. */
 typedef void (* ble_db_discovery_evt_handler_t)(ble_db_discovery_evt_t * p_evt);
 
@@ -148,6 +184,9 @@ uint32_t ble_db_discovery_evt_register(const ble_uuid_t * const             p_uu
  *
  * @warning p_db_discovery structure must be zero-initialized.
  *
+ * @note    If the database is completed from a stored database (see
+ *          @ref BLE_DB_DISCOVERY_CACHE_ENABLED), the events are sent before this function returns.
+ *
  * @param[out] p_db_discovery    Pointer to the DB Discovery structure.
  * @param[in]  conn_handle       The handle of the connection for which the discovery should be 
  *                               started.
@@ -175,6 +214,16 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
 void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
                                  const ble_evt_t * const    p_ble_evt);
 
+
+/**@brief Function for getting statistics on the use of stored databases.
+ *
+ * @param[out] p_stats  Pointer to the structure to fill with the statistics.
+ *
+ * @retval    NRF_SUCCESS               Operation success.
+ * @retval    NRF_ERROR_NULL            When a NULL pointer is passed as input.
+ */
+uint32_t ble_db_discovery_cache_stats_get(ble_db_discovery_cache_stats_t * p_stats);
+
 #endif // BLE_DB_DISCOVERY_H__
 
 /** @} */
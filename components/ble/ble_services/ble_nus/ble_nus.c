@@ -13,6 +13,7 @@
 #include "ble_nus.h"
 #include "ble_srv_common.h"
 #include "sdk_common.h"
+#include "app_util_platform.h"
 
 #define BLE_UUID_NUS_TX_CHARACTERISTIC 0x0002                      /**< The UUID of the TX Characteristic. */
 #define BLE_UUID_NUS_RX_CHARACTERISTIC 0x0003                      /**< The UUID of the RX Characteristic. */
@@ -42,6 +43,155 @@ static void on_disconnect(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
 {
     UNUSED_PARAMETER(p_ble_evt);
     p_nus->conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    if (p_nus->is_stream_enabled)
+    {
+        UNUSED_RETURN_VALUE(app_fifo_flush(&p_nus->tx_fifo));
+        p_nus->packets_in_flight = 0;
+    }
+}
+
+
+/**@brief Function for sending queued data until the queue is empty or the SoftDevice has no more
+ *        TX buffers.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code returned by @ref sd_ble_gatts_hvx.
+ */
+static uint32_t stream_tx_send(ble_nus_t * p_nus)
+{
+    uint8_t                packet[BLE_NUS_MAX_DATA_LEN];
+    uint8_t              * p_data;
+    uint32_t               size;
+    uint16_t               len;
+    uint32_t               err_code;
+    ble_gatts_hvx_params_t hvx_params;
+
+    if ((p_nus->conn_handle == BLE_CONN_HANDLE_INVALID) || (!p_nus->is_notification_enabled))
+    {
+        return NRF_SUCCESS;
+    }
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = p_nus->rx_handles.value_handle;
+    hvx_params.p_len  = &len;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+
+    // A packet that wraps around the end of the transmit buffer is copied to packet.
+    while (app_fifo_read_chunk_get(&p_nus->tx_fifo, &p_data, packet, sizeof(packet), &size)
+           == NRF_SUCCESS)
+    {
+        len               = (uint16_t)size;
+        hvx_params.p_data = p_data;
+
+        // The packet is counted first, as BLE_EVT_TX_COMPLETE can report it before the SoftDevice
+        // call returns. The count is also decremented by the BLE event handler.
+        CRITICAL_REGION_ENTER();
+        p_nus->packets_in_flight++;
+        CRITICAL_REGION_EXIT();
+
+        err_code = sd_ble_gatts_hvx(p_nus->conn_handle, &hvx_params);
+        if (err_code != NRF_SUCCESS)
+        {
+            CRITICAL_REGION_ENTER();
+            if (p_nus->packets_in_flight > 0)
+            {
+                p_nus->packets_in_flight--;
+            }
+            CRITICAL_REGION_EXIT();
+        }
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Continued on BLE_EVT_TX_COMPLETE.
+            p_nus->stream_stats.tx_buffers_full++;
+            return NRF_SUCCESS;
+        }
+        VERIFY_SUCCESS(err_code);
+
+        UNUSED_RETURN_VALUE(app_fifo_read_commit(&p_nus->tx_fifo, len));
+        p_nus->stream_stats.bytes_sent += len;
+        p_nus->stream_stats.packets_sent++;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for sending queued data, from the application or from the BLE event handler.
+ *
+ * @details The queue has a single reader. A call which interrupts the sending of the queue in
+ *          another context only makes the interrupted call go through the queue again, so that a
+ *          packet is never sent and committed twice.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ *
+ * @return NRF_SUCCESS on success or if the queue is being sent in another context, otherwise an
+ *         error code returned by @ref sd_ble_gatts_hvx.
+ */
+static uint32_t stream_tx_pump(ble_nus_t * p_nus)
+{
+    bool     is_busy;
+    uint32_t err_code;
+
+    CRITICAL_REGION_ENTER();
+    is_busy                     = p_nus->is_tx_pump_busy;
+    p_nus->is_tx_pump_busy      = true;
+    p_nus->is_tx_pump_requested = true;
+    CRITICAL_REGION_EXIT();
+
+    if (is_busy)
+    {
+        return NRF_SUCCESS;
+    }
+
+    do
+    {
+        p_nus->is_tx_pump_requested = false;
+
+        err_code = stream_tx_send(p_nus);
+
+        CRITICAL_REGION_ENTER();
+        is_busy                = p_nus->is_tx_pump_requested && (err_code == NRF_SUCCESS);
+        p_nus->is_tx_pump_busy = is_busy;
+        CRITICAL_REGION_EXIT();
+    } while (is_busy);
+
+    return err_code;
+}
+
+
+/**@brief Function for handling the @ref BLE_EVT_TX_COMPLETE event from the SoftDevice.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ * @param[in] p_ble_evt Pointer to the event received from BLE stack.
+ */
+static void on_tx_complete(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
+{
+    uint32_t count = p_ble_evt->evt.common_evt.params.tx_complete.count;
+
+    if (   !p_nus->is_stream_enabled
+        || (p_ble_evt->evt.common_evt.conn_handle != p_nus->conn_handle))
+    {
+        return;
+    }
+
+    // The count includes the packets of other modules on the link. The oldest packets are
+    // transmitted first, so the notifications of the service are at most those in flight.
+    count                     = MIN(count, p_nus->packets_in_flight);
+    p_nus->packets_in_flight -= count;
+
+    if (count > 0)
+    {
+        p_nus->stream_stats.tx_complete_evts++;
+    }
+    p_nus->stream_stats.packets_completed += count;
+    p_nus->stream_stats.max_packets_per_evt = MAX(p_nus->stream_stats.max_packets_per_evt,
+                                                  (uint8_t)count);
+
+    // Errors are reported again by the next call to ble_nus_stream_write.
+    UNUSED_RETURN_VALUE(stream_tx_pump(p_nus));
 }
 
 
@@ -63,6 +213,11 @@ static void on_write(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
         if (ble_srv_is_notification_enabled(p_evt_write->data))
         {
             p_nus->is_notification_enabled = true;
+
+            if (p_nus->is_stream_enabled)
+            {
+                UNUSED_RETURN_VALUE(stream_tx_pump(p_nus));
+            }
         }
         else
         {
@@ -218,6 +373,10 @@ void ble_nus_on_ble_evt(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
             on_write(p_nus, p_ble_evt);
             break;
 
+        case BLE_EVT_TX_COMPLETE:
+            on_tx_complete(p_nus, p_ble_evt);
+            break;
+
         default:
             // No implementation needed.
             break;
@@ -238,6 +397,18 @@ uint32_t ble_nus_init(ble_nus_t * p_nus, const ble_nus_init_t * p_nus_init)
     p_nus->conn_handle             = BLE_CONN_HANDLE_INVALID;
     p_nus->data_handler            = p_nus_init->data_handler;
     p_nus->is_notification_enabled = false;
+    p_nus->is_stream_enabled       = (p_nus_init->p_tx_buf != NULL);
+
+    memset(&p_nus->stream_stats, 0, sizeof(p_nus->stream_stats));
+    p_nus->packets_in_flight       = 0;
+    p_nus->is_tx_pump_busy         = false;
+    p_nus->is_tx_pump_requested    = false;
+
+    if (p_nus->is_stream_enabled)
+    {
+        err_code = app_fifo_init(&p_nus->tx_fifo, p_nus_init->p_tx_buf, p_nus_init->tx_buf_size);
+        VERIFY_SUCCESS(err_code);
+    }
 
     /**@snippet [Adding proprietary Service to S110 SoftDevice] */
     // Add a custom base UUID.
@@ -293,3 +464,36 @@ uint32_t ble_nus_string_send(ble_nus_t * p_nus, uint8_t * p_string, uint16_t len
 }
 
 
+uint32_t ble_nus_stream_write(ble_nus_t * p_nus, uint8_t const * p_data, uint32_t * p_length)
+{
+    uint32_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_nus);
+    VERIFY_PARAM_NOT_NULL(p_data);
+    VERIFY_PARAM_NOT_NULL(p_length);
+
+    if (   !p_nus->is_stream_enabled
+        || (p_nus->conn_handle == BLE_CONN_HANDLE_INVALID)
+        || (!p_nus->is_notification_enabled))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = app_fifo_write(&p_nus->tx_fifo, p_data, p_length);
+    VERIFY_SUCCESS(err_code);
+
+    p_nus->stream_stats.bytes_queued += *p_length;
+
+    return stream_tx_pump(p_nus);
+}
+
+
+uint32_t ble_nus_stream_stats_get(ble_nus_t const * p_nus, ble_nus_stream_stats_t * p_stats)
+{
+    VERIFY_PARAM_NOT_NULL(p_nus);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    *p_stats = p_nus->stream_stats;
+
+    return NRF_SUCCESS;
+}
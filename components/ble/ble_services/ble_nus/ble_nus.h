@@ -25,6 +25,12 @@
  *          is used by the application to send and receive ASCII text strings to and from the
  *          peer.
  *
+ *          For bulk transfers, the service can be given a transmit buffer in @ref ble_nus_init_t.
+ *          Data written with @ref ble_nus_stream_write is then queued in the buffer and sent as
+ *          notifications of @ref BLE_NUS_MAX_DATA_LEN bytes, filling all the application TX
+ *          buffers of the SoftDevice. The queue is refilled from the @ref BLE_EVT_TX_COMPLETE event,
+ *          so the application does not have to retry on @ref BLE_ERROR_NO_TX_PACKETS.
+ *
  * @note The application must propagate SoftDevice events to the Nordic UART Service module
  *       by calling the ble_nus_on_ble_evt() function from the ble_stack_handler callback.
  */
@@ -34,6 +40,7 @@
 
 #include "ble.h"
 #include "ble_srv_common.h"
+#include "app_fifo.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -55,8 +62,29 @@ typedef void (*ble_nus_data_handler_t) (ble_nus_t * p_nus, uint8_t * p_data, uin
 typedef struct
 {
     ble_nus_data_handler_t data_handler; /**< Event handler to be called for handling received data. */
+    uint8_t              * p_tx_buf;     /**< Buffer for the data queued by @ref ble_nus_stream_write. NULL if streaming is not used. */
+    uint16_t               tx_buf_size;  /**< Size of the transmit buffer. Must be a power of two. */
 } ble_nus_init_t;
 
+/**@brief Nordic UART Service streaming statistics.
+ *
+ * @details The throughput in bytes per second is the difference in bytes_sent between two calls to
+ *          @ref ble_nus_stream_stats_get, divided by the time between the calls. The average number
+ *          of packets per connection event is packets_completed divided by tx_complete_evts, as the
+ *          SoftDevice reports the transmitted packets at most once per connection event. Only the
+ *          packets sent by the service are counted, not those of other modules on the link.
+ */
+typedef struct
+{
+    uint32_t bytes_queued;        /**< Number of bytes accepted by @ref ble_nus_stream_write. */
+    uint32_t bytes_sent;          /**< Number of bytes handed to the SoftDevice. */
+    uint32_t packets_sent;        /**< Number of notifications handed to the SoftDevice. */
+    uint32_t packets_completed;   /**< Number of notifications transmitted, as reported by @ref BLE_EVT_TX_COMPLETE. */
+    uint32_t tx_complete_evts;    /**< Number of @ref BLE_EVT_TX_COMPLETE events that reported notifications. */
+    uint32_t tx_buffers_full;     /**< Number of times all the TX buffers of the SoftDevice were in use. */
+    uint8_t  max_packets_per_evt; /**< Largest number of packets reported by one @ref BLE_EVT_TX_COMPLETE event. */
+} ble_nus_stream_stats_t;
+
 /**@brief Nordic UART Service structure.
  *
  * @details This structure contains status information related to the service.
@@ -70,6 +98,12 @@ struct ble_nus_s
     uint16_t                 conn_handle;             /**< Handle of the current connection (as provided by the SoftDevice). BLE_CONN_HANDLE_INVALID if not in a connection. */
     bool                     is_notification_enabled; /**< Variable to indicate if the peer has enabled notification of the RX characteristic.*/
     ble_nus_data_handler_t   data_handler;            /**< Event handler to be called for handling received data. */
+    bool                     is_stream_enabled;       /**< Variable to indicate if a transmit buffer was given at initialization. */
+    app_fifo_t               tx_fifo;                 /**< Queue of data written with @ref ble_nus_stream_write. */
+    ble_nus_stream_stats_t   stream_stats;            /**< Streaming statistics. */
+    uint32_t                 packets_in_flight;       /**< Number of notifications handed to the SoftDevice and not yet reported as transmitted. */
+    volatile bool            is_tx_pump_busy;         /**< Variable to indicate if the transmit queue is being sent, in the application or in the BLE event handler. */
+    volatile bool            is_tx_pump_requested;    /**< Variable to indicate if the queue must be sent again by the running pump. */
 };
 
 /**@brief Function for initializing the Nordic UART Service.
@@ -81,6 +115,7 @@ struct ble_nus_s
  *
  * @retval NRF_SUCCESS If the service was successfully initialized. Otherwise, an error code is returned.
  * @retval NRF_ERROR_NULL If either of the pointers p_nus or p_nus_init is NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH If the size of the transmit buffer is not a power of two.
  */
 uint32_t ble_nus_init(ble_nus_t * p_nus, const ble_nus_init_t * p_nus_init);
 
@@ -109,6 +144,37 @@ void ble_nus_on_ble_evt(ble_nus_t * p_nus, ble_evt_t * p_ble_evt);
  */
 uint32_t ble_nus_string_send(ble_nus_t * p_nus, uint8_t * p_string, uint16_t length);
 
+/**@brief Function for queuing data to be streamed to the peer.
+ *
+ * @details The data is copied to the transmit buffer, and as much of the buffer as the
+ *          SoftDevice accepts is sent right away as RX characteristic notifications. The rest is
+ *          sent when the SoftDevice reports that packets were transmitted. Data that is still
+ *          queued when the link is disconnected is discarded.
+ *
+ * @param[in]    p_nus     Pointer to the Nordic UART Service structure.
+ * @param[in]    p_data    Data to be sent.
+ * @param[inout] p_length  Length of the data. Overwritten with the number of bytes that were
+ *                         queued, which is less than the length if the buffer was almost full.
+ *
+ * @retval NRF_SUCCESS             If the data was queued, fully or partially.
+ * @retval NRF_ERROR_NULL          If a parameter was NULL.
+ * @retval NRF_ERROR_INVALID_STATE If no transmit buffer was given at initialization, or the peer
+ *                                 is not connected or has not enabled notifications.
+ * @retval NRF_ERROR_NO_MEM        If the transmit buffer is full.
+ * @return Otherwise, an error code returned by @ref sd_ble_gatts_hvx.
+ */
+uint32_t ble_nus_stream_write(ble_nus_t * p_nus, uint8_t const * p_data, uint32_t * p_length);
+
+/**@brief Function for getting the streaming statistics.
+ *
+ * @param[in]  p_nus    Pointer to the Nordic UART Service structure.
+ * @param[out] p_stats  Statistics since the service was initialized.
+ *
+ * @retval NRF_SUCCESS    If the statistics were returned.
+ * @retval NRF_ERROR_NULL If a parameter was NULL.
+ */
+uint32_t ble_nus_stream_stats_get(ble_nus_t const * p_nus, ble_nus_stream_stats_t * p_stats);
+
 #endif // BLE_NUS_H__
 
 /** @} */
@@ -6,6 +6,7 @@
 #include "ble_srv_common.h"
 #include "app_error.h"
 #include "sdk_common.h"
+#include "app_util_platform.h"
 
 
 void ble_nus_c_on_db_disc_evt(ble_nus_c_t * p_ble_nus_c, ble_db_discovery_evt_t * p_evt)
@@ -77,6 +78,147 @@ static void on_hvx(ble_nus_c_t * p_ble_nus_c, const ble_evt_t * p_ble_evt)
     }
 }
 
+/**@brief Function for writing queued data until the queue is empty or the SoftDevice has no more
+ *        TX buffers.
+ *
+ * @param[in] p_ble_nus_c Pointer to the NUS Client structure.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code returned by @ref sd_ble_gattc_write.
+ */
+static uint32_t stream_tx_send(ble_nus_c_t * p_ble_nus_c)
+{
+    uint8_t                  packet[BLE_NUS_MAX_DATA_LEN];
+    uint8_t                * p_data;
+    uint32_t                 len;
+    uint32_t                 err_code;
+    ble_gattc_write_params_t write_params;
+
+    if (   (p_ble_nus_c->conn_handle == BLE_CONN_HANDLE_INVALID)
+        || (p_ble_nus_c->handles.nus_tx_handle == BLE_GATT_HANDLE_INVALID))
+    {
+        return NRF_SUCCESS;
+    }
+
+    memset(&write_params, 0, sizeof(write_params));
+
+    write_params.write_op = BLE_GATT_OP_WRITE_CMD;
+    write_params.flags    = BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE;
+    write_params.handle   = p_ble_nus_c->handles.nus_tx_handle;
+    write_params.offset   = 0;
+
+    // A packet that wraps around the end of the transmit buffer is copied to packet.
+    while (app_fifo_read_chunk_get(&p_ble_nus_c->tx_fifo, &p_data, packet, sizeof(packet), &len)
+           == NRF_SUCCESS)
+    {
+        write_params.len     = (uint16_t)len;
+        write_params.p_value = p_data;
+
+        // The packet is counted first, as BLE_EVT_TX_COMPLETE can report it before the SoftDevice
+        // call returns. The count is also decremented by the BLE event handler.
+        CRITICAL_REGION_ENTER();
+        p_ble_nus_c->packets_in_flight++;
+        CRITICAL_REGION_EXIT();
+
+        err_code = sd_ble_gattc_write(p_ble_nus_c->conn_handle, &write_params);
+        if (err_code != NRF_SUCCESS)
+        {
+            CRITICAL_REGION_ENTER();
+            if (p_ble_nus_c->packets_in_flight > 0)
+            {
+                p_ble_nus_c->packets_in_flight--;
+            }
+            CRITICAL_REGION_EXIT();
+        }
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Continued on BLE_EVT_TX_COMPLETE.
+            p_ble_nus_c->stream_stats.tx_buffers_full++;
+            return NRF_SUCCESS;
+        }
+        VERIFY_SUCCESS(err_code);
+
+        UNUSED_RETURN_VALUE(app_fifo_read_commit(&p_ble_nus_c->tx_fifo, len));
+        p_ble_nus_c->stream_stats.bytes_sent += len;
+        p_ble_nus_c->stream_stats.packets_sent++;
+    }
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Function for writing queued data, from the application or from the BLE event handler.
+ *
+ * @details The queue has a single reader. A call which interrupts the writing of the queue in
+ *          another context only makes the interrupted call go through the queue again, so that a
+ *          packet is never written and committed twice.
+ *
+ * @param[in] p_ble_nus_c Pointer to the NUS Client structure.
+ *
+ * @return NRF_SUCCESS on success or if the queue is being written in another context, otherwise
+ *         an error code returned by @ref sd_ble_gattc_write.
+ */
+static uint32_t stream_tx_pump(ble_nus_c_t * p_ble_nus_c)
+{
+    bool     is_busy;
+    uint32_t err_code;
+
+    CRITICAL_REGION_ENTER();
+    is_busy                           = p_ble_nus_c->is_tx_pump_busy;
+    p_ble_nus_c->is_tx_pump_busy      = true;
+    p_ble_nus_c->is_tx_pump_requested = true;
+    CRITICAL_REGION_EXIT();
+
+    if (is_busy)
+    {
+        return NRF_SUCCESS;
+    }
+
+    do
+    {
+        p_ble_nus_c->is_tx_pump_requested = false;
+
+        err_code = stream_tx_send(p_ble_nus_c);
+
+        CRITICAL_REGION_ENTER();
+        is_busy = p_ble_nus_c->is_tx_pump_requested && (err_code == NRF_SUCCESS);
+        p_ble_nus_c->is_tx_pump_busy = is_busy;
+        CRITICAL_REGION_EXIT();
+    } while (is_busy);
+
+    return err_code;
+}
+
+/**@brief     Function for handling the @ref BLE_EVT_TX_COMPLETE event from the SoftDevice.
+ *
+ * @param[in] p_ble_nus_c Pointer to the NUS Client structure.
+ * @param[in] p_ble_evt   Pointer to the BLE event received.
+ */
+static void on_tx_complete(ble_nus_c_t * p_ble_nus_c, const ble_evt_t * p_ble_evt)
+{
+    uint32_t count = p_ble_evt->evt.common_evt.params.tx_complete.count;
+
+    if (   !p_ble_nus_c->is_stream_enabled
+        || (p_ble_evt->evt.common_evt.conn_handle != p_ble_nus_c->conn_handle))
+    {
+        return;
+    }
+
+    // The count includes the packets of other modules on the link. The oldest packets are
+    // transmitted first, so the write commands of the client are at most those in flight.
+    count                           = MIN(count, p_ble_nus_c->packets_in_flight);
+    p_ble_nus_c->packets_in_flight -= count;
+
+    if (count > 0)
+    {
+        p_ble_nus_c->stream_stats.tx_complete_evts++;
+    }
+    p_ble_nus_c->stream_stats.packets_completed += count;
+    p_ble_nus_c->stream_stats.max_packets_per_evt =
+        MAX(p_ble_nus_c->stream_stats.max_packets_per_evt, (uint8_t)count);
+
+    // Errors are reported again by the next call to ble_nus_c_stream_write.
+    UNUSED_RETURN_VALUE(stream_tx_pump(p_ble_nus_c));
+}
+
 uint32_t ble_nus_c_init(ble_nus_c_t * p_ble_nus_c, ble_nus_c_init_t * p_ble_nus_c_init)
 {
     uint32_t      err_code;
@@ -96,6 +238,20 @@ uint32_t ble_nus_c_init(ble_nus_c_t * p_ble_nus_c, ble_nus_c_init_t * p_ble_nus_
     p_ble_nus_c->evt_handler           = p_ble_nus_c_init->evt_handler;
     p_ble_nus_c->handles.nus_rx_handle = BLE_GATT_HANDLE_INVALID;
     p_ble_nus_c->handles.nus_tx_handle = BLE_GATT_HANDLE_INVALID;
+    p_ble_nus_c->is_stream_enabled     = (p_ble_nus_c_init->p_tx_buf != NULL);
+
+    memset(&p_ble_nus_c->stream_stats, 0, sizeof(p_ble_nus_c->stream_stats));
+    p_ble_nus_c->packets_in_flight    = 0;
+    p_ble_nus_c->is_tx_pump_busy      = false;
+    p_ble_nus_c->is_tx_pump_requested = false;
+
+    if (p_ble_nus_c->is_stream_enabled)
+    {
+        err_code = app_fifo_init(&p_ble_nus_c->tx_fifo,
+                                 p_ble_nus_c_init->p_tx_buf,
+                                 p_ble_nus_c_init->tx_buf_size);
+        VERIFY_SUCCESS(err_code);
+    }
     
     return ble_db_discovery_evt_register(&uart_uuid);
 }
@@ -119,8 +275,18 @@ void ble_nus_c_on_ble_evt(ble_nus_c_t * p_ble_nus_c, const ble_evt_t * p_ble_evt
         case BLE_GATTC_EVT_HVX:
             on_hvx(p_ble_nus_c, p_ble_evt);
             break;
+
+        case BLE_EVT_TX_COMPLETE:
+            on_tx_complete(p_ble_nus_c, p_ble_evt);
+            break;
                 
         case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle == p_ble_nus_c->conn_handle
+                    && p_ble_nus_c->is_stream_enabled)
+            {
+                UNUSED_RETURN_VALUE(app_fifo_flush(&p_ble_nus_c->tx_fifo));
+                p_ble_nus_c->packets_in_flight = 0;
+            }
             if (p_ble_evt->evt.gap_evt.conn_handle == p_ble_nus_c->conn_handle
                     && p_ble_nus_c->evt_handler != NULL)
             {
@@ -195,6 +361,41 @@ uint32_t ble_nus_c_string_send(ble_nus_c_t * p_ble_nus_c, uint8_t * p_string, ui
 }
 
 
+uint32_t ble_nus_c_stream_write(ble_nus_c_t * p_ble_nus_c, uint8_t const * p_data, uint32_t * p_length)
+{
+    uint32_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_ble_nus_c);
+    VERIFY_PARAM_NOT_NULL(p_data);
+    VERIFY_PARAM_NOT_NULL(p_length);
+
+    if (   !p_ble_nus_c->is_stream_enabled
+        || (p_ble_nus_c->conn_handle == BLE_CONN_HANDLE_INVALID)
+        || (p_ble_nus_c->handles.nus_tx_handle == BLE_GATT_HANDLE_INVALID))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = app_fifo_write(&p_ble_nus_c->tx_fifo, p_data, p_length);
+    VERIFY_SUCCESS(err_code);
+
+    p_ble_nus_c->stream_stats.bytes_queued += *p_length;
+
+    return stream_tx_pump(p_ble_nus_c);
+}
+
+
+uint32_t ble_nus_c_stream_stats_get(ble_nus_c_t const * p_ble_nus_c, ble_nus_c_stream_stats_t * p_stats)
+{
+    VERIFY_PARAM_NOT_NULL(p_ble_nus_c);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    *p_stats = p_ble_nus_c->stream_stats;
+
+    return NRF_SUCCESS;
+}
+
+
 uint32_t ble_nus_c_handles_assign(ble_nus_c_t * p_ble_nus,
                                   const uint16_t conn_handle,
                                   const ble_nus_c_handles_t * p_peer_handles)
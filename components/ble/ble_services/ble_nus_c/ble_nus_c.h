@@ -32,6 +32,7 @@
 #include "ble.h"
 #include "ble_gatt.h"
 #include "ble_db_discovery.h"
+#include "app_fifo.h"
 
 #define NUS_BASE_UUID                  {{0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E}} /**< Used vendor specific UUID. */
 #define BLE_UUID_NUS_SERVICE           0x0001                      /**< The UUID of the Nordic UART Service. */
@@ -80,20 +81,48 @@ typedef struct ble_nus_c_s ble_nus_c_t;
 typedef void (* ble_nus_c_evt_handler_t)(ble_nus_c_t * p_ble_nus_c, const ble_nus_c_evt_t * p_evt);
 
 
+/**@brief NUS Client streaming statistics.
+ *
+ * @details The throughput in bytes per second is the difference in bytes_sent between two calls to
+ *          @ref ble_nus_c_stream_stats_get, divided by the time between the calls. The average
+ *          number of packets per connection event is packets_completed divided by
+ *          tx_complete_evts. Only the packets sent by the client are counted, not those of other
+ *          modules on the link.
+ */
+typedef struct
+{
+    uint32_t bytes_queued;        /**< Number of bytes accepted by @ref ble_nus_c_stream_write. */
+    uint32_t bytes_sent;          /**< Number of bytes handed to the SoftDevice. */
+    uint32_t packets_sent;        /**< Number of write commands handed to the SoftDevice. */
+    uint32_t packets_completed;   /**< Number of write commands transmitted, as reported by @ref BLE_EVT_TX_COMPLETE. */
+    uint32_t tx_complete_evts;    /**< Number of @ref BLE_EVT_TX_COMPLETE events that reported write commands. */
+    uint32_t tx_buffers_full;     /**< Number of times all the TX buffers of the SoftDevice were in use. */
+    uint8_t  max_packets_per_evt; /**< Largest number of packets reported by one @ref BLE_EVT_TX_COMPLETE event. */
+} ble_nus_c_stream_stats_t;
+
+
 /**@brief NUS Client structure.
  */
 struct ble_nus_c_s
 {
-    uint8_t                 uuid_type;          /**< UUID type. */
-    uint16_t                conn_handle;        /**< Handle of the current connection. Set with @ref ble_nus_c_handles_assign when connected. */
-    ble_nus_c_handles_t     handles;            /**< Handles on the connected peer device needed to interact with it. */
-    ble_nus_c_evt_handler_t evt_handler;        /**< Application event handler to be called when there is an event related to the NUS. */
+    uint8_t                  uuid_type;          /**< UUID type. */
+    uint16_t                 conn_handle;        /**< Handle of the current connection. Set with @ref ble_nus_c_handles_assign when connected. */
+    ble_nus_c_handles_t      handles;            /**< Handles on the connected peer device needed to interact with it. */
+    ble_nus_c_evt_handler_t  evt_handler;        /**< Application event handler to be called when there is an event related to the NUS. */
+    bool                     is_stream_enabled;  /**< Variable to indicate if a transmit buffer was given at initialization. */
+    app_fifo_t               tx_fifo;            /**< Queue of data written with @ref ble_nus_c_stream_write. */
+    ble_nus_c_stream_stats_t stream_stats;       /**< Streaming statistics. */
+    uint32_t                 packets_in_flight;  /**< Number of write commands handed to the SoftDevice and not yet reported as transmitted. */
+    volatile bool            is_tx_pump_busy;    /**< Variable to indicate if the transmit queue is being sent, in the application or in the BLE event handler. */
+    volatile bool            is_tx_pump_requested; /**< Variable to indicate if the queue must be sent again by the running pump. */
 };
 
 /**@brief NUS Client initialization structure.
  */
 typedef struct {
     ble_nus_c_evt_handler_t evt_handler;
+    uint8_t               * p_tx_buf;     /**< Buffer for the data queued by @ref ble_nus_c_stream_write. NULL if streaming is not used. */
+    uint16_t                tx_buf_size;  /**< Size of the transmit buffer. Must be a power of two. */
 } ble_nus_c_init_t;
 
 
@@ -112,6 +141,7 @@ typedef struct {
  *                        code is returned. This function
  *                        propagates the error code returned by the Database Discovery module API
  *                        @ref ble_db_discovery_evt_register.
+ * @retval    NRF_ERROR_INVALID_LENGTH If the size of the transmit buffer is not a power of two.
  */
 uint32_t ble_nus_c_init(ble_nus_c_t * p_ble_nus_c, ble_nus_c_init_t * p_ble_nus_c_init);
 
@@ -166,6 +196,38 @@ uint32_t ble_nus_c_rx_notif_enable(ble_nus_c_t * p_ble_nus_c);
  */
 uint32_t ble_nus_c_string_send(ble_nus_c_t * p_ble_nus_c, uint8_t * p_string, uint16_t length);
 
+/**@brief Function for queuing data to be streamed to the server.
+ *
+ * @details The data is copied to the transmit buffer, and as much of the buffer as the
+ *          SoftDevice accepts is written right away to the TX characteristic with write commands
+ *          of @ref BLE_NUS_MAX_DATA_LEN bytes. The rest is written when the SoftDevice reports that
+ *          packets were transmitted. Data that is still queued when the link is disconnected is
+ *          discarded.
+ *
+ * @param[in]    p_ble_nus_c Pointer to the NUS client structure.
+ * @param[in]    p_data      Data to be sent.
+ * @param[inout] p_length    Length of the data. Overwritten with the number of bytes that were
+ *                           queued, which is less than the length if the buffer was almost full.
+ *
+ * @retval NRF_SUCCESS             If the data was queued, fully or partially.
+ * @retval NRF_ERROR_NULL          If a parameter was NULL.
+ * @retval NRF_ERROR_INVALID_STATE If no transmit buffer was given at initialization, or the
+ *                                 server is not connected or its handles are not assigned.
+ * @retval NRF_ERROR_NO_MEM        If the transmit buffer is full.
+ * @return Otherwise, an error code returned by @ref sd_ble_gattc_write.
+ */
+uint32_t ble_nus_c_stream_write(ble_nus_c_t * p_ble_nus_c, uint8_t const * p_data, uint32_t * p_length);
+
+/**@brief Function for getting the streaming statistics.
+ *
+ * @param[in]  p_ble_nus_c Pointer to the NUS client structure.
+ * @param[out] p_stats     Statistics since the module was initialized.
+ *
+ * @retval NRF_SUCCESS    If the statistics were returned.
+ * @retval NRF_ERROR_NULL If a parameter was NULL.
+ */
+uint32_t ble_nus_c_stream_stats_get(ble_nus_c_t const * p_ble_nus_c, ble_nus_c_stream_stats_t * p_stats);
+
 
 /**@brief Function for assigning handles to a this instance of nus_c.
  *
@@ -0,0 +1,853 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the DB Discovery module with stored databases.
+ *
+ * @details The SoftDevice GATT client functions are replaced by a simulated GATT server. Each
+ *          simulated peer has a random database: the registered services, some of them missing,
+ *          and an unregistered one, in a random order, each with up to BLE_GATT_DB_MAX_CHARS
+ *          characteristics, some with a CCCD and some with another descriptor. The server answers
+ *          every request with the attributes of the peer, a few characteristics per response.
+ *
+ *          The Peer Manager functions used for stored databases are replaced as well. A database
+ *          store is completed later, from the buffer given to pm_peer_data_remote_db_store, as the
+ *          real Peer Manager does.
+ *
+ *          For each peer, a discovery is run on a new connection, and the DB Discovery structure
+ *          is cleared before the database store completes. On a second connection, the discovery
+ *          must complete from the stored database without any request. A Service Changed
+ *          indication then deletes the stored database, and the third discovery must send
+ *          requests again. Some peers are not bonded, and their databases must not be stored.
+ *
+ *          The events of every discovery must match the database of the peer, and the round trips
+ *          counted by the module must match the requests seen by the server.
+ *
+ *          New peers are then discovered CONN_COUNT at a time, on concurrent connections. The
+ *          server answers the pending requests of the connections in a random order, so that the
+ *          discoveries interleave, and the app_timer counter advances by one tick per response.
+ *          Each connection must get its own events, and the round trips and duration of its own
+ *          discovery. The peers are then connected to again, all at once.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "ble_db_discovery.h"
+#include "peer_manager.h"
+#include "app_timer.h"
+
+#define PEER_COUNT          200         /**< Number of simulated peers. */
+#define BONDED_PERCENT      80          /**< Share of the peers which are bonded. */
+#define MAX_ATTRS           64          /**< Maximum number of attributes of a peer. */
+#define CHARS_PER_RSP       3           /**< Maximum number of characteristics in a response. */
+#define DESCS_PER_RSP       4           /**< Maximum number of descriptors in a response. */
+#define CONN_COUNT          3           /**< Number of concurrent connections. */
+
+/**@brief Services registered by the test, in order. The last one is not registered. */
+static const uint16_t m_srv_uuids[] = {BLE_UUID_GATT, 0x180D, 0x180F, 0x1800};
+
+#define REGISTERED_COUNT    ((sizeof(m_srv_uuids) / sizeof(m_srv_uuids[0])) - 1)
+
+typedef enum
+{
+    ATTR_SERVICE,
+    ATTR_CHAR,
+    ATTR_VALUE,
+    ATTR_DESC,
+} attr_type_t;
+
+/**@brief Attribute of a simulated peer. Attributes are stored in handle order, from handle 1. */
+typedef struct
+{
+    attr_type_t type;
+    uint16_t    uuid;
+    uint16_t    end_handle;     /**< End of a service. */
+} attr_t;
+
+/**@brief Simulated peer. */
+typedef struct
+{
+    attr_t       attrs[MAX_ATTRS];
+    uint16_t     attr_count;
+    uint16_t     sc_handle;     /**< Value handle of the Service Changed characteristic. */
+    pm_peer_id_t peer_id;       /**< PM_PEER_ID_INVALID if not bonded. */
+    uint32_t     stored[BYTES_TO_WORDS(sizeof(ble_gatt_db_srv_t) * BLE_DB_DISCOVERY_MAX_SRV)];
+    uint16_t     stored_len;    /**< Length of the stored database, zero if none. */
+} peer_t;
+
+typedef enum
+{
+    REQ_NONE,
+    REQ_PRIM,
+    REQ_CHAR,
+    REQ_DESC,
+} req_type_t;
+
+/**@brief Simulated connection. */
+typedef struct
+{
+    uint16_t                 conn_handle;
+    peer_t                 * p_peer;
+    ble_db_discovery_t       db;
+    req_type_t               req;
+    uint16_t                 req_uuid;
+    ble_gattc_handle_range_t req_range;
+    uint32_t                 requests;
+    ble_db_discovery_evt_t   evts[BLE_DB_DISCOVERY_MAX_SRV];
+    uint32_t                 evt_count;
+    uint32_t                 start_ticks;
+} conn_t;
+
+/**@brief Database store waiting to be written by the simulated Peer Manager. */
+typedef struct
+{
+    pm_peer_id_t              peer_id;
+    ble_gatt_db_srv_t const * p_data;
+    uint16_t                  len;
+} pending_store_t;
+
+static peer_t          m_peers[PEER_COUNT];
+static conn_t          m_conns[CONN_COUNT];
+static uint32_t        m_ticks;         /**< Counter returned by app_timer_cnt_get. */
+static pending_store_t m_pending_store;
+static uint32_t        m_evt_buf[64];   /**< BLE event, with room for the variable length arrays. */
+static uint32_t        m_failures;
+static uint64_t        m_rand_state = 88172645463325252ULL;
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for getting the connection of a connection handle. */
+static conn_t * conn_get(uint16_t conn_handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < CONN_COUNT; i++)
+    {
+        if ((m_conns[i].p_peer != NULL) && (m_conns[i].conn_handle == conn_handle))
+        {
+            return &m_conns[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**@brief Function for adding an attribute to a peer.
+ *
+ * @return Handle of the attribute.
+ */
+static uint16_t attr_add(peer_t * p_peer, attr_type_t type, uint16_t uuid)
+{
+    p_peer->attrs[p_peer->attr_count].type       = type;
+    p_peer->attrs[p_peer->attr_count].uuid       = uuid;
+    p_peer->attrs[p_peer->attr_count].end_handle = 0;
+    p_peer->attr_count++;
+
+    return p_peer->attr_count;
+}
+
+
+static attr_t const * attr_get(peer_t const * p_peer, uint16_t handle)
+{
+    return &p_peer->attrs[handle - 1];
+}
+
+
+/**@brief Function for generating the database of a peer. */
+static void peer_generate(peer_t * p_peer, pm_peer_id_t peer_id)
+{
+    uint16_t order[REGISTERED_COUNT + 1];
+    uint32_t i;
+    uint32_t j;
+
+    memset(p_peer, 0, sizeof(*p_peer));
+    p_peer->peer_id = ((rand_get() % 100) < BONDED_PERCENT) ? peer_id : PM_PEER_ID_INVALID;
+
+    memcpy(order, m_srv_uuids, sizeof(order));
+    for (i = 0; i < REGISTERED_COUNT + 1; i++)
+    {
+        uint32_t k   = i + rand_get() % (REGISTERED_COUNT + 1 - i);
+        uint16_t tmp = order[i];
+
+        order[i] = order[k];
+        order[k] = tmp;
+    }
+
+    for (i = 0; i < REGISTERED_COUNT + 1; i++)
+    {
+        uint16_t srv_handle;
+        uint32_t char_count;
+
+        // The GATT service is always present, the others are missing now and then.
+        if ((order[i] != BLE_UUID_GATT) && ((rand_get() % 5) == 0))
+        {
+            continue;
+        }
+
+        srv_handle = attr_add(p_peer, ATTR_SERVICE, order[i]);
+        char_count = (order[i] == BLE_UUID_GATT) ? 1 : rand_get() % (BLE_GATT_DB_MAX_CHARS + 1);
+
+        for (j = 0; j < char_count; j++)
+        {
+            uint16_t uuid = (order[i] == BLE_UUID_GATT)
+                            ? BLE_UUID_GATT_CHARACTERISTIC_SERVICE_CHANGED
+                            : (uint16_t)(0x2A10 + rand_get() % 0x70);
+            uint16_t value_handle;
+
+            (void)attr_add(p_peer, ATTR_CHAR, uuid);
+            value_handle = attr_add(p_peer, ATTR_VALUE, uuid);
+
+            if (uuid == BLE_UUID_GATT_CHARACTERISTIC_SERVICE_CHANGED)
+            {
+                p_peer->sc_handle = value_handle;
+                (void)attr_add(p_peer, ATTR_DESC, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+                continue;
+            }
+            if ((rand_get() % 3) == 0)
+            {
+                (void)attr_add(p_peer, ATTR_DESC, BLE_UUID_DESCRIPTOR_CHAR_USER_DESC);
+            }
+            if ((rand_get() % 2) == 0)
+            {
+                (void)attr_add(p_peer, ATTR_DESC, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG);
+            }
+        }
+
+        p_peer->attrs[srv_handle - 1].end_handle = p_peer->attr_count;
+    }
+
+    // The last service of a database often extends to the last handle.
+    if ((rand_get() % 2) == 0)
+    {
+        for (i = p_peer->attr_count; i > 0; i--)
+        {
+            if (p_peer->attrs[i - 1].type == ATTR_SERVICE)
+            {
+                p_peer->attrs[i - 1].end_handle = 0xFFFF;
+                break;
+            }
+        }
+    }
+}
+
+
+/**@brief Function for checking a discovered service against the database of the peer. */
+static void srv_check(peer_t const * p_peer, ble_db_discovery_evt_t const * p_evt, uint16_t uuid)
+{
+    ble_gatt_db_srv_t const * p_srv      = &p_evt->params.discovered_db;
+    uint16_t                  srv_handle = 0;
+    uint16_t                  handle;
+    uint32_t                  char_count = 0;
+
+    for (handle = 1; handle <= p_peer->attr_count; handle++)
+    {
+        attr_t const * p_attr = attr_get(p_peer, handle);
+
+        if ((p_attr->type == ATTR_SERVICE) && (p_attr->uuid == uuid))
+        {
+            srv_handle = handle;
+            break;
+        }
+    }
+
+    check(p_srv->srv_uuid.uuid == uuid, "service UUID", uuid);
+
+    if (srv_handle == 0)
+    {
+        check(p_evt->evt_type == BLE_DB_DISCOVERY_SRV_NOT_FOUND, "service not found", uuid);
+        return;
+    }
+
+    check(p_evt->evt_type == BLE_DB_DISCOVERY_COMPLETE, "service found", uuid);
+    check(p_srv->handle_range.start_handle == srv_handle, "service start handle", uuid);
+    check(p_srv->handle_range.end_handle == attr_get(p_peer, srv_handle)->end_handle,
+          "service end handle", uuid);
+
+    for (handle = srv_handle + 1;
+         (handle <= p_peer->attr_count) && (attr_get(p_peer, handle)->type != ATTR_SERVICE);
+         handle++)
+    {
+        ble_gatt_db_char_t const * p_char;
+        uint16_t                   cccd_handle = BLE_GATT_HANDLE_INVALID;
+        uint16_t                   desc;
+
+        if (attr_get(p_peer, handle)->type != ATTR_CHAR)
+        {
+            continue;
+        }
+
+        for (desc = handle + 2;
+             (desc <= p_peer->attr_count) && (attr_get(p_peer, desc)->type == ATTR_DESC);
+             desc++)
+        {
+            if (attr_get(p_peer, desc)->uuid == BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG)
+            {
+                cccd_handle = desc;
+            }
+        }
+
+        p_char = &p_srv->charateristics[char_count];
+        check(p_char->characteristic.handle_decl == handle, "characteristic handle", handle);
+        check(p_char->characteristic.handle_value == handle + 1, "value handle", handle);
+        check(p_char->characteristic.uuid.uuid == attr_get(p_peer, handle)->uuid,
+              "characteristic UUID", handle);
+        check(p_char->cccd_handle == cccd_handle, "CCCD handle", handle);
+        char_count++;
+    }
+
+    check(p_srv->char_count == char_count, "characteristic count", uuid);
+}
+
+
+/**@brief Function for checking the events of a completed discovery. */
+static void evts_check(conn_t const * p_conn)
+{
+    uint32_t i;
+
+    check(p_conn->evt_count == REGISTERED_COUNT, "event count", p_conn->evt_count);
+
+    for (i = 0; (i < p_conn->evt_count) && (i < REGISTERED_COUNT); i++)
+    {
+        check(p_conn->evts[i].conn_handle == p_conn->conn_handle, "event connection", i);
+        srv_check(p_conn->p_peer, &p_conn->evts[i], m_srv_uuids[i]);
+    }
+}
+
+
+static void db_disc_handler(ble_db_discovery_evt_t * p_evt)
+{
+    conn_t * p_conn = conn_get(p_evt->conn_handle);
+
+    check(p_conn != NULL, "event of unknown connection", p_evt->conn_handle);
+    if ((p_conn == NULL) || (p_conn->evt_count == BLE_DB_DISCOVERY_MAX_SRV))
+    {
+        return;
+    }
+
+    // The events of a connection are sent together, when its last service has been discovered.
+    if (p_conn->evt_count == 0)
+    {
+        check(p_conn->db.duration_ticks == m_ticks - p_conn->start_ticks, "duration",
+              p_conn->db.duration_ticks);
+    }
+
+    p_conn->evts[p_conn->evt_count++] = *p_evt;
+}
+
+
+/**@brief Function for passing a BLE event to the DB Discovery module, as the application does. */
+static void ble_evt_dispatch(ble_evt_t const * p_ble_evt)
+{
+    uint32_t i;
+
+    for (i = 0; i < CONN_COUNT; i++)
+    {
+        ble_db_discovery_on_ble_evt(&m_conns[i].db, p_ble_evt);
+    }
+}
+
+
+static ble_evt_t * evt_get(uint16_t evt_id, uint16_t conn_handle)
+{
+    ble_evt_t * p_ble_evt = (ble_evt_t *)m_evt_buf;
+
+    memset(m_evt_buf, 0, sizeof(m_evt_buf));
+    p_ble_evt->header.evt_id             = evt_id;
+    p_ble_evt->evt.gattc_evt.conn_handle = conn_handle;
+    p_ble_evt->evt.gattc_evt.gatt_status = BLE_GATT_STATUS_SUCCESS;
+
+    return p_ble_evt;
+}
+
+
+/**@brief Function for recording a request of the module. */
+static uint32_t request_record(uint16_t                         conn_handle,
+                               req_type_t                       req,
+                               uint16_t                         uuid,
+                               ble_gattc_handle_range_t const * p_range)
+{
+    conn_t * p_conn = conn_get(conn_handle);
+
+    check(p_conn != NULL, "request on unknown connection", conn_handle);
+    if (p_conn == NULL)
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (p_conn->req != REQ_NONE)
+    {
+        // The SoftDevice allows one GATT client procedure at a time.
+        check(false, "request while busy", conn_handle);
+        return NRF_ERROR_BUSY;
+    }
+
+    p_conn->req       = req;
+    p_conn->req_uuid  = uuid;
+    p_conn->req_range = *p_range;
+    p_conn->requests++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t           conn_handle,
+                                                uint16_t           start_handle,
+                                                ble_uuid_t const * p_srvc_uuid)
+{
+    ble_gattc_handle_range_t range = {start_handle, 0xFFFF};
+
+    return request_record(conn_handle, REQ_PRIM, p_srvc_uuid->uuid, &range);
+}
+
+
+uint32_t sd_ble_gattc_characteristics_discover(uint16_t                         conn_handle,
+                                               ble_gattc_handle_range_t const * p_handle_range)
+{
+    return request_record(conn_handle, REQ_CHAR, 0, p_handle_range);
+}
+
+
+uint32_t sd_ble_gattc_descriptors_discover(uint16_t                         conn_handle,
+                                           ble_gattc_handle_range_t const * p_handle_range)
+{
+    return request_record(conn_handle, REQ_DESC, 0, p_handle_range);
+}
+
+
+/**@brief Function for answering the pending request of a connection. */
+static void request_answer(conn_t * p_conn)
+{
+    peer_t   const * p_peer = p_conn->p_peer;
+    uint16_t         start  = p_conn->req_range.start_handle;
+    uint16_t         end    = p_conn->req_range.end_handle;
+    uint16_t         last   = (end < p_peer->attr_count) ? end : p_peer->attr_count;
+    ble_evt_t      * p_ble_evt;
+    uint16_t         handle;
+    uint16_t         count  = 0;
+
+    switch (p_conn->req)
+    {
+        case REQ_PRIM:
+        {
+            ble_gattc_evt_prim_srvc_disc_rsp_t * p_rsp;
+
+            p_ble_evt = evt_get(BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP, p_conn->conn_handle);
+            p_rsp     = &p_ble_evt->evt.gattc_evt.params.prim_srvc_disc_rsp;
+
+            for (handle = start; (handle <= last) && (count == 0); handle++)
+            {
+                attr_t const * p_attr = attr_get(p_peer, handle);
+
+                if ((p_attr->type == ATTR_SERVICE) && (p_attr->uuid == p_conn->req_uuid))
+                {
+                    p_rsp->services[0].uuid.uuid                 = p_attr->uuid;
+                    p_rsp->services[0].uuid.type                 = BLE_UUID_TYPE_BLE;
+                    p_rsp->services[0].handle_range.start_handle = handle;
+                    p_rsp->services[0].handle_range.end_handle   = p_attr->end_handle;
+                    count++;
+                }
+            }
+            p_rsp->count = count;
+        } break;
+
+        case REQ_CHAR:
+        {
+            ble_gattc_evt_char_disc_rsp_t * p_rsp;
+
+            p_ble_evt = evt_get(BLE_GATTC_EVT_CHAR_DISC_RSP, p_conn->conn_handle);
+            p_rsp     = &p_ble_evt->evt.gattc_evt.params.char_disc_rsp;
+
+            for (handle = start; (handle <= last) && (count < CHARS_PER_RSP); handle++)
+            {
+                attr_t const * p_attr = attr_get(p_peer, handle);
+
+                if (p_attr->type == ATTR_CHAR)
+                {
+                    p_rsp->chars[count].uuid.uuid    = p_attr->uuid;
+                    p_rsp->chars[count].uuid.type    = BLE_UUID_TYPE_BLE;
+                    p_rsp->chars[count].handle_decl  = handle;
+                    p_rsp->chars[count].handle_value = handle + 1;
+                    count++;
+                }
+            }
+            p_rsp->count = count;
+        } break;
+
+        case REQ_DESC:
+        {
+            ble_gattc_evt_desc_disc_rsp_t * p_rsp;
+
+            p_ble_evt = evt_get(BLE_GATTC_EVT_DESC_DISC_RSP, p_conn->conn_handle);
+            p_rsp     = &p_ble_evt->evt.gattc_evt.params.desc_disc_rsp;
+
+            for (handle = start; (handle <= last) && (count < DESCS_PER_RSP); handle++)
+            {
+                attr_t const * p_attr = attr_get(p_peer, handle);
+
+                p_rsp->descs[count].uuid.uuid = p_attr->uuid;
+                p_rsp->descs[count].uuid.type = BLE_UUID_TYPE_BLE;
+                p_rsp->descs[count].handle    = handle;
+                count++;
+            }
+            p_rsp->count = count;
+        } break;
+
+        default:
+            return;
+    }
+
+    if (count == 0)
+    {
+        p_ble_evt->evt.gattc_evt.gatt_status = BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND;
+    }
+
+    p_conn->req = REQ_NONE;
+    m_ticks++;
+    ble_evt_dispatch(p_ble_evt);
+}
+
+
+ret_code_t pm_peer_id_get(uint16_t conn_handle, pm_peer_id_t * p_peer_id)
+{
+    conn_t * p_conn = conn_get(conn_handle);
+
+    if ((p_conn == NULL) || (p_conn->p_peer->peer_id == PM_PEER_ID_INVALID))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_peer_id = p_conn->p_peer->peer_id;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pm_peer_data_remote_db_store(pm_peer_id_t              peer_id,
+                                        ble_gatt_db_srv_t const * p_data,
+                                        uint16_t                  length,
+                                        pm_store_token_t        * p_token)
+{
+    check(peer_id < PEER_COUNT, "store of unknown peer", peer_id);
+    check(m_peers[peer_id].peer_id == peer_id, "store of peer not bonded", peer_id);
+    check(m_pending_store.p_data == NULL, "store while busy", peer_id);
+    check((length % 4) == 0, "store length", length);
+    check(length <= sizeof(m_peers[0].stored), "store length", length);
+
+    m_pending_store.peer_id = peer_id;
+    m_pending_store.p_data  = p_data;
+    m_pending_store.len     = length;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for completing the pending database store, from the buffer it was given. */
+static void pending_store_write(void)
+{
+    if (m_pending_store.p_data != NULL)
+    {
+        peer_t * p_peer = &m_peers[m_pending_store.peer_id];
+
+        memcpy(p_peer->stored, m_pending_store.p_data, m_pending_store.len);
+        p_peer->stored_len     = m_pending_store.len;
+        m_pending_store.p_data = NULL;
+    }
+}
+
+
+ret_code_t pm_peer_data_remote_db_load(pm_peer_id_t        peer_id,
+                                       ble_gatt_db_srv_t * p_data,
+                                       uint16_t          * p_length)
+{
+    peer_t const * p_peer = &m_peers[peer_id];
+
+    if (p_peer->stored_len == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (*p_length < p_peer->stored_len)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    memcpy(p_data, p_peer->stored, p_peer->stored_len);
+    *p_length = p_peer->stored_len;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pm_peer_data_delete(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    check(data_id == PM_PEER_DATA_ID_GATT_REMOTE, "deleted data", data_id);
+
+    m_peers[peer_id].stored_len = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(uint32_t * p_ticks)
+{
+    *p_ticks = m_ticks;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from, uint32_t * p_ticks_diff)
+{
+    *p_ticks_diff = (ticks_to - ticks_from) & 0x00FFFFFF;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for connecting to a peer and starting a discovery. */
+static void conn_start(conn_t * p_conn, uint16_t conn_handle, peer_t * p_peer)
+{
+    uint32_t err_code;
+
+    memset(p_conn, 0, sizeof(*p_conn));
+    p_conn->conn_handle = conn_handle;
+    p_conn->p_peer      = p_peer;
+    p_conn->start_ticks = m_ticks;
+
+    err_code = ble_db_discovery_start(&p_conn->db, p_conn->conn_handle);
+    check(err_code == NRF_SUCCESS, "ble_db_discovery_start", err_code);
+}
+
+
+/**@brief Function for checking a completed discovery.
+ *
+ * @return Number of requests sent to the peer.
+ */
+static uint32_t conn_check(conn_t const * p_conn)
+{
+    evts_check(p_conn);
+    check(p_conn->db.round_trips == p_conn->requests, "round trips", p_conn->db.round_trips);
+    check(!p_conn->db.discovery_in_progress, "discovery in progress", p_conn->conn_handle);
+
+    return p_conn->requests;
+}
+
+
+/**@brief Function for connecting to a peer and running a discovery until it completes.
+ *
+ * @return Number of requests sent to the peer.
+ */
+static uint32_t discovery_run(peer_t * p_peer)
+{
+    conn_t * p_conn = &m_conns[0];
+
+    conn_start(p_conn, 1, p_peer);
+
+    while (p_conn->req != REQ_NONE)
+    {
+        request_answer(p_conn);
+    }
+
+    return conn_check(p_conn);
+}
+
+
+/**@brief Function for running discoveries on all connections at once, answering the requests of
+ *        the connections in a random order.
+ *
+ * @details A database store is written as soon as it is requested, as a store of the Peer Manager
+ *          takes less time than a discovery.
+ *
+ * @return Number of requests sent to the peers.
+ */
+static uint32_t discoveries_interleave(peer_t * p_peers)
+{
+    uint32_t requests = 0;
+    uint32_t pending;
+    uint32_t i;
+
+    for (i = 0; i < CONN_COUNT; i++)
+    {
+        conn_start(&m_conns[i], (uint16_t)(i + 1), &p_peers[i]);
+        pending_store_write();
+    }
+
+    do
+    {
+        conn_t * p_pending[CONN_COUNT];
+
+        pending = 0;
+        for (i = 0; i < CONN_COUNT; i++)
+        {
+            if (m_conns[i].req != REQ_NONE)
+            {
+                p_pending[pending++] = &m_conns[i];
+            }
+        }
+
+        if (pending > 0)
+        {
+            request_answer(p_pending[rand_get() % pending]);
+            pending_store_write();
+        }
+    } while (pending > 0);
+
+    for (i = 0; i < CONN_COUNT; i++)
+    {
+        requests += conn_check(&m_conns[i]);
+    }
+
+    return requests;
+}
+
+
+/**@brief Function for indicating Service Changed on the first connection. */
+static void service_changed_indicate(void)
+{
+    ble_evt_t * p_ble_evt = evt_get(BLE_GATTC_EVT_HVX, m_conns[0].conn_handle);
+
+    p_ble_evt->evt.gattc_evt.params.hvx.type   = BLE_GATT_HVX_INDICATION;
+    p_ble_evt->evt.gattc_evt.params.hvx.handle = m_conns[0].p_peer->sc_handle;
+    ble_evt_dispatch(p_ble_evt);
+}
+
+
+int main(void)
+{
+    ble_db_discovery_cache_stats_t stats;
+    ble_db_discovery_cache_stats_t stats_concurrent;
+    uint32_t                       requests  = 0;
+    uint32_t                       full_reqs = 0;
+    uint32_t                       bonded    = 0;
+    uint32_t                       i;
+
+    APP_ERROR_CHECK(ble_db_discovery_init(db_disc_handler));
+    for (i = 0; i < REGISTERED_COUNT; i++)
+    {
+        ble_uuid_t uuid = {m_srv_uuids[i], BLE_UUID_TYPE_BLE};
+
+        APP_ERROR_CHECK(ble_db_discovery_evt_register(&uuid));
+    }
+
+    for (i = 0; i < PEER_COUNT; i++)
+    {
+        peer_t * p_peer = &m_peers[i];
+        uint32_t first;
+
+        peer_generate(p_peer, (pm_peer_id_t)i);
+
+        // First connection. The structure is cleared before the database is written, as the
+        // application can reuse it as soon as the discovery is complete.
+        first     = discovery_run(p_peer);
+        requests += first;
+        memset(&m_conns[0].db, 0, sizeof(m_conns[0].db));
+        check((m_pending_store.p_data != NULL) == (p_peer->peer_id != PM_PEER_ID_INVALID),
+              "database stored", i);
+        pending_store_write();
+
+        if (p_peer->peer_id == PM_PEER_ID_INVALID)
+        {
+            continue;
+        }
+        bonded++;
+        full_reqs += first;
+
+        // Second connection, completed from the stored database.
+        check(discovery_run(p_peer) == 0, "requests with a stored database", i);
+
+        // Service Changed deletes the stored database.
+        service_changed_indicate();
+        check(p_peer->stored_len == 0, "stored database deleted", i);
+
+        // Third connection, discovered again.
+        requests += discovery_run(p_peer);
+        pending_store_write();
+    }
+
+    APP_ERROR_CHECK(ble_db_discovery_cache_stats_get(&stats));
+    check(stats.cache_hits == bonded, "cache_hits", stats.cache_hits);
+    check(stats.cache_misses == 2 * bonded, "cache_misses", stats.cache_misses);
+    check(stats.cache_invalidations == bonded, "cache_invalidations", stats.cache_invalidations);
+    check(stats.round_trips == requests, "round_trips", stats.round_trips);
+    check(stats.round_trips_avoided <= full_reqs, "round_trips_avoided", stats.round_trips_avoided);
+
+    printf("ble_db_discovery: %u peers, %u bonded, %u requests, %u hits, %u misses, "
+           "%u round trips avoided\n",
+           (unsigned int)PEER_COUNT, (unsigned int)bonded, (unsigned int)requests,
+           (unsigned int)stats.cache_hits, (unsigned int)stats.cache_misses,
+           (unsigned int)stats.round_trips_avoided);
+
+    // Concurrent connections, to new peers, then again to the same peers. The second discovery of
+    // a bonded peer is completed from its stored database.
+    requests = 0;
+    bonded   = 0;
+    for (i = 0; i < PEER_COUNT; i++)
+    {
+        peer_generate(&m_peers[i], (pm_peer_id_t)i);
+    }
+    for (i = 0; i + CONN_COUNT <= PEER_COUNT; i += CONN_COUNT)
+    {
+        uint32_t j;
+
+        requests += discoveries_interleave(&m_peers[i]);
+        requests += discoveries_interleave(&m_peers[i]);
+
+        for (j = 0; j < CONN_COUNT; j++)
+        {
+            if (m_conns[j].p_peer->peer_id != PM_PEER_ID_INVALID)
+            {
+                check(m_conns[j].requests == 0, "concurrent requests with a stored database",
+                      i + j);
+                bonded++;
+            }
+        }
+    }
+
+    stats.cache_hits += bonded;
+    APP_ERROR_CHECK(ble_db_discovery_cache_stats_get(&stats_concurrent));
+    check(stats_concurrent.cache_hits == stats.cache_hits, "concurrent cache_hits",
+          stats_concurrent.cache_hits);
+
+    printf("ble_db_discovery: %u peers on %u concurrent connections, %u requests, %u ticks\n",
+           (unsigned int)PEER_COUNT, (unsigned int)CONN_COUNT, (unsigned int)requests,
+           (unsigned int)m_ticks);
+
+    if (m_failures != 0)
+    {
+        printf("ble_db_discovery_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
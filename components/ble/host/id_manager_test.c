@@ -0,0 +1,635 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the resolution of resolvable private addresses by the ID Manager.
+ *
+ * @details The peer database is replaced by PEER_COUNT bonded peers with random IRKs, more than fit
+ *          in the IRK cache of the module, and the SoftDevice ECB by the software AES library. The
+ *          addresses resolved by the test are generated from the IRKs of the peers, from IRKs of
+ *          unknown devices, or are not resolvable.
+ *
+ *          A model of the list of recently resolved addresses predicts, for every address, whether
+ *          it is found in the list or resolved against the IRKs, the ECB operations and the reads
+ *          of bonding data this takes. The peer IDs found, the statistics of the module and the
+ *          ECB operations and reads seen by the replaced functions must match the model.
+ *
+ *          Directed runs check that the least recently used address is evicted from the list,
+ *          that an address repeated in one batch is resolved once, and that the cache is
+ *          discarded when bonding data changes. A random run then resolves random batches.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "id_manager.h"
+#include "peer_database.h"
+#include "nrf_soc.h"
+#include "ble_conn_state.h"
+#include "aes.h"
+
+#define IRK_CACHE_SIZE      16          /**< IM_IRK_CACHE_SIZE of id_manager.c. */
+#define RPA_LRU_SIZE        8           /**< IM_RPA_LRU_SIZE of id_manager.c. */
+#define RESOLVE_BATCH_SIZE  8           /**< IM_RESOLVE_BATCH_SIZE of id_manager.c. */
+#define PEER_COUNT          24          /**< Number of bonded peers. */
+#define PEER_HAS_IRK(p)     (((p) != 3) && ((p) != 17))
+#define IRK_PEER_COUNT      (PEER_COUNT - 2)
+#define ADDRS_PER_PEER      2           /**< Number of resolvable addresses generated from the IRK of each peer. */
+#define STRANGER_COUNT      4           /**< Number of resolvable addresses of unknown devices. */
+#define OTHER_COUNT         4           /**< Number of addresses which are not resolvable. */
+#define STRANGER_FIRST      (IRK_PEER_COUNT * ADDRS_PER_PEER)    /**< Index of the first address of an unknown device. */
+#define OTHER_FIRST         (STRANGER_FIRST + STRANGER_COUNT)    /**< Index of the first address which is not resolvable. */
+#define ADDR_COUNT          (OTHER_FIRST + OTHER_COUNT)
+#define MAX_BATCH_LEN       20          /**< Longest batch of the random run. */
+#define RANDOM_BATCHES      5000        /**< Number of batches of the random run. */
+
+/**@brief An address resolved by the test, with the result expected from the module. */
+typedef struct
+{
+    ble_gap_addr_t addr;
+    pm_peer_id_t   peer_id;     /**< Peer the address resolves to, or PM_PEER_ID_INVALID. */
+    uint16_t       ecb_calls;   /**< ECB operations needed to resolve the address. */
+    uint16_t       reads;       /**< Reads of bonding data needed to resolve the address, once the IRK cache is loaded. */
+} test_addr_t;
+
+static pm_peer_data_bonding_t m_bonding[PEER_COUNT];
+static test_addr_t            m_addrs[ADDR_COUNT];
+static pdb_evt_handler_t      m_pdb_evt_handler;
+static uint32_t               m_ecb_calls;            /**< ECB operations seen by sd_ecb_block_encrypt. */
+static uint32_t               m_reads;                /**< Reads of bonding data seen by pdb_read_buf_get. */
+static uint32_t               m_lru[RPA_LRU_SIZE];    /**< Model of the list of recently resolved addresses, by address index, most recently used first. */
+static uint32_t               m_lru_count;
+static bool                   m_cache_loaded;
+static uint32_t               m_failures;
+static uint64_t               m_rand_state = 88172645463325252ULL;
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+uint32_t sd_ecb_block_encrypt(nrf_ecb_hal_data_t * p_ecb_data)
+{
+    aes128_context_t aes_ctx;
+
+    (void)aes128_init(&aes_ctx, p_ecb_data->key);
+    (void)aes128_ecb_encrypt(&aes_ctx, p_ecb_data->cleartext, p_ecb_data->ciphertext, 1);
+    m_ecb_calls++;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_register(pdb_evt_handler_t evt_handler)
+{
+    m_pdb_evt_handler = evt_handler;
+    return NRF_SUCCESS;
+}
+
+
+pm_peer_id_t pdb_next_peer_id_get(pm_peer_id_t prev_peer_id)
+{
+    if (prev_peer_id == PM_PEER_ID_INVALID)
+    {
+        return 0;
+    }
+    return (prev_peer_id + 1 < PEER_COUNT) ? (prev_peer_id + 1) : PM_PEER_ID_INVALID;
+}
+
+
+ret_code_t pdb_read_buf_get(pm_peer_id_t           peer_id,
+                            pm_peer_data_id_t      data_id,
+                            pm_peer_data_flash_t * p_peer_data,
+                            pm_store_token_t     * p_token)
+{
+    check(peer_id < PEER_COUNT, "peer ID read", peer_id);
+    check(data_id == PM_PEER_DATA_ID_BONDING, "data ID read", data_id);
+
+    p_peer_data->data_id        = data_id;
+    p_peer_data->length_words   = BYTES_TO_WORDS(sizeof(pm_peer_data_bonding_t));
+    p_peer_data->p_bonding_data = &m_bonding[peer_id];
+    m_reads++;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_peer_free(pm_peer_id_t peer_id)
+{
+    return NRF_SUCCESS;
+}
+
+
+ble_conn_state_user_flag_id_t ble_conn_state_user_flag_acquire(void)
+{
+    return BLE_CONN_STATE_USER_FLAG0;
+}
+
+
+bool ble_conn_state_user_flag_get(uint16_t conn_handle, ble_conn_state_user_flag_id_t flag_id)
+{
+    return false;
+}
+
+
+void ble_conn_state_user_flag_set(uint16_t                      conn_handle,
+                                  ble_conn_state_user_flag_id_t flag_id,
+                                  bool                          value)
+{
+}
+
+
+ble_conn_state_status_t ble_conn_state_status(uint16_t conn_handle)
+{
+    return BLE_CONN_STATUS_INVALID;
+}
+
+
+static void im_evt_handler(im_evt_t const * p_event)
+{
+}
+
+
+/**@brief Function for generating a resolvable address from an IRK, as in Bluetooth core
+ *        specification 4.2 section 3.H.2.2.2, independently of the module.
+ */
+static void rpa_generate(uint8_t const * p_irk, ble_gap_addr_t * p_addr)
+{
+    aes128_context_t aes_ctx;
+    uint8_t          key[AES128_BLOCK_SIZE];
+    uint8_t          block[AES128_BLOCK_SIZE] = {0};
+
+    p_addr->addr_type = BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE;
+    p_addr->addr[3]   = rand_get();
+    p_addr->addr[4]   = rand_get();
+    p_addr->addr[5]   = (rand_get() & 0x3F) | 0x40;
+
+    // The IRK and the address are little endian, the AES input and output big endian.
+    for (uint32_t i = 0; i < AES128_BLOCK_SIZE; i++)
+    {
+        key[i] = p_irk[AES128_BLOCK_SIZE - 1 - i];
+    }
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        block[AES128_BLOCK_SIZE - 1 - i] = p_addr->addr[3 + i];
+    }
+    (void)aes128_init(&aes_ctx, key);
+    (void)aes128_ecb_encrypt(&aes_ctx, block, block, 1);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        p_addr->addr[i] = block[AES128_BLOCK_SIZE - 1 - i];
+    }
+}
+
+
+/**@brief Function for making the bonded peers and the addresses resolved by the test.
+ *
+ * @details Two peers have no IRK. The IRKs of the others are cached in peer ID order, up to
+ *          IRK_CACHE_SIZE, and the module tries them in that order; the remaining peers are read
+ *          from flash after the cache, again in peer ID order. Either way, the address of the n-th
+ *          peer with an IRK takes n + 1 ECB operations, and an unknown address one per peer with
+ *          an IRK.
+ */
+static void addrs_make(void)
+{
+    uint32_t n_irks     = 0;
+    uint32_t n_uncached = 0;
+    uint32_t a          = 0;
+
+    for (uint32_t p = 0; p < PEER_COUNT; p++)
+    {
+        bool has_irk = PEER_HAS_IRK(p);
+
+        memset(&m_bonding[p], 0, sizeof(m_bonding[p]));
+        if (has_irk)
+        {
+            for (uint32_t i = 0; i < BLE_GAP_SEC_KEY_LEN; i++)
+            {
+                m_bonding[p].peer_id.id_info.irk[i] = rand_get();
+            }
+            m_bonding[p].peer_id.id_info.irk[0] |= 1;
+            n_irks++;
+        }
+        if (n_irks > IRK_CACHE_SIZE || !has_irk)
+        {
+            // Peers without an IRK are not cached, but are read from flash.
+            n_uncached++;
+        }
+
+        for (uint32_t k = 0; has_irk && (k < ADDRS_PER_PEER); k++, a++)
+        {
+            rpa_generate(m_bonding[p].peer_id.id_info.irk, &m_addrs[a].addr);
+            m_addrs[a].peer_id   = p;
+            m_addrs[a].ecb_calls = n_irks;
+            m_addrs[a].reads     = (n_irks > IRK_CACHE_SIZE) ? n_uncached : 0;
+        }
+    }
+
+    for (uint32_t s = 0; s < STRANGER_COUNT; s++, a++)
+    {
+        uint8_t irk[BLE_GAP_SEC_KEY_LEN];
+
+        for (uint32_t i = 0; i < BLE_GAP_SEC_KEY_LEN; i++)
+        {
+            irk[i] = rand_get();
+        }
+        rpa_generate(irk, &m_addrs[a].addr);
+        m_addrs[a].peer_id   = PM_PEER_ID_INVALID;
+        m_addrs[a].ecb_calls = n_irks;
+        m_addrs[a].reads     = n_uncached;
+    }
+
+    for (uint32_t o = 0; o < OTHER_COUNT; o++, a++)
+    {
+        static uint8_t const types[] = {BLE_GAP_ADDR_TYPE_PUBLIC,
+                                        BLE_GAP_ADDR_TYPE_RANDOM_STATIC,
+                                        BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE};
+
+        m_addrs[a].addr.addr_type = types[o % sizeof(types)];
+        for (uint32_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+        {
+            m_addrs[a].addr.addr[i] = rand_get();
+        }
+        m_addrs[a].peer_id   = PM_PEER_ID_INVALID;
+        m_addrs[a].ecb_calls = 0;
+        m_addrs[a].reads     = 0;
+    }
+
+    check(a == ADDR_COUNT, "addresses made", a);
+
+    // The addresses made are distinct, so the list of recently resolved addresses can be modelled
+    // by address index.
+    for (uint32_t i = 0; i < ADDR_COUNT; i++)
+    {
+        for (uint32_t j = 0; j < i; j++)
+        {
+            check(memcmp(m_addrs[i].addr.addr, m_addrs[j].addr.addr, BLE_GAP_ADDR_LEN) != 0,
+                  "distinct addresses", i);
+        }
+    }
+}
+
+
+/**@brief Function for looking up an address in the model, moving it to the front if found. */
+static bool model_find(uint32_t addr_index)
+{
+    for (uint32_t i = 0; i < m_lru_count; i++)
+    {
+        if (m_lru[i] == addr_index)
+        {
+            memmove(&m_lru[1], &m_lru[0], i * sizeof(m_lru[0]));
+            m_lru[0] = addr_index;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for adding an address to the front of the model, evicting the last one. */
+static void model_add(uint32_t addr_index)
+{
+    if (m_lru_count < RPA_LRU_SIZE)
+    {
+        m_lru_count++;
+    }
+    memmove(&m_lru[1], &m_lru[0], (m_lru_count - 1) * sizeof(m_lru[0]));
+    m_lru[0] = addr_index;
+}
+
+
+/**@brief Function for predicting the resolution of a batch of at most RESOLVE_BATCH_SIZE
+ *        addresses.
+ *
+ * @details The addresses are looked up in the list first, then those not found are resolved and
+ *          added in order. A repeated address is resolved once; its other occurrences count as
+ *          found in the list, with the ECB operations of the first one saved.
+ */
+static void model_batch(uint32_t const * p_indices, uint32_t n, pm_rpa_stats_t * p_expected,
+                        uint32_t * p_reads)
+{
+    uint32_t pending[RESOLVE_BATCH_SIZE];
+    uint32_t n_pending = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        test_addr_t const * p_addr = &m_addrs[p_indices[i]];
+        bool                is_dup = false;
+
+        if (p_addr->addr.addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+        {
+            continue;
+        }
+
+        for (uint32_t j = 0; j < n_pending; j++)
+        {
+            is_dup |= (pending[j] == p_indices[i]);
+        }
+
+        if (is_dup || model_find(p_indices[i]))
+        {
+            p_expected->lru_hits++;
+            p_expected->ecb_calls_saved += p_addr->ecb_calls;
+        }
+        else
+        {
+            pending[n_pending++] = p_indices[i];
+        }
+    }
+
+    for (uint32_t j = 0; j < n_pending; j++)
+    {
+        model_add(pending[j]);
+        p_expected->lru_misses++;
+        p_expected->ecb_calls += m_addrs[pending[j]].ecb_calls;
+        *p_reads              += m_addrs[pending[j]].reads;
+    }
+}
+
+
+/**@brief Function for resolving addresses and checking the result against the model.
+ *
+ * @param[in] p_indices  Indices of the addresses in m_addrs.
+ * @param[in] n          Number of addresses.
+ */
+static void resolve_check(uint32_t const * p_indices, uint32_t n)
+{
+    ble_gap_addr_t addrs[MAX_BATCH_LEN];
+    pm_peer_id_t   peer_ids[MAX_BATCH_LEN];
+    pm_rpa_stats_t before;
+    pm_rpa_stats_t expected;
+    pm_rpa_stats_t stats;
+    uint32_t       ecb_calls_before = m_ecb_calls;
+    uint32_t       reads_before     = m_reads;
+    uint32_t       expected_reads   = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        addrs[i] = m_addrs[p_indices[i]].addr;
+    }
+
+    im_rpa_stats_get(&before);
+    expected = before;
+    if (!m_cache_loaded)
+    {
+        expected.irk_cache_loads++;
+        expected_reads += PEER_COUNT;
+        m_cache_loaded  = true;
+    }
+    for (uint32_t i = 0; i < n; i += RESOLVE_BATCH_SIZE)
+    {
+        model_batch(&p_indices[i], MIN(n - i, RESOLVE_BATCH_SIZE), &expected, &expected_reads);
+    }
+
+    im_addresses_resolve(addrs, n, peer_ids);
+    im_rpa_stats_get(&stats);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        check(peer_ids[i] == m_addrs[p_indices[i]].peer_id, "peer ID", p_indices[i]);
+    }
+    check(stats.lru_hits == expected.lru_hits, "lru_hits", stats.lru_hits);
+    check(stats.lru_misses == expected.lru_misses, "lru_misses", stats.lru_misses);
+    check(stats.ecb_calls == expected.ecb_calls, "ecb_calls", stats.ecb_calls);
+    check(stats.ecb_calls_saved == expected.ecb_calls_saved, "ecb_calls_saved",
+          stats.ecb_calls_saved);
+    check(stats.irk_cache_loads == expected.irk_cache_loads, "irk_cache_loads",
+          stats.irk_cache_loads);
+    check(m_ecb_calls - ecb_calls_before == expected.ecb_calls - before.ecb_calls,
+          "ECB operations", m_ecb_calls - ecb_calls_before);
+    check(m_reads - reads_before == expected_reads, "bonding data reads", m_reads - reads_before);
+}
+
+
+/**@brief Function for resolving one address, returning whether it was found in the list of
+ *        recently resolved addresses.
+ */
+static bool resolve_one(uint32_t addr_index)
+{
+    pm_rpa_stats_t before;
+    pm_rpa_stats_t after;
+
+    im_rpa_stats_get(&before);
+    resolve_check(&addr_index, 1);
+    im_rpa_stats_get(&after);
+
+    return (after.lru_hits != before.lru_hits);
+}
+
+
+/**@brief Function for sending an event of the peer database to the module. */
+static void pdb_evt_send(pdb_evt_id_t evt_id, pm_peer_data_id_t data_id)
+{
+    pdb_evt_t event;
+
+    memset(&event, 0, sizeof(event));
+    event.evt_id  = evt_id;
+    event.peer_id = 0;
+    event.data_id = data_id;
+    m_pdb_evt_handler(&event);
+}
+
+
+/**@brief Function for discarding the cache of the model, as the module does when bonding data
+ *        changes.
+ */
+static void model_reset(void)
+{
+    m_lru_count    = 0;
+    m_cache_loaded = false;
+}
+
+
+/**@brief Function for discarding the cache of the module and the model. */
+static void cache_reset(void)
+{
+    pdb_evt_send(PDB_EVT_CLEARED, PM_PEER_DATA_ID_BONDING);
+    model_reset();
+}
+
+
+/**@brief Function for checking that the least recently used address is evicted from a full list.
+ */
+static void lru_eviction_test(void)
+{
+    cache_reset();
+
+    for (uint32_t i = 0; i < RPA_LRU_SIZE; i++)
+    {
+        check(!resolve_one(i), "first resolution found", i);
+    }
+    for (uint32_t i = 0; i < RPA_LRU_SIZE; i++)
+    {
+        check(resolve_one(i), "recent resolution not found", i);
+    }
+
+    // Address 0 is now the least recently used. Using it again makes address 1 the one evicted.
+    check(resolve_one(0), "recent resolution not found", 0);
+    check(!resolve_one(RPA_LRU_SIZE), "first resolution found", RPA_LRU_SIZE);
+    check(resolve_one(0), "used resolution evicted", 0);
+    check(!resolve_one(1), "least recently used resolution kept", 1);
+    check(!resolve_one(2), "least recently used resolution kept", 2);
+    check(resolve_one(RPA_LRU_SIZE), "recent resolution not found", RPA_LRU_SIZE);
+}
+
+
+/**@brief Function for checking that an address repeated in one batch is resolved once.
+ */
+static void duplicate_test(void)
+{
+    uint32_t const cached   = 0;                    // Resolved from the IRK cache.
+    uint32_t const uncached = STRANGER_FIRST - 1;   // Resolved from flash.
+    uint32_t const stranger = STRANGER_FIRST;       // Not resolved.
+    uint32_t const other    = OTHER_FIRST;          // Not resolvable.
+    uint32_t const batch[]  = {cached, uncached, cached, other, cached, uncached, stranger, stranger};
+    uint32_t const repeat[] = {cached, cached};
+    pm_rpa_stats_t before;
+    pm_rpa_stats_t after;
+    uint32_t       ecb_calls_before;
+
+    STATIC_ASSERT(sizeof(batch) / sizeof(batch[0]) <= RESOLVE_BATCH_SIZE);
+
+    cache_reset();
+    resolve_check(repeat, 0);   // Loads the IRK cache.
+
+    im_rpa_stats_get(&before);
+    ecb_calls_before = m_ecb_calls;
+    resolve_check(batch, sizeof(batch) / sizeof(batch[0]));
+    im_rpa_stats_get(&after);
+
+    check(after.lru_misses - before.lru_misses == 3, "addresses resolved",
+          after.lru_misses - before.lru_misses);
+    check(after.lru_hits - before.lru_hits == 4, "repeated addresses",
+          after.lru_hits - before.lru_hits);
+    check(m_ecb_calls - ecb_calls_before == m_addrs[cached].ecb_calls
+                                            + m_addrs[uncached].ecb_calls
+                                            + m_addrs[stranger].ecb_calls,
+          "ECB operations of the batch", m_ecb_calls - ecb_calls_before);
+    check(after.ecb_calls_saved - before.ecb_calls_saved == 2 * m_addrs[cached].ecb_calls
+                                                            + m_addrs[uncached].ecb_calls
+                                                            + m_addrs[stranger].ecb_calls,
+          "ECB operations saved by the batch", after.ecb_calls_saved - before.ecb_calls_saved);
+
+    // An address repeated in a batch and found in the list.
+    ecb_calls_before = m_ecb_calls;
+    resolve_check(repeat, sizeof(repeat) / sizeof(repeat[0]));
+    check(m_ecb_calls == ecb_calls_before, "ECB operations of a recent address",
+          m_ecb_calls - ecb_calls_before);
+}
+
+
+/**@brief Function for checking that the cache is discarded when bonding data changes, and only
+ *        then.
+ */
+static void invalidation_test(void)
+{
+    pm_rpa_stats_t before;
+    pm_rpa_stats_t after;
+
+    cache_reset();
+    check(!resolve_one(0), "first resolution found", 0);
+
+    im_rpa_stats_get(&before);
+    pdb_evt_send(PDB_EVT_CLEARED, PM_PEER_DATA_ID_PEER_RANK);
+    check(resolve_one(0), "resolution discarded on other data", 0);
+
+    pdb_evt_send(PDB_EVT_RAW_STORED, PM_PEER_DATA_ID_BONDING);
+    model_reset();
+    check(!resolve_one(0), "resolution kept on stored bonding data", 0);
+
+    pdb_evt_send(PDB_EVT_PEER_FREED, PM_PEER_DATA_ID_INVALID);
+    model_reset();
+    check(!resolve_one(0), "resolution kept on freed peer", 0);
+
+    check(im_peer_free(5) == NRF_SUCCESS, "im_peer_free", 5);
+    model_reset();
+    check(!resolve_one(0), "resolution kept on im_peer_free", 0);
+
+    im_rpa_stats_get(&after);
+    check(after.irk_cache_loads - before.irk_cache_loads == 3, "IRK cache loads",
+          after.irk_cache_loads - before.irk_cache_loads);
+}
+
+
+/**@brief Function for resolving random batches of addresses, with repetitions. */
+static void random_test(void)
+{
+    uint32_t indices[MAX_BATCH_LEN];
+
+    cache_reset();
+
+    for (uint32_t b = 0; b < RANDOM_BATCHES; b++)
+    {
+        uint32_t n = 1 + rand_get() % MAX_BATCH_LEN;
+
+        // Draw from a part of the addresses, so that some of them are often recently resolved.
+        uint32_t range = (rand_get() & 1) ? (RPA_LRU_SIZE + 2) : ADDR_COUNT;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            indices[i] = rand_get() % range;
+        }
+        resolve_check(indices, n);
+
+        if (rand_get() % 500 == 0)
+        {
+            cache_reset();
+        }
+    }
+}
+
+
+int main(void)
+{
+    pm_rpa_stats_t stats;
+
+    check(im_register(im_evt_handler) == NRF_SUCCESS, "im_register", 0);
+    addrs_make();
+
+    lru_eviction_test();
+    duplicate_test();
+    invalidation_test();
+    random_test();
+
+    im_rpa_stats_get(&stats);
+    printf("    hits   misses  ecb calls      saved  loads\n");
+    printf("%8u %8u %10u %10u %6u\n", (unsigned int)stats.lru_hits,
+           (unsigned int)stats.lru_misses, (unsigned int)stats.ecb_calls,
+           (unsigned int)stats.ecb_calls_saved, (unsigned int)stats.irk_cache_loads);
+
+    if (m_failures != 0)
+    {
+        printf("id_manager_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,415 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the streaming mode of the Nordic UART Service and of the NUS Client.
+ *
+ * @details The SoftDevice functions which send notifications and write commands are replaced by a
+ *          simulated link with TX_BUFFERS application TX buffers. The test writes random data to
+ *          the stream and transmits random numbers of the oldest packets, reporting them with
+ *          BLE_EVT_TX_COMPLETE, whose handler sends the queued data again.
+ *
+ *          When preemption is simulated, BLE_EVT_TX_COMPLETE is also reported from within the
+ *          SoftDevice call, as the BLE event interrupt does when it preempts the sending of the
+ *          queue by the application. Other modules can also send packets on the link, which are
+ *          counted by BLE_EVT_TX_COMPLETE as well.
+ *
+ *          The data received by the peer must be the data written to the stream, in packets of at
+ *          most BLE_NUS_MAX_DATA_LEN bytes, and the statistics of the module must match the
+ *          packets seen by the link.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "ble_nus.h"
+#include "ble_nus_c.h"
+
+#define CONN_HANDLE         0x0010
+#define TX_BUFFERS          7           /**< Number of application TX buffers of the SoftDevice. */
+#define TX_BUF_SIZE         256         /**< Size of the transmit buffer of the module. */
+#define WRITE_COUNT         100000      /**< Number of writes to the stream per run. */
+#define MAX_WRITE_LEN       100         /**< Largest length of a write to the stream. */
+#define MAX_STREAM_LEN      (WRITE_COUNT * MAX_WRITE_LEN)
+
+/**@brief Functions of the module under test. */
+typedef struct
+{
+    char const * p_name;
+    void       (*init)(void);
+    uint32_t   (*write)(uint8_t const * p_data, uint32_t * p_length);
+    void       (*evt_handle)(ble_evt_t * p_ble_evt);
+    void       (*stats_get)(ble_nus_stream_stats_t * p_stats);
+} module_t;
+
+static module_t const * mp_module;
+static ble_nus_t        m_nus;
+static ble_nus_c_t      m_nus_c;
+static uint8_t          m_tx_buf[TX_BUF_SIZE];
+static bool             m_tx_owned[TX_BUFFERS];   /**< Whether each packet in the TX buffers was sent by the module. */
+static uint32_t         m_tx_head;
+static uint32_t         m_tx_count;
+static bool             m_is_preempting;          /**< Whether BLE_EVT_TX_COMPLETE can preempt the module. */
+static bool             m_is_other_traffic;       /**< Whether other modules send packets on the link. */
+static uint32_t         m_preemptions;
+static uint32_t         m_other_packets;
+static uint8_t          m_sent[MAX_STREAM_LEN];
+static uint32_t         m_sent_len;
+static uint8_t          m_received[MAX_STREAM_LEN];
+static uint32_t         m_received_len;
+static uint32_t         m_received_packets;
+static uint32_t         m_evt_buf[16];            /**< BLE event, with room for the variable length arrays. */
+static uint32_t         m_failures;
+static uint64_t         m_rand_state = 88172645463325252ULL;
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s: %s (%u)\n", mp_module->p_name, p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+static ble_evt_t * evt_get(uint16_t evt_id)
+{
+    ble_evt_t * p_ble_evt = (ble_evt_t *)m_evt_buf;
+
+    memset(m_evt_buf, 0, sizeof(m_evt_buf));
+    p_ble_evt->header.evt_id              = evt_id;
+    p_ble_evt->evt.common_evt.conn_handle = CONN_HANDLE;
+
+    return p_ble_evt;
+}
+
+
+/**@brief Function for transmitting the oldest packets of the TX buffers and reporting them. */
+static void tx_complete(uint32_t count)
+{
+    ble_evt_t * p_ble_evt;
+
+    m_tx_head   = (m_tx_head + count) % TX_BUFFERS;
+    m_tx_count -= count;
+
+    p_ble_evt = evt_get(BLE_EVT_TX_COMPLETE);
+    p_ble_evt->evt.common_evt.params.tx_complete.count = (uint8_t)count;
+    mp_module->evt_handle(p_ble_evt);
+}
+
+
+/**@brief Function for sending a packet on the simulated link.
+ *
+ * @details The packet of the module is received by the peer. The BLE event interrupt is then
+ *          simulated, before the module sees that the packet was accepted.
+ */
+static uint32_t packet_send(uint16_t conn_handle, uint8_t const * p_data, uint16_t len)
+{
+    check(conn_handle == CONN_HANDLE, "connection handle", conn_handle);
+    if (m_tx_count == TX_BUFFERS)
+    {
+        return BLE_ERROR_NO_TX_PACKETS;
+    }
+
+    check((len > 0) && (len <= BLE_NUS_MAX_DATA_LEN), "packet length", len);
+    check(m_received_len + len <= m_sent_len, "more data received than written", m_received_len);
+    if (m_received_len + len <= MAX_STREAM_LEN)
+    {
+        memcpy(&m_received[m_received_len], p_data, len);
+        m_received_len += len;
+    }
+    m_received_packets++;
+
+    m_tx_owned[(m_tx_head + m_tx_count) % TX_BUFFERS] = true;
+    m_tx_count++;
+
+    if (m_is_preempting && ((rand_get() % 4) == 0))
+    {
+        m_preemptions++;
+        tx_complete(1 + rand_get() % m_tx_count);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    check(p_hvx_params->type == BLE_GATT_HVX_NOTIFICATION, "notification type", p_hvx_params->type);
+
+    return packet_send(conn_handle, p_hvx_params->p_data, *p_hvx_params->p_len);
+}
+
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params)
+{
+    check(p_write_params->write_op == BLE_GATT_OP_WRITE_CMD, "write operation",
+          p_write_params->write_op);
+
+    return packet_send(conn_handle, p_write_params->p_value, p_write_params->len);
+}
+
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type)
+{
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle)
+{
+    *p_handle = 0x000C;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t                   service_handle,
+                                         ble_gatts_char_md_t const * p_char_md,
+                                         ble_gatts_attr_t const    * p_attr_char_value,
+                                         ble_gatts_char_handles_t  * p_handles)
+{
+    static uint16_t handle = 0x000D;
+
+    p_handles->value_handle     = handle++;
+    p_handles->cccd_handle      = handle++;
+    p_handles->user_desc_handle = BLE_GATT_HANDLE_INVALID;
+    p_handles->sccd_handle      = BLE_GATT_HANDLE_INVALID;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_db_discovery_evt_register(ble_uuid_t const * p_uuid)
+{
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for initializing the service, connecting and enabling notifications. */
+static void nus_init(void)
+{
+    ble_nus_init_t init;
+    ble_evt_t    * p_ble_evt;
+
+    memset(&init, 0, sizeof(init));
+    init.p_tx_buf    = m_tx_buf;
+    init.tx_buf_size = sizeof(m_tx_buf);
+    APP_ERROR_CHECK(ble_nus_init(&m_nus, &init));
+
+    p_ble_evt = evt_get(BLE_GAP_EVT_CONNECTED);
+    ble_nus_on_ble_evt(&m_nus, p_ble_evt);
+
+    p_ble_evt = evt_get(BLE_GATTS_EVT_WRITE);
+    p_ble_evt->evt.gatts_evt.params.write.handle  = m_nus.rx_handles.cccd_handle;
+    p_ble_evt->evt.gatts_evt.params.write.len     = 2;
+    p_ble_evt->evt.gatts_evt.params.write.data[0] = BLE_GATT_HVX_NOTIFICATION;
+    ble_nus_on_ble_evt(&m_nus, p_ble_evt);
+}
+
+
+static uint32_t nus_write(uint8_t const * p_data, uint32_t * p_length)
+{
+    return ble_nus_stream_write(&m_nus, p_data, p_length);
+}
+
+
+static void nus_evt_handle(ble_evt_t * p_ble_evt)
+{
+    ble_nus_on_ble_evt(&m_nus, p_ble_evt);
+}
+
+
+static void nus_stats_get(ble_nus_stream_stats_t * p_stats)
+{
+    APP_ERROR_CHECK(ble_nus_stream_stats_get(&m_nus, p_stats));
+}
+
+
+/**@brief Function for initializing the client and assigning the handles of a discovered peer. */
+static void nus_c_init(void)
+{
+    ble_nus_c_init_t    init;
+    ble_nus_c_handles_t handles;
+
+    memset(&init, 0, sizeof(init));
+    init.p_tx_buf    = m_tx_buf;
+    init.tx_buf_size = sizeof(m_tx_buf);
+    APP_ERROR_CHECK(ble_nus_c_init(&m_nus_c, &init));
+
+    handles.nus_rx_handle      = 0x000E;
+    handles.nus_rx_cccd_handle = 0x000F;
+    handles.nus_tx_handle      = 0x0011;
+    APP_ERROR_CHECK(ble_nus_c_handles_assign(&m_nus_c, CONN_HANDLE, &handles));
+}
+
+
+static uint32_t nus_c_write(uint8_t const * p_data, uint32_t * p_length)
+{
+    return ble_nus_c_stream_write(&m_nus_c, p_data, p_length);
+}
+
+
+static void nus_c_evt_handle(ble_evt_t * p_ble_evt)
+{
+    ble_nus_c_on_ble_evt(&m_nus_c, p_ble_evt);
+}
+
+
+static void nus_c_stats_get(ble_nus_stream_stats_t * p_stats)
+{
+    ble_nus_c_stream_stats_t stats;
+
+    APP_ERROR_CHECK(ble_nus_c_stream_stats_get(&m_nus_c, &stats));
+
+    p_stats->bytes_queued        = stats.bytes_queued;
+    p_stats->bytes_sent          = stats.bytes_sent;
+    p_stats->packets_sent        = stats.packets_sent;
+    p_stats->packets_completed   = stats.packets_completed;
+    p_stats->tx_complete_evts    = stats.tx_complete_evts;
+    p_stats->tx_buffers_full     = stats.tx_buffers_full;
+    p_stats->max_packets_per_evt = stats.max_packets_per_evt;
+}
+
+
+static module_t const m_modules[] =
+{
+    {"nus",   nus_init,   nus_write,   nus_evt_handle,   nus_stats_get},
+    {"nus_c", nus_c_init, nus_c_write, nus_c_evt_handle, nus_c_stats_get},
+};
+
+
+/**@brief Function for streaming random data and checking the data received by the peer. */
+static void stream_run(module_t const * p_module, bool is_preempting, bool is_other_traffic)
+{
+    static uint8_t         data[MAX_WRITE_LEN];
+    ble_nus_stream_stats_t stats;
+    uint32_t               i;
+    uint32_t               j;
+
+    mp_module          = p_module;
+    m_is_preempting    = is_preempting;
+    m_is_other_traffic = is_other_traffic;
+    m_tx_head          = 0;
+    m_tx_count         = 0;
+    m_preemptions      = 0;
+    m_other_packets    = 0;
+    m_sent_len         = 0;
+    m_received_len     = 0;
+    m_received_packets = 0;
+
+    p_module->init();
+
+    for (i = 0; i < WRITE_COUNT; i++)
+    {
+        uint32_t requested = 1 + rand_get() % MAX_WRITE_LEN;
+        uint32_t length    = requested;
+        uint32_t err_code;
+
+        for (j = 0; j < length; j++)
+        {
+            data[j] = (uint8_t)rand_get();
+        }
+
+        // The data is recorded first, as it can be sent before the write returns. The part which
+        // does not fit in the queue is then dropped.
+        memcpy(&m_sent[m_sent_len], data, requested);
+        m_sent_len += requested;
+
+        err_code    = p_module->write(data, &length);
+        m_sent_len -= requested - ((err_code == NRF_SUCCESS) ? length : 0);
+        check((err_code == NRF_SUCCESS) || (err_code == NRF_ERROR_NO_MEM), "write", err_code);
+
+        if (m_is_other_traffic && (m_tx_count < TX_BUFFERS) && ((rand_get() % 8) == 0))
+        {
+            m_tx_owned[(m_tx_head + m_tx_count) % TX_BUFFERS] = false;
+            m_tx_count++;
+            m_other_packets++;
+        }
+
+        if ((m_tx_count > 0) && ((rand_get() % 2) == 0))
+        {
+            tx_complete(1 + rand_get() % m_tx_count);
+        }
+    }
+
+    // The queue is sent again on each BLE_EVT_TX_COMPLETE until it is empty.
+    while (m_tx_count > 0)
+    {
+        tx_complete(m_tx_count);
+    }
+
+    check(m_received_len == m_sent_len, "bytes received", m_received_len);
+    check(memcmp(m_received, m_sent, MIN(m_received_len, m_sent_len)) == 0, "data received", 0);
+
+    p_module->stats_get(&stats);
+    check(stats.bytes_queued == m_sent_len, "bytes_queued", stats.bytes_queued);
+    check(stats.bytes_sent == m_received_len, "bytes_sent", stats.bytes_sent);
+    check(stats.packets_sent == m_received_packets, "packets_sent", stats.packets_sent);
+    if (is_other_traffic)
+    {
+        // Packets of other modules can be counted as packets of the module, but not beyond them.
+        check(stats.packets_completed <= stats.packets_sent, "packets_completed",
+              stats.packets_completed);
+    }
+    else
+    {
+        check(stats.packets_completed == stats.packets_sent, "packets_completed",
+              stats.packets_completed);
+    }
+    check(stats.max_packets_per_evt <= TX_BUFFERS, "max_packets_per_evt",
+          stats.max_packets_per_evt);
+
+    printf("%-5s %9u %8u %8u %11u %11u %11u\n", p_module->p_name, (unsigned int)stats.bytes_sent,
+           (unsigned int)stats.packets_sent, (unsigned int)stats.tx_buffers_full,
+           (unsigned int)stats.tx_complete_evts, (unsigned int)m_preemptions,
+           (unsigned int)m_other_packets);
+}
+
+
+int main(void)
+{
+    uint32_t i;
+
+    printf("          bytes  packets     full  tx_complete preemptions other pkts\n");
+
+    for (i = 0; i < sizeof(m_modules) / sizeof(m_modules[0]); i++)
+    {
+        stream_run(&m_modules[i], false, false);
+        stream_run(&m_modules[i], true,  false);
+        stream_run(&m_modules[i], true,  true);
+    }
+
+    if (m_failures != 0)
+    {
+        printf("nus_stream_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -21,6 +21,9 @@
 #include "peer_database.h"
 #include "nordic_common.h"
 #include "sdk_common.h"
+#ifdef PM_SOFTWARE_AES
+#include "aes.h"
+#endif
 
 #define IM_MAX_CONN_HANDLES         8
 #define IM_NO_INVALID_CONN_HANDLES  0xFF
@@ -29,6 +32,9 @@
                                         BLE_GAP_WHITELIST_IRK_MAX_COUNT)
 #define IM_ADDR_CLEARTEXT_LENGTH    3
 #define IM_ADDR_CIPHERTEXT_LENGTH   3
+#define IM_IRK_CACHE_SIZE           16  /**< Number of IRKs of bonded peers kept in RAM for address resolution. Peers beyond this number are resolved from flash. */
+#define IM_RPA_LRU_SIZE             8   /**< Number of recently resolved addresses remembered, including addresses that did not resolve. */
+#define IM_RESOLVE_BATCH_SIZE       8   /**< Number of addresses resolved together in one pass over the IRKs. */
 
 typedef struct
 {
@@ -37,6 +43,21 @@ typedef struct
     ble_gap_addr_t peer_address;
 } im_connection_t;
 
+/**@brief IRK of a bonded peer, in the byte order used by the ECB. */
+typedef struct
+{
+    pm_peer_id_t peer_id;
+    uint8_t      ecb_key[SOC_ECB_KEY_LENGTH];
+} im_irk_entry_t;
+
+/**@brief Result of a previous address resolution. */
+typedef struct
+{
+    uint8_t      addr[BLE_GAP_ADDR_LEN];
+    pm_peer_id_t peer_id;       /**< Resolved peer, or @ref PM_PEER_ID_INVALID if no IRK matched. */
+    uint16_t     ecb_calls;     /**< Number of ECB operations the resolution took. */
+} im_rpa_lru_entry_t;
+
 typedef struct
 {
     im_evt_handler_t              evt_handlers[MAX_REGISTRANTS];
@@ -47,6 +68,13 @@ typedef struct
     ble_gap_addr_t                whitelist_addrs[BLE_GAP_WHITELIST_ADDR_MAX_COUNT];
     uint8_t                       n_irk_whitelist_peer_ids;
     ble_conn_state_user_flag_id_t conn_state_user_flag_id;
+    im_irk_entry_t                irk_cache[IM_IRK_CACHE_SIZE];
+    uint16_t                      n_irk_cache;
+    bool                          irk_cache_loaded;
+    bool                          irk_cache_complete;     /**< All bonded peers with an IRK are in the IRK cache. */
+    im_rpa_lru_entry_t            rpa_lru[IM_RPA_LRU_SIZE]; /**< Most recently used first. */
+    uint8_t                       n_rpa_lru;
+    pm_rpa_stats_t                rpa_stats;
 } im_t;
 
 static im_t m_im = {.n_registrants = 0};
@@ -210,6 +238,118 @@ bool addr_compare(ble_gap_addr_t const * p_addr1, ble_gap_addr_t const * p_addr2
 }
 
 
+/**@brief Function for discarding the IRK cache and the results of previous address resolutions.
+ *
+ * @detail Called whenever bonding data is written or deleted. The IRK cache is loaded again on the
+ *         next address resolution.
+ */
+static void irk_cache_invalidate(void)
+{
+    m_im.irk_cache_loaded = false;
+    m_im.n_irk_cache      = 0;
+    m_im.n_rpa_lru        = 0;
+}
+
+
+/**@brief Function for reading the IRKs of all bonded peers into the IRK cache.
+ */
+static void irk_cache_load(void)
+{
+    ret_code_t   err_code;
+    pm_peer_id_t peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+
+    m_im.n_irk_cache        = 0;
+    m_im.irk_cache_complete = true;
+
+    while (peer_id != PM_PEER_ID_INVALID)
+    {
+        pm_peer_data_flash_t peer_data;
+
+        err_code = pdb_read_buf_get(peer_id, PM_PEER_DATA_ID_BONDING, &peer_data, NULL);
+        if ((err_code == NRF_SUCCESS) && is_valid_irk(&peer_data.p_bonding_data->peer_id.id_info))
+        {
+            if (m_im.n_irk_cache < IM_IRK_CACHE_SIZE)
+            {
+                im_irk_entry_t * p_entry = &m_im.irk_cache[m_im.n_irk_cache++];
+
+                p_entry->peer_id = peer_id;
+                for (uint32_t i = 0; i < SOC_ECB_KEY_LENGTH; i++)
+                {
+                    p_entry->ecb_key[i] =
+                        peer_data.p_bonding_data->peer_id.id_info.irk[SOC_ECB_KEY_LENGTH - 1 - i];
+                }
+            }
+            else
+            {
+                m_im.irk_cache_complete = false;
+            }
+        }
+        peer_id = pdb_next_peer_id_get(peer_id);
+    }
+
+    m_im.irk_cache_loaded = true;
+    m_im.rpa_stats.irk_cache_loads++;
+}
+
+
+/**@brief Function for checking whether a peer's IRK is in the IRK cache.
+ */
+static bool irk_cache_contains(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < m_im.n_irk_cache; i++)
+    {
+        if (m_im.irk_cache[i].peer_id == peer_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for looking up the result of a previous resolution of an address.
+ *
+ * @detail A found entry is moved to the front of the list.
+ *
+ * @param[in] p_addr  The address to look up.
+ *
+ * @return The entry, or NULL if the address has not been resolved recently.
+ */
+static im_rpa_lru_entry_t * rpa_lru_find(uint8_t const * p_addr)
+{
+    for (uint32_t i = 0; i < m_im.n_rpa_lru; i++)
+    {
+        if (memcmp(m_im.rpa_lru[i].addr, p_addr, BLE_GAP_ADDR_LEN) == 0)
+        {
+            im_rpa_lru_entry_t entry = m_im.rpa_lru[i];
+
+            memmove(&m_im.rpa_lru[1], &m_im.rpa_lru[0], i * sizeof(im_rpa_lru_entry_t));
+            m_im.rpa_lru[0] = entry;
+            return &m_im.rpa_lru[0];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for remembering the result of an address resolution.
+ *
+ * @detail The least recently used entry is dropped when the list is full.
+ */
+static void rpa_lru_add(uint8_t const * p_addr, pm_peer_id_t peer_id, uint16_t ecb_calls)
+{
+    if (m_im.n_rpa_lru < IM_RPA_LRU_SIZE)
+    {
+        m_im.n_rpa_lru++;
+    }
+    memmove(&m_im.rpa_lru[1], &m_im.rpa_lru[0], (m_im.n_rpa_lru - 1) * sizeof(im_rpa_lru_entry_t));
+
+    memcpy(m_im.rpa_lru[0].addr, p_addr, BLE_GAP_ADDR_LEN);
+    m_im.rpa_lru[0].peer_id   = peer_id;
+    m_im.rpa_lru[0].ecb_calls = ecb_calls;
+}
+
+
 void im_ble_evt_handler(ble_evt_t * ble_evt)
 {
     ret_code_t err_code;
@@ -225,13 +365,21 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
                 bonded_matching_peer_id
                         = m_im.irk_whitelist_peer_ids[ble_evt->evt.gap_evt.params.connected.irk_match_idx];
             }
+            else if (   ble_evt->evt.gap_evt.params.connected.peer_addr.addr_type
+                     == BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+            {
+                // Resolvable random addresses are resolved against the cached IRKs of bonded peers.
+                im_addresses_resolve(&ble_evt->evt.gap_evt.params.connected.peer_addr,
+                                     1,
+                                     &bonded_matching_peer_id);
+            }
             else if (   ble_evt->evt.gap_evt.params.connected.peer_addr.addr_type
                      != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE)
             {
                 /* Search the database for bonding data matching the one that triggered the event.
-                 * Public and static addresses can be matched on address alone, while resolvable
-                 * random addresses can be resolved agains known IRKs. Non-resolvable random addresses
-                 * are never matching because they are not longterm form of identification.
+                 * Public and static addresses can be matched on address alone. Non-resolvable
+                 * random addresses are never matching because they are not longterm form of
+                 * identification.
                  */
                 pm_peer_id_t compared_peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
                 while (   (compared_peer_id        != PM_PEER_ID_INVALID)
@@ -257,19 +405,7 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
                             break;
 
                         case BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE:
-                            err_code = pdb_read_buf_get(compared_peer_id,
-                                                        PM_PEER_DATA_ID_BONDING,
-                                                        &compared_data,
-                                                        NULL);
-                            if (err_code == NRF_SUCCESS &&
-                                im_address_resolve(&ble_evt->evt.gap_evt.params.connected.peer_addr,
-                                                   &compared_data.p_bonding_data->peer_id.id_info)
-                            )
-                            {
-                                bonded_matching_peer_id = compared_peer_id;
-                            }
-                            break;
-
+                            /* fall-through */
                         case BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE:
                             // Should not happen.
                             break;
@@ -329,7 +465,33 @@ bool is_duplicate_bonding_data(pm_peer_data_bonding_t const * p_bonding_data1,
 static void pdb_evt_handler(pdb_evt_t const * p_event)
 {
     ret_code_t err_code;
-    if ((p_event != NULL) && (p_event->evt_id == PDB_EVT_WRITE_BUF_STORED))
+
+    if (p_event == NULL)
+    {
+        return;
+    }
+
+    // Cached IRKs and resolved addresses are stale when bonding data changes.
+    switch (p_event->evt_id)
+    {
+        case PDB_EVT_WRITE_BUF_STORED:
+        case PDB_EVT_RAW_STORED:
+        case PDB_EVT_CLEARED:
+            if (p_event->data_id == PM_PEER_DATA_ID_BONDING)
+            {
+                irk_cache_invalidate();
+            }
+            break;
+
+        case PDB_EVT_PEER_FREED:
+            irk_cache_invalidate();
+            break;
+
+        default:
+            break;
+    }
+
+    if (p_event->evt_id == PDB_EVT_WRITE_BUF_STORED)
     {
         // If new data about peer id has been stored it is compared to other peers peer ids in
         // search of duplicates.
@@ -555,6 +717,10 @@ ret_code_t im_peer_free(pm_peer_id_t peer_id)
     {
         peer_id_set(conn_handle, PM_PEER_ID_INVALID);
     }
+    if (err_code == NRF_SUCCESS)
+    {
+        irk_cache_invalidate();
+    }
     return err_code;
 }
 
@@ -666,6 +832,45 @@ ret_code_t im_whitelist_custom(ble_gap_whitelist_t const * p_whitelist)
 }
 
 
+/**@brief Function for encrypting blocks with a key, in ECB mode.
+ *
+ * @detail Uses the SoftDevice ECB, one block per call, unless PM_SOFTWARE_AES is defined, in which
+ *         case all blocks are encrypted by the software AES library in one call. The software
+ *         implementation makes the module usable without a SoftDevice, for example in host tests.
+ *
+ * @param[in]    p_key     The key, in ECB byte order.
+ * @param[inout] p_blocks  The cleartext, replaced by the ciphertext.
+ * @param[in]    n_blocks  The number of blocks.
+ */
+static void ecb_blocks_encrypt(uint8_t const * p_key,
+                               uint8_t         p_blocks[][SOC_ECB_KEY_LENGTH],
+                               uint32_t        n_blocks)
+{
+    ret_code_t err_code;
+
+#ifdef PM_SOFTWARE_AES
+    aes128_context_t aes_ctx;
+
+    err_code = aes128_init(&aes_ctx, p_key);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = aes128_ecb_encrypt(&aes_ctx, p_blocks[0], p_blocks[0], n_blocks);
+    }
+#else
+    nrf_ecb_hal_data_t ecb_hal_data;
+
+    memcpy(ecb_hal_data.key, p_key, SOC_ECB_KEY_LENGTH);
+    for (uint32_t i = 0; i < n_blocks; i++)
+    {
+        memcpy(ecb_hal_data.cleartext, p_blocks[i], SOC_ECB_KEY_LENGTH);
+        err_code = sd_ecb_block_encrypt(&ecb_hal_data); // Can only return NRF_SUCCESS.
+        memcpy(p_blocks[i], ecb_hal_data.ciphertext, SOC_ECB_KEY_LENGTH);
+    }
+#endif
+    UNUSED_VARIABLE(err_code);
+}
+
+
 /**@brief Function for calculating the ah() hash function described in Bluetooth core specification
  *        4.2 section 3.H.2.2.2.
  *
@@ -691,25 +896,24 @@ ret_code_t im_whitelist_custom(ble_gap_whitelist_t const * p_whitelist)
  */
 void ah(uint8_t const * p_k, uint8_t const * p_r, uint8_t * p_local_hash)
 {
-    ret_code_t err_code;
-    nrf_ecb_hal_data_t ecb_hal_data;
+    uint8_t key[SOC_ECB_KEY_LENGTH];
+    uint8_t block[1][SOC_ECB_KEY_LENGTH];
     for (uint32_t i = 0; i < SOC_ECB_KEY_LENGTH; i++)
     {
-        ecb_hal_data.key[i] = p_k[SOC_ECB_KEY_LENGTH - 1 - i];
+        key[i] = p_k[SOC_ECB_KEY_LENGTH - 1 - i];
     }
-    memset(ecb_hal_data.cleartext, 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
+    memset(block[0], 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
 
     for (uint32_t i = 0; i < IM_ADDR_CLEARTEXT_LENGTH; i++)
     {
-        ecb_hal_data.cleartext[SOC_ECB_KEY_LENGTH - 1 - i] = p_r[i];
+        block[0][SOC_ECB_KEY_LENGTH - 1 - i] = p_r[i];
     }
 
-    err_code = sd_ecb_block_encrypt(&ecb_hal_data); // Can only return NRF_SUCCESS.
-    UNUSED_VARIABLE(err_code);
+    ecb_blocks_encrypt(key, block, 1);
 
     for (uint32_t i = 0; i < IM_ADDR_CIPHERTEXT_LENGTH; i++)
     {
-        p_local_hash[i] = ecb_hal_data.ciphertext[SOC_ECB_KEY_LENGTH - 1 - i];
+        p_local_hash[i] = block[0][SOC_ECB_KEY_LENGTH - 1 - i];
     }
 }
 
@@ -729,3 +933,214 @@ bool im_address_resolve(ble_gap_addr_t const * p_addr, ble_gap_irk_t const * p_i
 
     return (memcmp(hash, local_hash, IM_ADDR_CIPHERTEXT_LENGTH) == 0);
 }
+
+
+/**@brief Function for making the ECB cleartext of the ah() hash of a resolvable address.
+ *
+ * @param[in]  p_addr   A resolvable address.
+ * @param[out] p_block  The cleartext.
+ */
+static void addr_cleartext_get(uint8_t const * p_addr, uint8_t * p_block)
+{
+    memset(p_block, 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
+    for (uint32_t i = 0; i < IM_ADDR_CLEARTEXT_LENGTH; i++)
+    {
+        p_block[SOC_ECB_KEY_LENGTH - 1 - i] = p_addr[IM_ADDR_CIPHERTEXT_LENGTH + i];
+    }
+}
+
+
+/**@brief Function for comparing the ECB ciphertext of the ah() hash with the hash of an address.
+ *
+ * @param[in] p_addr   A resolvable address.
+ * @param[in] p_block  The ciphertext of the cleartext from @ref addr_cleartext_get.
+ *
+ * @retval true   The address was generated from the key.
+ * @retval false  The address was not generated from the key.
+ */
+static bool addr_ciphertext_match(uint8_t const * p_addr, uint8_t const * p_block)
+{
+    for (uint32_t i = 0; i < IM_ADDR_CIPHERTEXT_LENGTH; i++)
+    {
+        if (p_addr[i] != p_block[SOC_ECB_KEY_LENGTH - 1 - i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**@brief Function for resolving addresses against the bonded peers which are not in the IRK
+ *        cache, reading their bonding data from flash.
+ */
+static pm_peer_id_t uncached_address_resolve(ble_gap_addr_t const * p_addr, uint16_t * p_ecb_calls)
+{
+    ret_code_t   err_code;
+    pm_peer_id_t peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+
+    while (peer_id != PM_PEER_ID_INVALID)
+    {
+        pm_peer_data_flash_t peer_data;
+
+        if (!irk_cache_contains(peer_id))
+        {
+            err_code = pdb_read_buf_get(peer_id, PM_PEER_DATA_ID_BONDING, &peer_data, NULL);
+            if ((err_code == NRF_SUCCESS) && is_valid_irk(&peer_data.p_bonding_data->peer_id.id_info))
+            {
+                (*p_ecb_calls)++;
+                if (im_address_resolve(p_addr, &peer_data.p_bonding_data->peer_id.id_info))
+                {
+                    return peer_id;
+                }
+            }
+        }
+        peer_id = pdb_next_peer_id_get(peer_id);
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for resolving up to @ref IM_RESOLVE_BATCH_SIZE addresses.
+ *
+ * @detail Addresses are first looked up among the recently resolved addresses. The remaining ones
+ *         are resolved together, encrypting the hashes of all of them with each cached IRK in
+ *         one go. An address repeated in the batch is resolved once, and counted as found among
+ *         the recently resolved addresses.
+ */
+static void addresses_resolve_batch(ble_gap_addr_t const * p_addrs,
+                                    uint32_t               n_addrs,
+                                    pm_peer_id_t         * p_peer_ids)
+{
+    uint8_t            blocks[IM_RESOLVE_BATCH_SIZE][SOC_ECB_KEY_LENGTH];
+    uint8_t            block_pending[IM_RESOLVE_BATCH_SIZE];
+    uint8_t            pending[IM_RESOLVE_BATCH_SIZE];
+    uint16_t           ecb_calls[IM_RESOLVE_BATCH_SIZE];
+    uint8_t            dups[IM_RESOLVE_BATCH_SIZE];
+    uint8_t            dup_pending[IM_RESOLVE_BATCH_SIZE];
+    uint32_t           n_pending    = 0;
+    uint32_t           n_dups       = 0;
+    uint32_t           n_unresolved = 0;
+
+    for (uint32_t i = 0; i < n_addrs; i++)
+    {
+        im_rpa_lru_entry_t * p_entry;
+
+        p_peer_ids[i] = PM_PEER_ID_INVALID;
+
+        if (p_addrs[i].addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+        {
+            continue;
+        }
+
+        p_entry = rpa_lru_find(p_addrs[i].addr);
+        if (p_entry != NULL)
+        {
+            p_peer_ids[i] = p_entry->peer_id;
+            m_im.rpa_stats.lru_hits++;
+            m_im.rpa_stats.ecb_calls_saved += p_entry->ecb_calls;
+        }
+        else
+        {
+            uint32_t j;
+
+            for (j = 0; j < n_pending; j++)
+            {
+                if (memcmp(p_addrs[pending[j]].addr, p_addrs[i].addr, BLE_GAP_ADDR_LEN) == 0)
+                {
+                    break;
+                }
+            }
+
+            if (j < n_pending)
+            {
+                dups[n_dups]          = i;
+                dup_pending[n_dups++] = j;
+            }
+            else
+            {
+                ecb_calls[n_pending] = 0;
+                pending[n_pending++] = i;
+            }
+        }
+    }
+
+    n_unresolved = n_pending;
+
+    for (uint32_t k = 0; (k < m_im.n_irk_cache) && (n_unresolved > 0); k++)
+    {
+        uint32_t n_blocks = 0;
+
+        for (uint32_t j = 0; j < n_pending; j++)
+        {
+            if (p_peer_ids[pending[j]] == PM_PEER_ID_INVALID)
+            {
+                addr_cleartext_get(p_addrs[pending[j]].addr, blocks[n_blocks]);
+                block_pending[n_blocks++] = j;
+                ecb_calls[j]++;
+            }
+        }
+
+        ecb_blocks_encrypt(m_im.irk_cache[k].ecb_key, blocks, n_blocks);
+
+        for (uint32_t b = 0; b < n_blocks; b++)
+        {
+            uint8_t i = pending[block_pending[b]];
+
+            if (addr_ciphertext_match(p_addrs[i].addr, blocks[b]))
+            {
+                p_peer_ids[i] = m_im.irk_cache[k].peer_id;
+                n_unresolved--;
+            }
+        }
+    }
+
+    for (uint32_t j = 0; j < n_pending; j++)
+    {
+        uint8_t i = pending[j];
+
+        if ((p_peer_ids[i] == PM_PEER_ID_INVALID) && !m_im.irk_cache_complete)
+        {
+            p_peer_ids[i] = uncached_address_resolve(&p_addrs[i], &ecb_calls[j]);
+        }
+
+        rpa_lru_add(p_addrs[i].addr, p_peer_ids[i], ecb_calls[j]);
+        m_im.rpa_stats.lru_misses++;
+        m_im.rpa_stats.ecb_calls += ecb_calls[j];
+    }
+
+    for (uint32_t d = 0; d < n_dups; d++)
+    {
+        p_peer_ids[dups[d]] = p_peer_ids[pending[dup_pending[d]]];
+        m_im.rpa_stats.lru_hits++;
+        m_im.rpa_stats.ecb_calls_saved += ecb_calls[dup_pending[d]];
+    }
+}
+
+
+void im_addresses_resolve(ble_gap_addr_t const * p_addrs,
+                          uint32_t               n_addrs,
+                          pm_peer_id_t         * p_peer_ids)
+{
+    if (!m_im.irk_cache_loaded)
+    {
+        irk_cache_load();
+    }
+
+    while (n_addrs > 0)
+    {
+        uint32_t n_batch = MIN(n_addrs, IM_RESOLVE_BATCH_SIZE);
+
+        addresses_resolve_batch(p_addrs, n_batch, p_peer_ids);
+
+        p_addrs    += n_batch;
+        p_peer_ids += n_batch;
+        n_addrs    -= n_batch;
+    }
+}
+
+
+void im_rpa_stats_get(pm_rpa_stats_t * p_stats)
+{
+    *p_stats = m_im.rpa_stats;
+}
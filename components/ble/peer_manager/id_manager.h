@@ -235,6 +235,29 @@ ret_code_t im_whitelist_create(pm_peer_id_t        * p_peer_ids,
  */
 bool im_address_resolve(ble_gap_addr_t const * p_addr, ble_gap_irk_t const * p_irk);
 
+
+/**@brief Function for resolving a set of addresses against the IRKs of all bonded peers.
+ *
+ * @details The IRKs are kept in RAM between calls, and the results of recent resolutions are
+ *          remembered, so that addresses seen repeatedly, for example in scan reports, are only
+ *          resolved once. Addresses that are not resolvable random addresses are not resolved.
+ *
+ * @param[in]  p_addrs     The addresses to resolve.
+ * @param[in]  n_addrs     The number of addresses in @p p_addrs.
+ * @param[out] p_peer_ids  Array of @p n_addrs entries which will be filled with the peer ID each
+ *                         address resolved to, or @ref PM_PEER_ID_INVALID.
+ */
+void im_addresses_resolve(ble_gap_addr_t const * p_addrs,
+                          uint32_t               n_addrs,
+                          pm_peer_id_t         * p_peer_ids);
+
+
+/**@brief Function for getting statistics on address resolution.
+ *
+ * @param[out] p_stats  The statistics.
+ */
+void im_rpa_stats_get(pm_rpa_stats_t * p_stats);
+
 /** @}
  * @endcond
  */
@@ -647,6 +647,27 @@ ret_code_t pm_peer_id_get(uint16_t conn_handle, pm_peer_id_t * p_peer_id)
 }
 
 
+ret_code_t pm_addresses_resolve(ble_gap_addr_t const * p_addrs,
+                                uint32_t               n_addrs,
+                                pm_peer_id_t         * p_peer_ids)
+{
+    VERIFY_MODULE_INITIALIZED();
+    VERIFY_PARAM_NOT_NULL(p_addrs);
+    VERIFY_PARAM_NOT_NULL(p_peer_ids);
+    im_addresses_resolve(p_addrs, n_addrs, p_peer_ids);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pm_rpa_stats_get(pm_rpa_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    VERIFY_PARAM_NOT_NULL(p_stats);
+    im_rpa_stats_get(p_stats);
+    return NRF_SUCCESS;
+}
+
+
 uint32_t pm_peer_count(void)
 {
     if (!MODULE_INITIALIZED)
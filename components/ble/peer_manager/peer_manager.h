@@ -394,6 +394,37 @@ ret_code_t pm_conn_handle_get(pm_peer_id_t peer_id, uint16_t * p_conn_handle);
 ret_code_t pm_peer_id_get(uint16_t conn_handle, pm_peer_id_t * p_peer_id);
 
 
+/**@brief Function for finding the bonded peers that a set of addresses belong to.
+ *
+ * @details Resolvable random addresses are resolved against the IRKs of all bonded peers. The
+ *          IRKs are cached in RAM and the results of recent resolutions are remembered, so this
+ *          function can be called for every scan report. Other address types are not resolved.
+ *
+ * @param[in]  p_addrs     The addresses to resolve.
+ * @param[in]  n_addrs     The number of addresses in @p p_addrs.
+ * @param[out] p_peer_ids  Array of @p n_addrs entries. Filled with the peer ID of each address,
+ *                         or @ref PM_PEER_ID_INVALID if the address did not resolve.
+ *
+ * @retval NRF_SUCCESS              If the addresses were resolved.
+ * @retval NRF_ERROR_NULL           If @p p_addrs or @p p_peer_ids was NULL.
+ * @retval NRF_ERROR_INVALID_STATE  If the Peer Manager is not initialized.
+ */
+ret_code_t pm_addresses_resolve(ble_gap_addr_t const * p_addrs,
+                                uint32_t               n_addrs,
+                                pm_peer_id_t         * p_peer_ids);
+
+
+/**@brief Function for getting statistics on the resolution of resolvable private addresses.
+ *
+ * @param[out] p_stats  The statistics.
+ *
+ * @retval NRF_SUCCESS              If the statistics were retrieved successfully.
+ * @retval NRF_ERROR_NULL           If @p p_stats was NULL.
+ * @retval NRF_ERROR_INVALID_STATE  If the Peer Manager is not initialized.
+ */
+ret_code_t pm_rpa_stats_get(pm_rpa_stats_t * p_stats);
+
+
 /**@brief Function for getting the next peer ID in the sequence of all used peer IDs.
  *
  * @details This function can be used to loop through all used peer IDs. The order in which
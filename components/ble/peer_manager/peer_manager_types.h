@@ -152,6 +152,18 @@ typedef struct
 } pm_peer_data_local_gatt_db_t;
 
 
+/**@brief Statistics on the resolution of resolvable private addresses.
+ */
+typedef struct
+{
+    uint32_t lru_hits;        /**< @brief Number of addresses found among the recently resolved addresses. */
+    uint32_t lru_misses;      /**< @brief Number of addresses that had to be resolved against the IRKs of bonded peers. */
+    uint32_t ecb_calls;       /**< @brief Number of ECB encryptions done to resolve addresses. */
+    uint32_t ecb_calls_saved; /**< @brief Number of ECB encryptions avoided by reusing the results of previous resolutions. */
+    uint32_t irk_cache_loads; /**< @brief Number of times the IRKs of bonded peers were read from flash into RAM. */
+} pm_rpa_stats_t;
+
+
 /**@brief Macro to check whether a data type is valid, thus one of the valid enum values.
  *
  * @param[in] data_id  The data type to check.
@@ -0,0 +1,667 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include <string.h>
+#include "aes.h"
+#include "sdk_errors.h"
+#include "sdk_common.h"
+
+
+#define AES_LANES           32                                  /**< Number of bytes processed in parallel, one per bit of a uint32_t. */
+#define AES_LANE_BLOCKS     (AES_LANES / AES128_BLOCK_SIZE)     /**< Number of blocks processed in parallel. */
+#define AES_AFFINE_CONSTANT 0x63                                /**< Constant of the S-box affine transformation. */
+#define AES_INV_AFFINE_CONSTANT 0x05                            /**< Constant of the inverse S-box affine transformation. */
+
+
+/**@brief Data in bitsliced form. Bit j of plane k is bit k of byte j.
+ */
+typedef uint32_t planes_t[8];
+
+
+/**@brief Function for converting bytes to bitsliced form.
+ */
+static void planes_from_bytes(planes_t q, uint8_t const * p_bytes)
+{
+    memset(q, 0, sizeof(planes_t));
+    for (uint32_t j = 0; j < AES_LANES; j++)
+    {
+        for (uint32_t k = 0; k < 8; k++)
+        {
+            q[k] |= (uint32_t)((p_bytes[j] >> k) & 1) << j;
+        }
+    }
+}
+
+
+/**@brief Function for converting bitsliced data back to bytes.
+ */
+static void planes_to_bytes(planes_t const q, uint8_t * p_bytes)
+{
+    for (uint32_t j = 0; j < AES_LANES; j++)
+    {
+        uint8_t b = 0;
+        for (uint32_t k = 0; k < 8; k++)
+        {
+            b |= (uint8_t)(((q[k] >> j) & 1) << k);
+        }
+        p_bytes[j] = b;
+    }
+}
+
+
+/**@brief Function for multiplying bitsliced elements of GF(2^8), modulo x^8 + x^4 + x^3 + x + 1.
+ *
+ * @param[out] r  Product. Can be the same as a or b.
+ * @param[in]  a  Factor.
+ * @param[in]  b  Factor.
+ */
+static void gf_mul(planes_t r, planes_t const a, planes_t const b)
+{
+    uint32_t p[15];
+
+    memset(p, 0, sizeof(p));
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            p[i + j] ^= a[i] & b[j];
+        }
+    }
+
+    // x^8 = x^4 + x^3 + x + 1.
+    for (uint32_t k = 14; k >= 8; k--)
+    {
+        p[k - 4] ^= p[k];
+        p[k - 5] ^= p[k];
+        p[k - 7] ^= p[k];
+        p[k - 8] ^= p[k];
+    }
+
+    memcpy(r, p, sizeof(planes_t));
+}
+
+
+/**@brief Function for inverting bitsliced elements of GF(2^8), mapping 0 to 0.
+ *
+ * @details Computes x^254 with 4 multiplications and 7 squarings.
+ */
+static void gf_inv(planes_t x)
+{
+    planes_t x2, x3, x12, t;
+
+    gf_mul(x2, x, x);       // x^2
+    gf_mul(x3, x2, x);      // x^3
+    gf_mul(x12, x3, x3);    // x^6
+    gf_mul(x12, x12, x12);  // x^12
+    gf_mul(t, x12, x3);     // x^15
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        gf_mul(t, t, t);    // x^240
+    }
+    gf_mul(t, t, x12);      // x^252
+    gf_mul(x, t, x2);       // x^254
+}
+
+
+/**@brief Function for applying the S-box, or the inverse S-box, to @ref AES_LANES bytes.
+ */
+static void sub_bytes(uint8_t * p_bytes, bool inverse)
+{
+    planes_t q;
+    planes_t r;
+
+    planes_from_bytes(q, p_bytes);
+
+    if (inverse)
+    {
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            r[i] = q[(i + 2) % 8] ^ q[(i + 5) % 8] ^ q[(i + 7) % 8]
+                 ^ (((AES_INV_AFFINE_CONSTANT >> i) & 1) ? 0xFFFFFFFF : 0);
+        }
+        gf_inv(r);
+    }
+    else
+    {
+        gf_inv(q);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            r[i] = q[i] ^ q[(i + 4) % 8] ^ q[(i + 5) % 8] ^ q[(i + 6) % 8] ^ q[(i + 7) % 8]
+                 ^ (((AES_AFFINE_CONSTANT >> i) & 1) ? 0xFFFFFFFF : 0);
+        }
+    }
+
+    planes_to_bytes(r, p_bytes);
+}
+
+
+/**@brief Function for multiplying by x in GF(2^8) without branching on the value.
+ */
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (0x1B & (uint8_t)(0 - (x >> 7))));
+}
+
+
+static void add_round_key(uint8_t * p_lanes, uint8_t const * p_round_key)
+{
+    for (uint32_t j = 0; j < AES_LANES; j++)
+    {
+        p_lanes[j] ^= p_round_key[j % AES128_BLOCK_SIZE];
+    }
+}
+
+
+/**@brief Function for rotating row r of each block left by r bytes, or right if inverse.
+ *
+ * @details Byte r + 4c of a block is in row r and column c.
+ */
+static void shift_rows(uint8_t * p_lanes, bool inverse)
+{
+    for (uint32_t b = 0; b < AES_LANES; b += AES128_BLOCK_SIZE)
+    {
+        uint8_t old[AES128_BLOCK_SIZE];
+
+        memcpy(old, &p_lanes[b], AES128_BLOCK_SIZE);
+        for (uint32_t r = 1; r < 4; r++)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                if (inverse)
+                {
+                    p_lanes[b + r + 4 * ((c + r) % 4)] = old[r + 4 * c];
+                }
+                else
+                {
+                    p_lanes[b + r + 4 * c] = old[r + 4 * ((c + r) % 4)];
+                }
+            }
+        }
+    }
+}
+
+
+static void mix_columns(uint8_t * p_lanes)
+{
+    for (uint32_t c = 0; c < AES_LANES; c += 4)
+    {
+        uint8_t * p_col = &p_lanes[c];
+        uint8_t   all   = p_col[0] ^ p_col[1] ^ p_col[2] ^ p_col[3];
+        uint8_t   first = p_col[0];
+
+        p_col[0] ^= all ^ xtime(p_col[0] ^ p_col[1]);
+        p_col[1] ^= all ^ xtime(p_col[1] ^ p_col[2]);
+        p_col[2] ^= all ^ xtime(p_col[2] ^ p_col[3]);
+        p_col[3] ^= all ^ xtime(p_col[3] ^ first);
+    }
+}
+
+
+static void inv_mix_columns(uint8_t * p_lanes)
+{
+    for (uint32_t c = 0; c < AES_LANES; c += 4)
+    {
+        uint8_t * p_col = &p_lanes[c];
+
+        // Multiplying by {04}x^2 + {05} first reduces the inverse to the forward transformation.
+        uint8_t u = xtime(xtime(p_col[0] ^ p_col[2]));
+        uint8_t v = xtime(xtime(p_col[1] ^ p_col[3]));
+
+        p_col[0] ^= u;
+        p_col[1] ^= v;
+        p_col[2] ^= u;
+        p_col[3] ^= v;
+    }
+    mix_columns(p_lanes);
+}
+
+
+/**@brief Function for encrypting or decrypting @ref AES_LANE_BLOCKS blocks in place.
+ */
+static void blocks_crypt(aes128_context_t const * p_ctx, uint8_t * p_lanes, bool decrypt)
+{
+    uint8_t const * p_keys = p_ctx->round_keys;
+
+    if (!decrypt)
+    {
+        add_round_key(p_lanes, &p_keys[0]);
+        for (uint32_t round = 1; round <= AES128_ROUNDS; round++)
+        {
+            sub_bytes(p_lanes, false);
+            shift_rows(p_lanes, false);
+            if (round != AES128_ROUNDS)
+            {
+                mix_columns(p_lanes);
+            }
+            add_round_key(p_lanes, &p_keys[round * AES128_BLOCK_SIZE]);
+        }
+    }
+    else
+    {
+        add_round_key(p_lanes, &p_keys[AES128_ROUNDS * AES128_BLOCK_SIZE]);
+        for (uint32_t round = AES128_ROUNDS; round >= 1; round--)
+        {
+            shift_rows(p_lanes, true);
+            sub_bytes(p_lanes, true);
+            add_round_key(p_lanes, &p_keys[(round - 1) * AES128_BLOCK_SIZE]);
+            if (round != 1)
+            {
+                inv_mix_columns(p_lanes);
+            }
+        }
+    }
+}
+
+
+/**@brief Function for encrypting or decrypting a number of blocks, @ref AES_LANE_BLOCKS at a time.
+ */
+static void ecb_crypt(aes128_context_t const * p_ctx,
+                      uint8_t const          * p_src,
+                      uint8_t                * p_dst,
+                      uint32_t                 n_blocks,
+                      bool                     decrypt)
+{
+    uint8_t lanes[AES_LANES];
+
+    while (n_blocks > 0)
+    {
+        uint32_t n_bytes = MIN(n_blocks, AES_LANE_BLOCKS) * AES128_BLOCK_SIZE;
+
+        memset(lanes, 0, sizeof(lanes));
+        memcpy(lanes, p_src, n_bytes);
+        blocks_crypt(p_ctx, lanes, decrypt);
+        memcpy(p_dst, lanes, n_bytes);
+
+        p_src    += n_bytes;
+        p_dst    += n_bytes;
+        n_blocks -= n_bytes / AES128_BLOCK_SIZE;
+    }
+}
+
+
+/**@brief Function for incrementing a block as a 128-bit big-endian number.
+ */
+static void counter_increment(uint8_t * p_counter)
+{
+    uint32_t carry = 1;
+
+    for (int32_t i = AES128_BLOCK_SIZE - 1; i >= 0; i--)
+    {
+        carry       += p_counter[i];
+        p_counter[i] = (uint8_t)carry;
+        carry      >>= 8;
+    }
+}
+
+
+ret_code_t aes128_init(aes128_context_t * p_ctx, uint8_t const * p_key)
+{
+    uint8_t   rcon = 0x01;
+    uint8_t * p_rk;
+
+    VERIFY_PARAM_NOT_NULL(p_ctx);
+    VERIFY_PARAM_NOT_NULL(p_key);
+
+    p_rk = p_ctx->round_keys;
+    memcpy(p_rk, p_key, AES128_KEY_SIZE);
+
+    for (uint32_t i = AES128_KEY_SIZE; i < sizeof(p_ctx->round_keys); i += 4)
+    {
+        uint8_t word[AES_LANES];
+
+        memset(word, 0, sizeof(word));
+        memcpy(word, &p_rk[i - 4], 4);
+
+        if ((i % AES128_KEY_SIZE) == 0)
+        {
+            uint8_t first = word[0];
+
+            word[0] = word[1];
+            word[1] = word[2];
+            word[2] = word[3];
+            word[3] = first;
+            sub_bytes(word, false);
+            word[0] ^= rcon;
+            rcon     = xtime(rcon);
+        }
+
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            p_rk[i + j] = p_rk[i + j - AES128_KEY_SIZE] ^ word[j];
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t aes128_ecb_encrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 n_blocks)
+{
+    VERIFY_PARAM_NOT_NULL(p_ctx);
+    VERIFY_PARAM_NOT_NULL(p_src);
+    VERIFY_PARAM_NOT_NULL(p_dst);
+
+    ecb_crypt(p_ctx, p_src, p_dst, n_blocks, false);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t aes128_ecb_decrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 n_blocks)
+{
+    VERIFY_PARAM_NOT_NULL(p_ctx);
+    VERIFY_PARAM_NOT_NULL(p_src);
+    VERIFY_PARAM_NOT_NULL(p_dst);
+
+    ecb_crypt(p_ctx, p_src, p_dst, n_blocks, true);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t aes128_ctr_crypt(aes128_context_t const * p_ctx,
+                            uint8_t                * p_counter,
+                            uint8_t const          * p_src,
+                            uint8_t                * p_dst,
+                            uint32_t                 len)
+{
+    uint8_t lanes[AES_LANES];
+
+    VERIFY_PARAM_NOT_NULL(p_ctx);
+    VERIFY_PARAM_NOT_NULL(p_counter);
+    if (len > 0)
+    {
+        VERIFY_PARAM_NOT_NULL(p_src);
+        VERIFY_PARAM_NOT_NULL(p_dst);
+    }
+
+    while (len > 0)
+    {
+        uint32_t n_bytes = MIN(len, AES_LANES);
+
+        for (uint32_t b = 0; b < AES_LANES; b += AES128_BLOCK_SIZE)
+        {
+            memcpy(&lanes[b], p_counter, AES128_BLOCK_SIZE);
+            if (b < n_bytes)
+            {
+                counter_increment(p_counter);
+            }
+        }
+        blocks_crypt(p_ctx, lanes, false);
+
+        for (uint32_t j = 0; j < n_bytes; j++)
+        {
+            p_dst[j] = p_src[j] ^ lanes[j];
+        }
+
+        p_src += n_bytes;
+        p_dst += n_bytes;
+        len   -= n_bytes;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for checking the parameters of a CCM operation.
+ */
+static ret_code_t ccm_params_check(aes128_context_t const * p_ctx,
+                                   uint8_t const          * p_nonce,
+                                   uint32_t                 nonce_len,
+                                   uint8_t const          * p_adata,
+                                   uint32_t                 adata_len,
+                                   uint8_t const          * p_src,
+                                   uint8_t const          * p_dst,
+                                   uint32_t                 len,
+                                   uint8_t const          * p_mic,
+                                   uint32_t                 mic_len)
+{
+    uint32_t len_size = AES128_BLOCK_SIZE - 1 - nonce_len;
+
+    VERIFY_PARAM_NOT_NULL(p_ctx);
+    VERIFY_PARAM_NOT_NULL(p_nonce);
+    VERIFY_PARAM_NOT_NULL(p_mic);
+    if (adata_len > 0)
+    {
+        VERIFY_PARAM_NOT_NULL(p_adata);
+    }
+    if (len > 0)
+    {
+        VERIFY_PARAM_NOT_NULL(p_src);
+        VERIFY_PARAM_NOT_NULL(p_dst);
+    }
+
+    if (   (nonce_len < AES128_CCM_NONCE_SIZE_MIN)
+        || (nonce_len > AES128_CCM_NONCE_SIZE_MAX)
+        || (mic_len   < AES128_CCM_MIC_SIZE_MIN)
+        || (mic_len   > AES128_CCM_MIC_SIZE_MAX)
+        || ((mic_len % 2) != 0)
+        || ((len_size < sizeof(len)) && ((len >> (8 * len_size)) != 0)))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for adding bytes to a CBC-MAC.
+ *
+ * @param[in]     p_ctx   Context instance.
+ * @param[in,out] p_mac   MAC state, @ref AES128_BLOCK_SIZE bytes.
+ * @param[in,out] p_pos   Number of bytes added to the current block.
+ * @param[in]     p_data  Bytes to add.
+ * @param[in]     len     Number of bytes to add.
+ */
+static void cbc_mac_update(aes128_context_t const * p_ctx,
+                           uint8_t                * p_mac,
+                           uint32_t               * p_pos,
+                           uint8_t const          * p_data,
+                           uint32_t                 len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        p_mac[(*p_pos)++] ^= p_data[i];
+        if (*p_pos == AES128_BLOCK_SIZE)
+        {
+            ecb_crypt(p_ctx, p_mac, p_mac, 1, false);
+            *p_pos = 0;
+        }
+    }
+}
+
+
+/**@brief Function for encrypting or decrypting in CCM mode and calculating the MIC.
+ *
+ * @details The CBC-MAC of each block of the message is calculated in the same pass as the key
+ *          stream of the next block, so the message is processed two blocks per pass even though
+ *          the CBC-MAC itself is sequential.
+ *
+ * @param[out] p_tag  Calculated MIC, @ref AES128_BLOCK_SIZE bytes of which the first mic_len are
+ *                    used.
+ */
+static void ccm_crypt(aes128_context_t const * p_ctx,
+                      uint8_t const          * p_nonce,
+                      uint32_t                 nonce_len,
+                      uint8_t const          * p_adata,
+                      uint32_t                 adata_len,
+                      uint8_t const          * p_src,
+                      uint8_t                * p_dst,
+                      uint32_t                 len,
+                      uint32_t                 mic_len,
+                      bool                     decrypt,
+                      uint8_t                * p_tag)
+{
+    uint32_t len_size = AES128_BLOCK_SIZE - 1 - nonce_len;
+    uint32_t n_blocks = CEIL_DIV(len, AES128_BLOCK_SIZE);
+    uint32_t pos      = 0;
+    uint8_t  mac[AES128_BLOCK_SIZE];
+    uint8_t  a0[AES128_BLOCK_SIZE];
+    uint8_t  counter[AES128_BLOCK_SIZE];
+    uint8_t  plain[AES128_BLOCK_SIZE];
+    uint8_t  lanes[AES_LANES];
+
+    // B0: flags, nonce, message length.
+    memset(mac, 0, sizeof(mac));
+    mac[0] = (uint8_t)(((adata_len > 0) ? 0x40 : 0) | (((mic_len - 2) / 2) << 3) | (len_size - 1));
+    memcpy(&mac[1], p_nonce, nonce_len);
+    for (uint32_t i = 0; (i < len_size) && (i < sizeof(len)); i++)
+    {
+        mac[AES128_BLOCK_SIZE - 1 - i] = (uint8_t)(len >> (8 * i));
+    }
+    ecb_crypt(p_ctx, mac, mac, 1, false);
+
+    if (adata_len > 0)
+    {
+        uint8_t  adata_hdr[6];
+        uint32_t adata_hdr_len;
+
+        if (adata_len < 0xFF00)
+        {
+            adata_hdr[0]  = (uint8_t)(adata_len >> 8);
+            adata_hdr[1]  = (uint8_t)adata_len;
+            adata_hdr_len = 2;
+        }
+        else
+        {
+            adata_hdr[0]  = 0xFF;
+            adata_hdr[1]  = 0xFE;
+            adata_hdr[2]  = (uint8_t)(adata_len >> 24);
+            adata_hdr[3]  = (uint8_t)(adata_len >> 16);
+            adata_hdr[4]  = (uint8_t)(adata_len >> 8);
+            adata_hdr[5]  = (uint8_t)adata_len;
+            adata_hdr_len = 6;
+        }
+        cbc_mac_update(p_ctx, mac, &pos, adata_hdr, adata_hdr_len);
+        cbc_mac_update(p_ctx, mac, &pos, p_adata, adata_len);
+        if (pos != 0)
+        {
+            ecb_crypt(p_ctx, mac, mac, 1, false);
+        }
+    }
+
+    // A0: flags, nonce, counter 0.
+    memset(a0, 0, sizeof(a0));
+    a0[0] = (uint8_t)(len_size - 1);
+    memcpy(&a0[1], p_nonce, nonce_len);
+    memcpy(counter, a0, sizeof(counter));
+    counter_increment(counter);
+
+    // Pass k authenticates block k - 1 and encrypts block k. The last pass encrypts A0.
+    memset(plain, 0, sizeof(plain));
+    for (uint32_t k = 0; k <= n_blocks; k++)
+    {
+        for (uint32_t j = 0; j < AES128_BLOCK_SIZE; j++)
+        {
+            lanes[j] = mac[j] ^ plain[j];
+        }
+        memcpy(&lanes[AES128_BLOCK_SIZE], (k < n_blocks) ? counter : a0, AES128_BLOCK_SIZE);
+
+        blocks_crypt(p_ctx, lanes, false);
+
+        if (k > 0)
+        {
+            memcpy(mac, lanes, AES128_BLOCK_SIZE);
+        }
+
+        if (k < n_blocks)
+        {
+            uint32_t offset = k * AES128_BLOCK_SIZE;
+            uint32_t n_bytes = MIN(len - offset, AES128_BLOCK_SIZE);
+
+            memset(plain, 0, sizeof(plain));
+            for (uint32_t j = 0; j < n_bytes; j++)
+            {
+                uint8_t in  = p_src[offset + j];
+                uint8_t out = in ^ lanes[AES128_BLOCK_SIZE + j];
+
+                plain[j]            = decrypt ? out : in;
+                p_dst[offset + j]   = out;
+            }
+            counter_increment(counter);
+        }
+        else
+        {
+            for (uint32_t j = 0; j < AES128_BLOCK_SIZE; j++)
+            {
+                p_tag[j] = mac[j] ^ lanes[AES128_BLOCK_SIZE + j];
+            }
+        }
+    }
+}
+
+
+ret_code_t aes128_ccm_encrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_nonce,
+                              uint32_t                 nonce_len,
+                              uint8_t const          * p_adata,
+                              uint32_t                 adata_len,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 len,
+                              uint8_t                * p_mic,
+                              uint32_t                 mic_len)
+{
+    uint8_t tag[AES128_BLOCK_SIZE];
+
+    ret_code_t err_code = ccm_params_check(p_ctx, p_nonce, nonce_len, p_adata, adata_len,
+                                           p_src, p_dst, len, p_mic, mic_len);
+    VERIFY_SUCCESS(err_code);
+
+    ccm_crypt(p_ctx, p_nonce, nonce_len, p_adata, adata_len, p_src, p_dst, len, mic_len, false, tag);
+    memcpy(p_mic, tag, mic_len);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t aes128_ccm_decrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_nonce,
+                              uint32_t                 nonce_len,
+                              uint8_t const          * p_adata,
+                              uint32_t                 adata_len,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 len,
+                              uint8_t const          * p_mic,
+                              uint32_t                 mic_len)
+{
+    uint8_t tag[AES128_BLOCK_SIZE];
+    uint8_t diff = 0;
+
+    ret_code_t err_code = ccm_params_check(p_ctx, p_nonce, nonce_len, p_adata, adata_len,
+                                           p_src, p_dst, len, p_mic, mic_len);
+    VERIFY_SUCCESS(err_code);
+
+    ccm_crypt(p_ctx, p_nonce, nonce_len, p_adata, adata_len, p_src, p_dst, len, mic_len, true, tag);
+
+    for (uint32_t i = 0; i < mic_len; i++)
+    {
+        diff |= tag[i] ^ p_mic[i];
+    }
+
+    if (diff != 0)
+    {
+        if (len > 0)
+        {
+            memset(p_dst, 0, len);
+        }
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    return NRF_SUCCESS;
+}
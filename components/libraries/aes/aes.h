@@ -0,0 +1,200 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup aes AES-128 software library
+ * @{
+ * @ingroup app_common
+ *
+ * @brief  This module implements AES-128 (FIPS-197) in software, with the ECB, CTR and CCM modes.
+ *
+ * @details To use this module, first call @ref aes128_init on a @ref aes128_context_t instance
+ *          with the key. The instance can then be used for any number of operations in any of the
+ *          modes.
+ *
+ *          The S-box is computed as an inversion in GF(2^8) on bitsliced data instead of being
+ *          looked up in a table, so the execution time does not depend on the key or on the
+ *          data. Two blocks are processed in each pass, so operations on several blocks are
+ *          faster per block than operations on a single block.
+ *
+ *          Keys and data are in the byte order used by FIPS-197, the same order as the key,
+ *          cleartext, and ciphertext of the ECB peripheral.
+ *
+ *          This module does not use any hardware, and can be built for the host.
+ */
+
+#ifndef AES_H__
+#define AES_H__
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+
+
+#define AES128_KEY_SIZE     16      /**< @brief Size of an AES-128 key in bytes. */
+#define AES128_BLOCK_SIZE   16      /**< @brief Size of an AES block in bytes. */
+#define AES128_ROUNDS       10      /**< @brief Number of rounds of AES-128. */
+
+#define AES128_CCM_NONCE_SIZE_MIN   7   /**< @brief Smallest supported CCM nonce size in bytes. */
+#define AES128_CCM_NONCE_SIZE_MAX   13  /**< @brief Largest supported CCM nonce size in bytes. */
+#define AES128_CCM_MIC_SIZE_MIN     4   /**< @brief Smallest supported CCM MIC size in bytes. */
+#define AES128_CCM_MIC_SIZE_MAX     16  /**< @brief Largest supported CCM MIC size in bytes. */
+
+
+/**@brief Expanded key of an AES-128 operation.
+ */
+typedef struct
+{
+    uint8_t round_keys[(AES128_ROUNDS + 1) * AES128_BLOCK_SIZE];
+} aes128_context_t;
+
+
+/**@brief Function for initializing a @ref aes128_context_t instance with a key.
+ *
+ * @param[out] p_ctx  Context instance to be initialized.
+ * @param[in]  p_key  Key, @ref AES128_KEY_SIZE bytes.
+ *
+ * @retval NRF_SUCCESS     If the instance was successfully initialized.
+ * @retval NRF_ERROR_NULL  If a parameter was NULL.
+ */
+ret_code_t aes128_init(aes128_context_t * p_ctx, uint8_t const * p_key);
+
+
+/**@brief Function for encrypting blocks in ECB mode.
+ *
+ * @param[in]  p_ctx     Initialized context instance.
+ * @param[in]  p_src     Cleartext, @p n_blocks * @ref AES128_BLOCK_SIZE bytes.
+ * @param[out] p_dst     Ciphertext, @p n_blocks * @ref AES128_BLOCK_SIZE bytes. Can be the same
+ *                       as @p p_src.
+ * @param[in]  n_blocks  Number of blocks.
+ *
+ * @retval NRF_SUCCESS     If the blocks were encrypted.
+ * @retval NRF_ERROR_NULL  If a parameter was NULL.
+ */
+ret_code_t aes128_ecb_encrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 n_blocks);
+
+
+/**@brief Function for decrypting blocks in ECB mode.
+ *
+ * @param[in]  p_ctx     Initialized context instance.
+ * @param[in]  p_src     Ciphertext, @p n_blocks * @ref AES128_BLOCK_SIZE bytes.
+ * @param[out] p_dst     Cleartext, @p n_blocks * @ref AES128_BLOCK_SIZE bytes. Can be the same
+ *                       as @p p_src.
+ * @param[in]  n_blocks  Number of blocks.
+ *
+ * @retval NRF_SUCCESS     If the blocks were decrypted.
+ * @retval NRF_ERROR_NULL  If a parameter was NULL.
+ */
+ret_code_t aes128_ecb_decrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 n_blocks);
+
+
+/**@brief Function for encrypting or decrypting data in CTR mode.
+ *
+ * @details The counter block is incremented as a 128-bit big-endian number for each block of
+ *          data. This function can be called multiple times in sequence with the same counter
+ *          block, as long as @p len is a multiple of @ref AES128_BLOCK_SIZE in all calls except the
+ *          last one.
+ *
+ * @param[in]     p_ctx      Initialized context instance.
+ * @param[in,out] p_counter  Counter block, @ref AES128_BLOCK_SIZE bytes. Holds the counter of the
+ *                           next block when the function returns.
+ * @param[in]     p_src      Data to encrypt or decrypt.
+ * @param[out]    p_dst      Result, @p len bytes. Can be the same as @p p_src.
+ * @param[in]     len        Length of the data.
+ *
+ * @retval NRF_SUCCESS     If the data was encrypted or decrypted.
+ * @retval NRF_ERROR_NULL  If a parameter was NULL, while the len parameter was not zero.
+ */
+ret_code_t aes128_ctr_crypt(aes128_context_t const * p_ctx,
+                            uint8_t                * p_counter,
+                            uint8_t const          * p_src,
+                            uint8_t                * p_dst,
+                            uint32_t                 len);
+
+
+/**@brief Function for encrypting and authenticating data in CCM mode (RFC 3610).
+ *
+ * @param[in]  p_ctx      Initialized context instance.
+ * @param[in]  p_nonce    Nonce.
+ * @param[in]  nonce_len  Length of the nonce, between @ref AES128_CCM_NONCE_SIZE_MIN and
+ *                        @ref AES128_CCM_NONCE_SIZE_MAX. Bluetooth low energy uses 13.
+ * @param[in]  p_adata    Additional data, authenticated but not encrypted. Can be NULL if
+ *                        @p adata_len is zero.
+ * @param[in]  adata_len  Length of the additional data.
+ * @param[in]  p_src      Cleartext.
+ * @param[out] p_dst      Ciphertext, @p len bytes. Can be the same as @p p_src.
+ * @param[in]  len        Length of the cleartext.
+ * @param[out] p_mic      Message integrity check, @p mic_len bytes.
+ * @param[in]  mic_len    Length of the MIC, an even number between @ref AES128_CCM_MIC_SIZE_MIN
+ *                        and @ref AES128_CCM_MIC_SIZE_MAX. Bluetooth low energy uses 4.
+ *
+ * @retval NRF_SUCCESS               If the data was encrypted.
+ * @retval NRF_ERROR_NULL            If a required parameter was NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH  If @p nonce_len or @p mic_len was not supported, or @p len
+ *                                   was too long for the nonce length.
+ */
+ret_code_t aes128_ccm_encrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_nonce,
+                              uint32_t                 nonce_len,
+                              uint8_t const          * p_adata,
+                              uint32_t                 adata_len,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 len,
+                              uint8_t                * p_mic,
+                              uint32_t                 mic_len);
+
+
+/**@brief Function for decrypting and verifying data in CCM mode (RFC 3610).
+ *
+ * @details If the MIC does not match, the decrypted data is cleared.
+ *
+ * @param[in]  p_ctx      Initialized context instance.
+ * @param[in]  p_nonce    Nonce.
+ * @param[in]  nonce_len  Length of the nonce, see @ref aes128_ccm_encrypt.
+ * @param[in]  p_adata    Additional data. Can be NULL if @p adata_len is zero.
+ * @param[in]  adata_len  Length of the additional data.
+ * @param[in]  p_src      Ciphertext.
+ * @param[out] p_dst      Cleartext, @p len bytes. Can be the same as @p p_src.
+ * @param[in]  len        Length of the ciphertext.
+ * @param[in]  p_mic      Received message integrity check, @p mic_len bytes.
+ * @param[in]  mic_len    Length of the MIC, see @ref aes128_ccm_encrypt.
+ *
+ * @retval NRF_SUCCESS               If the data was decrypted and the MIC matched.
+ * @retval NRF_ERROR_INVALID_DATA    If the MIC did not match.
+ * @retval NRF_ERROR_NULL            If a required parameter was NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH  If @p nonce_len or @p mic_len was not supported, or @p len
+ *                                   was too long for the nonce length.
+ */
+ret_code_t aes128_ccm_decrypt(aes128_context_t const * p_ctx,
+                              uint8_t const          * p_nonce,
+                              uint32_t                 nonce_len,
+                              uint8_t const          * p_adata,
+                              uint32_t                 adata_len,
+                              uint8_t const          * p_src,
+                              uint8_t                * p_dst,
+                              uint32_t                 len,
+                              uint8_t const          * p_mic,
+                              uint32_t                 mic_len);
+
+#endif // AES_H__
+
+/** @} */
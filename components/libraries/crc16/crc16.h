@@ -25,6 +25,22 @@
 
 #include <stdint.h>
 
+/**@defgroup crc16_engines CRC-16 engines
+ * @{
+ * @brief Implementations selectable at compile time by defining CRC16_ENGINE. All engines give
+ *        the same result, they differ in speed and flash usage.
+ */
+#define CRC16_ENGINE_BITWISE    0 /**< Shift and XOR per byte, no table. */
+#define CRC16_ENGINE_NIBBLE     1 /**< Two lookups per byte in a 16-entry table (32 bytes). */
+#define CRC16_ENGINE_TABLE      2 /**< One lookup per byte in a 256-entry table (512 bytes). */
+#define CRC16_ENGINE_SLICE_BY_4 3 /**< Four bytes per iteration using four 256-entry tables
+                                       (2 kB). */
+/** @} */
+
+#ifndef CRC16_ENGINE
+#define CRC16_ENGINE CRC16_ENGINE_BITWISE /**< Selected CRC-16 engine, see @ref crc16_engines. */
+#endif
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
@@ -24,6 +24,24 @@
 
 #include <stdint.h>
 
+/**@defgroup crc32_engines CRC-32 engines
+ * @{
+ * @brief Implementations selectable at compile time by defining CRC32_ENGINE. All engines give
+ *        the same result, they differ in speed and flash usage.
+ */
+#define CRC32_ENGINE_BITWISE    0 /**< Eight shift and XOR steps per byte, no table. */
+#define CRC32_ENGINE_NIBBLE     1 /**< Two lookups per byte in a 16-entry table (64 bytes). */
+#define CRC32_ENGINE_TABLE      2 /**< One lookup per byte in a 256-entry table (1 kB). */
+#define CRC32_ENGINE_SLICE_BY_4 3 /**< Four bytes per iteration using four 256-entry tables
+                                       (4 kB). */
+#define CRC32_ENGINE_SLICE_BY_8 4 /**< Eight bytes per iteration using eight 256-entry tables
+                                       (8 kB). */
+/** @} */
+
+#ifndef CRC32_ENGINE
+#define CRC32_ENGINE CRC32_ENGINE_BITWISE /**< Selected CRC-32 engine, see @ref crc32_engines. */
+#endif
+
 /**@brief Function for calculating CRC-32 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
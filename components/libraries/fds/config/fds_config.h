@@ -58,6 +58,32 @@
     #define FDS_VIRTUAL_PAGE_SIZE   (1024)
 #endif
 
+/**@brief   Configures the number of records that the RAM index can hold.
+ *
+ * The RAM index holds the record ID, file ID, record key and location of every valid record, so
+ * that records can be found without reading record headers from flash. Each entry takes 12 bytes
+ * of RAM. If there are more valid records than entries, records are found by reading flash until
+ * the index is rebuilt (after garbage collection). Set to zero to disable the RAM index.
+ */
+#define FDS_RAM_INDEX_SIZE          (0)
+
+/**@brief   Configures incremental garbage collection.
+ *
+ * When non-zero, garbage collection lets other queued operations execute after it has copied this
+ * many records, and after each page it has garbage collected. In the middle of a page, it only lets
+ * record writes execute; deletions and updates wait until the page has been garbage collected.
+ * Set to zero to run garbage collection to completion once started.
+ */
+#define FDS_GC_STEP_RECORDS         (0)
+
+/**@brief   Configures automatic garbage collection.
+ *
+ * When non-zero, garbage collection is queued after a record is deleted or updated if the space
+ * occupied by deleted records reaches this percentage of the flash space available for records.
+ * Set to zero to run garbage collection only when @ref fds_gc is called.
+ */
+#define FDS_GC_AUTO_THRESHOLD       (0)
+
 /** @} */
 
 #endif // FDS_CONFIG_H__
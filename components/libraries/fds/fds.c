@@ -66,6 +66,11 @@ static fds_swap_page_t      m_swap_page;
 // Garbage collection data.
 static fds_gc_data_t        m_gc;
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+// Locations of valid records.
+static fds_index_t          m_index;
+#endif
+
 
 static void flag_set(fds_flags_t flag)
 {
@@ -248,13 +253,13 @@ static ret_code_t page_from_record(uint16_t * const p_page, uint32_t const * con
 // Scan a page to determine how many words have been written to it.
 // This information is used to set the page write offset during initialization.
 // Additionally, this function updates the latest record ID as it proceeds.
-// If an invalid record header is found, the can_gc argument is set to true.
+// The words occupied by invalid records are counted in dirty_words, if not NULL.
 static void page_scan(uint32_t const *       p_addr,
                       uint16_t       * const words_written,
-                      bool           * const can_gc)
+                      uint16_t       * const dirty_words)
 {
-    uint32_t const * const p_end_addr          = p_addr + FDS_PAGE_SIZE;
-    bool                   dirty_record_found  = false;
+    uint32_t const * const p_end_addr = p_addr + FDS_PAGE_SIZE;
+    uint16_t               dirty      = 0;
 
     p_addr         += FDS_PAGE_TAG_SIZE;
     *words_written  = FDS_PAGE_TAG_SIZE;
@@ -266,7 +271,7 @@ static void page_scan(uint32_t const *       p_addr,
 
         if (!header_is_valid(p_header))
         {
-            dirty_record_found = true;
+            dirty += (FDS_HEADER_SIZE + p_header->tl.length_words);
         }
         else
         {
@@ -282,9 +287,9 @@ static void page_scan(uint32_t const *       p_addr,
         *words_written += (FDS_HEADER_SIZE + p_header->tl.length_words);
     }
 
-    if (can_gc != NULL)
+    if (dirty_words != NULL)
     {
-        *can_gc = dirty_record_found;
+        *dirty_words = dirty;
     }
 }
 
@@ -407,6 +412,210 @@ static bool record_find_next(uint16_t page, uint32_t const ** p_record)
 }
 
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+
+// Combine a page and an offset into a value which can be compared to order record locations.
+static uint32_t index_position(uint16_t page, uint16_t offset)
+{
+    return ((uint32_t)page << 16) | offset;
+}
+
+
+// Find the first index entry located at or after the given position.
+// NOTE: Must be called from within a critical section.
+static uint16_t index_lower_bound(uint32_t position)
+{
+    uint16_t low  = 0;
+    uint16_t high = m_index.count;
+
+    while (low < high)
+    {
+        uint16_t const           mid     = (low + high) / 2;
+        fds_index_entry_t const * p_entry = &m_index.entry[mid];
+
+        if (index_position(p_entry->page, p_entry->offset) < position)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+
+// Add a valid record to the index. If the index is full, it is no longer used until rebuilt.
+static void index_insert(fds_header_t const * const p_header, uint16_t page, uint16_t offset)
+{
+    CRITICAL_SECTION_ENTER();
+    if (m_index.complete)
+    {
+        if (m_index.count < FDS_RAM_INDEX_SIZE)
+        {
+            uint16_t const i = index_lower_bound(index_position(page, offset));
+
+            memmove(&m_index.entry[i + 1], &m_index.entry[i],
+                    (m_index.count - i) * sizeof(fds_index_entry_t));
+
+            m_index.entry[i].record_id  = p_header->record_id;
+            m_index.entry[i].file_id    = p_header->ic.file_id;
+            m_index.entry[i].record_key = p_header->tl.record_key;
+            m_index.entry[i].page       = page;
+            m_index.entry[i].offset     = offset;
+            m_index.count++;
+        }
+        else
+        {
+            // Fall back to searching flash.
+            m_index.complete = false;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Remove a record which has been flagged as dirty from the index.
+static void index_remove(uint32_t record_id)
+{
+    CRITICAL_SECTION_ENTER();
+    for (uint16_t i = 0; i < m_index.count; i++)
+    {
+        if (m_index.entry[i].record_id == record_id)
+        {
+            m_index.count--;
+            memmove(&m_index.entry[i], &m_index.entry[i + 1],
+                    (m_index.count - i) * sizeof(fds_index_entry_t));
+            break;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Rebuild the index from the records in flash.
+static void index_rebuild(void)
+{
+    CRITICAL_SECTION_ENTER();
+    m_index.count    = 0;
+    m_index.complete = true;
+
+    for (uint16_t page = 0; page < FDS_MAX_PAGES; page++)
+    {
+        uint32_t const * p_record = NULL;
+
+        if (m_pages[page].page_type != FDS_PAGE_DATA)
+        {
+            continue;
+        }
+
+        while (record_find_next(page, &p_record))
+        {
+            index_insert((fds_header_t*)p_record, page, (uint16_t)(p_record - m_pages[page].p_addr));
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Find a record by its ID using the index.
+static bool index_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * const p_page)
+{
+    bool found = false;
+
+    CRITICAL_SECTION_ENTER();
+    for (uint16_t i = 0; i < m_index.count; i++)
+    {
+        fds_index_entry_t const * const p_entry = &m_index.entry[i];
+
+        if (p_entry->record_id == p_desc->record_id)
+        {
+            *p_page              = p_entry->page;
+            p_desc->p_record     = m_pages[p_entry->page].p_addr + p_entry->offset;
+            p_desc->gc_run_count = m_gc.run_count;
+
+            found = true;
+            break;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+
+    return found;
+}
+
+
+// Search for a record using the index. See record_find().
+static ret_code_t index_record_find(uint16_t          const * const p_file_id,
+                                    uint16_t          const * const p_record_key,
+                                    fds_record_desc_t       * const p_desc,
+                                    fds_find_token_t        * const p_token)
+{
+    ret_code_t ret = FDS_ERR_NOT_FOUND;
+    uint32_t   position;
+
+    if (p_token->page >= FDS_MAX_PAGES)
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+
+    CRITICAL_SECTION_ENTER();
+
+    // Resume searching after the record in the token, if any.
+    if (p_token->p_addr == NULL)
+    {
+        position = index_position(p_token->page, 0);
+    }
+    else
+    {
+        position = index_position(p_token->page,
+                                  (uint16_t)(p_token->p_addr - m_pages[p_token->page].p_addr) + 1);
+    }
+
+    for (uint16_t i = index_lower_bound(position); i < m_index.count; i++)
+    {
+        fds_index_entry_t const * const p_entry = &m_index.entry[i];
+
+        if ((p_file_id != NULL) &&
+            (p_entry->file_id != *p_file_id))
+        {
+            continue;
+        }
+
+        if ((p_record_key != NULL) &&
+            (p_entry->record_key != *p_record_key))
+        {
+            continue;
+        }
+
+        // Record found; update the token and the descriptor.
+        p_token->page   = p_entry->page;
+        p_token->p_addr = m_pages[p_entry->page].p_addr + p_entry->offset;
+
+        p_desc->record_id    = p_entry->record_id;
+        p_desc->p_record     = p_token->p_addr;
+        p_desc->gc_run_count = m_gc.run_count;
+
+        ret = FDS_SUCCESS;
+        break;
+    }
+
+    if (ret == FDS_ERR_NOT_FOUND)
+    {
+        // All records have been searched.
+        p_token->page   = FDS_MAX_PAGES;
+        p_token->p_addr = NULL;
+    }
+
+    CRITICAL_SECTION_EXIT();
+
+    return ret;
+}
+
+#endif // FDS_RAM_INDEX_SIZE
+
+
 // Find a record given its descriptor and retrive the page in which the record is stored.
 // NOTE: Do not pass NULL as an argument for p_page.
 static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * const p_page)
@@ -422,6 +631,13 @@ static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * con
         return (page_from_record(p_page, p_desc->p_record) == FDS_SUCCESS);
     }
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+    if (m_index.complete)
+    {
+        return index_find_by_desc(p_desc, p_page);
+    }
+#endif
+
     // Otherwise, find the record in flash.
     for (*p_page = 0; *p_page < FDS_MAX_PAGES; (*p_page)++)
     {
@@ -463,6 +679,13 @@ static ret_code_t record_find(uint16_t          const * const p_file_id,
         return FDS_ERR_NULL_ARG;
     }
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+    if (m_index.complete)
+    {
+        return index_record_find(p_file_id, p_record_key, p_desc, p_token);
+    }
+#endif
+
     // Begin (or resume) searching for a record.
     for (; p_token->page < FDS_MAX_PAGES; p_token->page++)
     {
@@ -526,10 +749,8 @@ static void dirty_records_stat(uint16_t         page,
             (*p_dirty_records) += 1;
             (*p_word_count)    += p_header->tl.length_words;
         }
-        else
-        {
-            p_rec += (FDS_HEADER_SIZE + (p_header->tl.length_words));
-        }
+
+        p_rec += (FDS_HEADER_SIZE + (p_header->tl.length_words));
     }
 }
 
@@ -552,6 +773,23 @@ static bool queue_advance(void)
 }
 
 
+#if (FDS_GC_STEP_RECORDS > 0)
+
+// Move the current element to the back of the queue. This does not require a free element,
+// since the one being moved is freed in the process.
+static void queue_rotate(void)
+{
+    CRITICAL_SECTION_ENTER();
+    uint32_t const idx = (m_op_queue.rp + m_op_queue.count) % FDS_OP_QUEUE_SIZE;
+
+    m_op_queue.op[idx] = m_op_queue.op[m_op_queue.rp];
+    m_op_queue.rp      = (m_op_queue.rp + 1) % FDS_OP_QUEUE_SIZE;
+    CRITICAL_SECTION_EXIT();
+}
+
+#endif
+
+
 // Given a pointer to an element in the chunk queue, computes the pointer to
 // the next element in the queue. Handles wrap around.
 void chunk_queue_next(fds_record_chunk_t ** pp_chunk)
@@ -632,6 +870,25 @@ static bool op_enqueue(fds_op_t           const * const p_op,
 }
 
 
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+
+// Checks whether an operation with the given op-code is queued.
+static bool op_is_queued(fds_op_code_t op_code)
+{
+    for (uint32_t i = 0; i < m_op_queue.count; i++)
+    {
+        if (m_op_queue.op[(m_op_queue.rp + i) % FDS_OP_QUEUE_SIZE].op_code == op_code)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif
+
+
 // This function is called during initialization to setup the page structure (m_pages) and
 // provide additional information regarding eventual further initialization steps.
 static fds_init_opts_t pages_init()
@@ -679,7 +936,8 @@ static fds_init_opts_t pages_init()
                 m_pages[page].p_addr    = p_page_addr;
                 // Scan the page to compute its write offset and determine whether or not the page
                 // can be garbage collected. Additionally, update the latest kwown record ID.
-                page_scan(p_page_addr, &m_pages[page].write_offset, &m_pages[page].can_gc);
+                page_scan(p_page_addr, &m_pages[page].write_offset, &m_pages[page].dirty_words);
+                m_pages[page].can_gc = (m_pages[page].dirty_words != 0);
 
                 ret |= PAGE_DATA;
                 page++;
@@ -785,6 +1043,14 @@ static ret_code_t record_find_and_delete(fds_op_t * const p_op)
 
         // This page can now be garbage collected.
         m_pages[page].can_gc = true;
+
+        if (ret == FDS_SUCCESS)
+        {
+            m_pages[page].dirty_words += (FDS_HEADER_SIZE + p_header->tl.length_words);
+#if (FDS_RAM_INDEX_SIZE > 0)
+            index_remove(desc.record_id);
+#endif
+        }
     }
     else
     {
@@ -815,6 +1081,15 @@ static ret_code_t file_find_and_delete(fds_op_t * const p_op)
 
         // This page can now be garbage collected.
         m_pages[tok.page].can_gc = true;
+
+        if (ret == FDS_SUCCESS)
+        {
+            m_pages[tok.page].dirty_words +=
+                (FDS_HEADER_SIZE + ((fds_header_t const *)desc.p_record)->tl.length_words);
+#if (FDS_RAM_INDEX_SIZE > 0)
+            index_remove(desc.record_id);
+#endif
+        }
     }
     else // FDS_ERR_NOT_FOUND
     {
@@ -882,8 +1157,11 @@ static bool crc_verify_success(uint16_t crc, uint16_t len_words, uint32_t const
 static void gc_init(void)
 {
     m_gc.run_count++;
-    m_gc.cur_page = 0;
-    m_gc.resume   = false;
+    m_gc.cur_page       = 0;
+    m_gc.resume         = false;
+    m_gc.records_copied = 0;
+    m_gc.step_records   = 0;
+    m_gc.step_ops       = 0;
 
     // Setup which pages to GC. Defer checking for open records and the can_gc flag,
     // as other operations might change those while GC is running.
@@ -1027,6 +1305,9 @@ static void gc_update_swap_offset(void)
     uint16_t     const         record_len = FDS_HEADER_SIZE + p_header->tl.length_words;
 
     m_swap_page.write_offset += record_len;
+
+    m_gc.records_copied++;
+    m_gc.step_records++;
 }
 
 
@@ -1042,6 +1323,10 @@ static void gc_swap_pages(void)
     // Keep the offset for this page, but reset it for the swap.
     m_pages[m_gc.cur_page].write_offset = m_swap_page.write_offset;
     m_swap_page.write_offset            = FDS_PAGE_TAG_SIZE;
+
+    // Only valid records were copied.
+    m_pages[m_gc.cur_page].dirty_words  = 0;
+    m_pages[m_gc.cur_page].can_gc       = false;
 }
 
 
@@ -1063,6 +1348,10 @@ static void gc_state_advance(void)
         // A page was successfully erased. Prepare to promote the swap.
         case GC_ERASE_PAGE:
             gc_swap_pages();
+#if (FDS_RAM_INDEX_SIZE > 0)
+            // The records of this page have been moved.
+            index_rebuild();
+#endif
             m_gc.state = GC_PROMOTE_SWAP;
             break;
 
@@ -1085,6 +1374,96 @@ static void gc_state_advance(void)
 }
 
 
+#if (FDS_GC_STEP_RECORDS > 0)
+
+// Called before executing the next GC step. If GC has reached the end of a page, or copied
+// FDS_GC_STEP_RECORDS records, check whether GC should let the operations queued behind it
+// execute first. In the middle of a page, only record writes are let through: deleting or
+// updating a record which has already been copied to swap would leave the copy valid.
+// Returns true if GC should yield.
+static bool gc_yield(void)
+{
+    bool const page_done   = (m_gc.state == GC_NEXT_PAGE);
+    bool const step_done   = (m_gc.state == GC_FIND_NEXT_RECORD) &&
+                             (m_gc.step_records >= FDS_GC_STEP_RECORDS);
+    bool       others      = false;
+    bool       writes_only = true;
+
+    if (!page_done && !step_done)
+    {
+        return false;
+    }
+
+    // Skip the GC operation which is executing.
+    for (uint32_t i = 1; i < m_op_queue.count; i++)
+    {
+        fds_op_code_t const op_code = m_op_queue.op[(m_op_queue.rp + i) % FDS_OP_QUEUE_SIZE].op_code;
+
+        if (op_code == FDS_OP_GC)
+        {
+            // GC has been requested again, it would resume this run. Do not yield.
+            return false;
+        }
+
+        others = true;
+
+        if (op_code != FDS_OP_WRITE)
+        {
+            writes_only = false;
+        }
+    }
+
+    if (!others || (!page_done && !writes_only))
+    {
+        return false;
+    }
+
+    // Execute the current step when GC is resumed.
+    m_gc.resume       = true;
+    m_gc.step_records = 0;
+    m_gc.step_ops     = 0;
+
+    return true;
+}
+
+#endif
+
+
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+
+// Queue GC if the space occupied by dirty records has reached FDS_GC_AUTO_THRESHOLD percent
+// of the space available for records. The space is counted in RAM as records are deleted, since
+// this runs from the fstorage callback.
+static void gc_auto_start(void)
+{
+    uint32_t freeable = 0;
+    fds_op_t op;
+
+    if ((m_gc.state != GC_BEGIN) || op_is_queued(FDS_OP_GC))
+    {
+        // GC is already running or queued.
+        return;
+    }
+
+    for (uint16_t i = 0; i < FDS_MAX_PAGES; i++)
+    {
+        if (m_pages[i].page_type == FDS_PAGE_DATA)
+        {
+            freeable += m_pages[i].dirty_words;
+        }
+    }
+
+    if (freeable * 100 >= (uint32_t)FDS_GC_AUTO_THRESHOLD *
+                          FDS_MAX_PAGES * (FDS_PAGE_SIZE - FDS_PAGE_TAG_SIZE))
+    {
+        op.op_code = FDS_OP_GC;
+        (void)op_enqueue(&op, 0, NULL);
+    }
+}
+
+#endif
+
+
 // Initialize the filesystem.
 static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
 {
@@ -1121,6 +1500,9 @@ static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
             }
             if (!write_reqd)
             {
+#if (FDS_RAM_INDEX_SIZE > 0)
+                index_rebuild();
+#endif
                 flag_set(FDS_FLAG_INITIALIZED);
                 flag_clear(FDS_FLAG_INITIALIZING);
                 return FDS_OP_COMPLETED;
@@ -1192,6 +1574,15 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
     // Compute the address where to write data.
     p_write_addr = (uint32_t*)(p_page->p_addr + p_page->write_offset);
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+    // The record header has been finalized by the previous step, the record is now valid.
+    if ((p_op->write.step == FDS_OP_WRITE_FLAG_DIRTY) ||
+        ((p_op->write.step == FDS_OP_WRITE_DONE) && (p_op->op_code == FDS_OP_WRITE)))
+    {
+        index_insert(&p_op->write.header, p_op->write.page, p_page->write_offset);
+    }
+#endif
+
     // Execute the current step of the operation, and set one to be executed next.
     switch (p_op->write.step)
     {
@@ -1230,9 +1621,28 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
             break;
 
         case FDS_OP_WRITE_FLAG_DIRTY:
+        {
+            uint16_t page;
+
             ret = record_header_flag_dirty((uint32_t*)desc.p_record);
             p_op->write.step = FDS_OP_WRITE_DONE;
-            break;
+
+            if ((ret == FDS_SUCCESS) &&
+                (page_from_record(&page, desc.p_record) == FDS_SUCCESS))
+            {
+                // The page of the old copy can now be garbage collected.
+                m_pages[page].can_gc       = true;
+                m_pages[page].dirty_words += (FDS_HEADER_SIZE +
+                    ((fds_header_t const *)desc.p_record)->tl.length_words);
+            }
+#if (FDS_RAM_INDEX_SIZE > 0)
+            if (ret == FDS_SUCCESS)
+            {
+                index_remove(desc.record_id);
+            }
+#endif
+        }
+        break;
 
         case FDS_OP_WRITE_DONE:
             ret = FDS_OP_COMPLETED;
@@ -1322,6 +1732,13 @@ static ret_code_t gc_execute(uint32_t prev_ret)
     else
     {
         gc_state_advance();
+
+#if (FDS_GC_STEP_RECORDS > 0)
+        if (gc_yield())
+        {
+            return FDS_OP_YIELDED;
+        }
+#endif
     }
 
     switch (m_gc.state)
@@ -1356,6 +1773,21 @@ static ret_code_t gc_execute(uint32_t prev_ret)
             break;
     }
 
+    if ((ret == FDS_OP_EXECUTING) && (m_op_queue.count > 1))
+    {
+        // Keep track of how long other operations wait for GC, in flash operations.
+        m_gc.step_ops++;
+        if (m_gc.step_ops > m_gc.max_step_ops)
+        {
+            m_gc.max_step_ops = m_gc.step_ops;
+        }
+    }
+    else if (m_op_queue.count == 1)
+    {
+        // Nothing is waiting.
+        m_gc.step_ops = 0;
+    }
+
     // Either FDS_OP_EXECUTING, FDS_OP_COMPLETED, FDS_ERR_BUSY or FDS_ERR_INTERNAL.
     return ret;
 }
@@ -1366,6 +1798,14 @@ static void queue_process(fs_ret_t result)
     ret_code_t         ret;
     fds_op_t   * const p_op = &m_op_queue.op[m_op_queue.rp];
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+    if (result != FS_SUCCESS)
+    {
+        // The state of the records affected by the operation which timed out is unknown.
+        index_rebuild();
+    }
+#endif
+
     switch (p_op->op_code)
     {
         case FDS_OP_INIT:
@@ -1391,13 +1831,22 @@ static void queue_process(fs_ret_t result)
             break;
     }
 
-    if (ret != FDS_OP_EXECUTING)
+    if ((ret != FDS_OP_EXECUTING) && (ret != FDS_OP_YIELDED))
     {
         fds_evt_t evt;
 
         if (ret == FDS_OP_COMPLETED)
         {
             evt.result = FDS_SUCCESS;
+
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+            if ((p_op->op_code == FDS_OP_DEL_RECORD) ||
+                (p_op->op_code == FDS_OP_DEL_FILE)   ||
+                (p_op->op_code == FDS_OP_UPDATE))
+            {
+                gc_auto_start();
+            }
+#endif
         }
         else
         {
@@ -1411,7 +1860,20 @@ static void queue_process(fs_ret_t result)
 
         event_prepare(p_op, &evt);
         event_send(&evt);
+    }
+
+#if (FDS_GC_STEP_RECORDS > 0)
+    if (ret == FDS_OP_YIELDED)
+    {
+        // Queue GC behind the other operations, and process the next one.
+        queue_rotate();
+        queue_process(FS_SUCCESS);
+        return;
+    }
+#endif
 
+    if (ret != FDS_OP_EXECUTING)
+    {
         // Advance the queue, and if there are any queued operations, process them.
         if (queue_advance())
         {
@@ -1618,6 +2080,9 @@ ret_code_t fds_init(void)
     if (init_opts == ALREADY_INSTALLED)
     {
         // No initialization is necessary. Notify the application immediately.
+#if (FDS_RAM_INDEX_SIZE > 0)
+        index_rebuild();
+#endif
         flag_set(FDS_FLAG_INITIALIZED);
         flag_clear(FDS_FLAG_INITIALIZING);
 
@@ -2032,8 +2497,17 @@ ret_code_t fds_stat(fds_stat_t * const p_stat)
         }
 
         dirty_records_stat(i, &p_stat->dirty_records, &p_stat->freeable_words);
+
+        if (m_gc.do_gc_page[i])
+        {
+            p_stat->gc_pages_left++;
+        }
     }
 
+    p_stat->gc_running        = (m_gc.state != GC_BEGIN);
+    p_stat->gc_records_copied = m_gc.records_copied;
+    p_stat->gc_max_step_ops   = m_gc.max_step_ops;
+
     return FDS_SUCCESS;
 }
 
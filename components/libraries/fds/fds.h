@@ -278,6 +278,18 @@ typedef struct
      * records are open while garbage collection is run.
      */
     uint16_t freeable_words;
+
+    bool     gc_running;        //!< Whether garbage collection is in progress.
+    uint16_t gc_pages_left;     //!< The number of pages garbage collection has yet to examine in the current run.
+    uint16_t gc_records_copied; //!< The number of records copied by the current (or last) garbage collection run.
+
+    /**@brief The largest number of flash operations that garbage collection has executed in a row
+     *        while other operations were waiting to execute.
+     *
+     * This bounds the time that queued operations wait for garbage collection. See
+     * @ref FDS_GC_STEP_RECORDS.
+     */
+    uint16_t gc_max_step_ops;
 } fds_stat_t;
 
 
@@ -646,6 +658,11 @@ ret_code_t fds_record_close(fds_record_desc_t * const p_desc);
  * This function is asynchronous. Completion is reported through an event that is sent to the
  * registered event handler function.
  *
+ * If @ref FDS_GC_STEP_RECORDS is non-zero, operations queued while garbage collection is running
+ * can execute before garbage collection completes. If @ref FDS_GC_AUTO_THRESHOLD is non-zero,
+ * garbage collection may also be started by the module itself, in which case an
+ * @ref FDS_EVT_GC event is sent upon completion as well.
+ *
  * @retval  FDS_SUCCESS                 If the operation was queued successfully.
  * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
  * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
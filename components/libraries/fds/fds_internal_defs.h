@@ -45,6 +45,7 @@
 
 #define FDS_OP_EXECUTING        (FS_SUCCESS)
 #define FDS_OP_COMPLETED        (0x1D1D)
+#define FDS_OP_YIELDED          (0x1D1E) // Garbage collection lets the queued operations execute first.
 
 // The size of a physical page, in 4-byte words.
 #if   defined(NRF51)
@@ -74,6 +75,18 @@
     #error "FDS requires at least two virtual pages."
 #endif
 
+#ifndef FDS_RAM_INDEX_SIZE
+    #define FDS_RAM_INDEX_SIZE      (0)
+#endif
+
+#ifndef FDS_GC_STEP_RECORDS
+    #define FDS_GC_STEP_RECORDS     (0)
+#endif
+
+#ifndef FDS_GC_AUTO_THRESHOLD
+    #define FDS_GC_AUTO_THRESHOLD   (0)
+#endif
+
 
 // FDS internal status flags.
 typedef enum
@@ -102,6 +115,7 @@ typedef struct
     uint16_t                write_offset;   // The page write offset, in 4-byte words.
     uint16_t                words_reserved; // The amount of words reserved by fds_write_reserve().
     uint16_t                records_open;   // The number of records opened using fds_open().
+    uint16_t                dirty_words;    // The amount of words occupied by deleted records, headers included.
     bool                    can_gc;         // Indicates that there are some records that have been deleted.
 } fds_page_t;
 
@@ -285,9 +299,37 @@ typedef struct
     uint16_t         run_count;                 // Total number of times GC was run.
     bool             do_gc_page[FDS_MAX_PAGES]; // Controls which pages to garbage collect.
     bool             resume;                    // Whether or not GC should be resumed.
+    uint16_t         records_copied;            // Number of records copied by the current (or last) run.
+    uint16_t         step_records;              // Number of records copied since GC last yielded.
+    uint16_t         step_ops;                  // Flash operations executed by GC while others waited.
+    uint16_t         max_step_ops;              // Largest value of step_ops.
 } fds_gc_data_t;
 
 
+#if (FDS_RAM_INDEX_SIZE > 0)
+
+// An entry in the RAM index.
+typedef struct
+{
+    uint32_t record_id;     // The record ID.
+    uint16_t file_id;       // The ID of the file the record belongs to.
+    uint16_t record_key;    // The record key.
+    uint16_t page;          // The page the record is stored on.
+    uint16_t offset;        // The offset of the record from the page address, in 4-byte words.
+} fds_index_entry_t;
+
+
+// Holds the locations of valid records, sorted by page and offset.
+typedef struct
+{
+    fds_index_entry_t entry[FDS_RAM_INDEX_SIZE];
+    uint16_t          count;    // Number of entries in use.
+    bool              complete; // Whether all valid records are in the index. If not, the index is not used.
+} fds_index_t;
+
+#endif
+
+
 // Macros to enable and disable application interrupts.
 #if defined (FDS_THREADS)
 
@@ -11,6 +11,7 @@
  */
 
 #include "app_fifo.h"
+#include <string.h>
 #include "sdk_common.h"
 #include "nordic_common.h"
 
@@ -47,6 +48,30 @@ static __INLINE void fifo_get(app_fifo_t * p_fifo, uint8_t * p_byte)
 }
 
 
+/**@brief Put a number of bytes to the FIFO, using at most two memory copies. */
+static __INLINE void fifo_put_bulk(app_fifo_t * p_fifo, uint8_t const * p_data, uint32_t len)
+{
+    uint32_t const start = p_fifo->write_pos & p_fifo->buf_size_mask;
+    uint32_t const first = MIN(len, (uint32_t)p_fifo->buf_size_mask + 1 - start);
+
+    memcpy(&p_fifo->p_buf[start], p_data, first);
+    memcpy(p_fifo->p_buf, &p_data[first], len - first);
+    p_fifo->write_pos += len;
+}
+
+
+/**@brief Get a number of bytes from the FIFO, using at most two memory copies. */
+static __INLINE void fifo_get_bulk(app_fifo_t * p_fifo, uint8_t * p_data, uint32_t len)
+{
+    uint32_t const start = p_fifo->read_pos & p_fifo->buf_size_mask;
+    uint32_t const first = MIN(len, (uint32_t)p_fifo->buf_size_mask + 1 - start);
+
+    memcpy(p_data, &p_fifo->p_buf[start], first);
+    memcpy(&p_data[first], p_fifo->p_buf, len - first);
+    p_fifo->read_pos += len;
+}
+
+
 uint32_t app_fifo_init(app_fifo_t * p_fifo, uint8_t * p_buf, uint16_t buf_size)
 {
     // Check buffer for null pointer.
@@ -121,7 +146,6 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
 
     const uint32_t byte_count    = fifo_length(p_fifo);
     const uint32_t requested_len = (*p_size);
-    uint32_t       index         = 0;
     uint32_t       read_size     = MIN(requested_len, byte_count);
 
     (*p_size) = byte_count;
@@ -139,10 +163,7 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
     }
 
     // Fetch bytes from the FIFO.
-    while (index < read_size)
-    {
-        fifo_get(p_fifo, &p_byte_array[index++]);
-    }
+    fifo_get_bulk(p_fifo, p_byte_array, read_size);
 
     (*p_size) = read_size;
 
@@ -157,7 +178,6 @@ uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint3
 
     const uint32_t available_count = p_fifo->buf_size_mask - fifo_length(p_fifo) + 1;
     const uint32_t requested_len   = (*p_size);
-    uint32_t       index           = 0;
     uint32_t       write_size      = MIN(requested_len, available_count);
 
     (*p_size) = available_count;
@@ -174,13 +194,116 @@ uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint3
         return NRF_SUCCESS;
     }
 
-    //Fetch bytes from the FIFO.
-    while (index < write_size)
+    // Put bytes into the FIFO.
+    fifo_put_bulk(p_fifo, p_byte_array, write_size);
+
+    (*p_size) = write_size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_read_span_get(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+    VERIFY_PARAM_NOT_NULL(pp_data);
+    VERIFY_PARAM_NOT_NULL(p_size);
+
+    const uint32_t byte_count = fifo_length(p_fifo);
+    const uint32_t start      = p_fifo->read_pos & p_fifo->buf_size_mask;
+
+    (*pp_data) = &p_fifo->p_buf[start];
+    (*p_size)  = MIN(byte_count, (uint32_t)p_fifo->buf_size_mask + 1 - start);
+
+    if (byte_count == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_read_commit(app_fifo_t * p_fifo, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+
+    if (size > fifo_length(p_fifo))
     {
-        fifo_put(p_fifo, p_byte_array[index++]);
+        return NRF_ERROR_INVALID_LENGTH;
     }
 
-    (*p_size) = write_size;
+    p_fifo->read_pos += size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_read_chunk_get(app_fifo_t * p_fifo,
+                                 uint8_t   ** pp_data,
+                                 uint8_t    * p_bounce,
+                                 uint32_t     max_size,
+                                 uint32_t   * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+    VERIFY_PARAM_NOT_NULL(pp_data);
+    VERIFY_PARAM_NOT_NULL(p_bounce);
+    VERIFY_PARAM_NOT_NULL(p_size);
+
+    const uint32_t size  = MIN(fifo_length(p_fifo), max_size);
+    const uint32_t start = p_fifo->read_pos & p_fifo->buf_size_mask;
+    const uint32_t first = MIN(size, (uint32_t)p_fifo->buf_size_mask + 1 - start);
+
+    if (size == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    (*pp_data) = &p_fifo->p_buf[start];
+    (*p_size)  = size;
+
+    if (first < size)
+    {
+        memcpy(p_bounce, *pp_data, first);
+        memcpy(&p_bounce[first], p_fifo->p_buf, size - first);
+        (*pp_data) = p_bounce;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_write_span_get(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+    VERIFY_PARAM_NOT_NULL(pp_data);
+    VERIFY_PARAM_NOT_NULL(p_size);
+
+    const uint32_t available_count = p_fifo->buf_size_mask - fifo_length(p_fifo) + 1;
+    const uint32_t start           = p_fifo->write_pos & p_fifo->buf_size_mask;
+
+    (*pp_data) = &p_fifo->p_buf[start];
+    (*p_size)  = MIN(available_count, (uint32_t)p_fifo->buf_size_mask + 1 - start);
+
+    if (available_count == 0)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_write_commit(app_fifo_t * p_fifo, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+
+    if (size > p_fifo->buf_size_mask - fifo_length(p_fifo) + 1)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_fifo->write_pos += size;
 
     return NRF_SUCCESS;
 }
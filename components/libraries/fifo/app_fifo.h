@@ -140,6 +140,88 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
  */
 uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint32_t * p_size);
 
+/**@brief Function for getting the largest contiguous region of the FIFO that can be read.
+ *
+ * The region starts at the oldest byte in the FIFO. It is smaller than the number of bytes in the
+ * FIFO if the data wraps around the end of the buffer, in which case the rest of the data is
+ * returned by the next call, after @ref app_fifo_read_commit. This allows, for example, an EasyDMA
+ * peripheral to transmit directly from the FIFO buffer. The bytes stay in the FIFO, and the
+ * region stays valid, until they are released with @ref app_fifo_read_commit.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[out] pp_data  Start of the readable region.
+ * @param[out] p_size   Size of the readable region, in bytes.
+ *
+ * @retval     NRF_SUCCESS          If a non-empty region was returned.
+ * @retval     NRF_ERROR_NULL       If a NULL parameter was passed.
+ * @retval     NRF_ERROR_NOT_FOUND  If the FIFO is empty.
+ */
+uint32_t app_fifo_read_span_get(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size);
+
+/**@brief Function for removing bytes that were read through @ref app_fifo_read_span_get.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[in]  size     Number of bytes to remove from the FIFO.
+ *
+ * @retval     NRF_SUCCESS              If the bytes were removed.
+ * @retval     NRF_ERROR_NULL           If a NULL parameter was passed.
+ * @retval     NRF_ERROR_INVALID_LENGTH If @p size is larger than the number of bytes in the FIFO.
+ */
+uint32_t app_fifo_read_commit(app_fifo_t * p_fifo, uint32_t size);
+
+/**@brief Function for getting up to @p max_size of the oldest bytes in the FIFO as one contiguous
+ *        block.
+ *
+ * The block is the region returned by @ref app_fifo_read_span_get, unless the data wraps around
+ * the end of the buffer within @p max_size bytes, in which case the data is copied to
+ * @p p_bounce. This allows, for example, a packet to be sent from the FIFO buffer, copying only
+ * the packets that wrap. The bytes stay in the FIFO until they are released with
+ * @ref app_fifo_read_commit.
+ *
+ * @param[in]  p_fifo    Pointer to the FIFO. Must not be NULL.
+ * @param[out] pp_data   Start of the block.
+ * @param[in]  p_bounce  Buffer of @p max_size bytes, for a block that wraps.
+ * @param[in]  max_size  Largest size of the block, in bytes.
+ * @param[out] p_size    Size of the block, in bytes.
+ *
+ * @retval     NRF_SUCCESS          If a non-empty block was returned.
+ * @retval     NRF_ERROR_NULL       If a NULL parameter was passed.
+ * @retval     NRF_ERROR_NOT_FOUND  If the FIFO is empty.
+ */
+uint32_t app_fifo_read_chunk_get(app_fifo_t * p_fifo,
+                                 uint8_t   ** pp_data,
+                                 uint8_t    * p_bounce,
+                                 uint32_t     max_size,
+                                 uint32_t   * p_size);
+
+/**@brief Function for getting the largest contiguous region of the FIFO that can be written.
+ *
+ * The region starts at the first free byte of the FIFO. It is smaller than the free space in the
+ * FIFO if the free space wraps around the end of the buffer. This allows, for example, an EasyDMA
+ * peripheral to receive directly into the FIFO buffer. The bytes written to the region are added
+ * to the FIFO by @ref app_fifo_write_commit.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[out] pp_data  Start of the writable region.
+ * @param[out] p_size   Size of the writable region, in bytes.
+ *
+ * @retval     NRF_SUCCESS          If a non-empty region was returned.
+ * @retval     NRF_ERROR_NULL       If a NULL parameter was passed.
+ * @retval     NRF_ERROR_NO_MEM     If the FIFO is full.
+ */
+uint32_t app_fifo_write_span_get(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size);
+
+/**@brief Function for adding bytes that were written through @ref app_fifo_write_span_get.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[in]  size     Number of bytes to add to the FIFO.
+ *
+ * @retval     NRF_SUCCESS              If the bytes were added.
+ * @retval     NRF_ERROR_NULL           If a NULL parameter was passed.
+ * @retval     NRF_ERROR_INVALID_LENGTH If @p size is larger than the free space in the FIFO.
+ */
+uint32_t app_fifo_write_commit(app_fifo_t * p_fifo, uint32_t size);
+
 #endif // APP_FIFO_H__
 
 /** @} */
@@ -53,6 +53,20 @@
     #define FS_MAX_WRITE_SIZE_WORDS     (1024)
 #endif
 
+
+/**@brief   Configures the size, in words, of the buffer used to combine queued store operations
+ *          into a single flash write. Set to zero to disable write-combining.
+ *
+ * @details When the operation at the head of the queue is a store, fstorage looks ahead in the
+ *          queue for store operations whose destination immediately follows it in the same flash
+ *          page. The data of these operations is copied to this buffer and written with one call
+ *          to @ref sd_flash_write, which saves the per-call overhead of the SoftDevice and the
+ *          latency of one system event per operation. An event is still sent for each of the
+ *          original operations. A combined write never exceeds @ref FS_MAX_WRITE_SIZE_WORDS, so
+ *          that it fits the same SoftDevice timeslots as an uncombined write.
+ */
+#define FS_WRITE_COMBINE_BUFFER_WORDS   (0)
+
 /** @} */
 
 #endif // FS_CONFIG_H__
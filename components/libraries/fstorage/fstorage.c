@@ -24,14 +24,32 @@
 static uint8_t       m_flags;       // fstorage status flags.
 static fs_op_queue_t m_queue;       // Queue of requested operations.
 static uint8_t       m_retry_count; // Number of times the last flash operation was retried.
+static fs_stats_t    m_stats;       // Operation statistics.
+static uint32_t      m_write_ops;   // Number of queued operations covered by the current flash write.
+static uint16_t      m_write_len;   // Length of the current flash write, in words.
+
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+static uint32_t      m_combine_buf[FS_WRITE_COMBINE_BUFFER_WORDS]; // Data of a combined write.
+#endif
 
 
 // Sends events to the application.
 static void send_event(fs_op_t const * const p_op, fs_ret_t result)
 {
     fs_evt_t evt;
+    uint32_t latency;
+
     memset(&evt, 0x00, sizeof(fs_evt_t));
 
+    latency = (FS_OP_TIMESTAMP() - p_op->timestamp) & FS_OP_TIMESTAMP_MASK;
+
+    m_stats.ops_completed++;
+    m_stats.total_latency += latency;
+    if (latency > m_stats.max_latency)
+    {
+        m_stats.max_latency = latency;
+    }
+
     switch (p_op->op_code)
     {
         case FS_OP_STORE:
@@ -59,8 +77,8 @@ static void send_event(fs_op_t const * const p_op, fs_ret_t result)
 static bool check_config(fs_config_t const * const config)
 {
     if ((config != NULL) &&
-        (FS_SECTION_VARS_START_ADDR <= (uint32_t)config) &&
-        (FS_SECTION_VARS_END_ADDR   >  (uint32_t)config))
+        (FS_SECTION_VARS_START_ADDR <= (uintptr_t)config) &&
+        (FS_SECTION_VARS_END_ADDR   >  (uintptr_t)config))
     {
         return true;
     }
@@ -69,23 +87,108 @@ static bool check_config(fs_config_t const * const config)
 }
 
 
+// Returns the index of the queue element following the one at index idx.
+static uint32_t queue_next(uint32_t idx)
+{
+    return (idx + 1 < FS_QUEUE_SIZE) ? (idx + 1) : 0;
+}
+
+
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+
+// Size limit of a combined write, in words.
+#if (FS_WRITE_COMBINE_BUFFER_WORDS < FS_MAX_WRITE_SIZE_WORDS)
+    #define FS_COMBINE_MAX_WORDS    (FS_WRITE_COMBINE_BUFFER_WORDS)
+#else
+    #define FS_COMBINE_MAX_WORDS    (FS_MAX_WRITE_SIZE_WORDS)
+#endif
+
+// Combines the store operation at the head of the queue with the store operations that follow it,
+// as long as their destinations are contiguous and within the same flash page. Copies their data
+// to m_combine_buf and sets m_write_ops and m_write_len. Returns false if there is nothing to
+// combine, in which case the operation is to be executed on its own.
+static bool store_combine(fs_op_t const * const p_op)
+{
+    uint32_t         idx      = m_queue.rp;
+    uint32_t         ops      = 1;
+    uint32_t         words    = p_op->store.length_words;
+    uint32_t const * p_pg_end = (uint32_t*)((((uintptr_t)p_op->store.p_dest / FS_PAGE_SIZE) + 1) *
+                                            FS_PAGE_SIZE);
+
+    if ((p_op->store.offset != 0) || (words > FS_COMBINE_MAX_WORDS))
+    {
+        return false;
+    }
+
+    while (ops < m_queue.count)
+    {
+        fs_op_t const * const p_next = &m_queue.op[queue_next(idx)];
+
+        if ((p_next->op_code != FS_OP_STORE)                                 ||
+            (p_next->store.p_dest != p_op->store.p_dest + words)             ||
+            (p_next->store.p_dest + p_next->store.length_words > p_pg_end)   ||
+            (words + p_next->store.length_words > FS_COMBINE_MAX_WORDS))
+        {
+            break;
+        }
+
+        words += p_next->store.length_words;
+        idx    = queue_next(idx);
+        ops++;
+    }
+
+    if (ops == 1)
+    {
+        return false;
+    }
+
+    idx   = m_queue.rp;
+    words = 0;
+
+    for (uint32_t i = 0; i < ops; i++)
+    {
+        fs_op_t const * const p_cur = &m_queue.op[idx];
+
+        memcpy(&m_combine_buf[words], p_cur->store.p_src,
+               p_cur->store.length_words * sizeof(uint32_t));
+
+        words += p_cur->store.length_words;
+        idx    = queue_next(idx);
+    }
+
+    m_write_ops = ops;
+    m_write_len = words;
+
+    return true;
+}
+
+#endif // FS_WRITE_COMBINE_BUFFER_WORDS > 0
+
+
 // Executes a store operation.
 static uint32_t store_execute(fs_op_t const * const p_op)
 {
-    uint16_t chunk_len;
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+    if (store_combine(p_op))
+    {
+        return sd_flash_write((uint32_t*)p_op->store.p_dest, m_combine_buf, m_write_len);
+    }
+#endif
+
+    m_write_ops = 1;
 
     if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
     {
-        chunk_len = p_op->store.length_words - p_op->store.offset;
+        m_write_len = p_op->store.length_words - p_op->store.offset;
     }
     else
     {
-        chunk_len = FS_MAX_WRITE_SIZE_WORDS;
+        m_write_len = FS_MAX_WRITE_SIZE_WORDS;
     }
 
     return sd_flash_write((uint32_t*)p_op->store.p_dest + p_op->store.offset,
                           (uint32_t*)p_op->store.p_src  + p_op->store.offset,
-                          chunk_len);
+                          m_write_len);
 }
 
 
@@ -105,10 +208,7 @@ static void queue_advance(void)
         m_flags &= ~FS_FLAG_PROCESSING;
     }
 
-    if (++m_queue.rp == FS_QUEUE_SIZE)
-    {
-        m_queue.rp = 0;
-    }
+    m_queue.rp = queue_next(m_queue.rp);
 }
 
 
@@ -178,18 +278,24 @@ static void on_operation_success(fs_op_t * const p_op)
     {
         case FS_OP_STORE:
         {
-            uint16_t chunk_len;
+            m_stats.flash_writes++;
+            m_stats.words_written += m_write_len;
 
-            if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
+            if (m_write_ops > 1)
             {
-                chunk_len = p_op->store.length_words - p_op->store.offset;
-            }
-            else
-            {
-                chunk_len = FS_MAX_WRITE_SIZE_WORDS;
+                // A combined write has finished. Notify every operation it covered.
+                m_stats.ops_combined += m_write_ops - 1;
+
+                while (m_write_ops > 0)
+                {
+                    m_write_ops--;
+                    send_event(&m_queue.op[m_queue.rp], FS_SUCCESS);
+                    queue_advance();
+                }
+                break;
             }
 
-            p_op->store.offset += chunk_len;
+            p_op->store.offset += m_write_len;
 
             if (p_op->store.offset == p_op->store.length_words)
             {
@@ -202,6 +308,8 @@ static void on_operation_success(fs_op_t * const p_op)
 
         case FS_OP_ERASE:
         {
+            m_stats.flash_erases++;
+
             p_op->erase.page++;
             p_op->erase.pages_erased++;
 
@@ -228,6 +336,18 @@ static void on_operation_failure(fs_op_t const * const p_op)
     {
         m_retry_count = 0;
 
+        if ((p_op->op_code == FS_OP_STORE) && (m_write_ops > 1))
+        {
+            // Every operation covered by a combined write has timed out.
+            while (m_write_ops > 0)
+            {
+                m_write_ops--;
+                send_event(&m_queue.op[m_queue.rp], FS_ERR_OPERATION_TIMEOUT);
+                queue_advance();
+            }
+            return;
+        }
+
         send_event(p_op, FS_ERR_OPERATION_TIMEOUT);
         queue_advance();
     }
@@ -245,8 +365,7 @@ static bool queue_get_next_free(fs_op_t ** p_op)
         return false;
     }
 
-    idx = ((m_queue.rp + m_queue.count) < FS_QUEUE_SIZE) ?
-           (m_queue.rp + m_queue.count) : 0;
+    idx = (m_queue.rp + m_queue.count) % FS_QUEUE_SIZE;
 
     m_queue.count++;
 
@@ -352,8 +471,8 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
     }
 
     // Check that both pointers are word aligned.
-    if (((uint32_t)p_src  & 0x03) ||
-        ((uint32_t)p_dest & 0x03))
+    if (((uintptr_t)p_src  & 0x03) ||
+        ((uintptr_t)p_dest & 0x03))
     {
         return FS_ERR_UNALIGNED_ADDR;
     }
@@ -381,6 +500,7 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
     p_op->store.p_src        = p_src;
     p_op->store.p_dest       = p_dest;
     p_op->store.length_words = length_words;
+    p_op->timestamp          = FS_OP_TIMESTAMP();
 
     queue_start();
 
@@ -410,7 +530,7 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
     }
 
     // Check that the page is aligned to a page boundary.
-    if (((uint32_t)p_page_addr % FS_PAGE_SIZE) != 0)
+    if (((uintptr_t)p_page_addr % FS_PAGE_SIZE) != 0)
     {
         return FS_ERR_UNALIGNED_ADDR;
     }
@@ -435,8 +555,9 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
     // Initialize the operation.
     p_op->p_config             = p_config;
     p_op->op_code              = FS_OP_ERASE;
-    p_op->erase.page           = ((uint32_t)p_page_addr / FS_PAGE_SIZE);
+    p_op->erase.page           = ((uintptr_t)p_page_addr / FS_PAGE_SIZE);
     p_op->erase.pages_to_erase = num_pages;
+    p_op->timestamp            = FS_OP_TIMESTAMP();
 
     queue_start();
 
@@ -457,6 +578,19 @@ fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count)
 }
 
 
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return FS_ERR_NULL_ARG;
+    }
+
+    *p_stats = m_stats;
+
+    return FS_SUCCESS;
+}
+
+
 void fs_sys_event_handler(uint32_t sys_evt)
 {
     fs_op_t * const p_op = &m_queue.op[m_queue.rp];
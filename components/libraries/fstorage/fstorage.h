@@ -86,6 +86,25 @@ typedef struct
 #endif
 
 
+/**@brief   fstorage operation statistics.
+ *
+ * @details The average latency of an operation is @p total_latency divided by @p ops_completed.
+ *          Latencies are measured from the moment an operation is queued until its event is sent,
+ *          in FS_OP_TIMESTAMP() ticks. Unless defined otherwise, FS_OP_TIMESTAMP() reads the RTC1
+ *          counter (the RTC used by the app_timer module).
+ */
+typedef struct
+{
+    uint32_t ops_completed;     //!< Number of store and erase operations reported to the application.
+    uint32_t ops_combined;      //!< Number of store operations written as part of another operation's flash write.
+    uint32_t flash_writes;      //!< Number of completed calls to @ref sd_flash_write.
+    uint32_t flash_erases;      //!< Number of completed calls to @ref sd_flash_page_erase.
+    uint32_t words_written;     //!< Number of words written to flash.
+    uint32_t total_latency;     //!< Sum of the latencies of all completed operations.
+    uint32_t max_latency;       //!< Maximum latency of a completed operation.
+} fs_stats_t;
+
+
 /**@brief   fstorage event handler function prototype.
  *
  * @param[in]   evt     The event.
@@ -220,6 +239,16 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
 fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count);
 
 
+/**@brief   Function for retrieving operation statistics.
+ *
+ * @param[out]  p_stats     Operation statistics.
+ *
+ * @retval  FS_SUCCESS          If the statistics were retrieved successfully.
+ * @retval  FS_ERR_NULL_ARG     If @p p_stats is NULL.
+ */
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats);
+
+
 /**@brief   Function for handling system events from the SoftDevice.
  *
  * @details If any of the modules used by the application rely on fstorage, the application should
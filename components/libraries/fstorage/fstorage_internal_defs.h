@@ -81,6 +81,7 @@ typedef struct
             uint16_t pages_to_erase;
         } erase;
     };
+    uint32_t             timestamp;         // Time at which the operation was queued.
 } fs_op_t;
 
 #if defined(__CC_ARM)
@@ -104,6 +105,16 @@ typedef struct
 } fs_op_queue_t;
 
 
+// Time source for latency measurements.
+#ifndef FS_OP_TIMESTAMP
+    #define FS_OP_TIMESTAMP()       (NRF_RTC1->COUNTER)
+    #define FS_OP_TIMESTAMP_MASK    (0x00FFFFFF)
+#endif
+#ifndef FS_OP_TIMESTAMP_MASK
+    #define FS_OP_TIMESTAMP_MASK    (0xFFFFFFFF)
+#endif
+
+
 // Size of a flash page in bytes.
 #if   defined (NRF51)
     #define FS_PAGE_SIZE    (1024)
@@ -121,8 +132,8 @@ static uint32_t const * fs_flash_page_end_addr()
 {
     uint32_t const bootloader_addr = NRF_UICR->NRFFW[0];
 
-    return  (uint32_t*)((bootloader_addr != FS_ERASED_WORD) ? bootloader_addr :
-                                                              NRF_FICR->CODESIZE * FS_PAGE_SIZE);
+    return  (uint32_t*)(uintptr_t)((bootloader_addr != FS_ERASED_WORD) ?
+                                   bootloader_addr : NRF_FICR->CODESIZE * FS_PAGE_SIZE);
 }
 
 
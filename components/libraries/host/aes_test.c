@@ -0,0 +1,269 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the software AES-128 library against published test vectors.
+ *
+ * @details The vectors are:
+ *          - FIPS-197 appendix C.1, encrypted and decrypted in ECB mode.
+ *          - SP 800-38A F.5.1 and F.5.2, CTR-AES128 encryption and decryption, in one call and in
+ *            two calls sharing the counter block.
+ *          - RFC 3610 packet vector #1, CCM with a 13-byte nonce, 8 bytes of additional data and an
+ *            8-byte MIC. Decryption must fail, and clear the output, when the MIC is altered.
+ *          - The sample data of the random address hash function ah() in the Bluetooth Core
+ *            Specification, Vol 3, Part H, appendix D.7.
+ *
+ *          Multi-block ECB calls, which process blocks in pairs, must give the same result as one
+ *          call per block, for odd and even numbers of blocks. The time per block of ECB encryption
+ *          is printed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "aes.h"
+
+#define BATCH_BLOCKS        7           /**< Number of blocks of the multi-block ECB check. */
+#define BENCH_BLOCKS        64          /**< Number of blocks encrypted per call in the benchmark. */
+#define BENCH_LOOPS         2000        /**< Number of calls in the benchmark. */
+
+static uint32_t m_failures;
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**@brief Function for converting a hexadecimal string to bytes.
+ *
+ * @return Number of bytes.
+ */
+static uint32_t hex_decode(char const * p_hex, uint8_t * p_dst)
+{
+    uint32_t len = 0;
+
+    while ((p_hex[0] != '\0') && (p_hex[1] != '\0'))
+    {
+        unsigned int byte;
+
+        (void)sscanf(p_hex, "%2x", &byte);
+        p_dst[len++] = (uint8_t)byte;
+        p_hex       += 2;
+    }
+
+    return len;
+}
+
+
+static void check(bool condition, char const * p_what)
+{
+    if (!condition)
+    {
+        printf("%s: FAILED\n", p_what);
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for checking data against the expected value, given in hexadecimal. */
+static void check_hex(uint8_t const * p_data, char const * p_expected, char const * p_what)
+{
+    uint8_t  expected[64];
+    uint32_t len = hex_decode(p_expected, expected);
+
+    check(memcmp(p_data, expected, len) == 0, p_what);
+}
+
+
+static void fips_197_check(void)
+{
+    aes128_context_t ctx;
+    uint8_t          key[16];
+    uint8_t          data[16];
+
+    (void)hex_decode("000102030405060708090a0b0c0d0e0f", key);
+    (void)hex_decode("00112233445566778899aabbccddeeff", data);
+
+    check(aes128_init(&ctx, key) == NRF_SUCCESS, "FIPS-197 C.1 init");
+    check(aes128_ecb_encrypt(&ctx, data, data, 1) == NRF_SUCCESS, "FIPS-197 C.1 encrypt call");
+    check_hex(data, "69c4e0d86a7b0430d8cdb78070b4c55a", "FIPS-197 C.1 encrypt");
+    check(aes128_ecb_decrypt(&ctx, data, data, 1) == NRF_SUCCESS, "FIPS-197 C.1 decrypt call");
+    check_hex(data, "00112233445566778899aabbccddeeff", "FIPS-197 C.1 decrypt");
+}
+
+
+static void sp_800_38a_check(void)
+{
+    static char const plaintext[] =
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+    static char const ciphertext[] =
+        "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+        "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+
+    aes128_context_t ctx;
+    uint8_t          key[16];
+    uint8_t          counter[16];
+    uint8_t          data[64];
+
+    (void)hex_decode("2b7e151628aed2a6abf7158809cf4f3c", key);
+    (void)aes128_init(&ctx, key);
+
+    // F.5.1, in one call.
+    (void)hex_decode("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", counter);
+    (void)hex_decode(plaintext, data);
+    check(aes128_ctr_crypt(&ctx, counter, data, data, sizeof(data)) == NRF_SUCCESS,
+          "SP 800-38A F.5.1 call");
+    check_hex(data, ciphertext, "SP 800-38A F.5.1");
+    check_hex(counter, "f0f1f2f3f4f5f6f7f8f9fafbfcfdff03", "SP 800-38A F.5.1 next counter");
+
+    // F.5.2, in two calls: one block, then the rest, which does not end on a block boundary.
+    (void)hex_decode("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", counter);
+    (void)hex_decode(ciphertext, data);
+    (void)aes128_ctr_crypt(&ctx, counter, data, data, 16);
+    (void)aes128_ctr_crypt(&ctx, counter, &data[16], &data[16], 37);
+    check_hex(data, "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df",
+              "SP 800-38A F.5.2 in two calls");
+}
+
+
+static void rfc_3610_check(void)
+{
+    aes128_context_t ctx;
+    uint8_t          key[16];
+    uint8_t          nonce[13];
+    uint8_t          adata[8];
+    uint8_t          data[23];
+    uint8_t          mic[8];
+
+    (void)hex_decode("c0c1c2c3c4c5c6c7c8c9cacbcccdcecf", key);
+    (void)hex_decode("00000003020100a0a1a2a3a4a5", nonce);
+    (void)hex_decode("0001020304050607", adata);
+    (void)hex_decode("08090a0b0c0d0e0f101112131415161718191a1b1c1d1e", data);
+    (void)aes128_init(&ctx, key);
+
+    check(aes128_ccm_encrypt(&ctx, nonce, sizeof(nonce), adata, sizeof(adata),
+                             data, data, sizeof(data), mic, sizeof(mic)) == NRF_SUCCESS,
+          "RFC 3610 #1 encrypt call");
+    check_hex(data, "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384", "RFC 3610 #1 ciphertext");
+    check_hex(mic, "17e8d12cfdf926e0", "RFC 3610 #1 MIC");
+
+    check(aes128_ccm_decrypt(&ctx, nonce, sizeof(nonce), adata, sizeof(adata),
+                             data, data, sizeof(data), mic, sizeof(mic)) == NRF_SUCCESS,
+          "RFC 3610 #1 decrypt call");
+    check_hex(data, "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e", "RFC 3610 #1 decrypt");
+
+    // An altered MIC must be rejected, and the output cleared.
+    (void)aes128_ccm_encrypt(&ctx, nonce, sizeof(nonce), adata, sizeof(adata),
+                             data, data, sizeof(data), mic, sizeof(mic));
+    mic[sizeof(mic) - 1] ^= 0x01;
+    check(aes128_ccm_decrypt(&ctx, nonce, sizeof(nonce), adata, sizeof(adata),
+                             data, data, sizeof(data), mic, sizeof(mic)) == NRF_ERROR_INVALID_DATA,
+          "RFC 3610 #1 altered MIC");
+    check_hex(data, "0000000000000000000000000000000000000000000000",
+              "RFC 3610 #1 output cleared");
+}
+
+
+/**@brief ah(k, r) = e(k, padding || r) mod 2^24. The data is big-endian, as ah() in id_manager
+ *        passes it to the ECB.
+ */
+static void ah_check(void)
+{
+    aes128_context_t ctx;
+    uint8_t          irk[16];
+    uint8_t          data[16] = {0};
+
+    (void)hex_decode("ec0234a357c8ad05341010a60a397d9b", irk);
+    (void)hex_decode("708194", &data[13]);
+    (void)aes128_init(&ctx, irk);
+    (void)aes128_ecb_encrypt(&ctx, data, data, 1);
+
+    check_hex(&data[13], "0dfbaa", "ah() sample");
+}
+
+
+/**@brief Function for checking multi-block ECB calls against single-block calls, and for timing
+ *        them.
+ */
+static void ecb_batch_check(void)
+{
+    static uint8_t   bench[BENCH_BLOCKS * AES128_BLOCK_SIZE];
+    aes128_context_t ctx;
+    uint8_t          key[16];
+    uint8_t          src[BATCH_BLOCKS * AES128_BLOCK_SIZE];
+    uint8_t          batch[BATCH_BLOCKS * AES128_BLOCK_SIZE];
+    uint8_t          single[BATCH_BLOCKS * AES128_BLOCK_SIZE];
+    uint64_t         start;
+    uint32_t         n_blocks;
+    uint32_t         i;
+
+    for (i = 0; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)(i * 31 + 7);
+    }
+    for (i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (uint8_t)(i * 13 + 5);
+    }
+    (void)aes128_init(&ctx, key);
+
+    for (i = 0; i < BATCH_BLOCKS; i++)
+    {
+        (void)aes128_ecb_encrypt(&ctx, &src[i * AES128_BLOCK_SIZE],
+                                 &single[i * AES128_BLOCK_SIZE], 1);
+    }
+
+    for (n_blocks = 2; n_blocks <= BATCH_BLOCKS; n_blocks++)
+    {
+        memset(batch, 0, sizeof(batch));
+        (void)aes128_ecb_encrypt(&ctx, src, batch, n_blocks);
+        check(memcmp(batch, single, n_blocks * AES128_BLOCK_SIZE) == 0, "ECB multi-block encrypt");
+
+        (void)aes128_ecb_decrypt(&ctx, batch, batch, n_blocks);
+        check(memcmp(batch, src, n_blocks * AES128_BLOCK_SIZE) == 0, "ECB multi-block decrypt");
+    }
+
+    start = time_ns();
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {
+        (void)aes128_ecb_encrypt(&ctx, bench, bench, BENCH_BLOCKS);
+    }
+    printf("aes: ECB encryption %.1f ns per block\n",
+           (double)(time_ns() - start) / ((double)BENCH_LOOPS * BENCH_BLOCKS));
+}
+
+
+int main(void)
+{
+    fips_197_check();
+    sp_800_38a_check();
+    rfc_3610_check();
+    ah_check();
+    ecb_batch_check();
+
+    if (m_failures != 0)
+    {
+        printf("aes_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
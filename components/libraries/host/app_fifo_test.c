@@ -0,0 +1,506 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Randomized test of the FIFO library against a reference model, and of the TX path of the
+ *        FIFO based UART library.
+ *
+ * @details For every power of two buffer size from 1 to 256 bytes, random byte, bulk and span
+ *          operations are run on a FIFO whose read and write positions start just below the 32-bit
+ *          wrap. Every result must agree with a reference model. The time of a 100-byte write and
+ *          read is printed.
+ *
+ *          The UART test simulates the driver: app_uart_put starts transmissions, which complete
+ *          at random points, and the FIFO is flushed from time to time, also while a transmission
+ *          is in progress. The bytes handed to the driver must be the bytes put, in order, except
+ *          those which were still queued when the FIFO was flushed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "app_fifo.h"
+#include "app_uart.h"
+
+#define OP_COUNT            200000      /**< Number of operations per buffer size. */
+#define MAX_BUF_SIZE        256         /**< Largest buffer size. */
+#define START_POS           0xFFFFFF80uL/**< Read and write positions at the start of the test. */
+#define BENCH_LEN           100         /**< Number of bytes written and read in the benchmark. */
+#define BENCH_LOOPS         1000000     /**< Number of writes and reads in the benchmark. */
+#define UART_OP_COUNT       1000000     /**< Number of operations of the UART test. */
+#define UART_BUF_SIZE       64          /**< Size of the UART TX and RX buffers. */
+
+/**@brief Reference model of a FIFO. */
+typedef struct
+{
+    uint8_t  data[MAX_BUF_SIZE];
+    uint32_t head;                      /**< Index of the oldest byte. */
+    uint32_t len;                       /**< Number of bytes. */
+    uint32_t size;
+} model_t;
+
+static model_t  m_model;
+static uint32_t m_failures;
+static uint64_t m_rand_state = 88172645463325252ULL;
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+static uint8_t model_byte(uint32_t index)
+{
+    return m_model.data[(m_model.head + index) % m_model.size];
+}
+
+
+static void model_push(uint8_t byte)
+{
+    m_model.data[(m_model.head + m_model.len) % m_model.size] = byte;
+    m_model.len++;
+}
+
+
+static void model_pop(uint32_t len)
+{
+    m_model.head = (m_model.head + len) % m_model.size;
+    m_model.len -= len;
+}
+
+
+/**@brief Function for checking that bytes are the oldest bytes of the model. */
+static void model_check(uint8_t const * p_data, uint32_t len, char const * p_what)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (p_data[i] != model_byte(i))
+        {
+            check(false, p_what, i);
+            return;
+        }
+    }
+}
+
+
+/**@brief Function for running one random operation on the FIFO and the model. */
+static void fifo_op_run(app_fifo_t * p_fifo)
+{
+    uint8_t   data[MAX_BUF_SIZE + 1];
+    uint8_t * p_span;
+    uint32_t  free_len = m_model.size - m_model.len;
+    uint32_t  size;
+    uint32_t  err_code;
+    uint32_t  i;
+
+    switch (rand_get() % 10)
+    {
+        case 0:
+            data[0]  = (uint8_t)rand_get();
+            err_code = app_fifo_put(p_fifo, data[0]);
+            check(err_code == ((free_len > 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM), "put", err_code);
+            if (free_len > 0)
+            {
+                model_push(data[0]);
+            }
+            break;
+
+        case 1:
+            err_code = app_fifo_get(p_fifo, &data[0]);
+            check(err_code == ((m_model.len > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND), "get",
+                  err_code);
+            if (m_model.len > 0)
+            {
+                model_check(data, 1, "get data");
+                model_pop(1);
+            }
+            break;
+
+        case 2:
+            i        = rand_get() % (m_model.size + 1);
+            err_code = app_fifo_peek(p_fifo, (uint16_t)i, &data[0]);
+            check(err_code == ((i < m_model.len) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND), "peek",
+                  err_code);
+            if (i < m_model.len)
+            {
+                check(data[0] == model_byte(i), "peek data", i);
+            }
+            break;
+
+        case 3:
+            // Write, or get the free space if no data is given.
+            size = rand_get() % (m_model.size + 2);
+            for (i = 0; i < size; i++)
+            {
+                data[i] = (uint8_t)rand_get();
+            }
+            if ((rand_get() % 8) == 0)
+            {
+                err_code = app_fifo_write(p_fifo, NULL, &size);
+                check(err_code == ((free_len > 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM), "write size",
+                      err_code);
+                check(size == free_len, "write size", size);
+                break;
+            }
+            err_code = app_fifo_write(p_fifo, data, &size);
+            check(err_code == ((free_len > 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM), "write",
+                  err_code);
+            if (free_len > 0)
+            {
+                check(size <= free_len, "write length", size);
+                for (i = 0; i < size; i++)
+                {
+                    model_push(data[i]);
+                }
+            }
+            break;
+
+        case 4:
+            // Read, or get the number of bytes if no buffer is given.
+            size = rand_get() % (m_model.size + 2);
+            if ((rand_get() % 8) == 0)
+            {
+                err_code = app_fifo_read(p_fifo, NULL, &size);
+                check(err_code == ((m_model.len > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND),
+                      "read size", err_code);
+                check(size == m_model.len, "read size", size);
+                break;
+            }
+            err_code = app_fifo_read(p_fifo, data, &size);
+            check(err_code == ((m_model.len > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND), "read",
+                  err_code);
+            if (m_model.len > 0)
+            {
+                check(size <= m_model.len, "read length", size);
+                model_check(data, size, "read data");
+                model_pop(size);
+            }
+            break;
+
+        case 5:
+            err_code = app_fifo_read_span_get(p_fifo, &p_span, &size);
+            check(err_code == ((m_model.len > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND), "read span",
+                  err_code);
+            if (m_model.len > 0)
+            {
+                check((size > 0) && (size <= m_model.len), "read span length", size);
+                // The span ends at the last byte or at the end of the buffer.
+                check((size == m_model.len) ||
+                      (p_span + size == p_fifo->p_buf + m_model.size), "read span end", size);
+                model_check(p_span, size, "read span data");
+                size = rand_get() % (size + 1);
+                check(app_fifo_read_commit(p_fifo, size) == NRF_SUCCESS, "read commit", size);
+                model_pop(size);
+            }
+            break;
+
+        case 6:
+            err_code = app_fifo_write_span_get(p_fifo, &p_span, &size);
+            check(err_code == ((free_len > 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM), "write span",
+                  err_code);
+            if (free_len > 0)
+            {
+                check((size > 0) && (size <= free_len), "write span length", size);
+                check((size == free_len) ||
+                      (p_span + size == p_fifo->p_buf + m_model.size), "write span end", size);
+                size = rand_get() % (size + 1);
+                for (i = 0; i < size; i++)
+                {
+                    p_span[i] = (uint8_t)rand_get();
+                    model_push(p_span[i]);
+                }
+                check(app_fifo_write_commit(p_fifo, size) == NRF_SUCCESS, "write commit", size);
+            }
+            break;
+
+        case 7:
+            i        = 1 + rand_get() % MAX_BUF_SIZE;
+            err_code = app_fifo_read_chunk_get(p_fifo, &p_span, data, i, &size);
+            check(err_code == ((m_model.len > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND), "chunk",
+                  err_code);
+            if (m_model.len > 0)
+            {
+                check(size == MIN(i, m_model.len), "chunk length", size);
+                model_check(p_span, size, "chunk data");
+                check(app_fifo_read_commit(p_fifo, size) == NRF_SUCCESS, "chunk commit", size);
+                model_pop(size);
+            }
+            break;
+
+        case 8:
+            // Commits larger than the data or the free space are rejected.
+            check(app_fifo_read_commit(p_fifo, m_model.len + 1) == NRF_ERROR_INVALID_LENGTH,
+                  "read commit too long", m_model.len);
+            check(app_fifo_write_commit(p_fifo, free_len + 1) == NRF_ERROR_INVALID_LENGTH,
+                  "write commit too long", free_len);
+            break;
+
+        default:
+            if ((rand_get() % 16) == 0)
+            {
+                check(app_fifo_flush(p_fifo) == NRF_SUCCESS, "flush", 0);
+                model_pop(m_model.len);
+            }
+            break;
+    }
+}
+
+
+static void fifo_test(uint32_t buf_size)
+{
+    static uint8_t buf[MAX_BUF_SIZE];
+    app_fifo_t     fifo;
+    uint32_t       op;
+
+    check(app_fifo_init(&fifo, buf, (uint16_t)buf_size) == NRF_SUCCESS, "init", buf_size);
+    fifo.read_pos  = START_POS;
+    fifo.write_pos = START_POS;
+
+    memset(&m_model, 0, sizeof(m_model));
+    m_model.size = buf_size;
+    m_model.head = START_POS % buf_size;
+
+    for (op = 0; op < OP_COUNT; op++)
+    {
+        fifo_op_run(&fifo);
+    }
+}
+
+
+static void fifo_bench(void)
+{
+    static uint8_t buf[MAX_BUF_SIZE];
+    app_fifo_t     fifo;
+    uint8_t        data[BENCH_LEN];
+    uint64_t       start;
+    uint32_t       size;
+    uint32_t       i;
+
+    memset(data, 0x5A, sizeof(data));
+    (void)app_fifo_init(&fifo, buf, sizeof(buf));
+
+    start = time_ns();
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {
+        size = sizeof(data);
+        (void)app_fifo_write(&fifo, data, &size);
+        size = sizeof(data);
+        (void)app_fifo_read(&fifo, data, &size);
+    }
+    printf("app_fifo: %u-byte write and read %.1f ns\n", (unsigned int)BENCH_LEN,
+           (double)(time_ns() - start) / BENCH_LOOPS);
+}
+
+
+/* Simulated UART driver. A transmission stays in progress until uart_tx_done() is called. */
+static nrf_uart_event_handler_t m_uart_handler;
+static bool                     m_uart_tx_busy;
+static uint8_t                  m_uart_tx_len;
+static uint32_t                 m_uart_tx_bytes;
+static uint32_t                 m_uart_tx_empty_evts;
+
+ret_code_t nrf_drv_uart_init(nrf_drv_uart_config_t const * p_config,
+                             nrf_uart_event_handler_t      event_handler)
+{
+    m_uart_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_uninit(void)
+{
+}
+
+
+/**@brief The bytes handed to the driver must be the oldest bytes of the model, which holds the
+ *        bytes put and not yet handed to the driver. */
+ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, uint8_t length)
+{
+    check(!m_uart_tx_busy, "TX started during a TX", length);
+    check((length > 0) && (length <= m_model.len), "TX length", length);
+
+    length = MIN(length, m_model.len);
+    model_check(p_data, length, "TX data");
+    model_pop(length);
+
+    m_uart_tx_busy   = true;
+    m_uart_tx_len    = length;
+    m_uart_tx_bytes += length;
+
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_drv_uart_tx_in_progress(void)
+{
+    return m_uart_tx_busy;
+}
+
+
+ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length)
+{
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_rx_enable(void)
+{
+}
+
+
+static void uart_tx_done(void)
+{
+    nrf_drv_uart_event_t event;
+
+    memset(&event, 0, sizeof(event));
+    event.type            = NRF_DRV_UART_EVT_TX_DONE;
+    event.data.rxtx.bytes = m_uart_tx_len;
+    m_uart_tx_busy        = false;
+
+    m_uart_handler(&event, NULL);
+}
+
+
+static void uart_evt_handle(app_uart_evt_t * p_event)
+{
+    if (p_event->evt_type == APP_UART_TX_EMPTY)
+    {
+        m_uart_tx_empty_evts++;
+    }
+}
+
+
+static void uart_test(void)
+{
+    static uint8_t         rx_buf[UART_BUF_SIZE];
+    static uint8_t         tx_buf[UART_BUF_SIZE];
+    app_uart_comm_params_t comm_params;
+    app_uart_buffers_t     buffers;
+    uint32_t               queued = 0;
+    uint32_t               put    = 0;
+    uint32_t               flushes = 0;
+    uint32_t               op;
+
+    memset(&comm_params, 0, sizeof(comm_params));
+    buffers.rx_buf      = rx_buf;
+    buffers.rx_buf_size = sizeof(rx_buf);
+    buffers.tx_buf      = tx_buf;
+    buffers.tx_buf_size = sizeof(tx_buf);
+
+    // The model holds the bytes put and not yet handed to the driver.
+    memset(&m_model, 0, sizeof(m_model));
+    m_model.size = UART_BUF_SIZE;
+
+    APP_ERROR_CHECK(app_uart_init(&comm_params, &buffers, uart_evt_handle, APP_IRQ_PRIORITY_LOW));
+
+    for (op = 0; op < UART_OP_COUNT; op++)
+    {
+        uint32_t r = rand_get() % 100;
+
+        if (r < 60)
+        {
+            uint8_t  byte = (uint8_t)rand_get();
+            uint32_t err_code;
+
+            // The FIFO holds the queued bytes and those being transmitted. The byte is added to
+            // the model first, as app_uart_put can start a transmission.
+            queued = m_model.len + (m_uart_tx_busy ? m_uart_tx_len : 0);
+            if (queued < UART_BUF_SIZE)
+            {
+                model_push(byte);
+                put++;
+            }
+
+            err_code = app_uart_put(byte);
+            check(err_code == ((queued < UART_BUF_SIZE) ? NRF_SUCCESS : NRF_ERROR_NO_MEM), "put",
+                  err_code);
+        }
+        else if (r < 99)
+        {
+            if (m_uart_tx_busy)
+            {
+                uart_tx_done();
+            }
+        }
+        else
+        {
+            // The bytes being transmitted are sent anyway, the queued ones are dropped.
+            APP_ERROR_CHECK(app_uart_flush());
+            model_pop(m_model.len);
+            flushes++;
+        }
+    }
+
+    while (m_uart_tx_busy)
+    {
+        uart_tx_done();
+    }
+
+    check(m_model.len == 0, "bytes left in the UART FIFO", m_model.len);
+    check(m_uart_tx_empty_evts > 0, "TX empty events", m_uart_tx_empty_evts);
+
+    printf("app_uart: %u bytes put, %u transmitted, %u flushes, %u TX empty events\n",
+           (unsigned int)put, (unsigned int)m_uart_tx_bytes, (unsigned int)flushes,
+           (unsigned int)m_uart_tx_empty_evts);
+}
+
+
+int main(void)
+{
+    uint32_t buf_size;
+
+    for (buf_size = 1; buf_size <= MAX_BUF_SIZE; buf_size *= 2)
+    {
+        fifo_test(buf_size);
+    }
+    fifo_bench();
+    uart_test();
+
+    if (m_failures != 0)
+    {
+        printf("app_fifo_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,622 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the multi-priority scheduler (app_scheduler_prio.c).
+ *
+ * @details Every event carries a sequence number followed by a pattern derived from it, and the
+ *          handler checks both, along with the priority level and the order of execution.
+ *
+ *          The directed tests check that the highest priority level is always served first, also
+ *          when an event is scheduled from a handler; that an event which is reserved but not
+ *          committed holds back the events reserved after it at its own level only; that cancelled
+ *          events are not executed and give their room back; and that an event which does not fit
+ *          before the end of a queue is placed at its start, both when the skipped bytes are marked
+ *          with a wrap header and when they are too few to hold one. Latencies are measured against
+ *          a simulated RTC1 counter, also across its wrap-around.
+ *
+ *          The random test then fills and partially drains the queues with events of random sizes
+ *          and priority levels, pausing the scheduler from a handler. A queue must accept events as
+ *          long as the bytes in use leave room for them, and QUEUE_SIZE maximum size events must
+ *          fit in an empty queue, whatever the offsets left by the previous events.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "app_scheduler.h"
+#include "nordic_common.h"
+#include "nrf_error.h"
+
+#define EVENT_SIZE          16          /**< Maximum event data size. */
+#define QUEUE_SIZE          4           /**< Number of maximum size events each level can hold. */
+#define HEADER_SIZE         APP_SCHED_EVENT_HEADER_SIZE
+#define ENTRY_MAX           (HEADER_SIZE + EVENT_SIZE)          /**< Largest queue entry. */
+#define QUEUE_BYTES         (ENTRY_MAX * (QUEUE_SIZE + 1))      /**< Size of the queue of a level. */
+#define LOG_SIZE            64          /**< Number of executed events recorded. */
+#define RANDOM_ROUNDS       20000       /**< Number of fill and drain rounds of the random test. */
+#define RTC_COUNTER_MASK    0x00FFFFFF
+#define PENDING_MAX         (QUEUE_BYTES / HEADER_SIZE)         /**< More events than a level can hold. */
+
+STATIC_ASSERT(APP_SCHED_PRIORITY_COUNT == 3);
+
+/**@brief Model of a scheduled event. */
+typedef struct
+{
+    uint32_t seq;
+    uint16_t size;
+    uint8_t  priority;
+} event_model_t;
+
+static NRF_RTC_Type  m_rtc;
+
+static event_model_t m_log[LOG_SIZE];               /**< Events executed by the last app_sched_execute(). */
+static uint32_t      m_log_count;
+static uint32_t      m_seq;                         /**< Sequence number of the next event. */
+static uint32_t      m_pause_after;                 /**< Number of events after which a handler pauses the scheduler, 0 for never. */
+
+static event_model_t m_pending[APP_SCHED_PRIORITY_COUNT][PENDING_MAX];
+static uint32_t      m_pending_head[APP_SCHED_PRIORITY_COUNT];
+static uint32_t      m_pending_count[APP_SCHED_PRIORITY_COUNT];
+static uint32_t      m_pending_bytes[APP_SCHED_PRIORITY_COUNT]; /**< Bytes of the queued events, headers included. */
+static uint32_t      m_executed;
+
+static uint32_t      m_failures;
+static uint32_t      m_rand_state = 2463534242UL;
+
+
+NRF_RTC_Type * host_rtc1_access(void)
+{
+    return &m_rtc;
+}
+
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 17;
+    m_rand_state ^= m_rand_state << 5;
+    return m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t index)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s failed for event %u\n", p_what, (unsigned int)index);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for getting the number of bytes an event of a given size takes in a queue. */
+static uint32_t entry_bytes(uint16_t size)
+{
+    return HEADER_SIZE + CEIL_DIV(size, sizeof(uint32_t)) * sizeof(uint32_t);
+}
+
+
+/**@brief Function for filling the data of an event with its sequence number and pattern. */
+static void event_fill(uint8_t * p_data, uint32_t seq, uint16_t size)
+{
+    uint16_t i;
+
+    memcpy(p_data, &seq, sizeof(seq));
+    for (i = sizeof(seq); i < size; i++)
+    {
+        p_data[i] = (uint8_t)(seq * 7 + i);
+    }
+}
+
+
+/**@brief Function for checking the data of an event and adding it to the log. */
+static void event_log(void * p_event_data, uint16_t event_size, uint8_t priority)
+{
+    uint8_t const * p_data = p_event_data;
+    uint32_t        seq;
+    uint16_t        i;
+
+    check(((uintptr_t)p_event_data % sizeof(uint32_t)) == 0, "event data alignment", m_seq);
+    check(event_size >= sizeof(seq), "event size", m_seq);
+    if (event_size < sizeof(seq))
+    {
+        return;
+    }
+
+    memcpy(&seq, p_data, sizeof(seq));
+    for (i = sizeof(seq); i < event_size; i++)
+    {
+        check(p_data[i] == (uint8_t)(seq * 7 + i), "event data", seq);
+    }
+
+    if (m_log_count < LOG_SIZE)
+    {
+        m_log[m_log_count].seq      = seq;
+        m_log[m_log_count].size     = event_size;
+        m_log[m_log_count].priority = priority;
+    }
+    m_log_count++;
+
+    if ((m_pause_after != 0) && (m_log_count == m_pause_after))
+    {
+        app_sched_pause();
+    }
+}
+
+
+static void handler_prio_0(void * p_event_data, uint16_t event_size)
+{
+    event_log(p_event_data, event_size, 0);
+}
+
+
+static void handler_prio_1(void * p_event_data, uint16_t event_size)
+{
+    event_log(p_event_data, event_size, 1);
+}
+
+
+static void handler_prio_2(void * p_event_data, uint16_t event_size)
+{
+    event_log(p_event_data, event_size, 2);
+}
+
+
+static const app_sched_event_handler_t m_handlers[APP_SCHED_PRIORITY_COUNT] =
+{
+    handler_prio_0, handler_prio_1, handler_prio_2
+};
+
+
+/**@brief Function for scheduling an event with the next sequence number.
+ *
+ * @return The sequence number of the event, or UINT32_MAX if it could not be scheduled.
+ */
+static uint32_t event_put(uint16_t size, uint8_t priority)
+{
+    uint8_t data[EVENT_SIZE];
+
+    event_fill(data, m_seq, size);
+    if (app_sched_event_put_prio(data, size, m_handlers[priority], priority) != NRF_SUCCESS)
+    {
+        return UINT32_MAX;
+    }
+
+    return m_seq++;
+}
+
+
+/**@brief Function for reserving an event with the next sequence number and filling it in place.
+ *
+ * @return Pointer to the event data in the queue.
+ */
+static void * event_reserve(uint16_t size, uint8_t priority)
+{
+    void * p_data = NULL;
+
+    check(app_sched_event_reserve(size, m_handlers[priority], priority, &p_data) == NRF_SUCCESS,
+          "app_sched_event_reserve", m_seq);
+    if (p_data != NULL)
+    {
+        event_fill(p_data, m_seq, size);
+        m_seq++;
+    }
+
+    return p_data;
+}
+
+
+/**@brief Function for executing the scheduled events and checking the order of execution.
+ *
+ * @param[in] p_expected  Expected sequence numbers, in order of execution.
+ * @param[in] count       Number of expected events.
+ */
+static void execute_check(uint32_t const * p_expected, uint32_t count, char const * p_what)
+{
+    uint32_t i;
+
+    m_log_count = 0;
+    app_sched_execute();
+
+    check(m_log_count == count, p_what, m_log_count);
+    for (i = 0; (i < count) && (i < m_log_count); i++)
+    {
+        check(m_log[i].seq == p_expected[i], p_what, p_expected[i]);
+    }
+}
+
+
+static void handler_nested(void * p_event_data, uint16_t event_size)
+{
+    event_log(p_event_data, event_size, 2);
+
+    // Schedule an event at a higher level than the ones still queued.
+    (void)event_put(4, 1);
+}
+
+
+/**@brief Function for testing the order of execution across priority levels. */
+static void priority_test(void)
+{
+    uint32_t seq[8];
+    uint8_t  data[4];
+
+    seq[0] = event_put(8, 2);
+    seq[1] = event_put(4, 1);
+    seq[2] = event_put(12, 0);
+    seq[3] = event_put(4, 2);
+    seq[4] = event_put(16, 0);
+    seq[5] = event_put(4, 1);
+
+    {
+        uint32_t expected[] = {seq[2], seq[4], seq[1], seq[5], seq[0], seq[3]};
+        execute_check(expected, 6, "priority order");
+    }
+    check(m_log[0].priority == 0 && m_log[5].priority == 2, "priority of the handler", seq[0]);
+
+    // An event scheduled from a handler runs before the older events of lower levels.
+    event_fill(data, m_seq, sizeof(data));
+    check(app_sched_event_put_prio(data, sizeof(data), handler_nested, 2) == NRF_SUCCESS,
+          "app_sched_event_put_prio", m_seq);
+    seq[0] = m_seq++;
+    seq[1] = event_put(4, 2);
+    seq[2] = m_seq;                 // Scheduled by handler_nested.
+    {
+        uint32_t expected[] = {seq[0], seq[2], seq[1]};
+        execute_check(expected, 3, "event scheduled from a handler");
+    }
+
+    // app_sched_event_put() uses the lowest level.
+    event_fill(data, m_seq, sizeof(data));
+    check(app_sched_event_put(data, sizeof(data), handler_prio_2) == NRF_SUCCESS,
+          "app_sched_event_put", m_seq);
+    seq[0] = m_seq++;
+    seq[1] = event_put(4, APP_SCHED_PRIORITY_DEFAULT - 1);
+    {
+        uint32_t expected[] = {seq[1], seq[0]};
+        execute_check(expected, 2, "APP_SCHED_PRIORITY_DEFAULT");
+    }
+
+    check(app_sched_event_put_prio(data, sizeof(data), handler_prio_0, APP_SCHED_PRIORITY_COUNT) ==
+          NRF_ERROR_INVALID_PARAM, "invalid priority", 0);
+    check(app_sched_event_put_prio(data, EVENT_SIZE + 1, handler_prio_0, 0) ==
+          NRF_ERROR_INVALID_LENGTH, "oversized event", 0);
+    check(app_sched_event_reserve(4, handler_prio_0, 0, NULL) == NRF_ERROR_NULL,
+          "app_sched_event_reserve without pointer", 0);
+}
+
+
+/**@brief Function for testing the order of reserved, committed and cancelled events. */
+static void reserve_commit_test(void)
+{
+    void   * p_event[4];
+    uint32_t seq[4];
+    uint32_t i;
+
+    // An event which is not committed holds back the ones reserved after it at its level.
+    seq[0]     = m_seq;
+    p_event[0] = event_reserve(8, 1);
+    seq[1]     = m_seq;
+    p_event[1] = event_reserve(16, 1);
+    app_sched_event_commit(p_event[1]);
+    seq[2]     = event_put(4, 1);
+
+    // The other levels are not held back, be they higher or lower.
+    {
+        uint32_t expected[2];
+
+        expected[1] = event_put(4, 2);
+        expected[0] = event_put(4, 0);
+        execute_check(expected, 2, "uncommitted event holds back its level only");
+    }
+
+    app_sched_event_commit(p_event[0]);
+    execute_check(seq, 3, "commit order");
+
+    // Cancelled events are skipped, at the head of the queue and behind a committed event.
+    seq[0]     = m_seq;
+    p_event[0] = event_reserve(4, 0);
+    seq[1]     = m_seq;
+    p_event[1] = event_reserve(12, 0);
+    seq[2]     = m_seq;
+    p_event[2] = event_reserve(16, 0);
+    seq[3]     = m_seq;
+    p_event[3] = event_reserve(4, 0);
+    app_sched_event_cancel(p_event[0]);
+    app_sched_event_commit(p_event[1]);
+    app_sched_event_cancel(p_event[2]);
+    app_sched_event_commit(p_event[3]);
+    {
+        uint32_t expected[] = {seq[1], seq[3]};
+        execute_check(expected, 2, "cancelled events skipped");
+    }
+
+    // A queue which has only held cancelled events has all its room back.
+    for (i = 0; i < QUEUE_SIZE; i++)
+    {
+        p_event[0] = event_reserve(EVENT_SIZE, 1);
+        app_sched_event_cancel(p_event[0]);
+    }
+    execute_check(NULL, 0, "cancelled events not executed");
+    for (i = 0; i < QUEUE_SIZE; i++)
+    {
+        seq[0] = event_put(EVENT_SIZE, 1);
+        check(seq[0] != UINT32_MAX, "room given back by cancelled events", i);
+    }
+    m_log_count = 0;
+    app_sched_execute();
+    check(m_log_count == QUEUE_SIZE, "events after cancelled ones", m_log_count);
+}
+
+
+/**@brief Function for initializing the scheduler, so that every queue is empty at offset 0. */
+static void scheduler_init(void)
+{
+    APP_SCHED_INIT(EVENT_SIZE, QUEUE_SIZE);
+}
+
+
+/**@brief Function for filling an empty queue at offset 0 up to a given write offset.
+ *
+ * @details Every event holds at least a sequence number, and the last one must fill the bytes
+ *          left exactly, so the events are as large as possible while leaving room for it.
+ *
+ * @return  Number of events scheduled.
+ */
+static uint32_t queue_fill_to(uint8_t priority, uint32_t offset)
+{
+    uint32_t const entry_min = entry_bytes(sizeof(uint32_t));
+    uint32_t       count     = 0;
+
+    while (offset > 0)
+    {
+        uint32_t entry = (offset > ENTRY_MAX) ? MIN(ENTRY_MAX, offset - entry_min) : offset;
+
+        check(event_put((uint16_t)(entry - HEADER_SIZE), priority) != UINT32_MAX,
+              "queue filled", count);
+        offset -= entry;
+        count++;
+    }
+
+    return count;
+}
+
+
+/**@brief Function for testing the placement of events which do not fit before the end of a queue.
+ *
+ * @param[in] tail  Number of bytes left before the end of the queue when the event is scheduled.
+ */
+static void wrap_test(uint32_t tail)
+{
+    uint32_t expected[QUEUE_SIZE];
+    uint32_t first;
+    uint32_t count;
+    uint32_t i;
+
+    // Fill the queue up to 'tail' bytes from its end, and execute all but the last event.
+    scheduler_init();
+    first = m_seq;
+    count = queue_fill_to(2, QUEUE_BYTES - tail);
+    m_pause_after = count - 1;
+    m_log_count   = 0;
+    app_sched_execute();
+    app_sched_resume();
+    m_pause_after = 0;
+    check(m_log_count == count - 1, "pause from a handler", count);
+
+    // A maximum size event does not fit in the tail and is placed at the start of the queue.
+    expected[0] = first + count - 1;
+    for (i = 1; i < QUEUE_SIZE; i++)
+    {
+        expected[i] = event_put(EVENT_SIZE, 2);
+        check(expected[i] != UINT32_MAX, "event placed at the start of the queue", i);
+    }
+    execute_check(expected, QUEUE_SIZE, (tail >= HEADER_SIZE) ? "marked wrap" : "unmarked wrap");
+}
+
+
+/**@brief Function for testing the latency measurements. */
+static void latency_test(void)
+{
+    app_sched_prio_stats_t stats_before;
+    app_sched_prio_stats_t stats;
+    uint32_t               seq;
+
+    check(app_sched_prio_stats_get(0, &stats_before) == NRF_SUCCESS, "app_sched_prio_stats_get", 0);
+
+    m_rtc.COUNTER = RTC_COUNTER_MASK - 2;
+    seq = event_put(4, 0);
+    m_rtc.COUNTER = 1000;
+    (void)event_put(4, 0);
+    m_rtc.COUNTER = 1004;
+    app_sched_execute();
+
+    check(app_sched_prio_stats_get(0, &stats) == NRF_SUCCESS, "app_sched_prio_stats_get", seq);
+    check(stats.executed_events == stats_before.executed_events + 2, "executed events", seq);
+    check(stats.total_latency == stats_before.total_latency + 1007 + 4, "total latency", seq);
+    check(stats.max_latency == MAX(stats_before.max_latency, 1007), "latency across the wrap", seq);
+    check(stats.max_bytes_used <= QUEUE_BYTES, "maximum bytes used", stats.max_bytes_used);
+    check(app_sched_prio_stats_get(APP_SCHED_PRIORITY_COUNT, &stats) == NRF_ERROR_INVALID_PARAM,
+          "app_sched_prio_stats_get of an invalid level", 0);
+
+    m_rtc.COUNTER = 0;
+}
+
+
+/**@brief Function for the events of the random test. */
+static void handler_random(void * p_event_data, uint16_t event_size, uint8_t priority)
+{
+    event_model_t * p_expected;
+    uint32_t        seq;
+    uint8_t         lower;
+
+    memcpy(&seq, p_event_data, sizeof(seq));
+    event_log(p_event_data, event_size, priority);
+
+    // No level above this one may have a pending event.
+    for (lower = 0; lower < priority; lower++)
+    {
+        check(m_pending_count[lower] == 0, "higher level served first", seq);
+    }
+
+    check(m_pending_count[priority] > 0, "event executed once", seq);
+    if (m_pending_count[priority] == 0)
+    {
+        return;
+    }
+
+    p_expected = &m_pending[priority][m_pending_head[priority]];
+    check(p_expected->seq == seq, "FIFO order within a level", seq);
+    check(p_expected->size == event_size, "event size", seq);
+
+    m_pending_bytes[priority] -= entry_bytes(p_expected->size);
+    m_pending_head[priority]   = (m_pending_head[priority] + 1) % PENDING_MAX;
+    m_pending_count[priority]--;
+    m_executed++;
+}
+
+
+static void handler_random_0(void * p_event_data, uint16_t event_size)
+{
+    handler_random(p_event_data, event_size, 0);
+}
+
+
+static void handler_random_1(void * p_event_data, uint16_t event_size)
+{
+    handler_random(p_event_data, event_size, 1);
+}
+
+
+static void handler_random_2(void * p_event_data, uint16_t event_size)
+{
+    handler_random(p_event_data, event_size, 2);
+}
+
+
+static const app_sched_event_handler_t m_random_handlers[APP_SCHED_PRIORITY_COUNT] =
+{
+    handler_random_0, handler_random_1, handler_random_2
+};
+
+
+/**@brief Function for filling and partially draining the queues with random events. */
+static void random_test(void)
+{
+    uint32_t round;
+    uint32_t scheduled = 0;
+    uint32_t i;
+
+    for (round = 0; round < RANDOM_ROUNDS; round++)
+    {
+        uint32_t puts = 1 + rand_get() % (2 * QUEUE_SIZE);
+
+        for (i = 0; i < puts; i++)
+        {
+            uint8_t  priority = (uint8_t)(rand_get() % APP_SCHED_PRIORITY_COUNT);
+            uint16_t size     = (uint16_t)(sizeof(uint32_t) +
+                                           rand_get() % (EVENT_SIZE - sizeof(uint32_t) + 1));
+            uint8_t  data[EVENT_SIZE];
+            uint32_t err_code;
+
+            event_fill(data, m_seq, size);
+            err_code = app_sched_event_put_prio(data, size, m_random_handlers[priority], priority);
+
+            if (err_code == NRF_SUCCESS)
+            {
+                uint32_t index = (m_pending_head[priority] + m_pending_count[priority]) %
+                                 PENDING_MAX;
+
+                m_pending[priority][index].seq  = m_seq;
+                m_pending[priority][index].size = size;
+                m_pending_count[priority]++;
+                m_pending_bytes[priority] += entry_bytes(size);
+                scheduled++;
+            }
+            else
+            {
+                // At most the bytes skipped at the end of the queue, before the event and before
+                // the oldest event, are lost.
+                check(err_code == NRF_ERROR_NO_MEM, "app_sched_event_put_prio", m_seq);
+                check(m_pending_bytes[priority] + 2 * ENTRY_MAX + entry_bytes(size) > QUEUE_BYTES,
+                      "queue full", m_seq);
+            }
+            m_seq++;
+        }
+
+        // Execute a random number of the pending events, pausing from the handler.
+        m_log_count   = 0;
+        m_pause_after = rand_get() % (2 * QUEUE_SIZE);
+        app_sched_execute();
+        if (m_pause_after != 0)
+        {
+            app_sched_resume();
+        }
+        m_pause_after = 0;
+
+        // Every level which has been drained must take QUEUE_SIZE maximum size events, whatever
+        // the offset at which the previous events left it.
+        if ((round % 64) == 63)
+        {
+            app_sched_execute();
+            for (i = 0; i < APP_SCHED_PRIORITY_COUNT; i++)
+            {
+                uint32_t j;
+
+                check(m_pending_count[i] == 0, "queue drained", i);
+                for (j = 0; j < QUEUE_SIZE; j++)
+                {
+                    uint8_t data[EVENT_SIZE];
+
+                    event_fill(data, m_seq, EVENT_SIZE);
+                    check(app_sched_event_put_prio(data, EVENT_SIZE, m_handlers[i], (uint8_t)i) ==
+                          NRF_SUCCESS, "QUEUE_SIZE maximum size events in an empty queue", j);
+                    m_seq++;
+                }
+            }
+            app_sched_execute();
+        }
+    }
+
+    app_sched_execute();
+    check(m_executed == scheduled, "every scheduled event executed", m_executed);
+
+    printf("app_scheduler_prio: %u random events of up to %u bytes in %u rounds, %u executed\n",
+           (unsigned int)scheduled, EVENT_SIZE, RANDOM_ROUNDS, (unsigned int)m_executed);
+}
+
+
+int main(void)
+{
+    scheduler_init();
+
+    priority_test();
+    reserve_commit_test();
+    wrap_test(2 * HEADER_SIZE);
+    wrap_test(HEADER_SIZE);
+    wrap_test(sizeof(uint32_t));
+    latency_test();
+    random_test();
+
+    if (m_failures != 0)
+    {
+        printf("app_scheduler_prio_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
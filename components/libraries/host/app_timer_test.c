@@ -0,0 +1,421 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test and benchmark of app_timer.
+ *
+ * @details RTC1 and the NVIC are simulated. The RTC counter advances one tick per loop iteration
+ *          and raises the RTC1 interrupt when it reaches CC[0]. Pending interrupts are executed
+ *          between ticks, at the application low priority, and the time spent in them is
+ *          measured.
+ *
+ *          Each run creates a number of timers, one in four repeated, and starts and stops random
+ *          timers at random times for two wrap-arounds of the 24-bit counter. Single-shot timers
+ *          with an odd index are sometimes restarted from their time-out handler. The test keeps its
+ *          own model of every timer and checks each time-out: the timer must be running, and the
+ *          time-out must not come before the expiry time nor more than MAX_LATENESS ticks after it.
+ *
+ *          The same test is built with the sorted list (app_timer_list_test) and with the pairing
+ *          heap (app_timer_heap_test). Each prints, per number of timers, the largest delay of a
+ *          time-out, the time spent in the interrupt handlers, the number of CC[0] writes and a
+ *          checksum of the time-outs, which should be the same for both backends.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "app_timer.h"
+
+#define MAX_TIMERS          1024        /**< Largest number of timers of a run. */
+#define OP_QUEUE_SIZE       128         /**< Size of the timer operation queues. */
+#define RUN_TICKS           (1UL << 25) /**< Length of a run, two wrap-arounds of the counter. */
+#define RUN_OPS             20000       /**< Number of start and stop operations in a run. */
+#define MAX_LATENESS        3            /**< Largest allowed delay of a time-out, in ticks. */
+#define RTC_COUNTER_MASK    0x00FFFFFF
+
+/**@brief Timer state, as expected by the test. */
+typedef struct
+{
+    bool     running;
+    uint32_t expiry;        /**< Expected expiry time, on the extended tick counter. */
+    uint32_t period;        /**< Period of a repeated timer. */
+} timer_model_t;
+
+void RTC1_IRQHandler(void);
+void SWI0_IRQHandler(void);
+
+static NRF_RTC_Type    m_rtc;
+static bool            m_rtc_running;
+static bool            m_rtc_irq_enabled;
+static bool            m_rtc_irq_pending;
+static bool            m_swi_irq_pending;
+static uint8_t         m_int_priority = APP_IRQ_PRIORITY_THREAD;
+
+static uint32_t        m_ticks;     /**< Extended tick counter, not cleared with the RTC counter. */
+
+static app_timer_t     m_timer_data[MAX_TIMERS];
+static app_timer_id_t  m_timer_ids[MAX_TIMERS];
+static timer_model_t   m_timers[MAX_TIMERS];
+
+static uint32_t        m_timeouts;
+static uint32_t        m_cc_writes;
+static uint64_t        m_irq_ns;
+static uint64_t        m_checksum;
+static int32_t         m_max_lateness;
+static uint32_t        m_failures;
+static uint64_t        m_rand_state = 88172645463325252ULL;
+
+NRF_RTC_Type * host_rtc1_access(void)
+{
+    if (m_rtc.TASKS_CLEAR)
+    {
+        m_rtc.TASKS_CLEAR = 0;
+        m_rtc.COUNTER     = 0;
+    }
+    if (m_rtc.TASKS_START)
+    {
+        m_rtc.TASKS_START = 0;
+        m_rtc_running     = true;
+    }
+    if (m_rtc.TASKS_STOP)
+    {
+        m_rtc.TASKS_STOP = 0;
+        m_rtc_running    = false;
+    }
+
+    return &m_rtc;
+}
+
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+}
+
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == RTC1_IRQn)
+    {
+        m_rtc_irq_enabled = true;
+    }
+}
+
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == RTC1_IRQn)
+    {
+        m_rtc_irq_enabled = false;
+    }
+}
+
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == RTC1_IRQn)
+    {
+        m_rtc_irq_pending = true;
+    }
+    else
+    {
+        m_swi_irq_pending = true;
+    }
+}
+
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == RTC1_IRQn)
+    {
+        m_rtc_irq_pending = false;
+    }
+    else
+    {
+        m_swi_irq_pending = false;
+    }
+}
+
+
+uint8_t current_int_priority_get(void)
+{
+    return m_int_priority;
+}
+
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**@brief Function for executing the pending interrupts, as the NVIC would before returning to
+ *        thread mode.
+ */
+static void irqs_run(void)
+{
+    uint64_t start;
+
+    if (!(m_rtc_irq_pending && m_rtc_irq_enabled) && !m_swi_irq_pending)
+    {
+        return;
+    }
+
+    start = time_ns();
+
+    m_int_priority = APP_IRQ_PRIORITY_LOW;
+    while ((m_rtc_irq_pending && m_rtc_irq_enabled) || m_swi_irq_pending)
+    {
+        uint32_t cc = m_rtc.CC[0];
+
+        if (m_rtc_irq_pending && m_rtc_irq_enabled)
+        {
+            m_rtc_irq_pending = false;
+            RTC1_IRQHandler();
+        }
+        else
+        {
+            m_swi_irq_pending = false;
+            SWI0_IRQHandler();
+        }
+
+        if (m_rtc.CC[0] != cc)
+        {
+            m_cc_writes++;
+        }
+    }
+    m_int_priority = APP_IRQ_PRIORITY_THREAD;
+
+    m_irq_ns += time_ns() - start;
+}
+
+
+/**@brief Function for advancing the simulated RTC by one tick. */
+static void tick(void)
+{
+    (void)host_rtc1_access();
+
+    m_ticks++;
+    if (m_rtc_running)
+    {
+        m_rtc.COUNTER = (m_rtc.COUNTER + 1) & RTC_COUNTER_MASK;
+        if (m_rtc.COUNTER == m_rtc.CC[0])
+        {
+            m_rtc.EVENTS_COMPARE[0] = 1;
+            m_rtc_irq_pending       = true;
+        }
+    }
+}
+
+
+static void check(bool condition, char const * p_what, uintptr_t index)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s: timer %u at tick %u, expected %u\n", p_what, (unsigned int)index,
+                   (unsigned int)m_ticks, (unsigned int)m_timers[index].expiry);
+        }
+        m_failures++;
+    }
+}
+
+
+static void timer_start(uintptr_t index, uint32_t timeout)
+{
+    timer_model_t * p_timer = &m_timers[index];
+
+    APP_ERROR_CHECK(app_timer_start(m_timer_ids[index], timeout, (void *)index));
+
+    // Starting a running timer has no effect.
+    if (!p_timer->running)
+    {
+        p_timer->running = true;
+        p_timer->expiry  = m_ticks + timeout;
+        p_timer->period  = timeout;
+    }
+}
+
+
+/**@brief Function for hashing a time-out. Used for the checksum, which does not depend on the
+ *        order of the time-outs of a tick, and to decide whether to restart a timer, so that both
+ *        backends restart the same timers.
+ */
+static uint32_t timeout_hash(uintptr_t index)
+{
+    uint32_t hash = ((uint32_t)index * 2654435761U) ^ (m_ticks * 40503U);
+
+    return hash ^ (hash >> 15);
+}
+
+
+static void timeout_handler(void * p_context)
+{
+    uintptr_t       index   = (uintptr_t)p_context;
+    timer_model_t * p_timer = &m_timers[index];
+    int32_t         lateness = (int32_t)(m_ticks - p_timer->expiry);
+
+    check(p_timer->running, "time-out of a stopped timer", index);
+    check(lateness >= 0, "early time-out", index);
+    check(lateness <= MAX_LATENESS, "late time-out", index);
+    if (lateness > m_max_lateness)
+    {
+        m_max_lateness = lateness;
+    }
+
+    m_timeouts++;
+    m_checksum += timeout_hash(index);
+
+    if ((index % 4) == 0)
+    {
+        p_timer->expiry += p_timer->period;
+    }
+    else
+    {
+        p_timer->running = false;
+        if (((index % 2) == 1) && ((timeout_hash(index) & 0x100) == 0))
+        {
+            timer_start(index, 5 + (index * 7) % 300);
+        }
+    }
+}
+
+
+/**@brief Function for drawing a time-out, mostly short, sometimes spanning a large part of the
+ *        counter range.
+ */
+static uint32_t timeout_get(void)
+{
+    if ((rand_get() % 16) == 0)
+    {
+        return APP_TIMER_MIN_TIMEOUT_TICKS + rand_get() % (RTC_COUNTER_MASK / 4);
+    }
+
+    return APP_TIMER_MIN_TIMEOUT_TICKS + rand_get() % 2000;
+}
+
+
+/**@brief Function for drawing the period of a repeated timer. */
+static uint32_t period_get(void)
+{
+    return 1000 + rand_get() % 30000;
+}
+
+
+static void run(uint32_t timer_count)
+{
+    uint32_t  op_gap = (RUN_TICKS / RUN_OPS) * 2;
+    uint32_t  next_op;
+    uint32_t  end;
+    uint32_t  ops = 0;
+    uint32_t  i;
+
+    m_timeouts     = 0;
+    m_cc_writes    = 0;
+    m_irq_ns       = 0;
+    m_checksum     = 0;
+    m_max_lateness = 0;
+
+    for (i = 0; i < timer_count; i++)
+    {
+        memset(&m_timer_data[i], 0, sizeof(m_timer_data[i]));
+        memset(&m_timers[i], 0, sizeof(m_timers[i]));
+        m_timer_ids[i] = &m_timer_data[i];
+        APP_ERROR_CHECK(app_timer_create(&m_timer_ids[i],
+                                         ((i % 4) == 0) ? APP_TIMER_MODE_REPEATED
+                                                        : APP_TIMER_MODE_SINGLE_SHOT,
+                                         timeout_handler));
+    }
+
+    end     = m_ticks + RUN_TICKS;
+    next_op = m_ticks + 1;
+    while (m_ticks != end)
+    {
+        tick();
+        irqs_run();
+
+        if (m_ticks == next_op)
+        {
+            uintptr_t index = rand_get() % timer_count;
+
+            if ((rand_get() % 3) != 0)
+            {
+                timer_start(index, ((index % 4) == 0) ? period_get() : timeout_get());
+            }
+            else
+            {
+                APP_ERROR_CHECK(app_timer_stop(m_timer_ids[index]));
+                m_timers[index].running = false;
+            }
+            irqs_run();
+
+            ops++;
+            next_op = m_ticks + 1 + rand_get() % op_gap;
+        }
+    }
+
+    APP_ERROR_CHECK(app_timer_stop_all());
+    irqs_run();
+    for (i = 0; i < timer_count; i++)
+    {
+        m_timers[i].running = false;
+    }
+
+    printf("%-5s %6u %6u %9u %5d %10.0f %9u  %016llx\n",
+#ifdef APP_TIMER_WITH_HEAP
+           "heap",
+#else
+           "list",
+#endif
+           (unsigned int)timer_count, (unsigned int)ops, (unsigned int)m_timeouts, (int)m_max_lateness,
+           (double)m_irq_ns / 1000, (unsigned int)m_cc_writes, (unsigned long long)m_checksum);
+}
+
+
+int main(void)
+{
+    static const uint32_t timer_counts[] = {16, 64, 256, MAX_TIMERS};
+    uint32_t              i;
+
+    APP_TIMER_INIT(0, OP_QUEUE_SIZE, NULL);
+
+    printf("%-5s %6s %6s %9s %5s %10s %9s  %s\n",
+           "", "timers", "ops", "time-outs", "late", "irq us", "CC writes", "checksum");
+    for (i = 0; i < sizeof(timer_counts) / sizeof(timer_counts[0]); i++)
+    {
+        run(timer_counts[i]);
+    }
+
+    if (m_failures != 0)
+    {
+        printf("app_timer_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef FDS_CONFIG_H__
+#define FDS_CONFIG_H__
+
+/**@file
+ *
+ * @brief FDS configuration of the host tests.
+ *
+ * @details Four virtual pages of four physical pages each, so that a few hundred records fit. The size
+ *          of the RAM index, the GC step and the automatic GC threshold can be overridden from the
+ *          command line, to build the same test with and without these features.
+ */
+
+#define FDS_OP_QUEUE_SIZE           (4)
+
+#define FDS_CHUNK_QUEUE_SIZE        (8)
+
+#define FDS_MAX_USERS               (3)
+
+#define FDS_VIRTUAL_PAGES           (4)
+
+#define FDS_VIRTUAL_PAGE_SIZE       (1024)
+
+#ifndef FDS_RAM_INDEX_SIZE
+#define FDS_RAM_INDEX_SIZE          (256)
+#endif
+
+#ifndef FDS_GC_STEP_RECORDS
+#define FDS_GC_STEP_RECORDS         (0)
+#endif
+
+#ifndef FDS_GC_AUTO_THRESHOLD
+#define FDS_GC_AUTO_THRESHOLD       (0)
+#endif
+
+#endif // FDS_CONFIG_H__
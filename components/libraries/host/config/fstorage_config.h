@@ -0,0 +1,35 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef FS_CONFIG_H__
+#define FS_CONFIG_H__
+
+/**@file
+ *
+ * @brief fstorage configuration of the host tests.
+ *
+ * @details The queue is deep enough for stores to be combined. The size of the write-combining
+ *          buffer can be overridden from the command line, to build the same test with and without
+ *          write-combining.
+ */
+
+#define FS_QUEUE_SIZE       (8)
+
+#define FS_OP_MAX_RETRIES   (3)
+
+#define FS_MAX_WRITE_SIZE_WORDS     (256)
+
+#ifndef FS_WRITE_COMBINE_BUFFER_WORDS
+#define FS_WRITE_COMBINE_BUFFER_WORDS   (0)
+#endif
+
+#endif // FS_CONFIG_H__
@@ -0,0 +1,39 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SDK_CONFIG_H__
+#define SDK_CONFIG_H__
+
+/**@file
+ *
+ * @brief SDK configuration of the host tests.
+ *
+ * @details Memory Manager: four block categories, the largest with a fallback target for every
+ *          other one.
+ */
+
+#define MEMORY_MANAGER_SMALL_BLOCK_COUNT    40
+#define MEMORY_MANAGER_SMALL_BLOCK_SIZE     32
+
+#define MEMORY_MANAGER_MEDIUM_BLOCK_COUNT   70
+#define MEMORY_MANAGER_MEDIUM_BLOCK_SIZE    64
+
+#define MEMORY_MANAGER_LARGE_BLOCK_COUNT    20
+#define MEMORY_MANAGER_LARGE_BLOCK_SIZE     256
+
+#define MEMORY_MANAGER_XLARGE_BLOCK_COUNT   8
+#define MEMORY_MANAGER_XLARGE_BLOCK_SIZE    1024
+
+#define MEM_MANAGER_ENABLE_LOGS             0
+#define MEM_MANAGER_DISABLE_API_PARAM_CHECK 0
+
+#endif // SDK_CONFIG_H__
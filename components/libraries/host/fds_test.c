@@ -0,0 +1,629 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test and benchmark of FDS record lookup.
+ *
+ * @details fstorage is replaced by a simulation which queues store and erase operations and
+ *          executes them on a RAM copy of flash when the test pumps the queue, bit-clearing stores
+ *          like the real flash does.
+ *
+ *          Records are written, deleted, updated and removed with their file, then garbage is
+ *          collected. Every record key is then looked up with fds_record_find, and the records
+ *          found are opened and checked against the expected data. fds_record_iterate,
+ *          fds_record_find_in_file and fds_stat must agree with the expected number of records.
+ *
+ *          After every deletion and update, fds_stat must report the records deleted so far as
+ *          dirty. With automatic GC, the operation which brings the dirty records to
+ *          FDS_GC_AUTO_THRESHOLD percent of the space must start GC, and no other one. With GC steps,
+ *          records are written and deleted while GC runs: some of them must complete before GC,
+ *          and a record deleted while GC runs must not be found afterwards.
+ *
+ *          The same test is built with the RAM index (fds_test), without it (fds_scan_test), with
+ *          an index too small for the records (fds_index_overflow_test), with GC steps
+ *          (fds_gc_step_test) and with automatic GC (fds_gc_auto_test). Each prints the time of a
+ *          lookup by key and of a find, open and close sequence.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "fds.h"
+#include "fds_config.h"
+#include "fds_internal_defs.h"
+#include "fstorage.h"
+
+#define RECORD_COUNT        250         /**< Number of records written. */
+#define FILE_COUNT          4           /**< Number of files the records are spread over. */
+#define DELETED_FILE_ID     0x0100      /**< File whose records are removed with fds_file_delete. */
+#define DELETED_FILE_COUNT  10          /**< Number of records in the deleted file. */
+#define UPDATE_FLAG         0x80000000  /**< Set in the data of updated records. */
+#define BENCH_LOOPS         200         /**< Number of times every key is looked up. */
+#define DATA_WORDS          1           /**< Length of the record data, in words. */
+#define GC_YIELD_RECORDS    24          /**< Number of records written, and deleted, while GC runs. */
+#define GC_YIELD_KEY        0x1000      /**< Key of the first record written while GC runs. */
+
+#define FLASH_WORDS         (FDS_VIRTUAL_PAGES * FDS_VIRTUAL_PAGE_SIZE)
+#define FLASH_PAGE_WORDS    256         /**< nRF51 physical page size, in words. */
+#define SIM_QUEUE_SIZE      64
+
+/**@brief fstorage operation waiting in the simulation queue. */
+typedef struct
+{
+    bool             erase;
+    uint32_t       * p_dest;
+    uint32_t const * p_src;
+    uint16_t         length;    /**< Length of a store in words, or number of pages to erase. */
+} sim_op_t;
+
+/* Defined by fds.c. */
+extern fs_config_t fs_config;
+
+static uint32_t m_flash[FLASH_WORDS];
+
+static sim_op_t m_sim_queue[SIM_QUEUE_SIZE];
+static uint32_t m_sim_head;
+static uint32_t m_sim_count;
+
+static uint32_t m_record_ids[RECORD_COUNT];
+static uint32_t m_expected[RECORD_COUNT];   /**< Expected data of each record, 0 if it was deleted. */
+
+static uint32_t m_dirty;                    /**< Number of dirty records expected. */
+static uint32_t m_gc_runs;                  /**< Number of GC runs expected. */
+
+static uint32_t m_gc_events;
+static uint32_t m_write_events;
+static uint32_t m_delete_events;
+static uint32_t m_writes_before_gc;         /**< Write events received before the last GC event. */
+static uint32_t m_deletes_before_gc;        /**< Delete events received before the last GC event. */
+
+static uint32_t m_evt_errors;
+static uint32_t m_failures;
+
+fs_ret_t fs_init(void)
+{
+    fs_config.p_start_addr = m_flash;
+    fs_config.p_end_addr   = m_flash + FLASH_WORDS;
+
+    return FS_SUCCESS;
+}
+
+
+static fs_ret_t sim_op_push(sim_op_t const * p_op)
+{
+    if (m_sim_count == SIM_QUEUE_SIZE)
+    {
+        return FS_ERR_QUEUE_FULL;
+    }
+
+    m_sim_queue[(m_sim_head + m_sim_count) % SIM_QUEUE_SIZE] = *p_op;
+    m_sim_count++;
+
+    return FS_SUCCESS;
+}
+
+
+fs_ret_t fs_store(fs_config_t const * const p_config,
+                  uint32_t    const * const p_dest,
+                  uint32_t    const * const p_src,
+                  uint16_t                  length_words)
+{
+    sim_op_t op = {false, (uint32_t *)p_dest, p_src, length_words};
+
+    return sim_op_push(&op);
+}
+
+
+fs_ret_t fs_erase(fs_config_t const * const p_config,
+                  uint32_t    const * const p_page_addr,
+                  uint16_t                  num_pages)
+{
+    sim_op_t op = {true, (uint32_t *)p_page_addr, NULL, num_pages};
+
+    return sim_op_push(&op);
+}
+
+
+/**@brief Function for executing the oldest queued fstorage operation.
+ *
+ * @return false if no operation was queued.
+ */
+static bool sim_pump_one(void)
+{
+    sim_op_t op;
+    fs_evt_t evt;
+    uint32_t i;
+
+    if (m_sim_count == 0)
+    {
+        return false;
+    }
+
+    op         = m_sim_queue[m_sim_head];
+    m_sim_head = (m_sim_head + 1) % SIM_QUEUE_SIZE;
+    m_sim_count--;
+
+    memset(&evt, 0, sizeof(evt));
+    if (op.erase)
+    {
+        memset(op.p_dest, 0xFF, op.length * FLASH_PAGE_WORDS * sizeof(uint32_t));
+        evt.id               = FS_EVT_ERASE;
+        evt.erase.first_page = (uint16_t)((op.p_dest - m_flash) / FLASH_PAGE_WORDS);
+        evt.erase.last_page  = (uint16_t)(evt.erase.first_page + op.length - 1);
+    }
+    else
+    {
+        for (i = 0; i < op.length; i++)
+        {
+            op.p_dest[i] &= op.p_src[i];
+        }
+        evt.id                 = FS_EVT_STORE;
+        evt.store.p_data       = op.p_dest;
+        evt.store.length_words = op.length;
+    }
+
+    fs_config.callback(&evt, FS_SUCCESS);
+
+    return true;
+}
+
+
+/**@brief Function for executing the queued fstorage operations, including those queued by FDS
+ *        from the completion callbacks.
+ */
+static void sim_pump(void)
+{
+    while (sim_pump_one())
+    {
+    }
+}
+
+
+static void fds_evt_handler(fds_evt_t const * const p_evt)
+{
+    if (p_evt->result != FDS_SUCCESS)
+    {
+        printf("FDS event %d failed: %u\n", p_evt->id, (unsigned int)p_evt->result);
+        m_evt_errors++;
+    }
+
+    switch (p_evt->id)
+    {
+        case FDS_EVT_WRITE:
+            m_write_events++;
+            break;
+
+        case FDS_EVT_DEL_RECORD:
+            m_delete_events++;
+            break;
+
+        case FDS_EVT_GC:
+            m_gc_events++;
+            m_writes_before_gc  = m_write_events;
+            m_deletes_before_gc = m_delete_events;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t index)
+{
+    if (!condition)
+    {
+        printf("%s failed for record %u\n", p_what, (unsigned int)index);
+        m_failures++;
+    }
+}
+
+
+static uint16_t file_id(uint32_t index)
+{
+    return (uint16_t)(1 + (index % FILE_COUNT));
+}
+
+
+static uint16_t record_key(uint32_t index)
+{
+    return (uint16_t)(1 + index);
+}
+
+
+static ret_code_t record_write(fds_record_desc_t * p_desc, uint16_t file, uint16_t key, uint32_t data)
+{
+    fds_record_chunk_t chunk;
+    fds_record_t       record;
+    ret_code_t         err_code;
+
+    chunk.p_data           = &data;
+    chunk.length_words     = 1;
+    record.file_id         = file;
+    record.key             = key;
+    record.data.p_chunks   = &chunk;
+    record.data.num_chunks = 1;
+
+    err_code = fds_record_write(p_desc, &record);
+    sim_pump();
+
+    return err_code;
+}
+
+
+static ret_code_t record_update(fds_record_desc_t * p_desc, uint16_t file, uint16_t key, uint32_t data)
+{
+    fds_record_chunk_t chunk;
+    fds_record_t       record;
+    ret_code_t         err_code;
+
+    chunk.p_data           = &data;
+    chunk.length_words     = 1;
+    record.file_id         = file;
+    record.key             = key;
+    record.data.p_chunks   = &chunk;
+    record.data.num_chunks = 1;
+
+    err_code = fds_record_update(p_desc, &record);
+    sim_pump();
+
+    return err_code;
+}
+
+
+/**@brief Function for checking the number of dirty records after the deletion or update of
+ *        a record, or of a file.
+ *
+ * @param[in] deleted  Number of records deleted by the operation.
+ */
+static void dirty_check(uint32_t deleted, uint32_t index)
+{
+    fds_stat_t stat;
+
+    m_dirty += deleted;
+
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+    if (m_dirty * (FDS_HEADER_SIZE + DATA_WORDS) * 100 >=
+        FDS_GC_AUTO_THRESHOLD * FDS_MAX_PAGES * (FDS_PAGE_SIZE - FDS_PAGE_TAG_SIZE))
+    {
+        // The operation has started GC, which has collected all dirty records.
+        m_gc_runs++;
+        m_dirty = 0;
+    }
+#endif
+
+    check(m_gc_events == m_gc_runs, "automatic GC", index);
+    check(fds_stat(&stat) == FDS_SUCCESS, "fds_stat", index);
+    check(stat.dirty_records == m_dirty, "fds_stat dirty records", index);
+    check(stat.freeable_words == m_dirty * DATA_WORDS, "fds_stat freeable words", index);
+}
+
+
+/**@brief Function for writing, deleting and updating the records, then collecting garbage. */
+static void records_prepare(void)
+{
+    fds_record_desc_t desc;
+    fds_find_token_t  token;
+    uint32_t          i;
+
+    for (i = 0; i < RECORD_COUNT; i++)
+    {
+        m_expected[i] = i + 1;
+        check(record_write(&desc, file_id(i), record_key(i), m_expected[i]) == FDS_SUCCESS,
+              "fds_record_write", i);
+        m_record_ids[i] = desc.record_id;
+    }
+
+    for (i = 0; i < DELETED_FILE_COUNT; i++)
+    {
+        check(record_write(&desc, DELETED_FILE_ID, record_key(i), 0) == FDS_SUCCESS,
+              "fds_record_write", i);
+    }
+
+    for (i = 0; i < RECORD_COUNT; i += 3)
+    {
+        (void)fds_descriptor_from_rec_id(&desc, m_record_ids[i]);
+        check(fds_record_delete(&desc) == FDS_SUCCESS, "fds_record_delete", i);
+        sim_pump();
+        m_expected[i] = 0;
+        dirty_check(1, i);
+    }
+
+    for (i = 1; i < RECORD_COUNT; i += 5)
+    {
+        memset(&token, 0, sizeof(token));
+        if (fds_record_find(file_id(i), record_key(i), &desc, &token) == FDS_SUCCESS)
+        {
+            check(m_expected[i] != 0, "fds_record_find of a deleted record", i);
+            m_expected[i] |= UPDATE_FLAG;
+            check(record_update(&desc, file_id(i), record_key(i), m_expected[i]) == FDS_SUCCESS,
+                  "fds_record_update", i);
+            dirty_check(1, i);
+        }
+    }
+
+    check(fds_file_delete(DELETED_FILE_ID) == FDS_SUCCESS, "fds_file_delete", 0);
+    sim_pump();
+    dirty_check(DELETED_FILE_COUNT, 0);
+
+    check(fds_gc() == FDS_SUCCESS, "fds_gc", 0);
+    sim_pump();
+    m_gc_runs++;
+    m_dirty = 0;
+    check(m_gc_events == m_gc_runs, "fds_gc event", 0);
+}
+
+
+#if (FDS_GC_STEP_RECORDS > 0)
+
+/**@brief Function for writing records and deleting others while GC runs.
+ *
+ * The operations are queued behind GC as soon as there is space in the queue, while the flash
+ * operations are executed one at a time. The records written are then deleted, so that
+ * records_verify() can be run again.
+ */
+static void gc_yield_test(void)
+{
+    static uint32_t           data[GC_YIELD_RECORDS];
+    static fds_record_chunk_t chunks[GC_YIELD_RECORDS];
+
+    fds_record_desc_t  desc;
+    fds_find_token_t   token;
+    fds_flash_record_t flash_record;
+    fds_record_t       record;
+    uint32_t           writes   = 0;
+    uint32_t           deletes  = 0;
+    uint32_t           deleted  = 0;
+    uint32_t           i        = 0;
+    ret_code_t         err_code;
+
+    // Garbage on every page, so that GC copies records on each of them.
+    for (i = 2; i < RECORD_COUNT; i += 7)
+    {
+        memset(&token, 0, sizeof(token));
+        if ((m_expected[i] != 0) &&
+            (fds_record_find(file_id(i), record_key(i), &desc, &token) == FDS_SUCCESS))
+        {
+            check(fds_record_delete(&desc) == FDS_SUCCESS, "fds_record_delete", i);
+            sim_pump();
+            m_expected[i] = 0;
+        }
+    }
+
+    m_write_events  = 0;
+    m_delete_events = 0;
+    check(fds_gc() == FDS_SUCCESS, "fds_gc", 0);
+
+    // Alternate the writes of new records with the deletions of existing ones.
+    i = 0;
+    while ((writes < GC_YIELD_RECORDS) || (deletes < GC_YIELD_RECORDS))
+    {
+        if (writes <= deletes)
+        {
+            data[writes]                = GC_YIELD_KEY + writes;
+            chunks[writes].p_data       = &data[writes];
+            chunks[writes].length_words = DATA_WORDS;
+            record.file_id              = file_id(writes);
+            record.key                  = (uint16_t)(GC_YIELD_KEY + writes);
+            record.data.p_chunks        = &chunks[writes];
+            record.data.num_chunks      = 1;
+
+            err_code = fds_record_write(&desc, &record);
+            writes  += (err_code == FDS_SUCCESS) ? 1 : 0;
+        }
+        else
+        {
+            // Next record which has not been deleted yet.
+            while ((i < RECORD_COUNT) && (m_expected[i] == 0))
+            {
+                i++;
+            }
+            memset(&token, 0, sizeof(token));
+            err_code = fds_record_find(file_id(i), record_key(i), &desc, &token);
+            check(err_code == FDS_SUCCESS, "fds_record_find while GC runs", i);
+
+            err_code = fds_record_delete(&desc);
+            if (err_code == FDS_SUCCESS)
+            {
+                m_expected[i] = 0;
+                deletes++;
+                deleted++;
+            }
+        }
+
+        if (err_code == FDS_ERR_NO_SPACE_IN_QUEUES)
+        {
+            check(sim_pump_one(), "queue full while no flash operation is pending", writes);
+        }
+        else
+        {
+            check(err_code == FDS_SUCCESS, "operation queued while GC runs", writes);
+        }
+    }
+    sim_pump();
+
+    m_gc_runs++;
+    check(m_gc_events == m_gc_runs, "fds_gc event", 0);
+    check(m_writes_before_gc > 0, "writes completed while GC runs", m_writes_before_gc);
+    check(m_deletes_before_gc > 0, "deletions completed while GC runs", m_deletes_before_gc);
+    check(m_delete_events == deleted, "fds_record_delete events", m_delete_events);
+
+    for (i = 0; i < GC_YIELD_RECORDS; i++)
+    {
+        memset(&token, 0, sizeof(token));
+        check(fds_record_find(file_id(i), (uint16_t)(GC_YIELD_KEY + i), &desc, &token) ==
+              FDS_SUCCESS, "fds_record_find of a record written while GC runs", i);
+        check(fds_record_open(&desc, &flash_record) == FDS_SUCCESS, "fds_record_open", i);
+        check(*(uint32_t const *)flash_record.p_data == GC_YIELD_KEY + i, "record data", i);
+        check(fds_record_close(&desc) == FDS_SUCCESS, "fds_record_close", i);
+        check(fds_record_delete(&desc) == FDS_SUCCESS, "fds_record_delete", i);
+        sim_pump();
+    }
+
+    check(fds_gc() == FDS_SUCCESS, "fds_gc", 0);
+    sim_pump();
+    m_gc_runs++;
+}
+
+#endif
+
+
+
+/**@brief Function for checking that every record is found as expected. */
+static void records_verify(void)
+{
+    fds_record_desc_t  desc;
+    fds_find_token_t   token;
+    fds_flash_record_t flash_record;
+    fds_stat_t         stat;
+    uint32_t           valid = 0;
+    uint32_t           found;
+    uint32_t           in_file[FILE_COUNT] = {0};
+    uint32_t           i;
+
+    for (i = 0; i < RECORD_COUNT; i++)
+    {
+        found = 0;
+        memset(&token, 0, sizeof(token));
+        while (fds_record_find(file_id(i), record_key(i), &desc, &token) == FDS_SUCCESS)
+        {
+            found++;
+            check(fds_record_open(&desc, &flash_record) == FDS_SUCCESS, "fds_record_open", i);
+            check(flash_record.p_header->tl.record_key == record_key(i), "record key", i);
+            check(*(uint32_t const *)flash_record.p_data == m_expected[i], "record data", i);
+            check(fds_record_close(&desc) == FDS_SUCCESS, "fds_record_close", i);
+        }
+        check(found == ((m_expected[i] != 0) ? 1 : 0), "fds_record_find count", i);
+
+        if (m_expected[i] != 0)
+        {
+            valid++;
+            in_file[i % FILE_COUNT]++;
+        }
+    }
+
+    found = 0;
+    memset(&token, 0, sizeof(token));
+    while (fds_record_iterate(&desc, &token) == FDS_SUCCESS)
+    {
+        found++;
+    }
+    check(found == valid, "fds_record_iterate count", found);
+
+    for (i = 0; i < FILE_COUNT; i++)
+    {
+        found = 0;
+        memset(&token, 0, sizeof(token));
+        while (fds_record_find_in_file(file_id(i), &desc, &token) == FDS_SUCCESS)
+        {
+            found++;
+        }
+        check(found == in_file[i], "fds_record_find_in_file count", i);
+    }
+
+    memset(&token, 0, sizeof(token));
+    check(fds_record_find_in_file(DELETED_FILE_ID, &desc, &token) == FDS_ERR_NOT_FOUND,
+          "fds_record_find_in_file of a deleted file", 0);
+
+    check(fds_stat(&stat) == FDS_SUCCESS, "fds_stat", 0);
+    check(stat.valid_records == valid, "fds_stat valid records", stat.valid_records);
+    check(stat.dirty_records == 0, "fds_stat dirty records", stat.dirty_records);
+}
+
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static void lookup_bench(void)
+{
+    fds_record_desc_t  desc;
+    fds_find_token_t   token;
+    fds_flash_record_t flash_record;
+    uint64_t           start;
+    uint64_t           find_ns;
+    uint64_t           open_ns;
+    uint32_t           opens = 0;
+    uint32_t           loop;
+    uint32_t           i;
+
+    start = time_ns();
+    for (loop = 0; loop < BENCH_LOOPS; loop++)
+    {
+        for (i = 0; i < RECORD_COUNT; i++)
+        {
+            memset(&token, 0, sizeof(token));
+            (void)fds_record_find_by_key(record_key(i), &desc, &token);
+        }
+    }
+    find_ns = time_ns() - start;
+
+    start = time_ns();
+    for (loop = 0; loop < BENCH_LOOPS; loop++)
+    {
+        for (i = 0; i < RECORD_COUNT; i++)
+        {
+            if (m_expected[i] == 0)
+            {
+                continue;
+            }
+            memset(&token, 0, sizeof(token));
+            (void)fds_record_find(file_id(i), record_key(i), &desc, &token);
+            (void)fds_record_open(&desc, &flash_record);
+            (void)fds_record_close(&desc);
+            opens++;
+        }
+    }
+    open_ns = time_ns() - start;
+
+    printf("FDS_RAM_INDEX_SIZE %3u: find by key %6.0f ns/op, find + open + close %6.0f ns/op\n",
+           (unsigned int)FDS_RAM_INDEX_SIZE,
+           (double)find_ns / (BENCH_LOOPS * RECORD_COUNT),
+           (double)open_ns / opens);
+}
+
+
+int main(void)
+{
+    memset(m_flash, 0xFF, sizeof(m_flash));
+
+    APP_ERROR_CHECK(fds_register(fds_evt_handler));
+    APP_ERROR_CHECK(fds_init());
+    sim_pump();
+
+    records_prepare();
+    records_verify();
+
+#if (FDS_GC_STEP_RECORDS > 0)
+    gc_yield_test();
+    records_verify();
+#endif
+
+    if ((m_failures != 0) || (m_evt_errors != 0))
+    {
+        printf("fds_test: %u checks failed, %u failed events\n",
+               (unsigned int)m_failures, (unsigned int)m_evt_errors);
+        return EXIT_FAILURE;
+    }
+
+    lookup_bench();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,364 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of fstorage write-combining and statistics.
+ *
+ * @details The SoftDevice flash API is replaced by a simulation working on a RAM copy of flash.
+ *          sd_flash_write and sd_flash_page_erase are rejected as busy now and then, as if another
+ *          module had a flash operation pending, and some operations complete with an error, at
+ *          most FS_OP_MAX_RETRIES times in a row so that none times out. Stores clear bits, like
+ *          the real flash does.
+ *
+ *          Random stores are queued, mostly contiguous and short, some longer than
+ *          FS_MAX_WRITE_SIZE_WORDS, with a few page erases in between. Every event must match the
+ *          operation queued, in queue order, and the flash must hold the expected image at the
+ *          end. The statistics of fs_stats_get must agree with the operations and flash writes
+ *          seen by the test.
+ *
+ *          The same test is built without write-combining (fstorage_test) and with it
+ *          (fstorage_combine_test). Each prints the number of flash writes and the average and
+ *          maximum latency of an operation, in steps of the simulation.
+ *
+ *          fs_init assigns flash pages from the end of the code space, at addresses which do not
+ *          exist on the host. The test moves its configuration to the RAM copy of flash after
+ *          fs_init. Page numbers passed to sd_flash_page_erase and reported in erase events are
+ *          the lower 16 bits of the host address divided by the page size.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "fstorage.h"
+#include "fstorage_config.h"
+#include "nrf_error.h"
+#include "nrf_soc.h"
+
+#define OP_COUNT            20000       /**< Number of operations queued. */
+#define FLASH_PAGES         8           /**< Number of flash pages of the test configuration. */
+#define FLASH_PAGE_WORDS    256         /**< nRF51 page size, in words. */
+#define FLASH_WORDS         (FLASH_PAGES * FLASH_PAGE_WORDS)
+#define MAX_STORE_WORDS     300         /**< Maximum length of a store, in words. */
+#define SRC_SLOTS           (FS_QUEUE_SIZE + 1)
+
+/**@brief Operation queued by the test, as expected in its event. */
+typedef struct
+{
+    fs_evt_id_t id;
+    uint32_t    offset;     /**< Offset of a store in flash, in words, or page of an erase. */
+    uint32_t    length;     /**< Length of a store, in words, or number of pages to erase. */
+} expected_op_t;
+
+static void fs_evt_handler(fs_evt_t const * const p_evt, fs_ret_t result);
+
+FS_REGISTER_CFG(fs_config_t m_fs_config) =
+{
+    .callback  = fs_evt_handler,
+    .num_pages = FLASH_PAGES,
+    .priority  = 0xFE,
+};
+
+NRF_FICR_Type host_ficr = {.CODEPAGESIZE = 1024, .CODESIZE = 256};
+NRF_UICR_Type host_uicr = {.NRFFW = {0xFFFFFFFF}};
+
+static NRF_RTC_Type m_rtc1;
+
+static uint32_t m_flash[FLASH_WORDS] __attribute__((aligned(FLASH_PAGE_WORDS * 4)));
+static uint32_t m_expected_flash[FLASH_WORDS];
+static uint32_t m_src[SRC_SLOTS][MAX_STORE_WORDS];
+
+static expected_op_t m_expected[OP_COUNT];
+static uint32_t      m_queued;
+static uint32_t      m_completed;
+
+static bool             m_flash_busy;    /**< A flash operation was started and has not completed. */
+static uint32_t       * m_write_dest;
+static uint32_t const * m_p_write_src;
+static uint32_t         m_write_len;
+static int32_t          m_erase_page;    /**< Page being erased, or -1 during a write. */
+static uint32_t         m_flash_writes;
+static uint32_t         m_words_written;
+static uint32_t         m_busy_count;
+static uint32_t         m_error_count;
+static uint32_t         m_failures;
+static uint64_t         m_rand_state = 88172645463325252ULL;
+
+NRF_RTC_Type * host_rtc1_access(void)
+{
+    return &m_rtc1;
+}
+
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for getting the page number fstorage uses for a page of the RAM flash. */
+static uint16_t page_number_get(uint32_t page)
+{
+    return (uint16_t)((uintptr_t)&m_flash[page * FLASH_PAGE_WORDS] / (FLASH_PAGE_WORDS * 4));
+}
+
+
+uint32_t sd_flash_write(uint32_t * const p_dst, uint32_t const * const p_src, uint32_t size)
+{
+    check(!m_flash_busy, "write while busy", size);
+    check((size > 0) && (size <= FS_MAX_WRITE_SIZE_WORDS), "write size", size);
+    check((p_dst >= m_flash) && (p_dst + size <= &m_flash[FLASH_WORDS]), "write address", size);
+
+    if ((rand_get() % 7) == 0)
+    {
+        m_busy_count++;
+        return NRF_ERROR_BUSY;
+    }
+
+    // The source is read when the write completes, as fstorage must keep it valid until then.
+    m_flash_busy  = true;
+    m_write_dest  = p_dst;
+    m_p_write_src = p_src;
+    m_write_len   = size;
+    m_erase_page  = -1;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_flash_page_erase(uint32_t page_number)
+{
+    check(!m_flash_busy, "erase while busy", page_number);
+
+    if ((rand_get() % 7) == 0)
+    {
+        m_busy_count++;
+        return NRF_ERROR_BUSY;
+    }
+
+    m_flash_busy = true;
+    m_erase_page = (uint16_t)(page_number - page_number_get(0));
+    check(m_erase_page < FLASH_PAGES, "erase address", page_number);
+
+    return NRF_SUCCESS;
+}
+
+
+static void fs_evt_handler(fs_evt_t const * const p_evt, fs_ret_t result)
+{
+    expected_op_t const * p_op = &m_expected[m_completed];
+
+    check(result == FS_SUCCESS, "operation failed", result);
+    check(m_completed < m_queued, "unexpected event", m_completed);
+    check(p_evt->id == p_op->id, "event ID", m_completed);
+
+    if (p_evt->id == FS_EVT_STORE)
+    {
+        check(p_evt->store.p_data == &m_flash[p_op->offset], "store address", m_completed);
+        check(p_evt->store.length_words == p_op->length, "store length", m_completed);
+    }
+    else
+    {
+        check(p_evt->erase.first_page == page_number_get(p_op->offset), "erase first page",
+              m_completed);
+        check(p_evt->erase.last_page == (uint16_t)(page_number_get(p_op->offset) + p_op->length),
+              "erase last page", m_completed);
+    }
+
+    m_completed++;
+}
+
+
+/**@brief Function for completing the pending flash operation, or for ending a flash operation of
+ *        another module after a busy rejection.
+ */
+static void flash_event_send(void)
+{
+    static uint32_t errors_in_row;
+
+    if (!m_flash_busy)
+    {
+        fs_sys_event_handler(NRF_EVT_FLASH_OPERATION_SUCCESS);
+        return;
+    }
+
+    m_flash_busy = false;
+
+    if ((errors_in_row < FS_OP_MAX_RETRIES) && ((rand_get() % 5) == 0))
+    {
+        errors_in_row++;
+        m_error_count++;
+        fs_sys_event_handler(NRF_EVT_FLASH_OPERATION_ERROR);
+        return;
+    }
+
+    errors_in_row = 0;
+
+    if (m_erase_page < 0)
+    {
+        uint32_t i;
+
+        for (i = 0; i < m_write_len; i++)
+        {
+            m_write_dest[i] &= m_p_write_src[i];
+        }
+        m_flash_writes++;
+        m_words_written += m_write_len;
+    }
+    else
+    {
+        memset(&m_flash[m_erase_page * FLASH_PAGE_WORDS], 0xFF, FLASH_PAGE_WORDS * sizeof(uint32_t));
+    }
+
+    fs_sys_event_handler(NRF_EVT_FLASH_OPERATION_SUCCESS);
+}
+
+
+/**@brief Function for queueing a store of random data, or an erase.
+ *
+ * @param[in,out] p_offset  Offset following the previous store, in words.
+ */
+static void op_queue(uint32_t * p_offset)
+{
+    expected_op_t * p_op = &m_expected[m_queued];
+    fs_ret_t        ret;
+    uint32_t        i;
+
+    if ((rand_get() % 200) == 0)
+    {
+        p_op->id     = FS_EVT_ERASE;
+        p_op->offset = rand_get() % FLASH_PAGES;
+        p_op->length = 1 + rand_get() % (FLASH_PAGES - p_op->offset);
+
+        ret = fs_erase(&m_fs_config, &m_flash[p_op->offset * FLASH_PAGE_WORDS], p_op->length);
+        if (ret == FS_SUCCESS)
+        {
+            memset(&m_expected_flash[p_op->offset * FLASH_PAGE_WORDS], 0xFF,
+                   p_op->length * FLASH_PAGE_WORDS * sizeof(uint32_t));
+            m_queued++;
+        }
+    }
+    else
+    {
+        uint32_t * p_src = m_src[m_queued % SRC_SLOTS];
+        uint32_t   r     = rand_get() % 100;
+
+        p_op->id     = FS_EVT_STORE;
+        p_op->length = (r < 80) ? 1 + rand_get() % 8 :
+                       (r < 98) ? 1 + rand_get() % 64 : 1 + rand_get() % MAX_STORE_WORDS;
+        p_op->offset = *p_offset;
+        if ((rand_get() % 4) == 0)
+        {
+            p_op->offset += rand_get() % 8;
+        }
+        if (p_op->offset + p_op->length > FLASH_WORDS)
+        {
+            p_op->offset = 0;
+        }
+
+        for (i = 0; i < p_op->length; i++)
+        {
+            p_src[i] = rand_get() | rand_get();
+        }
+
+        ret = fs_store(&m_fs_config, &m_flash[p_op->offset], p_src, p_op->length);
+        if (ret == FS_SUCCESS)
+        {
+            for (i = 0; i < p_op->length; i++)
+            {
+                m_expected_flash[p_op->offset + i] &= p_src[i];
+            }
+            *p_offset = p_op->offset + p_op->length;
+            m_queued++;
+        }
+    }
+
+    check((ret == FS_SUCCESS) || (ret == FS_ERR_QUEUE_FULL), "unexpected error", ret);
+}
+
+
+int main(void)
+{
+    uint32_t   offset = 0;
+    uint32_t   count;
+    fs_stats_t stats;
+
+    memset(m_flash, 0xFF, sizeof(m_flash));
+    memset(m_expected_flash, 0xFF, sizeof(m_expected_flash));
+
+    check(fs_init() == FS_SUCCESS, "fs_init", 0);
+    m_fs_config.p_start_addr = m_flash;
+    m_fs_config.p_end_addr   = &m_flash[FLASH_WORDS];
+
+    while ((m_queued < OP_COUNT) || (m_completed < m_queued))
+    {
+        m_rtc1.COUNTER++;
+
+        // Operations are queued in bursts, so that several are waiting when a write completes.
+        if ((m_queued < OP_COUNT) && ((rand_get() % 3) != 0))
+        {
+            op_queue(&offset);
+        }
+        else
+        {
+            flash_event_send();
+        }
+    }
+
+    check(fs_queued_op_count_get(&count) == FS_SUCCESS, "fs_queued_op_count_get", 0);
+    check(count == 0, "operations left in the queue", count);
+    check(memcmp(m_flash, m_expected_flash, sizeof(m_flash)) == 0, "flash content", 0);
+
+    check(fs_stats_get(&stats) == FS_SUCCESS, "fs_stats_get", 0);
+    check(stats.ops_completed == m_queued, "ops_completed", stats.ops_completed);
+    check(stats.flash_writes == m_flash_writes, "flash_writes", stats.flash_writes);
+    check(stats.words_written == m_words_written, "words_written", stats.words_written);
+    check(stats.max_latency <= m_rtc1.COUNTER, "max_latency", stats.max_latency);
+    check((uint64_t)stats.max_latency * stats.ops_completed >= stats.total_latency,
+          "total_latency", stats.total_latency);
+#if (FS_WRITE_COMBINE_BUFFER_WORDS == 0)
+    check(stats.ops_combined == 0, "ops_combined", stats.ops_combined);
+#endif
+
+    printf("fstorage (combine buffer %u words): %u operations, %u busy, %u errors\n",
+           (unsigned int)FS_WRITE_COMBINE_BUFFER_WORDS, (unsigned int)m_queued,
+           (unsigned int)m_busy_count, (unsigned int)m_error_count);
+    printf("    %u flash writes, %u combined, %u erases, %u words, latency %.2f average, %u max\n",
+           (unsigned int)stats.flash_writes, (unsigned int)stats.ops_combined,
+           (unsigned int)stats.flash_erases, (unsigned int)stats.words_written,
+           (double)stats.total_latency / stats.ops_completed, (unsigned int)stats.max_latency);
+
+    if (m_failures != 0)
+    {
+        printf("fstorage_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Platform replacement for host (Linux) builds of the libraries.
+ *
+ * @details This file is included in front of every host test source. It defines the include guards
+ *          of the device and platform headers, so that the real headers are skipped, and provides
+ *          the few definitions the libraries take from them.
+ */
+
+#ifndef HOST_PLATFORM_H__
+#define HOST_PLATFORM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/* nrf.h */
+#define NRF_H
+#include "compiler_abstraction.h"
+
+#define __DMB()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __WFE()
+#define __SEV()
+
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (value == 0) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+/* Interrupts and peripherals. Only what the tested libraries use is declared; the functions and
+ * the peripheral access function are defined by the tests which need them. */
+#include "nrf51_bitfields.h"
+
+typedef enum
+{
+    RTC1_IRQn = 17,
+    SWI0_IRQn = 20,
+} IRQn_Type;
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+typedef struct
+{
+    volatile uint32_t TASKS_START;
+    volatile uint32_t TASKS_STOP;
+    volatile uint32_t TASKS_CLEAR;
+    volatile uint32_t TASKS_TRIGOVRFLW;
+    volatile uint32_t EVENTS_TICK;
+    volatile uint32_t EVENTS_OVRFLW;
+    volatile uint32_t EVENTS_COMPARE[4];
+    volatile uint32_t INTENSET;
+    volatile uint32_t INTENCLR;
+    volatile uint32_t EVTEN;
+    volatile uint32_t EVTENSET;
+    volatile uint32_t EVTENCLR;
+    volatile uint32_t COUNTER;
+    volatile uint32_t PRESCALER;
+    volatile uint32_t CC[4];
+} NRF_RTC_Type;
+
+/* Called on every register access, so that the test can carry out the tasks written before. */
+NRF_RTC_Type * host_rtc1_access(void);
+
+#define NRF_RTC1        host_rtc1_access()
+
+typedef struct
+{
+    volatile uint32_t CODEPAGESIZE;
+    volatile uint32_t CODESIZE;
+} NRF_FICR_Type;
+
+typedef struct
+{
+    volatile uint32_t NRFFW[15];
+} NRF_UICR_Type;
+
+extern NRF_FICR_Type host_ficr;
+extern NRF_UICR_Type host_uicr;
+
+#define NRF_FICR        (&host_ficr)
+#define NRF_UICR        (&host_uicr)
+
+/* nrf_delay.h */
+#define _NRF_DELAY_H
+
+#define nrf_delay_us(number_of_us)  ((void)(number_of_us))
+
+/* app_util_platform.h */
+#define APP_UTIL_PLATFORM_H__
+
+#define APP_IRQ_PRIORITY_HIGH       1
+#define APP_IRQ_PRIORITY_LOW        3
+#define APP_IRQ_PRIORITY_THREAD     4
+
+typedef uint8_t app_irq_priority_t;
+
+/* Defined by the tests which need it. */
+uint8_t current_int_priority_get(void);
+
+#define CRITICAL_REGION_ENTER()     {
+#define CRITICAL_REGION_EXIT()      }
+
+#define PACKED(TYPE)                TYPE __attribute__ ((packed))
+
+#define ANON_UNIONS_ENABLE
+#define ANON_UNIONS_DISABLE
+
+/* section_vars.h
+ * Section variables are global, so that a test can reach the variables of the module under test.
+ * The section names are valid C identifiers, so the host linker provides the start and stop
+ * symbols. */
+#define SECTION_VARS_H__
+
+#define NRF_SECTION_VARS_REGISTER_SECTION(section_name)
+#define NRF_SECTION_VARS_REGISTER_SYMBOLS(type_name, section_name)                                  \
+    extern type_name __start_ ## section_name[];                                                   \
+    extern type_name __stop_ ## section_name[]
+#define NRF_SECTION_VARS_ADD(section_name, type_def)                                               \
+    type_def __attribute__ ((section(#section_name))) __attribute__((used))
+#define NRF_SECTION_VARS_START_ADDR(section_name)   (uintptr_t)__start_ ## section_name
+#define NRF_SECTION_VARS_END_ADDR(section_name)     (uintptr_t)__stop_ ## section_name
+#define NRF_SECTION_VARS_GET(i, type_name, section_name)    (&__start_ ## section_name[i])
+#define NRF_SECTION_VARS_COUNT(type_name, section_name)                                            \
+    (uint32_t)(__stop_ ## section_name - __start_ ## section_name)
+
+/* nrf_assert.h */
+#define NRF_ASSERT_H_
+
+#define ASSERT(expr)                assert(expr)
+
+/* app_error.h */
+#define APP_ERROR_H__
+
+#include "sdk_errors.h"
+#include "nordic_common.h"
+
+#define APP_ERROR_CHECK(ERR_CODE)                                                                  \
+    do                                                                                             \
+    {                                                                                              \
+        const uint32_t LOCAL_ERR_CODE = (ERR_CODE);                                                \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS)                                                         \
+        {                                                                                          \
+            printf("%s:%d: error 0x%08x\n", __FILE__, __LINE__, (unsigned int)LOCAL_ERR_CODE);     \
+            abort();                                                                               \
+        }                                                                                          \
+    } while (0)
+
+#define APP_ERROR_CHECK_BOOL(BOOLEAN_VALUE) assert(BOOLEAN_VALUE)
+
+/* nrf_drv_uart.h
+ * The functions are defined by the tests which need them, which send the driver events. */
+#define NRF_DRV_UART_H
+
+typedef enum
+{
+    NRF_DRV_UART_EVT_TX_DONE,
+    NRF_DRV_UART_EVT_RX_DONE,
+    NRF_DRV_UART_EVT_ERROR,
+} nrf_drv_uart_evt_type_t;
+
+typedef enum
+{
+    NRF_UART_HWFC_DISABLED,
+    NRF_UART_HWFC_ENABLED,
+} nrf_uart_hwfc_t;
+
+typedef enum
+{
+    NRF_UART_PARITY_EXCLUDED,
+    NRF_UART_PARITY_INCLUDED,
+} nrf_uart_parity_t;
+
+typedef uint32_t nrf_uart_baudrate_t;
+
+typedef struct
+{
+    uint32_t            pseltxd;
+    uint32_t            pselrxd;
+    uint32_t            pselcts;
+    uint32_t            pselrts;
+    void *              p_context;
+    nrf_uart_hwfc_t     hwfc;
+    nrf_uart_parity_t   parity;
+    nrf_uart_baudrate_t baudrate;
+    uint8_t             interrupt_priority;
+} nrf_drv_uart_config_t;
+
+#define NRF_DRV_UART_DEFAULT_CONFIG {0}
+
+typedef struct
+{
+    uint8_t * p_data;
+    uint8_t   bytes;
+} nrf_drv_uart_xfer_evt_t;
+
+typedef struct
+{
+    nrf_drv_uart_xfer_evt_t rxtx;
+    uint32_t                error_mask;
+} nrf_drv_uart_error_evt_t;
+
+typedef struct
+{
+    nrf_drv_uart_evt_type_t type;
+    union
+    {
+        nrf_drv_uart_xfer_evt_t  rxtx;
+        nrf_drv_uart_error_evt_t error;
+    } data;
+} nrf_drv_uart_event_t;
+
+typedef void (*nrf_uart_event_handler_t)(nrf_drv_uart_event_t * p_event, void * p_context);
+
+ret_code_t nrf_drv_uart_init(nrf_drv_uart_config_t const * p_config,
+                             nrf_uart_event_handler_t      event_handler);
+void       nrf_drv_uart_uninit(void);
+ret_code_t nrf_drv_uart_tx(uint8_t const * const p_data, uint8_t length);
+bool       nrf_drv_uart_tx_in_progress(void);
+ret_code_t nrf_drv_uart_rx(uint8_t * p_data, uint8_t length);
+void       nrf_drv_uart_rx_enable(void);
+
+#endif // HOST_PLATFORM_H__
@@ -0,0 +1,444 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Randomized stress test of the Memory Manager, against the first-fit allocator it replaced.
+ *
+ * @details The test holds up to SLOT_COUNT blocks. Each operation picks a random slot: a held block
+ *          is checked and freed, an empty slot gets a new block of a random size, mostly small.
+ *          The time spent in nrf_mem_reserve and nrf_free is measured.
+ *
+ *          Every operation is also done by the previous allocator of the module, which searches the
+ *          block bitmap linearly from the first block of the fitting category and walks all blocks
+ *          to free one. It is rebuilt below for the block categories of the test configuration.
+ *          Both return the first free block of the smallest fitting category, so they must return
+ *          blocks at the same offset in their pools. The time per call of both is printed.
+ *          A block is filled with its slot number when reserved, and must still hold it when freed,
+ *          so that overlapping blocks are detected. A reserved block must be at least as large as
+ *          requested.
+ *
+ *          Every few operations, a block is freed twice and a pointer into the middle of a held
+ *          block is freed; both must be ignored. The statistics of nrf_mem_stats_get must
+ *          agree with the blocks held by the test, and once everything is freed, every block of
+ *          the pool must be reservable again.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sdk_config.h"
+#include "nordic_common.h"
+#include "app_util.h"
+#include "mem_manager.h"
+
+#define SLOT_COUNT          200         /**< Number of blocks the test can hold. */
+#define OP_COUNT            1000000     /**< Number of operations. */
+#define BAD_FREE_INTERVAL   97          /**< Number of operations between invalid frees. */
+
+#define TOTAL_BLOCK_COUNT   (MEMORY_MANAGER_SMALL_BLOCK_COUNT  + \
+                             MEMORY_MANAGER_MEDIUM_BLOCK_COUNT + \
+                             MEMORY_MANAGER_LARGE_BLOCK_COUNT  + \
+                             MEMORY_MANAGER_XLARGE_BLOCK_COUNT)
+
+#define FF_CAT_COUNT        4           /**< Number of block categories of the test configuration. */
+
+typedef struct
+{
+    uint8_t * p_block;
+    uint8_t * p_ff_block;               /**< Block of the first-fit allocator. */
+    uint32_t  size;
+} slot_t;
+
+static slot_t    m_slots[SLOT_COUNT];
+static uint8_t * m_pool_start;          /**< First block of the Memory Manager. */
+static uint32_t  m_held;
+static uint32_t  m_failures;
+static uint64_t  m_rand_state = 88172645463325252ULL;
+
+/**@brief Block sizes and counts of the first-fit allocator, from the test configuration. */
+static const uint32_t m_ff_block_size[FF_CAT_COUNT] =
+{
+    MEMORY_MANAGER_SMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_MEDIUM_BLOCK_SIZE,
+    MEMORY_MANAGER_LARGE_BLOCK_SIZE,
+    MEMORY_MANAGER_XLARGE_BLOCK_SIZE
+};
+
+static const uint32_t m_ff_block_end[FF_CAT_COUNT] =
+{
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT + MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT + MEMORY_MANAGER_MEDIUM_BLOCK_COUNT +
+    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
+    TOTAL_BLOCK_COUNT
+};
+
+static uint8_t  m_ff_memory[MEMORY_MANAGER_SMALL_BLOCK_COUNT  * MEMORY_MANAGER_SMALL_BLOCK_SIZE  +
+                            MEMORY_MANAGER_MEDIUM_BLOCK_COUNT * MEMORY_MANAGER_MEDIUM_BLOCK_SIZE +
+                            MEMORY_MANAGER_LARGE_BLOCK_COUNT  * MEMORY_MANAGER_LARGE_BLOCK_SIZE  +
+                            MEMORY_MANAGER_XLARGE_BLOCK_COUNT * MEMORY_MANAGER_XLARGE_BLOCK_SIZE];
+static uint32_t m_ff_pool[CEIL_DIV(TOTAL_BLOCK_COUNT, 32)];    /**< Bit set for a free block. */
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for getting the category of the first-fit allocator of the block of size 'size'
+ *        or block number 'block_index', as the Memory Manager did.
+ */
+static uint32_t ff_block_cat_get(uint32_t size, uint32_t block_index)
+{
+    for (uint32_t block_cat = 0; block_cat < FF_CAT_COUNT; block_cat++)
+    {
+        if (((size != 0) && (size <= m_ff_block_size[block_cat])) ||
+            (block_index < m_ff_block_end[block_cat]))
+        {
+            return block_cat;
+        }
+    }
+
+    return 0;
+}
+
+
+static void ff_init(void)
+{
+    for (uint32_t block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    {
+        SET_BIT(m_ff_pool[block_index / 32], block_index % 32);
+    }
+}
+
+
+/**@brief Function for reserving a block with the first-fit allocator.
+ *
+ * @details Blocks are searched one by one from the first block of the category fitting the size,
+ *          getting the size of each block from its category.
+ */
+static uint32_t ff_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
+{
+    const uint32_t block_cat    = ff_block_cat_get(*p_size, TOTAL_BLOCK_COUNT);
+    uint32_t       block_index  = (block_cat == 0) ? 0 : m_ff_block_end[block_cat - 1];
+    uint32_t       memory_index = 0;
+
+    for (uint32_t i = 0; i < block_cat; i++)
+    {
+        memory_index += m_ff_block_size[i] * (m_ff_block_end[i] - ((i == 0) ? 0 : m_ff_block_end[i - 1]));
+    }
+
+    for (; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    {
+        uint32_t block_size = m_ff_block_size[ff_block_cat_get(0, block_index)];
+
+        if (IS_SET(m_ff_pool[block_index / 32], block_index % 32))
+        {
+            CLR_BIT(m_ff_pool[block_index / 32], block_index % 32);
+
+            (*pp_buffer) = &m_ff_memory[memory_index];
+            (*p_size)    = block_size;
+
+            return NRF_SUCCESS;
+        }
+        memory_index += block_size;
+    }
+
+    return (NRF_ERROR_NO_MEM | MEMORY_MANAGER_ERR_BASE);
+}
+
+
+/**@brief Function for freeing a block of the first-fit allocator, walking all blocks to find it. */
+static void ff_free(void * p_mem)
+{
+    uint32_t memory_index = 0;
+
+    for (uint32_t block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    {
+        if (&m_ff_memory[memory_index] == p_mem)
+        {
+            SET_BIT(m_ff_pool[block_index / 32], block_index % 32);
+            break;
+        }
+        memory_index += m_ff_block_size[ff_block_cat_get(0, block_index)];
+    }
+}
+
+
+/**@brief Function for drawing a request size: half up to 32 bytes, most of the rest up to 64 or
+ *        256 bytes, a few up to 1024 bytes.
+ */
+static uint32_t size_get(void)
+{
+    uint32_t r = rand_get() % 100;
+
+    if (r < 50)
+    {
+        return 1 + rand_get() % 32;
+    }
+    if (r < 85)
+    {
+        return 1 + rand_get() % 64;
+    }
+    if (r < 97)
+    {
+        return 1 + rand_get() % 256;
+    }
+
+    return 1 + rand_get() % 1024;
+}
+
+
+static bool pattern_check(slot_t const * p_slot, uint8_t pattern)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_slot->size; i++)
+    {
+        if (p_slot->p_block[i] != pattern)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**@brief Function for freeing a pointer into the middle of a held block, which the Memory Manager
+ *        must ignore.
+ */
+static void interior_free(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < SLOT_COUNT; i++)
+    {
+        slot_t * p_slot = &m_slots[(i + rand_get()) % SLOT_COUNT];
+
+        if ((p_slot->p_block != NULL) && (p_slot->size > 1))
+        {
+            uint32_t offset = 1 + rand_get() % (p_slot->size - 1);
+
+            nrf_free(p_slot->p_block + offset);
+            ff_free(p_slot->p_ff_block + offset);
+            break;
+        }
+    }
+}
+
+
+static void stats_check(void)
+{
+    uint32_t        in_use = 0;
+    uint32_t        cat;
+    nrf_mem_stats_t stats;
+
+    for (cat = 0; cat < NRF_MEM_BLOCK_CAT_COUNT; cat++)
+    {
+        check(nrf_mem_stats_get(cat, &stats) == NRF_SUCCESS, "nrf_mem_stats_get", cat);
+        check(stats.in_use <= stats.max_in_use, "in use above the maximum", cat);
+        check(stats.max_in_use <= stats.block_count, "maximum in use above the block count", cat);
+        in_use += stats.in_use;
+    }
+
+    check(in_use == m_held, "blocks in use", in_use);
+}
+
+
+static void stats_print(void)
+{
+    uint32_t        cat;
+    nrf_mem_stats_t stats;
+
+    printf("%8s %6s %6s %8s %10s %12s %9s %8s\n",
+           "size", "count", "max", "reserves", "req bytes", "fragment %", "fallbacks", "failures");
+    for (cat = 0; cat < NRF_MEM_BLOCK_CAT_COUNT; cat++)
+    {
+        (void)nrf_mem_stats_get(cat, &stats);
+        if (stats.block_count == 0)
+        {
+            continue;
+        }
+        printf("%8u %6u %6u %8u %10u %12.1f %9u %8u\n",
+               (unsigned int)stats.block_size, (unsigned int)stats.block_count,
+               (unsigned int)stats.max_in_use, (unsigned int)stats.reserve_count,
+               (unsigned int)stats.requested_bytes,
+               100.0 * (1.0 - (double)stats.requested_bytes /
+                              ((double)stats.reserve_count * stats.block_size)),
+               (unsigned int)stats.fallback_count, (unsigned int)stats.failure_count);
+    }
+}
+
+
+int main(void)
+{
+    uint64_t  call_ns    = 0;
+    uint64_t  ff_call_ns = 0;
+    uint64_t  start;
+    uint32_t  reserved = 0;
+    uint32_t  rejected = 0;
+    uint32_t  op;
+    uint32_t  i;
+
+    APP_ERROR_CHECK(nrf_mem_init());
+    ff_init();
+
+    {
+        uint32_t size = 1;
+
+        APP_ERROR_CHECK(nrf_mem_reserve(&m_pool_start, &size));
+        nrf_free(m_pool_start);
+    }
+
+    for (op = 0; op < OP_COUNT; op++)
+    {
+        uint32_t  index  = rand_get() % SLOT_COUNT;
+        slot_t  * p_slot = &m_slots[index];
+
+        if (p_slot->p_block != NULL)
+        {
+            check(pattern_check(p_slot, (uint8_t)index), "block overwritten", index);
+
+            start = time_ns();
+            nrf_free(p_slot->p_block);
+            call_ns += time_ns() - start;
+
+            start = time_ns();
+            ff_free(p_slot->p_ff_block);
+            ff_call_ns += time_ns() - start;
+
+            // A double free must be ignored.
+            if ((op % BAD_FREE_INTERVAL) == 0)
+            {
+                nrf_free(p_slot->p_block);
+                ff_free(p_slot->p_ff_block);
+            }
+
+            p_slot->p_block    = NULL;
+            p_slot->p_ff_block = NULL;
+            m_held--;
+        }
+        else
+        {
+            uint32_t  requested  = size_get();
+            uint32_t  size       = requested;
+            uint32_t  ff_size    = requested;
+            uint8_t * p_block    = NULL;
+            uint8_t * p_ff_block = NULL;
+            uint32_t  err_code;
+            uint32_t  ff_err_code;
+
+            start    = time_ns();
+            err_code = nrf_mem_reserve(&p_block, &size);
+            call_ns += time_ns() - start;
+
+            start       = time_ns();
+            ff_err_code = ff_reserve(&p_ff_block, &ff_size);
+            ff_call_ns += time_ns() - start;
+
+            // Both allocators must pick the block at the same offset in the pool.
+            check(ff_err_code == err_code, "first-fit error code", err_code);
+
+            if (err_code == NRF_SUCCESS)
+            {
+                check(size >= requested, "block smaller than requested", requested);
+                check((ff_err_code == NRF_SUCCESS) &&
+                      (ff_size == size) &&
+                      (p_ff_block - m_ff_memory == p_block - m_pool_start),
+                      "first-fit block", (uint32_t)(p_block - m_pool_start));
+                memset(p_block, (uint8_t)index, size);
+                p_slot->p_block    = p_block;
+                p_slot->p_ff_block = p_ff_block;
+                p_slot->size       = size;
+                m_held++;
+                reserved++;
+            }
+            else
+            {
+                check(err_code == (NRF_ERROR_NO_MEM | MEMORY_MANAGER_ERR_BASE),
+                      "unexpected error", err_code);
+                rejected++;
+            }
+        }
+
+        if ((op % BAD_FREE_INTERVAL) == 0)
+        {
+            interior_free();
+            stats_check();
+        }
+    }
+
+    printf("mem_manager: %u operations, %u reserved, %u rejected, "
+           "%.1f ns per call, first-fit %.1f ns per call\n",
+           (unsigned int)OP_COUNT, (unsigned int)reserved, (unsigned int)rejected,
+           (double)call_ns / OP_COUNT, (double)ff_call_ns / OP_COUNT);
+    stats_print();
+
+    for (i = 0; i < SLOT_COUNT; i++)
+    {
+        if (m_slots[i].p_block != NULL)
+        {
+            check(pattern_check(&m_slots[i], (uint8_t)i), "block overwritten", i);
+            nrf_free(m_slots[i].p_block);
+            m_slots[i].p_block = NULL;
+            m_held--;
+        }
+    }
+    stats_check();
+
+    // Every block of the pool must be free again. The smallest requests fall back to every category.
+    for (i = 0; i < TOTAL_BLOCK_COUNT; i++)
+    {
+        uint32_t  size    = 1;
+        uint8_t * p_block = NULL;
+
+        check(nrf_mem_reserve(&p_block, &size) == NRF_SUCCESS, "pool not recovered", i);
+    }
+
+    if (m_failures != 0)
+    {
+        printf("mem_manager_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
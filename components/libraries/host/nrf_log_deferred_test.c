@@ -0,0 +1,486 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Test of the deferred logging mode of nrf_log, with the RTT backend.
+ *
+ * @details The SEGGER RTT functions are replaced by the test, which collects the output of each
+ *          terminal. The log buffer is LOG_BUFFER_SIZE words, so that entries of 2 to 8 words
+ *          often run over its end.
+ *
+ *          A model of the buffer predicts which entries are stored and which are dropped because
+ *          the buffer is full, including an entry which fills the buffer exactly. Every entry
+ *          processed must give the output of the backend for the entry, in the order the entries
+ *          were logged, and the drop count must match the model. The backend output of an entry
+ *          can log a new entry, as an interrupt can, which finds the room of the entry released.
+ *
+ *          Directed runs check the output of each logging macro and the module log level. A random
+ *          run then logs and processes random entries.
+ *
+ *          Strings are stored as 32-bit words, so the test is linked at a fixed address below
+ *          4 GB, and it only logs strings with static storage.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Debug macros of this module generate no code.
+#define NRF_LOG_MODULE_LEVEL NRF_LOG_LEVEL_INFO
+
+#include "nrf_log.h"
+#include "SEGGER_RTT.h"
+
+#define LOG_BUFFER_SIZE     NRF_LOG_DEFERRED_BUFFER_SIZE
+#define TERMINAL_COUNT      2           /**< Normal and error terminals. */
+#define MAX_OUTPUT_LEN      128         /**< Longest output of one entry. */
+#define MODEL_QUEUE_SIZE    LOG_BUFFER_SIZE
+#define STRING_COUNT        7           /**< Number of strings of the string entries. */
+#define RANDOM_ENTRIES      200000      /**< Number of entries logged by the random run. */
+
+/**@brief An entry expected from the module. */
+typedef struct
+{
+    uint32_t terminal;
+    uint32_t words;                     /**< Size of the entry in the buffer. */
+    char     output[MAX_OUTPUT_LEN];
+} model_entry_t;
+
+static char          m_output[TERMINAL_COUNT][MAX_OUTPUT_LEN];
+static uint32_t      m_output_len[TERMINAL_COUNT];
+static model_entry_t m_queue[MODEL_QUEUE_SIZE];
+static uint32_t      m_queue_head;      /**< Index of the oldest entry of the model. */
+static uint32_t      m_queue_count;
+static uint32_t      m_used_words;      /**< Words of the buffer used by the entries of the model. */
+static uint32_t      m_wr;              /**< Index of the next word of the buffer, modulo its size. */
+static uint32_t      m_dropped;
+static uint32_t      m_split_entries;   /**< Entries stored over the end of the buffer. */
+static bool          m_nested_log;      /**< Whether the next output logs an entry. */
+static uint32_t      m_failures;
+static uint64_t      m_rand_state = 88172645463325252ULL;
+
+static char const * const m_strings[STRING_COUNT] =
+{
+    "alpha", "beta ", "gamma", "\r\n", "", "delta epsilon", "z",
+};
+
+// Formats by number of arguments.
+static char const * const m_formats[NRF_LOG_DEFERRED_MAX_ARGS + 1] =
+{
+    "no args\r\n",
+    "%d\r\n",
+    "%u %x\r\n",
+    "%08X-%d-%u\r\n",
+    "%u,%u,%u,%u",
+    "%x %x %x %x %x",
+    "%d %d %u %u %x %X\r\n",
+};
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+static void output_append(unsigned terminal, char const * p_str)
+{
+    check(terminal < TERMINAL_COUNT, "terminal", terminal);
+    if (terminal < TERMINAL_COUNT)
+    {
+        uint32_t len = strlen(p_str);
+
+        check(m_output_len[terminal] + len < MAX_OUTPUT_LEN, "output length", len);
+        if (m_output_len[terminal] + len < MAX_OUTPUT_LEN)
+        {
+            memcpy(&m_output[terminal][m_output_len[terminal]], p_str, len + 1);
+            m_output_len[terminal] += len;
+        }
+    }
+}
+
+
+static void nested_log(void);
+
+
+int SEGGER_RTT_vprintf(unsigned BufferIndex, const char * sFormat, va_list * pParamList)
+{
+    char str[MAX_OUTPUT_LEN];
+
+    (void)vsnprintf(str, sizeof(str), sFormat, *pParamList);
+    output_append(BufferIndex, str);
+    nested_log();
+
+    return strlen(str);
+}
+
+
+unsigned SEGGER_RTT_WriteString(unsigned BufferIndex, const char * s)
+{
+    output_append(BufferIndex, s);
+    nested_log();
+
+    return strlen(s);
+}
+
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char * sName, void * pBuffer,
+                              unsigned BufferSize, unsigned Flags)
+{
+    return 0;
+}
+
+
+int SEGGER_RTT_ConfigDownBuffer(unsigned BufferIndex, const char * sName, void * pBuffer,
+                                unsigned BufferSize, unsigned Flags)
+{
+    return 0;
+}
+
+
+int SEGGER_RTT_HasKey(void)
+{
+    return 0;
+}
+
+
+unsigned SEGGER_RTT_Read(unsigned BufferIndex, void * pBuffer, unsigned BufferSize)
+{
+    return 0;
+}
+
+
+/**@brief Function for adding an entry to the model, or counting it as dropped.
+ *
+ * @param[in] terminal  Terminal of the entry.
+ * @param[in] num_args  Number of argument words of the entry.
+ * @param[in] p_output  Output expected for the entry.
+ *
+ * @retval true   The entry is stored.
+ * @retval false  The entry is dropped.
+ */
+static bool model_push(uint32_t terminal, uint32_t num_args, char const * p_output)
+{
+    uint32_t        words = num_args + 2;
+    model_entry_t * p_entry;
+
+    if ((num_args > NRF_LOG_DEFERRED_MAX_ARGS) || (LOG_BUFFER_SIZE - m_used_words < words))
+    {
+        m_dropped++;
+        return false;
+    }
+
+    if (m_wr + words > LOG_BUFFER_SIZE)
+    {
+        m_split_entries++;
+    }
+    m_wr          = (m_wr + words) % LOG_BUFFER_SIZE;
+    m_used_words += words;
+
+    p_entry           = &m_queue[(m_queue_head + m_queue_count++) % MODEL_QUEUE_SIZE];
+    p_entry->terminal = terminal;
+    p_entry->words    = words;
+    (void)snprintf(p_entry->output, sizeof(p_entry->output), "%s", p_output);
+
+    return true;
+}
+
+
+/**@brief Function for logging a printf entry and adding it to the model.
+ *
+ * @details All arguments are passed to the module, which only reads the number given in the
+ *          header.
+ */
+static void printf_log(uint32_t terminal, uint32_t num_args, uint32_t const * p_args)
+{
+    char const * p_format = m_formats[num_args];
+    char         output[MAX_OUTPUT_LEN];
+
+    (void)snprintf(output, sizeof(output), p_format, p_args[0], p_args[1], p_args[2], p_args[3],
+                   p_args[4], p_args[5]);
+    (void)model_push(terminal, num_args, output);
+
+    log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_PRINTF, terminal, num_args), p_format,
+                      p_args[0], p_args[1], p_args[2], p_args[3], p_args[4], p_args[5]);
+}
+
+
+/**@brief Function for logging a string entry of 1 to NRF_LOG_DEFERRED_MAX_ARGS + 1 strings and
+ *        adding it to the model.
+ */
+static void string_log(uint32_t terminal, uint32_t count, uint32_t const * p_indices)
+{
+    char const * strs[NRF_LOG_DEFERRED_MAX_ARGS + 1];
+    char         output[MAX_OUTPUT_LEN] = "";
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        strs[i] = m_strings[p_indices[i]];
+        strcat(output, strs[i]);
+    }
+    (void)model_push(terminal, count - 1, output);
+
+    log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_STRING, terminal, count - 1), strs[0],
+                      (uint32_t)(uintptr_t)strs[1], (uint32_t)(uintptr_t)strs[2],
+                      (uint32_t)(uintptr_t)strs[3], (uint32_t)(uintptr_t)strs[4],
+                      (uint32_t)(uintptr_t)strs[5], (uint32_t)(uintptr_t)strs[6]);
+}
+
+
+/**@brief Function for logging a random entry and adding it to the model. */
+static void random_log(void)
+{
+    uint32_t terminal = rand_get() % TERMINAL_COUNT;
+    uint32_t values[NRF_LOG_DEFERRED_MAX_ARGS + 1];
+    char     output[MAX_OUTPUT_LEN];
+
+    for (uint32_t i = 0; i < NRF_LOG_DEFERRED_MAX_ARGS + 1; i++)
+    {
+        values[i] = rand_get();
+    }
+
+    switch (rand_get() % 4)
+    {
+        case LOG_DEFERRED_TYPE_PRINTF:
+            printf_log(terminal, rand_get() % (NRF_LOG_DEFERRED_MAX_ARGS + 1), values);
+            break;
+
+        case LOG_DEFERRED_TYPE_STRING:
+            for (uint32_t i = 0; i < NRF_LOG_DEFERRED_MAX_ARGS + 1; i++)
+            {
+                values[i] %= STRING_COUNT;
+            }
+            string_log(terminal, 1 + rand_get() % (NRF_LOG_DEFERRED_MAX_ARGS + 1), values);
+            break;
+
+        case LOG_DEFERRED_TYPE_HEX:
+            (void)snprintf(output, sizeof(output), "0x%08X", (unsigned int)values[0]);
+            (void)model_push(terminal, 1, output);
+            log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_HEX, terminal, 1), NULL,
+                              values[0]);
+            break;
+
+        default:
+            (void)snprintf(output, sizeof(output), "%02X", (unsigned int)(values[0] & 0xFF));
+            (void)model_push(terminal, 1, output);
+            log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_HEX_CHAR, terminal, 1), NULL,
+                              values[0]);
+            break;
+    }
+}
+
+
+/**@brief Function for logging an entry from the output of another, if requested. */
+static void nested_log(void)
+{
+    if (m_nested_log)
+    {
+        m_nested_log = false;
+        random_log();
+    }
+}
+
+
+/**@brief Function for processing the oldest entry and checking its output against the model.
+ *
+ * @retval true   An entry was processed.
+ * @retval false  The buffer is empty.
+ */
+static bool process_check(void)
+{
+    bool          is_expected = (m_queue_count > 0);
+    model_entry_t entry;
+    int           processed;
+
+    memset(m_output, 0, sizeof(m_output));
+    memset(m_output_len, 0, sizeof(m_output_len));
+
+    if (is_expected)
+    {
+        // The room of the entry is released before its output.
+        entry          = m_queue[m_queue_head];
+        m_queue_head   = (m_queue_head + 1) % MODEL_QUEUE_SIZE;
+        m_queue_count--;
+        m_used_words  -= entry.words;
+    }
+
+    processed = NRF_LOG_PROCESS();
+    check(processed == (is_expected ? 1 : 0), "entry processed", processed);
+
+    if (is_expected && processed)
+    {
+        for (uint32_t t = 0; t < TERMINAL_COUNT; t++)
+        {
+            char const * p_expected = (t == entry.terminal) ? entry.output : "";
+
+            if (strcmp(m_output[t], p_expected) != 0)
+            {
+                if (m_failures < 10)
+                {
+                    printf("output \"%s\", expected \"%s\"\n", m_output[t], p_expected);
+                }
+                m_failures++;
+            }
+        }
+    }
+    check(NRF_LOG_DROPPED_COUNT() == m_dropped, "dropped count", NRF_LOG_DROPPED_COUNT());
+
+    return (processed != 0);
+}
+
+
+/**@brief Function for processing all entries. */
+static void process_all(void)
+{
+    while (process_check())
+    {
+    }
+    check(m_queue_count == 0, "entries left", m_queue_count);
+}
+
+
+/**@brief Function for checking the output of the logging macros and the module log level. */
+static void macro_test(void)
+{
+    NRF_LOG_PRINTF("x=%d y=%x\r\n", -5, 0xAB);
+    (void)model_push(LOG_DEFERRED_TERMINAL_NORMAL, 2, "x=-5 y=ab\r\n");
+    NRF_LOG_PRINTF_ERROR("error %u", 7);
+    (void)model_push(LOG_DEFERRED_TERMINAL_ERROR, 1, "error 7");
+    NRF_LOG("one ", "two ", "three");
+    (void)model_push(LOG_DEFERRED_TERMINAL_NORMAL, 2, "one two three");
+    NRF_LOG_ERROR("failed");
+    (void)model_push(LOG_DEFERRED_TERMINAL_ERROR, 0, "failed");
+    NRF_LOG_HEX(0x89ABCDEF);
+    (void)model_push(LOG_DEFERRED_TERMINAL_NORMAL, 1, "0x89ABCDEF");
+    NRF_LOG_HEX_ERROR(0x12);
+    (void)model_push(LOG_DEFERRED_TERMINAL_ERROR, 1, "0x00000012");
+    NRF_LOG_HEX_CHAR(0xAA);
+    (void)model_push(LOG_DEFERRED_TERMINAL_NORMAL, 1, "AA");
+    NRF_LOG_HEX_CHAR_ERROR(0x05);
+    (void)model_push(LOG_DEFERRED_TERMINAL_ERROR, 1, "05");
+
+    // Above the level of the module.
+    NRF_LOG_DEBUG("debug");
+    NRF_LOG_PRINTF_DEBUG("debug %d", 1);
+    NRF_LOG_HEX_DEBUG(1);
+    NRF_LOG_HEX_CHAR_DEBUG(1);
+
+    process_all();
+}
+
+
+/**@brief Function for checking that entries which do not fit are dropped, and that an entry which
+ *        fits exactly is stored.
+ */
+static void overflow_test(void)
+{
+    uint32_t const args[NRF_LOG_DEFERRED_MAX_ARGS] = {1, 2, 3, 4, 5, 6};
+    uint32_t const dropped = m_dropped;
+
+    STATIC_ASSERT(LOG_BUFFER_SIZE % (NRF_LOG_DEFERRED_MAX_ARGS + 2) == 0);
+
+    // Fill the buffer exactly with entries of the largest size.
+    for (uint32_t i = 0; i < LOG_BUFFER_SIZE / (NRF_LOG_DEFERRED_MAX_ARGS + 2); i++)
+    {
+        printf_log(LOG_DEFERRED_TERMINAL_NORMAL, NRF_LOG_DEFERRED_MAX_ARGS, args);
+    }
+    check(m_dropped == dropped, "entry filling the buffer dropped", m_dropped - dropped);
+
+    printf_log(LOG_DEFERRED_TERMINAL_NORMAL, 0, args);
+    check(m_dropped == dropped + 1, "entry not dropped", m_dropped - dropped);
+
+    // Too many arguments.
+    (void)process_check();
+    (void)model_push(LOG_DEFERRED_TERMINAL_NORMAL, NRF_LOG_DEFERRED_MAX_ARGS + 1, "");
+    log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_PRINTF, LOG_DEFERRED_TERMINAL_NORMAL,
+                                          NRF_LOG_DEFERRED_MAX_ARGS + 1), m_formats[0]);
+    check(m_dropped == dropped + 2, "entry with too many arguments not dropped",
+          m_dropped - dropped);
+
+    // Reuse the room of the processed entry.
+    printf_log(LOG_DEFERRED_TERMINAL_ERROR, 1, args);
+    printf_log(LOG_DEFERRED_TERMINAL_ERROR, 1, args);
+    printf_log(LOG_DEFERRED_TERMINAL_ERROR, 1, args);
+    check(m_dropped == dropped + 3, "entry larger than the room not dropped", m_dropped - dropped);
+    printf_log(LOG_DEFERRED_TERMINAL_ERROR, 0, args);
+    check(m_dropped == dropped + 3, "entry filling the room dropped", m_dropped - dropped);
+
+    process_all();
+    check(NRF_LOG_DROPPED_COUNT() == m_dropped, "dropped count", NRF_LOG_DROPPED_COUNT());
+}
+
+
+/**@brief Function for logging and processing random entries, some of them logged from the output
+ *        of others.
+ */
+static void random_test(void)
+{
+    for (uint32_t n = 0; n < RANDOM_ENTRIES; )
+    {
+        uint32_t burst = rand_get() % 8;
+
+        for (uint32_t i = 0; i < burst; i++, n++)
+        {
+            random_log();
+        }
+
+        burst = rand_get() % 8;
+        for (uint32_t i = 0; i < burst; i++)
+        {
+            m_nested_log = ((rand_get() % 8) == 0);
+            (void)process_check();
+            m_nested_log = false;
+        }
+    }
+
+    process_all();
+}
+
+
+int main(void)
+{
+    macro_test();
+    overflow_test();
+    random_test();
+
+    check(m_split_entries > 0, "no entry over the end of the buffer", 0);
+
+    printf("deferred log: %u dropped, %u over the end of the buffer\n", (unsigned int)m_dropped,
+           (unsigned int)m_split_entries);
+
+    if (m_failures != 0)
+    {
+        printf("nrf_log_deferred_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
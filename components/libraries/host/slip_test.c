@@ -0,0 +1,438 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Test of the SLIP library, comparing the per-byte decoder with the bulk decoder.
+ *
+ * @details Streams of random packets, rich in the SLIP special bytes, are encoded by slip_encode
+ *          and by the previous encoder, which sent END ESC_END for an END data byte. Both decoders
+ *          must return the original packets, the bulk decoder being given the stream in chunks of
+ *          random lengths. In streams with corrupted bytes, both decoders must report the same
+ *          errors and return the same packets. The encoding of the special bytes is checked
+ *          against fixed vectors.
+ *
+ *          The time per byte of the encoder and of both decoders is printed, for data with
+ *          uniformly random bytes.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "app_util.h"
+#include "nrf_error.h"
+#include "slip.h"
+
+#define END                 0xC0
+#define ESC                 0xDB
+#define ESC_END             0xDC
+#define ESC_ESC             0xDD
+
+#define PACKET_COUNT        2000        /**< Number of packets of a random stream. */
+#define MAX_PACKET_LEN      300         /**< Largest length of a random packet. */
+#define MAX_STREAM_LEN      (PACKET_COUNT * (2 * MAX_PACKET_LEN + 2))
+#define MAX_CHUNK_LEN       64          /**< Largest chunk given to the bulk decoder. */
+#define STREAM_COUNT        20          /**< Number of random streams of each kind. */
+#define CORRUPT_INTERVAL    500         /**< Average number of bytes between corrupted bytes. */
+#define BENCH_PACKET_LEN    200         /**< Length of the packets of the benchmark. */
+
+/**@brief Packets of a stream, stored one after the other. */
+typedef struct
+{
+    uint8_t  data[PACKET_COUNT * MAX_PACKET_LEN];
+    uint32_t lens[PACKET_COUNT + MAX_STREAM_LEN / 2];
+    uint32_t errors[PACKET_COUNT + MAX_STREAM_LEN / 2];
+    uint32_t count;
+    uint32_t size;
+} packets_t;
+
+static packets_t m_sent;
+static packets_t m_per_byte;
+static packets_t m_bulk;
+static uint8_t   m_stream[MAX_STREAM_LEN];
+static uint32_t  m_failures;
+static uint64_t  m_rand_state = 88172645463325252ULL;
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for adding a packet, or the number of errors before it, to a list. */
+static void packet_add(packets_t * p_packets, uint8_t const * p_data, uint32_t len)
+{
+    memcpy(&p_packets->data[p_packets->size], p_data, len);
+    p_packets->lens[p_packets->count] = len;
+    p_packets->size                  += len;
+    p_packets->count++;
+    p_packets->errors[p_packets->count] = 0;
+}
+
+
+static void packets_clear(packets_t * p_packets)
+{
+    p_packets->count     = 0;
+    p_packets->size      = 0;
+    p_packets->errors[0] = 0;
+}
+
+
+static bool packets_equal(packets_t const * p_a, packets_t const * p_b, bool errors)
+{
+    uint32_t i;
+
+    if ((p_a->count != p_b->count) || (p_a->size != p_b->size) ||
+        (memcmp(p_a->data, p_b->data, p_a->size) != 0))
+    {
+        return false;
+    }
+
+    for (i = 0; i < p_a->count; i++)
+    {
+        if ((p_a->lens[i] != p_b->lens[i]) || (errors && (p_a->errors[i] != p_b->errors[i])))
+        {
+            return false;
+        }
+    }
+
+    return !errors || (p_a->errors[p_a->count] == p_b->errors[p_b->count]);
+}
+
+
+/**@brief Function for encoding a packet as the previous encoder did, with END ESC_END for an END
+ *        data byte.
+ */
+static uint32_t legacy_encode(uint8_t * p_output, uint8_t const * p_input, uint32_t input_length)
+{
+    uint32_t output_index = 0;
+    uint32_t i;
+
+    for (i = 0; i < input_length; i++)
+    {
+        switch (p_input[i])
+        {
+            case END:
+                p_output[output_index++] = END;
+                p_output[output_index++] = ESC_END;
+                break;
+
+            case ESC:
+                p_output[output_index++] = ESC;
+                p_output[output_index++] = ESC_ESC;
+                break;
+
+            default:
+                p_output[output_index++] = p_input[i];
+                break;
+        }
+    }
+    p_output[output_index++] = END;
+    p_output[output_index++] = END;
+
+    return output_index;
+}
+
+
+/**@brief Function for generating random packets, a quarter of whose bytes are special bytes, and
+ *        encoding them into m_stream.
+ *
+ * @return Length of the stream.
+ */
+static uint32_t stream_generate(bool legacy)
+{
+    static uint8_t const special[] = {END, ESC, ESC_END, ESC_ESC};
+    uint8_t              packet[MAX_PACKET_LEN];
+    uint32_t             stream_len = 0;
+    uint32_t             i;
+    uint32_t             j;
+
+    packets_clear(&m_sent);
+
+    for (i = 0; i < PACKET_COUNT; i++)
+    {
+        uint32_t len = 1 + rand_get() % MAX_PACKET_LEN;
+        uint32_t encoded_len;
+
+        for (j = 0; j < len; j++)
+        {
+            packet[j] = ((rand_get() % 4) == 0) ? special[rand_get() % sizeof(special)] :
+                                                  (uint8_t)rand_get();
+        }
+        packet_add(&m_sent, packet, len);
+
+        if (legacy)
+        {
+            encoded_len = legacy_encode(&m_stream[stream_len], packet, len);
+        }
+        else
+        {
+            encoded_len = slip_encode(&m_stream[stream_len], packet, len,
+                                      MAX_STREAM_LEN - stream_len);
+            check(encoded_len >= len + 2, "encoded length", encoded_len);
+
+            // END bytes only end the packet.
+            check(memchr(&m_stream[stream_len], END, encoded_len - 2) == NULL, "END in packet", i);
+        }
+        stream_len += encoded_len;
+    }
+
+    return stream_len;
+}
+
+
+/**@brief Function for decoding a stream with slip_decoding_add_char. Empty packets are skipped,
+ *        as the bulk decoder does.
+ */
+static void per_byte_decode(uint8_t const * p_stream, uint32_t stream_len, packets_t * p_packets)
+{
+    static uint8_t buf[MAX_STREAM_LEN];
+    buffer_t       buffer = {buf, 0, 0, sizeof(buf)};
+    slip_state_t   state  = SLIP_DECODING;
+    uint32_t       i;
+
+    packets_clear(p_packets);
+
+    for (i = 0; i < stream_len; i++)
+    {
+        uint32_t err_code = slip_decoding_add_char(p_stream[i], &buffer, &state);
+
+        if (err_code == NRF_SUCCESS)
+        {
+            if (buffer.current_index > 0)
+            {
+                packet_add(p_packets, buf, buffer.current_index);
+            }
+            buffer.current_index  = 0;
+            buffer.current_length = 0;
+        }
+        else if (err_code != NRF_ERROR_BUSY)
+        {
+            check(err_code == NRF_ERROR_INVALID_DATA, "per-byte error", err_code);
+            p_packets->errors[p_packets->count]++;
+        }
+    }
+}
+
+
+/**@brief Function for decoding a stream with slip_decode_bulk, in chunks of random lengths, or of
+ *        max_chunk_len bytes if fixed_chunks is set.
+ */
+static void bulk_decode(uint8_t const * p_stream,
+                        uint32_t        stream_len,
+                        uint32_t        max_chunk_len,
+                        bool            fixed_chunks,
+                        packets_t     * p_packets)
+{
+    static uint8_t buf[MAX_STREAM_LEN];
+    buffer_t       buffer = {buf, 0, 0, sizeof(buf)};
+    slip_state_t   state  = SLIP_DECODING;
+    uint32_t       index  = 0;
+
+    packets_clear(p_packets);
+
+    while (index < stream_len)
+    {
+        uint32_t chunk_len = fixed_chunks ? max_chunk_len : 1 + rand_get() % max_chunk_len;
+        uint32_t used;
+
+        chunk_len = MIN(chunk_len, stream_len - index);
+
+        // The chunk is given again from the first unused byte until it has been processed.
+        while (chunk_len > 0)
+        {
+            uint32_t err_code = slip_decode_bulk(&p_stream[index], chunk_len, &used, &buffer,
+                                                 &state);
+
+            check((used > 0) && (used <= chunk_len), "bulk input used", used);
+            index     += used;
+            chunk_len -= used;
+
+            if (err_code == NRF_SUCCESS)
+            {
+                check(buffer.current_index > 0, "bulk empty packet", index);
+                packet_add(p_packets, buf, buffer.current_index);
+                buffer.current_index  = 0;
+                buffer.current_length = 0;
+            }
+            else if (err_code != NRF_ERROR_BUSY)
+            {
+                check(err_code == NRF_ERROR_INVALID_DATA, "bulk error", err_code);
+                p_packets->errors[p_packets->count]++;
+            }
+        }
+    }
+}
+
+
+/**@brief Function for checking the encoding of the special bytes, and the decoding of the END data
+ *        byte sent by the previous encoder.
+ */
+static void vectors_check(void)
+{
+    static uint8_t const packet[]  = {0x01, END, ESC, 0x02, ESC_END, ESC_ESC};
+    static uint8_t const encoded[] = {0x01, ESC, ESC_END, ESC, ESC_ESC, 0x02, ESC_END, ESC_ESC,
+                                      END, END};
+    static uint8_t const legacy[]  = {0x01, END, ESC_END, ESC, ESC_ESC, 0x02, ESC_END, ESC_ESC,
+                                      END, END};
+    uint8_t              output[sizeof(encoded)];
+
+    check(slip_encode(output, (uint8_t *)packet, sizeof(packet), sizeof(output)) == sizeof(encoded),
+          "encode vector length", 0);
+    check(memcmp(output, encoded, sizeof(encoded)) == 0, "encode vector", 0);
+
+    // The output buffer must hold the whole encoded packet.
+    check(slip_encode(output, (uint8_t *)packet, sizeof(packet), sizeof(output) - 1) == 0,
+          "encode into a short buffer", 0);
+
+    packets_clear(&m_sent);
+    packet_add(&m_sent, packet, sizeof(packet));
+
+    per_byte_decode(encoded, sizeof(encoded), &m_per_byte);
+    check(packets_equal(&m_per_byte, &m_sent, true), "per-byte decode vector", 0);
+    bulk_decode(encoded, sizeof(encoded), sizeof(encoded), true, &m_bulk);
+    check(packets_equal(&m_bulk, &m_sent, true), "bulk decode vector", 0);
+
+    per_byte_decode(legacy, sizeof(legacy), &m_per_byte);
+    check(packets_equal(&m_per_byte, &m_sent, true), "per-byte decode legacy vector", 0);
+    bulk_decode(legacy, sizeof(legacy), sizeof(legacy), true, &m_bulk);
+    check(packets_equal(&m_bulk, &m_sent, true), "bulk decode legacy vector", 0);
+}
+
+
+static void streams_check(void)
+{
+    uint32_t errors = 0;
+    uint32_t i;
+
+    for (i = 0; i < STREAM_COUNT; i++)
+    {
+        bool     legacy     = ((i % 2) == 1);
+        uint32_t stream_len = stream_generate(legacy);
+        uint32_t j;
+
+        per_byte_decode(m_stream, stream_len, &m_per_byte);
+        check(packets_equal(&m_per_byte, &m_sent, true), "per-byte decode", i);
+        bulk_decode(m_stream, stream_len, MAX_CHUNK_LEN, false, &m_bulk);
+        check(packets_equal(&m_bulk, &m_sent, true), "bulk decode", i);
+
+        // Corrupted streams: an ESC followed by an invalid byte, or any byte replaced.
+        for (j = rand_get() % CORRUPT_INTERVAL; j + 1 < stream_len; j += 1 + rand_get() % CORRUPT_INTERVAL)
+        {
+            if ((rand_get() % 2) == 0)
+            {
+                m_stream[j]     = ESC;
+                m_stream[j + 1] = (uint8_t)rand_get();
+            }
+            else
+            {
+                m_stream[j] = (uint8_t)rand_get();
+            }
+        }
+
+        per_byte_decode(m_stream, stream_len, &m_per_byte);
+        bulk_decode(m_stream, stream_len, MAX_CHUNK_LEN, false, &m_bulk);
+        check(packets_equal(&m_bulk, &m_per_byte, true), "decoders differ on corrupted data", i);
+
+        for (j = 0; j <= m_bulk.count; j++)
+        {
+            errors += m_bulk.errors[j];
+        }
+    }
+
+    check(errors > 0, "no invalid packets", errors);
+}
+
+
+static void bench(void)
+{
+    static uint8_t packet[BENCH_PACKET_LEN];
+    uint32_t       stream_len = 0;
+    uint64_t       start;
+    uint64_t       encode_ns;
+    uint64_t       per_byte_ns;
+    uint64_t       bulk_ns;
+    uint32_t       i;
+    uint32_t       j;
+
+    start = time_ns();
+    for (i = 0; i < PACKET_COUNT; i++)
+    {
+        for (j = 0; j < sizeof(packet); j++)
+        {
+            packet[j] = (uint8_t)rand_get();
+        }
+        stream_len += slip_encode(&m_stream[stream_len], packet, sizeof(packet),
+                                  MAX_STREAM_LEN - stream_len);
+    }
+    encode_ns = time_ns() - start;
+
+    start = time_ns();
+    per_byte_decode(m_stream, stream_len, &m_per_byte);
+    per_byte_ns = time_ns() - start;
+
+    start = time_ns();
+    bulk_decode(m_stream, stream_len, 256, true, &m_bulk);
+    bulk_ns = time_ns() - start;
+
+    check(packets_equal(&m_bulk, &m_per_byte, true), "benchmark decoders differ", 0);
+
+    printf("slip: per byte, encode %.2f ns, per-byte decode %.2f ns, bulk decode %.2f ns\n",
+           (double)encode_ns / stream_len, (double)per_byte_ns / stream_len,
+           (double)bulk_ns / stream_len);
+}
+
+
+int main(void)
+{
+    vectors_check();
+    streams_check();
+    bench();
+
+    if (m_failures != 0)
+    {
+        printf("slip_test: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
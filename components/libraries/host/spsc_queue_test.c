@@ -0,0 +1,217 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of app_spsc_queue and of the lock-free app_mailbox backend.
+ *
+ * @details A producer thread and a consumer thread pass records through a queue whose buffer size
+ *          is not a power of two, so that records wrap at every possible offset. Every record is
+ *          checked for length and content on the consumer side. The same is done for a mailbox
+ *          built with APP_MAILBOX_LOCK_FREE. __DMB() is mapped to a full fence by host_platform.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "app_spsc_queue.h"
+#include "app_mailbox.h"
+#include "nrf_error.h"
+
+#define RECORD_COUNT        200000  /**< Number of records passed through the queue. */
+#define RECORD_MAX_LEN      40      /**< Maximum length of a record. */
+#define MAILBOX_ITEM_COUNT  50000   /**< Number of items passed through the mailbox. */
+#define MAILBOX_QUEUE_SIZE  7       /**< Number of items the mailbox can hold. */
+
+static app_spsc_queue_t m_queue;
+static uint32_t         m_queue_buf[61];        /**< 244 bytes, not a power of two. */
+
+APP_MAILBOX_DEF(m_mailbox, MAILBOX_QUEUE_SIZE, 3 * sizeof(uint32_t));
+
+static uint32_t random_get(uint32_t * p_state)
+{
+    *p_state ^= *p_state << 13;
+    *p_state ^= *p_state >> 17;
+    *p_state ^= *p_state << 5;
+    return *p_state;
+}
+
+static void record_fill(uint8_t * p_data, uint32_t seq, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        p_data[i] = (uint8_t)(seq * 31 + i);
+    }
+}
+
+static void * queue_producer(void * p_context)
+{
+    uint8_t  data[RECORD_MAX_LEN];
+    uint32_t state = 1;
+
+    for (uint32_t i = 0; i < RECORD_COUNT; )
+    {
+        uint32_t saved_state = state;
+        uint16_t len         = random_get(&state) % (RECORD_MAX_LEN + 1);
+
+        record_fill(data, i, len);
+        if (app_spsc_queue_put(&m_queue, data, len) == NRF_SUCCESS)
+        {
+            i++;
+        }
+        else
+        {
+            // Retry the same record.
+            state = saved_state;
+            (void)sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void * queue_consumer(void * p_context)
+{
+    uint8_t  data[RECORD_MAX_LEN];
+    uint8_t  expected[RECORD_MAX_LEN];
+    uint32_t state = 1;
+
+    for (uint32_t i = 0; i < RECORD_COUNT; )
+    {
+        uint16_t len      = sizeof(data);
+        uint32_t err_code = app_spsc_queue_get(&m_queue, data, &len);
+
+        if (err_code == NRF_SUCCESS)
+        {
+            uint16_t expected_len = random_get(&state) % (RECORD_MAX_LEN + 1);
+
+            record_fill(expected, i, expected_len);
+            assert(len == expected_len);
+            assert(memcmp(data, expected, len) == 0);
+            i++;
+        }
+        else
+        {
+            assert(err_code == NRF_ERROR_NOT_FOUND);
+            (void)sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void * mailbox_producer(void * p_context)
+{
+    for (uint32_t i = 0; i < MAILBOX_ITEM_COUNT; )
+    {
+        uint32_t item[3] = {i, ~i, i * 7};
+
+        if (app_mailbox_put(&m_mailbox, item) == NRF_SUCCESS)
+        {
+            i++;
+        }
+        else
+        {
+            assert(app_mailbox_length_get(&m_mailbox) <= MAILBOX_QUEUE_SIZE);
+            (void)sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void * mailbox_consumer(void * p_context)
+{
+    for (uint32_t i = 0; i < MAILBOX_ITEM_COUNT; )
+    {
+        uint32_t item[3];
+
+        if (app_mailbox_get(&m_mailbox, item) == NRF_SUCCESS)
+        {
+            assert((item[0] == i) && (item[1] == ~i) && (item[2] == i * 7));
+            i++;
+        }
+        else
+        {
+            (void)sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static double time_get(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void threads_run(void * (*producer)(void *), void * (*consumer)(void *))
+{
+    pthread_t producer_thread;
+    pthread_t consumer_thread;
+
+    assert(pthread_create(&producer_thread, NULL, producer, NULL) == 0);
+    assert(pthread_create(&consumer_thread, NULL, consumer, NULL) == 0);
+    assert(pthread_join(producer_thread, NULL) == 0);
+    assert(pthread_join(consumer_thread, NULL) == 0);
+}
+
+static void queue_single_thread_test(void)
+{
+    uint8_t  data[8] = {0};
+    uint16_t len     = 4;
+
+    assert(app_spsc_queue_init(&m_queue, m_queue_buf, sizeof(m_queue_buf)) == NRF_SUCCESS);
+    assert(app_spsc_queue_is_empty(&m_queue));
+    assert(app_spsc_queue_get(&m_queue, data, &len) == NRF_ERROR_NOT_FOUND);
+
+    // A record that does not fit in the buffer stays in the queue.
+    assert(app_spsc_queue_put(&m_queue, data, sizeof(data)) == NRF_SUCCESS);
+    assert(app_spsc_queue_get(&m_queue, data, &len) == NRF_ERROR_DATA_SIZE);
+    assert(len == sizeof(data));
+    assert(app_spsc_queue_get(&m_queue, data, &len) == NRF_SUCCESS);
+    assert(app_spsc_queue_is_empty(&m_queue));
+
+    // The queue refuses records once it is full.
+    while (app_spsc_queue_put(&m_queue, data, sizeof(data)) == NRF_SUCCESS)
+    {
+    }
+    assert(!app_spsc_queue_is_empty(&m_queue));
+    do
+    {
+        len = sizeof(data);
+    } while (app_spsc_queue_get(&m_queue, data, &len) == NRF_SUCCESS);
+    assert(app_spsc_queue_is_empty(&m_queue));
+}
+
+int main(void)
+{
+    double start;
+
+    queue_single_thread_test();
+
+    start = time_get();
+    threads_run(queue_producer, queue_consumer);
+    printf("app_spsc_queue: %u records of 0-%u bytes through a %u byte buffer, %.2f Mrecords/s\n",
+           RECORD_COUNT, RECORD_MAX_LEN, (unsigned int)sizeof(m_queue_buf),
+           RECORD_COUNT / (time_get() - start) / 1e6);
+
+    assert(app_mailbox_create(&m_mailbox) == NRF_SUCCESS);
+    start = time_get();
+    threads_run(mailbox_producer, mailbox_consumer);
+    printf("app_mailbox (lock-free): %u items through %u slots, %.2f Mitems/s\n",
+           MAILBOX_ITEM_COUNT, MAILBOX_QUEUE_SIZE, MAILBOX_ITEM_COUNT / (time_get() - start) / 1e6);
+
+    printf("spsc_queue_test: passed\n");
+    return 0;
+}
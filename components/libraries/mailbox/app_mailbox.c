@@ -17,6 +17,69 @@
 #include "app_util.h"
 #include "nrf_assert.h"
 
+#ifdef APP_MAILBOX_LOCK_FREE
+
+ret_code_t app_mailbox_create(const app_mailbox_t * queue_def)
+{
+    queue_def->p_cb->put_count = 0;
+    queue_def->p_cb->get_count = 0;
+    queue_def->p_cb->mode      = APP_MAILBOX_MODE_NO_OVERFLOW;
+
+    return app_spsc_queue_init(&queue_def->p_cb->queue,
+                               queue_def->p_pool,
+                               APP_SPSC_QUEUE_BUF_SIZE(queue_def->item_sz, queue_def->queue_sz));
+}
+
+ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size)
+{
+    ASSERT(p_item != NULL);
+    ASSERT(p_mailbox);
+    ASSERT(size <= p_mailbox->item_sz);
+    app_mailbox_cb_t * p_cb = p_mailbox->p_cb;
+
+    // Items smaller than item_sz leave room in the queue, but the capacity stays queue_sz items.
+    if ((p_cb->put_count - p_cb->get_count) == p_mailbox->queue_sz)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    if (app_spsc_queue_put(&p_cb->queue, p_item, size) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_cb->put_count++;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_mailbox_sized_get(const app_mailbox_t * p_mailbox, void * p_item, uint16_t * p_size)
+{
+    ASSERT(p_mailbox);
+    ASSERT(p_item != NULL);
+    app_mailbox_cb_t * p_cb = p_mailbox->p_cb;
+
+    *p_size = p_mailbox->item_sz;
+    if (app_spsc_queue_get(&p_cb->queue, p_item, p_size) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_cb->get_count++;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t app_mailbox_length_get (const app_mailbox_t * p_mailbox)
+{
+    ASSERT(p_mailbox);
+    // The consumer may count an item before the producer does.
+    int32_t len = (int32_t)(p_mailbox->p_cb->put_count - p_mailbox->p_cb->get_count);
+    return (len > 0) ? (uint32_t)len : 0;
+}
+
+#else
+
 ret_code_t app_mailbox_create(const app_mailbox_t * queue_def)
 {
     queue_def->p_cb->r_idx    = 0;
@@ -45,15 +108,9 @@ static __INLINE void enqueue(app_mailbox_cb_t * p_cb, uint8_t queue_sz)
     p_cb->w_idx = (w_idx == queue_sz) ? 0 : w_idx;
 }
 
-ret_code_t app_mailbox_put(const app_mailbox_t * p_mailbox, void * p_item)
-{
-    ASSERT(p_mailbox);
-    return app_mailbox_sized_put(p_mailbox, p_item, p_mailbox->item_sz);
-}
-
 ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size)
 {
-    ASSERT((uint32_t)p_item>0);
+    ASSERT(p_item != NULL);
     ASSERT(p_mailbox);
     uint32_t           err_code  = NRF_ERROR_INTERNAL;
     uint32_t *         p_dst     = p_mailbox->p_pool;
@@ -84,7 +141,7 @@ ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item,
 
     if (do_put)
     {
-        p_dst = (uint32_t *)((uint32_t)p_dst + (p_cb->w_idx * (item_sz + sizeof(uint32_t))));
+        p_dst = (uint32_t *)((uint8_t *)p_dst + (p_cb->w_idx * (item_sz + sizeof(uint32_t))));
         enqueue(p_cb, queue_sz);
 
         //Put data in mailbox.
@@ -98,16 +155,10 @@ ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item,
     return err_code;
 }
 
-ret_code_t app_mailbox_get(const app_mailbox_t * p_mailbox, void * p_item)
-{
-    uint16_t size;
-    return app_mailbox_sized_get(p_mailbox, p_item, &size);
-}
-
 ret_code_t app_mailbox_sized_get(const app_mailbox_t * p_mailbox, void * p_item, uint16_t * p_size)
 {
     ASSERT(p_mailbox);
-    ASSERT((uint32_t)p_item>0);
+    ASSERT(p_item != NULL);
     uint32_t *         p_src     = p_mailbox->p_pool;
     ret_code_t         err_code  = NRF_SUCCESS;
     uint16_t           item_sz   = p_mailbox->item_sz;
@@ -122,7 +173,7 @@ ret_code_t app_mailbox_sized_get(const app_mailbox_t * p_mailbox, void * p_item,
     }
     else
     {
-        p_src = (void *)((uint32_t)p_src + (p_cb->r_idx * (item_sz + sizeof(uint32_t))));
+        p_src = (void *)((uint8_t *)p_src + (p_cb->r_idx * (item_sz + sizeof(uint32_t))));
         dequeue(p_cb, queue_sz);
     }
 
@@ -145,6 +196,20 @@ uint32_t app_mailbox_length_get (const app_mailbox_t * p_mailbox)
     return p_mailbox->p_cb->len;
 }
 
+#endif // APP_MAILBOX_LOCK_FREE
+
+ret_code_t app_mailbox_put(const app_mailbox_t * p_mailbox, void * p_item)
+{
+    ASSERT(p_mailbox);
+    return app_mailbox_sized_put(p_mailbox, p_item, p_mailbox->item_sz);
+}
+
+ret_code_t app_mailbox_get(const app_mailbox_t * p_mailbox, void * p_item)
+{
+    uint16_t size;
+    return app_mailbox_sized_get(p_mailbox, p_item, &size);
+}
+
 void app_mailbox_mode_set(const app_mailbox_t * p_mailbox, app_mailbox_overflow_mode_t mode)
 {
     ASSERT(p_mailbox);
@@ -134,6 +134,11 @@ uint32_t app_mailbox_length_get (const app_mailbox_t * p_mailbox);
 /**
  * @brief Function for changing the mode of overflow handling.
  *
+ * @note If APP_MAILBOX_LOCK_FREE is defined, the mailbox is a lock-free queue which does not disable
+ *       interrupts, but must only be used by one producer and one consumer, see @ref app_spsc_queue.
+ *       In that case, @ref APP_MAILBOX_MODE_OVERFLOW is not supported: the producer cannot remove
+ *       the oldest element, so a full mailbox does not accept new elements in either mode.
+ *
  * @param[in]  p_mailbox   Pointer to the mailbox.
  * @param mode             New mode to set.
  */
@@ -24,6 +24,20 @@
  * However, any functions and variables defined here may change at any time
  * without a warning, so you should not access them directly.
  */
+#ifdef APP_MAILBOX_LOCK_FREE
+#include "app_spsc_queue.h"
+
+     /**
+     * @brief Mailbox handle used for managing a lock-free mailbox queue.
+     */
+    typedef struct
+    {
+        app_spsc_queue_t             queue;      /**< Queue holding the mail. */
+        volatile uint32_t            put_count;  /**< Number of items put. Only modified by the producer. */
+        volatile uint32_t            get_count;  /**< Number of items got. Only modified by the consumer. */
+        app_mailbox_overflow_mode_t  mode;       /**< Mode of overflow handling. */
+    } app_mailbox_cb_t;
+#else
      /**
      * @brief Mailbox handle used for managing a mailbox queue.
      */
@@ -34,6 +48,7 @@
         uint8_t                      len;      /**< Number of elements currently in the mailbox queue. */
         app_mailbox_overflow_mode_t  mode;     /**< Mode of overflow handling. */
     } app_mailbox_cb_t;
+#endif // APP_MAILBOX_LOCK_FREE
 
 
 /** @} 
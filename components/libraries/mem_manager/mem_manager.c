@@ -402,7 +402,7 @@
                            MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  +                                     \
                            MEMORY_MANAGER_LARGE_BLOCK_COUNT   +                                     \
                            MEMORY_MANAGER_XLARGE_BLOCK_COUNT  +                                     \
-                           MEMORY_MANAGER_XLARGE_BLOCK_COUNT)
+                           MEMORY_MANAGER_XXLARGE_BLOCK_COUNT)
 
 
 /**@brief Total memory managed by the module. */
@@ -425,7 +425,27 @@
 #define BLOCK_CAT_XXL                  6                                                            /**< Extra Extra Large category identifier. */
 
 #define BITMAP_SIZE                    32                                                           /**< Bitmap size for each word used to contain block information. */
-#define BLOCK_BITMAP_ARRAY_SIZE        CEIL_DIV(TOTAL_BLOCK_COUNT, BITMAP_SIZE)                     /**< Determines number of blocks needed for book keeping availability status of all blocks. */
+#define BITMAP_MASK(POS)               (0x80000000UL >> (POS))                                      /**< Bit for position 'POS' in a bitmap word. Position 0 is the most significant bit, so that the first set position is found by counting leading zeros. */
+#define CAT_BITMAP_SIZE(COUNT)         CEIL_DIV((COUNT), BITMAP_SIZE)                               /**< Number of bitmap words for a block category of 'COUNT' blocks. */
+
+#define XXSMALL_BITMAP_END             (CAT_BITMAP_SIZE(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT))                       /**< End of XXSmall block bitmap words. */
+#define XSMALL_BITMAP_END              (XXSMALL_BITMAP_END + CAT_BITMAP_SIZE(MEMORY_MANAGER_XSMALL_BLOCK_COUNT))   /**< End of XSmall block bitmap words. */
+#define SMALL_BITMAP_END               (XSMALL_BITMAP_END  + CAT_BITMAP_SIZE(MEMORY_MANAGER_SMALL_BLOCK_COUNT))    /**< End of Small block bitmap words. */
+#define MEDIUM_BITMAP_END              (SMALL_BITMAP_END   + CAT_BITMAP_SIZE(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT))   /**< End of Medium block bitmap words. */
+#define LARGE_BITMAP_END               (MEDIUM_BITMAP_END  + CAT_BITMAP_SIZE(MEMORY_MANAGER_LARGE_BLOCK_COUNT))    /**< End of Large block bitmap words. */
+#define XLARGE_BITMAP_END              (LARGE_BITMAP_END   + CAT_BITMAP_SIZE(MEMORY_MANAGER_XLARGE_BLOCK_COUNT))   /**< End of XLarge block bitmap words. */
+#define XXLARGE_BITMAP_END             (XLARGE_BITMAP_END  + CAT_BITMAP_SIZE(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT))  /**< End of XXLarge block bitmap words. */
+
+#define BLOCK_BITMAP_ARRAY_SIZE        XXLARGE_BITMAP_END                                           /**< Determines number of blocks needed for book keeping availability status of all blocks. */
+
+// The words of a category's bitmap are tracked in a single summary word.
+STATIC_ASSERT(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_XSMALL_BLOCK_COUNT  <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_SMALL_BLOCK_COUNT   <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_LARGE_BLOCK_COUNT   <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_XLARGE_BLOCK_COUNT  <= (BITMAP_SIZE * BITMAP_SIZE));
+STATIC_ASSERT(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT <= (BITMAP_SIZE * BITMAP_SIZE));
 
 
 /**@brief Lookup table for maximum memory size per block category. */
@@ -476,8 +496,22 @@ static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
     XXLARGE_MEMORY_START
 };
 
+/**@brief Lookup table for first bitmap word index for each block category. */
+static const uint32_t m_bitmap_start[BLOCK_CAT_COUNT] =
+{
+    0,
+    XXSMALL_BITMAP_END,
+    XSMALL_BITMAP_END,
+    SMALL_BITMAP_END,
+    MEDIUM_BITMAP_END,
+    LARGE_BITMAP_END,
+    XLARGE_BITMAP_END
+};
+
 static uint8_t  m_memory[TOTAL_MEMORY_SIZE];                                                        /**< Memory managed by the module. */
-static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module. Each block category has its own words. */
+static uint32_t m_mem_pool_summary[BLOCK_CAT_COUNT];                                                /**< Bitmap, per block category, of the words in m_mem_pool which have a free block. */
+static uint32_t m_free_cat;                                                                         /**< Bitmap of the block categories which have a free block. */
 
 #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -493,38 +527,10 @@ static const char * m_block_desc_str[BLOCK_CAT_COUNT] =
     "XXLarge"
 };
 
-/**@brief Table for book keeping smallest size allocated in each block range. */
-static uint32_t m_min_size[BLOCK_CAT_COUNT]  =
-{
-    MEMORY_MANAGER_XXSMALL_BLOCK_SIZE,
-    MEMORY_MANAGER_XSMALL_BLOCK_SIZE,
-    MEMORY_MANAGER_SMALL_BLOCK_SIZE,
-    MEMORY_MANAGER_MEDIUM_BLOCK_SIZE,
-    MEMORY_MANAGER_LARGE_BLOCK_SIZE,
-    MEMORY_MANAGER_XLARGE_BLOCK_SIZE,
-    MEMORY_MANAGER_XXLARGE_BLOCK_SIZE
-};
-
-/**@brief Table for book keeping largest size allocated in each block range. */
-static uint32_t m_max_size[BLOCK_CAT_COUNT];
-
-/**@brief Global pointing to minimum size holder for block type being allocated. */
-static uint32_t * p_min_size;
+/**@brief Table for book keeping statistics of each block category. */
+static nrf_mem_stats_t m_stats[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to maximum size holder for block type being allocated. */
-static uint32_t * p_max_size;
-
-/**@brief Lookup table for count of block available in each block category. */
-static uint32_t m_block_count[BLOCK_CAT_COUNT] =
-{
-    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
-    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
-};
+STATIC_ASSERT(NRF_MEM_BLOCK_CAT_COUNT == BLOCK_CAT_COUNT);
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -534,39 +540,27 @@ static bool     m_module_initialized = false;
 #endif // MEM_MANAGER_DISABLE_API_PARAM_CHECK
 
 
-/**@brief Function to get X and Y coordinates.
- *
- * @details Function to get X and Y co-ordinates for the block identified by index.
- *          Here, X determines relevant word for the block. Y determines the actual bit in the word.
- *
- * @param[in]  index Identifies the block.
- * @param[out] p_x   Points to the word that contains the bit representing the block.
- * @param[out] p_y   Contains the bitnumber in the the word 'X' relevant to the block.
- */
-static __INLINE void get_block_coordinates(uint32_t block_index, uint32_t * p_x, uint32_t * p_y)
+/**@brief Initializes all blocks of the category 'block_cat' by setting them to be free. */
+static void block_cat_init(uint32_t block_cat)
 {
-    // Determine position of the block in the bitmap.
-    // X determines relevant word for the block. Y determines the actual bit in the word.
-    const uint32_t x = block_index/BITMAP_SIZE;
-    const uint32_t y = (block_index - x*BITMAP_SIZE);
-
-    (*p_x) = x;
-    (*p_y) = y;
-}
+    const uint32_t count = m_block_end[block_cat] - m_block_start[block_cat];
 
+    m_mem_pool_summary[block_cat] = 0;
 
-/**@brief Initializes the block by setting it to be free. */
-static void block_init (uint32_t block_index)
-{
-    uint32_t x;
-    uint32_t y;
+    for (uint32_t x = 0; x < CAT_BITMAP_SIZE(count); x++)
+    {
+        const uint32_t bits = count - (x * BITMAP_SIZE);
 
-    // Determine position of the block in the bitmap.
-    // X determines relevant word for the block. Y determines the actual bit in the word.
-    get_block_coordinates(block_index, &x, &y);
+        // Set bits related to the blocks to indicate that the blocks are free.
+        m_mem_pool[m_bitmap_start[block_cat] + x] = (bits >= BITMAP_SIZE) ?
+                                                    0xFFFFFFFF : ~(0xFFFFFFFF >> bits);
+        m_mem_pool_summary[block_cat] |= BITMAP_MASK(x);
+    }
 
-    // Set bit related to the block to indicate that the block is free.
-    SET_BIT(m_mem_pool[x], y);
+    if (count != 0)
+    {
+        m_free_cat |= BITMAP_MASK(block_cat);
+    }
 }
 
 
@@ -587,45 +581,56 @@ static __INLINE uint32_t get_block_cat(uint32_t size, uint32_t block_index)
 }
 
 
-/**@brief Function to get the size of the block number 'block_index'. */
-static __INLINE uint32_t get_block_size(uint32_t block_index)
+/**@brief Function to allocate a free block of the category 'block_cat'.
+ *
+ * @details The category must have a free block.
+ *
+ * @return Index of the block, relative to the first block of the category.
+ */
+static uint32_t block_allocate(uint32_t block_cat)
 {
-    const uint32_t block_cat = get_block_cat(0, block_index);
-
-    #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
-        p_min_size = &m_min_size[block_cat];
-        p_max_size = &m_max_size[block_cat];
-    #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
-
-    return m_block_size[block_cat];
-}
+    // X determines relevant word for the block. Y determines the actual bit in the word.
+    const uint32_t   x      = __CLZ(m_mem_pool_summary[block_cat]);
+    uint32_t * const p_word = &m_mem_pool[m_bitmap_start[block_cat] + x];
+    const uint32_t   y      = __CLZ(*p_word);
 
+    (*p_word) &= ~BITMAP_MASK(y);
 
-/**@brief Function to free the block identified by block number 'block_index'. */
-static bool is_block_free(uint32_t block_index)
-{
-    uint32_t x;
-    uint32_t y;
+    if ((*p_word) == 0)
+    {
+        m_mem_pool_summary[block_cat] &= ~BITMAP_MASK(x);
 
-    // Determine position of the block in the bitmap.
-    // X determines relevant word for the block. Y determines the actual bit in the word.
-    get_block_coordinates(block_index, &x, &y);
+        if (m_mem_pool_summary[block_cat] == 0)
+        {
+            m_free_cat &= ~BITMAP_MASK(block_cat);
+        }
+    }
 
-    return IS_SET(m_mem_pool[x], y);
+    return (x * BITMAP_SIZE) + y;
 }
 
 
-/**@brief Function to allocate the block identified by block number 'block_index'. */
-static void block_allocate(uint32_t block_index)
+/**@brief Function to free the block identified by 'block_index' in the category 'block_cat'.
+ *
+ * @return True if the block was freed, false if it was already free.
+ */
+static bool block_free(uint32_t block_cat, uint32_t block_index)
 {
-    uint32_t x;
-    uint32_t y;
-
-    // Determine position of the block in the bitmap.
     // X determines relevant word for the block. Y determines the actual bit in the word.
-    get_block_coordinates(block_index, &x, &y);
+    const uint32_t   x      = block_index / BITMAP_SIZE;
+    const uint32_t   y      = block_index % BITMAP_SIZE;
+    uint32_t * const p_word = &m_mem_pool[m_bitmap_start[block_cat] + x];
+
+    if (((*p_word) & BITMAP_MASK(y)) != 0)
+    {
+        return false;
+    }
+
+    (*p_word)                     |= BITMAP_MASK(y);
+    m_mem_pool_summary[block_cat] |= BITMAP_MASK(x);
+    m_free_cat                    |= BITMAP_MASK(block_cat);
 
-    CLR_BIT(m_mem_pool[x], y);
+    return true;
 }
 
 
@@ -637,11 +642,18 @@ uint32_t nrf_mem_init(void)
 
     MM_MUTEX_LOCK();
 
-    uint32_t block_index = 0;
+    m_free_cat = 0;
 
-    for(block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        block_init(block_index);
+        block_cat_init(block_cat);
+
+#ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+        memset(&m_stats[block_cat], 0, sizeof(nrf_mem_stats_t));
+        m_stats[block_cat].block_size  = m_block_size[block_cat];
+        m_stats[block_cat].block_count = m_block_end[block_cat] - m_block_start[block_cat];
+        m_stats[block_cat].min_size    = m_block_size[block_cat];
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
     }
 
 #if (MEM_MANAGER_DISABLE_API_PARAM_CHECK == 0)
@@ -674,41 +686,50 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
 
     MM_MUTEX_LOCK();
 
-    const uint32_t block_cat    = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
-    uint32_t       block_index  = m_block_start[block_cat];
-    uint32_t       memory_index = m_block_mem_start[block_cat];
-    uint32_t       err_code     = (NRF_ERROR_NO_MEM | MEMORY_MANAGER_ERR_BASE);
+    const uint32_t block_cat = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
+    uint32_t       err_code  = (NRF_ERROR_NO_MEM | MEMORY_MANAGER_ERR_BASE);
 
-    MM_LOG("[MM]: Start index for the pool = 0x%08lX, total block count 0x%08X\r\n",
-           block_index,
-           TOTAL_BLOCK_COUNT);
+    // Categories, from the one fitting the requested size and up, which have a free block.
+    const uint32_t free_cat  = m_free_cat & (0xFFFFFFFF >> block_cat);
 
-    for (; block_index < TOTAL_BLOCK_COUNT; block_index++)
-    {
-        uint32_t block_size = get_block_size(block_index);
+    MM_LOG("[MM]: Block category 0x%08lX, free categories 0x%08lX\r\n", block_cat, free_cat);
 
-        if (is_block_free(block_index) == true)
-        {
-            MM_LOG("[MM]: Reserving block 0x%08lX\r\n", block_index);
+    if (free_cat != 0)
+    {
+        // Search succeeded, the smallest category with a free block is the first one set.
+        const uint32_t alloc_cat   = __CLZ(free_cat);
+        const uint32_t block_index = block_allocate(alloc_cat);
 
-            // Search succeeded, found free block.
-            err_code     = NRF_SUCCESS;
+        MM_LOG("[MM]: Reserving block 0x%08lX\r\n", m_block_start[alloc_cat] + block_index);
 
-            // Allocate block.
-            block_allocate(block_index);
+        err_code     = NRF_SUCCESS;
+        (*pp_buffer) = &m_memory[m_block_mem_start[alloc_cat] +
+                                 (block_index * m_block_size[alloc_cat])];
+        (*p_size)    = m_block_size[alloc_cat];
 
-            (*pp_buffer) = &m_memory[memory_index];
-            (*p_size)    = block_size;
+        #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+            nrf_mem_stats_t * const p_stats = &m_stats[alloc_cat];
 
-            #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
-                (*p_min_size) = MIN((*p_min_size), requested_size);
-                (*p_max_size) = MAX((*p_max_size), requested_size);
-            #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+            p_stats->in_use++;
+            p_stats->max_in_use       = MAX(p_stats->max_in_use, p_stats->in_use);
+            p_stats->min_size         = MIN(p_stats->min_size, requested_size);
+            p_stats->max_size         = MAX(p_stats->max_size, requested_size);
+            p_stats->reserve_count++;
+            p_stats->requested_bytes += requested_size;
 
-            break;
-        }
-        memory_index += block_size;
+            if (alloc_cat != block_cat)
+            {
+                p_stats->fallback_count++;
+            }
+        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+    }
+    else
+    {
+        #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+            m_stats[block_cat].failure_count++;
+        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
     }
+
     if (err_code != NRF_SUCCESS)
     {
         MM_LOG ("[MM]: Memory reservation result %d, memory %p, size %d!",
@@ -777,19 +798,34 @@ void nrf_free(void * p_mem)
 
     MM_MUTEX_LOCK();
 
-    uint32_t index;
-    uint32_t memory_index = 0;
-
-    for (index = 0; index < TOTAL_BLOCK_COUNT; index++)
+    if (((uint8_t *)p_mem >= m_memory) && ((uint8_t *)p_mem < &m_memory[TOTAL_MEMORY_SIZE]))
     {
-        if (&m_memory[memory_index] == p_mem)
+        const uint32_t memory_index = (uint8_t *)p_mem - m_memory;
+        uint32_t       block_cat    = BLOCK_CAT_COUNT;
+
+        // Find the category whose memory range contains the block.
+        do
         {
-            // Found a free block of memory, assign.
-            MM_LOG("[MM]: << Freeing block %d.\r\n", index);
-            block_init(index);
-            break;
+            block_cat--;
+        } while ((m_block_start[block_cat] == m_block_end[block_cat]) ||
+                 (memory_index < m_block_mem_start[block_cat]));
+
+        const uint32_t offset = memory_index - m_block_mem_start[block_cat];
+
+        // Only the start of a block can be freed.
+        if ((offset % m_block_size[block_cat]) == 0)
+        {
+            const uint32_t block_index = offset / m_block_size[block_cat];
+
+            MM_LOG("[MM]: << Freeing block %d.\r\n", m_block_start[block_cat] + block_index);
+
+            if (block_free(block_cat, block_index))
+            {
+                #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+                    m_stats[block_cat].in_use--;
+                #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+            }
         }
-        memory_index += get_block_size(index);
     }
 
     MM_MUTEX_UNLOCK();
@@ -819,30 +855,18 @@ void * nrf_realloc(void * p_mem, uint32_t size)
 void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 {
     #define PRINT_COLUMN_WIDTH      13
-    #define PRINT_BUFFER_SIZE       80
+    #define PRINT_BUFFER_SIZE       96
     #define ASCII_VALUE_FOR_SPACE   32
 
-    char           print_buffer[PRINT_BUFFER_SIZE];
-    const uint32_t total_count   = (m_block_start[block_cat] + m_block_count[block_cat]);
-    uint32_t       in_use        = 0;
-    uint32_t       num_of_blocks = 0;
-    uint32_t       index         = m_block_start[block_cat];
-    uint32_t       column_number;
+    char                          print_buffer[PRINT_BUFFER_SIZE];
+    const nrf_mem_stats_t * const p_stats = &m_stats[block_cat];
+    uint32_t                      column_number;
 
     // No statistic provided in case block category is not included.
-    if (m_block_count[block_cat] != 0)
+    if (p_stats->block_count != 0)
     {
         memset(print_buffer, ASCII_VALUE_FOR_SPACE, PRINT_BUFFER_SIZE);
 
-        for (; index < total_count; index++)
-        {
-            if (is_block_free(index) == false)
-            {
-                num_of_blocks++;
-                in_use += m_block_size[block_cat];
-            }
-        }
-
         column_number = 0;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
@@ -859,25 +883,31 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 m_block_count[block_cat]);
+                 p_stats->block_count);
 
         column_number++;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 num_of_blocks);
+                 p_stats->in_use);
 
         column_number++;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 m_min_size[block_cat]);
+                 p_stats->max_in_use);
 
         column_number++;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 m_max_size[block_cat]);
+                 p_stats->min_size);
+
+        column_number++;
+        snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
+                 PRINT_COLUMN_WIDTH,
+                 "| %d",
+                 p_stats->max_size);
 
         column_number++;
         const uint32_t column_end = (column_number * PRINT_COLUMN_WIDTH);
@@ -893,7 +923,7 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 
         MMD_LOG("%s\r\n", print_buffer);
 
-        (*p_mem_in_use) += in_use;
+        (*p_mem_in_use) += p_stats->in_use * p_stats->block_size;
     }
 }
 
@@ -903,9 +933,9 @@ void nrf_mem_diagnose(void)
     uint32_t in_use = 0;
 
     MMD_LOG ("\r\n");
-    MMD_LOG ("+------------+------------+------------+------------+------------+------------+\r\n");
-    MMD_LOG ("| Block      | Size       | Total      | In Use     | Min Alloc  | Max Alloc  |\r\n");
-    MMD_LOG ("+------------+------------+------------+------------+------------+------------+\r\n");
+    MMD_LOG ("+------------+------------+------------+------------+------------+------------+------------+\r\n");
+    MMD_LOG ("| Block      | Size       | Total      | In Use     | Max In Use | Min Alloc  | Max Alloc  |\r\n");
+    MMD_LOG ("+------------+------------+------------+------------+------------+------------+------------+\r\n");
 
     print_block_info(BLOCK_CAT_XXS, &in_use);
     print_block_info(BLOCK_CAT_XS, &in_use);
@@ -915,10 +945,30 @@ void nrf_mem_diagnose(void)
     print_block_info(BLOCK_CAT_XL, &in_use);
     print_block_info(BLOCK_CAT_XXL, &in_use);
 
-    MMD_LOG ("+------------+------------+------------+------------+------------+------------+\r\n");
+    MMD_LOG ("+------------+------------+------------+------------+------------+------------+------------+\r\n");
     MMD_LOG ("| Total      | %d      | %d        | %d\r\n",
             TOTAL_MEMORY_SIZE, TOTAL_BLOCK_COUNT,in_use);
-    MMD_LOG ("+------------+------------+------------+------------+------------+------------+\r\n");
+    MMD_LOG ("+------------+------------+------------+------------+------------+------------+------------+\r\n");
+}
+
+
+uint32_t nrf_mem_stats_get(uint32_t block_cat, nrf_mem_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    NULL_PARAM_CHECK(p_stats);
+
+    if (block_cat >= BLOCK_CAT_COUNT)
+    {
+        return (NRF_ERROR_INVALID_PARAM | MEMORY_MANAGER_ERR_BASE);
+    }
+
+    MM_MUTEX_LOCK();
+
+    (*p_stats) = m_stats[block_cat];
+
+    MM_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
 }
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
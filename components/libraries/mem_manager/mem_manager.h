@@ -29,6 +29,9 @@
  * To use fewer than seven buffer pools, do not define the count for the unwanted block
  * or explicitly set it to zero. At least one block category must be configured
  * for this module to function as expected.
+ * A request is served from the smallest block category that fits it and has a free block. The
+ * free blocks of each category are tracked in a two-level bitmap, so reserving and freeing a block
+ * take constant time. A category can have at most 1024 blocks.
  */
 
 #ifndef MEM_MANAGER_H__
@@ -122,6 +125,27 @@ void * nrf_realloc(void *p_buffer, uint32_t size);
 
 #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 
+#define NRF_MEM_BLOCK_CAT_COUNT 7 /**< Number of block categories, from xxsmall (0) to xxlarge (6). */
+
+/**@brief Statistics of a block category. */
+typedef struct
+{
+    uint32_t block_size;        /**< Size of the blocks in the category. */
+    uint32_t block_count;       /**< Number of blocks in the category. */
+    uint32_t in_use;            /**< Number of blocks currently in use. */
+    uint32_t max_in_use;        /**< Largest number of blocks that have been in use at the same time. */
+    uint32_t min_size;          /**< Smallest size requested for a block of the category. */
+    uint32_t max_size;          /**< Largest size requested for a block of the category. */
+    uint32_t reserve_count;     /**< Number of blocks of the category that have been reserved. */
+    uint32_t requested_bytes;   /**< Sum of the sizes requested for those blocks. The fraction of
+                                     memory lost to internal fragmentation is
+                                     1 - requested_bytes / (reserve_count * block_size). */
+    uint32_t fallback_count;    /**< Number of blocks of the category that have been reserved because
+                                     all blocks of a smaller, fitting category were in use. */
+    uint32_t failure_count;     /**< Number of requests fitting this category which failed, because
+                                     no block of this or a larger category was free. */
+} nrf_mem_stats_t;
+
 /**@brief Function to print statstics related to memory blocks managed by memory manager.
  *
  * @details This API prints information with respects to each block function, including size, total
@@ -133,6 +157,22 @@ void * nrf_realloc(void *p_buffer, uint32_t size);
  */
 void nrf_mem_diagnose(void);
 
+
+/**@brief Function to get statistics of a block category.
+ *
+ * @details This API is intended to help developers tune the block sizes and counts, like
+ *          @ref nrf_mem_diagnose, but without relying on logs.
+ *
+ * @param[in]  block_cat   Block category, from 0 (xxsmall) to @ref NRF_MEM_BLOCK_CAT_COUNT - 1
+ *                         (xxlarge).
+ * @param[out] p_stats     Statistics of the block category.
+ *
+ * @retval     NRF_SUCCESS             If the statistics were retrieved successfully.
+ * @retval     NRF_ERROR_INVALID_PARAM If the block category is invalid.
+ * @retval     NRF_ERROR_NULL          If p_stats is NULL.
+ */
+uint32_t nrf_mem_stats_get(uint32_t block_cat, nrf_mem_stats_t * p_stats);
+
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
 #endif // MEM_MANAGER_H__
@@ -128,6 +128,14 @@ uint32_t app_sched_event_put(void                    * p_event_data,
     {
         uint16_t event_index = 0xFFFF;
 
+    #ifdef APP_SCHEDULER_SINGLE_PRODUCER
+        // Only one context puts events, so the slot can be taken without a critical region.
+        // The end index is moved once the event has been written, see below.
+        if (!APP_SCHED_QUEUE_FULL())
+        {
+            event_index = m_queue_end_index;
+        }
+    #else
         CRITICAL_REGION_ENTER();
 
         if (!APP_SCHED_QUEUE_FULL())
@@ -143,6 +151,7 @@ uint32_t app_sched_event_put(void                    * p_event_data,
         }
 
         CRITICAL_REGION_EXIT();
+    #endif
 
         if (event_index != 0xFFFF)
         {
@@ -161,6 +170,16 @@ uint32_t app_sched_event_put(void                    * p_event_data,
                 m_queue_event_headers[event_index].event_data_size = 0;
             }
 
+        #ifdef APP_SCHEDULER_SINGLE_PRODUCER
+            // Publish the event to app_sched_execute() only once it is complete.
+            __DMB();
+            m_queue_end_index = next_index(event_index);
+
+        #ifdef APP_SCHEDULER_WITH_PROFILER
+            queue_utilization_check();
+        #endif
+        #endif
+
             err_code = NRF_SUCCESS;
         }
         else
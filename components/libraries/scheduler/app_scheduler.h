@@ -44,6 +44,26 @@
  * @ref ble_sdk_app_hids_mouse and @ref ble_sdk_app_hids_keyboard.
  * @endif
  *
+ * @section app_scheduler_priorities Priorities:
+ *
+ * When the module is built from app_scheduler_prio.c with APP_SCHEDULER_WITH_PRIORITIES defined,
+ * the scheduler has APP_SCHED_PRIORITY_COUNT priority levels, 0 being the highest. Each level has
+ * its own queue in which events take only the space they need (rounded up to a multiple of
+ * 4 bytes), so a small event does not use a slot of the maximum event size. app_sched_execute()
+ * always executes the oldest event of the highest priority level that has pending events.
+ * app_sched_event_put() schedules events at @ref APP_SCHED_PRIORITY_DEFAULT.
+ *
+ * An event can also be built in place: app_sched_event_reserve() returns a pointer to the event
+ * data in the queue and app_sched_event_commit() makes the event available for execution. Events
+ * of the same priority level are executed in the order they were reserved, so an event which is
+ * reserved but not yet committed holds back the events reserved after it.
+ *
+ * @section app_scheduler_single_producer Single producer:
+ *
+ * When the module is built from app_scheduler.c with APP_SCHEDULER_SINGLE_PRODUCER defined,
+ * app_sched_event_put() does not disable interrupts. It must then only be called from one
+ * context, for example a single interrupt priority level, which never preempts itself.
+ *
  * @image html scheduler_working.jpg The high level design of the scheduler
  */
 
@@ -54,6 +74,8 @@
 #include "app_error.h"
 #include "app_util.h"
 
+#ifndef APP_SCHEDULER_WITH_PRIORITIES
+
 #define APP_SCHED_EVENT_HEADER_SIZE 8       /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
 
 /**@brief Compute number of bytes required to hold the scheduler buffer.
@@ -66,6 +88,39 @@
  */
 #define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE)                                                 \
             (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
+
+#else
+
+#ifndef APP_SCHED_PRIORITY_COUNT
+#define APP_SCHED_PRIORITY_COUNT    2       /**< Number of priority levels. */
+#endif
+
+#define APP_SCHED_PRIORITY_DEFAULT  (APP_SCHED_PRIORITY_COUNT - 1) /**< Priority level used by app_sched_event_put(). */
+
+// The header holds the handler pointer and 4 bytes of size and state, followed by the commit time
+// with the profiler. It is padded to a multiple of the pointer size (12 or 8 bytes on the target).
+#ifdef APP_SCHEDULER_WITH_PROFILER
+#define APP_SCHED_EVENT_HEADER_FIELDS_SIZE  8
+#else
+#define APP_SCHED_EVENT_HEADER_FIELDS_SIZE  4
+#endif
+#define APP_SCHED_EVENT_HEADER_SIZE                                                                            (CEIL_DIV(sizeof(void *) + APP_SCHED_EVENT_HEADER_FIELDS_SIZE, sizeof(void *))                      * sizeof(void *))                  /**< Size of app_scheduler_prio.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+
+/**@brief Compute number of bytes required to hold the scheduler buffer.
+ *
+ * @details Every priority level gets a queue which can hold QUEUE_SIZE events of EVENT_SIZE bytes,
+ *          and more events when they are smaller.
+ *
+ * @param[in] EVENT_SIZE   Maximum size of events to be passed through the scheduler.
+ * @param[in] QUEUE_SIZE   Number of maximum size events each priority level can hold.
+ *
+ * @return    Required scheduler buffer size (in bytes).
+ */
+#define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE)                                                 \
+            ((CEIL_DIV((EVENT_SIZE), 4) * 4 + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1)    \
+             * APP_SCHED_PRIORITY_COUNT)
+
+#endif // APP_SCHEDULER_WITH_PRIORITIES
             
 /**@brief Scheduler event handler type. */
 typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_size);
@@ -132,6 +187,59 @@ uint32_t app_sched_event_put(void *                    p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+#ifdef APP_SCHEDULER_WITH_PRIORITIES
+/**@brief Function for scheduling an event at a given priority level.
+ *
+ * @param[in]   p_event_data   Pointer to event data to be scheduled.
+ * @param[in]   event_size     Size of event data to be scheduled.
+ * @param[in]   handler        Event handler to receive the event.
+ * @param[in]   priority       Priority level, 0 is the highest.
+ *
+ * @retval      NRF_SUCCESS               Event scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event larger than the maximum event size.
+ * @retval      NRF_ERROR_NO_MEM          No room in the queue of the priority level.
+ */
+uint32_t app_sched_event_put_prio(void *                    p_event_data,
+                                  uint16_t                  event_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority);
+
+/**@brief Function for reserving room for an event in the queue of a priority level.
+ *
+ * @details The event data is written directly into the queue through the returned pointer, and
+ *          the event is made available for execution with @ref app_sched_event_commit. Every
+ *          reserved event must be either committed or cancelled.
+ *
+ * @param[in]   event_size     Size of event data.
+ * @param[in]   handler        Event handler to receive the event.
+ * @param[in]   priority       Priority level, 0 is the highest.
+ * @param[out]  pp_event_data  Pointer to the event data in the queue (word aligned).
+ *
+ * @retval      NRF_SUCCESS               Room reserved.
+ * @retval      NRF_ERROR_NULL            Null pointer supplied.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event larger than the maximum event size.
+ * @retval      NRF_ERROR_NO_MEM          No room in the queue of the priority level.
+ */
+uint32_t app_sched_event_reserve(uint16_t                  event_size,
+                                 app_sched_event_handler_t handler,
+                                 uint8_t                   priority,
+                                 void **                   pp_event_data);
+
+/**@brief Function for making a reserved event available for execution.
+ *
+ * @param[in]   p_event_data   Pointer returned by @ref app_sched_event_reserve.
+ */
+void app_sched_event_commit(void * p_event_data);
+
+/**@brief Function for releasing a reserved event without executing it.
+ *
+ * @param[in]   p_event_data   Pointer returned by @ref app_sched_event_reserve.
+ */
+void app_sched_event_cancel(void * p_event_data);
+#endif
+
 #ifdef APP_SCHEDULER_WITH_PROFILER
 /**@brief Function for getting the maximum observed queue utilization.
  *
@@ -140,6 +248,32 @@ uint32_t app_sched_event_put(void *                    p_event_data,
  * @return Maximum number of events in queue observed so far.
  */
 uint16_t app_sched_queue_utilization_get(void);
+
+#ifdef APP_SCHEDULER_WITH_PRIORITIES
+/**@brief Profiling data of a priority level. */
+typedef struct
+{
+    uint32_t max_bytes_used;    /**< Maximum observed number of bytes used in the queue. */
+    uint16_t max_events;        /**< Maximum observed number of events in the queue. */
+    uint32_t executed_events;   /**< Number of executed events. */
+    uint32_t max_latency;       /**< Maximum time from commit to execution, in APP_SCHED_PROFILER_TIMESTAMP() ticks. */
+    uint32_t total_latency;     /**< Sum of the times from commit to execution, in APP_SCHED_PROFILER_TIMESTAMP() ticks. */
+} app_sched_prio_stats_t;
+
+/**@brief Function for getting the profiling data of a priority level.
+ *
+ * @details Latencies are measured with APP_SCHED_PROFILER_TIMESTAMP(), which reads the RTC1 counter
+ *          (the RTC used by the app_timer module) unless defined otherwise.
+ *
+ * @param[in]   priority   Priority level.
+ * @param[out]  p_stats    Profiling data.
+ *
+ * @retval      NRF_SUCCESS               Profiling data returned.
+ * @retval      NRF_ERROR_NULL            Null pointer supplied.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority level.
+ */
+uint32_t app_sched_prio_stats_get(uint8_t priority, app_sched_prio_stats_t * p_stats);
+#endif
 #endif
 
 #ifdef APP_SCHEDULER_WITH_PAUSE
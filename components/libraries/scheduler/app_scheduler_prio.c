@@ -0,0 +1,472 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_scheduler.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nrf.h"
+#include "nrf_soc.h"
+#include "nrf_assert.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+
+#ifndef APP_SCHEDULER_WITH_PRIORITIES
+#error "app_scheduler_prio.c requires APP_SCHEDULER_WITH_PRIORITIES to be defined."
+#endif
+
+/* Each priority level has a byte ring of its own. An event occupies a header followed by its data
+ * rounded up to a multiple of 4 bytes. An event which does not fit before the end of the ring is
+ * placed at the start of the ring, and the skipped bytes at the end are marked with a wrap header
+ * (or left unmarked if they are too few to hold a header). Producers reserve room inside a critical
+ * region; the consumer is always app_sched_execute() in the main context. */
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+#ifndef APP_SCHED_PROFILER_TIMESTAMP
+#define APP_SCHED_PROFILER_TIMESTAMP()     (NRF_RTC1->COUNTER) /**< Time source for latency measurements. */
+#define APP_SCHED_PROFILER_TIMESTAMP_MASK  0x00FFFFFF          /**< Valid bits of the time source. */
+#endif
+#ifndef APP_SCHED_PROFILER_TIMESTAMP_MASK
+#define APP_SCHED_PROFILER_TIMESTAMP_MASK  0xFFFFFFFF
+#endif
+#endif
+
+/**@brief States of an entry in an event queue. */
+enum
+{
+    EVENT_STATE_RESERVED,   /**< Event is being written by the producer. */
+    EVENT_STATE_COMMITTED,  /**< Event is ready for execution. */
+    EVENT_STATE_CANCELLED,  /**< Event was released by the producer, it is skipped. */
+    EVENT_STATE_WRAP        /**< Remaining bytes until the end of the queue are unused. */
+};
+
+/**@brief Structure for holding a scheduled event header. */
+typedef struct
+{
+    app_sched_event_handler_t handler;          /**< Pointer to event handler to receive the event. */
+    uint16_t                  event_data_size;  /**< Size of event data. */
+    volatile uint8_t          state;            /**< Entry state. */
+    uint8_t                   reserved;         /**< Padding. */
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    uint32_t                  commit_time;      /**< Time at which the event was committed. */
+#endif
+} event_header_t;
+
+STATIC_ASSERT(sizeof(event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
+STATIC_ASSERT((sizeof(event_header_t) % sizeof(uint32_t)) == 0);
+
+/**@brief Structure for holding the event queue of a priority level. */
+typedef struct
+{
+    uint8_t *         p_buf;    /**< Queue memory. */
+    uint32_t          read;     /**< Offset of the oldest entry, modified by the consumer only. */
+    uint32_t          write;    /**< Offset at which the next entry will be reserved. */
+    volatile uint32_t used;     /**< Number of bytes in use, including skipped bytes at the end. */
+    volatile uint16_t count;    /**< Number of events in the queue. */
+} event_queue_t;
+
+static event_queue_t m_queues[APP_SCHED_PRIORITY_COUNT];   /**< Event queues, index 0 has the highest priority. */
+static uint32_t      m_queue_size;                         /**< Size of each event queue in bytes. */
+static uint16_t      m_queue_event_size;                   /**< Maximum event size. */
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+static app_sched_prio_stats_t m_stats[APP_SCHED_PRIORITY_COUNT];  /**< Profiling data of each priority level. */
+#endif
+
+#ifdef APP_SCHEDULER_WITH_PAUSE
+static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the difference between pausing
+                                                     and resuming the scheduler. */
+#endif
+
+
+/**@brief Function for getting the number of bytes an event takes in a queue.
+ *
+ * @param[in]   event_data_size   Size of event data.
+ *
+ * @return      Size of the queue entry.
+ */
+static __INLINE uint32_t entry_size(uint16_t event_data_size)
+{
+    return sizeof(event_header_t) + CEIL_DIV(event_data_size, sizeof(uint32_t)) * sizeof(uint32_t);
+}
+
+
+uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+{
+    uint32_t i;
+
+    // Check that buffer is correctly aligned
+    if (!is_word_aligned(p_event_buffer))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // Initialize event scheduler
+    m_queue_event_size = event_size;
+    m_queue_size       = entry_size(event_size) * (queue_size + 1);
+
+    for (i = 0; i < APP_SCHED_PRIORITY_COUNT; i++)
+    {
+        m_queues[i].p_buf = &((uint8_t *)p_event_buffer)[i * m_queue_size];
+        m_queues[i].read  = 0;
+        m_queues[i].write = 0;
+        m_queues[i].used  = 0;
+        m_queues[i].count = 0;
+    }
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    memset(m_stats, 0, sizeof(m_stats));
+#endif
+
+    return NRF_SUCCESS;
+}
+
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+/**@brief Function for updating the maximum observed utilization of a queue.
+ *
+ * @note Must be called from a critical region.
+ */
+static void queue_utilization_check(uint8_t priority)
+{
+    event_queue_t const * p_queue = &m_queues[priority];
+
+    if (p_queue->used > m_stats[priority].max_bytes_used)
+    {
+        m_stats[priority].max_bytes_used = p_queue->used;
+    }
+    if (p_queue->count > m_stats[priority].max_events)
+    {
+        m_stats[priority].max_events = p_queue->count;
+    }
+}
+
+
+/**@brief Function for recording the latency of an event which is about to be executed. */
+static void event_latency_record(uint8_t priority, event_header_t const * p_header)
+{
+    uint32_t latency = (APP_SCHED_PROFILER_TIMESTAMP() - p_header->commit_time)
+                       & APP_SCHED_PROFILER_TIMESTAMP_MASK;
+
+    m_stats[priority].executed_events++;
+    m_stats[priority].total_latency += latency;
+    if (latency > m_stats[priority].max_latency)
+    {
+        m_stats[priority].max_latency = latency;
+    }
+}
+
+
+uint16_t app_sched_queue_utilization_get(void)
+{
+    uint16_t max_events = 0;
+    uint32_t i;
+
+    for (i = 0; i < APP_SCHED_PRIORITY_COUNT; i++)
+    {
+        max_events = MAX(max_events, m_stats[i].max_events);
+    }
+
+    return max_events;
+}
+
+
+uint32_t app_sched_prio_stats_get(uint8_t priority, app_sched_prio_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (priority >= APP_SCHED_PRIORITY_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats[priority];
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+#endif
+
+
+uint32_t app_sched_event_reserve(uint16_t                  event_data_size,
+                                 app_sched_event_handler_t handler,
+                                 uint8_t                   priority,
+                                 void **                   pp_event_data)
+{
+    event_queue_t  * p_queue;
+    event_header_t * p_header = NULL;
+    uint32_t         size;
+
+    if (pp_event_data == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (priority >= APP_SCHED_PRIORITY_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (event_data_size > m_queue_event_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_queue = &m_queues[priority];
+    size    = entry_size(event_data_size);
+
+    CRITICAL_REGION_ENTER();
+
+    uint32_t offset   = p_queue->write;
+    uint32_t tail     = m_queue_size - offset;
+    uint32_t required = (tail < size) ? (tail + size) : size;
+
+    if (p_queue->used + required <= m_queue_size)
+    {
+        if (tail < size)
+        {
+            // The entry is placed at the start of the queue, the bytes until the end are skipped.
+            if (tail >= sizeof(event_header_t))
+            {
+                ((event_header_t *)&p_queue->p_buf[offset])->state = EVENT_STATE_WRAP;
+            }
+            offset = 0;
+        }
+
+        p_header                  = (event_header_t *)&p_queue->p_buf[offset];
+        p_header->handler         = handler;
+        p_header->event_data_size = event_data_size;
+        p_header->state           = EVENT_STATE_RESERVED;
+
+        p_queue->write  = ((offset + size) < m_queue_size) ? (offset + size) : 0;
+        p_queue->used  += required;
+        p_queue->count += 1;
+
+    #ifdef APP_SCHEDULER_WITH_PROFILER
+        // This function call must be protected with critical region because
+        // it modifies 'm_stats'.
+        queue_utilization_check(priority);
+    #endif
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    if (p_header == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    *pp_event_data = p_header + 1;
+
+    return NRF_SUCCESS;
+}
+
+
+void app_sched_event_commit(void * p_event_data)
+{
+    event_header_t * p_header = (event_header_t *)p_event_data - 1;
+
+    ASSERT(p_header->state == EVENT_STATE_RESERVED);
+
+#ifdef APP_SCHEDULER_WITH_PROFILER
+    p_header->commit_time = APP_SCHED_PROFILER_TIMESTAMP();
+#endif
+    p_header->state = EVENT_STATE_COMMITTED;
+}
+
+
+void app_sched_event_cancel(void * p_event_data)
+{
+    event_header_t * p_header = (event_header_t *)p_event_data - 1;
+
+    ASSERT(p_header->state == EVENT_STATE_RESERVED);
+
+    p_header->state = EVENT_STATE_CANCELLED;
+}
+
+
+uint32_t app_sched_event_put_prio(void *                    p_event_data,
+                                  uint16_t                  event_data_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority)
+{
+    uint32_t err_code;
+    void   * p_queued_data;
+
+    if (p_event_data == NULL)
+    {
+        event_data_size = 0;
+    }
+
+    err_code = app_sched_event_reserve(event_data_size, handler, priority, &p_queued_data);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        if (event_data_size > 0)
+        {
+            memcpy(p_queued_data, p_event_data, event_data_size);
+        }
+        app_sched_event_commit(p_queued_data);
+    }
+
+    return err_code;
+}
+
+
+uint32_t app_sched_event_put(void *                    p_event_data,
+                             uint16_t                  event_data_size,
+                             app_sched_event_handler_t handler)
+{
+    return app_sched_event_put_prio(p_event_data,
+                                    event_data_size,
+                                    handler,
+                                    APP_SCHED_PRIORITY_DEFAULT);
+}
+
+
+/**@brief Function for removing the oldest entry of a queue.
+ *
+ * @param[in]   p_queue    Queue.
+ * @param[in]   size       Number of bytes to release.
+ * @param[in]   is_event   True if the entry is an event, false if it is skipped bytes.
+ */
+static void queue_entry_release(event_queue_t * p_queue, uint32_t size, bool is_event)
+{
+    p_queue->read = ((p_queue->read + size) < m_queue_size) ? (p_queue->read + size) : 0;
+
+    CRITICAL_REGION_ENTER();
+    p_queue->used -= size;
+    if (is_event)
+    {
+        p_queue->count -= 1;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for getting the oldest event of a queue if it is ready for execution.
+ *
+ * @details Skipped bytes and cancelled events at the start of the queue are released.
+ *
+ * @note There is no need for a critical region when reading the queue, as this function will only
+ *       be called from app_sched_execute() from inside the main loop, and producers never modify
+ *       entries from the read offset until the write offset.
+ *
+ * @param[in]   p_queue    Queue.
+ *
+ * @return      Header of the event, or NULL if the queue is empty or the oldest event is not
+ *              committed yet.
+ */
+static event_header_t * queue_event_peek(event_queue_t * p_queue)
+{
+    while (p_queue->used != 0)
+    {
+        uint32_t         tail     = m_queue_size - p_queue->read;
+        event_header_t * p_header = (event_header_t *)&p_queue->p_buf[p_queue->read];
+
+        if ((tail < sizeof(event_header_t)) || (p_header->state == EVENT_STATE_WRAP))
+        {
+            queue_entry_release(p_queue, tail, false);
+        }
+        else if (p_header->state == EVENT_STATE_CANCELLED)
+        {
+            queue_entry_release(p_queue, entry_size(p_header->event_data_size), true);
+        }
+        else if (p_header->state == EVENT_STATE_COMMITTED)
+        {
+            return p_header;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+#ifdef APP_SCHEDULER_WITH_PAUSE
+void app_sched_pause(void)
+{
+    CRITICAL_REGION_ENTER();
+
+    if (m_scheduler_paused_counter < UINT32_MAX)
+    {
+        m_scheduler_paused_counter++;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_sched_resume(void)
+{
+    CRITICAL_REGION_ENTER();
+
+    if (m_scheduler_paused_counter > 0)
+    {
+        m_scheduler_paused_counter--;
+    }
+    CRITICAL_REGION_EXIT();
+}
+#endif
+
+
+/**@brief Function for checking if scheduler is paused which means that should break processing
+ *        events.
+ *
+ * @return    Boolean value - true if scheduler is paused, false otherwise.
+ */
+static __INLINE bool is_app_sched_paused(void)
+{
+#ifdef APP_SCHEDULER_WITH_PAUSE
+    return (m_scheduler_paused_counter > 0);
+#else
+    return false;
+#endif
+}
+
+
+void app_sched_execute(void)
+{
+    while (!is_app_sched_paused())
+    {
+        event_header_t * p_header = NULL;
+        uint8_t          priority;
+
+        // Get the next event of the highest priority level that has one.
+        for (priority = 0; priority < APP_SCHED_PRIORITY_COUNT; priority++)
+        {
+            p_header = queue_event_peek(&m_queues[priority]);
+            if (p_header != NULL)
+            {
+                break;
+            }
+        }
+
+        if (p_header == NULL)
+        {
+            break;
+        }
+
+    #ifdef APP_SCHEDULER_WITH_PROFILER
+        event_latency_record(priority, p_header);
+    #endif
+
+        // The event data stays in the queue until the handler returns.
+        p_header->handler(p_header + 1, p_header->event_data_size);
+
+        queue_entry_release(&m_queues[priority], entry_size(p_header->event_data_size), true);
+    }
+}
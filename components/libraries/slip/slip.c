@@ -10,6 +10,7 @@
  *
  */
  
+#include <string.h>
 #include "slip.h"
 #include "nrf_error.h"
 
@@ -18,30 +19,89 @@
 #define SLIP_ESC_END         0334    /* ESC ESC_END means END data byte */
 #define SLIP_ESC_ESC         0335    /* ESC ESC_ESC means ESC data byte */
 
+#define SLIP_WORD_HAS_ZERO_BYTE(word)  (((word) - 0x01010101uL) & ~(word) & 0x80808080uL)
+#define SLIP_WORD_HAS_BYTE(word, byte) SLIP_WORD_HAS_ZERO_BYTE((word) ^ (0x01010101uL * (byte)))
+
+
+/**@brief Function for getting the number of bytes before the first SLIP_END or SLIP_ESC byte.
+ *
+ * @details Bytes are tested one by one until the data is word aligned, then four bytes at a time.
+ *
+ * @param[in] p_data Pointer to the data.
+ * @param[in] length Length of the data.
+ *
+ * @return Number of bytes which can be copied without encoding or decoding.
+ */
+static uint32_t slip_plain_run_length_get(const uint8_t * p_data, uint32_t length)
+{
+    uint32_t index = 0;
+    uint32_t word;
+
+    while ((index < length) && ((((uintptr_t) &p_data[index]) & 0x03u) != 0))
+    {
+        if ((p_data[index] == SLIP_END) || (p_data[index] == SLIP_ESC))
+        {
+            return index;
+        }
+        index++;
+    }
+
+    while ((length - index) >= sizeof(uint32_t))
+    {
+        // Aligned, so the copy compiles to a single load, without breaking strict aliasing.
+        memcpy(&word, &p_data[index], sizeof(word));
+
+        if (SLIP_WORD_HAS_BYTE(word, SLIP_END) || SLIP_WORD_HAS_BYTE(word, SLIP_ESC))
+        {
+            break;
+        }
+        index += sizeof(uint32_t);
+    }
+
+    while ((index < length) && (p_data[index] != SLIP_END) && (p_data[index] != SLIP_ESC))
+    {
+        index++;
+    }
+
+    return index;
+}
+
 
 uint32_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_length, uint32_t output_buffer_length)
 {
-    uint32_t input_index;
-    uint32_t output_index;
-    
-    for (input_index = 0, output_index = 0; input_index < input_length && output_index < output_buffer_length; input_index++)
+    uint32_t input_index  = 0;
+    uint32_t output_index = 0;
+    uint32_t run_length;
+
+    while (input_index < input_length)
     {
-        switch (p_input[input_index])
+        // Copy bytes which do not need encoding at once.
+        run_length = slip_plain_run_length_get(&p_input[input_index], input_length - input_index);
+
+        if (run_length > (output_buffer_length - output_index))
         {
-            case SLIP_END:
-                p_output[output_index++] = SLIP_END;
-                p_output[output_index++] = SLIP_ESC_END;
-                break;
-            
-            case SLIP_ESC:
-                p_output[output_index++] = SLIP_ESC;
-                p_output[output_index++] = SLIP_ESC_ESC;
-                break;
-                
-            default:
-                p_output[output_index++] = p_input[input_index];
+            return 0;
+        }
+        memcpy(&p_output[output_index], &p_input[input_index], run_length);
+        input_index  += run_length;
+        output_index += run_length;
+
+        if (input_index < input_length)
+        {
+            if ((output_buffer_length - output_index) < 2)
+            {
+                return 0;
+            }
+            p_output[output_index++] = SLIP_ESC;
+            p_output[output_index++] = (p_input[input_index++] == SLIP_END) ? SLIP_ESC_END :
+                                                                              SLIP_ESC_ESC;
         }
     }
+
+    if ((output_buffer_length - output_index) < 2)
+    {
+        return 0;
+    }
     p_output[output_index++] = (uint8_t)SLIP_END;
     p_output[output_index++] = (uint8_t)SLIP_END; // clarify that the packet has ended.
     
@@ -60,7 +120,7 @@ uint32_t slip_decoding_add_char(uint8_t c, buffer_t * p_buf, slip_state_t * curr
             }
             else if (c == SLIP_ESC)
             {
-                *current_state = SLIP_END_RECEIVED;
+                *current_state = SLIP_ESC_RECEIVED;
             }
             else 
             {
@@ -76,6 +136,12 @@ uint32_t slip_decoding_add_char(uint8_t c, buffer_t * p_buf, slip_state_t * curr
                 p_buf->current_length++;  
                 *current_state = SLIP_DECODING;                
             }
+            else if (c == SLIP_ESC_END)
+            {
+                p_buf->p_buffer[p_buf->current_index++] = SLIP_END;
+                p_buf->current_length++;
+                *current_state = SLIP_DECODING;
+            }
             else
             {
                 // violation of protocol
@@ -110,3 +176,106 @@ uint32_t slip_decoding_add_char(uint8_t c, buffer_t * p_buf, slip_state_t * curr
     } 
     return NRF_ERROR_BUSY;
 }
+
+
+uint32_t slip_decode_bulk(const uint8_t * p_input,
+                          uint32_t        input_length,
+                          uint32_t      * p_input_used,
+                          buffer_t      * p_buf,
+                          slip_state_t  * current_state)
+{
+    uint32_t index    = 0;
+    uint32_t err_code = NRF_ERROR_BUSY;
+    uint32_t run_length;
+    uint8_t  c;
+
+    while ((index < input_length) && (err_code == NRF_ERROR_BUSY))
+    {
+        switch (*current_state)
+        {
+            case SLIP_ESC_RECEIVED:
+                c = p_input[index++];
+                if ((c != SLIP_ESC_END) && (c != SLIP_ESC_ESC))
+                {
+                    // violation of protocol
+                    *current_state = SLIP_CLEARING_INVALID_PACKET;
+                    err_code       = NRF_ERROR_INVALID_DATA;
+                }
+                else if (p_buf->current_index >= p_buf->len)
+                {
+                    *current_state = SLIP_CLEARING_INVALID_PACKET;
+                    err_code       = NRF_ERROR_NO_MEM;
+                }
+                else
+                {
+                    p_buf->p_buffer[p_buf->current_index++] = (c == SLIP_ESC_END) ? SLIP_END :
+                                                                                    SLIP_ESC;
+                    p_buf->current_length++;
+                    *current_state = SLIP_DECODING;
+                }
+                break;
+
+            case SLIP_CLEARING_INVALID_PACKET:
+                index += slip_plain_run_length_get(&p_input[index], input_length - index);
+                if ((index < input_length) && (p_input[index++] == SLIP_END))
+                {
+                    *current_state        = SLIP_DECODING;
+                    p_buf->current_index  = 0;
+                    p_buf->current_length = 0;
+                }
+                break;
+
+            case SLIP_END_RECEIVED:
+                // As in slip_decoding_add_char, SLIP_END SLIP_ESC_END is an END data byte, as sent
+                // by the previous encoder. Any other byte ends the packet, and is consumed with the
+                // SLIP_END, as the encoder ends packets with two SLIP_END bytes.
+                c              = p_input[index++];
+                *current_state = SLIP_DECODING;
+                if (c != SLIP_ESC_END)
+                {
+                    if (p_buf->current_index > 0)
+                    {
+                        err_code = NRF_SUCCESS;
+                    }
+                }
+                else if (p_buf->current_index >= p_buf->len)
+                {
+                    *current_state = SLIP_CLEARING_INVALID_PACKET;
+                    err_code       = NRF_ERROR_NO_MEM;
+                }
+                else
+                {
+                    p_buf->p_buffer[p_buf->current_index++] = SLIP_END;
+                    p_buf->current_length++;
+                }
+                break;
+
+            case SLIP_DECODING:
+            default:
+                *current_state = SLIP_DECODING;
+
+                // Copy bytes which do not need decoding at once.
+                run_length = slip_plain_run_length_get(&p_input[index], input_length - index);
+                if (run_length > (p_buf->len - p_buf->current_index))
+                {
+                    *current_state = SLIP_CLEARING_INVALID_PACKET;
+                    err_code       = NRF_ERROR_NO_MEM;
+                    break;
+                }
+                memcpy(&p_buf->p_buffer[p_buf->current_index], &p_input[index], run_length);
+                p_buf->current_index  += run_length;
+                p_buf->current_length += run_length;
+                index                 += run_length;
+
+                if (index < input_length)
+                {
+                    *current_state = (p_input[index++] == SLIP_ESC) ? SLIP_ESC_RECEIVED :
+                                                                      SLIP_END_RECEIVED;
+                }
+                break;
+        }
+    }
+
+    *p_input_used = index;
+    return err_code;
+}
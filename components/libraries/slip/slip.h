@@ -43,9 +43,11 @@ typedef struct {
   
 /**@brief Encodes a slip packet.
  * 
- * @details Note that the encoded output data will be longer than the input data. 
+ * @details Note that the encoded output data will be longer than the input data. Runs of bytes which
+ *          do not need escaping are found a word at a time and copied with memcpy.
  *
  * @retval The length of the encoded packet. If it is smaller than the input length, an error has occurred. 
+ *         0 is returned if the encoded packet does not fit in the output buffer.
  */
 uint32_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_length, uint32_t output_buffer_length);
 
@@ -60,6 +62,36 @@ uint32_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_leng
  */
 uint32_t slip_decoding_add_char(uint8_t c, buffer_t * p_buf, slip_state_t * current_state);
 
+/**@brief Decodes a chunk of slip encoded data, e.g. a whole DMA buffer.
+ *
+ * @details Runs of bytes which do not need decoding are found a word at a time and copied with
+ *          memcpy. Decoding stops at the end of a packet; the remaining input must be passed in the
+ *          next call. As in @ref slip_decoding_add_char, a packet ends with the byte after a
+ *          SLIP_END, which is consumed with it, unless that byte is SLIP_ESC_END: SLIP_END
+ *          SLIP_ESC_END is an END data byte, as sent by the previous encoder. A packet is
+ *          therefore only reported once the byte after its SLIP_END has been received. Packets
+ *          with no data are skipped. The decoded packet is stored in p_buf->p_buffer, which can
+ *          hold p_buf->len bytes. Initial state must be set to SLIP_DECODING. Do not mix calls
+ *          to this function and @ref slip_decoding_add_char for the same packet.
+ *
+ * @param[in]  p_input       Encoded data.
+ * @param[in]  input_length  Length of the encoded data.
+ * @param[out] p_input_used  Number of bytes of the encoded data that have been processed.
+ * @param[in]  p_buf         Buffer for the decoded packet.
+ * @param[in]  current_state Decoding state preserved between calls.
+ *
+ * @retval NRF_SUCCESS when a packet is parsed. The length of the packet can be read out from p_buf->current_index
+ * @retval NRF_ERROR_BUSY when all input is processed and the packet is not finished
+ * @retval NRF_ERROR_INVALID_DATA when packet is encoded wrong.
+ * @retval NRF_ERROR_NO_MEM when packet does not fit in the buffer.
+ *         On errors the decoding moves to SLIP_CLEARING_INVALID_PACKET, and will stay in this state until SLIP_END is encountered.
+ */
+uint32_t slip_decode_bulk(const uint8_t * p_input,
+                          uint32_t        input_length,
+                          uint32_t      * p_input_used,
+                          buffer_t      * p_buf,
+                          slip_state_t  * current_state);
+
 
 #endif // SLIP_H__
 
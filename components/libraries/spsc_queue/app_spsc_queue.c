@@ -0,0 +1,147 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_spsc_queue.h"
+#include <string.h>
+#include "nrf.h"
+#include "nrf_error.h"
+#include "sdk_common.h"
+
+#define RECORD_HEADER_SIZE      sizeof(uint32_t)                                        /**< Size of the length word of a record. */
+#define WORD_ALIGNED_LEN(LEN)   (CEIL_DIV((LEN), sizeof(uint32_t)) * sizeof(uint32_t))  /**< Length rounded up to whole words. */
+
+/**@brief Barrier between accessing the records and publishing a new position.
+ *
+ * @details Also keeps the compiler from moving record accesses across the position update.
+ */
+#define SPSC_BARRIER()          __DMB()
+
+
+/**@brief Function for moving a position forward by a number of bytes. */
+static __INLINE uint32_t pos_advance(app_spsc_queue_t const * p_queue, uint32_t pos, uint32_t len)
+{
+    pos += len;
+    return (pos >= 2 * p_queue->size) ? (pos - 2 * p_queue->size) : pos;
+}
+
+
+/**@brief Function for getting the buffer offset of a position. */
+static __INLINE uint32_t pos_offset(app_spsc_queue_t const * p_queue, uint32_t pos)
+{
+    return (pos >= p_queue->size) ? (pos - p_queue->size) : pos;
+}
+
+
+/**@brief Function for getting the number of bytes between two positions. */
+static __INLINE uint32_t pos_distance(app_spsc_queue_t const * p_queue, uint32_t rd, uint32_t wr)
+{
+    return (wr >= rd) ? (wr - rd) : (wr + 2 * p_queue->size - rd);
+}
+
+
+/**@brief Function for copying data into the buffer, wrapping around its end. */
+static void buf_write(app_spsc_queue_t * p_queue, uint32_t offset, void const * p_data, uint32_t len)
+{
+    uint32_t const first = MIN(len, p_queue->size - offset);
+
+    memcpy(&p_queue->p_buf[offset], p_data, first);
+    memcpy(p_queue->p_buf, (uint8_t const *)p_data + first, len - first);
+}
+
+
+/**@brief Function for copying data out of the buffer, wrapping around its end. */
+static void buf_read(app_spsc_queue_t const * p_queue, uint32_t offset, void * p_data, uint32_t len)
+{
+    uint32_t const first = MIN(len, p_queue->size - offset);
+
+    memcpy(p_data, &p_queue->p_buf[offset], first);
+    memcpy((uint8_t *)p_data + first, p_queue->p_buf, len - first);
+}
+
+
+ret_code_t app_spsc_queue_init(app_spsc_queue_t * p_queue, void * p_buf, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_queue);
+    VERIFY_PARAM_NOT_NULL(p_buf);
+
+    if (!is_word_aligned(p_buf) || (size == 0) || ((size % sizeof(uint32_t)) != 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_queue->p_buf = p_buf;
+    p_queue->size  = size;
+    p_queue->wr    = 0;
+    p_queue->rd    = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_spsc_queue_put(app_spsc_queue_t * p_queue, void const * p_data, uint16_t len)
+{
+    uint32_t const wr      = p_queue->wr;
+    uint32_t const rec_len = RECORD_HEADER_SIZE + WORD_ALIGNED_LEN(len);
+    uint32_t const header  = len;
+
+    if (rec_len > p_queue->size - pos_distance(p_queue, p_queue->rd, wr))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // Records are made of whole words, so the length word never wraps around.
+    buf_write(p_queue, pos_offset(p_queue, wr), &header, RECORD_HEADER_SIZE);
+    buf_write(p_queue, pos_offset(p_queue, pos_advance(p_queue, wr, RECORD_HEADER_SIZE)),
+              p_data, len);
+
+    SPSC_BARRIER();
+    p_queue->wr = pos_advance(p_queue, wr, rec_len);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_spsc_queue_get(app_spsc_queue_t * p_queue, void * p_data, uint16_t * p_len)
+{
+    uint32_t const rd = p_queue->rd;
+    uint32_t       header;
+
+    if (rd == p_queue->wr)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    SPSC_BARRIER();
+
+    buf_read(p_queue, pos_offset(p_queue, rd), &header, RECORD_HEADER_SIZE);
+
+    if (header > *p_len)
+    {
+        *p_len = (uint16_t)header;
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    buf_read(p_queue, pos_offset(p_queue, pos_advance(p_queue, rd, RECORD_HEADER_SIZE)),
+             p_data, header);
+    *p_len = (uint16_t)header;
+
+    SPSC_BARRIER();
+    p_queue->rd = pos_advance(p_queue, rd,
+                              RECORD_HEADER_SIZE + WORD_ALIGNED_LEN(header));
+
+    return NRF_SUCCESS;
+}
+
+
+bool app_spsc_queue_is_empty(app_spsc_queue_t const * p_queue)
+{
+    return (p_queue->rd == p_queue->wr);
+}
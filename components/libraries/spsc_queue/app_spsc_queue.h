@@ -0,0 +1,103 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_spsc_queue Single-producer single-consumer queue
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Lock-free queue of variable-size records, for one producer and one consumer.
+ *
+ * @details The producer and the consumer may run in different contexts, for example an interrupt
+ *          handler and the main loop, without disabling interrupts. Each of them must only be
+ *          used from one context at a time: the queue is not safe with two producers or two
+ *          consumers which can preempt each other.
+ *
+ *          A record takes a word for its length plus its data, rounded up to a whole number of
+ *          words. Records wrap around the end of the buffer, so no space is lost to padding.
+ */
+
+#ifndef APP_SPSC_QUEUE_H__
+#define APP_SPSC_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "app_util.h"
+
+/**@brief Queue instance.
+ *
+ * @details The positions run from zero to twice the buffer size, so that a full queue can be told
+ *          apart from an empty one without a shared element counter.
+ */
+typedef struct
+{
+    uint8_t          * p_buf;   /**< Queue buffer. */
+    uint32_t           size;    /**< Size of the buffer, in bytes. */
+    volatile uint32_t  wr;      /**< Write position. Only modified by the producer. */
+    volatile uint32_t  rd;      /**< Read position. Only modified by the consumer. */
+} app_spsc_queue_t;
+
+/**@brief Macro for computing the buffer size needed to hold a number of records.
+ *
+ * @param[in]   MAX_LEN     Maximum length of a record, in bytes.
+ * @param[in]   COUNT       Number of records of maximum length.
+ */
+#define APP_SPSC_QUEUE_BUF_SIZE(MAX_LEN, COUNT) ((COUNT) * (sizeof(uint32_t) * (1 + CEIL_DIV((MAX_LEN), sizeof(uint32_t)))))
+
+/**@brief Function for initializing a queue.
+ *
+ * @param[out] p_queue  Queue instance.
+ * @param[in]  p_buf    Buffer for the records. Must be word aligned.
+ * @param[in]  size     Size of the buffer, in bytes. Must be a non-zero multiple of four.
+ *
+ * @retval     NRF_SUCCESS              If the queue was initialized.
+ * @retval     NRF_ERROR_NULL           If a NULL pointer was passed.
+ * @retval     NRF_ERROR_INVALID_PARAM  If the buffer is not word aligned, or its size is invalid.
+ */
+ret_code_t app_spsc_queue_init(app_spsc_queue_t * p_queue, void * p_buf, uint32_t size);
+
+/**@brief Function for adding a record to the queue. Must only be called by the producer.
+ *
+ * @param[in]  p_queue  Queue instance.
+ * @param[in]  p_data   Data of the record.
+ * @param[in]  len      Length of the record, in bytes.
+ *
+ * @retval     NRF_SUCCESS          If the record was added.
+ * @retval     NRF_ERROR_NO_MEM     If there is not enough room for the record.
+ */
+ret_code_t app_spsc_queue_put(app_spsc_queue_t * p_queue, void const * p_data, uint16_t len);
+
+/**@brief Function for removing the oldest record from the queue. Must only be called by the
+ *        consumer.
+ *
+ * @param[in]    p_queue    Queue instance.
+ * @param[out]   p_data     Buffer for the data of the record.
+ * @param[inout] p_len      Size of @p p_data on input, length of the record on output.
+ *
+ * @retval     NRF_SUCCESS          If a record was removed.
+ * @retval     NRF_ERROR_NOT_FOUND  If the queue is empty.
+ * @retval     NRF_ERROR_DATA_SIZE  If the record does not fit in @p p_data. The record is left in
+ *                                  the queue, and its length is returned in @p p_len.
+ */
+ret_code_t app_spsc_queue_get(app_spsc_queue_t * p_queue, void * p_data, uint16_t * p_len);
+
+/**@brief Function for checking whether the queue is empty.
+ *
+ * @param[in]  p_queue  Queue instance.
+ */
+bool app_spsc_queue_is_empty(app_spsc_queue_t const * p_queue);
+
+#endif // APP_SPSC_QUEUE_H__
+
+/** @} */
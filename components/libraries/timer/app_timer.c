@@ -45,6 +45,32 @@ STATIC_ASSERT(RTC1_IRQ_PRI == SWI_IRQ_PRI);
 #define SWI_IRQHandler SWI0_EGU0_IRQHandler
 #endif
 
+#ifdef APP_TIMER_WITH_HEAP
+/**@brief Timer node type. The nodes of running timers form a pairing heap ordered by expiry time. */
+typedef struct timer_node_s
+{
+    uint32_t                    ticks_to_expire;                            /**< Number of ticks from previous timer interrupt to timer expiry. Once the timer is inserted, expiry time on the extended tick counter (see m_ticks_base). */
+    uint32_t                    ticks_at_start;                             /**< Current RTC counter value when the timer was started. */
+    uint32_t                    ticks_first_interval;                       /**< Number of ticks in the first timer interval. */
+    uint32_t                    ticks_periodic_interval;                    /**< Timer period (for repeating timers). */
+    bool                        is_running;                                 /**< True if timer is running, False otherwise. */
+    app_timer_mode_t            mode;                                       /**< Timer mode. */
+    uint8_t                     list;                                       /**< Structure that the node is in (see @ref timer_list_t). */
+    app_timer_timeout_handler_t p_timeout_handler;                          /**< Pointer to function to be executed when the timer expires. */
+    void *                      p_context;                                  /**< General purpose pointer. Will be passed to the timeout handler when the timer expires. */
+    struct timer_node_s *       next;                                       /**< Pointer to the next sibling in the heap, or to the next node in a list. */
+    struct timer_node_s *       child;                                      /**< Pointer to the first child in the heap. */
+    struct timer_node_s *       prev;                                       /**< Pointer to the previous sibling in the heap, or to the parent if the node is the first child. */
+} timer_node_t;
+
+/**@brief Structures a timer node can be in. */
+typedef enum
+{
+    TIMER_LIST_NONE,                                                        /**< The timer is not running. */
+    TIMER_LIST_HEAP,                                                        /**< The timer is in the heap of running timers. */
+    TIMER_LIST_EXPIRED                                                      /**< The timer has expired, but the timer list has not been updated yet. */
+} timer_list_t;
+#else
 /**@brief Timer node type. The nodes will be used form a linked list of running timers. */
 typedef struct
 {
@@ -58,6 +84,7 @@ typedef struct
     void *                      p_context;                                  /**< General purpose pointer. Will be passed to the timeout handler when the timer expires. */
     void *                      next;                                       /**< Pointer to the next node. */
 } timer_node_t;
+#endif
 
 STATIC_ASSERT(sizeof(timer_node_t) == APP_TIMER_NODE_SIZE);
 
@@ -134,6 +161,12 @@ static app_timer_evt_schedule_func_t m_evt_schedule_func;
 static bool                          m_rtc1_running;                            /**< Boolean indicating if RTC1 is running. */
 static bool                          m_rtc1_reset;                              /**< Boolean indicating if RTC1 counter has been reset due to last timer removed from timer list during the timer list handling. */
 
+#ifdef APP_TIMER_WITH_HEAP
+static uint32_t                      m_ticks_base;                              /**< Value of the extended tick counter at m_ticks_latest. Unlike the RTC counter, the extended counter wraps at 2^32, so that expiry times can be compared directly. */
+static timer_node_t *                mp_expired_head;                           /**< First timer in list of timers which have expired, but have not been removed from the timer list yet. */
+static timer_node_t *                mp_expired_tail;                           /**< Last timer in list of expired timers. */
+#endif
+
 #ifdef APP_TIMER_WITH_PROFILER
 static uint8_t                      m_max_user_op_queue_utilization;                  /**< Maximum observed timer user operations queue utilization. */
 #endif
@@ -220,6 +253,223 @@ static __INLINE void rtc1_compare0_set(uint32_t value)
 }
 
 
+#ifdef APP_TIMER_WITH_HEAP
+
+/**@brief Function for checking whether a timer expires before another one.
+ *
+ * @param[in]  p_a   Timer in the heap.
+ * @param[in]  p_b   Timer in the heap.
+ *
+ * @return     TRUE if p_a expires before p_b, FALSE otherwise.
+ */
+static __INLINE bool timer_expires_before(timer_node_t * p_a, timer_node_t * p_b)
+{
+    // The expiry times of running timers are never more than MAX_RTC_COUNTER_VAL apart.
+    return ((int32_t)(p_a->ticks_to_expire - p_b->ticks_to_expire) < 0);
+}
+
+
+/**@brief Function for melding two heaps.
+ *
+ * @param[in]  p_a   Root of the first heap, or NULL.
+ * @param[in]  p_b   Root of the second heap, or NULL.
+ *
+ * @return     Root of the resulting heap.
+ */
+static timer_node_t * timer_heap_meld(timer_node_t * p_a, timer_node_t * p_b)
+{
+    if (p_a == NULL)
+    {
+        return p_b;
+    }
+    if (p_b == NULL)
+    {
+        return p_a;
+    }
+
+    if (timer_expires_before(p_b, p_a))
+    {
+        timer_node_t * p_tmp = p_a;
+
+        p_a = p_b;
+        p_b = p_tmp;
+    }
+
+    // Make p_b the first child of p_a.
+    p_b->prev = p_a;
+    p_b->next = p_a->child;
+
+    if (p_a->child != NULL)
+    {
+        p_a->child->prev = p_b;
+    }
+
+    p_a->child = p_b;
+
+    return p_a;
+}
+
+
+/**@brief Function for melding a list of sibling heaps into one heap, using the two-pass method.
+ *
+ * @param[in]  p_first   First heap in the list of siblings, or NULL.
+ *
+ * @return     Root of the resulting heap.
+ */
+static timer_node_t * timer_heap_merge_pairs(timer_node_t * p_first)
+{
+    timer_node_t * p_pairs = NULL;
+    timer_node_t * p_root  = NULL;
+
+    // Meld the heaps in pairs from left to right, and stack the results.
+    while (p_first != NULL)
+    {
+        timer_node_t * p_a = p_first;
+        timer_node_t * p_b = p_a->next;
+
+        p_first   = (p_b != NULL) ? p_b->next : NULL;
+        p_a->next = NULL;
+        p_a->prev = NULL;
+
+        if (p_b != NULL)
+        {
+            p_b->next = NULL;
+            p_b->prev = NULL;
+        }
+
+        p_a       = timer_heap_meld(p_a, p_b);
+        p_a->next = p_pairs;
+        p_pairs   = p_a;
+    }
+
+    // Meld the stacked pairs from right to left.
+    while (p_pairs != NULL)
+    {
+        timer_node_t * p_next = p_pairs->next;
+
+        p_pairs->next = NULL;
+        p_root        = timer_heap_meld(p_root, p_pairs);
+        p_pairs       = p_next;
+    }
+
+    return p_root;
+}
+
+
+/**@brief Function for removing the timer which expires first from the heap.
+ *
+ * @return     Timer removed from the heap.
+ */
+static timer_node_t * timer_heap_pop(void)
+{
+    timer_node_t * p_timer = mp_timer_id_head;
+
+    mp_timer_id_head = timer_heap_merge_pairs(p_timer->child);
+    p_timer->child   = NULL;
+    p_timer->list    = TIMER_LIST_NONE;
+
+    return p_timer;
+}
+
+
+/**@brief Function for inserting a timer in the timer heap.
+ *
+ * @param[in]  p_timer   Timer to insert. Its ticks_to_expire field holds the number of ticks from
+ *                       m_ticks_latest to timer expiry.
+ */
+static void timer_list_insert(timer_node_t * p_timer)
+{
+    // Convert to the extended tick counter.
+    p_timer->ticks_to_expire += m_ticks_base;
+
+    p_timer->next    = NULL;
+    p_timer->prev    = NULL;
+    p_timer->child   = NULL;
+    p_timer->list    = TIMER_LIST_HEAP;
+    mp_timer_id_head = timer_heap_meld(mp_timer_id_head, p_timer);
+}
+
+
+/**@brief Function for removing a timer from the timer heap or from the list of expired timers.
+ *
+ * @param[in]  p_timer   Timer to remove.
+ */
+static void timer_list_remove(timer_node_t * p_timer)
+{
+    if (p_timer->list == TIMER_LIST_HEAP)
+    {
+        if (p_timer == mp_timer_id_head)
+        {
+            (void)timer_heap_pop();
+        }
+        else
+        {
+            // Cut the timer from its parent and siblings, and meld its children back into the heap.
+            if (p_timer->prev->child == p_timer)
+            {
+                p_timer->prev->child = p_timer->next;
+            }
+            else
+            {
+                p_timer->prev->next = p_timer->next;
+            }
+
+            if (p_timer->next != NULL)
+            {
+                p_timer->next->prev = p_timer->prev;
+            }
+
+            mp_timer_id_head = timer_heap_meld(mp_timer_id_head,
+                                               timer_heap_merge_pairs(p_timer->child));
+            p_timer->child   = NULL;
+        }
+    }
+    else if (p_timer->list == TIMER_LIST_EXPIRED)
+    {
+        timer_node_t * p_previous = NULL;
+        timer_node_t * p_current  = mp_expired_head;
+
+        while (p_current != p_timer)
+        {
+            p_previous = p_current;
+            p_current  = p_current->next;
+        }
+
+        if (p_previous == NULL)
+        {
+            mp_expired_head = p_timer->next;
+        }
+        else
+        {
+            p_previous->next = p_timer->next;
+        }
+
+        if (mp_expired_tail == p_timer)
+        {
+            mp_expired_tail = p_previous;
+        }
+    }
+    else
+    {
+        // Timer not in active list.
+        return;
+    }
+
+    p_timer->list = TIMER_LIST_NONE;
+    p_timer->next = NULL;
+    p_timer->prev = NULL;
+
+    // No more timers in the list. Reset RTC1 in case Start timer operations are present in the queue.
+    if ((mp_timer_id_head == NULL) && (mp_expired_head == NULL))
+    {
+        NRF_RTC1->TASKS_CLEAR = 1;
+        m_ticks_latest        = 0;
+        m_rtc1_reset          = true;
+    }
+}
+
+#else
+
 /**@brief Function for inserting a timer in the timer list.
  *
  * @param[in]  timer_id   Id of timer to insert.
@@ -327,6 +577,8 @@ static void timer_list_remove(timer_node_t * p_timer)
     }
 }
 
+#endif
+
 
 /**@brief Function for scheduling a check for timeouts by generating a RTC1 interrupt.
  */
@@ -363,6 +615,49 @@ static void timeout_handler_exec(timer_node_t * p_timer)
 }
 
 
+#ifdef APP_TIMER_WITH_HEAP
+/**@brief Function for moving expired timers from the timer heap to the list of expired timers, and
+ *        executing their timeout handlers.
+ *
+ * @return     Number of ticks from m_ticks_latest to the expiry of the last expired timer.
+ */
+static uint32_t timer_heap_timeouts_check(void)
+{
+    // Current value of the extended tick counter.
+    uint32_t const ticks_now = m_ticks_base + ticks_diff_get(rtc1_counter_get(), m_ticks_latest);
+
+    while ((mp_timer_id_head != NULL) &&
+           ((int32_t)(ticks_now - mp_timer_id_head->ticks_to_expire) >= 0))
+    {
+        timer_node_t * p_timer = timer_heap_pop();
+
+        // Append to the list of expired timers, which is kept in order of expiry.
+        p_timer->list = TIMER_LIST_EXPIRED;
+        p_timer->next = NULL;
+
+        if (mp_expired_tail != NULL)
+        {
+            mp_expired_tail->next = p_timer;
+        }
+        else
+        {
+            mp_expired_head = p_timer;
+        }
+        mp_expired_tail = p_timer;
+
+        // Execute Task.
+        if (p_timer->is_running)
+        {
+            p_timer->is_running = false;
+            timeout_handler_exec(p_timer);
+        }
+    }
+
+    return (mp_expired_tail != NULL) ? (mp_expired_tail->ticks_to_expire - m_ticks_base) : 0;
+}
+#endif
+
+
 /**@brief Function for checking for expired timers.
  */
 static void timer_timeouts_check(void)
@@ -370,6 +665,11 @@ static void timer_timeouts_check(void)
     // Handle expired of timer 
     if (mp_timer_id_head != NULL)
     {
+#ifdef APP_TIMER_WITH_HEAP
+        uint32_t        ticks_expired;
+
+        ticks_expired = timer_heap_timeouts_check();
+#else
         timer_node_t *  p_timer;
         timer_node_t *  p_previous_timer;
         uint32_t        ticks_elapsed;
@@ -408,6 +708,7 @@ static void timer_timeouts_check(void)
                 timeout_handler_exec(p_previous_timer);
             }
         }
+#endif
 
         // Prepare to queue the ticks expired in the m_ticks_elapsed queue.
         if (m_ticks_elapsed_q_read_ind == m_ticks_elapsed_q_write_ind)
@@ -455,6 +756,9 @@ static bool elapsed_ticks_acquire(uint32_t * p_ticks_elapsed)
 
         m_ticks_latest += *p_ticks_elapsed;
         m_ticks_latest &= MAX_RTC_COUNTER_VAL;
+#ifdef APP_TIMER_WITH_HEAP
+        m_ticks_base   += *p_ticks_elapsed;
+#endif
 
         return true;
     }
@@ -505,6 +809,21 @@ static bool list_deletions_handler(void)
                     
                 case TIMER_USER_OP_TYPE_STOP_ALL:
                     // Delete list of running timers, and mark all timers as not running.
+#ifdef APP_TIMER_WITH_HEAP
+                    while (mp_timer_id_head != NULL)
+                    {
+                        timer_heap_pop()->is_running = false;
+                    }
+                    while (mp_expired_head != NULL)
+                    {
+                        timer_node_t * p_head = mp_expired_head;
+
+                        p_head->is_running = false;
+                        p_head->list       = TIMER_LIST_NONE;
+                        mp_expired_head    = p_head->next;
+                    }
+                    mp_expired_tail = NULL;
+#else
                     while (mp_timer_id_head != NULL)
                     {
                         timer_node_t * p_head = mp_timer_id_head;
@@ -512,6 +831,7 @@ static bool list_deletions_handler(void)
                         p_head->is_running = false;
                         mp_timer_id_head    = p_head->next;
                     }
+#endif
                     break;
                     
                 default:
@@ -526,6 +846,45 @@ static bool list_deletions_handler(void)
 }
 
 
+#ifdef APP_TIMER_WITH_HEAP
+/**@brief Function for updating the timer list for expired timers.
+ *
+ * @param[in]  ticks_elapsed         Number of elapsed ticks.
+ * @param[in]  ticks_previous        Previous known value of the RTC counter.
+ * @param[out] p_restart_list_head   List of repeating timers to be restarted.
+ */
+static void expired_timers_handler(uint32_t         ticks_elapsed,
+                                   uint32_t         ticks_previous,
+                                   timer_node_t **  p_restart_list_head)
+{
+    // Value of the extended tick counter at ticks_previous. All timers in the list of expired
+    // timers expired within ticks_elapsed from it.
+    uint32_t const ticks_base_previous = m_ticks_base - ticks_elapsed;
+
+    while (mp_expired_head != NULL)
+    {
+        timer_node_t * p_timer = mp_expired_head;
+        uint32_t       ticks_expired;
+
+        ticks_expired   = p_timer->ticks_to_expire - ticks_base_previous;
+        mp_expired_head = p_timer->next;
+
+        p_timer->list            = TIMER_LIST_NONE;
+        p_timer->ticks_to_expire = 0;
+
+        // Timer will be restarted if periodic.
+        if (p_timer->ticks_periodic_interval != 0)
+        {
+            p_timer->ticks_at_start       = (ticks_previous + ticks_expired) & MAX_RTC_COUNTER_VAL;
+            p_timer->ticks_first_interval = p_timer->ticks_periodic_interval;
+            p_timer->next                 = *p_restart_list_head;
+            *p_restart_list_head          = p_timer;
+        }
+    }
+
+    mp_expired_tail = NULL;
+}
+#else
 /**@brief Function for updating the timer list for expired timers.
  *
  * @param[in]  ticks_elapsed         Number of elapsed ticks.
@@ -574,6 +933,7 @@ static void expired_timers_handler(uint32_t         ticks_elapsed,
         }
     }
 }
+#endif
 
 
 /**@brief Function for handling timer list insertions.
@@ -679,7 +1039,11 @@ static void compare_reg_update(timer_node_t * p_timer_id_head_old)
     // Setup the timeout for timers on the head of the list 
     if (mp_timer_id_head != NULL)
     {
+#ifdef APP_TIMER_WITH_HEAP
+        uint32_t ticks_to_expire = mp_timer_id_head->ticks_to_expire - m_ticks_base;
+#else
         uint32_t ticks_to_expire = mp_timer_id_head->ticks_to_expire;
+#endif
         uint32_t pre_counter_val = rtc1_counter_get();
         uint32_t cc              = m_ticks_latest;
         uint32_t ticks_elapsed   = ticks_diff_get(pre_counter_val, cc) + RTC_COMPARE_OFFSET_MIN;
@@ -995,6 +1359,10 @@ uint32_t app_timer_init(uint32_t                      prescaler,
     }
 
     mp_timer_id_head             = NULL;
+#ifdef APP_TIMER_WITH_HEAP
+    mp_expired_head              = NULL;
+    mp_expired_tail              = NULL;
+#endif
     m_ticks_elapsed_q_read_ind  = 0;
     m_ticks_elapsed_q_write_ind = 0;
 
@@ -35,6 +35,13 @@
  *          @ref app_scheduler should be used or not. Even if the scheduler is 
  *          not used, app_timer.h will include app_scheduler.h, so when
  *          compiling, app_scheduler.h must be available in one of the compiler include paths.
+ *
+ * @details By default, running timers are kept in a list sorted by expiry time, so starting a
+ *          timer takes time proportional to the number of running timers. Define
+ *          APP_TIMER_WITH_HEAP to keep them in a pairing heap instead, which makes starting a
+ *          timer take constant time and stopping a timer or handling a time-out take logarithmic
+ *          time (amortized), at the cost of 8 bytes of RAM per timer. This is worthwhile when many
+ *          timers run concurrently. APP_TIMER_WITH_HEAP is only supported by app_timer.c.
  */
 
 #ifndef APP_TIMER_H__
@@ -50,9 +57,24 @@
 #define APP_TIMER_CLOCK_FREQ         32768                      /**< Clock frequency of the RTC timer used to implement the app timer module. */
 #define APP_TIMER_MIN_TIMEOUT_TICKS  5                          /**< Minimum value of the timeout_ticks parameter of app_timer_start(). */
 
+#if defined(HOST_BUILD)
+// Sizes with the 64-bit pointers of the host (Linux) test builds.
+#ifdef APP_TIMER_WITH_HEAP
+#define APP_TIMER_NODE_SIZE          72                         /**< Size of app_timer.timer_node_t (used to allocate data). */
+#else
+#define APP_TIMER_NODE_SIZE          48                         /**< Size of app_timer.timer_node_t (used to allocate data). */
+#endif
+#define APP_TIMER_USER_OP_SIZE       40                         /**< Size of app_timer.timer_user_op_t (only for use inside APP_TIMER_BUF_SIZE()). */
+#define APP_TIMER_USER_SIZE          16                         /**< Size of app_timer.timer_user_t (only for use inside APP_TIMER_BUF_SIZE()). */
+#else
+#ifdef APP_TIMER_WITH_HEAP
+#define APP_TIMER_NODE_SIZE          40                         /**< Size of app_timer.timer_node_t (used to allocate data). */
+#else
 #define APP_TIMER_NODE_SIZE          32                         /**< Size of app_timer.timer_node_t (used to allocate data). */
+#endif
 #define APP_TIMER_USER_OP_SIZE       24                         /**< Size of app_timer.timer_user_op_t (only for use inside APP_TIMER_BUF_SIZE()). */
 #define APP_TIMER_USER_SIZE          8                          /**< Size of app_timer.timer_user_t (only for use inside APP_TIMER_BUF_SIZE()). */
+#endif
 #define APP_TIMER_INT_LEVELS         3                          /**< Number of interrupt levels from where timer operations may be initiated (only for use inside APP_TIMER_BUF_SIZE()). */
 
 /**@brief Compute number of bytes required to hold the application timer data structures.
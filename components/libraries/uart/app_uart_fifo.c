@@ -26,11 +26,37 @@ static __INLINE uint32_t fifo_length(app_fifo_t * const fifo)
 
 
 static app_uart_event_handler_t   m_event_handler;            /**< Event handler function. */
-static uint8_t tx_buffer[1];
 static uint8_t rx_buffer[1];
 
 static app_fifo_t                  m_rx_fifo;                               /**< RX FIFO buffer for storing data received on the UART until the application fetches them using app_uart_get(). */
 static app_fifo_t                  m_tx_fifo;                               /**< TX FIFO buffer for storing data to be transmitted on the UART when TXD is ready. Data is put to the buffer on using app_uart_put(). */
+static uint32_t                    m_tx_in_flight;                          /**< Number of bytes of the TX FIFO being transmitted. Released from the FIFO when the transmission has finished, unless the FIFO was flushed in between. */
+
+/**@brief Function for starting the transmission of the oldest contiguous data in the TX FIFO.
+ *
+ * @details The data is transmitted directly from the FIFO buffer and stays in the FIFO until
+ *          the transmission has finished.
+ */
+static uint32_t tx_start(void)
+{
+    uint8_t  * p_data;
+    uint32_t   size;
+    uint32_t   err_code;
+
+    err_code = app_fifo_read_span_get(&m_tx_fifo, &p_data, &size);
+    if (err_code == NRF_SUCCESS)
+    {
+        size           = MIN(size, UINT8_MAX);
+        m_tx_in_flight = size;
+        err_code       = nrf_drv_uart_tx(p_data, (uint8_t)size);
+        if (err_code != NRF_SUCCESS)
+        {
+            m_tx_in_flight = 0;
+        }
+    }
+
+    return err_code;
+}
 
 static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
 {
@@ -70,11 +96,12 @@ static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
     }
     else if (p_event->type == NRF_DRV_UART_EVT_TX_DONE)
     {
-        // Get next byte from FIFO.
-        if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
-        {
-            (void)nrf_drv_uart_tx(tx_buffer, 1);
-        }
+        // Release the transmitted bytes and start on the next ones. Nothing is released if the FIFO
+        // was flushed during the transmission.
+        (void)app_fifo_read_commit(&m_tx_fifo, MIN(p_event->data.rxtx.bytes, m_tx_in_flight));
+        m_tx_in_flight = 0;
+        (void)tx_start();
+
         if (FIFO_LENGTH(m_tx_fifo) == 0)
         {
             // Last byte from FIFO transmitted, notify the application.
@@ -136,7 +163,10 @@ uint32_t app_uart_flush(void)
     err_code = app_fifo_flush(&m_rx_fifo);
     VERIFY_SUCCESS(err_code);
 
-    err_code = app_fifo_flush(&m_tx_fifo);
+    CRITICAL_REGION_ENTER();
+    err_code       = app_fifo_flush(&m_tx_fifo);
+    m_tx_in_flight = 0;
+    CRITICAL_REGION_EXIT();
     VERIFY_SUCCESS(err_code);
 
     return NRF_SUCCESS;
@@ -170,14 +200,7 @@ uint32_t app_uart_put(uint8_t byte)
         // a new transmission here.
         if (!nrf_drv_uart_tx_in_progress())
         {
-            // This operation should be almost always successful, since we've
-            // just added a byte to FIFO, but if some bigger delay occurred
-            // (some heavy interrupt handler routine has been executed) since
-            // that time, FIFO might be empty already.
-            if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
-            {
-                err_code = nrf_drv_uart_tx(tx_buffer, 1);
-            }
+            err_code = tx_start();
         }
     }
 
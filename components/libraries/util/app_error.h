@@ -97,22 +97,22 @@ static __INLINE void app_error_log(uint32_t id, uint32_t pc, uint32_t info)
     {
         case NRF_FAULT_ID_SDK_ASSERT:
             NRF_LOG(NRF_LOG_COLOR_RED "\n*** ASSERTION FAILED ***\n");
-            if (((assert_info_t *)(info))->p_file_name)
+            if (((assert_info_t *)(uintptr_t)(info))->p_file_name)
             {
-                NRF_LOG_PRINTF(NRF_LOG_COLOR_WHITE "Line Number: %u\n", (unsigned int) ((assert_info_t *)(info))->line_num);
-                NRF_LOG_PRINTF("File Name:   %s\n", ((assert_info_t *)(info))->p_file_name);
+                NRF_LOG_PRINTF(NRF_LOG_COLOR_WHITE "Line Number: %u\n", (unsigned int) ((assert_info_t *)(uintptr_t)(info))->line_num);
+                NRF_LOG_PRINTF("File Name:   %s\n", ((assert_info_t *)(uintptr_t)(info))->p_file_name);
             }
             NRF_LOG_PRINTF(NRF_LOG_COLOR_DEFAULT "\n");
             break;
 
         case NRF_FAULT_ID_SDK_ERROR:
             NRF_LOG(NRF_LOG_COLOR_RED "\n*** APPLICATION ERROR *** \n" NRF_LOG_COLOR_WHITE);
-            if (((error_info_t *)(info))->p_file_name)
+            if (((error_info_t *)(uintptr_t)(info))->p_file_name)
             {
-                NRF_LOG_PRINTF("Line Number: %u\n", (unsigned int) ((error_info_t *)(info))->line_num);
-                NRF_LOG_PRINTF("File Name:   %s\n", ((error_info_t *)(info))->p_file_name);
+                NRF_LOG_PRINTF("Line Number: %u\n", (unsigned int) ((error_info_t *)(uintptr_t)(info))->line_num);
+                NRF_LOG_PRINTF("File Name:   %s\n", ((error_info_t *)(uintptr_t)(info))->p_file_name);
             }
-            NRF_LOG_PRINTF("Error Code:  0x%X\n" NRF_LOG_COLOR_DEFAULT "\n", (unsigned int) ((error_info_t *)(info))->err_code);
+            NRF_LOG_PRINTF("Error Code:  0x%X\n" NRF_LOG_COLOR_DEFAULT "\n", (unsigned int) ((error_info_t *)(uintptr_t)(info))->err_code);
             break;
     }
 }
@@ -137,14 +137,14 @@ static __INLINE void app_error_print(uint32_t id, uint32_t pc, uint32_t info)
     switch (id)
     {
         case NRF_FAULT_ID_SDK_ASSERT:
-            printf("Line Number: %u\r\n", tmp = ((assert_info_t *)(info))->line_num);
-            printf("File Name:   %s\r\n",       ((assert_info_t *)(info))->p_file_name);
+            printf("Line Number: %u\r\n", tmp = ((assert_info_t *)(uintptr_t)(info))->line_num);
+            printf("File Name:   %s\r\n",       ((assert_info_t *)(uintptr_t)(info))->p_file_name);
             break;
 
         case NRF_FAULT_ID_SDK_ERROR:
-            printf("Line Number: %u\r\n",   tmp = ((error_info_t *)(info))->line_num);
-            printf("File Name:   %s\r\n",         ((error_info_t *)(info))->p_file_name);
-            printf("Error Code:  0x%X\r\n", tmp = ((error_info_t *)(info))->err_code);
+            printf("Line Number: %u\r\n",   tmp = ((error_info_t *)(uintptr_t)(info))->line_num);
+            printf("File Name:   %s\r\n",         ((error_info_t *)(uintptr_t)(info))->p_file_name);
+            printf("Error Code:  0x%X\r\n", tmp = ((error_info_t *)(uintptr_t)(info))->err_code);
             break;
     }
 }
@@ -390,6 +390,160 @@ uint32_t log_raw_uart_read_input(char * c)
 
 #endif // NRF_LOG_USES_RAW_UART == 1
 
+#if (NRF_LOG_DEFERRED == 1) && \
+    ((NRF_LOG_USES_RTT == 1) || (NRF_LOG_USES_UART == 1) || (NRF_LOG_USES_RAW_UART == 1))
+
+#include "app_util_platform.h"
+
+#if (NRF_LOG_DEFERRED_BUFFER_SIZE & (NRF_LOG_DEFERRED_BUFFER_SIZE - 1)) != 0
+#error "NRF_LOG_DEFERRED_BUFFER_SIZE must be a power of two."
+#endif
+
+#if NRF_LOG_USES_RTT == 1
+#define LOG_BACKEND_PRINTF(term, fmt, a)        log_rtt_printf(term, (char *)fmt, a[0], a[1], a[2], a[3], a[4], a[5])
+#define LOG_BACKEND_STRING(term, n, a)          log_rtt_write_string(term, n, a[0], a[1], a[2], a[3], a[4], a[5], a[6])
+#define LOG_BACKEND_HEX(term, val)              log_rtt_write_hex(term, val)
+#define LOG_BACKEND_HEX_CHAR(term, val)         log_rtt_write_hex_char(term, (uint8_t)(val))
+#elif NRF_LOG_USES_UART == 1
+#define LOG_BACKEND_PRINTF(term, fmt, a)        log_uart_printf(fmt, a[0], a[1], a[2], a[3], a[4], a[5])
+#define LOG_BACKEND_STRING(term, n, a)          log_uart_write_string_many(n, a[0], a[1], a[2], a[3], a[4], a[5], a[6])
+#define LOG_BACKEND_HEX(term, val)              log_uart_write_hex(val)
+#define LOG_BACKEND_HEX_CHAR(term, val)         log_uart_write_hex_char((uint8_t)(val))
+#else
+#define LOG_BACKEND_PRINTF(term, fmt, a)        log_raw_uart_printf(fmt, a[0], a[1], a[2], a[3], a[4], a[5])
+#define LOG_BACKEND_STRING(term, n, a)          log_raw_uart_write_string_many(n, a[0], a[1], a[2], a[3], a[4], a[5], a[6])
+#define LOG_BACKEND_HEX(term, val)              log_raw_uart_write_hex(val)
+#define LOG_BACKEND_HEX_CHAR(term, val)         log_raw_uart_write_hex_char((uint8_t)(val))
+#endif
+
+#define LOG_DEFERRED_MASK           (NRF_LOG_DEFERRED_BUFFER_SIZE - 1)
+#define LOG_DEFERRED_VALID          (1UL << 31)     // Set in the header of a complete entry.
+#define LOG_DEFERRED_TERMINAL(hdr)  ((hdr) & 0x0F)
+#define LOG_DEFERRED_TYPE(hdr)      (((hdr) >> 4) & 0x0F)
+#define LOG_DEFERRED_NUM_ARGS(hdr)  (((hdr) >> 8) & 0xFF)
+
+// Entries are made of a header word, a string pointer word and the arguments. The buffer is shared
+// by all contexts which log: a writer reserves room for its entry in a short critical region, and
+// fills it outside of it. The header is written last, so that the reader only processes
+// complete entries, in order.
+static volatile uint32_t m_log_buf[NRF_LOG_DEFERRED_BUFFER_SIZE];
+static volatile uint32_t m_log_wr;          // Index of the next word to reserve.
+static volatile uint32_t m_log_rd;          // Index of the header of the oldest entry.
+static volatile uint32_t m_log_dropped;     // Number of entries dropped.
+
+void log_deferred_push(uint32_t header, char const * p_str, ...)
+{
+    uint32_t const num_args = LOG_DEFERRED_NUM_ARGS(header);
+    uint32_t const len      = num_args + 2;
+    uint32_t       idx;
+    bool           reserved = false;
+
+    CRITICAL_REGION_ENTER();
+    idx = m_log_wr;
+    if ((num_args <= NRF_LOG_DEFERRED_MAX_ARGS) &&
+        (NRF_LOG_DEFERRED_BUFFER_SIZE - (idx - m_log_rd) >= len))
+    {
+        // Mark the entry as incomplete, the word may hold data from an earlier entry.
+        m_log_buf[idx & LOG_DEFERRED_MASK] = 0;
+        m_log_wr = idx + len;
+        reserved = true;
+    }
+    else
+    {
+        m_log_dropped++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!reserved)
+    {
+        return;
+    }
+
+    m_log_buf[(idx + 1) & LOG_DEFERRED_MASK] = (uint32_t)(uintptr_t)p_str;
+
+    //lint -save -e526 -e628 -e530
+    va_list p_args;
+    va_start(p_args, p_str);
+    for (uint32_t i = 0; i < num_args; i++)
+    {
+        m_log_buf[(idx + 2 + i) & LOG_DEFERRED_MASK] = va_arg(p_args, uint32_t);
+    }
+    va_end(p_args);
+    //lint -restore
+
+    m_log_buf[idx & LOG_DEFERRED_MASK] = header | LOG_DEFERRED_VALID;
+}
+
+int log_deferred_process(void)
+{
+    uint32_t const idx = m_log_rd;
+    uint32_t       header;
+    char const   * p_str;
+    uint32_t       args[NRF_LOG_DEFERRED_MAX_ARGS] = {0};
+
+    if (idx == m_log_wr)
+    {
+        return 0;
+    }
+
+    header = m_log_buf[idx & LOG_DEFERRED_MASK];
+    if (!(header & LOG_DEFERRED_VALID))
+    {
+        // The oldest entry is still being written.
+        return 0;
+    }
+
+    p_str = (char const *)(uintptr_t)m_log_buf[(idx + 1) & LOG_DEFERRED_MASK];
+    for (uint32_t i = 0; i < LOG_DEFERRED_NUM_ARGS(header); i++)
+    {
+        args[i] = m_log_buf[(idx + 2 + i) & LOG_DEFERRED_MASK];
+    }
+
+    // Release the entry before writing it out, so that the backend's time is not spent with
+    // less room in the buffer.
+    m_log_rd = idx + LOG_DEFERRED_NUM_ARGS(header) + 2;
+
+    switch (LOG_DEFERRED_TYPE(header))
+    {
+        case LOG_DEFERRED_TYPE_PRINTF:
+            LOG_BACKEND_PRINTF(LOG_DEFERRED_TERMINAL(header), p_str, args);
+            break;
+
+        case LOG_DEFERRED_TYPE_STRING:
+        {
+            char const * strs[NRF_LOG_DEFERRED_MAX_ARGS + 1];
+
+            strs[0] = p_str;
+            for (uint32_t i = 0; i < NRF_LOG_DEFERRED_MAX_ARGS; i++)
+            {
+                strs[i + 1] = (char const *)(uintptr_t)args[i];
+            }
+            LOG_BACKEND_STRING(LOG_DEFERRED_TERMINAL(header), LOG_DEFERRED_NUM_ARGS(header) + 1, strs);
+            break;
+        }
+
+        case LOG_DEFERRED_TYPE_HEX:
+            LOG_BACKEND_HEX(LOG_DEFERRED_TERMINAL(header), args[0]);
+            break;
+
+        case LOG_DEFERRED_TYPE_HEX_CHAR:
+            LOG_BACKEND_HEX_CHAR(LOG_DEFERRED_TERMINAL(header), args[0]);
+            break;
+
+        default:
+            break;
+    }
+
+    return 1;
+}
+
+uint32_t log_deferred_dropped_get(void)
+{
+    return m_log_dropped;
+}
+
+#endif // NRF_LOG_DEFERRED == 1
+
 
 const char* log_hex_char(const char c)
 {
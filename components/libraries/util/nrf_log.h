@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <app_util.h>
 
 #ifndef NRF_LOG_USES_RTT
@@ -23,6 +24,34 @@
     #define NRF_LOG_USES_COLORS 1
 #endif
 
+#ifndef NRF_LOG_DEFERRED
+#define NRF_LOG_DEFERRED 0
+#endif
+
+#ifndef NRF_LOG_DEFERRED_BUFFER_SIZE
+#define NRF_LOG_DEFERRED_BUFFER_SIZE 128    /*!< Size of the deferred log buffer, in words. Must be a power of two. */
+#endif
+
+#define NRF_LOG_DEFERRED_MAX_ARGS   6       /*!< Maximum number of arguments of a deferred log entry. */
+
+#define NRF_LOG_LEVEL_NONE          0       /*!< No logging. */
+#define NRF_LOG_LEVEL_ERROR         1       /*!< Log the *_ERROR macros only. */
+#define NRF_LOG_LEVEL_INFO          2       /*!< Log the *_ERROR macros and the plain macros. */
+#define NRF_LOG_LEVEL_DEBUG         3       /*!< Log all macros. */
+
+#ifndef NRF_LOG_DEFAULT_LEVEL
+#ifdef DEBUG
+#define NRF_LOG_DEFAULT_LEVEL NRF_LOG_LEVEL_DEBUG
+#else
+#define NRF_LOG_DEFAULT_LEVEL NRF_LOG_LEVEL_INFO
+#endif
+#endif
+
+// Log level of the including module. Define it before including any header to override the default.
+#ifndef NRF_LOG_MODULE_LEVEL
+#define NRF_LOG_MODULE_LEVEL NRF_LOG_DEFAULT_LEVEL
+#endif
+
 #if NRF_LOG_USES_COLORS == 1
     #define NRF_LOG_COLOR_DEFAULT  "\x1B[0m"
     #define NRF_LOG_COLOR_BLACK    "\x1B[1;30m"
@@ -580,6 +609,145 @@ uint32_t log_raw_uart_read_input(char* p_char);
 
 #endif
 
+#if (NRF_LOG_DEFERRED != 1) && !defined(DOXYGEN)
+
+// Macros above the log level of the module generate no code.
+
+#if NRF_LOG_MODULE_LEVEL < NRF_LOG_LEVEL_DEBUG
+#undef NRF_LOG_PRINTF_DEBUG
+#define NRF_LOG_PRINTF_DEBUG(...)
+#undef NRF_LOG_DEBUG
+#define NRF_LOG_DEBUG(...)
+#undef NRF_LOG_HEX_DEBUG
+#define NRF_LOG_HEX_DEBUG(val)
+#undef NRF_LOG_HEX_CHAR_DEBUG
+#define NRF_LOG_HEX_CHAR_DEBUG(val)
+#endif
+
+#if NRF_LOG_MODULE_LEVEL < NRF_LOG_LEVEL_INFO
+#undef NRF_LOG_PRINTF
+#define NRF_LOG_PRINTF(...)
+#undef NRF_LOG
+#define NRF_LOG(...)
+#undef NRF_LOG_HEX
+#define NRF_LOG_HEX(val)
+#undef NRF_LOG_HEX_CHAR
+#define NRF_LOG_HEX_CHAR(val)
+#endif
+
+#if NRF_LOG_MODULE_LEVEL < NRF_LOG_LEVEL_ERROR
+#undef NRF_LOG_PRINTF_ERROR
+#define NRF_LOG_PRINTF_ERROR(...)
+#undef NRF_LOG_ERROR
+#define NRF_LOG_ERROR(...)
+#undef NRF_LOG_HEX_ERROR
+#define NRF_LOG_HEX_ERROR(val)
+#undef NRF_LOG_HEX_CHAR_ERROR
+#define NRF_LOG_HEX_CHAR_ERROR(val)
+#endif
+
+#endif // (NRF_LOG_DEFERRED != 1) && !defined(DOXYGEN)
+
+#if (NRF_LOG_DEFERRED == 1) && \
+    ((NRF_LOG_USES_RTT == 1) || (NRF_LOG_USES_UART == 1) || (NRF_LOG_USES_RAW_UART == 1))
+
+#define LOG_DEFERRED_TYPE_PRINTF    0
+#define LOG_DEFERRED_TYPE_STRING    1
+#define LOG_DEFERRED_TYPE_HEX       2
+#define LOG_DEFERRED_TYPE_HEX_CHAR  3
+
+#define LOG_DEFERRED_TERMINAL_NORMAL    0
+#define LOG_DEFERRED_TERMINAL_ERROR     1
+
+#define LOG_DEFERRED_HEADER(type, terminal, num_args) \
+    (((uint32_t)(num_args) << 8) | ((uint32_t)(type) << 4) | (uint32_t)(terminal))
+
+/**@brief Function for storing a log entry in the deferred log buffer.
+ *
+ * @details Only the string pointer and the raw arguments are stored. They are formatted and written
+ *          to the backend later, by @ref log_deferred_process. Arguments must therefore be integers
+ *          or pointers, and strings passed as arguments must still be valid when the entry is
+ *          processed. If the buffer has no room for the entry, it is dropped and counted.
+ *
+ * This function is available only when NRF_LOG_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use the logging macros instead.
+ *
+ * @param   header  Entry type, terminal and number of arguments, see @ref LOG_DEFERRED_HEADER.
+ * @param   p_str   Format string or first string of the entry, or NULL.
+ */
+void log_deferred_push(uint32_t header, char const * p_str, ...);
+
+/**@brief Function for writing the oldest deferred log entry to the backend.
+ *
+ * This function is available only when NRF_LOG_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use @ref NRF_LOG_PROCESS instead.
+ *
+ * @retval      1 If an entry was processed.
+ * @retval      0 If there are no complete entries in the buffer.
+ */
+int log_deferred_process(void);
+
+/**@brief Function for getting the number of log entries dropped because the buffer was full.
+ *
+ * This function is available only when NRF_LOG_DEFERRED is defined as 1.
+ *
+ * @note Do not call this function directly. Use @ref NRF_LOG_DROPPED_COUNT instead.
+ */
+uint32_t log_deferred_dropped_get(void);
+
+#define LOG_DEFERRED_IF_LEVEL(level, entry) \
+    do { if ((level) <= NRF_LOG_MODULE_LEVEL) { entry; } } while (0)
+
+#define LOG_DEFERRED_PRINTF(terminal, ...)                                                          \
+    log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_PRINTF, terminal,                       \
+                                          NUM_VA_ARGS(__VA_ARGS__) - 1), __VA_ARGS__)
+#define LOG_DEFERRED_STRING(terminal, str, ...)                                                     \
+    log_deferred_push(LOG_DEFERRED_HEADER(LOG_DEFERRED_TYPE_STRING, terminal,                       \
+                                          NUM_VA_ARGS(str, ##__VA_ARGS__) - 1), str, ##__VA_ARGS__)
+#define LOG_DEFERRED_HEX(type, terminal, val)                                                       \
+    log_deferred_push(LOG_DEFERRED_HEADER(type, terminal, 1), NULL, (uint32_t)(val))
+
+#undef NRF_LOG_PRINTF
+#undef NRF_LOG_PRINTF_DEBUG
+#undef NRF_LOG_PRINTF_ERROR
+#undef NRF_LOG
+#undef NRF_LOG_DEBUG
+#undef NRF_LOG_ERROR
+#undef NRF_LOG_HEX
+#undef NRF_LOG_HEX_DEBUG
+#undef NRF_LOG_HEX_ERROR
+#undef NRF_LOG_HEX_CHAR
+#undef NRF_LOG_HEX_CHAR_DEBUG
+#undef NRF_LOG_HEX_CHAR_ERROR
+
+#define NRF_LOG_PRINTF(...)             LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_INFO,  LOG_DEFERRED_PRINTF(LOG_DEFERRED_TERMINAL_NORMAL, __VA_ARGS__))
+#define NRF_LOG_PRINTF_DEBUG(...)       LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_DEBUG, LOG_DEFERRED_PRINTF(LOG_DEFERRED_TERMINAL_NORMAL, __VA_ARGS__))
+#define NRF_LOG_PRINTF_ERROR(...)       LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_ERROR, LOG_DEFERRED_PRINTF(LOG_DEFERRED_TERMINAL_ERROR, __VA_ARGS__))
+
+#define NRF_LOG(...)                    LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_INFO,  LOG_DEFERRED_STRING(LOG_DEFERRED_TERMINAL_NORMAL, __VA_ARGS__))
+#define NRF_LOG_DEBUG(...)              LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_DEBUG, LOG_DEFERRED_STRING(LOG_DEFERRED_TERMINAL_NORMAL, __VA_ARGS__))
+#define NRF_LOG_ERROR(...)              LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_ERROR, LOG_DEFERRED_STRING(LOG_DEFERRED_TERMINAL_ERROR, __VA_ARGS__))
+
+#define NRF_LOG_HEX(val)                LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_INFO,  LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX, LOG_DEFERRED_TERMINAL_NORMAL, val))
+#define NRF_LOG_HEX_DEBUG(val)          LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_DEBUG, LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX, LOG_DEFERRED_TERMINAL_NORMAL, val))
+#define NRF_LOG_HEX_ERROR(val)          LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_ERROR, LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX, LOG_DEFERRED_TERMINAL_ERROR, val))
+
+#define NRF_LOG_HEX_CHAR(val)           LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_INFO,  LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX_CHAR, LOG_DEFERRED_TERMINAL_NORMAL, val))
+#define NRF_LOG_HEX_CHAR_DEBUG(val)     LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_DEBUG, LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX_CHAR, LOG_DEFERRED_TERMINAL_NORMAL, val))
+#define NRF_LOG_HEX_CHAR_ERROR(val)     LOG_DEFERRED_IF_LEVEL(NRF_LOG_LEVEL_ERROR, LOG_DEFERRED_HEX(LOG_DEFERRED_TYPE_HEX_CHAR, LOG_DEFERRED_TERMINAL_ERROR, val))
+
+#define NRF_LOG_PROCESS()               log_deferred_process()                  /*!< Write the oldest deferred log entry to the backend. */
+#define NRF_LOG_DROPPED_COUNT()         log_deferred_dropped_get()              /*!< Get the number of dropped deferred log entries. */
+
+#else
+
+#define NRF_LOG_PROCESS()               0
+#define NRF_LOG_DROPPED_COUNT()         0
+
+#endif // NRF_LOG_DEFERRED == 1
+
 /**@brief Function for writing HEX values.
  *
  * @note This function not thread-safe. It is written for convenience.
@@ -694,6 +862,31 @@ int NRF_LOG_HAS_INPUT(void);
  */
 uint32_t NRF_LOG_READ_INPUT(char* p_char);
 
+/**@brief Macro for writing the oldest deferred log entry to the backend.
+ *
+ * @details When NRF_LOG_DEFERRED is set to 1, the logging macros do not format or output anything.
+ *          They store the string pointer and the raw arguments in a buffer of
+ *          NRF_LOG_DEFERRED_BUFFER_SIZE words, which takes tens of cycles, and this macro does the
+ *          output later. Call it from the main loop until it returns 0, before going to sleep.
+ *          Deferred entries take at most NRF_LOG_DEFERRED_MAX_ARGS integer or pointer arguments.
+ *          Strings passed as arguments must still be valid when the entry is processed.
+ *
+ *          Each module can set its log level at compile time by defining NRF_LOG_MODULE_LEVEL
+ *          (for example, to NRF_LOG_LEVEL_ERROR) before including any header. Macros above the
+ *          level of the module generate no code, whether or not logging is deferred. The default
+ *          level is NRF_LOG_DEFAULT_LEVEL.
+ *
+ * @retval      1 If an entry was processed.
+ * @retval      0 If there are no entries to process, or NRF_LOG_DEFERRED is not set to 1.
+ */
+int NRF_LOG_PROCESS(void);
+
+/**@brief Macro for getting the number of deferred log entries dropped because the buffer was full.
+ *
+ * @return      Number of dropped entries. Always 0 if NRF_LOG_DEFERRED is not set to 1.
+ */
+uint32_t NRF_LOG_DROPPED_COUNT(void);
+
 /** @} */
 #endif // DOXYGEN
 #endif // NRF_LOG_H_
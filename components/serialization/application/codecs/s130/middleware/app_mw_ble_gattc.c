@@ -15,6 +15,7 @@
 #include "ble_gattc_app.h"
 #include "ble_serialization.h"
 #include "ser_sd_transport.h"
+#include "ser_config.h"
 #include "app_error.h"
 
 static void tx_buf_alloc(uint8_t * * p_data, uint16_t * p_len)
@@ -378,9 +379,17 @@ uint32_t sd_ble_gattc_write(uint16_t                               conn_handle,
     APP_ERROR_CHECK(err_code);
 
     //@note: Increment buffer length as internally managed packet type field must be included.
+#if SER_GATTC_WRITE_ASYNC_ENABLED
+    //@note: The response carries only the return code so writes can be pipelined. The return code
+    //       is passed to the asynchronous response handler.
+    return ser_sd_transport_cmd_write_async(p_buffer,
+                                            (++buffer_length),
+                                            gattc_write_rsp_dec);
+#else
     return ser_sd_transport_cmd_write(p_buffer,
                                       (++buffer_length),
                                       gattc_write_rsp_dec);
+#endif /* SER_GATTC_WRITE_ASYNC_ENABLED */
 }
 
 /**@brief Command response callback function for @ref sd_ble_gattc_hv_confirm BLE command.
@@ -19,6 +19,80 @@
 #include "ble_serialization.h"
 #include "app_util.h"
 
+/**@brief Event decoder type. */
+typedef uint32_t (*ble_event_decoder_t)(uint8_t const * const p_buf,
+                                        uint32_t              packet_len,
+                                        ble_evt_t * const     p_event,
+                                        uint32_t * const      p_event_len);
+
+/**@brief Last event ID handled by the decoders table. */
+#define BLE_EVENT_DEC_ID_LAST BLE_L2CAP_EVT_LAST
+
+/**@brief Event decoders table indexed by event ID. Unsupported events are NULL. */
+static const ble_event_decoder_t m_event_decoder[BLE_EVENT_DEC_ID_LAST + 1] =
+{
+    [BLE_EVT_TX_COMPLETE] = ble_evt_tx_complete_dec,
+    [BLE_EVT_USER_MEM_REQUEST] = ble_evt_user_mem_request_dec,
+    [BLE_EVT_USER_MEM_RELEASE] = ble_evt_user_mem_release_dec,
+    [BLE_GAP_EVT_PASSKEY_DISPLAY] = ble_gap_evt_passkey_display_dec,
+    [BLE_GAP_EVT_AUTH_KEY_REQUEST] = ble_gap_evt_auth_key_request_dec,
+    [BLE_GAP_EVT_CONN_PARAM_UPDATE] = ble_gap_evt_conn_param_update_dec,
+    [BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST] = ble_gap_evt_conn_param_update_request_dec,
+    [BLE_GAP_EVT_CONN_SEC_UPDATE] = ble_gap_evt_conn_sec_update_dec,
+    [BLE_GAP_EVT_CONNECTED] = ble_gap_evt_connected_dec,
+    [BLE_GAP_EVT_DISCONNECTED] = ble_gap_evt_disconnected_dec,
+    [BLE_GAP_EVT_TIMEOUT] = ble_gap_evt_timeout_dec,
+    [BLE_GAP_EVT_RSSI_CHANGED] = ble_gap_evt_rssi_changed_dec,
+    [BLE_GAP_EVT_SEC_INFO_REQUEST] = ble_gap_evt_sec_info_request_dec,
+    [BLE_GAP_EVT_SEC_PARAMS_REQUEST] = ble_gap_evt_sec_params_request_dec,
+    [BLE_GAP_EVT_AUTH_STATUS] = ble_gap_evt_auth_status_dec,
+    [BLE_GAP_EVT_SEC_REQUEST] = ble_gap_evt_sec_request_dec,
+    [BLE_GAP_EVT_KEY_PRESSED] = ble_gap_evt_key_pressed_dec,
+    [BLE_GAP_EVT_LESC_DHKEY_REQUEST] = ble_gap_evt_lesc_dhkey_request_dec,
+    [BLE_GATTC_EVT_CHAR_DISC_RSP] = ble_gattc_evt_char_disc_rsp_dec,
+    [BLE_GATTC_EVT_CHAR_VAL_BY_UUID_READ_RSP] = ble_gattc_evt_char_val_by_uuid_read_rsp_dec,
+    [BLE_GATTC_EVT_DESC_DISC_RSP] = ble_gattc_evt_desc_disc_rsp_dec,
+    [BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP] = ble_gattc_evt_prim_srvc_disc_rsp_dec,
+    [BLE_GATTC_EVT_READ_RSP] = ble_gattc_evt_read_rsp_dec,
+    [BLE_GATTC_EVT_HVX] = ble_gattc_evt_hvx_dec,
+    [BLE_GATTC_EVT_TIMEOUT] = ble_gattc_evt_timeout_dec,
+    [BLE_GATTC_EVT_WRITE_RSP] = ble_gattc_evt_write_rsp_dec,
+    [BLE_GATTC_EVT_CHAR_VALS_READ_RSP] = ble_gattc_evt_char_vals_read_rsp_dec,
+    [BLE_GATTC_EVT_REL_DISC_RSP] = ble_gattc_evt_rel_disc_rsp_dec,
+    [BLE_GATTC_EVT_ATTR_INFO_DISC_RSP] = ble_gattc_evt_attr_info_disc_rsp_dec,
+    [BLE_GATTS_EVT_WRITE] = ble_gatts_evt_write_dec,
+    [BLE_GATTS_EVT_TIMEOUT] = ble_gatts_evt_timeout_dec,
+    [BLE_GATTS_EVT_SC_CONFIRM] = ble_gatts_evt_sc_confirm_dec,
+    [BLE_GATTS_EVT_HVC] = ble_gatts_evt_hvc_dec,
+    [BLE_GATTS_EVT_SYS_ATTR_MISSING] = ble_gatts_evt_sys_attr_missing_dec,
+    [BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST] = ble_gatts_evt_rw_authorize_request_dec,
+    [BLE_L2CAP_EVT_RX] = ble_l2cap_evt_rx_dec,
+    [BLE_GAP_EVT_ADV_REPORT] = ble_gap_evt_adv_report_dec,
+    [BLE_GAP_EVT_SCAN_REQ_REPORT] = ble_gap_evt_scan_req_report_dec,
+};
+
+/**@brief Function for getting the decoder of an event encoded in the compact wire format.
+ *
+ * @details Only a few events have a compact encoding, so a switch takes less flash than a table
+ *          indexed by event ID.
+ *
+ * @return Decoder of the event, NULL if the event has no compact encoding.
+ */
+static ble_event_decoder_t event_compact_decoder_get(uint16_t event_id)
+{
+    switch (event_id)
+    {
+        case BLE_GATTS_EVT_WRITE:
+            return ble_gatts_evt_write_compact_dec;
+
+        case BLE_GAP_EVT_ADV_REPORT:
+            return ble_gap_evt_adv_report_compact_dec;
+
+        default:
+            return NULL;
+    }
+}
+
 uint32_t ble_event_dec(uint8_t const * const p_buf,
                        uint32_t              packet_len,
                        ble_evt_t * const     p_event,
@@ -31,7 +105,8 @@ uint32_t ble_event_dec(uint8_t const * const p_buf,
     SER_ASSERT_LENGTH_LEQ(SER_EVT_HEADER_SIZE, packet_len);
 
 
-    const uint16_t  event_id       = uint16_decode(&p_buf[SER_EVT_ID_POS]);
+    const uint16_t  event_id_field = uint16_decode(&p_buf[SER_EVT_ID_POS]);
+    const uint16_t  event_id       = event_id_field & ~SER_EVT_ID_COMPACT_FLAG;
     const uint8_t * p_sub_buffer   = &p_buf[SER_EVT_HEADER_SIZE];
     const uint32_t  sub_packet_len = packet_len - SER_EVT_HEADER_SIZE;
 
@@ -41,213 +116,26 @@ uint32_t ble_event_dec(uint8_t const * const p_buf,
         *p_event_len -= sizeof (ble_evt_hdr_t);
     }
 
-    switch (event_id)
-    {
-        case BLE_EVT_TX_COMPLETE:
-            err_code = ble_evt_tx_complete_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_EVT_USER_MEM_REQUEST:
-            err_code = ble_evt_user_mem_request_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_EVT_USER_MEM_RELEASE:
-            err_code = ble_evt_user_mem_release_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GAP_EVT_PASSKEY_DISPLAY:
-            err_code = ble_gap_evt_passkey_display_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                       p_event_len);
-            break;
-
-        case BLE_GAP_EVT_AUTH_KEY_REQUEST:
-            err_code = ble_gap_evt_auth_key_request_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                        p_event_len);
-            break;
-
-        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
-            err_code = ble_gap_evt_conn_param_update_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                         p_event_len);
-            break;
-
-        case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
-            err_code = ble_gap_evt_conn_param_update_request_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                                 p_event_len);
-            break;
-
-        case BLE_GAP_EVT_CONN_SEC_UPDATE:
-            err_code = ble_gap_evt_conn_sec_update_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                       p_event_len);
-            break;
-
-        case BLE_GAP_EVT_CONNECTED:
-            err_code = ble_gap_evt_connected_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GAP_EVT_DISCONNECTED:
-            err_code = ble_gap_evt_disconnected_dec(p_sub_buffer,
-                                                    sub_packet_len,
-                                                    p_event,
-                                                    p_event_len);
-            break;
-
-        case BLE_GAP_EVT_TIMEOUT:
-            err_code = ble_gap_evt_timeout_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GAP_EVT_RSSI_CHANGED:
-            err_code = ble_gap_evt_rssi_changed_dec(p_sub_buffer,
-                                                    sub_packet_len,
-                                                    p_event,
-                                                    p_event_len);
-            break;
-
-        case BLE_GAP_EVT_SEC_INFO_REQUEST:
-            err_code = ble_gap_evt_sec_info_request_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                        p_event_len);
-            break;
-
-        case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
-            err_code = ble_gap_evt_sec_params_request_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                          p_event_len);
-            break;
+    /* The connectivity chip marks each event encoded in the compact wire format, so both formats
+     * are decoded regardless of the format selected on the connectivity side. */
+    ble_event_decoder_t decoder = NULL;
 
-        case BLE_GAP_EVT_AUTH_STATUS:
-            err_code = ble_gap_evt_auth_status_dec(p_sub_buffer,
-                                                   sub_packet_len,
-                                                   p_event,
-                                                   p_event_len);
-            break;
-
-        case BLE_GAP_EVT_SEC_REQUEST:
-            err_code = ble_gap_evt_sec_request_dec(p_sub_buffer,
-                                                   sub_packet_len,
-                                                   p_event,
-                                                   p_event_len);
-            break;
-
-        case BLE_GAP_EVT_KEY_PRESSED:
-            err_code = ble_gap_evt_key_pressed_dec(p_sub_buffer,
-                                                   sub_packet_len,
-                                                   p_event,
-                                                   p_event_len);
-            break;
-
-        case BLE_GAP_EVT_LESC_DHKEY_REQUEST:
-            err_code = ble_gap_evt_lesc_dhkey_request_dec(p_sub_buffer,
-                                                   sub_packet_len,
-                                                   p_event,
-                                                   p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_CHAR_DISC_RSP:
-            err_code = ble_gattc_evt_char_disc_rsp_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                       p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_CHAR_VAL_BY_UUID_READ_RSP:
-            err_code = ble_gattc_evt_char_val_by_uuid_read_rsp_dec(p_sub_buffer,
-                                                                   sub_packet_len,
-                                                                   p_event,
-                                                                   p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_DESC_DISC_RSP:
-            err_code = ble_gattc_evt_desc_disc_rsp_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                       p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP:
-            err_code = ble_gattc_evt_prim_srvc_disc_rsp_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                            p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_READ_RSP:
-            err_code = ble_gattc_evt_read_rsp_dec(p_sub_buffer,
-                                                  sub_packet_len,
-                                                  p_event,
-                                                  p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_HVX:
-            err_code = ble_gattc_evt_hvx_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_TIMEOUT:
-            err_code = ble_gattc_evt_timeout_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_WRITE_RSP:
-            err_code = ble_gattc_evt_write_rsp_dec(p_sub_buffer,
-                                                   sub_packet_len,
-                                                   p_event,
-                                                   p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_CHAR_VALS_READ_RSP:
-            err_code = ble_gattc_evt_char_vals_read_rsp_dec(p_sub_buffer,
-                                                            sub_packet_len,
-                                                            p_event,
-                                                            p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_REL_DISC_RSP:
-            err_code = ble_gattc_evt_rel_disc_rsp_dec(p_sub_buffer,
-                                                      sub_packet_len,
-                                                      p_event,
-                                                      p_event_len);
-            break;
-
-        case BLE_GATTC_EVT_ATTR_INFO_DISC_RSP:
-                    err_code = ble_gattc_evt_attr_info_disc_rsp_dec(p_sub_buffer,
-                                                                    sub_packet_len,
-                                                                    p_event,
-                                                                    p_event_len);
-                    break;
-
-        case BLE_GATTS_EVT_WRITE:
-            err_code = ble_gatts_evt_write_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GATTS_EVT_TIMEOUT:
-            err_code = ble_gatts_evt_timeout_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GATTS_EVT_SC_CONFIRM:
-            err_code = ble_gatts_evt_sc_confirm_dec(p_sub_buffer,
-                                                    sub_packet_len,
-                                                    p_event,
-                                                    p_event_len);
-            break;
-
-        case BLE_GATTS_EVT_HVC:
-            err_code = ble_gatts_evt_hvc_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GATTS_EVT_SYS_ATTR_MISSING:
-            err_code = ble_gatts_evt_sys_attr_missing_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                          p_event_len);
-            break;
-
-        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
-            err_code = ble_gatts_evt_rw_authorize_request_dec(p_sub_buffer, sub_packet_len, p_event,
-                                                              p_event_len);
-            break;
-
-        case BLE_L2CAP_EVT_RX:
-            err_code = ble_l2cap_evt_rx_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-
-        case BLE_GAP_EVT_ADV_REPORT:
-            err_code = ble_gap_evt_adv_report_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
+    if (event_id_field & SER_EVT_ID_COMPACT_FLAG)
+    {
+        decoder = event_compact_decoder_get(event_id);
+    }
+    else if (event_id <= BLE_EVENT_DEC_ID_LAST)
+    {
+        decoder = m_event_decoder[event_id];
+    }
 
-        case BLE_GAP_EVT_SCAN_REQ_REPORT:
-            err_code = ble_gap_evt_scan_req_report_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
-            break;
-        default:
-            err_code = NRF_ERROR_NOT_FOUND;
-            break;
+    if (decoder != NULL)
+    {
+        err_code = decoder(p_sub_buffer, sub_packet_len, p_event, p_event_len);
+    }
+    else
+    {
+        err_code = NRF_ERROR_NOT_FOUND;
     }
 
     if (p_event != NULL)
@@ -70,3 +70,70 @@ uint32_t ble_gap_evt_adv_report_dec(uint8_t const * const p_buf,
 
     return err_code;
 }
+
+
+uint32_t ble_gap_evt_adv_report_compact_dec(uint8_t const * const p_buf,
+                                            uint32_t              packet_len,
+                                            ble_evt_t * const     p_event,
+                                            uint32_t * const      p_event_len)
+{
+    uint32_t index = 0;
+    uint32_t err_code = NRF_SUCCESS;
+    uint8_t  byte;
+
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_event_len);
+
+    SER_ASSERT_LENGTH_LEQ(1+BLE_GAP_ADDR_LEN+1+1, packet_len); // assumed size(data) = 0
+
+    uint32_t event_len = (uint16_t) (offsetof(ble_evt_t, evt.gap_evt.params.adv_report)) +
+                         sizeof (ble_gap_evt_adv_report_t) -
+                         sizeof (ble_evt_hdr_t);
+
+    if (p_event == NULL)
+    {
+        *p_event_len = event_len;
+        return NRF_SUCCESS;
+    }
+
+    SER_ASSERT(event_len <= *p_event_len, NRF_ERROR_DATA_SIZE);
+
+    p_event->header.evt_id  = BLE_GAP_EVT_ADV_REPORT;
+    p_event->header.evt_len = event_len;
+
+    ble_gap_evt_adv_report_t * p_adv_report = &(p_event->evt.gap_evt.params.adv_report);
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &byte);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    p_adv_report->peer_addr.addr_type = byte & ~SER_ADV_REPORT_COMPACT_CONN_HANDLE_FLAG;
+
+    err_code = uint8_vector_dec(p_buf, packet_len, &index, p_adv_report->peer_addr.addr, BLE_GAP_ADDR_LEN);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    p_event->evt.gap_evt.conn_handle = BLE_CONN_HANDLE_INVALID;
+    if (byte & SER_ADV_REPORT_COMPACT_CONN_HANDLE_FLAG)
+    {
+        err_code = varint16_dec(p_buf, packet_len, &index, &(p_event->evt.gap_evt.conn_handle));
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &(p_adv_report->rssi));
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &byte);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    p_adv_report->scan_rsp = byte & 0x01;
+    p_adv_report->type = (byte >> 1) & 0x03;
+    p_adv_report->dlen = (byte >> 3) & 0x1F;
+
+    err_code = uint8_vector_dec(p_buf, packet_len, &index,
+        p_adv_report->data, (uint16_t)(p_adv_report->dlen));
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    SER_ASSERT_LENGTH_EQ(index, packet_len);
+    *p_event_len = event_len;
+
+    return err_code;
+}
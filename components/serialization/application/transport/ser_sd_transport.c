@@ -18,10 +18,12 @@
 #include "nrf_error.h"
 #include "app_error.h"
 #include "ble_serialization.h"
+#include "ser_config.h"
 
 #include "ser_app_power_system_off.h"
 
 #include "app_util.h"
+#include "app_util_platform.h"
 
 #ifdef ENABLE_DEBUG_LOG_SUPPORT
 #include "app_trace.h"
@@ -54,6 +56,103 @@ static volatile bool m_rsp_wait = false;
 /** SoftDevice call return value decoded by user decoder handler. */
 static uint32_t m_return_value;
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+/** @brief Command sent to the connectivity chip which waits for its response. */
+typedef struct
+{
+    ser_sd_transport_rsp_handler_t rsp_dec_handler; /**< Decoder of the response. Can be NULL. */
+    uint8_t                        seq_id;          /**< Sequence ID of the command. */
+    uint8_t                        op_code;         /**< Operation code of the command. */
+    bool                           is_async;        /**< True if no task is waiting for the response. */
+} ser_sd_transport_pending_cmd_t;
+
+/** Outstanding commands in order of sending. The connectivity chip processes commands in order so
+ *  responses are received in the same order. */
+static ser_sd_transport_pending_cmd_t m_pending_cmds[SER_PIPELINE_WINDOW_SIZE];
+
+/** Index of the oldest outstanding command. Modified in serial peripheral interrupt context only. */
+static volatile uint8_t m_pending_cmd_start = 0;
+
+/** Number of outstanding commands. */
+static volatile uint8_t m_pending_cmd_count = 0;
+
+/** Sequence ID of the next command. */
+static uint8_t m_next_seq_id = 0;
+#endif
+
+/** Handler called with the result of a command sent with @ref ser_sd_transport_cmd_write_async. */
+static ser_sd_transport_async_rsp_handler_t m_async_rsp_handler = NULL;
+
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+/**@brief Function for completing the oldest outstanding command.
+ *
+ * @details This function is called in serial peripheral interrupt context.
+ *
+ * @param[in]   result_code   SoftDevice call return value.
+ */
+static void pending_cmd_complete(uint32_t result_code)
+{
+    ser_sd_transport_pending_cmd_t * p_cmd = &m_pending_cmds[m_pending_cmd_start];
+
+    m_pending_cmd_start = (m_pending_cmd_start + 1) % SER_PIPELINE_WINDOW_SIZE;
+    m_pending_cmd_count--;
+
+    if (p_cmd->is_async)
+    {
+        if (m_async_rsp_handler)
+        {
+            m_async_rsp_handler(p_cmd->op_code, result_code);
+        }
+    }
+    else
+    {
+        m_return_value = result_code;
+
+        /* Reset response flag - cmd_write function is pending on it.*/
+        m_rsp_wait = false;
+
+        /* If os handler is set, signal os that response has arrived.*/
+        if (m_os_rsp_set_handler)
+        {
+            m_os_rsp_set_handler();
+        }
+    }
+}
+
+/**@brief Function for handling a response tagged with a sequence ID.
+ *
+ * @details This function is called in serial peripheral interrupt context. The response is matched
+ *          with the oldest outstanding command and decoded with the decoder of that command.
+ *
+ * @param[in]   p_data   Pointer to received data (starting from the sequence ID).
+ * @param[in]   length   Size of data.
+ */
+static void seq_rsp_handle(uint8_t * p_data, uint16_t length)
+{
+    uint32_t                         result_code = NRF_SUCCESS;
+    ser_sd_transport_pending_cmd_t * p_cmd       = &m_pending_cmds[m_pending_cmd_start];
+
+    if ((0 == m_pending_cmd_count) ||
+        (length < SER_PKT_SEQ_ID_SIZE) ||
+        (p_data[0] != p_cmd->seq_id))
+    {
+        /* Unexpected packet. */
+        (void)ser_sd_transport_rx_free(p_data);
+        APP_ERROR_HANDLER(SER_PKT_TYPE_SEQ_RESP);
+        return;
+    }
+
+    if (p_cmd->rsp_dec_handler)
+    {
+        result_code = p_cmd->rsp_dec_handler(&p_data[SER_PKT_SEQ_ID_SIZE],
+                                             length - SER_PKT_SEQ_ID_SIZE);
+    }
+    (void)ser_sd_transport_rx_free(p_data);
+
+    pending_cmd_complete(result_code);
+}
+#endif
+
 /**@brief Function for handling the rx packets comming from hal_transport.
  *
  * @details
@@ -99,6 +198,12 @@ static void ser_sd_transport_rx_packet_handler(uint8_t * p_data, uint16_t length
                 }
                 break;
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+            case SER_PKT_TYPE_SEQ_RESP:
+                seq_rsp_handle(p_data, length);
+                break;
+#endif
+
             case SER_PKT_TYPE_EVT:
                 /* It is ensured during opening that handler is not NULL. No check needed. */
                 APPL_LOG("\r\n[EVT_ID]: 0x%X \r\n", uint16_decode(&p_data[SER_EVT_ID_POS])); // p_data points to EVT_ID
@@ -139,6 +244,14 @@ static void ser_sd_transport_hal_handler(ser_hal_transport_evt_t event)
         break;
     case SER_HAL_TRANSP_EVT_PHY_ERROR:
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+        /* Responses to outstanding commands are lost. */
+        while (m_pending_cmd_count > 0)
+        {
+            pending_cmd_complete(NRF_ERROR_INTERNAL);
+        }
+#endif
+
         if (m_rsp_wait)
         {
             m_return_value = NRF_ERROR_INTERNAL;
@@ -169,6 +282,11 @@ uint32_t ser_sd_transport_open(ser_sd_transport_evt_handler_t             evt_ha
     m_ot_rsp_wait_handler = NULL;
     m_evt_handler         = evt_handler;
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+    m_pending_cmd_start = 0;
+    m_pending_cmd_count = 0;
+#endif
+
     if (evt_handler == NULL)
     {
         return NRF_ERROR_INVALID_PARAM;
@@ -183,6 +301,7 @@ uint32_t ser_sd_transport_close(void)
     m_os_rsp_wait_handler = NULL;
     m_os_rsp_set_handler  = NULL;
     m_ot_rsp_wait_handler = NULL;
+    m_async_rsp_handler   = NULL;
 
     ser_hal_transport_close();
 
@@ -196,6 +315,13 @@ uint32_t ser_sd_transport_ot_rsp_wait_handler_set(ser_sd_transport_rsp_wait_hand
     return NRF_SUCCESS;
 }
 
+uint32_t ser_sd_transport_async_rsp_handler_set(ser_sd_transport_async_rsp_handler_t handler)
+{
+    m_async_rsp_handler = handler;
+
+    return NRF_SUCCESS;
+}
+
 bool ser_sd_transport_is_busy(void)
 {
     return m_rsp_wait;
@@ -209,15 +335,36 @@ uint32_t ser_sd_transport_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
     {
         err_code = NRF_ERROR_BUSY;
     }
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+    else if (m_pending_cmd_count >= SER_PIPELINE_WINDOW_SIZE)
+    {
+        err_code = NRF_ERROR_BUSY;
+    }
+    else
+    {
+        err_code = ser_hal_transport_tx_pkt_alloc(pp_data, p_len);
+
+        /* Reserve space for the sequence ID in front of the packet type field. */
+        if (err_code == NRF_SUCCESS)
+        {
+            *pp_data += SER_PKT_SEQ_ID_SIZE;
+            *p_len   -= SER_PKT_SEQ_ID_SIZE;
+        }
+    }
+#else
     else
     {
         err_code = ser_hal_transport_tx_pkt_alloc(pp_data, p_len);
     }
+#endif
     return err_code;
 }
 
 uint32_t ser_sd_transport_tx_free(uint8_t * p_data)
 {
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+    p_data -= SER_PKT_SEQ_ID_SIZE;
+#endif
     return ser_hal_transport_tx_pkt_free(p_data);
 }
 
@@ -227,12 +374,91 @@ uint32_t ser_sd_transport_rx_free(uint8_t * p_data)
     return ser_hal_transport_rx_pkt_free(p_data);
 }
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+/**@brief Function for sending a command tagged with a sequence ID.
+ *
+ * @details The buffer must have been allocated with @ref ser_sd_transport_tx_alloc, so there is
+ *          space for the sequence ID in front of it.
+ *
+ * @param[in] p_buffer                 Pointer to command (starting from the packet type field).
+ * @param[in] length                   Length of command.
+ * @param[in] cmd_rsp_decode_callback  Pointer to function for decoding response packet.
+ * @param[in] is_async                 True if the caller does not wait for the response.
+ */
+static uint32_t seq_cmd_write(const uint8_t *                p_buffer,
+                              uint16_t                       length,
+                              ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback,
+                              bool                           is_async)
+{
+    uint32_t                         err_code;
+    ser_sd_transport_pending_cmd_t * p_cmd;
+    uint8_t *                        p_pkt = (uint8_t *)p_buffer - SER_PKT_SEQ_ID_SIZE;
+
+    /* A response is always sent for a sequenced command, nobody waits for it if there is no
+     * decoder. */
+    is_async = is_async || (cmd_rsp_decode_callback == NULL);
+
+    CRITICAL_REGION_ENTER();
+    p_cmd = &m_pending_cmds[(m_pending_cmd_start + m_pending_cmd_count) % SER_PIPELINE_WINDOW_SIZE];
+    p_cmd->rsp_dec_handler = cmd_rsp_decode_callback;
+    p_cmd->seq_id          = m_next_seq_id++;
+    p_cmd->op_code         = p_buffer[SER_PKT_OP_CODE_POS];
+    p_cmd->is_async        = is_async;
+    m_pending_cmd_count++;
+    m_rsp_wait = !is_async;
+    CRITICAL_REGION_EXIT();
+
+    /* The sequence ID overwrites the packet type field written by the codec. */
+    p_pkt[SER_PKT_TYPE_POS]   = SER_PKT_TYPE_SEQ_CMD;
+    p_pkt[SER_PKT_SEQ_ID_POS] = p_cmd->seq_id;
+
+    err_code = ser_hal_transport_tx_pkt_send(p_pkt, length + SER_PKT_SEQ_ID_SIZE);
+    APP_ERROR_CHECK(err_code);
+
+    if (!is_async)
+    {
+        if (m_ot_rsp_wait_handler)
+        {
+            m_ot_rsp_wait_handler();
+            m_ot_rsp_wait_handler = NULL;
+        }
+
+        m_os_rsp_wait_handler();
+        err_code = m_return_value;
+    }
+    APPL_LOG("\r\n[SD_CALL_ID]: 0x%X, seq= %d, err_code= 0x%X\r\n", p_cmd->op_code, p_cmd->seq_id, err_code);
+    return err_code;
+}
+#endif
+
+uint32_t ser_sd_transport_cmd_write_async(const uint8_t *                p_buffer,
+                                          uint16_t                       length,
+                                          ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback)
+{
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+    if (SER_PKT_TYPE_CMD == p_buffer[SER_PKT_TYPE_POS])
+    {
+        return seq_cmd_write(p_buffer, length, cmd_rsp_decode_callback, true);
+    }
+#endif
+    return ser_sd_transport_cmd_write(p_buffer, length, cmd_rsp_decode_callback);
+}
+
 uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
                                     uint16_t                       length,
                                     ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback)
 {
     uint32_t err_code = NRF_SUCCESS;
 
+#if (SER_PIPELINE_WINDOW_SIZE > 1)
+    /* Commands encoded by the middleware are tagged. Other packet types (DTM, reset) are allocated
+     * directly from the HAL Transport layer and are sent without a sequence ID. */
+    if (SER_PKT_TYPE_CMD == p_buffer[SER_PKT_TYPE_POS])
+    {
+        return seq_cmd_write(p_buffer, length, cmd_rsp_decode_callback, false);
+    }
+#endif
+
     m_rsp_wait        = true;
     m_rsp_dec_handler = cmd_rsp_decode_callback;
     err_code          = ser_hal_transport_tx_pkt_send(p_buffer, length);
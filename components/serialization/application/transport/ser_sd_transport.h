@@ -44,6 +44,8 @@ typedef void (*ser_sd_transport_rx_notification_handler_t)(void);
 
 typedef uint32_t (*ser_sd_transport_rsp_handler_t)(const uint8_t * p_buffer, uint16_t length);
 
+typedef void (*ser_sd_transport_async_rsp_handler_t)(uint8_t op_code, uint32_t result_code);
+
 /**@brief Function for opening the module.
  *
  * @note 'Wait for response' and 'Response set' callbacks can be set in RTOS environment.
@@ -149,5 +151,39 @@ uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
                                     uint16_t                       length,
                                     ser_sd_transport_rsp_handler_t cmd_resp_decode_callback);
 
+/**@brief Function for handling SoftDevice command without waiting for its response.
+ *
+ * @details If pipelining is enabled (@ref SER_PIPELINE_WINDOW_SIZE greater than 1), the command is
+ *          tagged with a sequence ID and the function returns as soon as the command is passed to
+ *          the transport. Up to @ref SER_PIPELINE_WINDOW_SIZE commands can be outstanding. The
+ *          response is decoded in serial peripheral interrupt context and the result is passed to
+ *          the handler set with @ref ser_sd_transport_async_rsp_handler_set. If pipelining is
+ *          disabled, the function works as @ref ser_sd_transport_cmd_write.
+ *
+ * @note The response decoder must not write to memory owned by the caller of the SoftDevice
+ *       function, as the response is decoded after that function has returned.
+ *
+ * @param[in] p_buffer                 Pointer to command.
+ * @param[in] length                   Pointer to allocated buffer length.
+ * @param[in] cmd_resp_decode_callback Pointer to function for decoding response packet.
+ *
+ * @retval NRF_SUCCESS          Operation success.
+ */
+uint32_t ser_sd_transport_cmd_write_async(const uint8_t *                p_buffer,
+                                          uint16_t                       length,
+                                          ser_sd_transport_rsp_handler_t cmd_resp_decode_callback);
+
+/**@brief Function for setting the handler of results of commands sent with
+ *        @ref ser_sd_transport_cmd_write_async.
+ *
+ * @note The handler is called in serial peripheral interrupt context.
+ *
+ * @param[in] handler       Handler called with the operation code and the SoftDevice call return
+ *                          value of each completed command.
+ *
+ * @retval NRF_SUCCESS          Operation success.
+ */
+uint32_t ser_sd_transport_async_rsp_handler_set(ser_sd_transport_async_rsp_handler_t handler);
+
 #endif /* SER_SD_TRANSPORT_H_ */
 /** @} */
@@ -16,6 +16,7 @@
 #include "app_scheduler.h"
 #include "softdevice_handler.h"
 #include "ser_sd_transport.h"
+#include "ser_softdevice_handler.h"
 #include "ser_app_hal.h"
 #include "ser_config.h"
 #include "nrf_soc.h"
@@ -198,3 +199,54 @@ uint32_t sd_softdevice_disable(void)
     return ser_sd_transport_close();
 }
 
+
+/**@brief Command response callback function for the Wire Format Set command.
+ *
+ * @param[in] p_buffer  Pointer to begin of command response buffer.
+ * @param[in] length    Length of data in bytes.
+ *
+ * @return Decoded command response return code.
+ */
+static uint32_t wire_format_set_rsp_dec(const uint8_t * p_buffer, uint16_t length)
+{
+    uint32_t result_code;
+
+    const uint32_t err_code = ser_ble_cmd_rsp_dec(p_buffer,
+                                                  length,
+                                                  SER_OP_CODE_WIRE_FORMAT_SET,
+                                                  &result_code);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    return result_code;
+}
+
+
+uint32_t ser_app_wire_format_request(ser_wire_format_t format)
+{
+    uint8_t * p_buffer;
+    uint16_t  buffer_length16;
+    uint32_t  buffer_length;
+    uint32_t  err_code;
+
+    err_code = ser_sd_transport_tx_alloc(&p_buffer, &buffer_length16);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_buffer[SER_PKT_TYPE_POS] = SER_PKT_TYPE_CMD;
+    buffer_length              = (uint32_t)buffer_length16 - SER_PKT_TYPE_SIZE;
+
+    err_code = ser_wire_format_set_req_enc(format, &p_buffer[SER_PKT_OP_CODE_POS], &buffer_length);
+    APP_ERROR_CHECK(err_code);
+
+    //@note: Increment buffer length as internally managed packet type field must be included.
+    return ser_sd_transport_cmd_write(p_buffer,
+                                      buffer_length + SER_PKT_TYPE_SIZE,
+                                      wire_format_set_rsp_dec);
+}
+
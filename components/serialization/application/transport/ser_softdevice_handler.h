@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ble_serialization.h"
 
 
 /**@brief Function for checking if there is any more events in the internal mailbox.
@@ -40,5 +41,19 @@
  */
 uint32_t sd_ble_evt_mailbox_length_get(uint32_t * p_mailbox_length);
 
+/**@brief Function for requesting the wire format of the events sent by the connectivity chip.
+ *
+ * @details The connectivity chip sends events in the standard format after every reset. Call this
+ *          function after @ref sd_softdevice_enable to switch to the compact format. If the
+ *          request fails, the connectivity chip keeps using the standard format, and events are
+ *          decoded as before.
+ *
+ * @param[in] format  Requested wire format.
+ *
+ * @retval ::NRF_SUCCESS                The connectivity chip uses the requested format.
+ * @retval ::NRF_ERROR_NOT_SUPPORTED    The connectivity chip does not support the requested format.
+ */
+uint32_t ser_app_wire_format_request(ser_wire_format_t format);
+
 #endif /* SER_SOFTDEVICE_HANDLER_H_ */
 /** @} */
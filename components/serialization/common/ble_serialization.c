@@ -15,6 +15,8 @@
 #include <stddef.h>
 #include <string.h>
 
+static ser_wire_format_t m_wire_format = SER_WIRE_FORMAT_STANDARD;
+
 uint32_t ser_ble_cmd_rsp_status_code_enc(uint8_t          op_code,
                                          uint32_t         command_status,
                                          uint8_t * const  p_buf,
@@ -518,3 +520,91 @@ uint32_t uint8_vector_dec(uint8_t const * const p_buf,
     return NRF_SUCCESS;
 }
 
+uint32_t varint16_enc(void const * const p_field,
+                      uint8_t * const    p_buf,
+                      uint32_t           buf_len,
+                      uint32_t * const   p_index)
+{
+    uint16_t value = *(uint16_t *)p_field;
+
+    do
+    {
+        SER_ASSERT_LENGTH_LEQ(1, ((int32_t)buf_len - *p_index));
+        p_buf[*p_index] = (uint8_t)(value & 0x7F);
+        value         >>= 7;
+        if (value)
+        {
+            p_buf[*p_index] |= 0x80;
+        }
+        (*p_index)++;
+    }
+    while (value);
+
+    return NRF_SUCCESS;
+}
+
+uint32_t varint16_dec(uint8_t const * const p_buf,
+                      uint32_t              buf_len,
+                      uint32_t * const      p_index,
+                      void *                p_field)
+{
+    uint32_t value = 0;
+    uint32_t shift = 0;
+    uint8_t  byte;
+
+    do
+    {
+        SER_ASSERT_LENGTH_LEQ(1, ((int32_t)buf_len - *p_index));
+        byte   = p_buf[(*p_index)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+        SER_ASSERT(value <= UINT16_MAX, NRF_ERROR_INVALID_DATA);
+    }
+    while ((byte & 0x80) && (shift < 21));
+
+    SER_ASSERT(!(byte & 0x80), NRF_ERROR_INVALID_DATA);
+
+    *(uint16_t *)p_field = (uint16_t)value;
+
+    return NRF_SUCCESS;
+}
+
+void ser_wire_format_set(ser_wire_format_t format)
+{
+    m_wire_format = format;
+}
+
+ser_wire_format_t ser_wire_format_get(void)
+{
+    return m_wire_format;
+}
+
+uint32_t ser_wire_format_set_req_enc(ser_wire_format_t format,
+                                     uint8_t * const   p_buf,
+                                     uint32_t * const  p_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_buf_len);
+    SER_ASSERT_LENGTH_LEQ(SER_CMD_HEADER_SIZE + 1, *p_buf_len);
+
+    p_buf[SER_CMD_OP_CODE_POS] = SER_OP_CODE_WIRE_FORMAT_SET;
+    p_buf[SER_CMD_DATA_POS]    = (uint8_t)format;
+    *p_buf_len                 = SER_CMD_HEADER_SIZE + 1;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t ser_wire_format_set_req_dec(uint8_t const * const     p_buf,
+                                     uint32_t                  packet_len,
+                                     ser_wire_format_t * const p_format)
+{
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_format);
+    SER_ASSERT_LENGTH_EQ(SER_CMD_HEADER_SIZE + 1, packet_len);
+    SER_ASSERT(p_buf[SER_CMD_DATA_POS] <= SER_WIRE_FORMAT_COMPACT, NRF_ERROR_INVALID_DATA);
+
+    *p_format = (ser_wire_format_t)p_buf[SER_CMD_DATA_POS];
+
+    return NRF_SUCCESS;
+}
+
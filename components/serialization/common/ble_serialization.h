@@ -27,9 +27,21 @@ typedef enum
     SER_PKT_TYPE_DTM_CMD,     /**< DTM Command packet type. */
     SER_PKT_TYPE_DTM_RESP,    /**< DTM Response packet type. */
     SER_PKT_TYPE_RESET_CMD,   /**< System Reset Command packet type. */
+    SER_PKT_TYPE_SEQ_CMD,     /**< Command packet type tagged with a sequence ID (pipelined mode). */
+    SER_PKT_TYPE_SEQ_RESP,    /**< Command Response packet type tagged with a sequence ID (pipelined mode). */
+    SER_PKT_TYPE_BENCH_CMD,   /**< Benchmark Command packet type (see @ref ser_bench). */
+    SER_PKT_TYPE_BENCH_RESP,  /**< Benchmark Response packet type (see @ref ser_bench). */
     SER_PKT_TYPE_MAX          /**< Upper bound. */
 } ser_pkt_type_t;
 
+/**@brief The wire formats of serialized events. */
+typedef enum
+{
+    SER_WIRE_FORMAT_STANDARD = 0, /**< All fields encoded at full width. */
+    SER_WIRE_FORMAT_COMPACT,      /**< Variable length integers, packed flags and omitted default fields
+                                       for the events that have a compact encoding. */
+} ser_wire_format_t;
+
 #define  LOW16(a) ((uint16_t)((a & 0x0000FFFF) >> 0))
 #define HIGH16(a) ((uint16_t)((a & 0xFFFF0000) >> 16))
 
@@ -42,6 +54,9 @@ typedef enum
 #define SER_PKT_TYPE_SIZE              1
 /** Size in bytes of the Operation Code field. */
 #define SER_OP_CODE_SIZE               1
+/** Size in bytes of the Sequence ID field (@ref SER_PKT_TYPE_SEQ_CMD and @ref SER_PKT_TYPE_SEQ_RESP
+ *  packets only). */
+#define SER_PKT_SEQ_ID_SIZE            1
 
 /** Position of the Packet Type field in a serialized packet buffer. */
 #define SER_PKT_TYPE_POS               0
@@ -49,6 +64,10 @@ typedef enum
 #define SER_PKT_OP_CODE_POS            (SER_PKT_TYPE_SIZE)
 /** Position of the Data in a serialized packet buffer. */
 #define SER_PKT_DATA_POS               (SER_PKT_TYPE_SIZE + SER_OP_CODE_SIZE)
+/** Position of the Sequence ID field in a sequenced packet buffer. */
+#define SER_PKT_SEQ_ID_POS             (SER_PKT_TYPE_SIZE)
+/** Position of the Operation Code field in a sequenced packet buffer. */
+#define SER_PKT_SEQ_OP_CODE_POS        (SER_PKT_TYPE_SIZE + SER_PKT_SEQ_ID_SIZE)
 
 /** Position of the Operation Code field in a command buffer. */
 #define SER_CMD_OP_CODE_POS            0
@@ -69,6 +88,12 @@ typedef enum
 #define SER_EVT_HEADER_SIZE            (SER_EVT_ID_SIZE)
 /** Size of event connection handler. */
 #define SER_EVT_CONN_HANDLE_SIZE       2
+/** Flag set in the event ID field of events encoded in the compact wire format. */
+#define SER_EVT_ID_COMPACT_FLAG        0x8000u
+/** Operation code of the Wire Format Set command. The value is outside of the SoftDevice SVC
+ *  ranges, so a connectivity chip which does not know the command answers it with
+ *  @ref NRF_ERROR_NOT_SUPPORTED. */
+#define SER_OP_CODE_WIRE_FORMAT_SET    0xF0
 
 /** Position of the Op Code in the DTM command buffer.*/
 #define SER_DTM_CMD_OP_CODE_POS        0
@@ -576,6 +601,91 @@ uint32_t uint8_vector_dec(uint8_t const * const p_buf,
                  uint8_t  * const      p_data,
                  uint16_t              dlen);
 
+/**@brief Function for safe encoding an uint16 value as a variable length integer.
+ *
+ * The value is encoded in 7-bit groups, least significant group first, with the most significant
+ * bit of each byte set when another byte follows. Values below 128 take one byte, values below
+ * 16384 take two bytes and other values three bytes.
+ *
+ * @param[in]      p_field          Pointer to the uint16 value to be encoded.
+ * @param[out]     p_buf            Pointer to the beginning of the output buffer.
+ * @param[in]      buf_len          Size of the buffer.
+ * @param[in,out]  p_index          \c in: Index to start of uint16 value in buffer.
+ *                                  \c out: Index in buffer to first byte after the encoded value.
+ *
+ * @return NRF_SUCCESS              Fields encoded successfully.
+ * @retval NRF_ERROR_INVALID_LENGTH Encoding failure. Incorrect buffer length.
+ */
+uint32_t varint16_enc(void const * const p_field,
+                      uint8_t * const    p_buf,
+                      uint32_t           buf_len,
+                      uint32_t * const   p_index);
+
+/**@brief Function for safe decoding an uint16 value encoded as a variable length integer.
+ *
+ * @param[in]      p_buf            Pointer to the beginning of the input buffer.
+ * @param[in]      buf_len          Size of the buffer.
+ * @param[in,out]  p_index          \c in: Index to start of uint16 value in buffer.
+ *                                  \c out: Index in buffer to first byte after the decoded value.
+ * @param[out]     p_field          Pointer to the location where uint16 value will be decoded.
+ *
+ * @return NRF_SUCCESS              Fields decoded successfully.
+ * @retval NRF_ERROR_INVALID_LENGTH Decoding failure. Incorrect buffer length.
+ * @retval NRF_ERROR_INVALID_DATA   Decoding failure. The value does not fit in 16 bits.
+ */
+uint32_t varint16_dec(uint8_t const * const p_buf,
+                      uint32_t              buf_len,
+                      uint32_t * const      p_index,
+                      void *                p_field);
+
+/**@brief Function for selecting the wire format used by the event encoders.
+ *
+ * @note The event decoders accept both formats, the format of each event is indicated by
+ *       @ref SER_EVT_ID_COMPACT_FLAG in its event ID.
+ *
+ * @note On the connectivity chip, the format is selected by the application chip with the Wire
+ *       Format Set command (@ref SER_OP_CODE_WIRE_FORMAT_SET).
+ *
+ * @param[in]      format           Wire format to be used.
+ */
+void ser_wire_format_set(ser_wire_format_t format);
+
+/**@brief Function for getting the wire format used by the event encoders.
+ *
+ * @return Wire format in use.
+ */
+ser_wire_format_t ser_wire_format_get(void);
+
+/**@brief Function for encoding the Wire Format Set command.
+ *
+ * @param[in]      format           Wire format requested from the connectivity chip.
+ * @param[in]      p_buf            Pointer to the buffer where the command will be encoded.
+ * @param[in,out]  p_buf_len        \c in: Size of \p p_buf buffer.
+ *                                  \c out: Length of the encoded command.
+ *
+ * @retval NRF_SUCCESS              Encoding success.
+ * @retval NRF_ERROR_NULL           Encoding failure. NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH Encoding failure. Incorrect buffer length.
+ */
+uint32_t ser_wire_format_set_req_enc(ser_wire_format_t format,
+                                     uint8_t * const   p_buf,
+                                     uint32_t * const  p_buf_len);
+
+/**@brief Function for decoding the Wire Format Set command.
+ *
+ * @param[in]      p_buf            Pointer to the beginning of the command.
+ * @param[in]      packet_len       Length (in bytes) of the command.
+ * @param[out]     p_format         Requested wire format.
+ *
+ * @retval NRF_SUCCESS              Decoding success.
+ * @retval NRF_ERROR_NULL           Decoding failure. NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH Decoding failure. Incorrect buffer length.
+ * @retval NRF_ERROR_INVALID_DATA   Decoding failure. Unknown wire format.
+ */
+uint32_t ser_wire_format_set_req_dec(uint8_t const * const     p_buf,
+                                     uint32_t                  packet_len,
+                                     ser_wire_format_t * const p_format);
+
 
 #endif
 
@@ -0,0 +1,129 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdint.h>
+#include "ble_serialization.h"
+#include "app_util.h"
+#include "ser_bench.h"
+
+
+uint32_t ser_bench_evt_start_req_enc(ser_bench_evt_params_t const * const p_params,
+                                     uint8_t * const                      p_buf,
+                                     uint32_t * const                     p_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_params);
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_buf_len);
+    SER_ASSERT_LENGTH_LEQ(SER_OP_CODE_SIZE + SER_BENCH_EVT_PARAMS_SIZE, *p_buf_len);
+
+    uint32_t index = 0;
+
+    p_buf[index++] = SER_BENCH_OP_EVT_START;
+    index         += uint32_encode(p_params->rate, &p_buf[index]);
+    index         += uint32_encode(p_params->count, &p_buf[index]);
+    index         += uint16_encode(p_params->data_len, &p_buf[index]);
+
+    *p_buf_len = index;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_bench_evt_start_req_dec(uint8_t const * const          p_buf,
+                                     uint32_t                       packet_len,
+                                     ser_bench_evt_params_t * const p_params)
+{
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_params);
+    SER_ASSERT_LENGTH_EQ(SER_OP_CODE_SIZE + SER_BENCH_EVT_PARAMS_SIZE, packet_len);
+
+    uint32_t index = SER_OP_CODE_SIZE;
+
+    p_params->rate     = uint32_decode(&p_buf[index]);
+    index             += sizeof (uint32_t);
+    p_params->count    = uint32_decode(&p_buf[index]);
+    index             += sizeof (uint32_t);
+    p_params->data_len = uint16_decode(&p_buf[index]);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_bench_stats_get_rsp_enc(uint32_t                        return_code,
+                                     ser_bench_stats_t const * const p_stats,
+                                     uint8_t * const                 p_buf,
+                                     uint32_t * const                p_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_stats);
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_buf_len);
+
+    uint32_t buf_len  = *p_buf_len;
+    uint32_t index    = 0;
+    uint32_t err_code = op_status_enc(SER_BENCH_OP_STATS_GET, return_code,
+                                      p_buf, p_buf_len, &index);
+
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    if (return_code == NRF_SUCCESS)
+    {
+        SER_ASSERT_LENGTH_LEQ(index + SER_BENCH_STATS_SIZE, buf_len);
+
+        index += uint32_encode(p_stats->cmd_count, &p_buf[index]);
+        index += uint32_encode(p_stats->evt_count, &p_buf[index]);
+        index += uint32_encode(p_stats->evt_dropped, &p_buf[index]);
+        index += uint32_encode(p_stats->idle_ticks, &p_buf[index]);
+        index += uint32_encode(p_stats->total_ticks, &p_buf[index]);
+        index += uint32_encode(p_stats->tick_freq, &p_buf[index]);
+
+        *p_buf_len = index;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_bench_stats_get_rsp_dec(uint8_t const * const     p_buf,
+                                     uint32_t                  packet_len,
+                                     ser_bench_stats_t * const p_stats,
+                                     uint32_t * const          p_result_code)
+{
+    SER_ASSERT_NOT_NULL(p_stats);
+
+    uint32_t index    = 0;
+    uint32_t err_code = ser_ble_cmd_rsp_result_code_dec(p_buf, &index, packet_len,
+                                                        SER_BENCH_OP_STATS_GET, p_result_code);
+
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    if (*p_result_code != NRF_SUCCESS)
+    {
+        SER_ERROR_CHECK(index == packet_len, NRF_ERROR_DATA_SIZE);
+        return NRF_SUCCESS;
+    }
+
+    SER_ERROR_CHECK(index + SER_BENCH_STATS_SIZE == packet_len, NRF_ERROR_DATA_SIZE);
+
+    p_stats->cmd_count   = uint32_decode(&p_buf[index]);
+    index               += sizeof (uint32_t);
+    p_stats->evt_count   = uint32_decode(&p_buf[index]);
+    index               += sizeof (uint32_t);
+    p_stats->evt_dropped = uint32_decode(&p_buf[index]);
+    index               += sizeof (uint32_t);
+    p_stats->idle_ticks  = uint32_decode(&p_buf[index]);
+    index               += sizeof (uint32_t);
+    p_stats->total_ticks = uint32_decode(&p_buf[index]);
+    index               += sizeof (uint32_t);
+    p_stats->tick_freq   = uint32_decode(&p_buf[index]);
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ser_bench Serialization benchmark protocol
+ * @{
+ * @ingroup ble_sdk_lib_serialization
+ *
+ * @brief   Encoders and decoders of the benchmark commands.
+ *
+ * @details A Benchmark Command packet (@ref SER_PKT_TYPE_BENCH_CMD) carries an opcode
+ *          (@ref ser_bench_op_t) followed by opcode specific data. The connectivity chip answers
+ *          with a Benchmark Response packet (@ref SER_PKT_TYPE_BENCH_RESP) carrying the opcode,
+ *          the error code and opcode specific data, in the same layout as a Command Response.
+ *
+ *          - @ref SER_BENCH_OP_ECHO: any data, the response carries the same data.
+ *          - @ref SER_BENCH_OP_EVT_START: @ref ser_bench_evt_params_t, no response data.
+ *          - @ref SER_BENCH_OP_EVT_STOP: no data, no response data.
+ *          - @ref SER_BENCH_OP_STATS_GET: no data, the response carries @ref ser_bench_stats_t.
+ *
+ *          Synthetic events are @ref BLE_GATTS_EVT_WRITE events on connection handle 0 and
+ *          attribute handle @ref SER_BENCH_EVT_ATTR_HANDLE, encoded and sent like SoftDevice events.
+ */
+
+#ifndef SER_BENCH_H__
+#define SER_BENCH_H__
+
+#include <stdint.h>
+
+/** Attribute handle of the synthetic GATTS Write events. */
+#define SER_BENCH_EVT_ATTR_HANDLE     0xBE00
+
+/** Size of the encoded @ref ser_bench_evt_params_t structure. */
+#define SER_BENCH_EVT_PARAMS_SIZE     10
+
+/** Size of the encoded @ref ser_bench_stats_t structure. */
+#define SER_BENCH_STATS_SIZE          24
+
+/**@brief Benchmark command opcodes. */
+typedef enum
+{
+    SER_BENCH_OP_ECHO = 0,    /**< Loop the command data back in the response. */
+    SER_BENCH_OP_EVT_START,   /**< Start generating synthetic events. */
+    SER_BENCH_OP_EVT_STOP,    /**< Stop generating synthetic events. */
+    SER_BENCH_OP_STATS_GET,   /**< Read and restart the statistics. */
+    SER_BENCH_OP_MAX          /**< Upper bound. */
+} ser_bench_op_t;
+
+/**@brief Synthetic event generator parameters. */
+typedef struct
+{
+    uint32_t rate;            /**< Events generated per second. */
+    uint32_t count;           /**< Number of events to generate, 0 to generate until stopped. */
+    uint16_t data_len;        /**< Length of the attribute value carried by each event. */
+} ser_bench_evt_params_t;
+
+/**@brief Statistics gathered by the connectivity chip since the previous
+ *        @ref SER_BENCH_OP_STATS_GET command. */
+typedef struct
+{
+    uint32_t cmd_count;       /**< Number of Benchmark Command packets processed. */
+    uint32_t evt_count;       /**< Number of synthetic events passed to the event encoder. */
+    uint32_t evt_dropped;     /**< Number of synthetic events dropped because the event backlog
+                                   was full. */
+    uint32_t idle_ticks;      /**< Time spent waiting for events, in RTC ticks. */
+    uint32_t total_ticks;     /**< Length of the statistics window, in RTC ticks. */
+    uint32_t tick_freq;       /**< Frequency of the RTC ticks, in Hz. */
+} ser_bench_stats_t;
+
+/**@brief Function for encoding the @ref SER_BENCH_OP_EVT_START command.
+ *
+ * @param[in]      p_params     Generator parameters.
+ * @param[out]     p_buf        Buffer for the command (opcode + data).
+ * @param[in,out]  p_buf_len    \c in: size of the buffer, \c out: length of the command.
+ *
+ * @retval NRF_SUCCESS              Command encoded.
+ * @retval NRF_ERROR_NULL           NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH Buffer too small.
+ */
+uint32_t ser_bench_evt_start_req_enc(ser_bench_evt_params_t const * const p_params,
+                                     uint8_t * const                      p_buf,
+                                     uint32_t * const                     p_buf_len);
+
+/**@brief Function for decoding the @ref SER_BENCH_OP_EVT_START command.
+ *
+ * @param[in]      p_buf        Command (opcode + data).
+ * @param[in]      packet_len   Length of the command.
+ * @param[out]     p_params     Generator parameters.
+ *
+ * @retval NRF_SUCCESS              Command decoded.
+ * @retval NRF_ERROR_NULL           NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH Command length does not match.
+ */
+uint32_t ser_bench_evt_start_req_dec(uint8_t const * const          p_buf,
+                                     uint32_t                       packet_len,
+                                     ser_bench_evt_params_t * const p_params);
+
+/**@brief Function for encoding the @ref SER_BENCH_OP_STATS_GET response.
+ *
+ * @param[in]      return_code  Error code of the command.
+ * @param[in]      p_stats      Statistics, encoded only if @p return_code is NRF_SUCCESS.
+ * @param[out]     p_buf        Buffer for the response (opcode + error code + data).
+ * @param[in,out]  p_buf_len    \c in: size of the buffer, \c out: length of the response.
+ *
+ * @retval NRF_SUCCESS              Response encoded.
+ * @retval NRF_ERROR_NULL           NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH Buffer too small.
+ */
+uint32_t ser_bench_stats_get_rsp_enc(uint32_t                        return_code,
+                                     ser_bench_stats_t const * const p_stats,
+                                     uint8_t * const                 p_buf,
+                                     uint32_t * const                p_buf_len);
+
+/**@brief Function for decoding the @ref SER_BENCH_OP_STATS_GET response.
+ *
+ * @param[in]      p_buf          Response (opcode + error code + data).
+ * @param[in]      packet_len     Length of the response.
+ * @param[out]     p_stats        Statistics, valid if @p p_result_code is NRF_SUCCESS.
+ * @param[out]     p_result_code  Error code of the command.
+ *
+ * @retval NRF_SUCCESS              Response decoded.
+ * @retval NRF_ERROR_NULL           NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_DATA   Not a @ref SER_BENCH_OP_STATS_GET response.
+ * @retval NRF_ERROR_DATA_SIZE      Response length does not match.
+ */
+uint32_t ser_bench_stats_get_rsp_dec(uint8_t const * const     p_buf,
+                                     uint32_t                  packet_len,
+                                     ser_bench_stats_t * const p_stats,
+                                     uint32_t * const          p_result_code);
+
+#endif /* SER_BENCH_H__ */
+
+/** @} */
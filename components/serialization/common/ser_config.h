@@ -52,6 +52,63 @@
     #define SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE         SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE
 #endif /* SER_CONNECTIVITY */
 
+/** Maximum number of commands which the application chip can send before it receives the response
+ *  to the oldest one. Commands and responses are then tagged with a sequence ID
+ *  (@ref SER_PKT_TYPE_SEQ_CMD). Value 1 disables pipelining and keeps the stop-and-wait protocol.
+ *  Both chips must be built with the same value. */
+#define SER_PIPELINE_WINDOW_SIZE                      1
+
+/** Send @ref sd_ble_gattc_write without waiting for the response of the connectivity chip, when
+ *  pipelining is enabled. The function then returns NRF_SUCCESS as soon as the command is queued,
+ *  and the SoftDevice return code (for example BLE_ERROR_NO_TX_PACKETS or NRF_ERROR_BUSY) is only
+ *  passed to the handler set with @ref ser_sd_transport_async_rsp_handler_set. Enable it only if
+ *  the application checks the results in that handler. Value 0 keeps the function synchronous. */
+#define SER_GATTC_WRITE_ASYNC_ENABLED                 0
+
+/** Number of RX packet buffers in serialization HAL Transport layer. The connectivity chip needs one
+ *  buffer per outstanding command to queue pipelined commands while it is processing one. */
+#ifdef SER_CONNECTIVITY
+    #define SER_HAL_TRANSPORT_RX_BUF_COUNT            SER_PIPELINE_WINDOW_SIZE
+#else
+    #define SER_HAL_TRANSPORT_RX_BUF_COUNT            1
+#endif /* SER_CONNECTIVITY */
+
+/** Number of TX buffers the connectivity chip can fill with encoded BLE events ahead of the
+ *  transmission. A non-zero value enables the zero-copy event path: BLE events are pulled from the
+ *  SoftDevice and encoded directly into HAL Transport TX buffers instead of being copied into the
+ *  application scheduler queue. Value 0 keeps the scheduler based event path. */
+#define SER_CONN_EVT_TX_SLOT_COUNT                    0
+
+/** Number of TX packet buffers in serialization HAL Transport layer. One buffer on the connectivity
+ *  side is always left for a command response. The application side can queue one buffer per
+ *  outstanding command. */
+#ifdef SER_CONNECTIVITY
+    #define SER_HAL_TRANSPORT_TX_BUF_COUNT            (SER_CONN_EVT_TX_SLOT_COUNT + 1)
+#else
+    #define SER_HAL_TRANSPORT_TX_BUF_COUNT            SER_PIPELINE_WINDOW_SIZE
+#endif /* SER_CONNECTIVITY */
+
+/** Maximum size of a frame carrying several packets. When non-zero, packets queued in the HAL
+ *  Transport layer while the PHY layer is busy are sent together in one frame, each preceded by
+ *  a 16-bit length field, and the receiving side splits the frame back into packets. Packets are
+ *  never held back to wait for more packets. Value 0 disables batching. Both chips must be built
+ *  with the same value, which must not exceed the maximum packet size in either direction. */
+#define SER_HAL_TRANSPORT_BATCH_MAX_SIZE              0
+
+/** Support the compact wire format for the events which have a compact encoding (GATTS write,
+ *  advertising report) on the connectivity chip. The connectivity chip starts in the standard
+ *  format after every reset, and switches to the compact format only when the application chip
+ *  requests it with ser_app_wire_format_request(). An application chip which does not send the
+ *  request, for example one built from an older SDK, keeps receiving the standard format. If this
+ *  setting is 0, the request is answered with NRF_ERROR_NOT_SUPPORTED. */
+#define SER_WIRE_FORMAT_COMPACT_ENABLED               0
+
+/** Build the connectivity chip with the benchmark mode. The connectivity chip then answers
+ *  @ref SER_PKT_TYPE_BENCH_CMD packets: it loops back their payload and generates synthetic BLE
+ *  events at a requested rate, and it measures how much time it spends waiting for events. Only
+ *  the connectivity chip has to be rebuilt to change this setting. */
+#define SER_CONN_BENCHMARK_ENABLED                    0
+
 
 /***********************************************************************************************//**
  * SER_PHY layer configuration.
@@ -69,6 +126,14 @@
 #define SER_PHY_UART_PARITY             true
 #define SER_PHY_UART_BAUDRATE           UART_BAUDRATE_BAUDRATE_Baud1M
 
+/** Number of unacknowledged packets the HCI PHY may have in flight (1 to 7). Value 1 keeps the
+ *  stop-and-wait protocol. With a larger value lost packets are retransmitted go-back-N style.
+ *  With HCI_LINK_CONTROL defined the window is agreed with the peer in the CONFIG exchange,
+ *  otherwise both chips must be built with the same value. */
+#ifndef SER_PHY_HCI_WINDOW_SIZE
+#define SER_PHY_HCI_WINDOW_SIZE         1
+#endif
+
 /** Find UART baudrate value based on chosen register setting. */
 #if (SER_PHY_UART_BAUDRATE == UART_BAUDRATE_BAUDRATE_Baud1200)
     #define SER_PHY_UART_BAUDRATE_VAL 1200uL
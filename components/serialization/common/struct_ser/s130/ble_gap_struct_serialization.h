@@ -12,6 +12,9 @@
 
 #include "ble_gap.h"
 
+/** Set in the address type byte of a compact advertising report when the connection handle follows. */
+#define SER_ADV_REPORT_COMPACT_CONN_HANDLE_FLAG 0x80
+
 uint32_t ble_gap_irk_enc(void const * const p_data,
                          uint8_t * const    p_buf,
                          uint32_t           buf_len,
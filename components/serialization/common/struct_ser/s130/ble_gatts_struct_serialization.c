@@ -520,6 +520,144 @@ uint32_t ble_gatts_evt_write_t_dec(uint8_t const * const p_buf,
     return err_code;
 }
 
+/* Compact encoding of ble_gatts_evt_write_t:
+ * handle (varint), flags, [uuid (uint16)], [uuid type], [offset (varint)], len (varint), data.
+ * The flags byte holds the operation, the authorization flag, the offset present flag and the UUID
+ * type; UUID type values which do not fit are sent in a separate byte. */
+#define GATTS_WRITE_COMPACT_OP_MASK        0x07 /**< Write operation. */
+#define GATTS_WRITE_COMPACT_AUTH_REQUIRED  0x08 /**< Authorization required. */
+#define GATTS_WRITE_COMPACT_OFFSET_PRESENT 0x10 /**< Non-zero offset follows. */
+#define GATTS_WRITE_COMPACT_UUID_TYPE_POS  5    /**< Position of the UUID type. */
+#define GATTS_WRITE_COMPACT_UUID_TYPE_EXT  7    /**< UUID type is sent in a separate byte. */
+
+uint32_t ble_gatts_evt_write_t_compact_enc(void const * const p_void_write,
+                                           uint8_t * const    p_buf,
+                                           uint32_t           buf_len,
+                                           uint32_t * const   p_index)
+{
+    ble_gatts_evt_write_t * p_write    = (ble_gatts_evt_write_t *) p_void_write;
+    uint32_t                error_code = NRF_SUCCESS;
+    uint8_t                 uuid_type  = MIN(p_write->uuid.type, GATTS_WRITE_COMPACT_UUID_TYPE_EXT);
+    uint8_t                 flags;
+
+    SER_ASSERT_LENGTH_LEQ(p_write->op, GATTS_WRITE_COMPACT_OP_MASK);
+
+    flags = p_write->op | (uuid_type << GATTS_WRITE_COMPACT_UUID_TYPE_POS);
+    if (p_write->auth_required)
+    {
+        flags |= GATTS_WRITE_COMPACT_AUTH_REQUIRED;
+    }
+    if (p_write->offset != 0)
+    {
+        flags |= GATTS_WRITE_COMPACT_OFFSET_PRESENT;
+    }
+
+    error_code = varint16_enc(&(p_write->handle), p_buf, buf_len, p_index);
+    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+
+    error_code = uint8_t_enc(&flags, p_buf, buf_len, p_index);
+    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+
+    if (uuid_type != BLE_UUID_TYPE_UNKNOWN)
+    {
+        error_code = uint16_t_enc(&(p_write->uuid.uuid), p_buf, buf_len, p_index);
+        SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+    }
+
+    if (uuid_type == GATTS_WRITE_COMPACT_UUID_TYPE_EXT)
+    {
+        error_code = uint8_t_enc(&(p_write->uuid.type), p_buf, buf_len, p_index);
+        SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+    }
+
+    if (p_write->offset != 0)
+    {
+        error_code = varint16_enc(&(p_write->offset), p_buf, buf_len, p_index);
+        SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+    }
+
+    error_code = varint16_enc(&(p_write->len), p_buf, buf_len, p_index);
+    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
+    SER_ASSERT_LENGTH_LEQ(p_write->len, buf_len - *p_index);
+    memcpy(&p_buf[*p_index], p_write->data, p_write->len);
+    *p_index += p_write->len;
+
+    return error_code;
+}
+
+uint32_t ble_gatts_evt_write_t_compact_dec(uint8_t const * const p_buf,
+                                           uint32_t              buf_len,
+                                           uint32_t * const      p_index,
+                                           uint32_t * const      p_struct_len,
+                                           void * const          p_void_write)
+{
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_index);
+    SER_ASSERT_NOT_NULL(p_struct_len);
+
+    uint32_t   err_code      = NRF_SUCCESS;
+    uint32_t   in_struct_len = *p_struct_len;
+    uint16_t   handle;
+    uint8_t    flags;
+    ble_uuid_t uuid   = {0};
+    uint16_t   offset = 0;
+    uint16_t   len;
+
+    *p_struct_len = offsetof(ble_gatts_evt_write_t, data);
+
+    err_code = varint16_dec(p_buf, buf_len, p_index, &handle);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_t_dec(p_buf, buf_len, p_index, &flags);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    uuid.type = flags >> GATTS_WRITE_COMPACT_UUID_TYPE_POS;
+
+    if (uuid.type != BLE_UUID_TYPE_UNKNOWN)
+    {
+        err_code = uint16_t_dec(p_buf, buf_len, p_index, &(uuid.uuid));
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    if (uuid.type == GATTS_WRITE_COMPACT_UUID_TYPE_EXT)
+    {
+        err_code = uint8_t_dec(p_buf, buf_len, p_index, &(uuid.type));
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    if (flags & GATTS_WRITE_COMPACT_OFFSET_PRESENT)
+    {
+        err_code = varint16_dec(p_buf, buf_len, p_index, &offset);
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    err_code = varint16_dec(p_buf, buf_len, p_index, &len);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    SER_ASSERT_LENGTH_LEQ(len, buf_len - *p_index);
+
+    *p_struct_len += len;
+
+    if (p_void_write != NULL)
+    {
+        ble_gatts_evt_write_t * p_write = (ble_gatts_evt_write_t *)p_void_write;
+
+        SER_ASSERT_LENGTH_LEQ(*p_struct_len, in_struct_len);
+
+        p_write->handle        = handle;
+        p_write->uuid          = uuid;
+        p_write->op            = flags & GATTS_WRITE_COMPACT_OP_MASK;
+        p_write->auth_required = (flags & GATTS_WRITE_COMPACT_AUTH_REQUIRED) ? 1 : 0;
+        p_write->offset        = offset;
+        p_write->len           = len;
+
+        memcpy(p_write->data, &p_buf[*p_index], p_write->len);
+    }
+
+    *p_index += len;
+
+    return err_code;
+}
+
 uint32_t ble_gatts_evt_read_t_enc(void const * const p_void_read,
                                   uint8_t * const    p_buf,
                                   uint32_t           buf_len,
@@ -75,6 +75,17 @@ uint32_t ble_gatts_evt_write_t_dec(uint8_t const * const p_buf,
                                    uint32_t * const      p_struct_len,
                                    void * const          p_void_write);
 
+uint32_t ble_gatts_evt_write_t_compact_enc(void const * const p_void_write,
+                                           uint8_t * const    p_buf,
+                                           uint32_t           buf_len,
+                                           uint32_t * const   p_index);
+
+uint32_t ble_gatts_evt_write_t_compact_dec(uint8_t const * const p_buf,
+                                           uint32_t              buf_len,
+                                           uint32_t * const      p_index,
+                                           uint32_t * const      p_struct_len,
+                                           void * const          p_void_write);
+
 uint32_t ble_gatts_hvx_params_t_enc(void const * const p_void_hvx_params,
                                     uint8_t * const    p_buf,
                                     uint32_t           buf_len,
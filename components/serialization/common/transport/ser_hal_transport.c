@@ -13,10 +13,23 @@
 #include <stdbool.h>
 #include <string.h>
 #include "app_error.h"
+#include "app_util.h"
 #include "ser_config.h"
 #include "ser_phy.h"
 #include "ser_hal_transport.h"
 
+#if (SER_HAL_TRANSPORT_BATCH_MAX_SIZE > 0)
+/**
+ * @brief Size of the length field preceding every packet in a frame.
+ */
+#define HAL_TRANSP_BATCH_LEN_SIZE    2
+STATIC_ASSERT(SER_HAL_TRANSPORT_BATCH_MAX_SIZE <= SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE);
+// Both chips batch up to the same size, so the frames of the peer must also fit in an RX buffer.
+STATIC_ASSERT(SER_HAL_TRANSPORT_BATCH_MAX_SIZE <= SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE);
+#else
+#define HAL_TRANSP_BATCH_LEN_SIZE    0
+#endif
+
 /**
  * @brief States of the RX state machine.
  */
@@ -26,9 +39,7 @@ typedef enum
     HAL_TRANSP_RX_STATE_IDLE,
     HAL_TRANSP_RX_STATE_RECEIVING,
     HAL_TRANSP_RX_STATE_DROPPING,
-    HAL_TRANSP_RX_STATE_RECEIVED,
-    HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ,
-    HAL_TRANSP_RX_STATE_RECEIVED_DROPPING,
+    HAL_TRANSP_RX_STATE_PENDING_BUF_REQ,
     HAL_TRANSP_RX_STATE_MAX
 }ser_hal_transp_rx_states_t;
 
@@ -55,13 +66,58 @@ static ser_hal_transp_rx_states_t m_rx_state = HAL_TRANSP_RX_STATE_CLOSED;
 static ser_hal_transp_tx_states_t m_tx_state = HAL_TRANSP_TX_STATE_CLOSED;
 
 /**
- * @brief Transmission buffer.
+ * @brief Transmission buffers.
+ */
+static uint8_t m_tx_buffer[SER_HAL_TRANSPORT_TX_BUF_COUNT][SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+/**
+ * @brief States of the transmission buffers.
+ */
+static ser_hal_transp_tx_states_t m_tx_buffer_state[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Lengths of the packets stored in the transmission buffers.
+ */
+static uint16_t m_tx_buffer_len[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Queue of transmission buffers in order of sending. The first buffer in the queue is being
+ *        transmitted by the PHY layer.
+ */
+static uint8_t m_tx_queue[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Index of the first buffer in the transmission queue.
+ */
+static uint8_t m_tx_queue_start_index = 0;
+/**
+ * @brief Number of buffers in the transmission queue.
+ */
+static volatile uint8_t m_tx_queue_count = 0;
+/**
+ * @brief Number of buffers from the beginning of the transmission queue which are being transmitted
+ *        in the current frame. Zero if the PHY layer is idle.
  */
-static uint8_t m_tx_buffer[SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+static uint8_t m_tx_frame_pkt_count = 0;
 /**
- * @brief Reception buffer.
+ * @brief Frame passed to the PHY layer.
  */
-static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+static uint8_t * mp_tx_frame = NULL;
+#if (SER_HAL_TRANSPORT_BATCH_MAX_SIZE > 0)
+/**
+ * @brief Buffer for a frame carrying more than one packet.
+ */
+static uint8_t m_tx_batch_buffer[SER_HAL_TRANSPORT_BATCH_MAX_SIZE];
+#endif
+/**
+ * @brief Reception buffers.
+ */
+static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_BUF_COUNT][SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+/**
+ * @brief Number of packets in every reception buffer which are owned by the PHY or by an upper
+ *        layer. A buffer is free when the count is zero.
+ */
+static uint8_t m_rx_buffer_used[SER_HAL_TRANSPORT_RX_BUF_COUNT];
+/**
+ * @brief Reception buffer passed to the PHY layer for the packet being received.
+ */
+static uint8_t * mp_rx_buffer_receiving = NULL;
 
 /**
  * @brief Callback function handler for Serialization HAL Transport layer events.
@@ -69,6 +125,259 @@ static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
 static ser_hal_transport_events_handler_t m_events_handler = NULL;
 
 
+/**
+ * @brief Function for finding the index of a reception buffer.
+ *
+ * @param[in] p_buffer    Pointer to a packet in a buffer. Packets unpacked from a batched frame
+ *                        do not start at the beginning of the buffer.
+ *
+ * @return    Index of the buffer or SER_HAL_TRANSPORT_RX_BUF_COUNT if the buffer does not belong to
+ *            this module.
+ */
+static uint32_t rx_buffer_index_get(uint8_t const * p_buffer)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_RX_BUF_COUNT; i++)
+    {
+        if ((p_buffer >= m_rx_buffer[i]) &&
+            (p_buffer < (m_rx_buffer[i] + SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE)))
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+/**
+ * @brief Function for finding the index of a transmission buffer.
+ *
+ * @param[in] p_buffer    Pointer to the packet in a buffer, as returned by
+ *                        @ref ser_hal_transport_tx_pkt_alloc.
+ *
+ * @return    Index of the buffer or SER_HAL_TRANSPORT_TX_BUF_COUNT if the buffer does not belong to
+ *            this module.
+ */
+static uint32_t tx_buffer_index_get(uint8_t const * p_buffer)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+    {
+        if (p_buffer == &m_tx_buffer[i][HAL_TRANSP_BATCH_LEN_SIZE])
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+/**
+ * @brief Function for passing a frame with the packets from the beginning of the transmission queue
+ *        to the PHY layer.
+ *
+ * @details When batching is enabled, every packet is preceded by its length and all packets queued
+ *          while the previous frame was being transmitted are sent in one frame, as long as they fit
+ *          in @ref SER_HAL_TRANSPORT_BATCH_MAX_SIZE.
+ *
+ * @retval    NRF_SUCCESS           Transmission has started.
+ * @retval    NRF_ERROR_BUSY        PHY layer is busy.
+ * @retval    NRF_ERROR_INTERNAL    PHY layer failed to start the transmission.
+ */
+static uint32_t tx_frame_send(void)
+{
+    uint32_t  err_code;
+    uint8_t   index     = m_tx_queue[m_tx_queue_start_index];
+    uint8_t   pkt_count = 1;
+    uint8_t * p_frame   = m_tx_buffer[index];
+    uint16_t  frame_len = m_tx_buffer_len[index] + HAL_TRANSP_BATCH_LEN_SIZE;
+
+#if (SER_HAL_TRANSPORT_BATCH_MAX_SIZE > 0)
+    (void)uint16_encode(m_tx_buffer_len[index], p_frame);
+
+    while (pkt_count < m_tx_queue_count)
+    {
+        uint16_t pkt_len;
+
+        index   = m_tx_queue[(m_tx_queue_start_index + pkt_count) % SER_HAL_TRANSPORT_TX_BUF_COUNT];
+        pkt_len = m_tx_buffer_len[index] + HAL_TRANSP_BATCH_LEN_SIZE;
+
+        if ((frame_len + pkt_len) > SER_HAL_TRANSPORT_BATCH_MAX_SIZE)
+        {
+            break;
+        }
+
+        /* The first packet is moved to the batch buffer when a second one is added. */
+        if (1 == pkt_count)
+        {
+            memcpy(m_tx_batch_buffer, p_frame, frame_len);
+            p_frame = m_tx_batch_buffer;
+        }
+
+        (void)uint16_encode(m_tx_buffer_len[index], &m_tx_buffer[index][0]);
+        memcpy(&p_frame[frame_len], &m_tx_buffer[index][0], pkt_len);
+        frame_len += pkt_len;
+        pkt_count++;
+    }
+#endif
+
+    err_code = ser_phy_tx_pkt_send(p_frame, frame_len);
+
+    if (NRF_SUCCESS == err_code)
+    {
+        mp_tx_frame          = p_frame;
+        m_tx_frame_pkt_count = pkt_count;
+    }
+    else if (NRF_ERROR_BUSY != err_code)
+    {
+        err_code = NRF_ERROR_INTERNAL;
+    }
+
+    return err_code;
+}
+
+
+/**
+ * @brief Function for removing the transmitted packets from the transmission queue, releasing their
+ *        buffers and starting a transmission of the next frame.
+ *
+ * @return    Number of released packets.
+ */
+static uint8_t tx_frame_release(void)
+{
+    uint32_t err_code;
+    uint8_t  index;
+    uint8_t  pkt_count = m_tx_frame_pkt_count;
+
+    for (uint8_t i = 0; i < pkt_count; i++)
+    {
+        index                    = m_tx_queue[m_tx_queue_start_index];
+        m_tx_buffer_state[index] = HAL_TRANSP_TX_STATE_TRANSMITTED;
+        m_tx_queue_start_index   = (m_tx_queue_start_index + 1) % SER_HAL_TRANSPORT_TX_BUF_COUNT;
+        m_tx_queue_count--;
+
+        err_code = ser_hal_transport_tx_pkt_free(&m_tx_buffer[index][HAL_TRANSP_BATCH_LEN_SIZE]);
+        APP_ERROR_CHECK(err_code);
+    }
+
+    mp_tx_frame          = NULL;
+    m_tx_frame_pkt_count = 0;
+
+    if (m_tx_queue_count > 0)
+    {
+        err_code = tx_frame_send();
+        APP_ERROR_CHECK(err_code);
+    }
+
+    return pkt_count;
+}
+
+
+/**
+ * @brief Function for taking a free reception buffer.
+ *
+ * @return    Pointer to the buffer or NULL if all buffers are in use.
+ */
+static uint8_t * rx_buffer_alloc(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_RX_BUF_COUNT; i++)
+    {
+        if (0 == m_rx_buffer_used[i])
+        {
+            m_rx_buffer_used[i] = 1;
+            return m_rx_buffer[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Function for passing a free reception buffer to the PHY layer.
+ *
+ * @retval    true     Buffer was passed, receiving has started.
+ * @retval    false    All buffers are in use.
+ */
+static bool rx_buffer_set(void)
+{
+    uint32_t  err_code;
+    uint8_t * p_buffer = rx_buffer_alloc();
+
+    if (NULL == p_buffer)
+    {
+        return false;
+    }
+
+    mp_rx_buffer_receiving = p_buffer;
+    m_rx_state             = HAL_TRANSP_RX_STATE_RECEIVING;
+
+    err_code = ser_phy_rx_buf_set(p_buffer);
+    APP_ERROR_CHECK(err_code);
+
+    return true;
+}
+
+
+#if (SER_HAL_TRANSPORT_BATCH_MAX_SIZE > 0)
+/**
+ * @brief Function for splitting a received frame into packets and passing them to an upper layer.
+ *
+ * @details Every packet is passed in its own @ref SER_HAL_TRANSP_EVT_RX_PKT_RECEIVED event and has to
+ *          be freed separately. The reception buffer is reused when all its packets are freed.
+ *          A malformed frame is dropped.
+ *
+ * @param[in] p_frame      Pointer to the beginning of the reception buffer.
+ * @param[in] frame_len    Length of the received frame.
+ */
+static void rx_frame_unpack(uint8_t * p_frame, uint16_t frame_len)
+{
+    ser_hal_transport_evt_t hal_transp_event;
+    uint32_t                index     = rx_buffer_index_get(p_frame);
+    uint32_t                offset    = 0;
+    uint8_t                 pkt_count = 0;
+    uint16_t                pkt_len;
+
+    memset(&hal_transp_event, 0, sizeof (ser_hal_transport_evt_t));
+
+    /* Count the packets first, the buffer must stay in use until the last packet is freed. */
+    while ((offset + HAL_TRANSP_BATCH_LEN_SIZE) <= frame_len)
+    {
+        pkt_len = uint16_decode(&p_frame[offset]);
+        offset += HAL_TRANSP_BATCH_LEN_SIZE + pkt_len;
+        pkt_count++;
+    }
+
+    if ((0 == pkt_count) || (offset != frame_len))
+    {
+        m_rx_buffer_used[index]   = 0;
+        hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_DROPPED;
+        m_events_handler(hal_transp_event);
+        return;
+    }
+
+    m_rx_buffer_used[index]   = pkt_count;
+    hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_RECEIVED;
+
+    for (offset = 0; offset < frame_len; offset += HAL_TRANSP_BATCH_LEN_SIZE + pkt_len)
+    {
+        /* The buffer can be reused as soon as the last packet is freed by the event handler. */
+        pkt_len = uint16_decode(&p_frame[offset]);
+        hal_transp_event.evt_params.rx_pkt_received.p_buffer     =
+            &p_frame[offset + HAL_TRANSP_BATCH_LEN_SIZE];
+        hal_transp_event.evt_params.rx_pkt_received.num_of_bytes = pkt_len;
+        m_events_handler(hal_transp_event);
+    }
+}
+#endif
+
+
 /**
  * @brief A callback function to be used to handle a PHY module events. This function is called in
  *        an interrupt context.
@@ -85,14 +394,16 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
     {
         case SER_PHY_EVT_TX_PKT_SENT:
         {
-            if (HAL_TRANSP_TX_STATE_TRANSMITTING == m_tx_state)
+            if (m_tx_frame_pkt_count > 0)
             {
-                m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTED;
-                err_code   = ser_hal_transport_tx_pkt_free(m_tx_buffer);
-                APP_ERROR_CHECK(err_code);
-                /* An event to an upper layer that a packet has been transmitted. */
+                uint8_t pkt_count = tx_frame_release();
+
+                /* An event to an upper layer for every packet that has been transmitted. */
                 hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_TX_PKT_SENT;
-                m_events_handler(hal_transp_event);
+                while (pkt_count-- > 0)
+                {
+                    m_events_handler(hal_transp_event);
+                }
             }
             else
             {
@@ -107,51 +418,31 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
             /* An event to an upper layer that a packet is being scheduled to receive or to drop. */
             hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_RECEIVING;
 
+            if (HAL_TRANSP_RX_STATE_IDLE != m_rx_state)
+            {
+                /* Lower layer should not generate this event in current state. */
+                APP_ERROR_CHECK_BOOL(false);
+            }
             /* Receive or drop a packet. */
-            if (phy_event.evt_params.rx_buf_request.num_of_bytes <= sizeof (m_rx_buffer))
+            else if (phy_event.evt_params.rx_buf_request.num_of_bytes <=
+                     SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE)
             {
-                if (HAL_TRANSP_RX_STATE_IDLE == m_rx_state)
-                {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(m_rx_buffer);
-                    APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVING;
-                }
-                else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
-                {
-                    /* It is OK to get know higher layer at this point that we are going to receive
-                     * a new packet even though we will start receiving when rx buffer is freed. */
-                    m_events_handler(hal_transp_event);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ;
-                }
-                else
+                /* It is OK to get know higher layer at this point that we are going to receive
+                 * a new packet even though we will start receiving when rx buffer is freed. */
+                m_events_handler(hal_transp_event);
+
+                if (!rx_buffer_set())
                 {
-                    /* Lower layer should not generate this event in current state. */
-                    APP_ERROR_CHECK_BOOL(false);
+                    m_rx_state = HAL_TRANSP_RX_STATE_PENDING_BUF_REQ;
                 }
             }
             else
             {
                 /* There is not enough memory but packet has to be received to dummy location. */
-                if (HAL_TRANSP_RX_STATE_IDLE == m_rx_state)
-                {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(NULL);
-                    APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
-                }
-                else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
-                {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(NULL);
-                    APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED_DROPPING;
-                }
-                else
-                {
-                    /* Lower layer should not generate this event in current state. */
-                    APP_ERROR_CHECK_BOOL(false);
-                }
+                m_events_handler(hal_transp_event);
+                err_code = ser_phy_rx_buf_set(NULL);
+                APP_ERROR_CHECK(err_code);
+                m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
             }
             break;
         }
@@ -160,7 +451,13 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
         {
             if (HAL_TRANSP_RX_STATE_RECEIVING == m_rx_state)
             {
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
+                /* The buffer stays in use until the upper layer frees it. */
+                m_rx_state             = HAL_TRANSP_RX_STATE_IDLE;
+                mp_rx_buffer_receiving = NULL;
+#if (SER_HAL_TRANSPORT_BATCH_MAX_SIZE > 0)
+                rx_frame_unpack(phy_event.evt_params.rx_pkt_received.p_buffer,
+                                phy_event.evt_params.rx_pkt_received.num_of_bytes);
+#else
                 /* Generate the event to an upper layer. */
                 hal_transp_event.evt_type =
                     SER_HAL_TRANSP_EVT_RX_PKT_RECEIVED;
@@ -169,6 +466,7 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
                 hal_transp_event.evt_params.rx_pkt_received.num_of_bytes =
                     phy_event.evt_params.rx_pkt_received.num_of_bytes;
                 m_events_handler(hal_transp_event);
+#endif
             }
             else
             {
@@ -187,13 +485,6 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
                 m_events_handler(hal_transp_event);
                 m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
             }
-            else if (HAL_TRANSP_RX_STATE_RECEIVED_DROPPING == m_rx_state)
-            {
-                /* Generate the event to an upper layer. */
-                hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_DROPPED;
-                m_events_handler(hal_transp_event);
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
-            }
             else
             {
                 /* Lower layer should not generate this event in current state. */
@@ -230,17 +521,16 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
                 SER_HAL_TRANSP_PHY_ERROR_HW_ERROR;
             hal_transp_event.evt_params.phy_error.hw_error_code =
                 phy_event.evt_params.hw_error.error_code;
-            if (HAL_TRANSP_TX_STATE_TRANSMITTING == m_tx_state)
+            if ((m_tx_frame_pkt_count > 0) &&
+                (phy_event.evt_params.hw_error.p_buffer == mp_tx_frame))
             {
-                m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTED;
-                err_code   = ser_hal_transport_tx_pkt_free(phy_event.evt_params.hw_error.p_buffer);
-                APP_ERROR_CHECK(err_code);
-                /* An event to an upper layer that a packet has been transmitted. */
+                (void)tx_frame_release();
             }
             else if (HAL_TRANSP_RX_STATE_RECEIVING == m_rx_state)
             {
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
-                err_code   = ser_hal_transport_rx_pkt_free(phy_event.evt_params.hw_error.p_buffer);
+                m_rx_state             = HAL_TRANSP_RX_STATE_IDLE;
+                mp_rx_buffer_receiving = NULL;
+                err_code = ser_hal_transport_rx_pkt_free(phy_event.evt_params.hw_error.p_buffer);
                 APP_ERROR_CHECK(err_code);
             }
             m_events_handler(hal_transp_event);
@@ -276,6 +566,18 @@ uint32_t ser_hal_transport_open(ser_hal_transport_events_handler_t events_handle
         m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
         m_tx_state = HAL_TRANSP_TX_STATE_IDLE;
 
+        memset(m_rx_buffer_used, 0, sizeof (m_rx_buffer_used));
+        mp_rx_buffer_receiving = NULL;
+
+        for (uint32_t i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+        {
+            m_tx_buffer_state[i] = HAL_TRANSP_TX_STATE_IDLE;
+        }
+        m_tx_queue_start_index = 0;
+        m_tx_queue_count       = 0;
+        m_tx_frame_pkt_count   = 0;
+        mp_tx_frame            = NULL;
+
         m_events_handler = events_handler;
 
         /* Initialize a PHY module. */
@@ -314,43 +616,35 @@ void ser_hal_transport_close(void)
 uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t index;
 
     ser_phy_interrupts_disable();
 
+    index = rx_buffer_index_get(p_buffer);
+
     if (NULL == p_buffer)
     {
         err_code = NRF_ERROR_NULL;
     }
-    else if (p_buffer != m_rx_buffer)
+    else if (SER_HAL_TRANSPORT_RX_BUF_COUNT == index)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
+    else if ((0 == m_rx_buffer_used[index]) || (m_rx_buffer[index] == mp_rx_buffer_receiving))
     {
-        m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
-    }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED_DROPPING == m_rx_state)
-    {
-        m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
+        /* Upper layer should not call this function in current state. */
+        err_code = NRF_ERROR_INVALID_STATE;
     }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ == m_rx_state)
+    else
     {
-        err_code = ser_phy_rx_buf_set(m_rx_buffer);
+        /* A buffer holding a batched frame is released with the last of its packets. */
+        m_rx_buffer_used[index]--;
 
-        if (NRF_SUCCESS == err_code)
-        {
-            m_rx_state = HAL_TRANSP_RX_STATE_RECEIVING;
-        }
-        else
+        if ((0 == m_rx_buffer_used[index]) && (HAL_TRANSP_RX_STATE_PENDING_BUF_REQ == m_rx_state))
         {
-            err_code = NRF_ERROR_INTERNAL;
+            (void)rx_buffer_set();
         }
     }
-    else
-    {
-        /* Upper layer should not call this function in current state. */
-        err_code = NRF_ERROR_INVALID_STATE;
-    }
     ser_phy_interrupts_enable();
 
     return err_code;
@@ -360,6 +654,7 @@ uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
 uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_of_bytes)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t i;
 
     if ((NULL == pp_memory) || (NULL == p_num_of_bytes))
     {
@@ -369,15 +664,24 @@ uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_
     {
         err_code = NRF_ERROR_INVALID_STATE;
     }
-    else if (HAL_TRANSP_TX_STATE_IDLE == m_tx_state)
-    {
-        m_tx_state      = HAL_TRANSP_TX_STATE_TX_ALLOCATED;
-        *pp_memory      = &m_tx_buffer[0];
-        *p_num_of_bytes = (uint16_t)sizeof (m_tx_buffer);
-    }
     else
     {
         err_code = NRF_ERROR_NO_MEM;
+
+        ser_phy_interrupts_disable();
+        for (i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+        {
+            if (HAL_TRANSP_TX_STATE_IDLE == m_tx_buffer_state[i])
+            {
+                m_tx_buffer_state[i] = HAL_TRANSP_TX_STATE_TX_ALLOCATED;
+                *pp_memory           = &m_tx_buffer[i][HAL_TRANSP_BATCH_LEN_SIZE];
+                *p_num_of_bytes      = (uint16_t)(sizeof (m_tx_buffer[i]) -
+                                                  HAL_TRANSP_BATCH_LEN_SIZE);
+                err_code             = NRF_SUCCESS;
+                break;
+            }
+        }
+        ser_phy_interrupts_enable();
     }
 
     return err_code;
@@ -387,6 +691,7 @@ uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_
 uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t index    = tx_buffer_index_get(p_buffer);
 
     /* The buffer provided to this function must be allocated through ser_hal_transport_tx_alloc()
      * function - this assures correct state and that correct memory buffer is used. */
@@ -398,29 +703,33 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
     {
         err_code = NRF_ERROR_INVALID_PARAM;
     }
-    else if (p_buffer != m_tx_buffer)
+    else if (SER_HAL_TRANSPORT_TX_BUF_COUNT == index)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if (num_of_bytes > sizeof (m_tx_buffer))
+    else if (num_of_bytes > (sizeof (m_tx_buffer[index]) - HAL_TRANSP_BATCH_LEN_SIZE))
     {
         err_code = NRF_ERROR_DATA_SIZE;
     }
-    else if (HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_state)
+    else if ((HAL_TRANSP_TX_STATE_CLOSED != m_tx_state) &&
+             (HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_buffer_state[index]))
     {
         ser_phy_interrupts_disable();
-        err_code = ser_phy_tx_pkt_send(p_buffer, num_of_bytes);
+        m_tx_buffer_len[index] = num_of_bytes;
+        m_tx_queue[(m_tx_queue_start_index + m_tx_queue_count) % SER_HAL_TRANSPORT_TX_BUF_COUNT] =
+            (uint8_t)index;
 
-        if (NRF_SUCCESS == err_code)
+        /* Buffers queued behind the frame being transmitted are passed to the PHY layer when the
+         * transmission in progress completes. */
+        if (0 == m_tx_queue_count)
         {
-            m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTING;
+            err_code = tx_frame_send();
         }
-        else
+
+        if (NRF_SUCCESS == err_code)
         {
-            if (NRF_ERROR_BUSY != err_code)
-            {
-                err_code = NRF_ERROR_INTERNAL;
-            }
+            m_tx_buffer_state[index] = HAL_TRANSP_TX_STATE_TRANSMITTING;
+            m_tx_queue_count++;
         }
         ser_phy_interrupts_enable();
     }
@@ -436,20 +745,21 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
 uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t index    = tx_buffer_index_get(p_buffer);
 
     if (NULL == p_buffer)
     {
         err_code = NRF_ERROR_NULL;
     }
-    else if (p_buffer != m_tx_buffer)
+    else if (SER_HAL_TRANSPORT_TX_BUF_COUNT == index)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if ((HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_state) ||
-             (HAL_TRANSP_TX_STATE_TRANSMITTED == m_tx_state))
+    else if ((HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_buffer_state[index]) ||
+             (HAL_TRANSP_TX_STATE_TRANSMITTED == m_tx_buffer_state[index]))
     {
         /* Release TX buffer for use. */
-        m_tx_state = HAL_TRANSP_TX_STATE_IDLE;
+        m_tx_buffer_state[index] = HAL_TRANSP_TX_STATE_IDLE;
     }
     else
     {
@@ -458,3 +768,20 @@ uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer)
 
     return err_code;
 }
+
+
+uint32_t ser_hal_transport_tx_free_buf_count_get(void)
+{
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+    {
+        if (HAL_TRANSP_TX_STATE_IDLE == m_tx_buffer_state[i])
+        {
+            count++;
+        }
+    }
+
+    return (HAL_TRANSP_TX_STATE_CLOSED == m_tx_state) ? 0 : count;
+}
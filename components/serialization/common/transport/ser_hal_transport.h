@@ -227,5 +227,16 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
 uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer);
 
 
+/**@brief A function for getting the number of TX buffers available for allocation.
+ *
+ * @details There are @ref SER_HAL_TRANSPORT_TX_BUF_COUNT TX buffers. A buffer is available again
+ *          when its packet has been transmitted or when it has been freed by
+ *          @ref ser_hal_transport_tx_pkt_free function.
+ *
+ * @return Number of free TX buffers. Zero if the transmission channel is not opened.
+ */
+uint32_t ser_hal_transport_tx_free_buf_count_get(void);
+
+
 #endif /* SER_HAL_TRANSPORT_H__ */
 /** @} */
@@ -49,27 +49,35 @@
 #define INVALID_PKT_TYPE             0xFFFFFFFFu                                       /**< Internal invalid packet type value. */
 #define MAX_TRANSMISSION_TIME_ms     (MAX_PACKET_SIZE_IN_BITS * BAUD_TIME_us / 1000uL) /**< Max transmission time of a single application packet over UART in units of mseconds. */
 #define RETRANSMISSION_TIMEOUT_IN_ms (10uL * MAX_TRANSMISSION_TIME_ms)                 /**< Retransmission timeout for application packet in units of mseconds. */
+#define RETRANSMISSION_TIMEOUT_IN_us (RETRANSMISSION_TIMEOUT_IN_ms * 1000uL)             /**< Initial and maximum retransmission timeout in units of useconds. */
+#define MIN_RETRANSMISSION_MARGIN_IN_us (MAX_PACKET_SIZE_IN_BITS * BAUD_TIME_us)       /**< Minimum retransmission timeout margin over the response time in units of useconds. An acknowledgement may wait for the peer to finish a packet of max size. */
+#define MAX_RETRANSMISSION_BACKOFF   3u                                                /**< Max number of retransmission timeout doublings after consecutive timeouts. */
+#define SLIP_TX_FRAMES_MAX           2u                                                /**< Frames held by SLIP for transmission: the frame being sent and the pending one. */
 
 #ifdef  HCI_LINK_CONTROL
 #define HCI_PKT_SYNC        0x7E01u                                                    /**< Link Control Packet: type SYNC */
 #define HCI_PKT_SYNC_RSP    0x7D02u                                                    /**< Link Control Packet: type SYNC RESPONSE */
 #define HCI_PKT_CONFIG      0xFC03u                                                    /**< Link Control Packet: type CONFIG */
 #define HCI_PKT_CONFIG_RSP  0x7B04u                                                    /**< Link Control Packet: type CONFIG RESPONSE */
-#define HCI_CONFIG_FIELD    0x11u                                                      /**< Configuration field of CONFIG and CONFIG_RSP packet */
+#define HCI_CONFIG_FIELD    (0x10u | SER_PHY_HCI_WINDOW_SIZE)                          /**< Configuration field of CONFIG and CONFIG_RSP packet */
+#define HCI_CONFIG_WINDOW_MASK 0x07u                                                   /**< Sliding Window Size bits of the configuration field */
 #define HCI_PKT_SYNC_SIZE   6u                                                         /**< Size of SYNC and SYNC_RSP packet */
 #define HCI_PKT_CONFIG_SIZE 7u                                                         /**< Size of CONFIG and CONFIG_RSP packet */
 #define HCI_LINK_CONTROL_PKT_INVALID 0xFFFFu                                           /**< Size of CONFIG and CONFIG_RSP packet */
-#define HCI_LINK_CONTROL_TIMEOUT     1u                                                /**< Default link control timeout. */
+#define HCI_LINK_CONTROL_TIMEOUT     RETRANSMISSION_TIMEOUT_IN_us                      /**< Default link control timeout in units of useconds. */
 #endif  /* HCI_LINK_CONTROL */
 
 #ifndef APP_TIMER_PRESCALER
 #define APP_TIMER_PRESCALER 0
 #endif
 
-#define RETRANSMISSION_TIMEOUT_IN_TICKS (APP_TIMER_TICKS(RETRANSMISSION_TIMEOUT_IN_ms, \
-                                                         APP_TIMER_PRESCALER)) /**< Retransmission timeout for application packet in units of timer ticks. */
+#define HCI_TIMER_TICK_us               32u                                    /**< Tick of the TIMER used for timeouts (prescaler 9) in units of useconds. */
 #define MAX_RETRY_COUNT                 5                                      /**< Max retransmission retry count for application packets. */
 
+#if (SER_PHY_HCI_WINDOW_SIZE < 1) || (SER_PHY_HCI_WINDOW_SIZE > 7)
+#error "SER_PHY_HCI_WINDOW_SIZE must be in range 1-7."
+#endif
+
 #if   (defined(HCI_TIMER0))
 #define HCI_TIMER            NRF_TIMER0
 #define HCI_TIMER_IRQn       TIMER0_IRQn
@@ -162,18 +170,58 @@ _static uint8_t m_tx_packet_header[PKT_HDR_SIZE];
 _static uint8_t m_tx_packet_crc[PKT_CRC_SIZE];
 _static uint8_t m_tx_ack_packet[PKT_HDR_SIZE];
 #ifdef HCI_LINK_CONTROL
-_static uint8_t m_tx_link_control_header[PKT_HDR_SIZE];
-_static uint8_t m_tx_link_control_payload[HCI_PKT_CONFIG_SIZE - PKT_HDR_SIZE];
+/* Two buffers are used in turn, as SLIP can send a link control packet while the next one is
+ * pending. */
+_static uint8_t m_tx_link_control_header[SLIP_TX_FRAMES_MAX][PKT_HDR_SIZE];
+_static uint8_t m_tx_link_control_payload[SLIP_TX_FRAMES_MAX][HCI_PKT_CONFIG_SIZE - PKT_HDR_SIZE];
+_static uint8_t m_tx_link_control_buf;
 #endif /* HCI_LINK_CONTROL */
 
 _static uint32_t m_packet_ack_number; // Sequence number counter of the packet expected to be received
+
+/* Frames passed to SLIP whose end has not been reported yet. Bit n of m_slip_tx_link_control_mask
+ * is set if the n-th data or link control frame to end is a link control frame, so that its end is
+ * not taken for the end of a data packet. */
+_static uint32_t m_slip_tx_frame_count;
+_static uint32_t m_slip_tx_pkt_count;
+_static uint32_t m_slip_tx_link_control_mask;
 _static uint32_t m_packet_seq_number; // Sequence number counter of the transmitted packet for which acknowledgement packet is waited for
 
 
 _static uint32_t m_tx_retry_count;
 
+/* Adaptive retransmission timeout. The response time of the peer is measured from the end of
+ * a packet transmission to the reception of its acknowledgement, for packets sent only once. */
+_static uint32_t m_rtt_srtt_us   = 0;     // Smoothed response time, 0 until the first measurement
+_static uint32_t m_rtt_rttvar_us = 0;     // Response time variation
+_static uint32_t m_rto_backoff   = 0;     // Number of timeout doublings since the last measurement
+_static bool     m_rtt_pending   = false; // Measurement in progress
+_static uint32_t m_rtt_start;             // Timestamp of the measurement start
+_static uint32_t m_tx_retx_counter     = 0;
+_static uint32_t m_tx_spurious_counter = 0;
+
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+/* Sliding window mode: copies of the packets which have not been acknowledged yet. The packet with
+ * sequence number m_packet_seq_number is stored in slot m_tx_window_start. */
+_static uint8_t  m_tx_window_payload[SER_PHY_HCI_WINDOW_SIZE][SER_HAL_TRANSPORT_MAX_PKT_SIZE];
+_static uint16_t m_tx_window_length[SER_PHY_HCI_WINDOW_SIZE];
+_static uint32_t m_tx_window_size = SER_PHY_HCI_WINDOW_SIZE; // Window size used on the link
+_static uint32_t m_tx_window_start;                          // Slot of the oldest packet
+_static uint32_t m_tx_window_count;                          // Number of packets in the window
+_static uint32_t m_tx_window_sent;                           // Number of packets passed to SLIP since the last retransmission
+_static uint32_t m_tx_window_max_sent;                       // Number of packets passed to SLIP at least once
+_static bool     m_tx_window_slip_busy;                      // SLIP is transmitting a data packet
+_static uint32_t m_tx_window_slip_slot;                      // Slot of the packet transmitted by SLIP
+_static bool     m_tx_window_rtt_candidate;                  // Packet transmitted by SLIP is sent for the first time
+_static uint8_t  m_rtt_seq_number;                           // Sequence number of the packet whose response time is measured
+
+/* The peer does not wait for an acknowledgement before sending the next packet, so a packet received
+ * while an acknowledgement is being sent is processed after it instead of being dropped. */
+_static hci_evt_t m_rx_deferred_evt;
+_static bool      m_rx_deferred_flag = false;
+#endif /* SER_PHY_HCI_WINDOW_SIZE > 1 */
+
 
-// _static uint32_t m_tx_retx_counter = 0;
 // _static uint32_t m_rx_drop_counter = 0;
 
 
@@ -240,13 +288,17 @@ static void hci_signal_timeout_event(void)
 
 #ifndef HCI_APP_TIMER
 
+_static bool m_hci_timer_running_flag = false; // TIMER is started
+_static bool m_hci_timeout_armed_flag = false; // Timeout compare event is enabled
+
 void HCI_TIMER_IRQHandler(void)
 {
 
     if ((HCI_TIMER->EVENTS_COMPARE[1] == 1) && (HCI_TIMER->INTENSET & TIMER_INTENSET_COMPARE1_Msk))
     {
         HCI_TIMER->EVENTS_COMPARE[1] = 0;
-        HCI_TIMER->TASKS_CLEAR       = 1;
+        HCI_TIMER->INTENCLR          = TIMER_INTENCLR_COMPARE1_Msk;
+        m_hci_timeout_armed_flag     = false;
 
         if (m_hci_timer_enabled_flag)
         {
@@ -260,72 +312,205 @@ void HCI_TIMER_IRQHandler(void)
 }
 
 
-static void hci_timeout_setup(uint32_t count)
+/* TIMER runs only while a timeout or a response time measurement is pending, so that it does not
+ * keep the high frequency clock running when the link is idle. It is started by the first call to
+ * hci_time_get() and CC[0] is used to read the current time. */
+static uint32_t hci_time_get(void)
 {
+    if (!m_hci_timer_running_flag)
+    {
+        HCI_TIMER->TASKS_CLEAR   = 1;
+        HCI_TIMER->TASKS_START   = 1;
+        m_hci_timer_running_flag = true;
+    }
+
+    HCI_TIMER->TASKS_CAPTURE[0] = 1;
+    return HCI_TIMER->CC[0];
+}
 
-    uint32_t time_msec;
 
-    if (count)
+/* stops TIMER if no timeout and no response time measurement is pending */
+static void hci_timer_idle_check(void)
+{
+    if (m_hci_timer_running_flag && !m_hci_timeout_armed_flag && !m_rtt_pending)
     {
-        HCI_TIMER->INTENCLR          = TIMER_INTENCLR_COMPARE1_Msk;
-        time_msec                    = count * RETRANSMISSION_TIMEOUT_IN_ms;
-        HCI_TIMER->CC[1]             = time_msec * 31;
-        HCI_TIMER->CC[1]            += time_msec / 4;
-        HCI_TIMER->TASKS_CLEAR       = 1; // < Clear TIMER
-        HCI_TIMER->EVENTS_COMPARE[1] = 0;
-        HCI_TIMER->TASKS_START       = 1; // < Start TIMER
-        HCI_TIMER->INTENSET          = TIMER_INTENSET_COMPARE1_Msk;
+        HCI_TIMER->TASKS_STOP    = 1;
+        m_hci_timer_running_flag = false;
     }
-    else
+}
+
+
+static uint32_t hci_time_diff_us(uint32_t time_from)
+{
+    return ((hci_time_get() - time_from) & 0xFFFFu) * HCI_TIMER_TICK_us;
+}
+
+
+/* timeout_us equal to 0 stops the timeout */
+static void hci_timeout_setup(uint32_t timeout_us)
+{
+    uint32_t ticks;
+
+    HCI_TIMER->INTENCLR      = TIMER_INTENCLR_COMPARE1_Msk;
+    m_hci_timeout_armed_flag = false;
+
+    if (timeout_us)
     {
-        HCI_TIMER->INTENCLR   = TIMER_INTENCLR_COMPARE1_Msk;
-        HCI_TIMER->TASKS_STOP = 1; // < Start TIMER
+        ticks                        = MIN(MAX(timeout_us / HCI_TIMER_TICK_us, 1u), 0xFFFFu);
+        HCI_TIMER->CC[1]             = (hci_time_get() + ticks) & 0xFFFFu;
+        HCI_TIMER->EVENTS_COMPARE[1] = 0;
+        HCI_TIMER->INTENSET          = TIMER_INTENSET_COMPARE1_Msk;
+        m_hci_timeout_armed_flag     = true;
     }
+
+    hci_timer_idle_check();
 }
 
 
 #else
 
-_static bool     m_hci_timer_setup_flag = false;
-_static uint32_t m_hci_timer_counter    = 0;
-_static uint32_t m_hci_timer_setup;
+static uint32_t hci_time_get(void)
+{
+    uint32_t ticks;
+
+    (void) app_timer_cnt_get(&ticks);
+    return ticks;
+}
+
+
+static uint32_t hci_time_diff_us(uint32_t time_from)
+{
+    uint32_t ticks;
+
+    (void) app_timer_cnt_diff_compute(hci_time_get(), time_from, &ticks);
+    return (uint32_t) (((uint64_t) ticks * (APP_TIMER_PRESCALER + 1) * 1000000uL) / 32768uL);
+}
+
 
-static void hci_timeout_setup(uint32_t count)
+/* app_timer is based on RTC, which runs anyway, so nothing has to be stopped when the link is idle */
+static void hci_timer_idle_check(void)
 {
-    m_hci_timer_setup      = count;
-    m_hci_timer_setup_flag = true;
+}
+
+
+/* timeout_us equal to 0 stops the timeout, other values arm the single shot timer with the timeout
+ * rounded up to the next RTC tick */
+static void hci_timeout_setup(uint32_t timeout_us)
+{
+    uint32_t ticks;
+    uint32_t err_code;
+
+    // A running single shot timer is not restarted by app_timer_start(), so it is stopped first.
+    err_code = app_timer_stop(m_app_timer_id);
+    ser_phy_hci_assert(err_code == NRF_SUCCESS);
+
+    if (timeout_us)
+    {
+        ticks    = (uint32_t) CEIL_DIV((uint64_t) timeout_us * 32768uL,
+                                       1000000uL * (APP_TIMER_PRESCALER + 1));
+        ticks    = MAX(ticks, APP_TIMER_MIN_TIMEOUT_TICKS);
+        err_code = app_timer_start(m_app_timer_id, ticks, NULL);
+        ser_phy_hci_assert(err_code == NRF_SUCCESS);
+    }
 }
 
 
 static void hci_timeout_handler(void * p_context)
 {
+    if (m_hci_timer_enabled_flag)
+    {
+        hci_signal_timeout_event();
+    }
+    else
+    {
+        m_hci_timout_pending_flag = true;
+    }
+}
+
 
-    if (m_hci_timer_setup_flag)
+#endif
+
+
+/**@brief Function for getting the retransmission timeout.
+ *
+ * Until the first measurement the timeout for the worst case is used. Then the timeout is
+ * SRTT + 4 * RTTVAR, with a margin over SRTT of at least @ref MIN_RETRANSMISSION_MARGIN_IN_us,
+ * doubled after each consecutive timeout and limited to @ref RETRANSMISSION_TIMEOUT_IN_us.
+ *
+ * @return Retransmission timeout in useconds.
+ */
+static uint32_t hci_rto_get(void)
+{
+    uint32_t rto_us = RETRANSMISSION_TIMEOUT_IN_us;
+
+    if (m_rtt_srtt_us)
     {
-        m_hci_timer_setup_flag = false;
-        m_hci_timer_counter    = m_hci_timer_setup; /* for 1 it will be always more than 1 tick - jitter is up to 1 tick */
+        rto_us = (m_rtt_srtt_us + MAX(4u * m_rtt_rttvar_us, MIN_RETRANSMISSION_MARGIN_IN_us))
+                 << m_rto_backoff;
+        rto_us = MIN(rto_us, RETRANSMISSION_TIMEOUT_IN_us);
     }
-    else if ( m_hci_timer_counter )
+
+    return rto_us;
+}
+
+
+/**@brief Function for starting a response time measurement. To be called when the transmission of
+ *        a packet sent for the first time has ended.
+ */
+static void hci_rtt_start(void)
+{
+    m_rtt_start   = hci_time_get();
+    m_rtt_pending = true;
+}
+
+
+/**@brief Function for ending a response time measurement and updating the estimation. To be called
+ *        when the measured packet has been acknowledged.
+ */
+static void hci_rtt_stop(void)
+{
+    uint32_t rtt_us;
+    uint32_t delta_us;
+
+    if (!m_rtt_pending)
     {
-        m_hci_timer_counter--;
+        return;
+    }
+    m_rtt_pending = false;
 
-        if (m_hci_timer_counter == 0)
-        {
-            if (m_hci_timer_enabled_flag)
-            {
-                hci_signal_timeout_event();
-            }
-            else
-            {
-                m_hci_timout_pending_flag = true;
-            }
-        }
+    rtt_us = MAX(hci_time_diff_us(m_rtt_start), 1u); // SRTT equal to 0 means no measurement
+    hci_timer_idle_check();
+
+    if (m_rtt_srtt_us == 0)
+    {
+        m_rtt_srtt_us   = rtt_us;
+        m_rtt_rttvar_us = rtt_us / 2;
     }
-    return;
+    else
+    {
+        delta_us        = (m_rtt_srtt_us > rtt_us) ? (m_rtt_srtt_us - rtt_us) :
+                                                     (rtt_us - m_rtt_srtt_us);
+        m_rtt_rttvar_us = m_rtt_rttvar_us - (m_rtt_rttvar_us / 4) + (delta_us / 4);
+        m_rtt_srtt_us   = m_rtt_srtt_us - (m_rtt_srtt_us / 8) + (rtt_us / 8);
+        m_rtt_srtt_us   = MAX(m_rtt_srtt_us, 1u);
+    }
+    m_rto_backoff = 0;
 }
 
 
-#endif
+/**@brief Function for handling an expired retransmission timeout. The measurement in progress is
+ *        dropped, as the acknowledgement could not be matched with a transmission (Karn's rule).
+ */
+static void hci_rto_expired(void)
+{
+    m_rtt_pending = false;
+    hci_timer_idle_check();
+
+    if (m_rto_backoff < MAX_RETRANSMISSION_BACKOFF)
+    {
+        m_rto_backoff++;
+    }
+}
 
 
 /**@brief Function for validating a received packet.
@@ -414,13 +599,15 @@ static __INLINE uint8_t packet_seq_nmbr_extract(const uint8_t * p_buffer)
 
 
 /**@brief Function for constructing 1st byte of the packet header of the packet to be transmitted.
+ *
+ * @param[in] seq_number Sequence number of the packet to be transmitted.
  *
  * @return 1st byte of the packet header of the packet to be transmitted
  */
-static __INLINE uint8_t tx_packet_byte_zero_construct(void)
+static __INLINE uint8_t tx_packet_byte_zero_construct(uint8_t seq_number)
 {
     const uint32_t value = DATA_INTEGRITY_MASK | RELIABLE_PKT_MASK |
-                           (packet_ack_get() << 3u) | packet_seq_get();
+                           (packet_ack_get() << 3u) | seq_number;
 
     return (uint8_t) value;
 }
@@ -478,6 +665,7 @@ static __INLINE uint8_t next_expected_ack_number_get(void)
 }
 
 
+#if (SER_PHY_HCI_WINDOW_SIZE == 1)
 /**@brief Function for processing a received acknowledgement packet.
  *
  * Verifies does the received acknowledgement packet has the expected acknowledgement number and
@@ -507,6 +695,7 @@ static bool rx_ack_pkt_valid(const uint8_t * p_buffer)
     return ( (ack_number == expected_ack_number_get()) ||
              (ack_number == next_expected_ack_number_get()) );
 }
+#endif /* SER_PHY_HCI_WINDOW_SIZE == 1 */
 
 
 /**@brief Function for decoding a packet type field.
@@ -581,12 +770,14 @@ static uint16_t link_control_packet_decode(const uint8_t * p_buffer, uint32_t le
         {
             packet_type = HCI_LINK_CONTROL_PKT_INVALID;
         }
-        // Verify configuration field (0x11):
-        // - Sliding Window Size       == 1,
+        // Verify configuration field (0x11 - 0x17):
+        // - Sliding Window Size       != 0,
         // - OOF Flow Control          == 0,
         // - Data Integrity Check Type == 1,
         // - Version Number            == 0
-        if (p_buffer[HCI_PKT_CONFIG_SIZE - 1] != HCI_CONFIG_FIELD)
+        if (((p_buffer[HCI_PKT_CONFIG_SIZE - 1] & ~HCI_CONFIG_WINDOW_MASK) !=
+             (HCI_CONFIG_FIELD & ~HCI_CONFIG_WINDOW_MASK)) ||
+            ((p_buffer[HCI_PKT_CONFIG_SIZE - 1] & HCI_CONFIG_WINDOW_MASK) == 0))
         {
             packet_type = HCI_LINK_CONTROL_PKT_INVALID;
         }
@@ -608,6 +799,53 @@ static uint16_t link_control_packet_decode(const uint8_t * p_buffer, uint32_t le
 }
 #endif /* HCI_LINK_CONTROL */
 
+/**@brief Function for recording a frame passed to SLIP.
+ *
+ * @param[in] is_ack           True for an acknowledgement packet, whose end is reported as
+ *                             @ref SER_PHY_HCI_SLIP_EVT_ACK_SENT.
+ * @param[in] is_link_control  True for a link control packet.
+ */
+static void hci_slip_tx_frame_add(bool is_ack, bool is_link_control)
+{
+    CRITICAL_REGION_ENTER();
+    m_slip_tx_frame_count++;
+    if (!is_ack)
+    {
+        m_slip_tx_link_control_mask |= (is_link_control ? 1u : 0u) << m_slip_tx_pkt_count;
+        m_slip_tx_pkt_count++;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for recording the end of a frame reported by SLIP. SLIP sends the frames in the
+ *        order they were passed to it.
+ *
+ * @param[in] is_ack  True if the end was reported as @ref SER_PHY_HCI_SLIP_EVT_ACK_SENT.
+ *
+ * @return True if the frame was a link control packet.
+ */
+static bool hci_slip_tx_frame_end(bool is_ack)
+{
+    bool is_link_control = false;
+
+    CRITICAL_REGION_ENTER();
+    if (m_slip_tx_frame_count > 0)
+    {
+        m_slip_tx_frame_count--;
+    }
+    if (!is_ack && (m_slip_tx_pkt_count > 0))
+    {
+        is_link_control               = (m_slip_tx_link_control_mask & 1u) != 0;
+        m_slip_tx_link_control_mask >>= 1;
+        m_slip_tx_pkt_count--;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return is_link_control;
+}
+
+
 /**@brief Function for writing an acknowledgment packet for transmission.
  */
 
@@ -630,6 +868,7 @@ static void ack_transmit(void)
     pkt_header.p_buffer     = m_tx_ack_packet;
     pkt_header.num_of_bytes = PKT_HDR_SIZE;
     DEBUG_EVT_SLIP_ACK_TX(0);
+    hci_slip_tx_frame_add(true, false);
     err_code = ser_phy_hci_slip_tx_pkt_send(&pkt_header, NULL, NULL);
     ser_phy_hci_assert(err_code == NRF_SUCCESS);
 
@@ -719,9 +958,12 @@ static void hci_slip_event_handler(ser_phy_hci_slip_evt_t * p_event)
         event.evt_source                    = HCI_SLIP_EVT;
         event.evt.ser_phy_slip_evt.evt_type = p_event->evt_type;
 #ifndef HCI_LINK_CONTROL
+        (void) hci_slip_tx_frame_end(false);
         hci_tx_event_handler(&event);
 #else
-        if ((m_hci_mode == HCI_MODE_ACTIVE) && m_hci_other_side_active)
+        // The end of a link control packet sent while active is not passed to the TX FSM.
+        if (!hci_slip_tx_frame_end(false) &&
+            (m_hci_mode == HCI_MODE_ACTIVE) && m_hci_other_side_active)
         {
             hci_tx_event_handler(&event);
         }
@@ -730,6 +972,7 @@ static void hci_slip_event_handler(ser_phy_hci_slip_evt_t * p_event)
     else if ( p_event->evt_type == SER_PHY_HCI_SLIP_EVT_ACK_SENT )
     {
         DEBUG_EVT_SLIP_ACK_TXED(0);
+        (void) hci_slip_tx_frame_end(true);
         event.evt_source                    = HCI_SLIP_EVT;
         event.evt.ser_phy_slip_evt.evt_type = p_event->evt_type;
 #ifndef HCI_LINK_CONTROL
@@ -821,16 +1064,22 @@ static void hci_slip_event_handler(ser_phy_hci_slip_evt_t * p_event)
 }
 
 
-static void hci_pkt_send(void)
+/**@brief Function for sending a reliable packet.
+ *
+ * @param[in] seq_number  Sequence number of the packet.
+ * @param[in] p_payload   Pointer to the packet payload.
+ * @param[in] length      Length of the packet payload in bytes.
+ */
+static void hci_data_pkt_send(uint8_t seq_number, uint8_t * p_payload, uint16_t length)
 {
     uint32_t err_code;
 
-    m_tx_packet_header[0] = tx_packet_byte_zero_construct();
-    uint16_t type_and_length_fields = ((m_tx_payload_length << 4u) | PKT_TYPE_VENDOR_SPECIFIC);
+    m_tx_packet_header[0] = tx_packet_byte_zero_construct(seq_number);
+    uint16_t type_and_length_fields = ((length << 4u) | PKT_TYPE_VENDOR_SPECIFIC);
     (void)uint16_encode(type_and_length_fields, &(m_tx_packet_header[1]));
     m_tx_packet_header[3] = header_checksum_calculate(m_tx_packet_header);
     uint16_t crc = crc16_compute(m_tx_packet_header, PKT_HDR_SIZE, NULL);
-    crc = crc16_compute(m_p_tx_payload, m_tx_payload_length, &crc);
+    crc = crc16_compute(p_payload, length, &crc);
     (void)uint16_encode(crc, m_tx_packet_crc);
 
     ser_phy_hci_pkt_params_t pkt_header;
@@ -839,61 +1088,85 @@ static void hci_pkt_send(void)
 
     pkt_header.p_buffer      = m_tx_packet_header;
     pkt_header.num_of_bytes  = PKT_HDR_SIZE;
-    pkt_payload.p_buffer     = m_p_tx_payload;
-    pkt_payload.num_of_bytes = m_tx_payload_length;
+    pkt_payload.p_buffer     = p_payload;
+    pkt_payload.num_of_bytes = length;
     pkt_crc.p_buffer         = m_tx_packet_crc;
     pkt_crc.num_of_bytes     = PKT_CRC_SIZE;
     DEBUG_EVT_SLIP_PACKET_TX(0);
+    hci_slip_tx_frame_add(false, false);
     err_code = ser_phy_hci_slip_tx_pkt_send(&pkt_header, &pkt_payload, &pkt_crc);
     ser_phy_hci_assert(err_code == NRF_SUCCESS);
 
     return;
 }
 
+
+#if (SER_PHY_HCI_WINDOW_SIZE == 1)
+static void hci_pkt_send(void)
+{
+    hci_data_pkt_send(packet_seq_get(), m_p_tx_payload, m_tx_payload_length);
+}
+#endif /* SER_PHY_HCI_WINDOW_SIZE == 1 */
+
 #ifdef HCI_LINK_CONTROL
 static void hci_link_control_pkt_send(void)
 {
-    uint32_t err_code;
-    uint16_t link_control_payload_len = 0;
+    uint32_t  err_code;
+    uint16_t  link_control_payload_len = 0;
+    uint8_t * p_header;
+    uint8_t * p_payload;
 
-    m_tx_link_control_header[0] = 0x00u;       // SEQ, ACK, DI and RP are set to 0 for link control
+    // SLIP would overwrite its pending frame. The packet is dropped, the peer sends its link
+    // control packets again until they are answered.
+    if (m_slip_tx_frame_count >= SLIP_TX_FRAMES_MAX)
+    {
+        return;
+    }
+
+    // The other buffer may still be read by SLIP.
+    m_tx_link_control_buf = (m_tx_link_control_buf + 1) % SLIP_TX_FRAMES_MAX;
+    p_header              = m_tx_link_control_header[m_tx_link_control_buf];
+    p_payload             = m_tx_link_control_payload[m_tx_link_control_buf];
+
+    p_header[0] = 0x00u;       // SEQ, ACK, DI and RP are set to 0 for link control
     if (m_hci_link_control_next_pkt == HCI_PKT_SYNC)
     {
         link_control_payload_len = HCI_PKT_SYNC_SIZE - PKT_HDR_SIZE;
-        (void)uint16_encode(HCI_PKT_SYNC, m_tx_link_control_payload);
+        (void)uint16_encode(HCI_PKT_SYNC, p_payload);
     }
     else if (m_hci_link_control_next_pkt == HCI_PKT_SYNC_RSP)
     {
         link_control_payload_len = HCI_PKT_SYNC_SIZE - PKT_HDR_SIZE;
-        (void)uint16_encode(HCI_PKT_SYNC_RSP, m_tx_link_control_payload);
+        (void)uint16_encode(HCI_PKT_SYNC_RSP, p_payload);
     }
     else if (m_hci_link_control_next_pkt == HCI_PKT_CONFIG)
     {
         link_control_payload_len = HCI_PKT_CONFIG_SIZE - PKT_HDR_SIZE;
-        (void)uint16_encode(HCI_PKT_CONFIG, m_tx_link_control_payload);
-        m_tx_link_control_payload[2] = HCI_CONFIG_FIELD;
+        (void)uint16_encode(HCI_PKT_CONFIG, p_payload);
+        p_payload[2] = HCI_CONFIG_FIELD;
     }
     else if (m_hci_link_control_next_pkt == HCI_PKT_CONFIG_RSP)
     {
         link_control_payload_len = HCI_PKT_CONFIG_SIZE - PKT_HDR_SIZE;
-        (void)uint16_encode(HCI_PKT_CONFIG_RSP, m_tx_link_control_payload);
-        m_tx_link_control_payload[2] = HCI_CONFIG_FIELD;
+        (void)uint16_encode(HCI_PKT_CONFIG_RSP, p_payload);
+        p_payload[2] = HCI_CONFIG_FIELD;
     }
     uint16_t type_and_length_fields = ((link_control_payload_len << 4u) | PKT_TYPE_LINK_CONTROL);
-    (void)uint16_encode(type_and_length_fields, &(m_tx_link_control_header[1]));
-    m_tx_link_control_header[3] = header_checksum_calculate(m_tx_link_control_header);
+    (void)uint16_encode(type_and_length_fields, &(p_header[1]));
+    p_header[3] = header_checksum_calculate(p_header);
 
     ser_phy_hci_pkt_params_t pkt_header;
     ser_phy_hci_pkt_params_t pkt_payload;
     ser_phy_hci_pkt_params_t pkt_crc;
 
-    pkt_header.p_buffer      = m_tx_link_control_header;
+    pkt_header.p_buffer      = p_header;
     pkt_header.num_of_bytes  = PKT_HDR_SIZE;
-    pkt_payload.p_buffer     = m_tx_link_control_payload;
+    pkt_payload.p_buffer     = p_payload;
     pkt_payload.num_of_bytes = link_control_payload_len;
     pkt_crc.p_buffer         = NULL;
     pkt_crc.num_of_bytes     = 0;
     DEBUG_EVT_SLIP_PACKET_TX(0);
+    hci_slip_tx_frame_add(false, true);
     err_code = ser_phy_hci_slip_tx_pkt_send(&pkt_header, &pkt_payload, &pkt_crc);
     ser_phy_hci_assert(err_code == NRF_SUCCESS);
 
@@ -901,6 +1174,7 @@ static void hci_link_control_pkt_send(void)
 }
 #endif /* HCI_LINK_CONTROL */
 
+#if (SER_PHY_HCI_WINDOW_SIZE == 1)
 static void hci_pkt_sent_upcall(void)
 {
     m_packet_seq_number++; // incoming ACK is valid, increment SEQ
@@ -910,6 +1184,7 @@ static void hci_pkt_sent_upcall(void)
 
     return;
 }
+#endif /* SER_PHY_HCI_WINDOW_SIZE == 1 */
 
 
 static void hci_release_ack_buffer(hci_evt_t * p_event)
@@ -923,6 +1198,7 @@ static void hci_release_ack_buffer(hci_evt_t * p_event)
     return;
 }
 
+#if (SER_PHY_HCI_WINDOW_SIZE == 1)
 
 static void hci_process_orphaned_ack(hci_evt_t * p_event)
 {
@@ -959,7 +1235,8 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
             if ((p_event->evt_source == HCI_SLIP_EVT) &&
                 (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_PKT_SENT))
             {
-                hci_timeout_setup(1);
+                hci_timeout_setup(hci_rto_get());
+                hci_rtt_start();
                 m_hci_tx_fsm_state = HCI_TX_STATE_WAIT_FOR_ACK;
             }
             else if ((p_event->evt_source == HCI_SLIP_EVT) &&
@@ -974,7 +1251,7 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
             if ((p_event->evt_source == HCI_SLIP_EVT) &&
                 (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_PKT_SENT))
             {
-                hci_timeout_setup(1);
+                hci_timeout_setup(hci_rto_get());
                 m_hci_tx_fsm_state = HCI_TX_STATE_WAIT_FOR_ACK;
             }
             else if ((p_event->evt_source == HCI_SLIP_EVT) &&
@@ -982,6 +1259,8 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
             {
                 if (rx_ack_pkt_valid(p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer))
                 {
+                    // The retransmission has not ended yet, so the original one was acknowledged.
+                    m_tx_spurious_counter++;
                     hci_timeout_setup(0);
                     m_hci_tx_fsm_state = HCI_TX_STATE_WAIT_FOR_TX_END;
                 }
@@ -996,6 +1275,7 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
             {
                 if (rx_ack_pkt_valid(p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer))
                 {
+                    hci_rtt_stop();
                     hci_timeout_setup(0);
                     hci_pkt_sent_upcall();
                     m_hci_tx_fsm_state = HCI_TX_STATE_SEND;
@@ -1005,9 +1285,10 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
             else if (p_event->evt_source == HCI_TIMER_EVT)
             {
                 m_tx_retry_count--;
-                // m_tx_retx_counter++; // global retransmissions counter
+                hci_rto_expired();
                 if (m_tx_retry_count)
                 {
+                    m_tx_retx_counter++;
                     hci_pkt_send();
                     DEBUG_HCI_RETX(0);
                     m_hci_tx_fsm_state = HCI_TX_STATE_WAIT_FOR_ACK_OR_TX_END;
@@ -1052,6 +1333,237 @@ static void hci_tx_fsm_event_process(hci_evt_t * p_event)
     }
 }
 
+#else
+
+static void hci_tx_window_reset(void)
+{
+    m_tx_window_start     = 0;
+    m_tx_window_count     = 0;
+    m_tx_window_sent      = 0;
+    m_tx_window_max_sent  = 0;
+    m_tx_window_slip_busy = false;
+    m_tx_retry_count      = MAX_RETRY_COUNT;
+    m_rtt_pending         = false;
+}
+
+
+#ifdef HCI_LINK_CONTROL
+/**@brief Function for setting the window size agreed with the peer.
+ *
+ * @param[in] p_buffer Pointer to a valid CONFIG or CONFIG_RSP packet received from the peer.
+ */
+static void hci_tx_window_size_set(const uint8_t * p_buffer)
+{
+    uint32_t peer_window_size = p_buffer[HCI_PKT_CONFIG_SIZE - 1] & HCI_CONFIG_WINDOW_MASK;
+
+    m_tx_window_size = MIN(peer_window_size, SER_PHY_HCI_WINDOW_SIZE);
+}
+#endif /* HCI_LINK_CONTROL */
+
+
+/**@brief Function for copying the packet requested by the upper layer into the window.
+ *
+ * The upper layer is notified that the packet has been sent as soon as it is copied, so it can
+ * pass the next one while the previous ones wait for acknowledgement.
+ */
+static void hci_tx_window_pkt_add(void)
+{
+    uint32_t slot;
+
+    if ((m_p_tx_payload != NULL) && (m_tx_window_count < m_tx_window_size))
+    {
+        slot = (m_tx_window_start + m_tx_window_count) % SER_PHY_HCI_WINDOW_SIZE;
+
+        // The slot is free, but SLIP can still be sending an old packet from it.
+        if (m_tx_window_slip_busy && (slot == m_tx_window_slip_slot))
+        {
+            return;
+        }
+
+        memcpy(m_tx_window_payload[slot], m_p_tx_payload, m_tx_payload_length);
+        m_tx_window_length[slot] = m_tx_payload_length;
+        m_tx_window_count++;
+
+        m_p_tx_payload = NULL;
+        packet_transmitted_callback();
+    }
+}
+
+
+/**@brief Function for passing the next packet from the window to SLIP.
+ *
+ * Data packets are passed to SLIP one by one, so only one acknowledgement packet can be waiting in
+ * SLIP behind a data packet.
+ */
+static void hci_tx_window_pkt_send(void)
+{
+    uint32_t slot;
+    uint8_t  seq_number;
+
+    if (!m_tx_window_slip_busy && (m_tx_window_sent < m_tx_window_count))
+    {
+        slot       = (m_tx_window_start + m_tx_window_sent) % SER_PHY_HCI_WINDOW_SIZE;
+        seq_number = (packet_seq_get() + m_tx_window_sent) & 0x07u;
+
+        if (m_tx_window_sent < m_tx_window_max_sent)
+        {
+            m_tx_retx_counter++;
+            m_tx_window_rtt_candidate = false;
+        }
+        else
+        {
+            m_tx_window_max_sent      = m_tx_window_sent + 1;
+            m_tx_window_rtt_candidate = !m_rtt_pending;
+            if (m_tx_window_rtt_candidate)
+            {
+                m_rtt_seq_number = seq_number;
+            }
+        }
+
+        hci_data_pkt_send(seq_number, m_tx_window_payload[slot], m_tx_window_length[slot]);
+        m_tx_window_sent++;
+        m_tx_window_slip_busy = true;
+        m_tx_window_slip_slot = slot;
+    }
+}
+
+
+/**@brief Function for processing a received acknowledgement packet.
+ *
+ * The acknowledgement number is the sequence number of the next packet expected by the peer, so it
+ * acknowledges all packets sent before it (cumulative acknowledgement).
+ *
+ * @param[in] p_buffer Pointer to the packet data.
+ *
+ * @return Number of packets removed from the window.
+ */
+static uint32_t hci_tx_window_ack_process(const uint8_t * p_buffer)
+{
+    uint32_t acked_count = 0;
+    uint32_t ended_count;
+
+    // Verify header checksum.
+    const uint32_t expected_checksum =
+        ((p_buffer[0] + p_buffer[1] + p_buffer[2] + p_buffer[3])) & 0xFFu;
+
+    if (expected_checksum == 0)
+    {
+        acked_count = (((p_buffer[0] >> 3u) & 0x07u) - packet_seq_get()) & 0x07u;
+
+        // Ignore acknowledgement of packets which have not been sent.
+        if (acked_count > m_tx_window_max_sent)
+        {
+            acked_count = 0;
+        }
+    }
+
+    if (acked_count > 0)
+    {
+        // Acknowledgement of a packet whose retransmission has not ended yet, or which has not been
+        // retransmitted yet after a timeout, was sent for its original transmission. A packet in
+        // transmission right after a timeout was passed to SLIP before it, so it was not retransmitted.
+        ended_count = m_tx_window_sent;
+        if (m_tx_window_slip_busy && (ended_count > 0))
+        {
+            ended_count--;
+        }
+        if (acked_count > ended_count)
+        {
+            m_tx_spurious_counter++;
+        }
+
+        if (m_rtt_pending && (((m_rtt_seq_number - packet_seq_get()) & 0x07u) < acked_count))
+        {
+            hci_rtt_stop();
+        }
+
+        m_packet_seq_number   = (m_packet_seq_number + acked_count) & 0x07u;
+        m_tx_window_start     = (m_tx_window_start + acked_count) % SER_PHY_HCI_WINDOW_SIZE;
+        m_tx_window_count    -= acked_count;
+        m_tx_window_sent      = (acked_count < m_tx_window_sent) ? (m_tx_window_sent - acked_count) : 0;
+        m_tx_window_max_sent -= acked_count;
+        m_tx_retry_count      = MAX_RETRY_COUNT;
+    }
+
+    return acked_count;
+}
+
+
+/* main tx fsm - sliding window (go-back-N) mode */
+static void hci_tx_fsm_event_process(hci_evt_t * p_event)
+{
+    if (m_hci_tx_fsm_state == HCI_TX_STATE_DISABLE)
+    {
+#ifdef HCI_LINK_CONTROL
+        /* This case should not happen if HCI is in ACTIVE mode */
+        if (m_hci_mode == HCI_MODE_ACTIVE)
+        {
+            ser_phy_hci_assert(false);
+        }
+#else
+        ser_phy_hci_assert(false);
+#endif /* HCI_LINK_CONTROL */
+        return;
+    }
+
+    if ((p_event->evt_source == HCI_SLIP_EVT) &&
+        (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_PKT_SENT))
+    {
+        // Retransmission timeout is counted from the end of the last transmission.
+        m_tx_window_slip_busy = false;
+        hci_timeout_setup(hci_rto_get());
+
+        if (m_tx_window_rtt_candidate)
+        {
+            m_tx_window_rtt_candidate = false;
+            hci_rtt_start();
+        }
+    }
+    else if ((p_event->evt_source == HCI_SLIP_EVT) &&
+             (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_PKT_RECEIVED))
+    {
+        if (hci_tx_window_ack_process(
+                p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer) > 0)
+        {
+            hci_timeout_setup((m_tx_window_sent > 0) ? hci_rto_get() : 0);
+        }
+        hci_release_ack_buffer(p_event);
+    }
+    else if (p_event->evt_source == HCI_TIMER_EVT)
+    {
+        if (m_tx_window_sent > 0)
+        {
+            m_tx_retry_count--;
+            hci_rto_expired();
+            if (m_tx_retry_count)
+            {
+                // Go back to the oldest unacknowledged packet, the peer drops packets received
+                // out of sequence.
+                m_tx_window_sent          = 0;
+                m_tx_window_rtt_candidate = false;
+                DEBUG_HCI_RETX(0);
+            }
+            else
+            {
+                m_tx_window_start    = (m_tx_window_start + m_tx_window_count) %
+                                       SER_PHY_HCI_WINDOW_SIZE;
+                m_tx_window_count    = 0;
+                m_tx_window_sent     = 0;
+                m_tx_window_max_sent = 0;
+                m_tx_retry_count     = MAX_RETRY_COUNT;
+                error_callback();
+                m_p_tx_payload       = NULL;
+            }
+        }
+    }
+
+    // A new request, an acknowledgement or the end of a transmission may have made space in
+    // the window.
+    hci_tx_window_pkt_add();
+    hci_tx_window_pkt_send();
+}
+#endif /* SER_PHY_HCI_WINDOW_SIZE == 1 */
+
 
 static void hci_mem_request(hci_evt_t * p_event)
 {
@@ -1071,6 +1583,41 @@ static void hci_inc_ack()
 }
 
 
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+static void hci_rx_fsm_event_process(hci_evt_t * p_event);
+
+
+/**@brief Function for storing a data packet received while an acknowledgement is being sent. */
+static void hci_rx_pkt_defer(hci_evt_t * p_event)
+{
+    if (!m_rx_deferred_flag)
+    {
+        m_rx_deferred_evt  = *p_event;
+        m_rx_deferred_flag = true;
+    }
+    else
+    {
+        (void) ser_phy_hci_slip_rx_buf_free(
+            p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+    }
+}
+
+
+/**@brief Function for processing the deferred data packet, if any. */
+static void hci_rx_deferred_pkt_process(void)
+{
+    hci_evt_t event;
+
+    if (m_rx_deferred_flag)
+    {
+        event              = m_rx_deferred_evt;
+        m_rx_deferred_flag = false;
+        hci_rx_fsm_event_process(&event);
+    }
+}
+#endif /* SER_PHY_HCI_WINDOW_SIZE > 1 */
+
+
 static void hci_rx_fsm_event_process(hci_evt_t * p_event)
 {
     switch (m_hci_rx_fsm_state)
@@ -1093,7 +1640,8 @@ static void hci_rx_fsm_event_process(hci_evt_t * p_event)
                 {
                     // m_rx_drop_counter++;
                     m_hci_rx_fsm_state = HCI_RX_STATE_WAIT_FOR_SLIP_NACK_END;
-                    (void) ser_phy_hci_slip_rx_buf_free(m_p_rx_packet); // and drop a packet
+                    (void) ser_phy_hci_slip_rx_buf_free(                // and drop a packet
+                        p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
                     ack_transmit();                                     // send NACK with valid ACK
                 }
             }
@@ -1134,11 +1682,18 @@ static void hci_rx_fsm_event_process(hci_evt_t * p_event)
                     packet_dropped_callback();
                 }
                 m_hci_rx_fsm_state = HCI_RX_STATE_RECEIVE;
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+                hci_rx_deferred_pkt_process();
+#endif
             }
             else if ((p_event->evt_source == HCI_SLIP_EVT) &&
                     (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_PKT_RECEIVED))
             {
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+                hci_rx_pkt_defer(p_event);
+#else
                 (void) ser_phy_hci_slip_rx_buf_free(p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+#endif
             }
             break;
 
@@ -1147,10 +1702,17 @@ static void hci_rx_fsm_event_process(hci_evt_t * p_event)
                (p_event->evt.ser_phy_slip_evt.evt_type == SER_PHY_HCI_SLIP_EVT_ACK_SENT))
             {
                m_hci_rx_fsm_state = HCI_RX_STATE_RECEIVE;
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+               hci_rx_deferred_pkt_process();
+#endif
             }
             else
             {
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+               hci_rx_pkt_defer(p_event);
+#else
                (void) ser_phy_hci_slip_rx_buf_free(p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+#endif
             }
             break;
 
@@ -1366,6 +1928,15 @@ static void hci_link_control_event_handler(hci_evt_t * p_event)
                         m_hci_tx_fsm_state  = HCI_TX_STATE_DISABLE;
                         m_hci_rx_fsm_state  = HCI_RX_STATE_DISABLE;
                         m_hci_other_side_active = false;
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+                        hci_tx_window_reset();
+                        if (m_rx_deferred_flag)
+                        {
+                            m_rx_deferred_flag = false;
+                            (void) ser_phy_hci_slip_rx_buf_free(m_rx_deferred_evt.evt.
+                                ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+                        }
+#endif
                     }
                     hci_link_control_pkt_send();
                     hci_timeout_setup(HCI_LINK_CONTROL_TIMEOUT); // Need to trigger transmitting SYNC messages
@@ -1380,6 +1951,10 @@ static void hci_link_control_event_handler(hci_evt_t * p_event)
                 case HCI_PKT_CONFIG:
                     if (m_hci_mode != HCI_MODE_UNINITIALIZED)
                     {
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+                        hci_tx_window_size_set(
+                            p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+#endif
                         m_hci_link_control_next_pkt = HCI_PKT_CONFIG_RSP;
                         hci_link_control_pkt_send();
                         m_hci_other_side_active = true;
@@ -1388,6 +1963,10 @@ static void hci_link_control_event_handler(hci_evt_t * p_event)
                 case HCI_PKT_CONFIG_RSP:
                     if (m_hci_mode == HCI_MODE_INITIALIZED)
                     {
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+                        hci_tx_window_size_set(
+                            p_event->evt.ser_phy_slip_evt.evt_params.received_pkt.p_buffer);
+#endif
                         m_hci_mode          = HCI_MODE_ACTIVE;
                         m_hci_tx_fsm_state  = HCI_TX_STATE_SEND;
                         m_hci_rx_fsm_state  = HCI_RX_STATE_RECEIVE;                        
@@ -1533,14 +2112,7 @@ static uint32_t  hci_timer_init(void)
 
 #ifdef HCI_APP_TIMER
 
-    err_code = app_timer_create(&m_app_timer_id, APP_TIMER_MODE_REPEATED, hci_timeout_handler);
-
-    if (err_code != NRF_SUCCESS)
-    {
-        return NRF_ERROR_INTERNAL;
-    }
-
-    err_code = app_timer_start(m_app_timer_id, RETRANSMISSION_TIMEOUT_IN_TICKS, NULL);
+    err_code = app_timer_create(&m_app_timer_id, APP_TIMER_MODE_SINGLE_SHOT, hci_timeout_handler);
 
     if (err_code != NRF_SUCCESS)
     {
@@ -1554,12 +2126,14 @@ static uint32_t  hci_timer_init(void)
     HCI_TIMER->MODE      = TIMER_MODE_MODE_Timer;
     HCI_TIMER->BITMODE   = TIMER_BITMODE_BITMODE_16Bit;
 
-    // Clear TIMER
-    HCI_TIMER->TASKS_CLEAR = 1;
+    // TIMER is started when a timeout is set up or a response time measurement starts
+    HCI_TIMER->TASKS_STOP    = 1;
+    HCI_TIMER->TASKS_CLEAR   = 1;
+    m_hci_timer_running_flag = false;
+    m_hci_timeout_armed_flag = false;
 
-    // Enable interrupt
+    // Interrupt is enabled when a timeout is set up
     HCI_TIMER->INTENCLR = 0xFFFFFFFF;
-    HCI_TIMER->INTENSET = TIMER_INTENSET_COMPARE1_Enabled << TIMER_INTENSET_COMPARE1_Pos;
 
     NVIC_ClearPendingIRQ(HCI_TIMER_IRQn);
     NVIC_SetPriority(HCI_TIMER_IRQn, APP_IRQ_PRIORITY_HIGH);
@@ -1620,6 +2194,14 @@ uint32_t ser_phy_open(ser_phy_events_handler_t events_handler)
         m_packet_ack_number = INITIAL_ACK_NUMBER_EXPECTED;
         m_packet_seq_number = INITIAL_SEQ_NUMBER;
         m_ser_phy_callback  = events_handler;
+        m_p_tx_payload      = NULL; // A packet not acknowledged before ser_phy_close is dropped.
+        m_slip_tx_frame_count       = 0;
+        m_slip_tx_pkt_count         = 0;
+        m_slip_tx_link_control_mask = 0;
+#if (SER_PHY_HCI_WINDOW_SIZE > 1)
+        hci_tx_window_reset();
+        m_rx_deferred_flag  = false;
+#endif
 
 #ifndef HCI_LINK_CONTROL
         m_hci_tx_fsm_state  = HCI_TX_STATE_SEND;
@@ -1644,6 +2226,11 @@ static uint32_t hci_timer_close(void)
     {
         return NRF_ERROR_INTERNAL;
     }
+#else
+    HCI_TIMER->INTENCLR      = 0xFFFFFFFF;
+    HCI_TIMER->TASKS_STOP    = 1;
+    m_hci_timer_running_flag = false;
+    m_hci_timeout_armed_flag = false;
 #endif
 
     return err_code;
@@ -1666,3 +2253,22 @@ void ser_phy_close(void)
 }
 
 
+uint32_t ser_phy_hci_stats_get(ser_phy_hci_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    CRITICAL_REGION_ENTER();
+    p_stats->retransmissions   = m_tx_retx_counter;
+    p_stats->spurious_timeouts = m_tx_spurious_counter;
+    p_stats->srtt_us           = m_rtt_srtt_us;
+    p_stats->rttvar_us         = m_rtt_rttvar_us;
+    p_stats->rto_us            = hci_rto_get();
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
@@ -143,5 +143,29 @@ uint32_t ser_phy_hci_slip_rx_buf_free(uint8_t * p_buffer);
  */
 void ser_phy_hci_slip_close(void);
 
+
+/**@brief Struct containing statistics of the HCI PHY reliable link. */
+typedef struct
+{
+    uint32_t retransmissions;   /**< Number of retransmitted packets. */
+    uint32_t spurious_timeouts; /**< Number of timeouts after which the acknowledgement of the original transmission was received. */
+    uint32_t srtt_us;           /**< Smoothed response time of the peer in microseconds, 0 if not measured yet. */
+    uint32_t rttvar_us;         /**< Response time variation of the peer in microseconds. */
+    uint32_t rto_us;            /**< Current retransmission timeout in microseconds. */
+} ser_phy_hci_stats_t;
+
+
+/**@brief A function for reading statistics of the HCI PHY reliable link.
+ *
+ * @note The response time of the peer is measured from the end of a packet transmission to the
+ *       reception of its acknowledgement. Packets which have been retransmitted are not measured.
+ *
+ * @param[out] p_stats    Pointer to a structure to be filled with the statistics.
+ *
+ * @retval NRF_SUCCESS       Operation success.
+ * @retval NRF_ERROR_NULL    Operation failure. NULL pointer supplied.
+ */
+uint32_t ser_phy_hci_stats_get(ser_phy_hci_stats_t * p_stats);
+
 #endif /* SER_PHY_HCI_H__ */
 /** @} */
@@ -12,6 +12,7 @@
 #include <stddef.h>
 
 #include "ble_serialization.h"
+#include "ser_config.h"
 #include "nrf_soc.h"
 #include "ble.h"
 #include "ble_l2cap.h"
@@ -32,18 +33,63 @@ typedef struct
     conn_mw_handler_t fp_handler; /**< Function pointer to handler associated with given opcode */
 } conn_mw_item_t;
 
+/**@brief Connectivity middleware handler of the Wire Format Set command.
+ *
+ * @details The compact format is accepted only if the connectivity chip is built with
+ *          @ref SER_WIRE_FORMAT_COMPACT_ENABLED. The standard format is always accepted.
+ */
+static uint32_t conn_mw_wire_format_set(uint8_t const * const p_rx_buf,
+                                        uint32_t              rx_buf_len,
+                                        uint8_t * const       p_tx_buf,
+                                        uint32_t * const      p_tx_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_rx_buf);
+    SER_ASSERT_NOT_NULL(p_tx_buf);
+    SER_ASSERT_NOT_NULL(p_tx_buf_len);
+
+    ser_wire_format_t format;
+    uint32_t          result_code = NRF_SUCCESS;
+    uint32_t          err_code;
+
+    err_code = ser_wire_format_set_req_dec(p_rx_buf, rx_buf_len, &format);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    if ((format == SER_WIRE_FORMAT_COMPACT) && !SER_WIRE_FORMAT_COMPACT_ENABLED)
+    {
+        result_code = NRF_ERROR_NOT_SUPPORTED;
+    }
+    else
+    {
+        ser_wire_format_set(format);
+    }
+
+    return ser_ble_cmd_rsp_status_code_enc(SER_OP_CODE_WIRE_FORMAT_SET,
+                                           result_code,
+                                           p_tx_buf,
+                                           p_tx_buf_len);
+}
+
 /* Include handlers for given softdevice */
 #include "conn_mw_items.c"
 
 /**@brief Number of registered connectivity middleware handlers. */
 static const uint32_t conn_mw_item_len = sizeof (conn_mw_item) / sizeof (conn_mw_item[0]);
 
-/**@brief Local function for finding connectivity middleware handler in the table.. */
+/**@brief Local function for finding connectivity middleware handler in the table.
+ *
+ * @details Opcodes from the BLE SVC range are looked up directly by index. Remaining opcodes are
+ *          searched for in the sparse table.
+ */
 static conn_mw_handler_t conn_mw_handler_get(uint8_t opcode)
 {
     conn_mw_handler_t fp_handler = NULL;
     uint32_t          i;
 
+    if ((opcode >= CONN_MW_DIRECT_OPCODE_FIRST) && (opcode <= CONN_MW_DIRECT_OPCODE_LAST))
+    {
+        return conn_mw_direct_handler[opcode - CONN_MW_DIRECT_OPCODE_FIRST];
+    }
+
     for (i = 0; i < conn_mw_item_len; i++)
     {
         if (opcode == conn_mw_item[i].opcode)
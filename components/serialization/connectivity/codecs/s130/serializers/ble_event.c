@@ -160,7 +160,14 @@ uint32_t ble_event_enc(ble_evt_t const * const p_event,
             break;
 
         case BLE_GATTS_EVT_WRITE:
-            ret_val = ble_gatts_evt_write_enc(p_event, event_len, p_buf, p_buf_len);
+            if (ser_wire_format_get() == SER_WIRE_FORMAT_COMPACT)
+            {
+                ret_val = ble_gatts_evt_write_compact_enc(p_event, event_len, p_buf, p_buf_len);
+            }
+            else
+            {
+                ret_val = ble_gatts_evt_write_enc(p_event, event_len, p_buf, p_buf_len);
+            }
             break;
 
         case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
@@ -176,7 +183,14 @@ uint32_t ble_event_enc(ble_evt_t const * const p_event,
             break;
 
         case BLE_GAP_EVT_ADV_REPORT:
-            ret_val = ble_gap_evt_adv_report_enc(p_event, event_len, p_buf, p_buf_len);
+            if (ser_wire_format_get() == SER_WIRE_FORMAT_COMPACT)
+            {
+                ret_val = ble_gap_evt_adv_report_compact_enc(p_event, event_len, p_buf, p_buf_len);
+            }
+            else
+            {
+                ret_val = ble_gap_evt_adv_report_enc(p_event, event_len, p_buf, p_buf_len);
+            }
             break;
 
         case BLE_GAP_EVT_SCAN_REQ_REPORT:
@@ -59,3 +59,61 @@ uint32_t ble_gap_evt_adv_report_enc(ble_evt_t const * const p_event,
 
     return err_code;
 }
+
+
+uint32_t ble_gap_evt_adv_report_compact_enc(ble_evt_t const * const p_event,
+                                            uint32_t                event_len,
+                                            uint8_t * const         p_buf,
+                                            uint32_t * const        p_buf_len)
+{
+    SER_ASSERT_NOT_NULL(p_event);
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_buf_len);
+
+    uint32_t       index      = 0;
+    uint32_t       total_len  = *p_buf_len;
+    uint32_t       err_code   = NRF_SUCCESS;
+    uint8_t        byte;
+    const uint16_t evt_header = BLE_GAP_EVT_ADV_REPORT | SER_EVT_ID_COMPACT_FLAG;
+
+    ble_gap_evt_adv_report_t const * p_adv_report = &(p_event->evt.gap_evt.params.adv_report);
+
+    err_code = uint16_t_enc((void *)&evt_header, p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    /* The connection handle is only sent when valid, which is flagged in the address type byte. */
+    byte = p_adv_report->peer_addr.addr_type;
+    if (p_event->evt.gap_evt.conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        byte |= SER_ADV_REPORT_COMPACT_CONN_HANDLE_FLAG;
+    }
+
+    err_code = uint8_t_enc((void *)&(byte), p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_vector_enc(p_adv_report->peer_addr.addr, BLE_GAP_ADDR_LEN, p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    if (p_event->evt.gap_evt.conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        err_code = varint16_enc((void *)&p_event->evt.gap_evt.conn_handle, p_buf, total_len, &index);
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    err_code = uint8_t_enc((void *)&(p_adv_report->rssi), p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    byte = (p_adv_report->scan_rsp) |
+           ((p_adv_report->type) << 0x01) |
+           ((p_adv_report->dlen) << 0x03);
+
+    err_code = uint8_t_enc((void *)&(byte), p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = uint8_vector_enc(p_adv_report->data, (uint16_t)p_adv_report->dlen, p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    *p_buf_len = index;
+
+    return err_code;
+}
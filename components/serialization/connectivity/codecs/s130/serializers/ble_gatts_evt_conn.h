@@ -152,5 +152,27 @@ uint32_t ble_gatts_evt_write_enc(ble_evt_t const * const p_event,
                                  uint8_t * const         p_buf,
                                  uint32_t * const        p_buf_len);
 
+/**
+ * @brief Encodes @ref BLE_GATTS_EVT_WRITE event in the compact wire format.
+ *
+ * Connection handle, attribute handle, offset and data length are encoded as variable length
+ * integers, operation and authorization flag are packed in one byte together with the UUID type,
+ * and zero offset and UUID of unknown type are omitted.
+ *
+ * @param[in] p_event          Pointer to the \ref ble_evt_t buffer that shall be encoded.
+ * @param[in] event_len        Size (in bytes) of \p p_event buffer.
+ * @param[out] p_buf           Pointer to the beginning of a buffer for encoded event packet.
+ * @param[in,out] p_buf_len    \c in: Size (in bytes) of \p p_buf buffer.
+ *                             \c out: Length of encoded contents in \p p_buf.
+ *
+ * @retval NRF_SUCCESS               Encoding success.
+ * @retval NRF_ERROR_NULL            Encoding failure. NULL pointer supplied.
+ * @retval NRF_ERROR_INVALID_LENGTH  Encoding failure. Incorrect buffer length.
+ */
+uint32_t ble_gatts_evt_write_compact_enc(ble_evt_t const * const p_event,
+                                         uint32_t                event_len,
+                                         uint8_t * const         p_buf,
+                                         uint32_t * const        p_buf_len);
+
 /** @} */
 #endif
@@ -61,3 +61,47 @@ uint32_t ble_gatts_evt_write_enc(ble_evt_t const * const p_event,
 
     return err_code;
 }
+
+uint32_t ble_gatts_evt_write_compact_enc(ble_evt_t const * const p_event,
+                                         uint32_t                event_len,
+                                         uint8_t * const         p_buf,
+                                         uint32_t * const        p_buf_len)
+{
+
+    uint32_t err_code = NRF_SUCCESS;
+
+    SER_ASSERT_NOT_NULL(p_event);
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_buf_len);
+
+    uint32_t index      = 0;
+    uint32_t total_len  = *p_buf_len;
+    uint16_t evt_header = BLE_GATTS_EVT_WRITE | SER_EVT_ID_COMPACT_FLAG;
+
+    err_code = uint16_t_enc(&evt_header, p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = varint16_enc(&(p_event->evt.gatts_evt.conn_handle), p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    err_code = ble_gatts_evt_write_t_compact_enc(&(p_event->evt.gatts_evt.params.write),
+                                                 p_buf,
+                                                 total_len,
+                                                 &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    if((p_event->evt.gatts_evt.params.write.op == BLE_GATTS_OP_WRITE_REQ) || (p_event->evt.gatts_evt.params.write.op == BLE_GATTS_OP_EXEC_WRITE_REQ_NOW))
+    {
+        uint32_t conn_index;
+
+        if(conn_ble_user_mem_context_find(p_event->evt.gatts_evt.conn_handle, &conn_index) != NRF_ERROR_NOT_FOUND)
+        {
+            err_code = len16data_enc(m_conn_user_mem_table[conn_index].mem_block.p_mem, m_conn_user_mem_table[conn_index].mem_block.len, p_buf, *p_buf_len, &index);
+            SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+        }
+    }
+
+    *p_buf_len = index;
+
+    return err_code;
+}
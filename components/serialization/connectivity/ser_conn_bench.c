@@ -0,0 +1,376 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "nordic_common.h"
+#include "app_error.h"
+#include "app_scheduler.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#include "ble.h"
+#include "ble_serialization.h"
+#include "ser_config.h"
+#include "ser_bench.h"
+#include "ser_hal_transport.h"
+#include "ser_conn_handlers.h"
+#include "ser_conn_event_encoder.h"
+#include "ser_conn_bench.h"
+
+#if SER_CONN_BENCHMARK_ENABLED
+
+/** Period of the generator tick in RTC ticks. */
+#define BENCH_TIMER_TICKS       APP_TIMER_TICKS(SER_CONN_BENCH_TICK_MS, SER_CONN_BENCH_TIMER_PRESCALER)
+
+/** Length of a synthetic event up to the attribute value. */
+#define BENCH_EVT_HDR_LEN       (offsetof(ble_evt_t, evt.gatts_evt.params.write.data))
+
+/** Maximum length of the attribute value carried by a synthetic event. */
+#define BENCH_EVT_DATA_LEN_MAX  (sizeof (m_evt_buffer) - BENCH_EVT_HDR_LEN)
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT == 0)
+/** Maximum number of synthetic events in the application scheduler queue. The rest of the queue is
+ *  left for SoftDevice events. */
+#define BENCH_SCHED_EVT_MAX     (SER_CONN_SCHED_QUEUE_SIZE / 2)
+#endif
+
+APP_TIMER_DEF(m_bench_timer_id);
+
+/** Synthetic event, aligned to 32 bits. Built when the generator is started. */
+static uint32_t m_evt_buffer[CEIL_DIV(BLE_STACK_EVT_MSG_BUF_SIZE, sizeof (uint32_t))];
+
+static ser_bench_evt_params_t m_evt_params;     /**< Parameters of the running generator. */
+static uint32_t               m_evt_left;       /**< Events left to generate if the count is limited. */
+static uint32_t               m_evt_rate_acc;   /**< Fraction of an event carried to the next tick, in thousandths. */
+
+/** Number of events due but not yet passed to the event encoder. Incremented in the timer handler
+ *  and decremented in the main context. */
+static volatile uint32_t      m_evt_due;
+
+/** Number of events dropped because the backlog was full. Modified in the timer handler only. */
+static volatile uint32_t      m_evt_dropped;
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT == 0)
+/** Number of synthetic events in the application scheduler queue. Modified in the main context only. */
+static uint8_t                m_evt_in_sched;
+#endif
+
+static ser_bench_stats_t      m_stats;          /**< Statistics of the current window. */
+static uint32_t               m_ticks_last;     /**< RTC counter when the window length was last updated. */
+static uint32_t               m_idle_start;     /**< RTC counter when the CPU went idle. */
+
+
+/**@brief Function for adding the time elapsed since the last update to the statistics window. */
+static void stats_ticks_update(uint32_t ticks_now)
+{
+    uint32_t ticks_diff;
+
+    (void)app_timer_cnt_diff_compute(ticks_now, m_ticks_last, &ticks_diff);
+    m_stats.total_ticks += ticks_diff;
+    m_ticks_last         = ticks_now;
+}
+
+
+/**@brief Function for making events due at the configured rate, called on every generator tick. */
+static void bench_timer_handler(void * p_context)
+{
+    uint32_t due;
+
+    UNUSED_PARAMETER(p_context);
+
+    m_evt_rate_acc += m_evt_params.rate * SER_CONN_BENCH_TICK_MS;
+    due             = m_evt_rate_acc / 1000;
+    m_evt_rate_acc -= due * 1000;
+
+    if (m_evt_params.count != 0)
+    {
+        due         = MIN(due, m_evt_left);
+        m_evt_left -= due;
+
+        if (m_evt_left == 0)
+        {
+            (void)app_timer_stop(m_bench_timer_id);
+        }
+    }
+
+    if (m_evt_due + due > SER_CONN_BENCH_EVT_BACKLOG_MAX)
+    {
+        m_evt_dropped += m_evt_due + due - SER_CONN_BENCH_EVT_BACKLOG_MAX;
+        due            = SER_CONN_BENCH_EVT_BACKLOG_MAX - m_evt_due;
+    }
+
+    m_evt_due += due;
+}
+
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT == 0)
+/**@brief Application scheduler handler encoding a synthetic event. */
+static void bench_evt_encoder(void * p_event_data, uint16_t event_size)
+{
+    m_evt_in_sched--;
+    ser_conn_ble_event_encoder(p_event_data, event_size);
+}
+#endif
+
+
+/**@brief Function for stopping the generator and discarding the due events. */
+static void evt_stop(void)
+{
+    (void)app_timer_stop(m_bench_timer_id);
+
+    CRITICAL_REGION_ENTER();
+    m_evt_due = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for building the synthetic event and starting the generator. */
+static uint32_t evt_start(uint8_t const * p_command, uint16_t command_len)
+{
+    ble_evt_t * p_ble_evt = (ble_evt_t *)m_evt_buffer;
+    uint32_t    err_code;
+    uint16_t    i;
+
+    err_code = ser_bench_evt_start_req_dec(p_command, command_len, &m_evt_params);
+
+    if (NRF_SUCCESS != err_code)
+    {
+        return err_code;
+    }
+
+    if ((m_evt_params.rate == 0) || (m_evt_params.data_len > BENCH_EVT_DATA_LEN_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    evt_stop();
+
+    memset(p_ble_evt, 0, BENCH_EVT_HDR_LEN);
+    p_ble_evt->header.evt_id                       = BLE_GATTS_EVT_WRITE;
+    p_ble_evt->header.evt_len                      = (uint16_t)(BENCH_EVT_HDR_LEN -
+                                                                sizeof (ble_evt_hdr_t) +
+                                                                m_evt_params.data_len);
+    p_ble_evt->evt.gatts_evt.conn_handle           = 0;
+    p_ble_evt->evt.gatts_evt.params.write.handle   = SER_BENCH_EVT_ATTR_HANDLE;
+    p_ble_evt->evt.gatts_evt.params.write.op       = BLE_GATTS_OP_WRITE_CMD;
+    p_ble_evt->evt.gatts_evt.params.write.len      = m_evt_params.data_len;
+
+    for (i = 0; i < m_evt_params.data_len; i++)
+    {
+        p_ble_evt->evt.gatts_evt.params.write.data[i] = (uint8_t)i;
+    }
+
+    m_evt_left     = m_evt_params.count;
+    m_evt_rate_acc = 0;
+
+    return app_timer_start(m_bench_timer_id, BENCH_TIMER_TICKS, NULL);
+}
+
+
+/**@brief Function for encoding the response (opcode + error code + data) to a Benchmark Command. */
+static uint32_t bench_rsp_enc(uint8_t const * p_command,
+                              uint16_t        command_len,
+                              uint8_t *       p_buf,
+                              uint32_t *      p_buf_len)
+{
+    uint8_t  opcode     = p_command[SER_CMD_OP_CODE_POS];
+    uint32_t data_len   = command_len - SER_OP_CODE_SIZE;
+    uint32_t buf_len    = *p_buf_len;
+    uint32_t index      = 0;
+    uint32_t err_code   = NRF_SUCCESS;
+    uint32_t ticks_now;
+
+    switch (opcode)
+    {
+        case SER_BENCH_OP_ECHO:
+        {
+            if (SER_CMD_RSP_HEADER_SIZE + data_len > buf_len)
+            {
+                return op_status_enc(opcode, NRF_ERROR_DATA_SIZE, p_buf, p_buf_len, &index);
+            }
+
+            err_code = op_status_enc(opcode, NRF_SUCCESS, p_buf, p_buf_len, &index);
+            memcpy(&p_buf[index], &p_command[SER_OP_CODE_SIZE], data_len);
+            *p_buf_len += data_len;
+            break;
+        }
+
+        case SER_BENCH_OP_EVT_START:
+        {
+            err_code = evt_start(p_command, command_len);
+            err_code = op_status_enc(opcode, err_code, p_buf, p_buf_len, &index);
+            break;
+        }
+
+        case SER_BENCH_OP_EVT_STOP:
+        {
+            evt_stop();
+            err_code = op_status_enc(opcode, NRF_SUCCESS, p_buf, p_buf_len, &index);
+            break;
+        }
+
+        case SER_BENCH_OP_STATS_GET:
+        {
+            (void)app_timer_cnt_get(&ticks_now);
+            stats_ticks_update(ticks_now);
+
+            CRITICAL_REGION_ENTER();
+            m_stats.evt_dropped = m_evt_dropped;
+            m_evt_dropped       = 0;
+            CRITICAL_REGION_EXIT();
+
+            m_stats.tick_freq = APP_TIMER_CLOCK_FREQ / (SER_CONN_BENCH_TIMER_PRESCALER + 1);
+
+            err_code = ser_bench_stats_get_rsp_enc(NRF_SUCCESS, &m_stats, p_buf, p_buf_len);
+            memset(&m_stats, 0, sizeof (m_stats));
+            break;
+        }
+
+        default:
+        {
+            err_code = op_status_enc(opcode, NRF_ERROR_NOT_SUPPORTED, p_buf, p_buf_len, &index);
+            break;
+        }
+    }
+
+    return err_code;
+}
+
+
+uint32_t ser_conn_bench_init(void)
+{
+    uint32_t err_code;
+
+    err_code = app_timer_create(&m_bench_timer_id, APP_TIMER_MODE_REPEATED, bench_timer_handler);
+
+    if (NRF_SUCCESS == err_code)
+    {
+        err_code = app_timer_cnt_get(&m_ticks_last);
+    }
+
+    return err_code;
+}
+
+
+uint32_t ser_conn_bench_command_process(uint8_t * p_command, uint16_t command_len)
+{
+    SER_ASSERT_NOT_NULL(p_command);
+    SER_ASSERT_LENGTH_LEQ(SER_OP_CODE_SIZE, command_len);
+
+    uint32_t  err_code   = NRF_SUCCESS;
+    uint8_t * p_tx_buf   = NULL;
+    uint32_t  tx_buf_len = 0;
+
+    m_stats.cmd_count++;
+
+    /* Allocate a memory buffer from HAL Transport layer for transmitting the Benchmark Response.
+     * Loop until a buffer is available. */
+    do
+    {
+        err_code = ser_hal_transport_tx_pkt_alloc(&p_tx_buf, (uint16_t *)&tx_buf_len);
+    }
+    while (NRF_ERROR_NO_MEM == err_code);
+
+    if (NRF_SUCCESS != err_code)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_BENCH_RESP;
+    tx_buf_len                -= SER_PKT_TYPE_SIZE;
+
+    err_code = bench_rsp_enc(p_command, command_len, &p_tx_buf[SER_PKT_OP_CODE_POS], &tx_buf_len);
+
+    if (NRF_SUCCESS == err_code)
+    {
+        tx_buf_len += SER_PKT_TYPE_SIZE;
+        err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
+        /* TX buffer is going to be freed automatically in the HAL Transport layer. */
+    }
+    else
+    {
+        (void)ser_hal_transport_tx_pkt_free(p_tx_buf);
+    }
+
+    return (NRF_SUCCESS == err_code) ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+}
+
+
+uint32_t ser_conn_bench_evt_process(void)
+{
+    uint32_t    err_code  = NRF_SUCCESS;
+    ble_evt_t * p_ble_evt = (ble_evt_t *)m_evt_buffer;
+
+    while (m_evt_due > 0)
+    {
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+        /* One TX buffer is always left for a command response. */
+        if (ser_hal_transport_tx_free_buf_count_get() <= 1)
+        {
+            break;
+        }
+
+        ser_conn_ble_event_direct_encoder(p_ble_evt);
+#else
+        if (m_evt_in_sched >= BENCH_SCHED_EVT_MAX)
+        {
+            break;
+        }
+
+        err_code = app_sched_event_put(p_ble_evt,
+                                       sizeof (ble_evt_hdr_t) + p_ble_evt->header.evt_len,
+                                       bench_evt_encoder);
+
+        if (NRF_ERROR_NO_MEM == err_code)
+        {
+            err_code = NRF_SUCCESS;
+            break;
+        }
+        else if (NRF_SUCCESS != err_code)
+        {
+            break;
+        }
+
+        m_evt_in_sched++;
+#endif
+
+        CRITICAL_REGION_ENTER();
+        m_evt_due--;
+        CRITICAL_REGION_EXIT();
+
+        m_stats.evt_count++;
+    }
+
+    return err_code;
+}
+
+
+void ser_conn_bench_idle_enter(void)
+{
+    (void)app_timer_cnt_get(&m_idle_start);
+    stats_ticks_update(m_idle_start);
+}
+
+
+void ser_conn_bench_idle_exit(void)
+{
+    uint32_t ticks_now;
+    uint32_t ticks_idle;
+
+    (void)app_timer_cnt_get(&ticks_now);
+    (void)app_timer_cnt_diff_compute(ticks_now, m_idle_start, &ticks_idle);
+
+    m_stats.idle_ticks += ticks_idle;
+    stats_ticks_update(ticks_now);
+}
+
+#endif /* SER_CONN_BENCHMARK_ENABLED */
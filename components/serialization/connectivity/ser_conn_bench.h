@@ -0,0 +1,91 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @addtogroup ser_conn Connectivity application code
+ * @ingroup ble_sdk_lib_serialization
+ */
+
+/** @file
+ *
+ * @defgroup ser_conn_bench Benchmark mode of the connectivity chip
+ * @{
+ * @ingroup ser_conn
+ *
+ * @brief   Benchmark Command processing and synthetic BLE event generation.
+ *
+ * @details Available when @ref SER_CONN_BENCHMARK_ENABLED is set. Benchmark Commands
+ *          (@ref ser_bench) loop back serialized data and control a generator of synthetic BLE
+ *          events. Synthetic events are due on an app_timer tick and are encoded in the main loop,
+ *          through the same event path as SoftDevice events. The main loop reports the time spent
+ *          in sd_app_evt_wait() to measure the CPU idle time.
+ */
+
+#ifndef SER_CONN_BENCH_H__
+#define SER_CONN_BENCH_H__
+
+#include <stdint.h>
+#include "ser_config.h"
+
+/** Period of the synthetic event generator tick in milliseconds. */
+#define SER_CONN_BENCH_TICK_MS          10u
+
+/** Maximum number of synthetic events which are due but not yet passed to the event encoder.
+ *  Events becoming due when the backlog is full are dropped and counted. */
+#define SER_CONN_BENCH_EVT_BACKLOG_MAX  64u
+
+/** Prescaler of the app_timer instance started by the benchmark mode. */
+#define SER_CONN_BENCH_TIMER_PRESCALER  0u
+
+/** Size of the app_timer operations queue used by the benchmark mode. */
+#define SER_CONN_BENCH_TIMER_OP_QUEUE_SIZE  2u
+
+/**@brief A function for initializing the benchmark mode.
+ *
+ * @note  The app_timer module has to be initialized before this function is called.
+ *
+ * @retval    NRF_SUCCESS    Operation success, otherwise an error code returned by app_timer.
+ */
+uint32_t ser_conn_bench_init(void);
+
+
+/**@brief A function for processing a Benchmark Command and sending the Benchmark Response.
+ *
+ * @param[in]   p_command      The command (opcode + data).
+ * @param[in]   command_len    Length of the command.
+ *
+ * @retval    NRF_SUCCESS           Command processed and response sent.
+ * @retval    NRF_ERROR_INTERNAL    Operation failure. Internal error ocurred.
+ */
+uint32_t ser_conn_bench_command_process(uint8_t * p_command, uint16_t command_len);
+
+
+/**@brief A function for passing due synthetic events to the event encoder.
+ *
+ * @details Events are passed as long as the event path has room for them, the rest stay due until
+ *          the next call. Called from the main loop after the received packets are processed.
+ *
+ * @retval    NRF_SUCCESS    No more events can be processed at the moment, otherwise an error code.
+ */
+uint32_t ser_conn_bench_evt_process(void);
+
+
+/**@brief A function for marking the start of the CPU idle time (before sd_app_evt_wait()). */
+void ser_conn_bench_idle_enter(void);
+
+
+/**@brief A function for marking the end of the CPU idle time (after sd_app_evt_wait()). */
+void ser_conn_bench_idle_exit(void);
+
+#endif /* SER_CONN_BENCH_H__ */
+
+/** @} */
@@ -21,7 +21,17 @@
 #include "ser_conn_cmd_decoder.h"
 
 
-uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
+/**@brief Local function for decoding a command and sending a response with a given header.
+ *
+ * @param[in]   p_command      The encoded command.
+ * @param[in]   command_len    Length of the encoded command including opcode.
+ * @param[in]   p_rsp_hdr      Response header (packet type and optionally sequence ID).
+ * @param[in]   rsp_hdr_len    Length of the response header.
+ */
+static uint32_t command_process(uint8_t *       p_command,
+                                uint16_t        command_len,
+                                uint8_t const * p_rsp_hdr,
+                                uint32_t        rsp_hdr_len)
 {
     SER_ASSERT_NOT_NULL(p_command);
     SER_ASSERT_LENGTH_LEQ(SER_OP_CODE_SIZE, command_len);
@@ -43,12 +53,11 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
     if (NRF_SUCCESS == err_code)
     {
         /* Create a new response packet. */
-        p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_RESP;
-        tx_buf_len                -= SER_PKT_TYPE_SIZE;
+        memcpy(p_tx_buf, p_rsp_hdr, rsp_hdr_len);
+        tx_buf_len -= rsp_hdr_len;
 
         /* Decode a request, pass a memory for a response command (opcode + data) and encode it. */
-        err_code = conn_mw_handler
-                       (p_command, command_len, &p_tx_buf[SER_PKT_OP_CODE_POS], &tx_buf_len);
+        err_code = conn_mw_handler(p_command, command_len, &p_tx_buf[rsp_hdr_len], &tx_buf_len);
 
         /* Command decoder not found. */
         if (NRF_ERROR_NOT_SUPPORTED == err_code)
@@ -56,10 +65,10 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
             APP_ERROR_CHECK(SER_WARNING_CODE);
             err_code = op_status_enc
                            (opcode, NRF_ERROR_NOT_SUPPORTED,
-                           &p_tx_buf[SER_PKT_OP_CODE_POS], &tx_buf_len, &index);
+                           &p_tx_buf[rsp_hdr_len], &tx_buf_len, &index);
             if (NRF_SUCCESS == err_code)
             {
-                tx_buf_len += SER_PKT_TYPE_SIZE;
+                tx_buf_len += rsp_hdr_len;
                 err_code   = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
                 /* TX buffer is going to be freed automatically in the HAL Transport layer. */
                 if (NRF_SUCCESS != err_code)
@@ -74,7 +83,7 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
         }
         else if (NRF_SUCCESS == err_code) /* Send a response. */
         {
-            tx_buf_len += SER_PKT_TYPE_SIZE;
+            tx_buf_len += rsp_hdr_len;
             err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
 
             /* TX buffer is going to be freed automatically in the HAL Transport layer. */
@@ -95,3 +104,19 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
 
     return err_code;
 }
+
+
+uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
+{
+    uint8_t const rsp_hdr[] = {SER_PKT_TYPE_RESP};
+
+    return command_process(p_command, command_len, rsp_hdr, sizeof (rsp_hdr));
+}
+
+
+uint32_t ser_conn_seq_command_process(uint8_t seq_id, uint8_t * p_command, uint16_t command_len)
+{
+    uint8_t const rsp_hdr[] = {SER_PKT_TYPE_SEQ_RESP, seq_id};
+
+    return command_process(p_command, command_len, rsp_hdr, sizeof (rsp_hdr));
+}
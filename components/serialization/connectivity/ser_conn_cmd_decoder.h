@@ -48,6 +48,22 @@
  */
 uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len);
 
+/**@brief A function decodes a command tagged with a sequence ID and sends a response tagged with the
+ *        same sequence ID to an Application Chip.
+ *
+ * @details Works as @ref ser_conn_command_process but is used for @ref SER_PKT_TYPE_SEQ_CMD packets
+ *          when pipelining is enabled (see @ref SER_PIPELINE_WINDOW_SIZE).
+ *
+ * @param[in]   seq_id         Sequence ID of the command, echoed in the response.
+ * @param[in]   p_command      The encoded command.
+ * @param[in]   command_len    Length of the encoded command including opcode.
+ *
+ * @retval    NRF_SUCCESS           Operation success.
+ * @retval    NRF_ERROR_NULL        Operation failure. NULL pointer supplied.
+ * @retval    NRF_ERROR_INTERNAL    Operation failure. Internal error ocurred.
+ */
+uint32_t ser_conn_seq_command_process(uint8_t seq_id, uint8_t * p_command, uint16_t command_len);
+
 #endif /* SER_CONN_CMD_DECODER_H__ */
 
 /** @} */
@@ -12,6 +12,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "app_error.h"
 #include "app_scheduler.h"
 #include "ble_conn.h"
@@ -21,18 +22,19 @@
 #include "ser_conn_event_encoder.h"
 
 
-void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
+/**@brief A function for encoding a BLE event into a newly allocated TX buffer and sending it.
+ *
+ * @param[in]   p_ble_evt   Pointer to the event.
+ *
+ * @retval      true        Event was encoded and passed to the HAL Transport layer.
+ * @retval      false       Event is not supported by the serialization, nothing was sent.
+ */
+static bool ble_event_encode_and_send(ble_evt_t * p_ble_evt)
 {
-    if (NULL == p_event_data)
-    {
-        APP_ERROR_CHECK(NRF_ERROR_NULL);
-    }
-    UNUSED_PARAMETER(event_size);
-
     uint32_t    err_code   = NRF_SUCCESS;
     uint8_t *   p_tx_buf   = NULL;
     uint32_t    tx_buf_len = 0;
-    ble_evt_t * p_ble_evt  = (ble_evt_t *)p_event_data;
+    bool        is_sent    = false;
 
     /* Allocate a memory buffer from HAL Transport layer for transmitting an event.
      * Loop until a buffer is available. */
@@ -56,13 +58,8 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
         tx_buf_len += SER_PKT_TYPE_SIZE;
         err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
         APP_ERROR_CHECK(err_code);
-        /* TX buffer is going to be freed automatically in the HAL Transport layer.
-         * Scheduler must be paused because this function returns before a packet is physically sent
-         * by transport layer. This can cause start processing of a next event from the application
-         * scheduler queue. In result the next event reserves the TX buffer before the current
-         * packet is sent. If in meantime a command arrives a command response cannot be sent in
-         * result. Pausing the scheduler temporary prevents processing a next event. */
-        app_sched_pause();
+        /* TX buffer is going to be freed automatically in the HAL Transport layer. */
+        is_sent     = true;
     }
     else
     {
@@ -71,5 +68,38 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
         APP_ERROR_CHECK(err_code);
         APP_ERROR_CHECK(SER_WARNING_CODE);
     }
+
+    return is_sent;
 }
 
+
+void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
+{
+    if (NULL == p_event_data)
+    {
+        APP_ERROR_CHECK(NRF_ERROR_NULL);
+    }
+    UNUSED_PARAMETER(event_size);
+
+    if (ble_event_encode_and_send((ble_evt_t *)p_event_data))
+    {
+        /* Scheduler must be paused because this function returns before a packet is physically sent
+         * by transport layer. This can cause start processing of a next event from the application
+         * scheduler queue. In result the next event reserves the TX buffer before the current
+         * packet is sent. If in meantime a command arrives a command response cannot be sent in
+         * result. Pausing the scheduler temporary prevents processing a next event. */
+        app_sched_pause();
+    }
+}
+
+
+void ser_conn_ble_event_direct_encoder(ble_evt_t * p_ble_evt)
+{
+    if (NULL == p_ble_evt)
+    {
+        APP_ERROR_CHECK(NRF_ERROR_NULL);
+    }
+
+    /* The caller reserves a TX buffer for a command response, so the scheduler is not paused. */
+    (void)ble_event_encode_and_send(p_ble_evt);
+}
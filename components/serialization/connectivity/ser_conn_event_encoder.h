@@ -31,6 +31,7 @@
 #define SER_CONN_EVENT_ENCODER_H__
 
 #include <stdint.h>
+#include "ble.h"
 
 /**@brief A function for encoding a @ref ble_evt_t. The function passes the serialized byte stream
  *        to the transport layer after encoding.
@@ -45,6 +46,17 @@
  */
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size);
 
+/**@brief A function for encoding a @ref ble_evt_t directly from a SoftDevice event buffer. The
+ *        function passes the serialized byte stream to the transport layer after encoding.
+ *
+ * @details The function is used by the zero-copy event path (@ref SER_CONN_EVT_TX_SLOT_COUNT). It
+ *          does not pause the application scheduler, so the caller has to make sure that a TX
+ *          buffer is left for a command response.
+ *
+ * @param[in]   p_ble_evt      Pointer to the event pulled from the SoftDevice.
+ */
+void ser_conn_ble_event_direct_encoder(ble_evt_t * p_ble_evt);
+
 #endif /* SER_CONN_EVENT_ENCODER_H__ */
 
 /** @} */
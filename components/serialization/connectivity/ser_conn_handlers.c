@@ -13,6 +13,7 @@
 #include <string.h>
 #include "app_error.h"
 #include "app_scheduler.h"
+#include "app_util_platform.h"
 #include "ser_config.h"
 #include "ser_conn_handlers.h"
 #include "ser_conn_event_encoder.h"
@@ -32,11 +33,21 @@
  *          the SoftDevice and events generated by the HAL Transport layer.
  */
 
-/** Parameters of a received packet. */
-static ser_hal_transport_evt_rx_pkt_received_params_t m_rx_pkt_received_params;
+/** Queue of received packets waiting to be processed. There are never more received packets than
+ *  RX buffers in the HAL Transport layer, so the queue cannot overflow. */
+static ser_hal_transport_evt_rx_pkt_received_params_t
+    m_rx_pkt_received_params[SER_HAL_TRANSPORT_RX_BUF_COUNT];
 
-/** Indicator of received packet that should be process. */
-static bool m_rx_pkt_to_process = false;
+/** Index of the next received packet to be processed. Modified in the main context only. */
+static volatile uint8_t m_rx_pkt_start_index = 0;
+
+/** Number of received packets that should be processed. */
+static volatile uint8_t m_rx_pkt_count = 0;
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+/** Buffer for BLE events pulled from the SoftDevice, aligned to 32 bits. */
+static uint32_t m_ble_evt_buffer[CEIL_DIV(BLE_STACK_EVT_MSG_BUF_SIZE, sizeof (uint32_t))];
+#endif
 
 
 void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
@@ -69,9 +80,12 @@ void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
             /* We can NOT add received packets as events to the application scheduler queue because
              * received packets have to be processed before SoftDevice events but the scheduler
              * queue do not have priorities. */
-            memcpy(&m_rx_pkt_received_params, &event.evt_params.rx_pkt_received,
+            uint8_t end_index = (m_rx_pkt_start_index + m_rx_pkt_count) %
+                                SER_HAL_TRANSPORT_RX_BUF_COUNT;
+
+            memcpy(&m_rx_pkt_received_params[end_index], &event.evt_params.rx_pkt_received,
                    sizeof (ser_hal_transport_evt_rx_pkt_received_params_t));
-            m_rx_pkt_to_process = true;
+            m_rx_pkt_count++;
             break;
         }
 
@@ -100,12 +114,17 @@ uint32_t ser_conn_rx_process(void)
 {
     uint32_t err_code = NRF_SUCCESS;
 
-    if (m_rx_pkt_to_process)
+    while ((NRF_SUCCESS == err_code) && (m_rx_pkt_count > 0))
     {
-        /* No critical section needed on m_rx_pkt_to_process parameter because it is not possible
-         * to get next packet before sending a response. */
-        m_rx_pkt_to_process = false;
-        err_code            = ser_conn_received_pkt_process(&m_rx_pkt_received_params);
+        /* The packet has to be processed before it is removed from the queue, because the queue
+         * slot is reused as soon as its RX buffer is freed. */
+        err_code = ser_conn_received_pkt_process(&m_rx_pkt_received_params[m_rx_pkt_start_index]);
+
+        m_rx_pkt_start_index = (m_rx_pkt_start_index + 1) % SER_HAL_TRANSPORT_RX_BUF_COUNT;
+
+        CRITICAL_REGION_ENTER();
+        m_rx_pkt_count--;
+        CRITICAL_REGION_EXIT();
     }
 
     return err_code;
@@ -126,4 +145,36 @@ void ser_conn_ble_event_handle(ble_evt_t * p_ble_evt)
     APP_ERROR_CHECK(err_code);
 }
 
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+uint32_t ser_conn_ble_event_process(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+    uint16_t evt_len;
+
+    /* Events are encoded from the SoftDevice event buffer straight into TX buffers, one TX buffer is
+     * always left for a response to a received command. Events which do not fit stay queued in the
+     * SoftDevice, the main loop is woken up when a transmission completes. */
+    while (ser_hal_transport_tx_free_buf_count_get() > 1)
+    {
+        evt_len  = (uint16_t)sizeof (m_ble_evt_buffer);
+        err_code = sd_ble_evt_get((uint8_t *)m_ble_evt_buffer, &evt_len);
+
+        if (NRF_SUCCESS != err_code)
+        {
+            break;
+        }
+
+        ser_conn_ble_event_direct_encoder((ble_evt_t *)m_ble_evt_buffer);
+    }
+
+    if (NRF_ERROR_NOT_FOUND == err_code)
+    {
+        err_code = NRF_SUCCESS;
+    }
+
+    return err_code;
+}
+#endif /* SER_CONN_EVT_TX_SLOT_COUNT > 0 */
+
 /** @} */
@@ -39,8 +39,20 @@
 #include "ant_stack_handler_types.h"
 #include "softdevice_handler.h"
 #include "ble.h"
+#include "ser_config.h"
 #include "ser_hal_transport.h"
 
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+
+/** Maximum number of events in the application scheduler queue. BLE events are not put into the
+ *  scheduler queue in the zero-copy event path. */
+#define SER_CONN_SCHED_QUEUE_SIZE             1u
+
+/** Maximum size of events data in the application scheduler queue. */
+#define SER_CONN_SCHED_MAX_EVENT_DATA_SIZE    0u
+
+#else
+
 /** Maximum number of events in the application scheduler queue. */
 #define SER_CONN_SCHED_QUEUE_SIZE             16u
 
@@ -55,6 +67,8 @@
                                                          sizeof(uint32_t))) *                   \
                                                sizeof(uint32_t))
 
+#endif /* SER_CONN_EVT_TX_SLOT_COUNT > 0 */
+
 
 /**@brief A function for processing the HAL Transport layer events.
  *
@@ -80,5 +94,20 @@ uint32_t ser_conn_rx_process(void);
  */
 void ser_conn_ble_event_handle(ble_evt_t * p_ble_evt);
 
+
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+/**@brief A function for pulling BLE events from the SoftDevice and encoding them directly into
+ *        HAL Transport TX buffers.
+ *
+ * @details Used instead of @ref ser_conn_ble_event_handle when the zero-copy event path is enabled.
+ *          Events are pulled only as long as a TX buffer is left for a command response. The
+ *          remaining events stay in the SoftDevice until a packet transmission completes.
+ *
+ * @retval    NRF_SUCCESS    No more events can be processed at the moment.
+ * @retval    Other          Error code returned by sd_ble_evt_get().
+ */
+uint32_t ser_conn_ble_event_process(void);
+#endif /* SER_CONN_EVT_TX_SLOT_COUNT > 0 */
+
 #endif /* SER_CONN_HANDLERS_H__ */
 /** @} */
@@ -22,6 +22,7 @@
 #include "ser_conn_cmd_decoder.h"
 #include "ser_conn_dtm_cmd_decoder.h"
 #include "ser_conn_reset_cmd_decoder.h"
+#include "ser_conn_bench.h"
 
 
 uint32_t ser_conn_received_pkt_process(
@@ -43,6 +44,22 @@ uint32_t ser_conn_received_pkt_process(
                 break;
             }
 
+            case SER_PKT_TYPE_SEQ_CMD:
+            {
+                if (command_len >= SER_PKT_SEQ_ID_SIZE)
+                {
+                    err_code = ser_conn_seq_command_process
+                                   (p_rx_pkt_params->p_buffer[SER_PKT_SEQ_ID_POS],
+                                   &p_rx_pkt_params->p_buffer[SER_PKT_SEQ_OP_CODE_POS],
+                                   command_len - SER_PKT_SEQ_ID_SIZE);
+                }
+                else
+                {
+                    err_code = NRF_ERROR_INVALID_LENGTH;
+                }
+                break;
+            }
+
             case SER_PKT_TYPE_DTM_CMD:
             {
                 err_code = ser_conn_dtm_command_process(p_command, command_len);
@@ -55,6 +72,14 @@ uint32_t ser_conn_received_pkt_process(
                 break;
             }
 
+#if SER_CONN_BENCHMARK_ENABLED
+            case SER_PKT_TYPE_BENCH_CMD:
+            {
+                err_code = ser_conn_bench_command_process(p_command, command_len);
+                break;
+            }
+#endif
+
             default:
             {
                 APP_ERROR_CHECK(SER_WARNING_CODE);
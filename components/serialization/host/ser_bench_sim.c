@@ -0,0 +1,837 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief   Serialization throughput benchmark against simulated transports.
+ *
+ * @details The benchmark runs the connectivity chip benchmark mode (@ref ser_bench) against a
+ *          simulated transport for each PHY of the connectivity application (UART, SPI, SPI-5W,
+ *          HCI). The application side keeps a window of Benchmark ECHO commands outstanding while
+ *          the connectivity side generates synthetic GATTS Write events at a requested rate.
+ *
+ *          Packets are encoded and decoded with the real codecs, so packet lengths, SLIP escaping
+ *          and codec execution times are real. Codec execution times measured on the host are
+ *          multiplied by a CPU scale factor to approximate the connectivity chip. Wire timing and
+ *          the driver CPU load of each transport come from the link models in @ref m_transports,
+ *          derived from the defaults in ser_config.h. The connectivity chip main loop is modelled
+ *          as in nrf51_drone/main.c: commands are processed before events, a command response
+ *          always gets a TX buffer and an event is encoded only when the event path has a TX
+ *          buffer for it.
+ *
+ *          Reported per transport: commands/s, events/s, events dropped by the generator,
+ *          command round trip and event delivery latencies (p50/p99) and the idle time of the
+ *          connectivity chip CPU.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "app_util.h"
+#include "ble.h"
+#include "ble_serialization.h"
+#include "ser_config.h"
+#include "ser_bench.h"
+
+/* Encoder of the connectivity side and decoder of the application side, see ble_conn.h and
+ * ble_app.h. The headers are not included together as they declare the same codec names. */
+uint32_t ble_event_enc(ble_evt_t const * const p_event,
+                       uint32_t                event_len,
+                       uint8_t * const         p_buf,
+                       uint32_t * const        p_buf_len);
+
+uint32_t ble_event_dec(uint8_t const * const p_buf,
+                       uint32_t              packet_len,
+                       ble_evt_t * const     p_event,
+                       uint32_t * const      p_event_len);
+
+#define NS_PER_S            1000000000.0
+
+#define SLIP_END            0xC0    /**< SLIP frame delimiter. */
+#define SLIP_ESC            0xDB    /**< SLIP escape character. */
+#define HCI_PKT_HDR_SIZE    4       /**< HCI packet header size, see ser_phy_hci.c. */
+#define HCI_PKT_CRC_SIZE    2       /**< HCI packet CRC size, see ser_phy_hci.c. */
+
+#define GEN_TICK_MS         10      /**< Generator tick, as SER_CONN_BENCH_TICK_MS. */
+#define GEN_BACKLOG_MAX     64      /**< Generator backlog, as SER_CONN_BENCH_EVT_BACKLOG_MAX. */
+
+/** Size of a BLE event buffer, as BLE_STACK_EVT_MSG_BUF_SIZE. */
+#define EVT_BUF_SIZE        (sizeof (ble_evt_t) + GATT_MTU_SIZE_DEFAULT)
+
+#define FRAME_QUEUE_SIZE    64      /**< Frames queued on one link. */
+#define RX_QUEUE_SIZE       8       /**< Commands received and waiting for the connectivity CPU. */
+#define MAX_SAMPLES         (1u << 20)
+#define CALIBRATION_LOOPS   20000
+
+/**@brief Transport (link) model. */
+typedef struct
+{
+    char const * p_name;
+    uint32_t     bit_rate;          /**< Bits per second on the wire. */
+    uint32_t     bits_per_byte;     /**< Wire bits per byte, including start, parity and stop bits. */
+    uint32_t     pkt_overhead;      /**< Bytes added to a packet by the PHY layer (length header). */
+    uint32_t     mtu;               /**< Maximum bytes per bus transaction, 0 if not limited. */
+    uint32_t     xfer_setup_ns;     /**< Bus time between transactions (request/ready handshake). */
+    bool         shared_bus;        /**< Both directions share one bus (SPI master/slave). */
+    bool         hci;               /**< Packets are SLIP framed, CRC protected and acknowledged. */
+    uint32_t     cpu_byte_ns;       /**< Connectivity CPU time per wire byte (interrupt per byte). */
+    uint32_t     cpu_xfer_ns;       /**< Connectivity CPU time per bus transaction. */
+} transport_t;
+
+/** Link models. Bit rates are the ser_config.h defaults (UART 1 Mbaud with parity, SPI 1 MHz,
+ *  MTU 255). CPU costs are estimates for a 16 MHz Cortex-M0: the UART drivers take an interrupt per
+ *  byte (HCI adds SLIP decoding and CRC), the SPI slave uses EasyDMA and takes an interrupt per
+ *  transaction, SPI-5W adds a GPIOTE interrupt for the extra handshake line. */
+static transport_t const m_transports[] =
+{
+    {"UART",   1000000, 11, SER_PHY_HEADER_SIZE, 0,                    0, false, false, 4000,     0},
+    {"SPI",    1000000,  8, SER_PHY_HEADER_SIZE, SER_PHY_SPI_MTU_SIZE, 40000, true,  false,   0, 15000},
+    {"SPI-5W", 1000000,  8, SER_PHY_HEADER_SIZE, SER_PHY_SPI_MTU_SIZE, 12000, true,  false,   0, 22000},
+    {"HCI",    1000000, 11, 0,                   0,                    0, false, true,  6000,     0},
+};
+
+/**@brief Frame kinds. */
+typedef enum
+{
+    FRAME_CMD,  /**< Benchmark ECHO command, application to connectivity. */
+    FRAME_RSP,  /**< Benchmark ECHO response, connectivity to application. */
+    FRAME_EVT,  /**< Synthetic event, connectivity to application. */
+    FRAME_ACK   /**< HCI acknowledgement. */
+} frame_kind_t;
+
+/**@brief Direction of a frame. */
+typedef enum
+{
+    DIR_A2C = 0,    /**< Application chip to connectivity chip. */
+    DIR_C2A,        /**< Connectivity chip to application chip. */
+    DIR_COUNT
+} dir_t;
+
+/**@brief Frame queued on a link. */
+typedef struct
+{
+    frame_kind_t kind;
+    dir_t        dir;
+    uint32_t     wire_len;          /**< Bytes on the wire. */
+    double       t_origin;          /**< Command submission or event due time. */
+} frame_t;
+
+/**@brief Link, one per direction or one shared by both directions. */
+typedef struct
+{
+    frame_t  queue[FRAME_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t count;
+    bool     busy;
+    frame_t  current;
+    double   t_done;                /**< End of the current frame. */
+    bool     await_ack[DIR_COUNT];  /**< HCI: data frame in given direction waits for an ACK. */
+} link_t;
+
+/**@brief Benchmark parameters. */
+typedef struct
+{
+    double   duration_s;
+    uint32_t window;
+    uint32_t cmd_len;
+    uint32_t evt_rate;
+    uint32_t evt_len;
+    uint32_t tx_slots;
+    double   cpu_scale;
+    uint32_t cpu_pkt_ns;
+} params_t;
+
+/**@brief Costs and wire lengths derived from the real codecs. */
+typedef struct
+{
+    uint32_t cmd_len;               /**< Benchmark Command packet length. */
+    uint32_t rsp_len;               /**< Benchmark Response packet length. */
+    uint32_t evt_len;               /**< Event packet length. */
+    uint32_t cmd_escapes;           /**< SLIP escapes in a command packet. */
+    uint32_t rsp_escapes;
+    uint32_t evt_escapes;
+    double   rsp_enc_ns;            /**< Host time to build a response. */
+    double   evt_enc_ns;            /**< Host time to encode an event. */
+    double   evt_dec_ns;            /**< Host time to decode an event on the application side. */
+} codec_t;
+
+/**@brief Results of one run. */
+typedef struct
+{
+    uint32_t cmds;
+    uint32_t evts;
+    uint32_t evts_dropped;
+    double   cmd_lat[2];            /**< p50, p99 in microseconds. */
+    double   evt_lat[2];
+    double   idle_pct;
+} result_t;
+
+/* Simulation state. */
+static transport_t const * m_p_tr;
+static params_t            m_params;
+static codec_t             m_codec;
+static double              m_now;
+static link_t              m_links[DIR_COUNT];
+
+static uint32_t m_app_outstanding;
+static uint32_t m_tx_free;
+static double   m_tx_wait_start;    /**< Connectivity CPU spinning for a TX buffer since. */
+static bool     m_tx_waiting;
+
+static double   m_rx_queue[RX_QUEUE_SIZE];
+static uint32_t m_rx_head;
+static uint32_t m_rx_count;
+
+static bool     m_cpu_busy;
+static double   m_cpu_done;
+static frame_t  m_cpu_frame;        /**< Frame produced by the running CPU task. */
+static double   m_cpu_busy_ns;
+
+static double   m_gen_next;
+static uint32_t m_gen_acc;
+static uint32_t m_gen_due;
+static double   m_gen_due_time[GEN_BACKLOG_MAX];
+static uint32_t m_gen_head;
+
+static result_t m_result;
+static double * m_p_cmd_samples;
+static uint32_t m_cmd_samples;
+static double * m_p_evt_samples;
+static uint32_t m_evt_samples;
+
+
+static double time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * NS_PER_S + (double)ts.tv_nsec;
+}
+
+
+static uint32_t slip_escapes(uint8_t const * p_buf, uint32_t len)
+{
+    uint32_t escapes = 0;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((p_buf[i] == SLIP_END) || (p_buf[i] == SLIP_ESC))
+        {
+            escapes++;
+        }
+    }
+
+    return escapes;
+}
+
+
+/**@brief Function for building the packets with the real codecs and timing the codecs. */
+static int codec_calibrate(codec_t * p_codec, params_t const * p_params)
+{
+    static uint32_t evt_buf[CEIL_DIV(EVT_BUF_SIZE, sizeof (uint32_t))];
+    static uint32_t dec_buf[CEIL_DIV(EVT_BUF_SIZE, sizeof (uint32_t))];
+    static uint8_t  cmd[SER_HAL_TRANSPORT_APP_TO_CONN_MAX_PKT_SIZE];
+    static uint8_t  rsp[SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE];
+    static uint8_t  evt[SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE];
+
+    ble_evt_t * p_evt     = (ble_evt_t *)evt_buf;
+    ble_evt_t * p_dec     = (ble_evt_t *)dec_buf;
+    uint32_t    hdr_len   = offsetof(ble_evt_t, evt.gatts_evt.params.write.data);
+    uint32_t    len;
+    uint32_t    index;
+    uint32_t    i;
+    double      t_start;
+
+    if ((SER_PKT_TYPE_SIZE + SER_OP_CODE_SIZE + p_params->cmd_len > sizeof (cmd)) ||
+        (SER_PKT_TYPE_SIZE + SER_CMD_RSP_HEADER_SIZE + p_params->cmd_len > sizeof (rsp)) ||
+        (hdr_len + p_params->evt_len > sizeof (evt_buf)))
+    {
+        fprintf(stderr, "Command or event data too long.\n");
+        return -1;
+    }
+
+    /* Benchmark ECHO command. */
+    cmd[SER_PKT_TYPE_POS]    = SER_PKT_TYPE_BENCH_CMD;
+    cmd[SER_PKT_OP_CODE_POS] = SER_BENCH_OP_ECHO;
+    for (i = 0; i < p_params->cmd_len; i++)
+    {
+        cmd[SER_PKT_DATA_POS + i] = (uint8_t)i;
+    }
+    p_codec->cmd_len     = SER_PKT_TYPE_SIZE + SER_OP_CODE_SIZE + p_params->cmd_len;
+    p_codec->cmd_escapes = slip_escapes(cmd, p_codec->cmd_len);
+
+    /* Benchmark response, built as in ser_conn_bench.c. */
+    t_start = time_ns();
+    for (i = 0; i < CALIBRATION_LOOPS; i++)
+    {
+        len   = sizeof (rsp) - SER_PKT_TYPE_SIZE;
+        index = 0;
+        rsp[SER_PKT_TYPE_POS] = SER_PKT_TYPE_BENCH_RESP;
+        (void)op_status_enc(SER_BENCH_OP_ECHO, NRF_SUCCESS, &rsp[SER_PKT_OP_CODE_POS], &len, &index);
+        memcpy(&rsp[SER_PKT_OP_CODE_POS + index], &cmd[SER_PKT_DATA_POS], p_params->cmd_len);
+        len += p_params->cmd_len;
+    }
+    p_codec->rsp_enc_ns  = (time_ns() - t_start) / CALIBRATION_LOOPS;
+    p_codec->rsp_len     = SER_PKT_TYPE_SIZE + len;
+    p_codec->rsp_escapes = slip_escapes(rsp, p_codec->rsp_len);
+
+    /* Synthetic event, built as in ser_conn_bench.c. */
+    memset(p_evt, 0, hdr_len);
+    p_evt->header.evt_id                     = BLE_GATTS_EVT_WRITE;
+    p_evt->header.evt_len                    = (uint16_t)(hdr_len - sizeof (ble_evt_hdr_t) +
+                                                          p_params->evt_len);
+    p_evt->evt.gatts_evt.params.write.handle = SER_BENCH_EVT_ATTR_HANDLE;
+    p_evt->evt.gatts_evt.params.write.op     = BLE_GATTS_OP_WRITE_CMD;
+    p_evt->evt.gatts_evt.params.write.len    = (uint16_t)p_params->evt_len;
+    for (i = 0; i < p_params->evt_len; i++)
+    {
+        p_evt->evt.gatts_evt.params.write.data[i] = (uint8_t)i;
+    }
+
+    t_start = time_ns();
+    for (i = 0; i < CALIBRATION_LOOPS; i++)
+    {
+        len = sizeof (evt) - SER_PKT_TYPE_SIZE;
+        evt[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT;
+        if (ble_event_enc(p_evt, 0, &evt[SER_PKT_OP_CODE_POS], &len) != NRF_SUCCESS)
+        {
+            fprintf(stderr, "Event encoding failed.\n");
+            return -1;
+        }
+    }
+    p_codec->evt_enc_ns  = (time_ns() - t_start) / CALIBRATION_LOOPS;
+    p_codec->evt_len     = SER_PKT_TYPE_SIZE + len;
+    p_codec->evt_escapes = slip_escapes(evt, p_codec->evt_len);
+
+    /* The application side decodes the event back, which also checks the encoding. */
+    t_start = time_ns();
+    for (i = 0; i < CALIBRATION_LOOPS; i++)
+    {
+        uint32_t dec_len = sizeof (dec_buf);
+
+        if (ble_event_dec(&evt[SER_PKT_OP_CODE_POS], p_codec->evt_len - SER_PKT_TYPE_SIZE,
+                          p_dec, &dec_len) != NRF_SUCCESS)
+        {
+            fprintf(stderr, "Event decoding failed.\n");
+            return -1;
+        }
+    }
+    p_codec->evt_dec_ns = (time_ns() - t_start) / CALIBRATION_LOOPS;
+
+    if ((p_dec->header.evt_id != BLE_GATTS_EVT_WRITE) ||
+        (p_dec->evt.gatts_evt.params.write.handle != SER_BENCH_EVT_ATTR_HANDLE) ||
+        (p_dec->evt.gatts_evt.params.write.len != p_params->evt_len) ||
+        (memcmp(p_dec->evt.gatts_evt.params.write.data,
+                p_evt->evt.gatts_evt.params.write.data, p_params->evt_len) != 0))
+    {
+        fprintf(stderr, "Decoded event does not match.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static link_t * link_get(dir_t dir)
+{
+    return m_p_tr->shared_bus ? &m_links[0] : &m_links[dir];
+}
+
+
+static uint32_t wire_len(uint32_t pkt_len, uint32_t escapes)
+{
+    if (m_p_tr->hci)
+    {
+        /* Header and CRC are assumed not to need escaping. */
+        return 2 + HCI_PKT_HDR_SIZE + pkt_len + escapes + HCI_PKT_CRC_SIZE;
+    }
+
+    return m_p_tr->pkt_overhead + pkt_len;
+}
+
+
+static void sample_add(double * p_samples, uint32_t * p_count, double value)
+{
+    if (*p_count < MAX_SAMPLES)
+    {
+        p_samples[(*p_count)++] = value;
+    }
+}
+
+
+static void frame_enqueue(frame_kind_t kind, dir_t dir, double t_origin)
+{
+    link_t * p_link = link_get(dir);
+    uint32_t index;
+    frame_t  frame;
+
+    frame.kind     = kind;
+    frame.dir      = dir;
+    frame.t_origin = t_origin;
+
+    switch (kind)
+    {
+        case FRAME_CMD:
+            frame.wire_len = wire_len(m_codec.cmd_len, m_codec.cmd_escapes);
+            break;
+        case FRAME_RSP:
+            frame.wire_len = wire_len(m_codec.rsp_len, m_codec.rsp_escapes);
+            break;
+        case FRAME_EVT:
+            frame.wire_len = wire_len(m_codec.evt_len, m_codec.evt_escapes);
+            break;
+        default:
+            frame.wire_len = 2 + HCI_PKT_HDR_SIZE;
+            break;
+    }
+
+    if (p_link->count == FRAME_QUEUE_SIZE)
+    {
+        fprintf(stderr, "Link queue overflow.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (kind == FRAME_ACK)
+    {
+        /* Acknowledgements are sent before queued data. */
+        p_link->head = (p_link->head + FRAME_QUEUE_SIZE - 1) % FRAME_QUEUE_SIZE;
+        index        = p_link->head;
+    }
+    else
+    {
+        index = (p_link->head + p_link->count) % FRAME_QUEUE_SIZE;
+    }
+
+    p_link->queue[index] = frame;
+    p_link->count++;
+}
+
+
+/**@brief Function for starting the next frame on a link, if the link and the frame can go. */
+static void link_kick(link_t * p_link)
+{
+    uint32_t i;
+
+    if (p_link->busy)
+    {
+        return;
+    }
+
+    for (i = 0; i < p_link->count; i++)
+    {
+        uint32_t  index   = (p_link->head + i) % FRAME_QUEUE_SIZE;
+        frame_t * p_frame = &p_link->queue[index];
+        uint32_t  xfers   = 1;
+        double    t_wire;
+
+        /* HCI with window size 1: a data frame waits until the previous one is acknowledged. */
+        if ((p_frame->kind != FRAME_ACK) && p_link->await_ack[p_frame->dir])
+        {
+            continue;
+        }
+
+        if (m_p_tr->mtu != 0)
+        {
+            xfers = CEIL_DIV(p_frame->wire_len, m_p_tr->mtu);
+            if (p_frame->dir == DIR_C2A)
+            {
+                /* The master reads the packet length first. */
+                xfers++;
+            }
+        }
+
+        t_wire = (double)p_frame->wire_len * m_p_tr->bits_per_byte * NS_PER_S / m_p_tr->bit_rate +
+                 (double)xfers * m_p_tr->xfer_setup_ns;
+
+        /* Driver load on the connectivity chip, taken in interrupts. */
+        m_cpu_busy_ns += (double)p_frame->wire_len * m_p_tr->cpu_byte_ns +
+                         (double)xfers * m_p_tr->cpu_xfer_ns;
+
+        p_link->current = *p_frame;
+        p_link->busy    = true;
+        p_link->t_done  = m_now + t_wire;
+
+        /* Remove the frame from the queue, keeping the order of the others. */
+        for (; i > 0; i--)
+        {
+            uint32_t to   = (p_link->head + i) % FRAME_QUEUE_SIZE;
+            uint32_t from = (p_link->head + i - 1) % FRAME_QUEUE_SIZE;
+
+            p_link->queue[to] = p_link->queue[from];
+        }
+        p_link->head = (p_link->head + 1) % FRAME_QUEUE_SIZE;
+        p_link->count--;
+        return;
+    }
+}
+
+
+static void app_submit(void)
+{
+    while (m_app_outstanding < m_params.window)
+    {
+        m_app_outstanding++;
+        frame_enqueue(FRAME_CMD, DIR_A2C, m_now);
+    }
+}
+
+
+static void tx_buf_release(void)
+{
+    m_tx_free++;
+
+    if (m_tx_waiting)
+    {
+        m_cpu_busy_ns += m_now - m_tx_wait_start;
+        m_tx_waiting   = false;
+    }
+}
+
+
+/**@brief Function for handling the end of a frame on a link. */
+static void link_done(link_t * p_link)
+{
+    frame_t frame = p_link->current;
+
+    p_link->busy = false;
+
+    if (frame.kind == FRAME_ACK)
+    {
+        dir_t acked = (frame.dir == DIR_A2C) ? DIR_C2A : DIR_A2C;
+
+        link_get(acked)->await_ack[acked] = false;
+        if (acked == DIR_C2A)
+        {
+            tx_buf_release();
+        }
+        return;
+    }
+
+    if (m_p_tr->hci)
+    {
+        p_link->await_ack[frame.dir] = true;
+        frame_enqueue(FRAME_ACK, (frame.dir == DIR_A2C) ? DIR_C2A : DIR_A2C, m_now);
+    }
+    else if (frame.dir == DIR_C2A)
+    {
+        tx_buf_release();
+    }
+
+    switch (frame.kind)
+    {
+        case FRAME_CMD:
+            m_rx_queue[(m_rx_head + m_rx_count) % RX_QUEUE_SIZE] = frame.t_origin;
+            m_rx_count++;
+            break;
+
+        case FRAME_RSP:
+            m_result.cmds++;
+            m_app_outstanding--;
+            sample_add(m_p_cmd_samples, &m_cmd_samples, (m_now - frame.t_origin) / 1000.0);
+            app_submit();
+            break;
+
+        case FRAME_EVT:
+            m_result.evts++;
+            sample_add(m_p_evt_samples, &m_evt_samples,
+                       (m_now + m_codec.evt_dec_ns - frame.t_origin) / 1000.0);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**@brief Function for making events due, as the generator tick in ser_conn_bench.c. */
+static void gen_tick(void)
+{
+    uint32_t due;
+
+    m_gen_acc += m_params.evt_rate * GEN_TICK_MS;
+    due        = m_gen_acc / 1000;
+    m_gen_acc -= due * 1000;
+
+    while (due-- > 0)
+    {
+        if (m_gen_due == GEN_BACKLOG_MAX)
+        {
+            m_result.evts_dropped++;
+            continue;
+        }
+        m_gen_due_time[(m_gen_head + m_gen_due) % GEN_BACKLOG_MAX] = m_now;
+        m_gen_due++;
+    }
+
+    m_gen_next += GEN_TICK_MS * 1000000.0;
+}
+
+
+/**@brief Function for starting the next main loop task on the connectivity CPU. */
+static void cpu_schedule(void)
+{
+    /* A response buffer is reserved in the zero-copy event path. With the scheduler event path
+     * the only TX buffer is shared and the scheduler is paused until an event is sent. */
+    uint32_t evt_tx_reserve = (m_params.tx_slots > 0) ? 1 : 0;
+    double   cost;
+
+    if (m_cpu_busy || m_tx_waiting)
+    {
+        return;
+    }
+
+    if (m_rx_count > 0)
+    {
+        if (m_tx_free == 0)
+        {
+            /* ser_conn_bench_command_process() loops until a TX buffer is free. */
+            m_tx_waiting    = true;
+            m_tx_wait_start = m_now;
+            return;
+        }
+
+        cost                 = m_codec.rsp_enc_ns * m_params.cpu_scale + m_params.cpu_pkt_ns;
+        m_cpu_frame.kind     = FRAME_RSP;
+        m_cpu_frame.t_origin = m_rx_queue[m_rx_head];
+        m_rx_head            = (m_rx_head + 1) % RX_QUEUE_SIZE;
+        m_rx_count--;
+    }
+    else if ((m_gen_due > 0) && (m_tx_free > evt_tx_reserve))
+    {
+        cost                 = m_codec.evt_enc_ns * m_params.cpu_scale + m_params.cpu_pkt_ns;
+        m_cpu_frame.kind     = FRAME_EVT;
+        m_cpu_frame.t_origin = m_gen_due_time[m_gen_head];
+        m_gen_head           = (m_gen_head + 1) % GEN_BACKLOG_MAX;
+        m_gen_due--;
+    }
+    else
+    {
+        return;
+    }
+
+    m_tx_free--;
+    m_cpu_busy     = true;
+    m_cpu_done     = m_now + cost;
+    m_cpu_busy_ns += cost;
+}
+
+
+static int sample_cmp(void const * p_a, void const * p_b)
+{
+    double a = *(double const *)p_a;
+    double b = *(double const *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+
+static void percentiles(double * p_samples, uint32_t count, double * p_out)
+{
+    if (count == 0)
+    {
+        p_out[0] = 0;
+        p_out[1] = 0;
+        return;
+    }
+
+    qsort(p_samples, count, sizeof (double), sample_cmp);
+    p_out[0] = p_samples[(count - 1) * 50 / 100];
+    p_out[1] = p_samples[(count - 1) * 99 / 100];
+}
+
+
+/**@brief Function for running the simulation for one transport. */
+static void run(transport_t const * p_tr)
+{
+    double t_end = m_params.duration_s * NS_PER_S;
+
+    m_p_tr = p_tr;
+    memset(m_links, 0, sizeof (m_links));
+    memset(&m_result, 0, sizeof (m_result));
+    m_now             = 0;
+    m_app_outstanding = 0;
+    m_tx_free         = m_params.tx_slots + 1;
+    m_tx_waiting      = false;
+    m_rx_head         = 0;
+    m_rx_count        = 0;
+    m_cpu_busy        = false;
+    m_cpu_busy_ns     = 0;
+    m_gen_next        = (m_params.evt_rate > 0) ? 0 : t_end;
+    m_gen_acc         = 0;
+    m_gen_due         = 0;
+    m_gen_head        = 0;
+    m_cmd_samples     = 0;
+    m_evt_samples     = 0;
+
+    app_submit();
+
+    while (m_now < t_end)
+    {
+        double   t_next = m_gen_next;
+        uint32_t i;
+
+        for (i = 0; i < DIR_COUNT; i++)
+        {
+            link_kick(&m_links[i]);
+        }
+        cpu_schedule();
+
+        for (i = 0; i < DIR_COUNT; i++)
+        {
+            if (m_links[i].busy && (m_links[i].t_done < t_next))
+            {
+                t_next = m_links[i].t_done;
+            }
+        }
+        if (m_cpu_busy && (m_cpu_done < t_next))
+        {
+            t_next = m_cpu_done;
+        }
+
+        m_now = t_next;
+
+        if (m_cpu_busy && (m_cpu_done <= m_now))
+        {
+            m_cpu_busy = false;
+            frame_enqueue(m_cpu_frame.kind, DIR_C2A, m_cpu_frame.t_origin);
+        }
+        for (i = 0; i < DIR_COUNT; i++)
+        {
+            if (m_links[i].busy && (m_links[i].t_done <= m_now))
+            {
+                link_done(&m_links[i]);
+            }
+        }
+        if ((m_params.evt_rate > 0) && (m_gen_next <= m_now))
+        {
+            gen_tick();
+        }
+    }
+
+    if (m_tx_waiting)
+    {
+        m_cpu_busy_ns += m_now - m_tx_wait_start;
+    }
+
+    percentiles(m_p_cmd_samples, m_cmd_samples, m_result.cmd_lat);
+    percentiles(m_p_evt_samples, m_evt_samples, m_result.evt_lat);
+    m_result.idle_pct = 100.0 * (1.0 - MIN(m_cpu_busy_ns, m_now) / m_now);
+}
+
+
+static void usage(char const * p_prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -T name   run only the given transport (UART, SPI, SPI-5W, HCI)\n"
+            "  -t sec    simulated time per transport (default 2)\n"
+            "  -w n      commands outstanding, SER_PIPELINE_WINDOW_SIZE (default %u)\n"
+            "  -l bytes  ECHO command data length (default 20)\n"
+            "  -r rate   synthetic events per second, 0 for none (default 200)\n"
+            "  -e bytes  synthetic event data length (default 20)\n"
+            "  -s n      SER_CONN_EVT_TX_SLOT_COUNT (default %u)\n"
+            "  -c ratio  connectivity chip / host codec execution time (default 40)\n"
+            "  -p ns     connectivity chip main loop cost per packet (default 30000)\n",
+            p_prog, SER_PIPELINE_WINDOW_SIZE, SER_CONN_EVT_TX_SLOT_COUNT);
+}
+
+
+int main(int argc, char * argv[])
+{
+    char const * p_only = NULL;
+    uint32_t     i;
+    int          opt;
+
+    m_params.duration_s = 2.0;
+    m_params.window     = SER_PIPELINE_WINDOW_SIZE;
+    m_params.cmd_len    = 20;
+    m_params.evt_rate   = 200;
+    m_params.evt_len    = 20;
+    m_params.tx_slots   = SER_CONN_EVT_TX_SLOT_COUNT;
+    m_params.cpu_scale  = 40.0;
+    m_params.cpu_pkt_ns = 30000;
+
+    while ((opt = getopt(argc, argv, "T:t:w:l:r:e:s:c:p:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'T': p_only              = optarg;                       break;
+            case 't': m_params.duration_s = atof(optarg);                 break;
+            case 'w': m_params.window     = (uint32_t)atoi(optarg);       break;
+            case 'l': m_params.cmd_len    = (uint32_t)atoi(optarg);       break;
+            case 'r': m_params.evt_rate   = (uint32_t)atoi(optarg);       break;
+            case 'e': m_params.evt_len    = (uint32_t)atoi(optarg);       break;
+            case 's': m_params.tx_slots   = (uint32_t)atoi(optarg);       break;
+            case 'c': m_params.cpu_scale  = atof(optarg);                 break;
+            case 'p': m_params.cpu_pkt_ns = (uint32_t)atoi(optarg);       break;
+            default:  usage(argv[0]);                                     return EXIT_FAILURE;
+        }
+    }
+
+    if ((m_params.window == 0) || (m_params.window > RX_QUEUE_SIZE) ||
+        (m_params.duration_s <= 0) || (m_params.tx_slots + 1 > FRAME_QUEUE_SIZE / 4))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (codec_calibrate(&m_codec, &m_params) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    m_p_cmd_samples = malloc(MAX_SAMPLES * sizeof (double));
+    m_p_evt_samples = malloc(MAX_SAMPLES * sizeof (double));
+    if ((m_p_cmd_samples == NULL) || (m_p_evt_samples == NULL))
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("cmd %u B, rsp %u B, evt %u B; host ns: rsp enc %.0f, evt enc %.0f, evt dec %.0f\n",
+           m_codec.cmd_len, m_codec.rsp_len, m_codec.evt_len,
+           m_codec.rsp_enc_ns, m_codec.evt_enc_ns, m_codec.evt_dec_ns);
+    printf("window %u, events %u/s, TX slots %u, CPU scale %.0f, %.1f s per transport\n\n",
+           m_params.window, m_params.evt_rate, m_params.tx_slots, m_params.cpu_scale,
+           m_params.duration_s);
+    printf("%-8s %10s %10s %8s %9s %9s %9s %9s %7s\n", "", "cmd/s", "evt/s", "dropped",
+           "cmd p50", "cmd p99", "evt p50", "evt p99", "idle");
+    printf("%-8s %10s %10s %8s %9s %9s %9s %9s %7s\n", "", "", "", "", "us", "us", "us", "us", "%");
+
+    for (i = 0; i < sizeof (m_transports) / sizeof (m_transports[0]); i++)
+    {
+        if ((p_only != NULL) && (strcmp(p_only, m_transports[i].p_name) != 0))
+        {
+            continue;
+        }
+
+        run(&m_transports[i]);
+
+        printf("%-8s %10.0f %10.0f %8u %9.0f %9.0f %9.0f %9.0f %7.1f\n",
+               m_transports[i].p_name,
+               m_result.cmds / m_params.duration_s,
+               m_result.evts / m_params.duration_s,
+               m_result.evts_dropped,
+               m_result.cmd_lat[0], m_result.cmd_lat[1],
+               m_result.evt_lat[0], m_result.evt_lat[1],
+               m_result.idle_pct);
+    }
+
+    free(m_p_cmd_samples);
+    free(m_p_evt_samples);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,827 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief   Per-opcode round trip benchmark of the serialization codecs.
+ *
+ * @details Every SoftDevice command of the connectivity middleware is called through the
+ *          application middleware (app_mw_*.c). The transport is replaced by a loopback which
+ *          passes the command packet directly to @ref conn_mw_handler and the response packet
+ *          back to the response decoder of the application middleware. The SoftDevice functions
+ *          called by the connectivity middleware are the stubs in ser_codec_bench_sd.c.
+ *
+ *          One round trip is: command encoding, command decoding, SoftDevice stub, response
+ *          encoding and response decoding. Reported per opcode: the time of one round trip, the
+ *          time spent in @ref conn_mw_handler (opcode dispatch, command decoding, SoftDevice stub
+ *          and response encoding) and the size of the command and response packets, including the
+ *          packet type byte. The cost of reading the clock is measured once and subtracted from
+ *          the connectivity time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ble.h"
+#include "ble_gap.h"
+#include "ble_gattc.h"
+#include "ble_gatts.h"
+#include "ble_l2cap.h"
+#include "nrf_soc.h"
+#include "ble_serialization.h"
+#include "ser_config.h"
+#include "ser_sd_transport.h"
+#include "ble_hci.h"
+
+/* Connectivity middleware entry point, see conn_mw.h. */
+uint32_t conn_mw_handler(uint8_t const * const p_rx_buf,
+                         uint32_t              rx_buf_len,
+                         uint8_t * const       p_tx_buf,
+                         uint32_t * const      p_tx_buf_len);
+
+/* Security and user memory contexts of both sides, see app_ble_gap_sec_keys.h, app_ble_user_mem.h,
+ * conn_ble_gap_sec_keys.h and conn_ble_user_mem.h. They are released by events which the benchmark
+ * does not send. The headers are not included, as they define SER_MAX_CONNECTIONS differently from
+ * ser_config.h. */
+uint32_t app_ble_gap_sec_context_destroy(uint16_t conn_handle);
+uint32_t app_ble_user_mem_context_destroy(uint16_t conn_handle);
+uint32_t conn_ble_gap_sec_context_destroy(uint16_t conn_handle);
+uint32_t conn_ble_user_mem_context_destroy(uint16_t conn_handle);
+
+#define NS_PER_S            1000000000.0
+#define DEFAULT_LOOPS       20000   /**< Default number of round trips per opcode. */
+
+#define CONN_HANDLE         0       /**< Connection handle used in the commands. */
+#define CHAR_HANDLE         0x0010  /**< Attribute handle used in the commands. */
+#define UUID_HRS            0x180D  /**< Heart Rate service UUID. */
+#define UUID_HRM            0x2A37  /**< Heart Rate Measurement characteristic UUID. */
+
+/**@brief Benchmarked command. */
+typedef struct
+{
+    char const * p_name;        /**< Name of the SoftDevice function. */
+    uint32_t  (* call)(void);   /**< Function calling the SoftDevice function once. */
+} cmd_t;
+
+static uint8_t  m_cmd_buf[SER_HAL_TRANSPORT_APP_TO_CONN_MAX_PKT_SIZE];  /**< Command packet. */
+static uint8_t  m_rsp_buf[SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE];  /**< Response packet. */
+static uint32_t m_cmd_len;                                              /**< Length of the last command packet. */
+static uint32_t m_rsp_len;                                              /**< Length of the last response packet. */
+static double   m_conn_s;                                               /**< Time spent in conn_mw_handler. */
+
+static uint8_t  m_data[GATT_MTU_SIZE_DEFAULT] = "0123456789abcdefghij";  /**< Payload used in the commands. */
+static uint8_t  m_user_mem[64];                                         /**< User memory block. */
+
+static ble_gap_addr_t          m_addr        = {.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC,
+                                                .addr      = {0x11, 0x22, 0x33, 0x44, 0x55, 0xC6}};
+static ble_gap_conn_params_t   m_conn_params = {.min_conn_interval = 8,
+                                                .max_conn_interval = 16,
+                                                .slave_latency     = 0,
+                                                .conn_sup_timeout  = 400};
+static ble_gap_scan_params_t   m_scan_params = {.active   = 1,
+                                                .interval = 0x00A0,
+                                                .window   = 0x0050,
+                                                .timeout  = 0};
+static ble_gattc_handle_range_t m_range      = {.start_handle = 0x0001, .end_handle = 0xFFFF};
+static ble_uuid_t               m_uuid       = {.uuid = UUID_HRS,
+                                                .type = BLE_UUID_TYPE_BLE};
+static ble_gap_enc_info_t       m_enc_info;
+static ble_gap_master_id_t      m_master_id;
+static ble_gap_irk_t            m_irk;
+static ble_gap_sign_info_t      m_sign_info;
+static ble_gap_lesc_p256_pk_t   m_pk;
+static ble_gap_lesc_dhkey_t     m_dhkey;
+static ble_gap_lesc_oob_data_t  m_oobd;
+static ble_gap_enc_key_t        m_enc_key_own;
+static ble_gap_enc_key_t        m_enc_key_peer;
+static ble_gap_id_key_t         m_id_key_peer;
+
+static double time_get(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / NS_PER_S;
+}
+
+/* Stubs of the application side platform functions used by the application middleware. */
+void app_error_handler_bare(uint32_t error_code)
+{
+    printf("error 0x%08x\n", (unsigned int)error_code);
+    exit(EXIT_FAILURE);
+}
+
+void ser_app_power_system_off_set(void)
+{
+}
+
+uint32_t ser_sd_transport_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
+{
+    *pp_data = m_cmd_buf;
+    *p_len   = sizeof(m_cmd_buf);
+    return NRF_SUCCESS;
+}
+
+uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
+                                    uint16_t                       length,
+                                    ser_sd_transport_rsp_handler_t cmd_resp_decode_callback)
+{
+    uint32_t rsp_len = sizeof(m_rsp_buf) - SER_PKT_TYPE_SIZE;
+    uint32_t err_code;
+    double   start;
+
+    start    = time_get();
+    err_code = conn_mw_handler(&p_buffer[SER_PKT_TYPE_SIZE],
+                               length - SER_PKT_TYPE_SIZE,
+                               &m_rsp_buf[SER_PKT_TYPE_SIZE],
+                               &rsp_len);
+    m_conn_s += time_get() - start;
+    if (err_code != NRF_SUCCESS)
+    {
+        printf("conn_mw_handler failed for opcode 0x%02x: 0x%08x\n",
+               p_buffer[SER_PKT_TYPE_SIZE], (unsigned int)err_code);
+        exit(EXIT_FAILURE);
+    }
+
+    m_rsp_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_RESP;
+    m_cmd_len                   = length;
+    m_rsp_len                   = rsp_len + SER_PKT_TYPE_SIZE;
+
+    // sd_power_system_off does not return on the connectivity chip, so no response is sent.
+    if (cmd_resp_decode_callback == NULL)
+    {
+        m_rsp_len = 0;
+        return NRF_SUCCESS;
+    }
+    return cmd_resp_decode_callback(&m_rsp_buf[SER_PKT_TYPE_SIZE], rsp_len);
+}
+
+/* BLE commands. */
+static uint32_t tx_packet_count_get(void)
+{
+    uint8_t count;
+    return sd_ble_tx_packet_count_get(CONN_HANDLE, &count);
+}
+
+static uint32_t uuid_vs_add(void)
+{
+    ble_uuid128_t vs_uuid = {{0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0,
+                              0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E}};
+    uint8_t       type;
+    return sd_ble_uuid_vs_add(&vs_uuid, &type);
+}
+
+static uint32_t uuid_decode(void)
+{
+    uint8_t    uuid_le[2] = {0x0D, 0x18};
+    ble_uuid_t uuid;
+    return sd_ble_uuid_decode(sizeof(uuid_le), uuid_le, &uuid);
+}
+
+static uint32_t uuid_encode(void)
+{
+    uint8_t uuid_le[16];
+    uint8_t uuid_le_len;
+    return sd_ble_uuid_encode(&m_uuid, &uuid_le_len, uuid_le);
+}
+
+static uint32_t version_get(void)
+{
+    ble_version_t version;
+    return sd_ble_version_get(&version);
+}
+
+static uint32_t opt_get(void)
+{
+    ble_opt_t opt;
+    return sd_ble_opt_get(BLE_GAP_OPT_SCAN_REQ_REPORT, &opt);
+}
+
+static uint32_t opt_set(void)
+{
+    ble_opt_t opt;
+
+    memset(&opt, 0, sizeof(opt));
+    opt.gap_opt.scan_req_report.enable = 1;
+    return sd_ble_opt_set(BLE_GAP_OPT_SCAN_REQ_REPORT, &opt);
+}
+
+static uint32_t enable(void)
+{
+    ble_enable_params_t params;
+    uint32_t            app_ram_base = 0x20001870;
+
+    memset(&params, 0, sizeof(params));
+    params.gap_enable_params.periph_conn_count  = 1;
+    params.gap_enable_params.central_conn_count = 1;
+    params.gatts_enable_params.attr_tab_size    = BLE_GATTS_ATTR_TAB_SIZE_DEFAULT;
+    return sd_ble_enable(&params, &app_ram_base);
+}
+
+static uint32_t user_mem_reply(void)
+{
+    ble_user_mem_block_t block = {.p_mem = m_user_mem, .len = sizeof(m_user_mem)};
+    uint32_t             err_code;
+
+    err_code = sd_ble_user_mem_reply(CONN_HANDLE, &block);
+
+    // Released by the BLE_EVT_USER_MEM_RELEASE event on a real link.
+    (void)app_ble_user_mem_context_destroy(CONN_HANDLE);
+    (void)conn_ble_user_mem_context_destroy(CONN_HANDLE);
+    return err_code;
+}
+
+/* L2CAP commands. */
+static uint32_t l2cap_cid_register(void)
+{
+    return sd_ble_l2cap_cid_register(BLE_L2CAP_CID_DYN_BASE);
+}
+
+static uint32_t l2cap_cid_unregister(void)
+{
+    return sd_ble_l2cap_cid_unregister(BLE_L2CAP_CID_DYN_BASE);
+}
+
+static uint32_t l2cap_tx(void)
+{
+    ble_l2cap_header_t header = {.len = 20, .cid = BLE_L2CAP_CID_DYN_BASE};
+    return sd_ble_l2cap_tx(CONN_HANDLE, &header, m_data);
+}
+
+/* GAP commands. */
+static uint32_t gap_scan_stop(void)
+{
+    return sd_ble_gap_scan_stop();
+}
+
+static uint32_t gap_address_set(void)
+{
+    return sd_ble_gap_address_set(BLE_GAP_ADDR_CYCLE_MODE_NONE, &m_addr);
+}
+
+static uint32_t gap_connect(void)
+{
+    return sd_ble_gap_connect(&m_addr, &m_scan_params, &m_conn_params);
+}
+
+static uint32_t gap_connect_cancel(void)
+{
+    return sd_ble_gap_connect_cancel();
+}
+
+static uint32_t gap_scan_start(void)
+{
+    return sd_ble_gap_scan_start(&m_scan_params);
+}
+
+static uint32_t gap_sec_info_reply(void)
+{
+    return sd_ble_gap_sec_info_reply(CONN_HANDLE, &m_enc_info, &m_irk, &m_sign_info);
+}
+
+static uint32_t gap_encrypt(void)
+{
+    return sd_ble_gap_encrypt(CONN_HANDLE, &m_master_id, &m_enc_info);
+}
+
+static uint32_t gap_address_get(void)
+{
+    ble_gap_addr_t addr;
+    return sd_ble_gap_address_get(&addr);
+}
+
+static uint32_t gap_adv_data_set(void)
+{
+    static const uint8_t adv_data[] = {0x02, 0x01, 0x06, 0x0D, 0x09, 'N', 'o', 'r', 'd', 'i', 'c',
+                                       '_', 'B', 'e', 'n', 'c', 'h', 0x03, 0x03, 0x0D, 0x18};
+    static const uint8_t sr_data[]  = {0x03, 0x19, 0x80, 0x00};
+
+    return sd_ble_gap_adv_data_set(adv_data, sizeof(adv_data), sr_data, sizeof(sr_data));
+}
+
+static uint32_t gap_adv_start(void)
+{
+    ble_gap_adv_params_t params;
+
+    memset(&params, 0, sizeof(params));
+    params.type     = BLE_GAP_ADV_TYPE_ADV_IND;
+    params.fp       = BLE_GAP_ADV_FP_ANY;
+    params.interval = 0x0040;
+    return sd_ble_gap_adv_start(&params);
+}
+
+static uint32_t gap_adv_stop(void)
+{
+    return sd_ble_gap_adv_stop();
+}
+
+static uint32_t gap_conn_param_update(void)
+{
+    return sd_ble_gap_conn_param_update(CONN_HANDLE, &m_conn_params);
+}
+
+static uint32_t gap_disconnect(void)
+{
+    return sd_ble_gap_disconnect(CONN_HANDLE, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+static uint32_t gap_tx_power_set(void)
+{
+    return sd_ble_gap_tx_power_set(-4);
+}
+
+static uint32_t gap_appearance_set(void)
+{
+    return sd_ble_gap_appearance_set(BLE_APPEARANCE_GENERIC_COMPUTER);
+}
+
+static uint32_t gap_appearance_get(void)
+{
+    uint16_t appearance;
+    return sd_ble_gap_appearance_get(&appearance);
+}
+
+static uint32_t gap_ppcp_set(void)
+{
+    return sd_ble_gap_ppcp_set(&m_conn_params);
+}
+
+static uint32_t gap_ppcp_get(void)
+{
+    ble_gap_conn_params_t conn_params;
+    return sd_ble_gap_ppcp_get(&conn_params);
+}
+
+static uint32_t gap_device_name_set(void)
+{
+    static const uint8_t    name[] = "Nordic_Bench";
+    ble_gap_conn_sec_mode_t perm   = {.sm = 1, .lv = 1};
+
+    return sd_ble_gap_device_name_set(&perm, name, sizeof(name) - 1);
+}
+
+static uint32_t gap_device_name_get(void)
+{
+    uint8_t  name[32];
+    uint16_t len = sizeof(name);
+    return sd_ble_gap_device_name_get(name, &len);
+}
+
+static uint32_t gap_authenticate(void)
+{
+    ble_gap_sec_params_t params;
+
+    memset(&params, 0, sizeof(params));
+    params.bond         = 1;
+    params.io_caps      = BLE_GAP_IO_CAPS_NONE;
+    params.min_key_size = 7;
+    params.max_key_size = 16;
+    return sd_ble_gap_authenticate(CONN_HANDLE, &params);
+}
+
+static uint32_t gap_sec_params_reply(void)
+{
+    ble_gap_sec_params_t params;
+    ble_gap_sec_keyset_t keyset;
+    uint32_t             err_code;
+
+    memset(&params, 0, sizeof(params));
+    params.bond           = 1;
+    params.io_caps        = BLE_GAP_IO_CAPS_NONE;
+    params.min_key_size   = 7;
+    params.max_key_size   = 16;
+    params.kdist_own.enc  = 1;
+    params.kdist_peer.enc = 1;
+    params.kdist_peer.id  = 1;
+
+    memset(&keyset, 0, sizeof(keyset));
+    keyset.keys_own.p_enc_key  = &m_enc_key_own;
+    keyset.keys_peer.p_enc_key = &m_enc_key_peer;
+    keyset.keys_peer.p_id_key  = &m_id_key_peer;
+
+    err_code = sd_ble_gap_sec_params_reply(CONN_HANDLE, BLE_GAP_SEC_STATUS_SUCCESS, &params, &keyset);
+
+    // Released by the BLE_GAP_EVT_AUTH_STATUS event on a real link.
+    (void)app_ble_gap_sec_context_destroy(CONN_HANDLE);
+    (void)conn_ble_gap_sec_context_destroy(CONN_HANDLE);
+    return err_code;
+}
+
+static uint32_t gap_auth_key_reply(void)
+{
+    static const uint8_t passkey[] = "123456";
+    return sd_ble_gap_auth_key_reply(CONN_HANDLE, BLE_GAP_AUTH_KEY_TYPE_PASSKEY, passkey);
+}
+
+static uint32_t gap_conn_sec_get(void)
+{
+    ble_gap_conn_sec_t conn_sec;
+    return sd_ble_gap_conn_sec_get(CONN_HANDLE, &conn_sec);
+}
+
+static uint32_t gap_rssi_start(void)
+{
+    return sd_ble_gap_rssi_start(CONN_HANDLE, 2, 0);
+}
+
+static uint32_t gap_rssi_stop(void)
+{
+    return sd_ble_gap_rssi_stop(CONN_HANDLE);
+}
+
+static uint32_t gap_keypress_notify(void)
+{
+    return sd_ble_gap_keypress_notify(CONN_HANDLE, BLE_GAP_KP_NOT_TYPE_PASSKEY_DIGIT_IN);
+}
+
+static uint32_t gap_lesc_dhkey_reply(void)
+{
+    return sd_ble_gap_lesc_dhkey_reply(CONN_HANDLE, &m_dhkey);
+}
+
+static uint32_t gap_lesc_oob_data_set(void)
+{
+    return sd_ble_gap_lesc_oob_data_set(CONN_HANDLE, &m_oobd, &m_oobd);
+}
+
+static uint32_t gap_lesc_oob_data_get(void)
+{
+    ble_gap_lesc_oob_data_t oobd;
+    return sd_ble_gap_lesc_oob_data_get(CONN_HANDLE, &m_pk, &oobd);
+}
+
+/* GATTC commands. */
+static uint32_t gattc_primary_services_discover(void)
+{
+    return sd_ble_gattc_primary_services_discover(CONN_HANDLE, 0x0001, &m_uuid);
+}
+
+static uint32_t gattc_relationships_discover(void)
+{
+    return sd_ble_gattc_relationships_discover(CONN_HANDLE, &m_range);
+}
+
+static uint32_t gattc_characteristics_discover(void)
+{
+    return sd_ble_gattc_characteristics_discover(CONN_HANDLE, &m_range);
+}
+
+static uint32_t gattc_descriptors_discover(void)
+{
+    return sd_ble_gattc_descriptors_discover(CONN_HANDLE, &m_range);
+}
+
+static uint32_t gattc_char_value_by_uuid_read(void)
+{
+    return sd_ble_gattc_char_value_by_uuid_read(CONN_HANDLE, &m_uuid, &m_range);
+}
+
+static uint32_t gattc_read(void)
+{
+    return sd_ble_gattc_read(CONN_HANDLE, CHAR_HANDLE, 0);
+}
+
+static uint32_t gattc_char_values_read(void)
+{
+    static const uint16_t handles[] = {CHAR_HANDLE, CHAR_HANDLE + 2, CHAR_HANDLE + 4};
+    return sd_ble_gattc_char_values_read(CONN_HANDLE, handles, sizeof(handles) / sizeof(handles[0]));
+}
+
+static uint32_t gattc_write(void)
+{
+    ble_gattc_write_params_t params = {.write_op = BLE_GATT_OP_WRITE_CMD,
+                                       .flags    = 0,
+                                       .handle   = CHAR_HANDLE,
+                                       .offset   = 0,
+                                       .len      = 20,
+                                       .p_value  = m_data};
+
+    return sd_ble_gattc_write(CONN_HANDLE, &params);
+}
+
+static uint32_t gattc_hv_confirm(void)
+{
+    return sd_ble_gattc_hv_confirm(CONN_HANDLE, CHAR_HANDLE);
+}
+
+static uint32_t gattc_attr_info_discover(void)
+{
+    return sd_ble_gattc_attr_info_discover(CONN_HANDLE, &m_range);
+}
+
+/* GATTS commands. */
+static uint32_t gatts_service_add(void)
+{
+    uint16_t handle;
+    return sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &m_uuid, &handle);
+}
+
+static uint32_t gatts_include_add(void)
+{
+    uint16_t handle;
+    return sd_ble_gatts_include_add(CHAR_HANDLE, CHAR_HANDLE + 8, &handle);
+}
+
+static uint32_t gatts_characteristic_add(void)
+{
+    ble_gatts_char_md_t      char_md;
+    ble_gatts_attr_md_t      cccd_md;
+    ble_gatts_attr_md_t      attr_md;
+    ble_gatts_attr_t         attr;
+    ble_gatts_char_handles_t handles;
+    ble_uuid_t               uuid = {.uuid = UUID_HRM,
+                                     .type = BLE_UUID_TYPE_BLE};
+
+    memset(&cccd_md, 0, sizeof(cccd_md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
+    memset(&char_md, 0, sizeof(char_md));
+    char_md.char_props.notify = 1;
+    char_md.p_cccd_md         = &cccd_md;
+
+    memset(&attr_md, 0, sizeof(attr_md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
+    attr_md.vloc = BLE_GATTS_VLOC_STACK;
+    attr_md.vlen = 1;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.p_uuid    = &uuid;
+    attr.p_attr_md = &attr_md;
+    attr.init_len  = 4;
+    attr.max_len   = 20;
+    attr.p_value   = m_data;
+
+    return sd_ble_gatts_characteristic_add(CHAR_HANDLE, &char_md, &attr, &handles);
+}
+
+static uint32_t gatts_descriptor_add(void)
+{
+    ble_gatts_attr_md_t attr_md;
+    ble_gatts_attr_t    attr;
+    uint16_t            handle;
+    ble_uuid_t          uuid = {.uuid = BLE_UUID_DESCRIPTOR_CHAR_USER_DESC,
+                                .type = BLE_UUID_TYPE_BLE};
+
+    memset(&attr_md, 0, sizeof(attr_md));
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
+    attr_md.vloc = BLE_GATTS_VLOC_STACK;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.p_uuid    = &uuid;
+    attr.p_attr_md = &attr_md;
+    attr.init_len  = 8;
+    attr.max_len   = 8;
+    attr.p_value   = m_data;
+
+    return sd_ble_gatts_descriptor_add(CHAR_HANDLE, &attr, &handle);
+}
+
+static uint32_t gatts_value_set(void)
+{
+    ble_gatts_value_t value = {.len = 20, .offset = 0, .p_value = m_data};
+    return sd_ble_gatts_value_set(CONN_HANDLE, CHAR_HANDLE, &value);
+}
+
+static uint32_t gatts_value_get(void)
+{
+    uint8_t           data[20];
+    ble_gatts_value_t value = {.len = sizeof(data), .offset = 0, .p_value = data};
+    return sd_ble_gatts_value_get(CONN_HANDLE, CHAR_HANDLE, &value);
+}
+
+static uint32_t gatts_hvx(void)
+{
+    uint16_t               len    = 20;
+    ble_gatts_hvx_params_t params = {.handle = CHAR_HANDLE,
+                                     .type   = BLE_GATT_HVX_NOTIFICATION,
+                                     .offset = 0,
+                                     .p_len  = &len,
+                                     .p_data = m_data};
+
+    return sd_ble_gatts_hvx(CONN_HANDLE, &params);
+}
+
+static uint32_t gatts_service_changed(void)
+{
+    return sd_ble_gatts_service_changed(CONN_HANDLE, 0x000C, 0xFFFF);
+}
+
+static uint32_t gatts_rw_authorize_reply(void)
+{
+    ble_gatts_rw_authorize_reply_params_t params;
+
+    memset(&params, 0, sizeof(params));
+    params.type                    = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    params.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
+    params.params.read.update      = 1;
+    params.params.read.len         = 20;
+    params.params.read.p_data      = m_data;
+    return sd_ble_gatts_rw_authorize_reply(CONN_HANDLE, &params);
+}
+
+static uint32_t gatts_sys_attr_set(void)
+{
+    return sd_ble_gatts_sys_attr_set(CONN_HANDLE, m_data, 16, 0);
+}
+
+static uint32_t gatts_sys_attr_get(void)
+{
+    uint8_t  data[32];
+    uint16_t len = sizeof(data);
+    return sd_ble_gatts_sys_attr_get(CONN_HANDLE, data, &len, 0);
+}
+
+/* SoC commands. */
+static uint32_t power_system_off(void)
+{
+    return sd_power_system_off();
+}
+
+static uint32_t temp_get(void)
+{
+    int32_t temp;
+    return sd_temp_get(&temp);
+}
+
+static uint32_t ecb_block_encrypt(void)
+{
+    nrf_ecb_hal_data_t ecb_data;
+
+    memset(&ecb_data, 0, sizeof(ecb_data));
+    memcpy(ecb_data.cleartext, m_data, sizeof(ecb_data.cleartext));
+    return sd_ecb_block_encrypt(&ecb_data);
+}
+
+static const cmd_t m_cmds[] =
+{
+    {"sd_ble_tx_packet_count_get", tx_packet_count_get},
+    {"sd_ble_uuid_vs_add", uuid_vs_add},
+    {"sd_ble_uuid_decode", uuid_decode},
+    {"sd_ble_uuid_encode", uuid_encode},
+    {"sd_ble_version_get", version_get},
+    {"sd_ble_opt_get", opt_get},
+    {"sd_ble_opt_set", opt_set},
+    {"sd_ble_enable", enable},
+    {"sd_ble_user_mem_reply", user_mem_reply},
+    {"sd_ble_l2cap_cid_register", l2cap_cid_register},
+    {"sd_ble_l2cap_cid_unregister", l2cap_cid_unregister},
+    {"sd_ble_l2cap_tx", l2cap_tx},
+    {"sd_ble_gap_scan_stop", gap_scan_stop},
+    {"sd_ble_gap_address_set", gap_address_set},
+    {"sd_ble_gap_connect", gap_connect},
+    {"sd_ble_gap_connect_cancel", gap_connect_cancel},
+    {"sd_ble_gap_scan_start", gap_scan_start},
+    {"sd_ble_gap_sec_info_reply", gap_sec_info_reply},
+    {"sd_ble_gap_encrypt", gap_encrypt},
+    {"sd_ble_gap_address_get", gap_address_get},
+    {"sd_ble_gap_adv_data_set", gap_adv_data_set},
+    {"sd_ble_gap_adv_start", gap_adv_start},
+    {"sd_ble_gap_adv_stop", gap_adv_stop},
+    {"sd_ble_gap_conn_param_update", gap_conn_param_update},
+    {"sd_ble_gap_disconnect", gap_disconnect},
+    {"sd_ble_gap_tx_power_set", gap_tx_power_set},
+    {"sd_ble_gap_appearance_set", gap_appearance_set},
+    {"sd_ble_gap_appearance_get", gap_appearance_get},
+    {"sd_ble_gap_ppcp_set", gap_ppcp_set},
+    {"sd_ble_gap_ppcp_get", gap_ppcp_get},
+    {"sd_ble_gap_device_name_set", gap_device_name_set},
+    {"sd_ble_gap_device_name_get", gap_device_name_get},
+    {"sd_ble_gap_authenticate", gap_authenticate},
+    {"sd_ble_gap_sec_params_reply", gap_sec_params_reply},
+    {"sd_ble_gap_auth_key_reply", gap_auth_key_reply},
+    {"sd_ble_gap_conn_sec_get", gap_conn_sec_get},
+    {"sd_ble_gap_rssi_start", gap_rssi_start},
+    {"sd_ble_gap_rssi_stop", gap_rssi_stop},
+    {"sd_ble_gap_keypress_notify", gap_keypress_notify},
+    {"sd_ble_gap_lesc_dhkey_reply", gap_lesc_dhkey_reply},
+    {"sd_ble_gap_lesc_oob_data_set", gap_lesc_oob_data_set},
+    {"sd_ble_gap_lesc_oob_data_get", gap_lesc_oob_data_get},
+    {"sd_ble_gattc_primary_services_discover", gattc_primary_services_discover},
+    {"sd_ble_gattc_relationships_discover", gattc_relationships_discover},
+    {"sd_ble_gattc_characteristics_discover", gattc_characteristics_discover},
+    {"sd_ble_gattc_descriptors_discover", gattc_descriptors_discover},
+    {"sd_ble_gattc_char_value_by_uuid_read", gattc_char_value_by_uuid_read},
+    {"sd_ble_gattc_read", gattc_read},
+    {"sd_ble_gattc_char_values_read", gattc_char_values_read},
+    {"sd_ble_gattc_write", gattc_write},
+    {"sd_ble_gattc_hv_confirm", gattc_hv_confirm},
+    {"sd_ble_gattc_attr_info_discover", gattc_attr_info_discover},
+    {"sd_ble_gatts_service_add", gatts_service_add},
+    {"sd_ble_gatts_include_add", gatts_include_add},
+    {"sd_ble_gatts_characteristic_add", gatts_characteristic_add},
+    {"sd_ble_gatts_descriptor_add", gatts_descriptor_add},
+    {"sd_ble_gatts_value_set", gatts_value_set},
+    {"sd_ble_gatts_value_get", gatts_value_get},
+    {"sd_ble_gatts_hvx", gatts_hvx},
+    {"sd_ble_gatts_service_changed", gatts_service_changed},
+    {"sd_ble_gatts_rw_authorize_reply", gatts_rw_authorize_reply},
+    {"sd_ble_gatts_sys_attr_set", gatts_sys_attr_set},
+    {"sd_ble_gatts_sys_attr_get", gatts_sys_attr_get},
+    {"sd_power_system_off", power_system_off},
+    {"sd_temp_get", temp_get},
+    {"sd_ecb_block_encrypt", ecb_block_encrypt},
+};
+
+#define CMD_COUNT (sizeof(m_cmds) / sizeof(m_cmds[0]))
+
+static void usage(char const * p_prog)
+{
+    printf("usage: %s [-n loops]\n"
+           "  -n  round trips per opcode (default %u)\n", p_prog, DEFAULT_LOOPS);
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t loops         = DEFAULT_LOOPS;
+    double   total_ns      = 0;
+    double   total_conn_ns = 0;
+    double   clock_ns;
+    uint32_t total_cmd     = 0;
+    uint32_t total_rsp     = 0;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                loops = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (loops == 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Time measured between two clock readings with nothing in between, as around conn_mw_handler.
+    m_conn_s = 0;
+    for (uint32_t j = 0; j < loops; j++)
+    {
+        double start = time_get();
+        m_conn_s    += time_get() - start;
+    }
+    clock_ns = m_conn_s * NS_PER_S / loops;
+
+    printf("%-40s %8s %10s %10s %10s\n",
+           "command", "ns/op", "conn ns/op", "cmd bytes", "rsp bytes");
+
+    for (uint32_t i = 0; i < CMD_COUNT; i++)
+    {
+        double start;
+        double ns;
+        double conn_ns;
+
+        // Warm up, and check that the command succeeds end to end.
+        if (m_cmds[i].call() != NRF_SUCCESS)
+        {
+            printf("%s failed\n", m_cmds[i].p_name);
+            return EXIT_FAILURE;
+        }
+
+        m_conn_s = 0;
+        start    = time_get();
+        for (uint32_t j = 0; j < loops; j++)
+        {
+            (void)m_cmds[i].call();
+        }
+        ns      = (time_get() - start) * NS_PER_S / loops;
+        conn_ns = m_conn_s * NS_PER_S / loops - clock_ns;
+
+        printf("%-40s %8.0f %10.0f %10u %10u\n",
+               m_cmds[i].p_name, ns, conn_ns, (unsigned int)m_cmd_len, (unsigned int)m_rsp_len);
+
+        total_ns      += ns;
+        total_conn_ns += conn_ns;
+        total_cmd     += m_cmd_len;
+        total_rsp     += m_rsp_len;
+    }
+
+    printf("%-40s %8.0f %10.0f %10.1f %10.1f\n", "mean", total_ns / CMD_COUNT,
+           total_conn_ns / CMD_COUNT, (double)total_cmd / CMD_COUNT, (double)total_rsp / CMD_COUNT);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,538 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief SoftDevice stubs for the connectivity side of the codec round-trip benchmark.
+ *
+ * @details Every SoftDevice function called by the connectivity middleware succeeds. Functions
+ *          with output parameters fill them with fixed values, so that the responses have
+ *          realistic sizes. This file is linked into the connectivity side object only, where the
+ *          functions become local symbols (see the Makefile).
+ */
+
+#include <string.h>
+#include "ble.h"
+#include "ble_gap.h"
+#include "ble_gatts.h"
+#include "ble_gattc.h"
+#include "ble_l2cap.h"
+#include "ble_types.h"
+#include "nrf_soc.h"
+#include "nrf_error.h"
+#include "app_util.h"
+#include "nordic_common.h"
+
+#define SYS_ATTR_LEN 16 /**< Length of the system attributes returned by sd_ble_gatts_sys_attr_get. */
+
+/**@brief Data returned by the stubs. */
+static const uint8_t m_pattern[20] =
+{
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA,
+    0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x01, 0x02, 0x03, 0x04, 0x05
+};
+
+uint32_t sd_ble_enable(ble_enable_params_t * p_ble_enable_params,
+                       uint32_t * p_app_ram_base)
+{
+    if (p_app_ram_base != NULL)
+    {
+        *p_app_ram_base = 0x20002000;
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_address_get(ble_gap_addr_t * p_addr)
+{
+    p_addr->addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    memcpy(p_addr->addr, m_pattern, BLE_GAP_ADDR_LEN);
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_address_set(uint8_t addr_cycle_mode,
+                                ble_gap_addr_t const * p_addr)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_data_set(uint8_t const * p_data,
+                                 uint8_t dlen,
+                                 uint8_t const * p_sr_data,
+                                 uint8_t srdlen)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_start(ble_gap_adv_params_t const * p_adv_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_stop(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_appearance_get(uint16_t * p_appearance)
+{
+    *p_appearance = BLE_APPEARANCE_GENERIC_COMPUTER;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_appearance_set(uint16_t appearance)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_auth_key_reply(uint16_t conn_handle,
+                                   uint8_t key_type,
+                                   uint8_t const * p_key)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_authenticate(uint16_t conn_handle,
+                                 ble_gap_sec_params_t const * p_sec_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_conn_param_update(uint16_t conn_handle,
+                                      ble_gap_conn_params_t const * p_conn_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_conn_sec_get(uint16_t conn_handle,
+                                 ble_gap_conn_sec_t * p_conn_sec)
+{
+    p_conn_sec->sec_mode.sm = 1;
+    p_conn_sec->sec_mode.lv = 2;
+    p_conn_sec->encr_key_size = 16;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_connect(ble_gap_addr_t const * p_peer_addr,
+                            ble_gap_scan_params_t const * p_scan_params,
+                            ble_gap_conn_params_t const * p_conn_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_connect_cancel(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_device_name_get(uint8_t * p_dev_name,
+                                    uint16_t * p_len)
+{
+    static const char dev_name[] = "Nordic_Bench";
+
+    if ((p_dev_name != NULL) && (*p_len >= sizeof(dev_name) - 1))
+    {
+        memcpy(p_dev_name, dev_name, sizeof(dev_name) - 1);
+    }
+    *p_len = sizeof(dev_name) - 1;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_device_name_set(ble_gap_conn_sec_mode_t const * p_write_perm,
+                                    uint8_t const * p_dev_name,
+                                    uint16_t len)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle,
+                               uint8_t hci_status_code)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_encrypt(uint16_t conn_handle,
+                            ble_gap_master_id_t const * p_master_id,
+                            ble_gap_enc_info_t const * p_enc_info)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_keypress_notify(uint16_t conn_handle,
+                                    uint8_t kp_not)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_lesc_dhkey_reply(uint16_t conn_handle,
+                                     ble_gap_lesc_dhkey_t const * p_dhkey)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_lesc_oob_data_get(uint16_t conn_handle,
+                                      ble_gap_lesc_p256_pk_t const * p_pk_own,
+                                      ble_gap_lesc_oob_data_t * p_oobd_own)
+{
+    memset(p_oobd_own, 0, sizeof(*p_oobd_own));
+    memcpy(p_oobd_own->r, m_pattern, sizeof(p_oobd_own->r));
+    memcpy(p_oobd_own->c, m_pattern, sizeof(p_oobd_own->c));
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_lesc_oob_data_set(uint16_t conn_handle,
+                                      ble_gap_lesc_oob_data_t const * p_oobd_own,
+                                      ble_gap_lesc_oob_data_t const * p_oobd_peer)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_ppcp_get(ble_gap_conn_params_t * p_conn_params)
+{
+    p_conn_params->min_conn_interval = 8;
+    p_conn_params->max_conn_interval = 16;
+    p_conn_params->slave_latency     = 0;
+    p_conn_params->conn_sup_timeout  = 400;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * p_conn_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_rssi_get(uint16_t conn_handle,
+                             int8_t * p_rssi)
+{
+    *p_rssi = -60;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_rssi_start(uint16_t conn_handle,
+                               uint8_t threshold_dbm,
+                               uint8_t skip_count)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_rssi_stop(uint16_t conn_handle)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_scan_start(ble_gap_scan_params_t const * p_scan_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_scan_stop(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_sec_info_reply(uint16_t conn_handle,
+                                   ble_gap_enc_info_t const * p_enc_info,
+                                   ble_gap_irk_t const * p_id_info,
+                                   ble_gap_sign_info_t const * p_sign_info)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_sec_params_reply(uint16_t conn_handle,
+                                     uint8_t sec_status,
+                                     ble_gap_sec_params_t const * p_sec_params,
+                                     ble_gap_sec_keyset_t const * p_sec_keyset)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_tx_power_set(int8_t tx_power)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_attr_info_discover(uint16_t conn_handle,
+                                         ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_char_value_by_uuid_read(uint16_t conn_handle,
+                                              ble_uuid_t const * p_uuid,
+                                              ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_char_values_read(uint16_t conn_handle,
+                                       uint16_t const * p_handles,
+                                       uint16_t handle_count)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_characteristics_discover(uint16_t conn_handle,
+                                               ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_descriptors_discover(uint16_t conn_handle,
+                                           ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_hv_confirm(uint16_t conn_handle,
+                                 uint16_t handle)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t conn_handle,
+                                                uint16_t start_handle,
+                                                ble_uuid_t const * p_srvc_uuid)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_read(uint16_t conn_handle,
+                           uint16_t handle,
+                           uint16_t offset)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_relationships_discover(uint16_t conn_handle,
+                                             ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle,
+                            ble_gattc_write_params_t const * p_write_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_attr_get(uint16_t handle,
+                               ble_uuid_t * p_uuid,
+                               ble_gatts_attr_md_t * p_md)
+{
+    if (p_uuid != NULL)
+    {
+        p_uuid->type = BLE_UUID_TYPE_BLE;
+        p_uuid->uuid = BLE_UUID_GAP_CHARACTERISTIC_DEVICE_NAME;
+    }
+    if (p_md != NULL)
+    {
+        memset(p_md, 0, sizeof(*p_md));
+        p_md->vloc = BLE_GATTS_VLOC_STACK;
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t service_handle,
+                                         ble_gatts_char_md_t const * p_char_md,
+                                         ble_gatts_attr_t const * p_attr_char_value,
+                                         ble_gatts_char_handles_t * p_handles)
+{
+    p_handles->value_handle     = service_handle + 2;
+    p_handles->user_desc_handle = 0;
+    p_handles->cccd_handle      = service_handle + 3;
+    p_handles->sccd_handle      = 0;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_descriptor_add(uint16_t char_handle,
+                                     ble_gatts_attr_t const * p_attr,
+                                     uint16_t * p_handle)
+{
+    *p_handle = char_handle + 1;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle,
+                          ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_include_add(uint16_t service_handle,
+                                  uint16_t inc_srvc_handle,
+                                  uint16_t * p_include_handle)
+{
+    *p_include_handle = service_handle + 1;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_initial_user_handle_get(uint16_t * p_handle)
+{
+    *p_handle = 12;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_rw_authorize_reply(uint16_t conn_handle,
+                                         ble_gatts_rw_authorize_reply_params_t const * p_rw_authorize_reply_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_service_add(uint8_t type,
+                                  ble_uuid_t const * p_uuid,
+                                  uint16_t * p_handle)
+{
+    *p_handle = 12;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_service_changed(uint16_t conn_handle,
+                                      uint16_t start_handle,
+                                      uint16_t end_handle)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_sys_attr_get(uint16_t conn_handle,
+                                   uint8_t * p_sys_attr_data,
+                                   uint16_t * p_len,
+                                   uint32_t flags)
+{
+    if ((p_sys_attr_data != NULL) && (*p_len >= SYS_ATTR_LEN))
+    {
+        memcpy(p_sys_attr_data, m_pattern, SYS_ATTR_LEN);
+    }
+    *p_len = SYS_ATTR_LEN;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle,
+                                   uint8_t const * p_sys_attr_data,
+                                   uint16_t len,
+                                   uint32_t flags)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_value_get(uint16_t conn_handle,
+                                uint16_t handle,
+                                ble_gatts_value_t * p_value)
+{
+    if (p_value->p_value != NULL)
+    {
+        p_value->len = MIN(p_value->len, sizeof(m_pattern));
+        memcpy(p_value->p_value, m_pattern, p_value->len);
+    }
+    else
+    {
+        p_value->len = sizeof(m_pattern);
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_value_set(uint16_t conn_handle,
+                                uint16_t handle,
+                                ble_gatts_value_t * p_value)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_l2cap_cid_register(uint16_t cid)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_l2cap_cid_unregister(uint16_t cid)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_l2cap_tx(uint16_t conn_handle,
+                         ble_l2cap_header_t const * p_header,
+                         uint8_t const * p_data)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_opt_get(uint32_t opt_id,
+                        ble_opt_t * p_opt)
+{
+    memset(p_opt, 0, sizeof(*p_opt));
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_opt_set(uint32_t opt_id,
+                        ble_opt_t const * p_opt)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_tx_packet_count_get(uint16_t conn_handle,
+                                    uint8_t * p_count)
+{
+    *p_count = 7;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_user_mem_reply(uint16_t conn_handle,
+                               ble_user_mem_block_t const * p_block)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_uuid_decode(uint8_t uuid_le_len,
+                            uint8_t const * p_uuid_le,
+                            ble_uuid_t * p_uuid)
+{
+    p_uuid->type = BLE_UUID_TYPE_BLE;
+    p_uuid->uuid = uint16_decode(p_uuid_le);
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_uuid_encode(ble_uuid_t const * p_uuid,
+                            uint8_t * p_uuid_le_len,
+                            uint8_t * p_uuid_le)
+{
+    *p_uuid_le_len = (uint8_t)uint16_encode(p_uuid->uuid, p_uuid_le);
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid,
+                            uint8_t * p_uuid_type)
+{
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_version_get(ble_version_t * p_version)
+{
+    p_version->version_number   = 8;
+    p_version->company_id       = 0x0059;
+    p_version->subversion_number = 0x0087;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ecb_block_encrypt(nrf_ecb_hal_data_t * p_ecb_data)
+{
+    memcpy(p_ecb_data->ciphertext, p_ecb_data->cleartext, sizeof(p_ecb_data->ciphertext));
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_power_system_off(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_temp_get(int32_t * p_temp)
+{
+    *p_temp = 100;
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,263 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief   Test and benchmark of the CRC16 and CRC32 engines.
+ *
+ * @details crc16.c and crc32.c are built once per engine, with crc16_compute and crc32_compute
+ *          renamed to crc16_compute_<engine> and crc32_compute_<engine> (see the Makefile).
+ *
+ *          Every engine is checked against the check value of its CRC for "123456789"
+ *          (CRC-16/CCITT-FALSE: 0x29B1, CRC-32: 0xCBF43926), and against the bitwise engine on
+ *          random buffers, computed in two blocks split at a random position, so that the
+ *          initial value passed in p_crc and the unaligned tails are covered.
+ *
+ *          The time per byte of each engine is then measured on a 1 kB buffer. The host numbers
+ *          only give the relative cost of the engines, the Cortex-M0 has no cache and loads each
+ *          table entry from flash.
+ *
+ *          Usage: ser_crc_bench [-n <loops>]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CRC16_ENGINE_DECLARE(N) \
+    uint16_t crc16_compute_##N(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc)
+
+#define CRC32_ENGINE_DECLARE(N) \
+    uint32_t crc32_compute_##N(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc)
+
+CRC16_ENGINE_DECLARE(0);
+CRC16_ENGINE_DECLARE(1);
+CRC16_ENGINE_DECLARE(2);
+CRC16_ENGINE_DECLARE(3);
+
+CRC32_ENGINE_DECLARE(0);
+CRC32_ENGINE_DECLARE(1);
+CRC32_ENGINE_DECLARE(2);
+CRC32_ENGINE_DECLARE(3);
+CRC32_ENGINE_DECLARE(4);
+
+#define CHECK_CRC16         0x29B1      /**< CRC-16/CCITT-FALSE of "123456789". */
+#define CHECK_CRC32         0xCBF43926  /**< CRC-32 of "123456789". */
+
+#define RANDOM_RUNS         20000       /**< Number of random buffers compared to the bitwise engine. */
+#define RANDOM_MAX_SIZE     300         /**< Maximum size of the random buffers. */
+#define BENCH_SIZE          1024        /**< Size of the benchmark buffer. */
+#define BENCH_LOOPS_DEFAULT 20000       /**< Default number of benchmark loops. */
+
+typedef uint16_t (* crc16_fn_t)(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
+typedef uint32_t (* crc32_fn_t)(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+typedef struct
+{
+    char const * p_name;
+    crc16_fn_t   compute;
+} crc16_engine_t;
+
+typedef struct
+{
+    char const * p_name;
+    crc32_fn_t   compute;
+} crc32_engine_t;
+
+static const crc16_engine_t m_crc16_engines[] =
+{
+    {"BITWISE",    crc16_compute_0},
+    {"NIBBLE",     crc16_compute_1},
+    {"TABLE",      crc16_compute_2},
+    {"SLICE_BY_4", crc16_compute_3},
+};
+
+static const crc32_engine_t m_crc32_engines[] =
+{
+    {"BITWISE",    crc32_compute_0},
+    {"NIBBLE",     crc32_compute_1},
+    {"TABLE",      crc32_compute_2},
+    {"SLICE_BY_4", crc32_compute_3},
+    {"SLICE_BY_8", crc32_compute_4},
+};
+
+#define CRC16_ENGINE_COUNT  (sizeof (m_crc16_engines) / sizeof (m_crc16_engines[0]))
+#define CRC32_ENGINE_COUNT  (sizeof (m_crc32_engines) / sizeof (m_crc32_engines[0]))
+
+static const uint8_t m_check_data[] = "123456789";
+
+static uint8_t m_bench_buf[BENCH_SIZE];
+
+/**@brief Sink for the benchmark results, so that the calls are not optimized out. */
+static volatile uint32_t m_sink;
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**@brief Function for checking all engines.
+ *
+ * @return Number of failed checks.
+ */
+static uint32_t engines_check(void)
+{
+    uint8_t  buf[RANDOM_MAX_SIZE];
+    uint32_t failures = 0;
+    uint32_t run;
+    uint32_t i;
+
+    for (i = 0; i < CRC16_ENGINE_COUNT; i++)
+    {
+        uint16_t crc = m_crc16_engines[i].compute(m_check_data, sizeof (m_check_data) - 1, NULL);
+
+        if (crc != CHECK_CRC16)
+        {
+            printf("CRC16 %s: check value 0x%04X, expected 0x%04X.\n",
+                   m_crc16_engines[i].p_name, crc, CHECK_CRC16);
+            failures++;
+        }
+    }
+
+    for (i = 0; i < CRC32_ENGINE_COUNT; i++)
+    {
+        uint32_t crc = m_crc32_engines[i].compute(m_check_data, sizeof (m_check_data) - 1, NULL);
+
+        if (crc != CHECK_CRC32)
+        {
+            printf("CRC32 %s: check value 0x%08X, expected 0x%08X.\n",
+                   m_crc32_engines[i].p_name, (unsigned int)crc, (unsigned int)CHECK_CRC32);
+            failures++;
+        }
+    }
+
+    srand(1);
+    for (run = 0; run < RANDOM_RUNS; run++)
+    {
+        uint32_t size  = (uint32_t)rand() % RANDOM_MAX_SIZE;
+        uint32_t split = (uint32_t)rand() % (size + 1);
+        uint16_t ref16;
+        uint32_t ref32;
+
+        for (i = 0; i < size; i++)
+        {
+            buf[i] = (uint8_t)rand();
+        }
+
+        ref16 = crc16_compute_0(buf, size, NULL);
+        ref32 = crc32_compute_0(buf, size, NULL);
+
+        for (i = 0; i < CRC16_ENGINE_COUNT; i++)
+        {
+            uint16_t crc = m_crc16_engines[i].compute(buf, split, NULL);
+
+            crc = m_crc16_engines[i].compute(&buf[split], size - split, &crc);
+            if (crc != ref16)
+            {
+                printf("CRC16 %s: mismatch, size %u split %u.\n",
+                       m_crc16_engines[i].p_name, (unsigned int)size, (unsigned int)split);
+                failures++;
+            }
+        }
+
+        for (i = 0; i < CRC32_ENGINE_COUNT; i++)
+        {
+            uint32_t crc = m_crc32_engines[i].compute(buf, split, NULL);
+
+            crc = m_crc32_engines[i].compute(&buf[split], size - split, &crc);
+            if (crc != ref32)
+            {
+                printf("CRC32 %s: mismatch, size %u split %u.\n",
+                       m_crc32_engines[i].p_name, (unsigned int)size, (unsigned int)split);
+                failures++;
+            }
+        }
+    }
+
+    return failures;
+}
+
+static void engines_bench(uint32_t loops)
+{
+    uint64_t start;
+    uint32_t loop;
+    uint32_t i;
+
+    for (i = 0; i < sizeof (m_bench_buf); i++)
+    {
+        m_bench_buf[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    printf("%-6s %-12s %10s\n", "crc", "engine", "ns/byte");
+
+    for (i = 0; i < CRC16_ENGINE_COUNT; i++)
+    {
+        start = time_ns();
+        for (loop = 0; loop < loops; loop++)
+        {
+            m_sink = m_crc16_engines[i].compute(m_bench_buf, sizeof (m_bench_buf), NULL);
+        }
+        printf("%-6s %-12s %10.3f\n", "CRC16", m_crc16_engines[i].p_name,
+               (double)(time_ns() - start) / ((double)loops * sizeof (m_bench_buf)));
+    }
+
+    for (i = 0; i < CRC32_ENGINE_COUNT; i++)
+    {
+        start = time_ns();
+        for (loop = 0; loop < loops; loop++)
+        {
+            m_sink = m_crc32_engines[i].compute(m_bench_buf, sizeof (m_bench_buf), NULL);
+        }
+        printf("%-6s %-12s %10.3f\n", "CRC32", m_crc32_engines[i].p_name,
+               (double)(time_ns() - start) / ((double)loops * sizeof (m_bench_buf)));
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t loops = BENCH_LOOPS_DEFAULT;
+    uint32_t failures;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                loops = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                printf("Usage: %s [-n <loops>]\n", argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    failures = engines_check();
+    if (failures != 0)
+    {
+        printf("%u checks failed.\n", (unsigned int)failures);
+        return EXIT_FAILURE;
+    }
+    printf("All engines match the check values and the bitwise engine.\n\n");
+
+    engines_bench(loops);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1073 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief   Loopback test of the HCI PHY reliable link, with frame loss and latency.
+ *
+ * @details Two instances of ser_phy_hci.c, built with HCI_LINK_CONTROL, are connected through a
+ *          simulated UART link. Each instance is compiled with its own SER_PHY_HCI_WINDOW_SIZE and
+ *          with its API, SLIP and app_timer functions renamed after the instance (see the
+ *          Makefile), so that the test can run several pairs of peers.
+ *
+ *          The SLIP layer is replaced by a model of ser_phy_hci_slip.c: one frame is transmitted at
+ *          a time at 11 bits per byte, with one more frame pending, and received frames are stored
+ *          in a small buffer for acknowledgements and a big buffer, each locked until it is freed.
+ *          A frame received while no buffer is free is lost, as on the chip. The link adds a
+ *          constant latency to every frame, and drops or corrupts frames with a given probability.
+ *          app_timer runs on the simulated time.
+ *
+ *          Both peers send PACKET_COUNT packets of random length to each other as fast as the PHY
+ *          accepts them. Every packet must be received once and in order. The frames on the link
+ *          are decoded to check the CONFIG exchange and the window agreed with it, the number of
+ *          packets in flight, the retransmissions and the cumulative acknowledgements.
+ *
+ *          The test also keeps a model of the retransmission timer of each peer, from the frames
+ *          passed to SLIP, the frames which ended and the timeouts. An acknowledgement of a packet
+ *          which timed out and has not been passed to SLIP again since, or whose last transmission
+ *          has not ended, is counted as spurious, as by the PHY. The response time of a packet is
+ *          measured when its acknowledgement is received, unless it was sent more than once or
+ *          timed out (Karn's rule). SRTT must stay within the range of these measurements and RTTVAR
+ *          within their spread, and on a link without loss, overruns or stalls, no timeout may
+ *          expire. In the stall runs, every STALL_INTERVAL-th frame on the link is delayed beyond
+ *          the retransmission timeout, along with the frames behind it, so that the original
+ *          transmission is acknowledged after the timeout.
+ *
+ *          Reported for each run: goodput of both directions together, as a share of the line
+ *          rate of both directions, retransmitted frames, spurious timeouts, frames lost for lack
+ *          of an RX buffer, and SRTT and RTTVAR of the first peer.
+ *          With traffic in both directions, a packet received while the acknowledgement of the
+ *          previous one waits behind a data packet of the receiver keeps the big buffer locked, so
+ *          the next packets of a window can be lost even on a link without loss.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_util.h"
+#include "app_timer.h"
+#include "ser_config.h"
+#include "ser_phy.h"
+#include "ser_phy_hci.h"
+
+#define PKT_HDR_SIZE        4       /**< HCI packet header size, see ser_phy_hci.c. */
+#define PKT_CRC_SIZE        2       /**< HCI packet CRC size, see ser_phy_hci.c. */
+#define PKT_TYPE_ACK        0
+#define PKT_TYPE_DATA       14
+#define PKT_TYPE_LINK_CTRL  15
+#define SEQ_COUNT           8       /**< Number of sequence numbers. */
+#define LINK_CTRL_CONFIG    0xFC03u /**< CONFIG packet type, see ser_phy_hci.c. */
+#define LINK_CTRL_CONFIG_RSP 0x7B04u
+#define CONFIG_FIELD_BASE   0x10u   /**< Configuration field without the window size. */
+#define MAX_FRAME_SIZE      (SER_HAL_TRANSPORT_MAX_PKT_SIZE + PKT_HDR_SIZE + PKT_CRC_SIZE)
+
+#define SLIP_END            0xC0
+#define SLIP_ESC            0xDB
+#define BITS_PER_BYTE       11      /**< Start, 8 data, parity and stop bits. */
+#define NS_PER_BYTE         ((BITS_PER_BYTE * 1000000000ull) / SER_PHY_UART_BAUDRATE_VAL)
+#define RTC_FREQ            32768ull
+#define RTT_TOLERANCE_US    (2 * 1000000 / RTC_FREQ)    /**< The PHY measures in app_timer ticks. */
+
+#define PACKET_COUNT        500     /**< Packets sent in each direction per run. */
+#define FRAME_QUEUE_SIZE    32      /**< Frames in flight in one direction. */
+#define STALL_INTERVAL      50      /**< Number of frames on the link between two stalls. */
+#define RUN_TIME_LIMIT_NS   (60ull * 1000000000ull)
+
+/**@brief Declaration of the functions of an instance of ser_phy_hci.c. */
+#define HCI_INSTANCE_API(name)                                                                      \
+    uint32_t ser_phy_open_##name(ser_phy_events_handler_t events_handler);                          \
+    void     ser_phy_close_##name(void);                                                            \
+    uint32_t ser_phy_tx_pkt_send_##name(const uint8_t * p_buffer, uint16_t num_of_bytes);           \
+    uint32_t ser_phy_rx_buf_set_##name(uint8_t * p_buffer);                                         \
+    uint32_t ser_phy_hci_stats_get_##name(ser_phy_hci_stats_t * p_stats);
+
+/**@brief Definition of the SLIP and app_timer functions called by an instance of ser_phy_hci.c, and
+ *        of the PHY event handler of the instance.
+ */
+#define HCI_INSTANCE_STUBS(name, index)                                                             \
+    uint32_t ser_phy_hci_slip_open_##name(ser_phy_hci_slip_event_handler_t events_handler)         \
+    {                                                                                               \
+        return slip_open(&m_nodes[index], events_handler);                                         \
+    }                                                                                               \
+    uint32_t ser_phy_hci_slip_tx_pkt_send_##name(const ser_phy_hci_pkt_params_t * p_header,        \
+                                                 const ser_phy_hci_pkt_params_t * p_payload,       \
+                                                 const ser_phy_hci_pkt_params_t * p_crc)           \
+    {                                                                                               \
+        return slip_tx_pkt_send(&m_nodes[index], p_header, p_payload, p_crc);                      \
+    }                                                                                               \
+    uint32_t ser_phy_hci_slip_rx_buf_free_##name(uint8_t * p_buffer)                               \
+    {                                                                                               \
+        return slip_rx_buf_free(&m_nodes[index], p_buffer);                                        \
+    }                                                                                               \
+    void ser_phy_hci_slip_close_##name(void)                                                        \
+    {                                                                                               \
+        m_nodes[index].slip_handler = NULL;                                                         \
+    }                                                                                               \
+    uint32_t app_timer_create_##name(app_timer_id_t const *      p_timer_id,                       \
+                                     app_timer_mode_t            mode,                             \
+                                     app_timer_timeout_handler_t timeout_handler)                  \
+    {                                                                                               \
+        m_nodes[index].timer_handler = timeout_handler;                                             \
+        return NRF_SUCCESS;                                                                         \
+    }                                                                                               \
+    uint32_t app_timer_start_##name(app_timer_id_t timer_id, uint32_t timeout_ticks,               \
+                                    void * p_context)                                               \
+    {                                                                                               \
+        return timer_start(&m_nodes[index], timeout_ticks);                                        \
+    }                                                                                               \
+    uint32_t app_timer_stop_##name(app_timer_id_t timer_id)                                        \
+    {                                                                                               \
+        m_nodes[index].timer_armed = false;                                                         \
+        return NRF_SUCCESS;                                                                         \
+    }                                                                                               \
+    uint32_t app_timer_cnt_get_##name(uint32_t * p_ticks)                                          \
+    {                                                                                               \
+        *p_ticks = (uint32_t)((m_now_ns * RTC_FREQ) / 1000000000ull) & 0x00FFFFFF;                  \
+        return NRF_SUCCESS;                                                                         \
+    }                                                                                               \
+    uint32_t app_timer_cnt_diff_compute_##name(uint32_t ticks_to, uint32_t ticks_from,             \
+                                               uint32_t * p_ticks_diff)                             \
+    {                                                                                               \
+        *p_ticks_diff = (ticks_to - ticks_from) & 0x00FFFFFF;                                       \
+        return NRF_SUCCESS;                                                                         \
+    }                                                                                               \
+    static void phy_events_handler_##name(ser_phy_evt_t event)                                     \
+    {                                                                                               \
+        phy_event_handle(&m_nodes[index], &event);                                                 \
+    }
+
+#define HCI_INSTANCE(name, window)                                                                  \
+    {#name, window, ser_phy_open_##name, ser_phy_close_##name, ser_phy_tx_pkt_send_##name,         \
+     ser_phy_rx_buf_set_##name, ser_phy_hci_stats_get_##name, phy_events_handler_##name}
+
+/**@brief Instance of ser_phy_hci.c. */
+typedef struct
+{
+    char const *             p_name;
+    uint32_t                 window;        /**< SER_PHY_HCI_WINDOW_SIZE of the instance. */
+    uint32_t               (*open)(ser_phy_events_handler_t events_handler);
+    void                   (*close)(void);
+    uint32_t               (*tx_pkt_send)(const uint8_t * p_buffer, uint16_t num_of_bytes);
+    uint32_t               (*rx_buf_set)(uint8_t * p_buffer);
+    uint32_t               (*stats_get)(ser_phy_hci_stats_t * p_stats);
+    ser_phy_events_handler_t events_handler;
+} hci_instance_t;
+
+/**@brief Frame on the link. */
+typedef struct
+{
+    uint64_t time_ns;                   /**< End of reception by the peer. */
+    uint16_t len;
+    uint8_t  data[MAX_FRAME_SIZE];
+} frame_t;
+
+/**@brief Peer, with its SLIP layer, timer, link to the other peer and upper layer. */
+typedef struct
+{
+    hci_instance_t const *           p_inst;
+    uint32_t                         peer;
+
+    /* SLIP transmitter: frame being transmitted and frame pending. */
+    ser_phy_hci_slip_event_handler_t slip_handler;
+    ser_phy_hci_pkt_params_t         tx_parts[2][3];
+    bool                             tx_busy;
+    bool                             tx_pending;
+    uint64_t                         tx_end_ns;
+    uint8_t                          tx_frame[MAX_FRAME_SIZE];   /**< Copy taken at the start of the transmission. */
+    uint16_t                         tx_frame_len;
+
+    /* Link to the peer. */
+    frame_t                          frames[FRAME_QUEUE_SIZE];
+    uint32_t                         frame_head;
+    uint32_t                         frame_count;
+    uint32_t                         frames_queued; /**< Frames queued to this node since the start of the run. */
+    uint64_t                         last_frame_ns; /**< End of reception of the last frame queued. */
+
+    /* SLIP receiver. */
+    uint8_t                          small_buf[PKT_HDR_SIZE];
+    uint8_t                          big_buf[MAX_FRAME_SIZE];
+    bool                             small_free;
+    bool                             big_free;
+
+    /* app_timer. */
+    app_timer_timeout_handler_t      timer_handler;
+    bool                             timer_armed;
+    uint64_t                         timer_expiry_ns;
+
+    /* Upper layer. */
+    bool                             is_link_up;    /**< CONFIG and CONFIG_RSP were received. */
+    bool                             config_rx;
+    bool                             config_rsp_rx;
+    bool                             tx_pkt_busy;
+    uint32_t                         tx_pkt_count;
+    uint32_t                         rx_pkt_count;
+    uint32_t                         rx_bytes;
+    uint32_t                         hw_errors;
+    uint32_t                         rx_pkt_dropped;
+    uint8_t                          tx_pkt[SER_HAL_TRANSPORT_MAX_PKT_SIZE];
+    uint8_t                          rx_pkt[SER_HAL_TRANSPORT_MAX_PKT_SIZE];
+
+    /* Frames seen on the link. */
+    uint8_t                          config_field;  /**< Configuration field of the CONFIG packets sent. */
+    uint8_t                          next_seq;      /**< Sequence number of the next new data packet. */
+    uint8_t                          acked_seq;     /**< Acknowledgement number received from the peer. */
+    uint32_t                         max_in_flight;
+    uint32_t                         retx_frames;
+    uint32_t                         cumulative_acks; /**< Acknowledgements of more than one packet. */
+    uint32_t                         rx_overruns;   /**< Frames lost as no RX buffer was free. */
+    uint32_t                         frames_lost;
+
+    /* Model of the retransmission timer, from the data packets passed to SLIP. */
+    uint8_t                          handed_seq;    /**< Sequence number of the next new data packet passed to SLIP. */
+    uint8_t                          tx_count[SEQ_COUNT];   /**< Number of times each packet was passed to SLIP. */
+    bool                             tx_ended[SEQ_COUNT];   /**< The last transmission of each packet has ended. */
+    bool                             timed_out[SEQ_COUNT];  /**< A timeout expired since each packet was last passed to SLIP. */
+    uint64_t                         first_end_ns[SEQ_COUNT]; /**< End of the first transmission of each packet. */
+    uint32_t                         timeouts;
+    uint32_t                         spurious_timeouts;
+    uint32_t                         rtt_samples;   /**< Response times measured (Karn's rule). */
+    uint32_t                         rtt_min_us;
+    uint32_t                         rtt_max_us;
+} node_t;
+
+/**@brief Pair of instances and link parameters of a run. */
+typedef struct
+{
+    uint32_t inst_a;
+    uint32_t inst_b;
+    uint32_t loss_permille;
+    uint32_t latency_us;
+    uint32_t stall_us;      /**< Delay added to every STALL_INTERVAL-th frame. */
+} run_t;
+
+HCI_INSTANCE_API(1_a)
+HCI_INSTANCE_API(1_b)
+HCI_INSTANCE_API(4_a)
+HCI_INSTANCE_API(4_b)
+HCI_INSTANCE_API(7_a)
+HCI_INSTANCE_API(3_b)
+
+static uint32_t slip_open(node_t * p_node, ser_phy_hci_slip_event_handler_t events_handler);
+static uint32_t slip_tx_pkt_send(node_t                         * p_node,
+                                 const ser_phy_hci_pkt_params_t * p_header,
+                                 const ser_phy_hci_pkt_params_t * p_payload,
+                                 const ser_phy_hci_pkt_params_t * p_crc);
+static uint32_t slip_rx_buf_free(node_t * p_node, uint8_t * p_buffer);
+static uint32_t timer_start(node_t * p_node, uint32_t timeout_ticks);
+static void     phy_event_handle(node_t * p_node, ser_phy_evt_t const * p_event);
+
+enum
+{
+    INST_1_A,
+    INST_1_B,
+    INST_4_A,
+    INST_4_B,
+    INST_7_A,
+    INST_3_B,
+    INST_COUNT
+};
+
+static node_t   m_nodes[INST_COUNT];
+static uint64_t m_now_ns;
+static uint32_t m_loss_permille;
+static uint64_t m_latency_ns;
+static uint64_t m_stall_ns;
+static uint32_t m_failures;
+static uint64_t m_rand_state = 88172645463325252ULL;
+
+HCI_INSTANCE_STUBS(1_a, INST_1_A)
+HCI_INSTANCE_STUBS(1_b, INST_1_B)
+HCI_INSTANCE_STUBS(4_a, INST_4_A)
+HCI_INSTANCE_STUBS(4_b, INST_4_B)
+HCI_INSTANCE_STUBS(7_a, INST_7_A)
+HCI_INSTANCE_STUBS(3_b, INST_3_B)
+
+static hci_instance_t const m_instances[INST_COUNT] =
+{
+    HCI_INSTANCE(1_a, 1),
+    HCI_INSTANCE(1_b, 1),
+    HCI_INSTANCE(4_a, 4),
+    HCI_INSTANCE(4_b, 4),
+    HCI_INSTANCE(7_a, 7),
+    HCI_INSTANCE(3_b, 3),
+};
+
+/* Stop-and-wait, sliding window, window agreed with CONFIG, and sliding window with a stop-and-wait
+ * peer, each with and without latency and loss, then with stalls. */
+static run_t const m_runs[] =
+{
+    {INST_1_A, INST_1_B,  0,    0}, {INST_1_A, INST_1_B,  0,  500}, {INST_1_A, INST_1_B,  0, 2000},
+    {INST_1_A, INST_1_B, 10,  500}, {INST_1_A, INST_1_B, 20,  500}, {INST_1_A, INST_1_B, 20, 2000},
+    {INST_4_A, INST_4_B,  0,    0}, {INST_4_A, INST_4_B,  0,  500}, {INST_4_A, INST_4_B,  0, 2000},
+    {INST_4_A, INST_4_B, 10,  500}, {INST_4_A, INST_4_B, 20,  500}, {INST_4_A, INST_4_B, 20, 2000},
+    {INST_7_A, INST_3_B,  0,    0}, {INST_7_A, INST_3_B,  0,  500}, {INST_7_A, INST_3_B,  0, 2000},
+    {INST_7_A, INST_3_B, 10,  500}, {INST_7_A, INST_3_B, 20,  500}, {INST_7_A, INST_3_B, 20, 2000},
+    {INST_4_A, INST_1_B,  0,    0}, {INST_4_A, INST_1_B,  0,  500}, {INST_4_A, INST_1_B, 20,  500},
+    {INST_1_A, INST_1_B,  0,  500, 15000}, {INST_4_A, INST_4_B,  0,  500, 15000},
+    {INST_7_A, INST_3_B, 10,  500, 15000},
+};
+
+static uint32_t rand_get(void)
+{
+    m_rand_state ^= m_rand_state << 13;
+    m_rand_state ^= m_rand_state >> 7;
+    m_rand_state ^= m_rand_state << 17;
+
+    return (uint32_t)m_rand_state;
+}
+
+
+static void check(bool condition, char const * p_what, uint32_t value)
+{
+    if (!condition)
+    {
+        if (m_failures < 10)
+        {
+            printf("%s (%u)\n", p_what, (unsigned int)value);
+        }
+        m_failures++;
+    }
+}
+
+
+/**@brief Function for generating packet number index sent by a node.
+ *
+ * @return Packet length.
+ */
+static uint16_t packet_generate(uint32_t node, uint32_t index, uint8_t * p_pkt)
+{
+    uint64_t state = ((uint64_t)(node + 1) << 32) ^ (index * 2654435761u) ^ 0x9E3779B97F4A7C15ull;
+    uint16_t len;
+    uint32_t i;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    len    = (uint16_t)(1 + (state % SER_HAL_TRANSPORT_MAX_PKT_SIZE));
+
+    for (i = 0; i < len; i++)
+    {
+        state   ^= state << 13;
+        state   ^= state >> 7;
+        state   ^= state << 17;
+        p_pkt[i] = (uint8_t)state;
+    }
+
+    return len;
+}
+
+
+static bool header_valid(uint8_t const * p_frame, uint32_t len)
+{
+    return (len >= PKT_HDR_SIZE) &&
+           (((p_frame[0] + p_frame[1] + p_frame[2] + p_frame[3]) & 0xFFu) == 0);
+}
+
+
+/**@brief Function for recording a frame sent by a node, as it starts on the link. */
+static void frame_sent_record(node_t * p_node, uint8_t const * p_frame, uint32_t len)
+{
+    uint8_t type = p_frame[1] & 0x0F;
+
+    if ((type == PKT_TYPE_DATA) && (p_frame[0] & 0x80))
+    {
+        uint8_t seq = p_frame[0] & 0x07;
+
+        if (seq == p_node->next_seq)
+        {
+            p_node->max_in_flight = MAX(p_node->max_in_flight,
+                                        ((uint32_t)(seq - p_node->acked_seq) & 0x07) + 1);
+            p_node->next_seq      = (seq + 1) & 0x07;
+        }
+        else
+        {
+            p_node->retx_frames++;
+        }
+    }
+    else if ((type == PKT_TYPE_LINK_CTRL) && (len == PKT_HDR_SIZE + 3) &&
+             (uint16_decode(&p_frame[PKT_HDR_SIZE]) == LINK_CTRL_CONFIG))
+    {
+        p_node->config_field = p_frame[PKT_HDR_SIZE + 2];
+    }
+}
+
+
+/**@brief Function for recording a data packet passed to SLIP by a node. */
+static void frame_handover_record(node_t * p_node, uint8_t const * p_header)
+{
+    uint8_t seq = p_header[0] & 0x07;
+
+    if (((p_header[1] & 0x0F) != PKT_TYPE_DATA) || !(p_header[0] & 0x80))
+    {
+        return;
+    }
+
+    if (seq == p_node->handed_seq)
+    {
+        p_node->tx_count[seq] = 1;
+        p_node->handed_seq    = (seq + 1) & 0x07;
+    }
+    else
+    {
+        p_node->tx_count[seq]++;
+    }
+    p_node->tx_ended[seq]  = false;
+    p_node->timed_out[seq] = false;
+}
+
+
+/**@brief Function for recording the end of the transmission of the current frame of a node. */
+static void frame_end_record(node_t * p_node)
+{
+    uint8_t const * p_frame = p_node->tx_frame;
+    uint8_t         seq     = p_frame[0] & 0x07;
+
+    if (((p_frame[1] & 0x0F) == PKT_TYPE_DATA) && (p_frame[0] & 0x80))
+    {
+        p_node->tx_ended[seq] = true;
+        if (p_node->tx_count[seq] == 1)
+        {
+            p_node->first_end_ns[seq] = m_now_ns;
+        }
+    }
+}
+
+
+/**@brief Function for recording the expiry of the retransmission timer of a node. Every packet
+ *        passed to SLIP and not acknowledged is sent again.
+ */
+static void timeout_record(node_t * p_node)
+{
+    uint8_t seq;
+
+    // Before the link is up, the timer is used to send link control packets.
+    if (!p_node->is_link_up || (p_node->acked_seq == p_node->handed_seq))
+    {
+        return;
+    }
+
+    p_node->timeouts++;
+    for (seq = p_node->acked_seq; seq != p_node->handed_seq; seq = (seq + 1) & 0x07)
+    {
+        p_node->timed_out[seq] = true;
+    }
+}
+
+
+/**@brief Function for recording the response time of a packet. */
+static void rtt_record(node_t * p_node, uint32_t rtt_us)
+{
+    p_node->rtt_samples++;
+    p_node->rtt_min_us = MIN(p_node->rtt_min_us, rtt_us);
+    p_node->rtt_max_us = MAX(p_node->rtt_max_us, rtt_us);
+}
+
+
+/**@brief Function for recording a frame received by a node, before the node processes it. */
+static void frame_received_record(node_t * p_node, uint8_t const * p_frame, uint32_t len)
+{
+    uint8_t type = p_frame[1] & 0x0F;
+
+    if (!header_valid(p_frame, len))
+    {
+        return;
+    }
+
+    if ((type == PKT_TYPE_ACK) && (len == PKT_HDR_SIZE))
+    {
+        uint32_t acked     = ((p_frame[0] >> 3) - p_node->acked_seq) & 0x07;
+        uint32_t in_flight = (p_node->next_seq - p_node->acked_seq) & 0x07;
+
+        // Acknowledgements of packets which were not sent are ignored, as by the PHY.
+        if ((acked > 0) && (acked <= in_flight))
+        {
+            bool     spurious = false;
+            uint32_t i;
+
+            for (i = 0; i < acked; i++)
+            {
+                uint8_t seq = (p_node->acked_seq + i) & 0x07;
+
+                if (p_node->timed_out[seq] || !p_node->tx_ended[seq])
+                {
+                    // The acknowledgement was sent for a transmission before the timeout.
+                    spurious = true;
+                }
+                else if (p_node->tx_count[seq] == 1)
+                {
+                    rtt_record(p_node, (uint32_t)((m_now_ns - p_node->first_end_ns[seq]) / 1000));
+                }
+            }
+
+            p_node->spurious_timeouts += spurious ? 1 : 0;
+            p_node->cumulative_acks   += (acked > 1) ? 1 : 0;
+            p_node->acked_seq        = (p_node->acked_seq + acked) & 0x07;
+        }
+    }
+    else if ((type == PKT_TYPE_LINK_CTRL) && (len == PKT_HDR_SIZE + 3))
+    {
+        if (uint16_decode(&p_frame[PKT_HDR_SIZE]) == LINK_CTRL_CONFIG)
+        {
+            p_node->config_rx = true;
+        }
+        else if (uint16_decode(&p_frame[PKT_HDR_SIZE]) == LINK_CTRL_CONFIG_RSP)
+        {
+            p_node->config_rsp_rx = true;
+        }
+        p_node->is_link_up = p_node->config_rx && p_node->config_rsp_rx;
+    }
+}
+
+
+/**@brief Function for starting the transmission of the current frame of a node. */
+static void slip_tx_start(node_t * p_node)
+{
+    uint32_t len     = 0;
+    uint32_t escapes = 0;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < 3; i++)
+    {
+        ser_phy_hci_pkt_params_t const * p_part = &p_node->tx_parts[0][i];
+
+        if (p_part->p_buffer == NULL)
+        {
+            continue;
+        }
+        for (j = 0; j < p_part->num_of_bytes; j++)
+        {
+            uint8_t byte = p_part->p_buffer[j];
+
+            p_node->tx_frame[len++] = byte;
+            escapes                += ((byte == SLIP_END) || (byte == SLIP_ESC)) ? 1 : 0;
+        }
+    }
+
+    p_node->tx_frame_len = (uint16_t)len;
+    p_node->tx_end_ns    = m_now_ns + (2 + len + escapes) * NS_PER_BYTE;
+    p_node->tx_busy      = true;
+    frame_sent_record(p_node, p_node->tx_frame, len);
+}
+
+
+static uint32_t slip_open(node_t * p_node, ser_phy_hci_slip_event_handler_t events_handler)
+{
+    p_node->slip_handler = events_handler;
+    p_node->tx_busy      = false;
+    p_node->tx_pending   = false;
+    p_node->small_free   = true;
+    p_node->big_free     = true;
+    p_node->frame_head   = 0;
+    p_node->frame_count  = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+static uint32_t slip_tx_pkt_send(node_t                         * p_node,
+                                 const ser_phy_hci_pkt_params_t * p_header,
+                                 const ser_phy_hci_pkt_params_t * p_payload,
+                                 const ser_phy_hci_pkt_params_t * p_crc)
+{
+    ser_phy_hci_pkt_params_t * p_parts;
+
+    // ser_phy_hci_slip.c has a single pending frame, which would be overwritten.
+    check(!p_node->tx_pending, "SLIP pending frame overwritten", (uint32_t)(p_node - m_nodes));
+    frame_handover_record(p_node, p_header->p_buffer);
+
+    p_parts    = p_node->tx_parts[p_node->tx_busy ? 1 : 0];
+    p_parts[0] = *p_header;
+    memset(&p_parts[1], 0, 2 * sizeof(p_parts[1]));
+    if (p_payload != NULL)
+    {
+        p_parts[1] = *p_payload;
+    }
+    if (p_crc != NULL)
+    {
+        p_parts[2] = *p_crc;
+    }
+
+    if (p_node->tx_busy)
+    {
+        p_node->tx_pending = true;
+    }
+    else
+    {
+        slip_tx_start(p_node);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+static uint32_t slip_rx_buf_free(node_t * p_node, uint8_t * p_buffer)
+{
+    bool * p_free = NULL;
+
+    if (p_buffer == p_node->small_buf)
+    {
+        p_free = &p_node->small_free;
+    }
+    else if (p_buffer == p_node->big_buf)
+    {
+        p_free = &p_node->big_free;
+    }
+    check(p_free != NULL, "unknown RX buffer freed", (uint32_t)(p_node - m_nodes));
+    if ((p_free == NULL) || *p_free)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    *p_free = true;
+
+    return NRF_SUCCESS;
+}
+
+
+static uint32_t timer_start(node_t * p_node, uint32_t timeout_ticks)
+{
+    // A running timer is not restarted by app_timer_start.
+    if (!p_node->timer_armed)
+    {
+        p_node->timer_armed     = true;
+        p_node->timer_expiry_ns = m_now_ns + CEIL_DIV(timeout_ticks * 1000000000ull, RTC_FREQ);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for ending the transmission of the current frame of a node. The frame is sent to
+ *        the peer, unless it is lost.
+ */
+static void slip_tx_end(node_t * p_node)
+{
+    node_t                 * p_peer = &m_nodes[p_node->peer];
+    ser_phy_hci_slip_evt_t   event;
+    bool                     is_ack = (p_node->tx_parts[0][1].p_buffer == NULL);
+    uint8_t                  type   = p_node->tx_frame[1] & 0x0F;
+    uint32_t                 i;
+    uint32_t                 len    = 0;
+
+    frame_end_record(p_node);
+
+    // The frame is read from the buffers of the PHY during the whole transmission.
+    for (i = 0; i < 3; i++)
+    {
+        ser_phy_hci_pkt_params_t const * p_part = &p_node->tx_parts[0][i];
+
+        if (p_part->p_buffer != NULL)
+        {
+            check(memcmp(&p_node->tx_frame[len], p_part->p_buffer, p_part->num_of_bytes) == 0,
+                  "frame changed during transmission", (uint32_t)(p_node - m_nodes));
+            len += p_part->num_of_bytes;
+        }
+    }
+
+    if ((rand_get() % 1000) < m_loss_permille)
+    {
+        p_node->frames_lost++;
+
+        // Link control packets have no CRC, so they are only lost, not corrupted.
+        if ((type != PKT_TYPE_LINK_CTRL) && ((rand_get() % 2) == 0))
+        {
+            p_node->tx_frame[rand_get() % p_node->tx_frame_len] ^= (uint8_t)(1 + rand_get() % 255);
+        }
+        else
+        {
+            p_node->tx_frame_len = 0;
+        }
+    }
+
+    if (p_node->tx_frame_len > 0)
+    {
+        frame_t * p_frame;
+        uint64_t  time_ns = m_now_ns + m_latency_ns;
+
+        // A stalled frame holds back the frames behind it.
+        p_peer->frames_queued++;
+        if ((p_peer->frames_queued % STALL_INTERVAL) == 0)
+        {
+            time_ns += m_stall_ns;
+        }
+        time_ns               = MAX(time_ns, p_peer->last_frame_ns);
+        p_peer->last_frame_ns = time_ns;
+
+        check(p_peer->frame_count < FRAME_QUEUE_SIZE, "link queue full", p_node->peer);
+        p_frame          = &p_peer->frames[(p_peer->frame_head + p_peer->frame_count) %
+                                           FRAME_QUEUE_SIZE];
+        p_frame->time_ns = time_ns;
+        p_frame->len     = p_node->tx_frame_len;
+        memcpy(p_frame->data, p_node->tx_frame, p_node->tx_frame_len);
+        p_peer->frame_count++;
+    }
+
+    // As ser_phy_hci_slip.c, the pending frame is started before the end is reported.
+    p_node->tx_busy = false;
+    if (p_node->tx_pending)
+    {
+        p_node->tx_pending = false;
+        memcpy(p_node->tx_parts[0], p_node->tx_parts[1], sizeof(p_node->tx_parts[0]));
+        slip_tx_start(p_node);
+    }
+
+    if (p_node->slip_handler != NULL)
+    {
+        event.evt_type = is_ack ? SER_PHY_HCI_SLIP_EVT_ACK_SENT : SER_PHY_HCI_SLIP_EVT_PKT_SENT;
+        p_node->slip_handler(&event);
+    }
+}
+
+
+/**@brief Function for passing the oldest frame on the link to a node. */
+static void slip_rx(node_t * p_node)
+{
+    frame_t              * p_frame = &p_node->frames[p_node->frame_head];
+    ser_phy_hci_slip_evt_t event;
+    uint8_t              * p_buf   = NULL;
+
+    p_node->frame_head = (p_node->frame_head + 1) % FRAME_QUEUE_SIZE;
+    p_node->frame_count--;
+
+    // The small buffer is used for acknowledgements if it is free, as in ser_phy_hci_slip.c.
+    if ((p_frame->len <= sizeof(p_node->small_buf)) && p_node->small_free)
+    {
+        p_buf              = p_node->small_buf;
+        p_node->small_free = false;
+    }
+    else if (p_node->big_free)
+    {
+        p_buf            = p_node->big_buf;
+        p_node->big_free = false;
+    }
+
+    if ((p_buf == NULL) || (p_node->slip_handler == NULL))
+    {
+        p_node->rx_overruns++;
+        return;
+    }
+
+    memcpy(p_buf, p_frame->data, p_frame->len);
+    frame_received_record(p_node, p_buf, p_frame->len);
+
+    event.evt_type                                = SER_PHY_HCI_SLIP_EVT_PKT_RECEIVED;
+    event.evt_params.received_pkt.p_buffer        = p_buf;
+    event.evt_params.received_pkt.num_of_bytes    = p_frame->len;
+    p_node->slip_handler(&event);
+}
+
+
+static void phy_event_handle(node_t * p_node, ser_phy_evt_t const * p_event)
+{
+    uint32_t node = (uint32_t)(p_node - m_nodes);
+    uint8_t  expected[SER_HAL_TRANSPORT_MAX_PKT_SIZE];
+    uint16_t len;
+
+    switch (p_event->evt_type)
+    {
+        case SER_PHY_EVT_TX_PKT_SENT:
+            p_node->tx_pkt_busy = false;
+            break;
+
+        case SER_PHY_EVT_RX_BUF_REQUEST:
+            check(p_event->evt_params.rx_buf_request.num_of_bytes <= sizeof(p_node->rx_pkt),
+                  "RX buffer request", p_event->evt_params.rx_buf_request.num_of_bytes);
+            check(p_node->p_inst->rx_buf_set(p_node->rx_pkt) == NRF_SUCCESS, "RX buffer set", node);
+            break;
+
+        case SER_PHY_EVT_RX_PKT_RECEIVED:
+            len = packet_generate(p_node->peer, p_node->rx_pkt_count, expected);
+            check((p_event->evt_params.rx_pkt_received.num_of_bytes == len) &&
+                  (memcmp(p_event->evt_params.rx_pkt_received.p_buffer, expected, len) == 0),
+                  "packet received out of order or corrupted", p_node->rx_pkt_count);
+            p_node->rx_pkt_count++;
+            p_node->rx_bytes += p_event->evt_params.rx_pkt_received.num_of_bytes;
+            break;
+
+        case SER_PHY_EVT_RX_PKT_DROPPED:
+            p_node->rx_pkt_dropped++;
+            break;
+
+        case SER_PHY_EVT_HW_ERROR:
+            p_node->hw_errors++;
+            p_node->tx_pkt_busy = false;
+            break;
+
+        default:
+            check(false, "unexpected PHY event", p_event->evt_type);
+            break;
+    }
+}
+
+
+/**@brief Function for passing the next packet of a node to the PHY, as the upper layer does from
+ *        the main loop.
+ */
+static void upper_layer_process(node_t * p_node)
+{
+    uint16_t len;
+
+    if (!p_node->is_link_up || p_node->tx_pkt_busy || (p_node->tx_pkt_count == PACKET_COUNT))
+    {
+        return;
+    }
+
+    // In window mode, the packet is reported as sent before ser_phy_tx_pkt_send returns.
+    len                 = packet_generate((uint32_t)(p_node - m_nodes), p_node->tx_pkt_count,
+                                          p_node->tx_pkt);
+    p_node->tx_pkt_busy = true;
+    if (p_node->p_inst->tx_pkt_send(p_node->tx_pkt, len) == NRF_SUCCESS)
+    {
+        p_node->tx_pkt_count++;
+    }
+    else
+    {
+        p_node->tx_pkt_busy = false;
+    }
+}
+
+
+static void node_open(uint32_t node, uint32_t peer)
+{
+    node_t * p_node = &m_nodes[node];
+
+    memset(p_node, 0, sizeof(*p_node));
+    p_node->p_inst     = &m_instances[node];
+    p_node->peer       = peer;
+    p_node->rtt_min_us = UINT32_MAX;
+
+    check(p_node->p_inst->open(p_node->p_inst->events_handler) == NRF_SUCCESS, "open", node);
+}
+
+
+/**@brief Function for processing the next event of the simulation: the end of a transmission, the
+ *        reception of a frame or a timeout.
+ *
+ * @return false if no event is pending.
+ */
+static bool event_process(uint32_t const * p_nodes)
+{
+    node_t * p_next = NULL;
+    uint32_t kind   = 0;
+    uint64_t next   = UINT64_MAX;
+    uint32_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        node_t * p_node = &m_nodes[p_nodes[i]];
+
+        if (p_node->tx_busy && (p_node->tx_end_ns < next))
+        {
+            next   = p_node->tx_end_ns;
+            p_next = p_node;
+            kind   = 0;
+        }
+        if ((p_node->frame_count > 0) && (p_node->frames[p_node->frame_head].time_ns < next))
+        {
+            next   = p_node->frames[p_node->frame_head].time_ns;
+            p_next = p_node;
+            kind   = 1;
+        }
+        if (p_node->timer_armed && (p_node->timer_expiry_ns < next))
+        {
+            next   = p_node->timer_expiry_ns;
+            p_next = p_node;
+            kind   = 2;
+        }
+    }
+
+    if (p_next == NULL)
+    {
+        return false;
+    }
+
+    m_now_ns = next;
+    switch (kind)
+    {
+        case 0:
+            slip_tx_end(p_next);
+            break;
+
+        case 1:
+            slip_rx(p_next);
+            break;
+
+        default:
+            p_next->timer_armed = false;
+            timeout_record(p_next);
+            p_next->timer_handler(NULL);
+            break;
+    }
+
+    return true;
+}
+
+
+static bool run_done(uint32_t const * p_nodes)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        node_t const * p_node = &m_nodes[p_nodes[i]];
+
+        if ((p_node->rx_pkt_count < PACKET_COUNT) || (p_node->tx_pkt_count < PACKET_COUNT) ||
+            p_node->tx_pkt_busy || (p_node->next_seq != p_node->acked_seq))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void run(run_t const * p_run)
+{
+    uint32_t const      nodes[2] = {p_run->inst_a, p_run->inst_b};
+    uint32_t            window   = MIN(m_instances[nodes[0]].window, m_instances[nodes[1]].window);
+    ser_phy_hci_stats_t stats_before[2];
+    ser_phy_hci_stats_t stats;
+    uint64_t            start_ns = 0;
+    uint32_t            bytes    = 0;
+    uint32_t            retx     = 0;
+    uint32_t            overruns = 0;
+    uint32_t            spurious = 0;
+    uint32_t            i;
+
+    m_now_ns        = 0;
+    m_loss_permille = p_run->loss_permille;
+    m_latency_ns    = p_run->latency_us * 1000ull;
+    m_stall_ns      = p_run->stall_us * 1000ull;
+
+    for (i = 0; i < 2; i++)
+    {
+        (void)m_instances[nodes[i]].stats_get(&stats_before[i]);
+        node_open(nodes[i], nodes[1 - i]);
+    }
+
+    // The run ends when all packets are received, and acknowledged so that the PHY is idle.
+    while (!run_done(nodes))
+    {
+        if ((start_ns == 0) && m_nodes[nodes[0]].is_link_up && m_nodes[nodes[1]].is_link_up)
+        {
+            start_ns = m_now_ns;
+        }
+        upper_layer_process(&m_nodes[nodes[0]]);
+        upper_layer_process(&m_nodes[nodes[1]]);
+
+        if ((m_now_ns > RUN_TIME_LIMIT_NS) || !event_process(nodes))
+        {
+            check(false, "packets not delivered", m_nodes[nodes[0]].rx_pkt_count);
+            break;
+        }
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        node_t * p_node = &m_nodes[nodes[i]];
+
+        (void)p_node->p_inst->stats_get(&stats);
+        p_node->p_inst->close();
+
+        bytes    += p_node->rx_bytes;
+        retx     += p_node->retx_frames;
+        overruns += p_node->rx_overruns;
+        spurious += p_node->spurious_timeouts;
+
+        check(p_node->hw_errors == 0, "TX errors", p_node->hw_errors);
+        check(p_node->rx_pkt_dropped == 0, "RX packets dropped", p_node->rx_pkt_dropped);
+
+        // CONFIG carries the window size of the instance, and the agreed window is not exceeded.
+        check(p_node->config_field == (CONFIG_FIELD_BASE | p_node->p_inst->window),
+              "CONFIG field", p_node->config_field);
+        check(p_node->max_in_flight <= window, "packets in flight", p_node->max_in_flight);
+
+        // Each frame sent again on the link is counted by the PHY.
+        check(stats.retransmissions - stats_before[i].retransmissions == p_node->retx_frames,
+              "retransmissions", stats.retransmissions - stats_before[i].retransmissions);
+        check(stats.spurious_timeouts - stats_before[i].spurious_timeouts ==
+              p_node->spurious_timeouts, "spurious timeouts",
+              stats.spurious_timeouts - stats_before[i].spurious_timeouts);
+
+        // Samples which could be matched with a single transmission move SRTT into their range,
+        // and the others are not measured, so SRTT stays there. RTTVAR follows their spread.
+        check(p_node->rtt_samples > 0, "no response time measured", nodes[i]);
+        check((stats.srtt_us + RTT_TOLERANCE_US >= p_node->rtt_min_us) &&
+              (stats.srtt_us <= p_node->rtt_max_us + RTT_TOLERANCE_US),
+              "SRTT out of the range of the unambiguous response times", stats.srtt_us);
+        check(stats.rttvar_us <= p_node->rtt_max_us - p_node->rtt_min_us + RTT_TOLERANCE_US,
+              "RTTVAR above the spread of the response times", stats.rttvar_us);
+        check(stats.rto_us > stats.srtt_us, "RTO below SRTT", stats.rto_us);
+
+        if ((p_run->loss_permille == 0) && (p_node->rx_overruns == 0) &&
+            (m_nodes[p_node->peer].rx_overruns == 0) && (p_run->stall_us == 0))
+        {
+            // Frames are only late when the acknowledgement waits behind a packet of the peer.
+            check(p_node->timeouts == 0, "timeout on a link without loss", p_node->timeouts);
+        }
+        if (p_run->stall_us > 0)
+        {
+            check(p_node->spurious_timeouts > 0, "no spurious timeout", nodes[i]);
+        }
+
+        if (p_run->latency_us >= 500)
+        {
+            // With latency, the whole window is in flight.
+            check(p_node->max_in_flight == window, "window not used", p_node->max_in_flight);
+        }
+        if ((p_run->loss_permille >= 20) && (window > 1))
+        {
+            // Lost frames are sent again, and a lost acknowledgement is covered by the next one.
+            check(p_node->retx_frames > 0, "no retransmission", nodes[i]);
+            check(p_node->cumulative_acks > 0, "no cumulative acknowledgement", nodes[i]);
+        }
+    }
+
+    (void)m_instances[nodes[0]].stats_get(&stats);
+    printf("%-3s %-3s %6u %5u.%u %8u %6u %7.1f %6.1f %%  %6u %8u %8u %7u %7u\n",
+           m_instances[nodes[0]].p_name, m_instances[nodes[1]].p_name, (unsigned int)window,
+           (unsigned int)(p_run->loss_permille / 10), (unsigned int)(p_run->loss_permille % 10),
+           (unsigned int)p_run->latency_us, (unsigned int)p_run->stall_us,
+           (double)bytes * 1000000.0 / (double)(m_now_ns - start_ns),
+           100.0 * (double)bytes * NS_PER_BYTE / (2.0 * (double)(m_now_ns - start_ns)),
+           (unsigned int)retx, (unsigned int)spurious, (unsigned int)overruns,
+           (unsigned int)stats.srtt_us, (unsigned int)stats.rttvar_us);
+}
+
+
+int main(void)
+{
+    uint32_t i;
+
+    printf("HCI loopback, %u packets of 1 to %u bytes in each direction at %u baud\n",
+           PACKET_COUNT, (unsigned int)SER_HAL_TRANSPORT_MAX_PKT_SIZE,
+           (unsigned int)SER_PHY_UART_BAUDRATE_VAL);
+    printf("peers   window loss %% latency  stall   kB/s   line rate  retx  spurious overruns"
+           " srtt us rttvar\n");
+
+    for (i = 0; i < sizeof(m_runs) / sizeof(m_runs[0]); i++)
+    {
+        run(&m_runs[i]);
+    }
+
+    if (m_failures != 0)
+    {
+        printf("ser_hci_loopback: %u checks failed\n", (unsigned int)m_failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,330 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief   Size report and round trip check of the compact wire format.
+ *
+ * @details The Wire Format Set command is first sent to the connectivity middleware, to check that
+ *          the compact format is accepted only when @ref SER_WIRE_FORMAT_COMPACT_ENABLED is set,
+ *          and that the standard format is always accepted.
+ *
+ *          Every event which has a compact encoding is then encoded with the connectivity side
+ *          codecs in both formats and decoded with the application side codecs. The decoded event
+ *          must match the original one. Reported per event: the size of the event packet in both
+ *          formats, including the packet type byte.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_util.h"
+#include "ble.h"
+#include "ble_serialization.h"
+#include "ser_config.h"
+
+/* Connectivity middleware entry point, see conn_mw.h. */
+uint32_t conn_mw_handler(uint8_t const * const p_rx_buf,
+                         uint32_t              rx_buf_len,
+                         uint8_t * const       p_tx_buf,
+                         uint32_t * const      p_tx_buf_len);
+
+/* Encoder of the connectivity side and decoder of the application side, see ble_conn.h and
+ * ble_app.h. The headers are not included together as they declare the same codec names. */
+uint32_t ble_event_enc(ble_evt_t const * const p_event,
+                       uint32_t                event_len,
+                       uint8_t * const         p_buf,
+                       uint32_t * const        p_buf_len);
+
+uint32_t ble_event_dec(uint8_t const * const p_buf,
+                       uint32_t              packet_len,
+                       ble_evt_t * const     p_event,
+                       uint32_t * const      p_event_len);
+
+/** Size of a BLE event buffer, as BLE_STACK_EVT_MSG_BUF_SIZE. */
+#define EVT_BUF_SIZE        (sizeof (ble_evt_t) + GATT_MTU_SIZE_DEFAULT)
+
+#define CONN_HANDLE         0       /**< Connection handle of the GATTS events. */
+
+/**@brief GATTS Write event of the report. */
+typedef struct
+{
+    char const * p_name;        /**< Description of the event. */
+    uint16_t     handle;        /**< Attribute handle. */
+    uint16_t     uuid;          /**< Attribute UUID. */
+    uint8_t      uuid_type;     /**< Attribute UUID type. */
+    uint8_t      op;            /**< Write operation. */
+    uint8_t      auth_required; /**< Authorization required flag. */
+    uint16_t     offset;        /**< Write offset. */
+    uint16_t     len;           /**< Length of the written data. */
+} gatts_write_t;
+
+/**@brief Advertising report event of the report. */
+typedef struct
+{
+    char const * p_name;        /**< Description of the event. */
+    uint16_t     conn_handle;   /**< Connection handle of the event. */
+    uint8_t      scan_rsp;      /**< Scan response flag. */
+    uint8_t      type;          /**< Advertising type. */
+    uint8_t      dlen;          /**< Length of the advertising data. */
+} adv_report_t;
+
+static const gatts_write_t m_gatts_writes[] =
+{
+    {"GATTS write, CCCD",              0x000F, BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG,
+     BLE_UUID_TYPE_BLE,          BLE_GATTS_OP_WRITE_REQ,      0, 0,  2},
+    {"GATTS write command, 20 B",      0x000D, 0x0002,
+     BLE_UUID_TYPE_VENDOR_BEGIN, BLE_GATTS_OP_WRITE_CMD,      0, 0,  20},
+    {"GATTS write command, 1 B",       0x0024, 0x2A06,
+     BLE_UUID_TYPE_BLE,          BLE_GATTS_OP_WRITE_CMD,      0, 0,  1},
+    {"GATTS prepared write, offset",   0x0010, 0x0003,
+     BLE_UUID_TYPE_VENDOR_BEGIN, BLE_GATTS_OP_PREP_WRITE_REQ, 1, 36, 18},
+    {"GATTS write, unknown UUID",      0x0180, 0x0000,
+     BLE_UUID_TYPE_UNKNOWN,      BLE_GATTS_OP_WRITE_REQ,      0, 0,  8},
+};
+
+static const adv_report_t m_adv_reports[] =
+{
+    {"ADV report, ADV_IND, 31 B",      BLE_CONN_HANDLE_INVALID, 0, BLE_GAP_ADV_TYPE_ADV_IND,        31},
+    {"ADV report, scan response, 10 B", BLE_CONN_HANDLE_INVALID, 1, BLE_GAP_ADV_TYPE_ADV_SCAN_IND,   10},
+    {"ADV report, NONCONN_IND, 3 B",   BLE_CONN_HANDLE_INVALID, 0, BLE_GAP_ADV_TYPE_ADV_NONCONN_IND, 3},
+    {"ADV report, during connection",  1,                       0, BLE_GAP_ADV_TYPE_ADV_IND,        31},
+};
+
+static uint32_t m_evt_buf[CEIL_DIV(EVT_BUF_SIZE, sizeof (uint32_t))];
+static uint32_t m_dec_buf[CEIL_DIV(EVT_BUF_SIZE, sizeof (uint32_t))];
+
+/**@brief Function for sending the Wire Format Set command to the connectivity middleware.
+ *
+ * @return Result code of the command response.
+ */
+static uint32_t wire_format_request(ser_wire_format_t format)
+{
+    uint8_t  cmd[SER_HAL_TRANSPORT_APP_TO_CONN_MAX_PKT_SIZE];
+    uint8_t  rsp[SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE];
+    uint32_t cmd_len = sizeof (cmd);
+    uint32_t rsp_len = sizeof (rsp);
+    uint32_t result_code;
+
+    if ((ser_wire_format_set_req_enc(format, cmd, &cmd_len) != NRF_SUCCESS) ||
+        (conn_mw_handler(cmd, cmd_len, rsp, &rsp_len) != NRF_SUCCESS) ||
+        (ser_ble_cmd_rsp_dec(rsp, rsp_len, SER_OP_CODE_WIRE_FORMAT_SET, &result_code) != NRF_SUCCESS))
+    {
+        printf("Wire Format Set command failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return result_code;
+}
+
+/**@brief Function for checking the Wire Format Set command. */
+static void handshake_check(void)
+{
+    uint32_t result_code;
+
+    result_code = wire_format_request(SER_WIRE_FORMAT_COMPACT);
+    if (SER_WIRE_FORMAT_COMPACT_ENABLED)
+    {
+        if ((result_code != NRF_SUCCESS) || (ser_wire_format_get() != SER_WIRE_FORMAT_COMPACT))
+        {
+            printf("Compact format request not accepted.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        if ((result_code != NRF_ERROR_NOT_SUPPORTED) ||
+            (ser_wire_format_get() != SER_WIRE_FORMAT_STANDARD))
+        {
+            printf("Compact format request accepted although not enabled.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    result_code = wire_format_request(SER_WIRE_FORMAT_STANDARD);
+    if ((result_code != NRF_SUCCESS) || (ser_wire_format_get() != SER_WIRE_FORMAT_STANDARD))
+    {
+        printf("Standard format request not accepted.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Wire Format Set: compact format %s, standard format accepted.\n",
+           SER_WIRE_FORMAT_COMPACT_ENABLED ? "accepted" : "rejected (not enabled)");
+}
+
+/**@brief Function for encoding an event in the given format and decoding it back.
+ *
+ * @return Length of the event packet, including the packet type byte.
+ */
+static uint32_t event_round_trip(ble_evt_t const * p_evt, ser_wire_format_t format, ble_evt_t * p_dec)
+{
+    uint8_t  pkt[SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE];
+    uint32_t len     = sizeof (pkt) - SER_PKT_TYPE_SIZE;
+    uint32_t dec_len = EVT_BUF_SIZE;
+
+    ser_wire_format_set(format);
+
+    pkt[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT;
+    if (ble_event_enc(p_evt, 0, &pkt[SER_PKT_OP_CODE_POS], &len) != NRF_SUCCESS)
+    {
+        printf("Event encoding failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(p_dec, 0, EVT_BUF_SIZE);
+    if (ble_event_dec(&pkt[SER_PKT_OP_CODE_POS], len, p_dec, &dec_len) != NRF_SUCCESS)
+    {
+        printf("Event decoding failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ser_wire_format_set(SER_WIRE_FORMAT_STANDARD);
+
+    return SER_PKT_TYPE_SIZE + len;
+}
+
+static bool gatts_write_equal(ble_evt_t const * p_a, ble_evt_t const * p_b)
+{
+    ble_gatts_evt_write_t const * p_wa = &p_a->evt.gatts_evt.params.write;
+    ble_gatts_evt_write_t const * p_wb = &p_b->evt.gatts_evt.params.write;
+
+    return (p_b->header.evt_id == p_a->header.evt_id) &&
+           (p_b->evt.gatts_evt.conn_handle == p_a->evt.gatts_evt.conn_handle) &&
+           (p_wb->handle == p_wa->handle) &&
+           (p_wb->uuid.uuid == p_wa->uuid.uuid) &&
+           (p_wb->uuid.type == p_wa->uuid.type) &&
+           (p_wb->op == p_wa->op) &&
+           (p_wb->auth_required == p_wa->auth_required) &&
+           (p_wb->offset == p_wa->offset) &&
+           (p_wb->len == p_wa->len) &&
+           (memcmp(p_wb->data, p_wa->data, p_wa->len) == 0);
+}
+
+static bool adv_report_equal(ble_evt_t const * p_a, ble_evt_t const * p_b)
+{
+    ble_gap_evt_adv_report_t const * p_ra = &p_a->evt.gap_evt.params.adv_report;
+    ble_gap_evt_adv_report_t const * p_rb = &p_b->evt.gap_evt.params.adv_report;
+
+    return (p_b->header.evt_id == p_a->header.evt_id) &&
+           (p_b->evt.gap_evt.conn_handle == p_a->evt.gap_evt.conn_handle) &&
+           (memcmp(&p_rb->peer_addr, &p_ra->peer_addr, sizeof (p_ra->peer_addr)) == 0) &&
+           (p_rb->rssi == p_ra->rssi) &&
+           (p_rb->scan_rsp == p_ra->scan_rsp) &&
+           (p_rb->type == p_ra->type) &&
+           (p_rb->dlen == p_ra->dlen) &&
+           (memcmp(p_rb->data, p_ra->data, p_ra->dlen) == 0);
+}
+
+/**@brief Function for running one event in both formats and printing its sizes. */
+static void event_report(char const * p_name,
+                         ble_evt_t const * p_evt,
+                         bool (* equal)(ble_evt_t const *, ble_evt_t const *),
+                         uint32_t * p_std_total,
+                         uint32_t * p_compact_total)
+{
+    ble_evt_t * p_dec = (ble_evt_t *)m_dec_buf;
+    uint32_t    std_len;
+    uint32_t    compact_len;
+
+    std_len = event_round_trip(p_evt, SER_WIRE_FORMAT_STANDARD, p_dec);
+    if (!equal(p_evt, p_dec))
+    {
+        printf("%s: standard format round trip mismatch.\n", p_name);
+        exit(EXIT_FAILURE);
+    }
+
+    compact_len = event_round_trip(p_evt, SER_WIRE_FORMAT_COMPACT, p_dec);
+    if (!equal(p_evt, p_dec))
+    {
+        printf("%s: compact format round trip mismatch.\n", p_name);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-34s %8u %8u %8d\n", p_name, (unsigned int)std_len, (unsigned int)compact_len,
+           (int)std_len - (int)compact_len);
+
+    *p_std_total     += std_len;
+    *p_compact_total += compact_len;
+}
+
+int main(void)
+{
+    ble_evt_t * p_evt         = (ble_evt_t *)m_evt_buf;
+    uint32_t    std_total     = 0;
+    uint32_t    compact_total = 0;
+    uint32_t    i;
+    uint32_t    j;
+
+    handshake_check();
+
+    printf("\n%-34s %8s %8s %8s\n", "event", "standard", "compact", "saved");
+
+    for (i = 0; i < sizeof (m_gatts_writes) / sizeof (m_gatts_writes[0]); i++)
+    {
+        gatts_write_t const   * p_params = &m_gatts_writes[i];
+        ble_gatts_evt_write_t * p_write  = &p_evt->evt.gatts_evt.params.write;
+
+        memset(m_evt_buf, 0, sizeof (m_evt_buf));
+        p_evt->header.evt_id          = BLE_GATTS_EVT_WRITE;
+        p_evt->header.evt_len         = (uint16_t)(offsetof(ble_evt_t, evt.gatts_evt.params.write.data) -
+                                                   sizeof (ble_evt_hdr_t) + p_params->len);
+        p_evt->evt.gatts_evt.conn_handle = CONN_HANDLE;
+        p_write->handle               = p_params->handle;
+        p_write->uuid.uuid            = p_params->uuid;
+        p_write->uuid.type            = p_params->uuid_type;
+        p_write->op                   = p_params->op;
+        p_write->auth_required        = p_params->auth_required;
+        p_write->offset               = p_params->offset;
+        p_write->len                  = p_params->len;
+        for (j = 0; j < p_params->len; j++)
+        {
+            p_write->data[j] = (uint8_t)(0x30 + j);
+        }
+
+        event_report(p_params->p_name, p_evt, gatts_write_equal, &std_total, &compact_total);
+    }
+
+    for (i = 0; i < sizeof (m_adv_reports) / sizeof (m_adv_reports[0]); i++)
+    {
+        adv_report_t const       * p_params = &m_adv_reports[i];
+        ble_gap_evt_adv_report_t * p_report = &p_evt->evt.gap_evt.params.adv_report;
+
+        memset(m_evt_buf, 0, sizeof (m_evt_buf));
+        p_evt->header.evt_id             = BLE_GAP_EVT_ADV_REPORT;
+        p_evt->header.evt_len            = (uint16_t)(offsetof(ble_evt_t, evt.gap_evt.params) -
+                                                      sizeof (ble_evt_hdr_t) +
+                                                      sizeof (ble_gap_evt_adv_report_t));
+        p_evt->evt.gap_evt.conn_handle   = p_params->conn_handle;
+        p_report->peer_addr.addr_type    = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+        for (j = 0; j < BLE_GAP_ADDR_LEN; j++)
+        {
+            p_report->peer_addr.addr[j] = (uint8_t)(0xC1 + j);
+        }
+        p_report->rssi                   = -67;
+        p_report->scan_rsp               = p_params->scan_rsp;
+        p_report->type                   = p_params->type;
+        p_report->dlen                   = p_params->dlen;
+        for (j = 0; j < p_params->dlen; j++)
+        {
+            p_report->data[j] = (uint8_t)(0x02 + j);
+        }
+
+        event_report(p_params->p_name, p_evt, adv_report_equal, &std_total, &compact_total);
+    }
+
+    printf("%-34s %8u %8u %8d\n", "total", (unsigned int)std_total, (unsigned int)compact_total,
+           (int)std_total - (int)compact_total);
+
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "nordic_common.h"
 #include "app_error.h"
 #include "app_uart.h"
@@ -499,6 +500,7 @@ static void nus_c_init(void)
     uint32_t         err_code;
     ble_nus_c_init_t nus_c_init_t;
     
+    memset(&nus_c_init_t, 0, sizeof(nus_c_init_t));
     nus_c_init_t.evt_handler = ble_nus_c_evt_handler;
     
     err_code = ble_nus_c_init(&m_ble_nus_c, &nus_c_init_t);
@@ -52,9 +52,11 @@ int main(void)
     SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
 
     
+#if (SER_CONN_EVT_TX_SLOT_COUNT == 0)
     /* Subscribe for BLE events. */
     err_code = softdevice_ble_evt_handler_set(ser_conn_ble_event_handle);
     APP_ERROR_CHECK(err_code);
+#endif
 
     /* Open serialization HAL Transport layer and subscribe for HAL Transport events. */
     err_code = ser_hal_transport_open(ser_conn_hal_transport_event_handle);
@@ -73,6 +75,12 @@ int main(void)
         err_code = ser_conn_rx_process();
         APP_ERROR_CHECK(err_code);
 
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+        /* Pull BLE events from the SoftDevice and encode them directly into free TX buffers. */
+        err_code = ser_conn_ble_event_process();
+        APP_ERROR_CHECK(err_code);
+#endif
+
         /* Sleep waiting for an application event. */
         err_code = sd_app_evt_wait();
         APP_ERROR_CHECK(err_code);
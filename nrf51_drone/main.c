@@ -24,9 +24,11 @@
 #include "nrf_soc.h"
 #include "app_error.h"
 #include "app_scheduler.h"
+#include "app_timer.h"
 #include "softdevice_handler.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_handlers.h"
+#include "ser_conn_bench.h"
 #include "boards.h"
 
 #include "ser_phy_debug_comm.h"
@@ -52,9 +54,18 @@ int main(void)
     SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
 
     
+#if (SER_CONN_EVT_TX_SLOT_COUNT == 0)
     /* Subscribe for BLE events. */
     err_code = softdevice_ble_evt_handler_set(ser_conn_ble_event_handle);
     APP_ERROR_CHECK(err_code);
+#endif
+
+#if SER_CONN_BENCHMARK_ENABLED
+    /* Initialize the timer driving the synthetic event generator. */
+    APP_TIMER_INIT(SER_CONN_BENCH_TIMER_PRESCALER, SER_CONN_BENCH_TIMER_OP_QUEUE_SIZE, false);
+    err_code = ser_conn_bench_init();
+    APP_ERROR_CHECK(err_code);
+#endif
 
     /* Open serialization HAL Transport layer and subscribe for HAL Transport events. */
     err_code = ser_hal_transport_open(ser_conn_hal_transport_event_handle);
@@ -73,9 +84,27 @@ int main(void)
         err_code = ser_conn_rx_process();
         APP_ERROR_CHECK(err_code);
 
+#if (SER_CONN_EVT_TX_SLOT_COUNT > 0)
+        /* Pull BLE events from the SoftDevice and encode them directly into free TX buffers. */
+        err_code = ser_conn_ble_event_process();
+        APP_ERROR_CHECK(err_code);
+#endif
+
+#if SER_CONN_BENCHMARK_ENABLED
+        /* Encode synthetic BLE events which are due. */
+        err_code = ser_conn_bench_evt_process();
+        APP_ERROR_CHECK(err_code);
+
+        ser_conn_bench_idle_enter();
+#endif
+
         /* Sleep waiting for an application event. */
         err_code = sd_app_evt_wait();
         APP_ERROR_CHECK(err_code);
+
+#if SER_CONN_BENCHMARK_ENABLED
+        ser_conn_bench_idle_exit();
+#endif
     }
 }
 /** @} */